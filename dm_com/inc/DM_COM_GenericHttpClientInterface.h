@@ -57,6 +57,32 @@ typedef struct httpputfiledatatype{
   char * localFileNameStr;      // File to be uploaded
 } __attribute((packed)) httpPutFileDataType;
 
+typedef struct httppostdatatype{
+  char       * destURLStr;      // URL of the collector
+  char       * usernameStr;     // Username for authentication
+  char       * passwordStr;     // Password for authentication
+  char       * contentTypeStr;  // Content-Type of the data (ex: "text/csv")
+  const char * dataPtr;         // Data to be posted (not copied)
+  size_t       dataSize;        // Size of the data in bytes
+} __attribute((packed)) httpPostDataType;
+
+// Message produced piece by piece while it is sent (see DM_SendHttpMessageStream)
+typedef struct httpmessagestreamtype{
+  int  (*readFunction)(void * producerData, char * buffer, size_t size); // Writes the next bytes of the message (at most size).
+                                                                          // Returns their number, 0 at the end of the message, -1 on error
+  int  (*rewindFunction)(void * producerData);  // Restarts the message from its beginning (0 on success)
+  void (*releaseFunction)(void * producerData); // Frees the producer data once the message is sent
+  void * producerData;
+} __attribute((packed)) httpMessageStreamType;
+
+// Message shared, without copy, by its producer, the HTTP client (message being sent or pending) and the retry buffer
+// (see DM_CreateHttpMessageBuffer)
+typedef struct httpmessagebuffertype{
+  char   * data;     // Null terminated message, never modified once the buffer is created
+  size_t   length;   // Length of the message
+  int      refCount; // Number of holders, the buffer is freed when the last one releases it
+} __attribute((packed)) httpMessageBufferType;
+
 
 int DM_ConfigureHttpClient(const char * acsUrl,
                            const char * acsUsername,
@@ -88,6 +114,75 @@ int DM_StopHttpClient(void);
 int DM_SendHttpMessage(IN const char * msgToSendStr);
 
 
+/*
+* @brief Function used to send an HTTP Message held by a shared buffer. The HTTP client keeps
+*        a reference on the buffer (no copy) while the message is pending or being sent.
+*
+* @param IN: ptr on the message buffer (still to be released by the caller)
+*
+* @return 0 on success (-1 otherwise)
+*
+*/
+int DM_SendHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr);
+
+
+/*
+* @brief Function used to create a shared message buffer, with one reference held by the caller
+*
+* @param IN: message allocated by malloc, owned by the buffer from now on
+*
+* @return The buffer (NULL if message is NULL or on allocation error, message being then freed)
+*
+*/
+httpMessageBufferType * DM_CreateHttpMessageBuffer(IN char * message);
+
+
+/*
+* @brief Function used to take a new reference on a shared message buffer
+*
+* @param IN: ptr on the message buffer
+*
+* @return The buffer
+*
+*/
+httpMessageBufferType * DM_RetainHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr);
+
+
+/*
+* @brief Function used to release a reference on a shared message buffer, freed with the last one
+*
+* @param IN: ptr on the message buffer (NULL allowed)
+*
+*/
+void DM_ReleaseHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr);
+
+
+/*
+* @brief Function used to send an HTTP Message produced while it is sent,
+*        using the chunked transfer encoding. The whole message is never held in memory.
+*
+* @param IN: ptr on the message producer (copied). Its producer data belongs to the HTTP client,
+*            which calls releaseFunction once the message is sent or discarded (even on error).
+*
+* @return 0 on success (-1 otherwise)
+*
+*/
+int DM_SendHttpMessageStream(IN const httpMessageStreamType * msgStreamPtr);
+
+
+/*
+* @brief Function used to set the number of SOAP envelopes the ACS accepts in one HTTP POST
+*        (MaxEnvelopes of the InformResponse). The messages waiting to be sent are then gathered
+*        in the same HTTP POST, up to this number. Set back to 1 when the HTTP session is closed.
+*
+* @param IN: the maximum number of envelopes
+*
+* @return 0 on success (-1 otherwise)
+*
+*/
+int DM_SetHttpMaxEnvelopes(IN int maxEnvelopes);
+
+
 /*
 * @brief Function used to get a file using HTTP GET.
 *
@@ -129,6 +224,21 @@ int DM_HttpPutFile(httpPutFileDataType * httpPutFileDataPtr);
 */
 int DM_FtpPutFile(httpPutFileDataType * httpPutFileDataPtr);
 
+/*
+* @brief Function used to push data using HTTP POST (bulk data collection).
+*
+* @param IN: char * destURLStr
+*        IN: char * usernameStr
+*        IN: char * passwordStr
+*        IN: char * contentTypeStr
+*        IN: char * dataPtr
+*        IN: size_t dataSize
+*
+* @return 0 on success, the HTTP response code if not 2xx, -1 on transport error
+*
+*/
+int DM_HttpPostData(httpPostDataType * httpPostDataPtr);
+
 /*
 * @brief Function used to close the HTTP Client Session
 *
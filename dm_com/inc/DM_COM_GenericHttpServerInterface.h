@@ -59,7 +59,10 @@
 #define MAXHOSTNAMELEN (256)
 #endif
 
-#define MAX_BACKLOG_CONNECTION (5) // The maximum number of backlog connection on the CPE HTTP Server socket
+#define MAX_HTTP_SERVER_CONNECTIONS (16)  // The maximum number of connections served at the same time by the CPE HTTP Server
+#define MAX_BACKLOG_CONNECTION (MAX_HTTP_SERVER_CONNECTIONS) // The maximum number of backlog connection on the CPE HTTP Server socket
+#define HTTP_SERVER_REQUEST_TIMEOUT (2000) // Delay (ms) given to a client to send its request and read the response
+#define HTTP_SERVER_POLL_PERIOD     (1000) // Maximum wait (ms) of the CPE HTTP Server loop, to check the exit request
 
 #define DEFAULT_MAX_CONNECTIONREQUEST      (50)    // The Maximum number of connection request during the period time
 #define DEFAULT_FREQ_CONNECTION_REQUEST    (3600)  // The period duration in seconds (Default 50 connections allowed per hour)
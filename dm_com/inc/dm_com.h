@@ -50,6 +50,8 @@
 #include "DM_CMN_Thread.h"
 
 #include "dm_com_utils.h"
+#include "dm_com_soap_writer.h"
+#include "dm_com_soap_reader.h"
 
 #include "DM_COM_GenericDomXmlParserInterface.h"
 #include "DM_COM_GenericHttpServerInterface.h"
@@ -57,6 +59,9 @@
 
 #include "CMN_Type_Def.h" 
 
+// Shared message buffer of the HTTP client (DM_COM_GenericHttpClientInterface.h may include this header first)
+struct httpmessagebuffertype;
+
 // DM_ENGINE's header
 #include "DM_ENG_RPCInterface.h"  /* high RPC interface definition    */
 
@@ -456,7 +461,11 @@ extern char* DM_COM_ArrayTypeAttrName;
 #define  SIZE_SERIALNUMBER    (65)
 #define  SIZE_EVENTCODE	      (65)
 #define  SIZE_PARAM_VAL_NAME  (257)
+// MaxEnvelopes of the Inform : number of SOAP envelopes the CPE accepts in one HTTP response.
+// 1 according to the TR069 protocol, more to let the ACS send several RPCs per round trip (make MAX_ENVELOPES=n)
+#ifndef MAX_ENVELOPPE_TR069
 #define  MAX_ENVELOPPE_TR069  (1)
+#endif
 #define   MAX_NUMBER_OF_RPC_COMMAND_PER_BODY (1)
 
 // -------------------------------------------------------------
@@ -507,6 +516,12 @@ typedef         int	  DMRET;
 // Max buffer size
 #define TMPBUFFER_SIZE (150)
 
+// Number of parameters beyond which the GetParameterValuesResponse is streamed (chunked) instead of being built in memory
+#define GPV_STREAMING_THRESHOLD (64)
+
+// Initial size of the buffer where the parts of a SOAP message received from the ACS are gathered
+#define RECEIVE_BUFFER_INITIAL_SIZE (4096)
+
 
 #ifndef unsignedInt
 typedef unsigned int unsignedInt;
@@ -1089,13 +1104,14 @@ DM_FreeTMPXMLBufferCpe();
  * @brief Function which update the retry buffer whith 
  *        the last emitted request.
  *
- * @param A Pointer on the message to store (string) and its size
+ * @param A Pointer on the shared buffer of the message to store (see httpMessageBufferType),
+ *        NULL or an empty message to forget the previous one
  *
  * @Return DM_OK
  *
  */
 DMRET
-DM_UpdateRetryBuffer(const char * soapMsgToStoreStr, int size) ;
+DM_UpdateRetryBuffer(struct httpmessagebuffertype * pMsgToStore) ;
 
 /**
  * @brief Call the DM_ENG_SetParameterAttributes
@@ -1142,16 +1158,38 @@ DMRET
 DM_GenerateUniqueHeaderID(OUT char *pID_generated);
 
 /**
- * @brief Function which add a Header_ID to a SOAP message
+ * @brief Function which starts a SOAP message sent by the CPE : Envelope, Header (with the cwmp:ID) and Body
  *
- * @param pUniqueHeaderID Header ID to add to the soap XML message
- * @param pSoapMsg	  Pointer to the XML/SOAP object to update
+ * @param pWriter  Writer to initialize
+ * @param pSoapId  Value of the cwmp:ID header (no cwmp:ID if NULL)
+ * @param allEnveloppeAttributs true to add the XMLSchema namespace (Inform and GetParameterValuesResponse)
  *
- * @Return DM_OK is okay else DM_ERR
+ * @Return None
  */
-DMRET
-DM_AddSoapHeaderID(IN const char       *pUniqueHeaderID,
-     IN       DM_SoapXml *pSoapMsg);
+void
+DM_StartSoapMessage(DM_SoapWriter * pWriter,
+                    const char    * pSoapId,
+                    bool            allEnveloppeAttributs);
+
+/**
+ * @brief Function which terminates a SOAP message started by DM_StartSoapMessage()
+ *
+ * @param pWriter  Writer of the message
+ *
+ * @Return The message (to be freed by the caller) or NULL on error
+ */
+char *
+DM_EndSoapMessage(DM_SoapWriter * pWriter);
+
+/**
+ * @brief Function which gives the XML schema type (xsi:type attribute) of a parameter value
+ *
+ * @param type  Type of the parameter
+ *
+ * @Return The type name or NULL if the type is unknown
+ */
+const char *
+DM_GetXsdTypeName(DM_ENG_ParameterType type);
 
 /**
  * @brief Private Entry point for ACS Session Supervision Thread
@@ -1192,16 +1230,16 @@ void
 _retryRequest();
 
 /**
- * @brief Private routine used to send an authentication
- *        request tp the ACS.
+ * @brief Private routine used to build an authentication
+ *        request to the ACS (a new nonce and opaque are generated).
  *
- * @param The socket aon wich the message is sent
+ * @param The buffer receiving the message and its size
  *
  * @Return OK DM_OK or ERROR
  *
  */
 DMRET
-_sendAuthenticationRequest(int nSocksExp);
+_buildAuthenticationRequest(char * requestDigestMsg, int size);
 
 
 /**
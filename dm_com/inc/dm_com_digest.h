@@ -52,6 +52,10 @@
 #define TOTAL_MAXTOKENSIZE  (6*MAXTOKENSIZE)
 #define SIGNATURE_SIZE      (16)
 
+#define DIGEST_REALM        "liveboxrealm"
+#define NONCE_TABLE_SIZE    (16)   // Number of challenges (nonces) valid at the same time
+#define NONCE_LIFETIME      (60)   // Validity of a nonce (in seconds)
+
 
 bool 
 _checkDigestAuthMessageContent(const char * _str);
@@ -59,6 +63,15 @@ _checkDigestAuthMessageContent(const char * _str);
 bool
 performClientDigestAuthentication(const char * _str);
 
+void
+initDigestAuthentication();
+
+void
+releaseDigestAuthentication();
+
+void
+updateDigestCredentials(const char * username, const char * password);
+
 #endif
 
 
@@ -93,7 +93,7 @@ DM_ACS_InformCallback(
  * @brief Beside to "DM_ACS_Inform_Callback", this function will add the MaxEnveloppes parameter 
  * @brief that must be only known by the DM_COM module.
  *
- * @remarks The MaxEnveloppes parameter is set to 1 in the current TR069 version.
+ * @remarks The MaxEnveloppes parameter is set to 1 in the current TR069 version (MAX_ENVELOPPE_TR069).
  *
  */
 int
@@ -200,16 +200,19 @@ DM_ACS_updateAscParameters(char * url,
 				                   char * password);
 
 /**
- * @brief function which remake the xml buffer from a XML data structure
+ * @brief Notify the DM_COM module of the credentials of the connection requests.
+ *        This callback function is used when the application is started and when 
+ *        the ConnectionRequestUsername or ConnectionRequestPassword is changed.
  *
- * @param pElement  Current element of the XML tree (
+ * @param username - The username expected from the ACS (could be NULL if not set)
+ * 
+ * @param password - The password expected from the ACS (could be NULL if not set)
  *
- * @Return DM_OK is okay else DM_ERR
+ * @return void
  *
- * @Remarks for a complete tree, pElement = pRoot
- */
-char *
-DM_RemakeXMLBufferACS(GenericXmlNodePtr pElement);
-
+ */ 
+void
+DM_ACS_updateConnectionRequestCredentials(char * username,
+                                          char * password);
 
 #endif /* _DM_RPC_ACS_H_ */
@@ -0,0 +1,97 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_com_soap_reader.h
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_com_soap_reader.h
+ *
+ * @brief Pull parser used to read the SOAP messages received from the ACS
+ *
+ * The reader walks through the received buffer and gives its content event by event
+ * (start tag, end tag, text) without building any DOM tree. The names, attributes and
+ * texts are not copied : they point into the buffer, which must remain valid while
+ * it is read. Only the strings explicitly asked for (DM_SoapReader_getAttribute(),
+ * DM_SoapReader_readElementText()) are allocated, with their entities decoded.
+ *
+ * Like the ixml parser, the blank texts between two tags are ignored.
+ *
+ * Typical use :
+ *
+ *    DM_SoapReader reader;
+ *    DM_SoapReader_init(&reader, pMessage);
+ *    while (DM_SoapReader_next(&reader) == DM_SoapReader_START_ELEMENT)
+ *    {
+ *       if (DM_SoapReader_isElement(&reader, "Name")) { DM_SoapReader_readElementText(&reader, &name); }
+ *       else { DM_SoapReader_skipElement(&reader); }
+ *    }
+ */
+
+#ifndef _DM_COM_SOAP_READER_H
+#define _DM_COM_SOAP_READER_H
+
+#include "DM_ENG_Common.h"
+
+#define DM_SOAP_READER_MAX_DEPTH (32)
+
+typedef enum _DM_SoapReaderEvent
+{
+   DM_SoapReader_EOF = 0,       // End of the buffer, all the elements being closed
+   DM_SoapReader_START_ELEMENT,
+   DM_SoapReader_END_ELEMENT,
+   DM_SoapReader_TEXT,          // Character data or CDATA section
+   DM_SoapReader_ERROR          // Malformed XML (sticky)
+
+} DM_SoapReaderEvent;
+
+/**
+ * Reader state
+ *
+ * name / nameLength give the element of the last START_ELEMENT or END_ELEMENT event,
+ * depth is the number of elements open after the event (1 after the START_ELEMENT of the root).
+ */
+typedef struct _DM_SoapReader
+{
+  const char * pos;              // Next character to read
+  const char * name;
+  size_t       nameLength;
+  const char * attributes;       // Raw attributes of the last start tag
+  size_t       attributesLength;
+  const char * text;             // Raw text of the last TEXT event
+  size_t       textLength;
+  bool         textIsCData;      // No entity to decode in the text
+  bool         pendingEnd;       // Empty element tag : its END_ELEMENT is the next event
+  bool         error;
+  int          depth;
+  const char * openTags[DM_SOAP_READER_MAX_DEPTH];
+  size_t       openTagLengths[DM_SOAP_READER_MAX_DEPTH];
+
+} __attribute((packed)) DM_SoapReader;
+
+void DM_SoapReader_init(DM_SoapReader* reader, const char* buffer);
+DM_SoapReaderEvent DM_SoapReader_next(DM_SoapReader* reader);
+bool DM_SoapReader_isElement(const DM_SoapReader* reader, const char* name);
+char* DM_SoapReader_getAttribute(const DM_SoapReader* reader, const char* name);
+char* DM_SoapReader_getText(const DM_SoapReader* reader);
+bool DM_SoapReader_readElementText(DM_SoapReader* reader, char** pText);
+bool DM_SoapReader_skipElement(DM_SoapReader* reader);
+
+#endif /* _DM_COM_SOAP_READER_H */
@@ -0,0 +1,95 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_com_soap_writer.h
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_com_soap_writer.h
+ *
+ * @brief Streaming XML writer used to build the SOAP messages sent by the CPE
+ *
+ * The elements, attributes and texts are escaped and appended directly into one
+ * growable buffer, without building any DOM tree. The output is laid out exactly
+ * as the ixml serializer does it (same prolog, same line breaks, same escaping)
+ * so that the messages are unchanged on the wire.
+ *
+ * Typical use :
+ *
+ *    DM_SoapWriter writer;
+ *    DM_SoapWriter_init(&writer);
+ *    DM_SoapWriter_startElement(&writer, "cwmp:Inform");
+ *    DM_SoapWriter_addElement(&writer, "MaxEnvelopes", "1");
+ *    DM_SoapWriter_endElement(&writer);
+ *    char* msg = DM_SoapWriter_detachBuffer(&writer);
+ *
+ * The writing errors (allocation failure, unbalanced tags) are sticky : they are only
+ * reported by DM_SoapWriter_detachBuffer() which then returns NULL.
+ *
+ * A message may also be sent while it is written : DM_SoapWriter_read() copies the text
+ * already written out of the buffer and moves a read offset past it. The consumed text is
+ * only dropped when the buffer must grow, so that the buffer holds little more than the
+ * part of the message not yet consumed.
+ *
+ * The parts of the messages which seldom change may be written once, kept (copy of the
+ * buffer between two lengths) then appended as is to the next messages with
+ * DM_SoapWriter_addRawAttributes() or DM_SoapWriter_addRawElements().
+ */
+
+#ifndef _DM_COM_SOAP_WRITER_H
+#define _DM_COM_SOAP_WRITER_H
+
+#include "DM_ENG_Common.h"
+
+#define DM_SOAP_WRITER_MAX_DEPTH (16)
+
+/**
+ * Writer state
+ *
+ * The names of the open elements are only referenced (not copied) : they must stay valid
+ * until the corresponding DM_SoapWriter_endElement().
+ */
+typedef struct _DM_SoapWriter
+{
+  char       * buffer;
+  size_t       length;
+  size_t       capacity;
+  size_t       readOffset;   // Text before it already consumed by DM_SoapWriter_read()
+  const char * openTags[DM_SOAP_WRITER_MAX_DEPTH];
+  int          depth;
+  bool         startTagOpen; // The '>' of the last start tag is not written yet
+  bool         error;
+
+} __attribute((packed)) DM_SoapWriter;
+
+void DM_SoapWriter_init(DM_SoapWriter* writer);
+void DM_SoapWriter_startElement(DM_SoapWriter* writer, const char* name);
+void DM_SoapWriter_addAttribute(DM_SoapWriter* writer, const char* name, const char* value);
+void DM_SoapWriter_addText(DM_SoapWriter* writer, const char* text);
+void DM_SoapWriter_endElement(DM_SoapWriter* writer);
+void DM_SoapWriter_addElement(DM_SoapWriter* writer, const char* name, const char* text);
+void DM_SoapWriter_addRawAttributes(DM_SoapWriter* writer, const char* attributes);
+void DM_SoapWriter_addRawElements(DM_SoapWriter* writer, const char* elements);
+char* DM_SoapWriter_detachBuffer(DM_SoapWriter* writer);
+size_t DM_SoapWriter_pendingLength(DM_SoapWriter* writer);
+size_t DM_SoapWriter_read(DM_SoapWriter* writer, char* dest, size_t size);
+void DM_SoapWriter_free(DM_SoapWriter* writer);
+
+#endif /* _DM_COM_SOAP_WRITER_H */
@@ -48,6 +48,7 @@
 
 #include <errno.h>	  /* Usefull for system errors    */
 #include <sys/time.h> /* gettimeofday */
+#include <pthread.h>  /* pthread_once */
 #include "DM_ENG_Global.h"
 #include "CMN_Trace.h"
 #include "DM_ENG_Parameter.h"
@@ -63,6 +64,7 @@
 #include "dm_com.h"	  /* DM_COM module definition    */
 
 #include "dm_com_rpc_acs.h"  /* Definition of the ACS RPC methods	  */
+#include "dm_com_digest.h"   /* Digest authentication of the connection requests */
 
 // DM_ENGINE's header
 #include "DM_ENG_RPCInterface.h"  /* DM_Engine module definition    */
@@ -87,6 +89,10 @@ static char* _FaultTagName = NULL;
 char* DM_COM_ArrayTypeAttrName = NULL; 
 static char* _MustUnderstandAttrName = NULL; 
 
+// Namespace attributes of the Envelope tag, serialized by the first message which needs them.
+// Indexes : [allEnveloppeAttributs][cwmp-1-1 used] (see DM_StartSoapMessage)
+static char* _EnvelopeAttributes[2][2] = { { NULL, NULL }, { NULL, NULL } };
+
 dm_com_struct	 g_DmComData;  /* Global data structure for the DM_COM module  */
 
 // Information about the thread launched for the http's server
@@ -97,7 +103,7 @@ static DM_CMN_ThreadId_t _AcsSupervisionThreadID;
 
 static char  *g_pBufferCpe = NULL;	/* Global pointer used to remake XML buffer  */
 
-static char  *g_retryBuffer = NULL;/* Global pointer used to retry CPE Request */
+static httpMessageBufferType *g_retryBuffer = NULL;/* Global pointer used to retry CPE Request (shared with the HTTP client) */
 
 #define ACSSESSIONSUPERVISOR (10)
 #define ACSSESSIONTIMEOUT    (30)
@@ -127,9 +133,24 @@ static bool _httpServerStatus = false; // Flag to indicate if the HTTP Server is
 static void _forceACSSessionToClose(void);
 static void _closeACSSession(bool success);
 static char * _getCwmpVersionSupported();
+static bool _processSoapMessageWithoutDom(const char * pMessage);
 
 static bool _AcsSessionSupervisorAlive = false;
 
+/*
+* Buffer where the parts of a SOAP message received from the ACS are gathered
+*/
+typedef struct _SoapReceiveBuffer
+{
+  char   * data;     // Null terminated, NULL when no message is pending
+  size_t   length;
+  size_t   capacity; // Allocated size, the null character excluded
+  size_t   scanned;  // Number of bytes already searched for the end envelope tag
+
+} __attribute((packed)) SoapReceiveBuffer;
+
+static SoapReceiveBuffer _receivedMessage = { NULL, 0, 0, 0 };
+
 
 /**
  * @brief Start the DM_COM module
@@ -216,12 +237,14 @@ DM_COM_STOP()
 	DM_CMN_Thread_cancel ( _AcsSupervisionThreadID );
   
   // Free g_retryBuffer
-  DM_ENG_FREE(g_retryBuffer);
+  DM_ReleaseHttpMessageBuffer(g_retryBuffer);
+  g_retryBuffer = NULL;
 	
    // ---------------------------------------------------------------------------------
    // Destry the mutex used in the DM_COM module
    // ---------------------------------------------------------------------------------
    DM_CMN_Thread_destroyMutex( mutexAcsSession );
+   releaseDigestAuthentication();
 
 	INFO("DM_COM_STOP - end");
 
@@ -265,12 +288,17 @@ DMRET DM_COM_INIT()
 	// Initialize the several mutex used int the DM_COM module
 	// ---------------------------------------------------------------------------------
 	DM_CMN_Thread_initMutex( &mutexAcsSession );
+
+	// ---------------------------------------------------------------------------------
+	// Initialize the digest authentication of the connection requests
+	// ---------------------------------------------------------------------------------
+	initDigestAuthentication();
 	
 	// ---------------------------------------------------------------------------------
 	// Set the callback's notification with the DM_ENGINE
 	// ---------------------------------------------------------------------------------
 
-	DM_ENG_ActivateNotification( DM_ENG_EntityType_ACS, DM_ACS_InformCallback, DM_ACS_TransfertCompleteCallback, DM_ACS_RequestDownloadCallback, DM_ACS_updateAscParameters);
+	DM_ENG_ActivateNotification( DM_ENG_EntityType_ACS, DM_ACS_InformCallback, DM_ACS_TransfertCompleteCallback, DM_ACS_RequestDownloadCallback, DM_ACS_updateAscParameters, DM_ACS_updateConnectionRequestCredentials);
 	
 	// ---------------------------------------------------------------------------------
 	// Create the ACS Session Supervisor Thread.
@@ -331,6 +359,17 @@ DM_COM_ConfigureHttpClient(char * acsUrl,
 	
 }
 
+/*
+* Private routine which frees the serialized Envelope attributes, to be written again with the new prefixes
+*/
+static void _freeEnvelopeAttributes()
+{
+   DM_ENG_FREE(_EnvelopeAttributes[0][0]);
+   DM_ENG_FREE(_EnvelopeAttributes[0][1]);
+   DM_ENG_FREE(_EnvelopeAttributes[1][0]);
+   DM_ENG_FREE(_EnvelopeAttributes[1][1]);
+}
+
 static void _initPrefixedTag()
 {
    if (DM_COM_SoapEnv_NS == NULL) { DM_COM_SoapEnv_NS = _DEFAULT_SOAPENV_NS; }
@@ -417,6 +456,8 @@ static void _initPrefixedTag()
    strcpy(_MustUnderstandAttrName, DM_COM_SoapEnv_NS);
    strcat(_MustUnderstandAttrName, ":");
    strcat(_MustUnderstandAttrName, DM_COM_MUST_UNDERSTAND_ATTR);
+
+   _freeEnvelopeAttributes();
 }
 
 static void _freePrefixedTag()
@@ -434,12 +475,99 @@ static void _freePrefixedTag()
    DM_ENG_FREE(_FaultTagName);
    DM_ENG_FREE(DM_COM_ArrayTypeAttrName);
    DM_ENG_FREE(_MustUnderstandAttrName);
+   _freeEnvelopeAttributes();
+}
+
+/*
+* Private routine which appends a part of the SOAP message to the receive buffer.
+* The capacity is doubled when it is exceeded, so the message is gathered in linear time.
+* return false if the memory cannot be allocated
+*/
+static bool
+_appendToReceiveBuffer(const char * pData,
+                       size_t       size)
+{
+  if ( _receivedMessage.length + size > _receivedMessage.capacity ) {
+    size_t newCapacity = ( _receivedMessage.capacity == 0 ? RECEIVE_BUFFER_INITIAL_SIZE : _receivedMessage.capacity );
+    char * newData     = NULL;
+
+    while ( newCapacity < _receivedMessage.length + size ) { newCapacity *= 2; }
+    newData = (char*)realloc( _receivedMessage.data, newCapacity + 1 );
+    if ( newData == NULL ) {
+      return false;
+    }
+    _receivedMessage.data     = newData;
+    _receivedMessage.capacity = newCapacity;
+  }
+
+  memcpy( _receivedMessage.data + _receivedMessage.length, pData, size );
+  _receivedMessage.length += size;
+  _receivedMessage.data[_receivedMessage.length] = '\0';
+
+  return true;
+}
+
+/*
+* Private routine which looks for the end envelope tag of the first envelope received.
+* Only the bytes appended since the last call are searched, plus the few previous ones
+* where the tag may begin.
+* return the size of the first envelope (up to its end tag included), 0 if it is not complete
+*/
+static size_t
+_findReceivedEnvelopeEnd()
+{
+  size_t       tagLength = 0;
+  size_t       from      = 0;
+  const char * endTag    = NULL;
+
+  if ( (_receivedMessage.data == NULL) || (_EndEnvelopeTag == NULL) ) {
+    return 0;
+  }
+
+  tagLength = strlen( _EndEnvelopeTag );
+  from      = ( _receivedMessage.scanned < tagLength ? 0 : _receivedMessage.scanned - tagLength + 1 );
+  _receivedMessage.scanned = _receivedMessage.length;
+
+  endTag = strstr( _receivedMessage.data + from, _EndEnvelopeTag );
+  return ( endTag == NULL ? 0 : (size_t)(endTag - _receivedMessage.data) + tagLength );
+}
+
+/*
+* Private routine which frees the receive buffer
+*/
+static void
+_resetReceiveBuffer()
+{
+  DM_ENG_FREE( _receivedMessage.data );
+  _receivedMessage.length   = 0;
+  _receivedMessage.capacity = 0;
+  _receivedMessage.scanned  = 0;
+}
+
+/*
+* Private routine which removes the first envelope from the receive buffer once processed.
+* The next envelopes sent in the same HTTP response (see MaxEnvelopes) are kept.
+*/
+static void
+_consumeReceivedEnvelope(size_t envelopeSize)
+{
+  while ( (envelopeSize < _receivedMessage.length) && isspace( (unsigned char)_receivedMessage.data[envelopeSize] ) ) {
+    envelopeSize++;
+  }
+
+  if ( envelopeSize >= _receivedMessage.length ) {
+    _resetReceiveBuffer();
+  } else {
+    _receivedMessage.length -= envelopeSize;
+    memmove( _receivedMessage.data, _receivedMessage.data + envelopeSize, _receivedMessage.length + 1 );
+    _receivedMessage.scanned = 0;
+  }
 }
 
 /**
  * @brief Function called by the HTTP Client engine in order to get the http content
  *
- * @param httpDataMsgString  
+ * @param httpDataMsgString  Part of the message, null terminated
  * @param msgSize  
  *
  * @return Size of the data received
@@ -449,20 +577,17 @@ size_t
 DM_HttpCallbackClientData(char   * httpDataMsgString,
                           size_t   msgSize)
 {
-   static char           * pMessage       = NULL;
-   bool	                  MessageComplete = false;
+   size_t                 envelopeSize = 0;
    DM_SoapXml	            SoapMsg;
 
    // Dipslay Debug Info
-   char* tmpStr = DM_ENG_strndup((char*) httpDataMsgString, msgSize);
-   DBG( "message =\n%s\nMsgSize = %d", (char*) tmpStr, msgSize );
+   DBG( "message =\n%.*s\nMsgSize = %d", (int)msgSize, (char*) httpDataMsgString, msgSize );
 
 	// Make sure in case of Digest Authentication, the session is authorized
 	// The string AUTHORIZATION_REQUIRED must be present in a non soap message
-   if (NULL != strstr(tmpStr, AUTHORIZATION_REQUIRED))
+   if (NULL != strstr(httpDataMsgString, AUTHORIZATION_REQUIRED))
    {
      WARN("HTTP SESSION UNAUTHORIZED - DIGEST AUTJENTICATION FAILED");
-     DM_ENG_FREE(tmpStr);  
      return 0;
    }
 
@@ -474,106 +599,100 @@ DM_HttpCallbackClientData(char   * httpDataMsgString,
     EXEC_ERROR( "Msg = '%s' ", (char*)httpDataMsgString );
     EXEC_ERROR( "An internal error have been detected which cannot valid the current request " );
     EXEC_ERROR( "For more information, see the TOMCAT log (/var/log/Tomcat5/catalina.out)!!  " );
-    DM_ENG_FREE(tmpStr);
     return (-1) ;
 	}
 
    // A vrifier validit lexicale du namespace trouv !!
    if (( DM_COM_SoapEnv_NS == NULL ) || ( DM_COM_SoapEnv_NS == _DEFAULT_SOAPENV_NS))
    {
-      char* c1 = strchr( tmpStr, '<' );
-      char* c2 = strchr( tmpStr, ':' );
+      char* c1 = strchr( httpDataMsgString, '<' );
+      char* c2 = strchr( httpDataMsgString, ':' );
       if ( (c1==NULL) || (c2==NULL) || (c1>c2) || (c2-c1 > 15) )
       {
          WARN("Invalid SOAP message !");
-         DM_ENG_FREE(tmpStr);  
          return 0;
       }
       DM_COM_SoapEnv_NS = DM_ENG_strndup( c1+1, c2-c1-1 );
       _initPrefixedTag();
    }
-   DM_ENG_FREE(tmpStr);
-
-	// Make sure a new SOAP message is coming while an imcomplete one is stored
-  if ((pMessage != NULL) && (strstr( (char*)httpDataMsgString, _BeginEnvelopeTag ) != NULL)){
-    EXEC_ERROR( "Can not complete the previous SOAP Message. Start a new SOAP Message" );
-    DM_ENG_FREE(pMessage);
-  }
 
 	// -----------------------------------------------------------------------
 	// At the beginning the message is NULL, then because the content can be separated
 	// in several parts, we will need to concatenate each one.
 	// -----------------------------------------------------------------------
-	if ( pMessage == NULL )	{
+	if ( _receivedMessage.data == NULL )	{
     // --------------------------------------------------------------------------------
     // Look for the begin SOAP tag
     // --------------------------------------------------------------------------------
     if ( strstr( (char*)httpDataMsgString, _BeginEnvelopeTag ) == NULL ) {
       EXEC_ERROR( "The message received seems not to be SOAP!! Msg: %s", httpDataMsgString );
       return( msgSize );
-    } else {
-      DBG( "-----> The message received seem to be SOAP." );
-
-      pMessage = DM_ENG_strndup( (char*)httpDataMsgString, msgSize );
-
-      if ( strstr( (char*)httpDataMsgString, _EndEnvelopeTag ) == NULL)	{
-        INFO(" Wait for other SOAP messages to complete the actual one..." );
-      } else {
-        DBG( "-----> SOAP message is complete!!" );
-        MessageComplete = true;
-      }
     }
-	} else {  // if ( pMessage == NULL )
+    DBG( "-----> The message received seem to be SOAP." );
+	} else {
 	  INFO( "Completing an existing message." );
-	  	  
-    // --------------------------------------------------------------------------------
-    // Save the new part of the soap message / use realloc+strcat instead ??
-    // --------------------------------------------------------------------------------
-    pMessage = (char*)realloc( pMessage, strlen(pMessage)+strlen((char*)httpDataMsgString)+1 );
-    sprintf( pMessage, "%s%s", pMessage, (char*)httpDataMsgString );
-    if ( strstr( (char*)httpDataMsgString, _EndEnvelopeTag ) == NULL) {
-      INFO(" SOAP message not complete yet!!"                            );
-      INFO(" Wait for other SOAP messages to complete the actual one..." );
-    } else {
-      INFO( "-----> SOAP message complete!!" );
-      MessageComplete = true;
-    }
 	}
 
+  // --------------------------------------------------------------------------------
+  // Save the new part of the soap message
+  // --------------------------------------------------------------------------------
+  if ( !_appendToReceiveBuffer( httpDataMsgString, msgSize ) ) {
+    EXEC_ERROR( "Can not store the SOAP message (%d bytes received)", _receivedMessage.length + msgSize );
+    _resetReceiveBuffer();
+    return 0;
+  }
+
 	// -------------------------------------------------------------------------
-	// If the soap message is complete, parse it and run the methods one by one
+	// Parse and run the complete SOAP messages one by one. The ACS may send several
+	// envelopes in the same HTTP response (up to the MaxEnvelopes of the Inform).
 	// -------------------------------------------------------------------------
-	if ( MessageComplete )
+  while ( (envelopeSize = _findReceivedEnvelopeEnd()) != 0 )
    {
+    char nextChar = _receivedMessage.data[envelopeSize];
+
+    DBG( "-----> SOAP message is complete!!" );
 	  INFO("------------------------------------------------");
 	  INFO("- SOAP MESSAGE RECEIVED: ACS --> CPE           -");
      //INFO( "%s", pMessage );
      INFO("------------------------------------------------");
 
+    // The envelope is terminated in place while it is processed
+    _receivedMessage.data[envelopeSize] = '\0';
+
     // --------------------------------------------------------------------------------
-    // Convert the SOAP message into a XML tree
+    // The RPC with big arguments (SetParameterValues, SetParameterAttributes) are read
+    // straight from the buffer. The other messages are converted into a XML tree.
     // --------------------------------------------------------------------------------
-    DM_InitSoapMsgReceived( &SoapMsg );
-    if(DM_OK == DM_AnalyseSoapMessage( &SoapMsg, pMessage, TYPE_ACS, false )) {
+    if ( !_processSoapMessageWithoutDom( _receivedMessage.data ) ) {
+      DM_InitSoapMsgReceived( &SoapMsg );
+      if(DM_OK == DM_AnalyseSoapMessage( &SoapMsg, _receivedMessage.data, TYPE_ACS, false )) {
 
-      // --------------------------------------------------------------------------------
-      // Parse the XML tree in order to launch the RPC methods
-      // --------------------------------------------------------------------------------
-      DM_ParseSoapEnveloppe(SoapMsg.pBody, SoapMsg.pSoapID, SoapMsg.nHoldRequest);
-			
-    } else {
-      EXEC_ERROR("Invalid SOAP Message. Close the session.");
+        // --------------------------------------------------------------------------------
+        // Parse the XML tree in order to launch the RPC methods
+        // --------------------------------------------------------------------------------
+        DM_ParseSoapEnveloppe(SoapMsg.pBody, SoapMsg.pSoapID, SoapMsg.nHoldRequest);
+
+      } else {
+        EXEC_ERROR("Invalid SOAP Message. Close the session.");
+      }
+
+      xmlDocumentFree(SoapMsg.pParser);
+
+      DM_InitSoapMsgReceived( &SoapMsg );
     }
 
-    xmlDocumentFree(SoapMsg.pParser);
-    
-    DM_InitSoapMsgReceived( &SoapMsg );
-    
-    if(NULL != pMessage) {
-      DM_ENG_FREE(pMessage);
+    _receivedMessage.data[envelopeSize] = nextChar;
+    _consumeReceivedEnvelope( envelopeSize );
+
+    // The session may have been closed by the message, the next envelopes are dropped
+    if ( _EndEnvelopeTag == NULL ) {
+      _resetReceiveBuffer();
     }
-    MessageComplete = false;
 	}
+
+  if ( _receivedMessage.data != NULL ) {
+    INFO(" Wait for other SOAP messages to complete the actual one..." );
+  }
 	
 	return( msgSize );
 }
@@ -615,6 +734,12 @@ DM_HttpCallbackClientHeader(char   * httpHeaderMsgString,
 
 	DBG( "HTTP Header received = '%s'", pData );
 	if ( !strncmp( pData, HTTP_VERSION, 5 ) ) {
+
+    // Make sure a new HTTP response is coming while an incomplete SOAP message is stored
+    if ( (lastHttpResponseCode != HTTP_CONTINUE) && (_receivedMessage.data != NULL) ) {
+      EXEC_ERROR( "Can not complete the previous SOAP Message. Start a new SOAP Message" );
+      _resetReceiveBuffer();
+    }
  
     // -------------------------------------------------------------------------
     // Analyse the return code
@@ -982,115 +1107,60 @@ DM_ParseSoapEnveloppe(GenericXmlNodePtr bodyNodePtr, char* soapIdStr, unsigned i
   return DM_ParseSoapBodyMessage( bodyNodePtr, soapIdStr, holdRequests);
 }
 
-/**
- * @brief Function which parse a SOAP message and extract the RPC commands
- *
- * Example :
- * <soapenv:Body>
- *   <cwmp:GetParameterNames>
- *     <ParameterPath>Object.</ParameterPath>
- *     <NextLevel>0</NextLevel>
- *   </cwmp:GetParameterNames>
- * </soapenv:Body>
- *
- * @param pBody current reference to the body tag
- *
- * @return return DM_OK is okay else DM_ERR
- *
- */
-DMRET
-DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsigned int holdRequests)
+/*
+* Private routine which processes the Fault message received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processFault(GenericXmlNodePtr   rpcNode,
+              char              * soapIdStr,
+              unsigned int        holdRequests UNUSED)
 {
-  DMRET                   nRet             = DM_ERR;
-  char                  * rpcCmmandTypeStr = NULL;
-
-  DBG("DM_ParseSoapBodyMessage - Begin");
-
-  // Retrieve the list of child nodes (child nodes of soapenv:Body node)
-  // Only one RPC command must exist per body
-  GenericXmlNodeListPtr rpcNodeList = xmlGetChildNodesList(pBody);
-  // Check only one one RPC exist 
-  if(NULL == rpcNodeList) {
-    EXEC_ERROR( "RPC Command List is Empty. No RPC Request in the Soap Message" );
-    // Send a fault SOAP message to the ACS server (NOK)
-    DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-    return nRet;
-  }
-  
-  // Check there is only one RPC Command in the soap body
-  if(MAX_NUMBER_OF_RPC_COMMAND_PER_BODY != xmlGetNumberOfChildNodes(pBody) ) {
-    // More than 1 RPC Command in the body
-    EXEC_ERROR( "The soapenv:Body contains %d RPC Cmd (max is %d)", (int )xmlGetNodesListLength(rpcNodeList),
-                                                               MAX_NUMBER_OF_RPC_COMMAND_PER_BODY);
-    // Send a fault SOAP message to the ACS server (NOK)
-    DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-    // Free the rpcNodeList
-    xmlFreeNodesList( rpcNodeList );
-    return nRet;
-  }
-
-  // Get the RPC Node (first entry in the list)
-  GenericXmlNodePtr rpcNode = xmlGetNodeFromNodesList(rpcNodeList, 0);
-  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
-
-  // Free the rpcNodeList
-  xmlFreeNodesList( rpcNodeList );
-
-  // Get the name of the RPC Command
-  xmlGetNodeParameters(rpcNode, &rpcCmmandTypeStr, NULL);
-
-  INFO("RPC Command = %s", rpcCmmandTypeStr);
-  
-  INFO("SOAP Message: RPC: %s (soapId: %s)", rpcCmmandTypeStr , soapIdStr);
-  
-  // A message is received from the ACS. Update the ACS Session Timer.
-  _updateAcsSessionTimer();
-
-
-  if(0 == strcmp( rpcCmmandTypeStr, _FaultTagName )) {
-    // -----------------------------------------------------------------
-    // FAULT MESSAGE - BEGIN
-    // -----------------------------------------------------------------
-    // <soapenv:Envelope
-    //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/" 
-    //	xmlns:xsd="http://www.w3.org/2001/XMLSchema" 
-    //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
-    // <soapenv:Header>
-    // <cwmp:ID
-    //	soapenv:mustUnderstand="1"
-    //	xsi:type="xsd:string" 
-    //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1186754215138</cwmp:ID>
-    // </soapenv:Header>
-    // <soapenv:Body>
-    // <soapenv:Fault>
-    // <faultcode xsi:type="xsd:string">Server</faultcode>
-    // <faultstring xsi:type="xsd:string">CWMP Fault</faultstring>
-    // <detail>
-    // 	<cwmp:Fault xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
-    //   <FaultCode xsi:type="xsd:int">8002</FaultCode>
-    //  <FaultString xsi:type="xsd:string">Problem during execution of operation inform : null</FaultString>
-    //	</cwmp:Fault>
-    // </detail>
-    // </soapenv:Fault>
-    // </soapenv:Body>
-    // </soapenv:Envelope>
-    // -----------------------------------------------------------------
-    unsigned int            i;
-    GenericXmlNodePtr       faultNode         = NULL;
-    bool                    retryCpeRequest   = false; // Indicate if the Previous CPE Request must be retry.
-    GenericXmlNodeListPtr   faultCodeNodeList = xmlGetNodesListWithTagName(rpcNode, FAULTCODE2);
-    char                  * faultCodeStr      = NULL;
-    int                     theFaultCode      = 0;
-
-    
-    if(NULL != faultCodeNodeList) {
-      // Loop through all the FaultCode node to check if RetryRequest is present.
-      for(i=0; i < xmlGetNodesListLength(faultCodeNodeList); i++){
+  DMRET                 nRet       = DM_ERR;
+
+  // -----------------------------------------------------------------
+  // FAULT MESSAGE - BEGIN
+  // -----------------------------------------------------------------
+  // <soapenv:Envelope
+  //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/" 
+  //	xmlns:xsd="http://www.w3.org/2001/XMLSchema" 
+  //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
+  // <soapenv:Header>
+  // <cwmp:ID
+  //	soapenv:mustUnderstand="1"
+  //	xsi:type="xsd:string" 
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1186754215138</cwmp:ID>
+  // </soapenv:Header>
+  // <soapenv:Body>
+  // <soapenv:Fault>
+  // <faultcode xsi:type="xsd:string">Server</faultcode>
+  // <faultstring xsi:type="xsd:string">CWMP Fault</faultstring>
+  // <detail>
+  // 	<cwmp:Fault xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
+  //   <FaultCode xsi:type="xsd:int">8002</FaultCode>
+  //  <FaultString xsi:type="xsd:string">Problem during execution of operation inform : null</FaultString>
+  //	</cwmp:Fault>
+  // </detail>
+  // </soapenv:Fault>
+  // </soapenv:Body>
+  // </soapenv:Envelope>
+  // -----------------------------------------------------------------
+  unsigned int            i;
+  GenericXmlNodePtr       faultNode         = NULL;
+  bool                    retryCpeRequest   = false; // Indicate if the Previous CPE Request must be retry.
+  GenericXmlNodeListPtr   faultCodeNodeList = xmlGetNodesListWithTagName(rpcNode, FAULTCODE2);
+  char                  * faultCodeStr      = NULL;
+  int                     theFaultCode      = 0;
+
+
+  if(NULL != faultCodeNodeList) {
+    // Loop through all the FaultCode node to check if RetryRequest is present.
+    for(i=0; i < xmlGetNodesListLength(faultCodeNodeList); i++){
 	      faultNode = xmlGetNodeFromNodesList(faultCodeNodeList, i);
 	      xmlGetNodeParameters(faultNode, NULL, &faultCodeStr);
-        // Convert the string into int.
-        if(DM_ENG_stringToInt(faultCodeStr, &theFaultCode)) {
-          if(ACS_ERROR_RETRY_REQUEST == theFaultCode) {
+      // Convert the string into int.
+      if(DM_ENG_stringToInt(faultCodeStr, &theFaultCode)) {
+        if(ACS_ERROR_RETRY_REQUEST == theFaultCode) {
 	          // This is a Retry request
 	          INFO("SOAP MSG ERROR 8005 (RETRY REQUEST DETECTED)");
 	          retryCpeRequest = true;
@@ -1100,71 +1170,266 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
 		        // Break: At least one error not equal to retry request
 		        break;
 	        }
-        } else {
-          EXEC_ERROR("Can not convert FaultCode string.");
+      } else {
+        EXEC_ERROR("Can not convert FaultCode string.");
 	        retryCpeRequest = false;
-          break;
-        }
-      }
-      xmlFreeNodesList(faultCodeNodeList);
-    } // end if(NULL != faultCodeNodeList)
-    
-    if(!retryCpeRequest) {
-      // Look for a SOAP Header_ID in the global array (and remove it from HeaderID array.
-      nRet = DM_RemoveHeaderIDFromTab( soapIdStr );
-      if ( nRet != DM_OK ) {
-        EXEC_ERROR( "The Header_ID %s of the soap message haven't been found in the",  soapIdStr);
-        EXEC_ERROR( "global array. That's not a response of a previous message!!" );
+        break;
       }
-      
-      // Force the ACS Session to close.
-      _forceACSSessionToClose();
-      
+    }
+    xmlFreeNodesList(faultCodeNodeList);
+  } // end if(NULL != faultCodeNodeList)
+
+  if(!retryCpeRequest) {
+    // Look for a SOAP Header_ID in the global array (and remove it from HeaderID array.
+    nRet = DM_RemoveHeaderIDFromTab( soapIdStr );
+    if ( nRet != DM_OK ) {
+      EXEC_ERROR( "The Header_ID %s of the soap message haven't been found in the",  soapIdStr);
+      EXEC_ERROR( "global array. That's not a response of a previous message!!" );
+    }
+
+    // Force the ACS Session to close.
+    _forceACSSessionToClose();
+
+  } else {
+    DBG("Perform Retry Request");
+    // Perform retry request.
+    _retryRequest();
+  }
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the GetRPCMethods RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processGetRPCMethods(GenericXmlNodePtr   rpcNode UNUSED,
+                      char              * soapIdStr,
+                      unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+
+  // -----------------------------------------------------------------
+  // GET RPC METHOD - BEGIN
+  // -----------------------------------------------------------------
+  // <soapenv:Envelope
+  //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
+  //	xmlns:xsd="http://www.w3.org/2001/XMLSchema" 
+  //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
+  // <soapenv:Header>
+  // <cwmp:ID soapenv:mustUnderstand="1"
+  //	xsi:type="xsd:string"
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1187869873996</cwmp:ID>
+  //</soapenv:Header>
+  // <soapenv:Body>
+  // <cwmp:GetRPCMethods
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0"/>
+  // </soapenv:Body>
+  // </soapenv:Envelope>
+  // -----------------------------------------------------------------
+
+  if (!DM_ENG_IS_GETRPCMETHODS_SUPPORTED) {
+  DBG( " The %s RPC method is not implemented.", RPC_GETRPCMETHODS);
+  // Send a fault SOAP message to the ACS server (NOK)
+  DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else { 
+    // The GET RPC Method is supported
+    DBG( " RPC_GETRPCMETHODS - Begin");
+    nRet = DM_SUB_GetRPCMethods( soapIdStr );
+    if ( nRet == DM_ERR ) {
+      EXEC_ERROR( "Result of the 'GetRPCMethods' method : NOK (%d) ", nRet );
     } else {
-      DBG("Perform Retry Request");
-      // Perform retry request.
-      _retryRequest();
+      DBG( "Result of the 'GetRPCMethods' : OK " );
     }
+    DBG( " RPC_GETRPCMETHODS - End");
+  } // end if(true != getRpcMethodSupportedOnDevice())
 
-  } else if(0 == strcmp( rpcCmmandTypeStr, RPC_GETRPCMETHODS )){
-    // -----------------------------------------------------------------
-    // GET RPC METHOD - BEGIN
-    // -----------------------------------------------------------------
-    // <soapenv:Envelope
-    //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
-    //	xmlns:xsd="http://www.w3.org/2001/XMLSchema" 
-    //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
-    // <soapenv:Header>
-    // <cwmp:ID soapenv:mustUnderstand="1"
-    //	xsi:type="xsd:string"
-    //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1187869873996</cwmp:ID>
-    //</soapenv:Header>
-    // <soapenv:Body>
-    // <cwmp:GetRPCMethods
-    //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0"/>
-    // </soapenv:Body>
-    // </soapenv:Envelope>
-    // -----------------------------------------------------------------
+  return( nRet );
+}
+
+/*
+* Private routine which processes the SetParameterValues RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processSetParameterValues(GenericXmlNodePtr   rpcNode,
+                           char              * soapIdStr,
+                           unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
 
-    if (!DM_ENG_IS_GETRPCMETHODS_SUPPORTED) {
-    DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
+  // -----------------------------------------------------------------
+  // NAME      = SETPARAMETERVALUES - BEGIN
+  // MANDATORY = YES
+  // -----------------------------------------------------------------
+  // <soapenv:Envelope
+  //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
+  //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
+  //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
+  // <soapenv:Header>
+  // <cwmp:ID soapenv:mustUnderstand="1"
+  //	xsi:type="xsd:string"
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1189610097240</cwmp:ID>
+  // </soapenv:Header>
+  // <soapenv:Body>
+  // <cwmp:SetParameterValues
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
+  //	<ParameterList>
+  //  <ParameterValueStruct>
+  //	  <Name xsi:type="xsd:string">Device.UserInterface.CurrentLanguage</Name>
+  //	  <Value xsi:type="xsd:string">fr</Value>
+  //  </ParameterValueStruct>
+  //	</ParameterList>
+  //	<ParameterKey/>
+  // </cwmp:SetParameterValues>
+  // </soapenv:Body>
+  // </soapenv:Envelope>
+  // -----------------------------------------------------------------
+
+  if (!DM_ENG_IS_SETPARAMETERVALUES_SUPPORTED) {
+    DBG( " The %s RPC method is not implemented.", RPC_SETPARAMETERVALUES);
     // Send a fault SOAP message to the ACS server (NOK)
     DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-    } else { 
-      // The GET RPC Method is supported
-      DBG( " RPC_GETRPCMETHODS - Begin");
-      nRet = DM_SUB_GetRPCMethods( soapIdStr );
-      if ( nRet == DM_ERR ) {
-        EXEC_ERROR( "Result of the 'GetRPCMethods' method : NOK (%d) ", nRet );
-      } else {
-        DBG( "Result of the 'GetRPCMethods' : OK " );
+  } else { 
+    // The feature is supported
+    GenericXmlNodeListPtr paramValStructNodeList = NULL;                                                             
+    GenericXmlNodePtr paramValueNode             = NULL;                                                             
+    GenericXmlNodePtr paramListNode = NULL; 
+    GenericXmlNodePtr paramKeyNode  = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERKEY);   
+    char          * parameterKeyValStr = NULL;
+    unsigned int    nbParamValStructNodes;
+    unsigned int    n;
+    char          * parameterNameStr  = NULL;
+    char          * parameterValueStr = NULL;
+    char          * pValTypeStr       = NULL;
+    int             valueTypeFound    = 0;
+
+    paramListNode = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERLIST);  
+    if(NULL == paramListNode) { // Make ACS and Karma Compatibility
+      paramListNode = xmlGetFirstNodeWithTagName(rpcDocNode, CWMP_PARAM_PARAMETERLIST);  
+    }
+
+    // Check nodes pointers
+    if((NULL == paramListNode) || (NULL == paramKeyNode)) {
+       EXEC_ERROR( "SETPARAMETERVALUES - Can not get parameters node" );
+	       // Send a fault SOAP message to the ACS server (NOK)
+	     DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+       return nRet;
+    }
+
+    // Retrieve the parameter key's string
+    xmlGetNodeParameters(paramKeyNode, NULL, &parameterKeyValStr);
+    if(NULL == parameterKeyValStr) {
+      DBG( "No content inside the ParameterKey tag (or empty value)" );
+      parameterKeyValStr = _EMPTY;
+    }
+
+    paramValStructNodeList = xmlGetNodesListWithTagName(paramListNode, PARAMETERVALUESTRUCT);
+
+    nbParamValStructNodes = xmlGetNodesListLength(paramValStructNodeList);
+
+    if(0 == nbParamValStructNodes) {
+       EXEC_ERROR( "PARAMETERVALUESTRUCT - No parameter to Set" );
+       // Send a fault SOAP message to the ACS server (NOK)
+       DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+       // Free the paramValStructNodeList
+       xmlFreeNodesList(paramValStructNodeList);
+       return nRet;
+    }
+
+    DM_ENG_ParameterValueStruct** pParameterList = DM_ENG_newTabParameterValueStruct(nbParamValStructNodes);
+
+    for(n = 0; n < nbParamValStructNodes; n++) {
+      GenericXmlDocumentPtr pvsNode = xmlNodeToDocument(xmlGetNodeFromNodesList(paramValStructNodeList, n));
+
+      // Read the Name and value of the parameter
+      xmlGetNodeParameters(xmlGetFirstNodeWithTagName(pvsNode, PARAM_NAME), NULL, &parameterNameStr);  
+
+      // Read the value/content of the parameter
+      paramValueNode = xmlGetFirstNodeWithTagName(pvsNode, PARAM_VALUE);
+      xmlGetNodeParameters(paramValueNode, NULL, &parameterValueStr);
+      if(NULL == parameterValueStr) {
+        // Set empty value
+        parameterValueStr = _EMPTY;
       }
-      DBG( " RPC_GETRPCMETHODS - End");
-    } // end if(true != getRpcMethodSupportedOnDevice())
-    
-  } else if(0 == strcmp( rpcCmmandTypeStr, RPC_SETPARAMETERVALUES )) {
+      pValTypeStr    = xmlGetAttributValue(paramValueNode, ATTR_TYPE);
+
+      // Check strings
+      if((NULL == parameterNameStr) || (NULL == parameterValueStr) || (NULL == pValTypeStr)){
+        EXEC_ERROR( "Some element(s) haven't been found in the soap message!!" );
+	        xmlFreeNodesList( paramValStructNodeList );
+         DM_ENG_deleteTabParameterValueStruct(pParameterList);
+        // Send a fault SOAP message to the ACS server (NOK)
+        DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+	        DM_ENG_FREE(pValTypeStr);
+
+        return nRet;
+      }
+
+      // Convert the Value Type
+      if(DM_OK != DM_FindTypeParameter(pValTypeStr, &valueTypeFound )){
+        EXEC_ERROR( "Invalid Value Type" );
+	        xmlFreeNodesList( paramValStructNodeList );
+         DM_ENG_deleteTabParameterValueStruct(pParameterList);
+        // Send a fault SOAP message to the ACS server (NOK)
+        DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+        DM_ENG_FREE(pValTypeStr);
+        return nRet;
+      }
+      DM_ENG_FREE(pValTypeStr);
+
+      // ------------------------------------------------------------
+      // Add the information to the ParameterList
+      // ------------------------------------------------------------
+      DBG( "Param.%d : Name = '%s', Value = '%s' ", n, parameterNameStr, parameterValueStr);
+      pParameterList[n] = DM_ENG_newParameterValueStruct(parameterNameStr,
+                                                         (DM_ENG_ParameterType) valueTypeFound,
+                                                         parameterValueStr );
+
+    } // end for each parameterValueStructNode
+
+    // Note: No need to set the last entry to NULL (it's already done above)
+
+    // ------------------------------------------------------------
+    // Launch the RPC method then analyse the result of the SetParameterValue RPC method
+    // ------------------------------------------------------------
+    nRet = DM_SUB_SetParameterValues( soapIdStr,
+                                      pParameterList,
+                                      parameterKeyValStr );
+    DBG( "DM_SUB_SetParameterValues Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
+
+    // ------------------------------------------------------------
+    // Free the memory previously allocated
+    // ------------------------------------------------------------ 
+    DM_ENG_deleteTabParameterValueStruct(pParameterList);
+
+    // Free the list
+    xmlFreeNodesList( paramValStructNodeList );
+  }
+
+  // -----------------------------------------------------------------
+  // RPC_SETPARAMETERVALUES - END
+  // -----------------------------------------------------------------
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the GetParameterValues RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processGetParameterValues(GenericXmlNodePtr   rpcNode,
+                           char              * soapIdStr,
+                           unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
+
     // -----------------------------------------------------------------
-    // NAME      = SETPARAMETERVALUES - BEGIN
+    // NAME      = GETPARAMETERVALUES
     // MANDATORY = YES
     // -----------------------------------------------------------------
     // <soapenv:Envelope
@@ -1172,195 +1437,41 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
     //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
     //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
     // <soapenv:Header>
-    // <cwmp:ID soapenv:mustUnderstand="1"
+    // <cwmp:ID
+    //	soapenv:mustUnderstand="1"
     //	xsi:type="xsd:string"
-    //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1189610097240</cwmp:ID>
+    //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1189688625500</cwmp:ID>
     // </soapenv:Header>
     // <soapenv:Body>
-    // <cwmp:SetParameterValues
-    //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
-    //	<ParameterList>
-    //  <ParameterValueStruct>
-    //	  <Name xsi:type="xsd:string">Device.UserInterface.CurrentLanguage</Name>
-    //	  <Value xsi:type="xsd:string">fr</Value>
-    //  </ParameterValueStruct>
-    //	</ParameterList>
-    //	<ParameterKey/>
-    // </cwmp:SetParameterValues>
+    // <cwmp:GetParameterValues xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
+    // <ParameterNames>
+    // 	<string xsi:type="xsd:string">Device.UserInterface.CurrentLanguage</string>
+    // </ParameterNames>
+    // </cwmp:GetParameterValues>
     // </soapenv:Body>
     // </soapenv:Envelope>
     // -----------------------------------------------------------------
-    
-    if (!DM_ENG_IS_SETPARAMETERVALUES_SUPPORTED) {
-      DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
+
+    if (!DM_ENG_IS_GETPARAMETERVALUES_SUPPORTED) {
+      DBG( " The %s RPC method is not implemented.", RPC_GETPARAMETERVALUES);
       // Send a fault SOAP message to the ACS server (NOK)
       DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
     } else { 
       // The feature is supported
-      GenericXmlNodeListPtr paramValStructNodeList = NULL;                                                             
-      GenericXmlNodePtr paramValueNode             = NULL;                                                             
-      GenericXmlNodePtr paramListNode = NULL; 
-      GenericXmlNodePtr paramKeyNode  = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERKEY);   
-      char          * parameterKeyValStr = NULL;
-      unsigned int    nbParamValStructNodes;
-      unsigned int    n;
-      char          * parameterNameStr  = NULL;
-      char          * parameterValueStr = NULL;
-      char          * pValTypeStr       = NULL;
-      int             valueTypeFound    = 0;
-    
-      paramListNode = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERLIST);  
-      if(NULL == paramListNode) { // Make ACS and Karma Compatibility
-        paramListNode = xmlGetFirstNodeWithTagName(rpcDocNode, CWMP_PARAM_PARAMETERLIST);  
-      }
-
-      // Check nodes pointers
-      if((NULL == paramListNode) || (NULL == paramKeyNode)) {
-         EXEC_ERROR( "SETPARAMETERVALUES - Can not get parameters node" );
-	       // Send a fault SOAP message to the ACS server (NOK)
-	     DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-         return nRet;
-      }
 
-      // Retrieve the parameter key's string
-      xmlGetNodeParameters(paramKeyNode, NULL, &parameterKeyValStr);
-      if(NULL == parameterKeyValStr) {
-        DBG( "No content inside the ParameterKey tag (or empty value)" );
-        parameterKeyValStr = _EMPTY;
-      }
+      DBG( " The %s RPC method is implemented.", RPC_GETPARAMETERVALUES);
 
-      paramValStructNodeList = xmlGetNodesListWithTagName(paramListNode, PARAMETERVALUESTRUCT);
-
-      nbParamValStructNodes = xmlGetNodesListLength(paramValStructNodeList);
-
-      if(0 == nbParamValStructNodes) {
-         EXEC_ERROR( "PARAMETERVALUESTRUCT - No parameter to Set" );
-         // Send a fault SOAP message to the ACS server (NOK)
-         DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-         // Free the paramValStructNodeList
-         xmlFreeNodesList(paramValStructNodeList);
-         return nRet;
-      }
-
-      DM_ENG_ParameterValueStruct** pParameterList = DM_ENG_newTabParameterValueStruct(nbParamValStructNodes);
-
-      for(n = 0; n < nbParamValStructNodes; n++) {
-        GenericXmlDocumentPtr pvsNode = xmlNodeToDocument(xmlGetNodeFromNodesList(paramValStructNodeList, n));
-      
-        // Read the Name and value of the parameter
-        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(pvsNode, PARAM_NAME), NULL, &parameterNameStr);  
-      
-        // Read the value/content of the parameter
-        paramValueNode = xmlGetFirstNodeWithTagName(pvsNode, PARAM_VALUE);
-        xmlGetNodeParameters(paramValueNode, NULL, &parameterValueStr);
-        if(NULL == parameterValueStr) {
-          // Set empty value
-          parameterValueStr = _EMPTY;
-        }
-        pValTypeStr    = xmlGetAttributValue(paramValueNode, ATTR_TYPE);
-
-        // Check strings
-        if((NULL == parameterNameStr) || (NULL == parameterValueStr) || (NULL == pValTypeStr)){
-          EXEC_ERROR( "Some element(s) haven't been found in the soap message!!" );
-	        xmlFreeNodesList( paramValStructNodeList );
-           DM_ENG_deleteTabParameterValueStruct(pParameterList);
-          // Send a fault SOAP message to the ACS server (NOK)
-          DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-	        DM_ENG_FREE(pValTypeStr);
-		
-          return nRet;
-        }
-
-        // Convert the Value Type
-        if(DM_OK != DM_FindTypeParameter(pValTypeStr, &valueTypeFound )){
-          EXEC_ERROR( "Invalid Value Type" );
-	        xmlFreeNodesList( paramValStructNodeList );
-           DM_ENG_deleteTabParameterValueStruct(pParameterList);
-          // Send a fault SOAP message to the ACS server (NOK)
-          DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-          DM_ENG_FREE(pValTypeStr);
-          return nRet;
-        }
-        DM_ENG_FREE(pValTypeStr);
-	
-        // ------------------------------------------------------------
-        // Add the information to the ParameterList
-        // ------------------------------------------------------------
-        DBG( "Param.%d : Name = '%s', Value = '%s' ", n, parameterNameStr, parameterValueStr);
-        pParameterList[n] = DM_ENG_newParameterValueStruct(parameterNameStr,
-                                                           (DM_ENG_ParameterType) valueTypeFound,
-                                                           parameterValueStr );
-
-      } // end for each parameterValueStructNode
-       
-      // Note: No need to set the last entry to NULL (it's already done above)
-
-      // ------------------------------------------------------------
-      // Launch the RPC method then analyse the result of the SetParameterValue RPC method
-      // ------------------------------------------------------------
-      nRet = DM_SUB_SetParameterValues( soapIdStr,
-                                        pParameterList,
-                                        parameterKeyValStr );
-      DBG( "DM_SUB_SetParameterValues Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
-
-      // ------------------------------------------------------------
-      // Free the memory previously allocated
-      // ------------------------------------------------------------ 
-      DM_ENG_deleteTabParameterValueStruct(pParameterList);
-
-      // Free the list
-      xmlFreeNodesList( paramValStructNodeList );
-    }
-    
-    // -----------------------------------------------------------------
-    // RPC_SETPARAMETERVALUES - END
-    // -----------------------------------------------------------------
-
-    } else if(0 == strcmp( rpcCmmandTypeStr, RPC_GETPARAMETERVALUES )){
-    // -----------------------------------------------------------------
-    // NAME      = GETPARAMETERVALUES
-    // MANDATORY = YES
-    // -----------------------------------------------------------------
-    // <soapenv:Envelope
-    //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
-    //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
-    //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
-    // <soapenv:Header>
-    // <cwmp:ID
-    //	soapenv:mustUnderstand="1"
-    //	xsi:type="xsd:string"
-    //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1189688625500</cwmp:ID>
-    // </soapenv:Header>
-    // <soapenv:Body>
-    // <cwmp:GetParameterValues xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
-    // <ParameterNames>
-    // 	<string xsi:type="xsd:string">Device.UserInterface.CurrentLanguage</string>
-    // </ParameterNames>
-    // </cwmp:GetParameterValues>
-    // </soapenv:Body>
-    // </soapenv:Envelope>
-    // -----------------------------------------------------------------
-    
-    if (!DM_ENG_IS_GETPARAMETERVALUES_SUPPORTED) {
-      DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
-      // Send a fault SOAP message to the ACS server (NOK)
-      DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-    } else { 
-      // The feature is supported
-     
-      DBG( " The %s RPC method is implemented.", rpcCmmandTypeStr);
-      
       GenericXmlNodePtr      paramNamesNode      = NULL; 
       GenericXmlNodePtr      paramNamesChildNode = NULL;
       GenericXmlNodeListPtr  paramNamesList      = NULL;
-    
+
       paramNamesNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERNAMES); 
       if(NULL == paramNamesNode) {
         // Try to find cwmp:ParameterNames (for ACS and Karma compatibility)
         DBG("NO %s try to find %s", PARAM_PARAMETERNAMES, CWMP_PARAM_PARAMETERNAMES);
         paramNamesNode      = xmlGetFirstNodeWithTagName(rpcDocNode, CWMP_PARAM_PARAMETERNAMES); 
       }
-    
+
       unsigned int    nbParameter = 0;
       unsigned int    n = 0;
       char          * parameterNameStr    = NULL;
@@ -1385,7 +1496,7 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
 
       // Get the number of element to retrieve
       nbParameter = xmlGetNodesListLength(paramNamesList);
-    
+
       char** pChildParamName = (char**)calloc(nbParameter+1, sizeof(char*)); // calloc set memory to 0x00
 
       // Loop through all the parameters
@@ -1394,7 +1505,7 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
         // Read the Name of the parameter
         parameterNameStr = NULL;
         xmlGetNodeParameters(paramNamesChildNode, NULL, &parameterNameStr);
-      
+
         if(NULL == parameterNameStr) {
 	        // Set "" root
 	        WARN("No parameter specified for GetParameterValues. Set root parameter");
@@ -1426,106 +1537,120 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
     // RPC_GETPARAMETERVALUES - END
     // -----------------------------------------------------------------
 
-    }  else if (0 == strcmp( rpcCmmandTypeStr, RPC_SETPARAMETERATTRIBUTES )){
-      // -----------------------------------------------------------------
-      // NAME      = RPC_SETPARAMETERATTRIBUTES
-      // MANDATORY = YES
-      // -----------------------------------------------------------------
- 
-     if (!DM_ENG_IS_SETPARAMETERATTRIBUTES_SUPPORTED) {
-       DBG(" The %s RPC method is not implemented.", rpcCmmandTypeStr);
-       // Send a fault SOAP message to the ACS server (NOK)
-       DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-     } else {
-        DBG(" The %s RPC method is implemented.", rpcCmmandTypeStr);
-        // The feature is supported
+  return( nRet );
+}
+
+/*
+* Private routine which processes the SetParameterAttributes RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processSetParameterAttributes(GenericXmlNodePtr   rpcNode,
+                               char              * soapIdStr,
+                               unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
+
+   // -----------------------------------------------------------------
+   // NAME      = RPC_SETPARAMETERATTRIBUTES
+   // MANDATORY = YES
+   // -----------------------------------------------------------------
+
+  if (!DM_ENG_IS_SETPARAMETERATTRIBUTES_SUPPORTED) {
+    DBG(" The %s RPC method is not implemented.", RPC_SETPARAMETERATTRIBUTES);
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else {
+     DBG(" The %s RPC method is implemented.", RPC_SETPARAMETERATTRIBUTES);
+     // The feature is supported
 
-        // Retrieve the ParameterList XML Node
+     // Retrieve the ParameterList XML Node
 	     GenericXmlNodePtr paramListNode = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERLIST); 
-        if(NULL == paramListNode) { // Make ACS and Karma Compatibility
-          paramListNode = xmlGetFirstNodeWithTagName(rpcDocNode, CWMP_PARAM_PARAMETERLIST);  
-        }
-	
+     if(NULL == paramListNode) { // Make ACS and Karma Compatibility
+       paramListNode = xmlGetFirstNodeWithTagName(rpcDocNode, CWMP_PARAM_PARAMETERLIST);  
+     }
+
 	      if(NULL == paramListNode) {
 	    	  // Send a fault SOAP message to the ACS server (NOK)
 		      EXEC_ERROR("No Parameter List in the Message");
-          DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+       DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
 	        return nRet;
 	      }
-       
-        // Retrieve the SetParameterAttributesStruct Nodes list
-        GenericXmlNodeListPtr paramAttributeStructNodeList = xmlGetNodesListWithTagName(paramListNode, SETPARAMETERATTRIBUTESSTRUCT);
-	
+
+     // Retrieve the SetParameterAttributesStruct Nodes list
+     GenericXmlNodeListPtr paramAttributeStructNodeList = xmlGetNodesListWithTagName(paramListNode, SETPARAMETERATTRIBUTESSTRUCT);
+
 	      if(NULL == paramAttributeStructNodeList) {
 	        // TEMP - Workaround for ACS Bug
 	        WARN("No %s. Search %s for ACS Compatibility", SETPARAMETERATTRIBUTESSTRUCT, PARAMETERATTIBUTESSTRUCT);
 		      paramAttributeStructNodeList = xmlGetNodesListWithTagName(paramListNode, PARAMETERATTIBUTESSTRUCT);
 	      }
-	
+
 	      // Retrieve the node list size
-        unsigned int nbParamAttributeStructNodes = xmlGetNodesListLength(paramAttributeStructNodeList);  
+     unsigned int nbParamAttributeStructNodes = xmlGetNodesListLength(paramAttributeStructNodeList);  
+
+     if(0 == nbParamAttributeStructNodes) {
+       WARN( "Set Parameter Attributes - No parameter to Set" );
+       // Send a fault SOAP message to the ACS server (NOK)
+       DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+       // Free the paramValStructNodeList
+       xmlFreeNodesList(paramAttributeStructNodeList);
+       return nRet;
+     }
 
-        if(0 == nbParamAttributeStructNodes) {
-          WARN( "Set Parameter Attributes - No parameter to Set" );
-          // Send a fault SOAP message to the ACS server (NOK)
-          DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-          // Free the paramValStructNodeList
-          xmlFreeNodesList(paramAttributeStructNodeList);
-          return nRet;
-        }
-        
 	      // Allocate memory for the ParameterAttributesStruct Array
-        DM_ENG_ParameterAttributesStruct ** pParameterList = DM_ENG_newTabParameterAttributesStruct(nbParamAttributeStructNodes);
-	
-        unsigned int n;
-        for(n = 0; n < nbParamAttributeStructNodes ; n++)
-        {
-           GenericXmlDocumentPtr pasNode = xmlNodeToDocument(xmlGetNodeFromNodesList(paramAttributeStructNodeList, n));
+     DM_ENG_ParameterAttributesStruct ** pParameterList = DM_ENG_newTabParameterAttributesStruct(nbParamAttributeStructNodes);
 
-           char* paramNameStr = NULL;
-           char* paramNotificationChangeFlagStr = NULL;
-           char* paramNotificationChangeValStr = NULL;
-           char* paramAccessListChangeFlagStr = NULL;
+     unsigned int n;
+     for(n = 0; n < nbParamAttributeStructNodes ; n++)
+     {
+        GenericXmlDocumentPtr pasNode = xmlNodeToDocument(xmlGetNodeFromNodesList(paramAttributeStructNodeList, n));
 
-           bool notificationChange = false;
-           bool accessListChange = false;
+        char* paramNameStr = NULL;
+        char* paramNotificationChangeFlagStr = NULL;
+        char* paramNotificationChangeValStr = NULL;
+        char* paramAccessListChangeFlagStr = NULL;
 
-           char** accessListArray = NULL;
-           DM_ENG_NotificationMode notification;
+        bool notificationChange = false;
+        bool accessListChange = false;
+
+        char** accessListArray = NULL;
+        DM_ENG_NotificationMode notification;
 
 		     // Read the Name, the Notifcation Change flag, the Notification and the AccessList
 	        // Retrieve the Name Node
 	        GenericXmlNodePtr paramNameNode = xmlGetFirstNodeWithTagName(pasNode, PARAM_NAME);
 
 	        // Retrieve the Notification Change Flag Node
-           GenericXmlNodePtr paramNotificationChangeFlagNode = xmlGetFirstNodeWithTagName(pasNode, PARAM_NOTIFICATION_CHANGE);	  
+        GenericXmlNodePtr paramNotificationChangeFlagNode = xmlGetFirstNodeWithTagName(pasNode, PARAM_NOTIFICATION_CHANGE);	  
 
 	        // Retrieve the Access List Change Flag Node
-           GenericXmlNodePtr paramAccessListChangeFlagNode = xmlGetFirstNodeWithTagName(pasNode, PARAM_ACCESSLIST_CHANGE);
+        GenericXmlNodePtr paramAccessListChangeFlagNode = xmlGetFirstNodeWithTagName(pasNode, PARAM_ACCESSLIST_CHANGE);
 
-           if((NULL != paramNameNode) && (NULL != paramNotificationChangeFlagNode) && (NULL != paramAccessListChangeFlagNode))
-           {
+        if((NULL != paramNameNode) && (NULL != paramNotificationChangeFlagNode) && (NULL != paramAccessListChangeFlagNode))
+        {
 				   // Retrieve the node's values
 				   xmlGetNodeParameters(paramNameNode,                   NULL, &paramNameStr);
 				   xmlGetNodeParameters(paramNotificationChangeFlagNode, NULL, &paramNotificationChangeFlagStr);
-               DM_ENG_stringToBool(paramNotificationChangeFlagStr, &notificationChange);
+            DM_ENG_stringToBool(paramNotificationChangeFlagStr, &notificationChange);
 
 				   xmlGetNodeParameters(paramAccessListChangeFlagNode,   NULL, &paramAccessListChangeFlagStr);
-               DM_ENG_stringToBool(paramAccessListChangeFlagStr, &accessListChange);
-				   
+            DM_ENG_stringToBool(paramAccessListChangeFlagStr, &accessListChange);
+
 				   if (NULL != paramNameStr)
-               {
+            {
 				      // Check paramNotificationChangeFlagStr Change required
 				      if (notificationChange)
-                  {
+               {
 				        DBG("Notification flag set to true");
-                // Retrieve the Notification Change Value
-                GenericXmlNodePtr paramNotificationChangeValNode = xmlGetFirstNodeWithTagName(pasNode, PARAM_NOTIFICATION);		
+             // Retrieve the Notification Change Value
+             GenericXmlNodePtr paramNotificationChangeValNode = xmlGetFirstNodeWithTagName(pasNode, PARAM_NOTIFICATION);		
 		            xmlGetNodeParameters(paramNotificationChangeValNode, NULL, &paramNotificationChangeValStr);
-               if(NULL != paramNotificationChangeValStr) {
-                  int notif;
-                 DM_ENG_stringToInt(paramNotificationChangeValStr, &notif);
-                 notification = (DM_ENG_NotificationMode)notif;
+            if(NULL != paramNotificationChangeValStr) {
+               int notif;
+              DM_ENG_stringToInt(paramNotificationChangeValStr, &notif);
+              notification = (DM_ENG_NotificationMode)notif;
 	              } else {
 		              WARN("No Value for Parameter Notification Change - Set it to undefined");
 		              notification = DM_ENG_NotificationMode_UNDEFINED;
@@ -1538,61 +1663,61 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
 
 				      // Check paramAccessListChangeFlagStr Change required
 				      if (accessListChange)
-                  {
+               {
 				         DBG("Access List flag set to true");
 
 			            // Retrieve the AccessList node
-                     GenericXmlNodePtr paramAccessListNode =  xmlGetFirstNodeWithTagName(pasNode, PARAM_ACCESSLIST);
-
-                     if(NULL == paramAccessListNode) {
-                       EXEC_ERROR( "Missing AccessList in SetParameterAttributes RPC Command" );
-                      // Send a fault SOAP message to the ACS server (NOK)
-                       DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-                       return nRet;
-                     }
-
-                     unsigned int    nbAccessList = 0;
-                     char          * accessListStr    = NULL;
-
-                     // Retrieve the list of strings
-                     GenericXmlNodePtr paramAccessListStringNodeList = xmlGetChildNodesList(paramAccessListNode);
-
-                     // Check the list is not empty
-                     if(NULL == paramAccessListStringNodeList) {
-                       EXEC_ERROR( "Missing AccessList in SetParameterAttributes RPC Command" );
-                      // Send a fault SOAP message to the ACS server (NOK)
-                       DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-                       return nRet;
-                     }
-
-                     // Get the number of element to retrieve
-                     nbAccessList = xmlGetNodesListLength(paramAccessListStringNodeList);
-                     DBG("AccessList size = %d", nbAccessList);
-
-                     // Allocate memory for the Acces List Array
-                     accessListArray = (char**)calloc(nbAccessList+1, sizeof(char*)); // calloc set memory to 0x00
-
-                     // Loop through all the parameters
-                     unsigned int i = 0;
-                     for(i = 0; i < nbAccessList; i++) {
-                       GenericXmlNodePtr accessListChildNode = xmlGetNodeFromNodesList(paramAccessListStringNodeList, i);
-                       // Read the Name of the parameter
-                       accessListStr = NULL;
-                       xmlGetNodeParameters(accessListChildNode, NULL, &accessListStr);
-                       DBG("AccessList Value %d/%d = %s", i, nbAccessList, accessListStr);
-
-                       // Store the name 
-                       accessListArray[i] = (accessListStr == NULL ? _EMPTY : accessListStr);
-                     }
-
-                     // Free the list
-                     xmlFreeNodesList( paramAccessListStringNodeList );
+                  GenericXmlNodePtr paramAccessListNode =  xmlGetFirstNodeWithTagName(pasNode, PARAM_ACCESSLIST);
+
+                  if(NULL == paramAccessListNode) {
+                    EXEC_ERROR( "Missing AccessList in SetParameterAttributes RPC Command" );
+                   // Send a fault SOAP message to the ACS server (NOK)
+                    DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+                    return nRet;
+                  }
+
+                  unsigned int    nbAccessList = 0;
+                  char          * accessListStr    = NULL;
+
+                  // Retrieve the list of strings
+                  GenericXmlNodePtr paramAccessListStringNodeList = xmlGetChildNodesList(paramAccessListNode);
+
+                  // Check the list is not empty
+                  if(NULL == paramAccessListStringNodeList) {
+                    EXEC_ERROR( "Missing AccessList in SetParameterAttributes RPC Command" );
+                   // Send a fault SOAP message to the ACS server (NOK)
+                    DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+                    return nRet;
+                  }
+
+                  // Get the number of element to retrieve
+                  nbAccessList = xmlGetNodesListLength(paramAccessListStringNodeList);
+                  DBG("AccessList size = %d", nbAccessList);
+
+                  // Allocate memory for the Acces List Array
+                  accessListArray = (char**)calloc(nbAccessList+1, sizeof(char*)); // calloc set memory to 0x00
+
+                  // Loop through all the parameters
+                  unsigned int i = 0;
+                  for(i = 0; i < nbAccessList; i++) {
+                    GenericXmlNodePtr accessListChildNode = xmlGetNodeFromNodesList(paramAccessListStringNodeList, i);
+                    // Read the Name of the parameter
+                    accessListStr = NULL;
+                    xmlGetNodeParameters(accessListChildNode, NULL, &accessListStr);
+                    DBG("AccessList Value %d/%d = %s", i, nbAccessList, accessListStr);
+
+                    // Store the name 
+                    accessListArray[i] = (accessListStr == NULL ? _EMPTY : accessListStr);
+                  }
+
+                  // Free the list
+                  xmlFreeNodesList( paramAccessListStringNodeList );
 				      }
 
 				      // Add the parameter structure into the parameter structure list
 				      DBG("Param: %s, Notification: %d, AccesssList[0]: %s", paramNameStr, notification, (accessListArray == NULL ? "NULL" : accessListArray[0]));
 				      pParameterList[n] = DM_ENG_newParameterAttributesStruct(paramNameStr, notification, accessListArray);
-                  if (accessListArray != NULL) { free(accessListArray); }
+               if (accessListArray != NULL) { free(accessListArray); }
 
 				   } else {
 				     // Error invalid parameter
@@ -1607,38 +1732,52 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
 
 	      // Set the parameters Attributs
 	      DM_SUB_SetParameterAttributes(soapIdStr, pParameterList);	      
-	      
+
 	      // Free the Tab
 	      DM_ENG_deleteTabParameterAttributesStruct(pParameterList);
-	      
+
 	      // Free the Node list
 	      xmlFreeNodesList(paramAttributeStructNodeList);
-      }
+   }
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the GetParameterAttributes RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processGetParameterAttributes(GenericXmlNodePtr   rpcNode,
+                               char              * soapIdStr,
+                               unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
 
-    } else if (0 ==  strcmp( rpcCmmandTypeStr, RPC_GETPARAMETERATTRIBUTES )){
       // -----------------------------------------------------------------
       // NAME      = RPC_GETPARAMETERATTRIBUTES
       // MANDATORY = YES
       // -----------------------------------------------------------------
-      DBG( " The RPC method '%s' have been found", rpcCmmandTypeStr );
-      
+      DBG( " The RPC method '%s' have been found", RPC_GETPARAMETERATTRIBUTES );
+
       if (!DM_ENG_IS_GETPARAMETERATTRIBUTES_SUPPORTED) {
-        DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
+        DBG( " The %s RPC method is not implemented.", RPC_GETPARAMETERATTRIBUTES);
         // Send a fault SOAP message to the ACS server (NOK)
         DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
       } else {
-        DBG( " The %s RPC method is implemented.", rpcCmmandTypeStr);
+        DBG( " The %s RPC method is implemented.", RPC_GETPARAMETERATTRIBUTES);
         GenericXmlNodePtr      paramNamesNode      = NULL; 
         GenericXmlNodePtr      paramNamesChildNode = NULL;
         GenericXmlNodeListPtr  paramNamesList      = NULL; 
-	
+
         paramNamesNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERNAMES); 
         if(NULL == paramNamesNode) {
           // Try to find cwmp:ParameterNames (for ACS and Karma compatibility)
           DBG("NO %s try to find %s", PARAM_PARAMETERNAMES, CWMP_PARAM_PARAMETERNAMES);
           paramNamesNode      = xmlGetFirstNodeWithTagName(rpcDocNode, CWMP_PARAM_PARAMETERNAMES); 
         }	
-	
+
         if(NULL == paramNamesNode) {
           EXEC_ERROR( "No ParameterNames Node for GETPARAMETERATTRIBUTES RPC Command" );
 	    	  // Send a fault SOAP message to the ACS server (NOK)
@@ -1660,207 +1799,265 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
           DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
           return nRet;
         }		
-	
+
         // Get the number of element to retrieve
         nbParameter = xmlGetNodesListLength(paramNamesList);
 	      DBG("**** RPC_GETPARAMETERATTRIBUTES - nbParameter = %d ****", nbParameter);
-    
+
 	      char** pChildParamNameArray = (char**)calloc(nbParameter+1, sizeof(char*)); // calloc set memory to 0x00
 
         // Loop through all the parameters
         for(n = 0; n < nbParameter; n++) {
           paramNamesChildNode = xmlGetNodeFromNodesList(paramNamesList, n);
-  
+
           // Read the Name of the parameter
           parameterNameStr = NULL;
           xmlGetNodeParameters(paramNamesChildNode, NULL, &parameterNameStr);
-      
+
           if(NULL == parameterNameStr) {
 	          // Set "/" root
 	          WARN("No parameter specified for GetParameterAttributes. Set root parameter");
 	          parameterNameStr = _EMPTY;	
 	       }
- 	  
+
 	       // Store the name 
           pChildParamNameArray[n] = strdup ( parameterNameStr );
           DBG( "Param.%d/%d = '%s' ", n, nbParameter, pChildParamNameArray[n] );
         } // end for
 
 	      // No need to set the last entry to NULL (it's already done by the calloc)
-		    	 
+
         // --------------------------------------------------------------
         // Launch the GetParameterAttributes RPC Method and analyse its result 
         // --------------------------------------------------------------
         nRet = DM_SUB_GetParameterAttributes( soapIdStr, (const char**)pChildParamNameArray );
-    
+
         DBG( "DM_SUB_GetParameterAttributes Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
 
         // Free the list
         xmlFreeNodesList( paramNamesList );
-    
+
         // Free pChildParamNameArray
         DM_ENG_deleteTabString(pChildParamNameArray);
       }
 
-    } else if (0 ==  strcmp( rpcCmmandTypeStr, RPC_GETPARAMETERNAMES )){
-      // -----------------------------------------------------------------
-      // NAME      = RPC_GETPARAMETERNAMES
-      // MANDATORY = YES
-      // -----------------------------------------------------------------
-			DBG( " The RPC method '%s' have been found", rpcCmmandTypeStr );
-      if (!DM_ENG_IS_GETPARAMETERNAMES_SUPPORTED) {
-        DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
-        // Send a fault SOAP message to the ACS server (NOK)
-        DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-      } else { 
-        // The feature is supported
+  return( nRet );
+}
+
+/*
+* Private routine which processes the GetParameterNames RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processGetParameterNames(GenericXmlNodePtr   rpcNode,
+                          char              * soapIdStr,
+                          unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
+
+  // -----------------------------------------------------------------
+  // NAME      = RPC_GETPARAMETERNAMES
+  // MANDATORY = YES
+  // -----------------------------------------------------------------
+			DBG( " The RPC method '%s' have been found", RPC_GETPARAMETERNAMES );
+  if (!DM_ENG_IS_GETPARAMETERNAMES_SUPPORTED) {
+    DBG( " The %s RPC method is not implemented.", RPC_GETPARAMETERNAMES);
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else { 
+    // The feature is supported
 			  char 	            * pValParameterPath     = NULL;
 			  char 	            * pValNextLevel         = NULL;			
-        GenericXmlNodePtr   pValParameterPathNode = NULL; 
-        GenericXmlNodePtr   pValNextLevelNode     = NULL;       
-    
-        pValParameterPathNode  = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERPATH); 
-        xmlGetNodeParameters(pValParameterPathNode, NULL, &pValParameterPath);
-      
-        pValNextLevelNode = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_NEXTLEVEL); 
-        xmlGetNodeParameters(pValNextLevelNode, NULL, &pValNextLevel);
-	
-        bool bNextLevel;
+    GenericXmlNodePtr   pValParameterPathNode = NULL; 
+    GenericXmlNodePtr   pValNextLevelNode     = NULL;       
+
+    pValParameterPathNode  = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERPATH); 
+    xmlGetNodeParameters(pValParameterPathNode, NULL, &pValParameterPath);
+
+    pValNextLevelNode = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_NEXTLEVEL); 
+    xmlGetNodeParameters(pValNextLevelNode, NULL, &pValNextLevel);
+
+    bool bNextLevel;
 		  if (DM_ENG_stringToBool(pValNextLevel, &bNextLevel))
-        {
-           if (NULL == pValParameterPath) { pValParameterPath = (char*)DM_ENG_PARAMETER_PREFIX; }
-	   
-           DBG( " RPC method = DM_SUB_GetParameterNames( '%s' , '%s' ) ", pValParameterPath, pValNextLevel );
-           nRet = DM_SUB_GetParameterNames( soapIdStr, pValParameterPath, bNextLevel);
-	   
-          if ( nRet != 0 ) {
-            EXEC_ERROR( "Result of the 'DM_SUB_GetParameterNames' method : NOK (%d) ", nRet );
-          } else {
-            DBG( "Result of the 'DM_SUB_GetParameterNames' method : OK " );
-          }
-        } else {
+    {
+       if (NULL == pValParameterPath) { pValParameterPath = (char*)DM_ENG_PARAMETER_PREFIX; }
+
+       DBG( " RPC method = DM_SUB_GetParameterNames( '%s' , '%s' ) ", pValParameterPath, pValNextLevel );
+       nRet = DM_SUB_GetParameterNames( soapIdStr, pValParameterPath, bNextLevel);
+
+      if ( nRet != 0 ) {
+        EXEC_ERROR( "Result of the 'DM_SUB_GetParameterNames' method : NOK (%d) ", nRet );
+      } else {
+        DBG( "Result of the 'DM_SUB_GetParameterNames' method : OK " );
+      }
+    } else {
 	        DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
 				  EXEC_ERROR( "One of the two parameters 'ObjectName' or 'ParameterKey' expected by the " );
 				  EXEC_ERROR( "'DM_SUB_GetParameterNames' RPC method haven't been found in the soap message!!" );
 			  }
 	     } // end feature is supported
-    } else if (0 ==  strcmp( rpcCmmandTypeStr, RPC_ADDOBJECT )){
-      // -----------------------------------------------------------------
-      // NAME      = RPC_ADDOBJECT
-      // MANDATORY = YES
-      // -----------------------------------------------------------------
-			DBG( " The RPC method '%s' have been found", rpcCmmandTypeStr );
-      if (!DM_ENG_IS_ADDOBJECT_SUPPORTED) {
-        DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
-        // Send a fault SOAP message to the ACS server (NOK)
-        DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-      } else { 
-        // The feature is supported
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the AddObject RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processAddObject(GenericXmlNodePtr   rpcNode,
+                  char              * soapIdStr,
+                  unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
+
+  // -----------------------------------------------------------------
+  // NAME      = RPC_ADDOBJECT
+  // MANDATORY = YES
+  // -----------------------------------------------------------------
+			DBG( " The RPC method '%s' have been found", RPC_ADDOBJECT );
+  if (!DM_ENG_IS_ADDOBJECT_SUPPORTED) {
+    DBG( " The %s RPC method is not implemented.", RPC_ADDOBJECT);
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else { 
+    // The feature is supported
 			  char 	          * pValObjectName   = NULL;
 			  char 	          * pValParameterKey = NULL;			
-        GenericXmlNodePtr objNode          = NULL; 
-        GenericXmlNodePtr paramKeyNode     = NULL;       
-    
-        objNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_OBJECTNAME); 
-        xmlGetNodeParameters(objNode, NULL, &pValObjectName);
-      
-        paramKeyNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERKEY);
-        if (paramKeyNode != NULL)
-        {
-           xmlGetNodeParameters(paramKeyNode, NULL, &pValParameterKey);
-           if (NULL == pValParameterKey) { pValParameterKey = _EMPTY; }
-        }
+    GenericXmlNodePtr objNode          = NULL; 
+    GenericXmlNodePtr paramKeyNode     = NULL;       
+
+    objNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_OBJECTNAME); 
+    xmlGetNodeParameters(objNode, NULL, &pValObjectName);
+
+    paramKeyNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERKEY);
+    if (paramKeyNode != NULL)
+    {
+       xmlGetNodeParameters(paramKeyNode, NULL, &pValParameterKey);
+       if (NULL == pValParameterKey) { pValParameterKey = _EMPTY; }
+    }
 
 		  if ((pValObjectName != NULL) && (pValParameterKey != NULL)){
-          DBG( " RPC method = AddObject( '%s' , '%s' ) ", (char*)pValObjectName, (char*)pValParameterKey );
-          nRet = DM_SUB_AddObject( soapIdStr,
-                                  (char*)pValObjectName,
-                                  (char*)pValParameterKey );
-          if ( nRet != 0 ) {
-            EXEC_ERROR( "Result of the 'AddObject' method : NOK (%d) ", nRet );
-          } else {
-            DBG( "Result of the 'AddObject' method : OK " );
-          }
-        } else {
+      DBG( " RPC method = AddObject( '%s' , '%s' ) ", (char*)pValObjectName, (char*)pValParameterKey );
+      nRet = DM_SUB_AddObject( soapIdStr,
+                              (char*)pValObjectName,
+                              (char*)pValParameterKey );
+      if ( nRet != 0 ) {
+        EXEC_ERROR( "Result of the 'AddObject' method : NOK (%d) ", nRet );
+      } else {
+        DBG( "Result of the 'AddObject' method : OK " );
+      }
+    } else {
 	        DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
 				  EXEC_ERROR( "One of the two parameters 'ObjectName' or 'ParameterKey' expected by the " );
 				  EXEC_ERROR( "'AddObject' RPC method haven't been found in the soap message!!" );
 			  }	
 			}
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_DELETEOBJECT )){
-      // -----------------------------------------------------------------
-      // NAME      = RPC_DELETEOBJECT
-      // MANDATORY = YES
-      // -----------------------------------------------------------------
 
-			DBG( " The RPC method '%s' have been found", rpcCmmandTypeStr );
-      if (!DM_ENG_IS_DELETEOBJECT_SUPPORTED) {
-        DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
-        // Send a fault SOAP message to the ACS server (NOK)
-        DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-      } else { 
-        // The feature is supported
-        char 	            * pValObjectName   = NULL;
+  return( nRet );
+}
+
+/*
+* Private routine which processes the DeleteObject RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processDeleteObject(GenericXmlNodePtr   rpcNode,
+                     char              * soapIdStr,
+                     unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
+
+  // -----------------------------------------------------------------
+  // NAME      = RPC_DELETEOBJECT
+  // MANDATORY = YES
+  // -----------------------------------------------------------------
+
+			DBG( " The RPC method '%s' have been found", RPC_DELETEOBJECT );
+  if (!DM_ENG_IS_DELETEOBJECT_SUPPORTED) {
+    DBG( " The %s RPC method is not implemented.", RPC_DELETEOBJECT);
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else { 
+    // The feature is supported
+    char 	            * pValObjectName   = NULL;
 			  char 	            * pValParameterKey = NULL;			
-        GenericXmlNodePtr   objNode          = NULL; 
-        GenericXmlNodePtr   paramKeyNode     = NULL;       
-    
-        objNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_OBJECTNAME); 
-        xmlGetNodeParameters(objNode, NULL, &pValObjectName);
-      
-        paramKeyNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERKEY); 
-        if (paramKeyNode != NULL)
-        {
-           xmlGetNodeParameters(paramKeyNode, NULL, &pValParameterKey);
-           if (NULL == pValParameterKey) { pValParameterKey = _EMPTY; }
-        }
+    GenericXmlNodePtr   objNode          = NULL; 
+    GenericXmlNodePtr   paramKeyNode     = NULL;       
+
+    objNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_OBJECTNAME); 
+    xmlGetNodeParameters(objNode, NULL, &pValObjectName);
+
+    paramKeyNode      = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_PARAMETERKEY); 
+    if (paramKeyNode != NULL)
+    {
+       xmlGetNodeParameters(paramKeyNode, NULL, &pValParameterKey);
+       if (NULL == pValParameterKey) { pValParameterKey = _EMPTY; }
+    }
 
 		  if ((pValObjectName != NULL) && (pValParameterKey != NULL)){
-          DBG( " RPC method = DeleteObject( '%s' , '%s' ) ", (char*)pValObjectName, (char*)pValParameterKey );
-          nRet = DM_SUB_DeleteObject( soapIdStr,
-                                     (char*)pValObjectName,
-                                     (char*)pValParameterKey );
-          if ( nRet != 0 ) {
-            EXEC_ERROR( "Result of the 'DeleteObject' method : NOK (%d) ", nRet );
-          } else {
-            DBG( "Result of the 'DeleteObject' method : OK " );
-          }
-        } else {
+      DBG( " RPC method = DeleteObject( '%s' , '%s' ) ", (char*)pValObjectName, (char*)pValParameterKey );
+      nRet = DM_SUB_DeleteObject( soapIdStr,
+                                 (char*)pValObjectName,
+                                 (char*)pValParameterKey );
+      if ( nRet != 0 ) {
+        EXEC_ERROR( "Result of the 'DeleteObject' method : NOK (%d) ", nRet );
+      } else {
+        DBG( "Result of the 'DeleteObject' method : OK " );
+      }
+    } else {
 	        DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
 				  EXEC_ERROR( "One of the two parameters 'ObjectName' or 'ParameterKey' expected by the " );
 				  EXEC_ERROR( "'DeleteObject' RPC method haven't been found in the soap message!!" );
 			  }
-		  }   // end if feature is supported   
-      
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_REBOOT )){
-      // -----------------------------------------------------------------
-      // NAME      = RPC_REBOOT
-      // MANDATORY = YES
-      // -----------------------------------------------------------------
-      
-			DBG( " The RPC method '%s' have been found", rpcCmmandTypeStr );
-      if (!DM_ENG_IS_REBOOT_SUPPORTED) {
-        DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
-        // Send a fault SOAP message to the ACS server (NOK)
-        DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-      } else { 
-        // The feature is supported
+		  }   // end if feature is supported
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the Reboot RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processReboot(GenericXmlNodePtr   rpcNode,
+               char              * soapIdStr,
+               unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
+
+  // -----------------------------------------------------------------
+  // NAME      = RPC_REBOOT
+  // MANDATORY = YES
+  // -----------------------------------------------------------------
+
+			DBG( " The RPC method '%s' have been found", RPC_REBOOT );
+  if (!DM_ENG_IS_REBOOT_SUPPORTED) {
+    DBG( " The %s RPC method is not implemented.", RPC_REBOOT);
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else { 
+    // The feature is supported
+
+    GenericXmlNodePtr   pRefCommandKey  = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_COMMANDKEY);
+    if (NULL == pRefCommandKey)
+    {
+       // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
+       pRefCommandKey = xmlGetFirstNodeWithTagName(rpcDocNode, CWMP_PARAM_COMMANDKEY);
+    }
 
-        GenericXmlNodePtr   pRefCommandKey  = xmlGetFirstNodeWithTagName(rpcDocNode, PARAM_COMMANDKEY);
-        if (NULL == pRefCommandKey)
-        {
-           // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
-           pRefCommandKey = xmlGetFirstNodeWithTagName(rpcDocNode, CWMP_PARAM_COMMANDKEY);
-        }
-			 
 		  if ( pRefCommandKey != NULL ) {
-          char * pValCommandKey = NULL;
-          xmlGetNodeParameters(pRefCommandKey, NULL, &pValCommandKey);
-           if(NULL == pValCommandKey) { pValCommandKey = _EMPTY; }
-				
-          // If commandKey is not set, set this value to the NULL ((void*)0) !!
-          DBG( " RPC method = Reboot( cwmpID = %s, CmdKey = %s ) ", soapIdStr, pValCommandKey );
-          nRet = DM_SUB_Reboot( soapIdStr, pValCommandKey );
+      char * pValCommandKey = NULL;
+      xmlGetNodeParameters(pRefCommandKey, NULL, &pValCommandKey);
+       if(NULL == pValCommandKey) { pValCommandKey = _EMPTY; }
+
+      // If commandKey is not set, set this value to the NULL ((void*)0) !!
+      DBG( " RPC method = Reboot( cwmpID = %s, CmdKey = %s ) ", soapIdStr, pValCommandKey );
+      nRet = DM_SUB_Reboot( soapIdStr, pValCommandKey );
 
 			  } else {
 			    DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
@@ -1869,8 +2066,22 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
 
 			  }
 			}  // end feature supported
-      
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_DOWNLOAD )){
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the Download RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processDownload(GenericXmlNodePtr   rpcNode,
+                 char              * soapIdStr,
+                 unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
+
       // -----------------------------------------------------------------
       // NAME      = DOWNLOAD
       // MANDATORY = YES
@@ -1900,9 +2111,9 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
       // </soapenv:Body>
       // </soapenv:Envelope>
       // -----------------------------------------------------------------
-      
+
     if (!DM_ENG_IS_DOWNLOAD_SUPPORTED) {
-      DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
+      DBG( " The %s RPC method is not implemented.", RPC_DOWNLOAD);
       // Send a fault SOAP message to the ACS server (NOK)
       DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
     } else { 
@@ -1989,7 +2200,7 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
         if(NULL == userNameValueStr) {
           DBG( "No UserName for DOWNLOAD RPC Request.");
         }
-       
+
         // -----------------------------------------------------------------
         // Field     : Password
         // Mandatory : No
@@ -2080,7 +2291,7 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
             (NULL != fileTypeValueStr)   && 
             (NULL != urlValueStr)        &&
             validValue ) {
-         
+
           nRet = DM_SUB_Download( soapIdStr,
                                   fileTypeValueStr,
                                   urlValueStr,
@@ -2092,9 +2303,9 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
                                   successUrlValueStr,
                                   failureUrlValueStr,
                                   commandKeyValueStr );
-         
+
           DBG( "DM_SUB_Download Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
-         
+
         } else {
           // The request can not be performed
           EXEC_ERROR( "Invalid Parameter. The Download request can not be performed.");
@@ -2103,18 +2314,31 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
         return nRet;
       }
       }
-       
+
       // -----------------------------------------------------------------
       // DOWNLOAD - END
       // -----------------------------------------------------------------
-       
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_FACTORYRESET )) {
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the FactoryReset RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processFactoryReset(GenericXmlNodePtr   rpcNode UNUSED,
+                     char              * soapIdStr,
+                     unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+
       // -----------------------------------------------------------------
       // NAME      = RPC_FACTORYRESET
       // MANDATORY = NO
       // -----------------------------------------------------------------
      if (!DM_ENG_IS_FACTORYRESET_SUPPORTED) {
-       DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
+       DBG( " The %s RPC method is not implemented.", RPC_FACTORYRESET);
        // Send a fault SOAP message to the ACS server (NOK)
        DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
      } else { 
@@ -2126,453 +2350,1087 @@ DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsig
        }
      }
 
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_SCHEDULEINFORM )) {
-     // -----------------------------------------------------------------
-     // NAME      = SCHEDULEINFORM
-     // MANDATORY = YES
-     // -----------------------------------------------------------------
-     // <soapenv:Envelope
-     //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
-     //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
-     //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
-     // <soapenv:Header>
-     // <cwmp:ID soapenv:mustUnderstand="1"
-     //	xsi:type="xsd:string"
-     //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1193144023902</cwmp:ID>
-     // </soapenv:Header>
-     // <soapenv:Body>
-     // <cwmp:ScheduleInform>
-     //   <DelaySeconds>Delay befor inform</DelaySeconds>
-     //  <CommandKey>CommandKey</CommandKey>
-     // </cwmp:ScheduleInform>
-     // </soapenv:Body>
-     // </soapenv:Envelope>
-     // -----------------------------------------------------------------
-     if (!DM_ENG_IS_SCHEDULEINFORM_SUPPORTED) {
-       DBG( " The %s RPC method is not implemented.", rpcCmmandTypeStr);
-        // Send a fault SOAP message to the ACS server (NOK)
-      DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-     } else { 
-       // The feature is supported
-       GenericXmlNodePtr scheduleInformNode = xmlGetFirstNodeWithTagName(rpcDocNode, RPC_SCHEDULEINFORM);  
-       char          * delaySecondsValueStr = NULL;
-       char          * commandKeyStr        = NULL;
-
-
-       xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(scheduleInformNode), PARAM_DELAYSECONDS), NULL, &delaySecondsValueStr); 
-       if(NULL ==  delaySecondsValueStr) {
-         xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(scheduleInformNode), CWMP_PARAM_DELAYSECONDS), NULL, &delaySecondsValueStr); 
-         if(NULL == delaySecondsValueStr) {
-           EXEC_ERROR("NULL delaySecondsValueStr\n");
-         } 
-       }
+  return( nRet );
+}
 
-        GenericXmlNodePtr ckNode = xmlGetFirstNodeWithTagName(xmlNodeToDocument(scheduleInformNode), PARAM_COMMANDKEY);
-        if (NULL == ckNode)
-        {
-           ckNode = xmlGetFirstNodeWithTagName(xmlNodeToDocument(scheduleInformNode), CWMP_PARAM_COMMANDKEY);
-        }
+/*
+* Private routine which processes the ScheduleInform RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processScheduleInform(GenericXmlNodePtr   rpcNode,
+                       char              * soapIdStr,
+                       unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
 
-        if(NULL != ckNode)
-        {
-           xmlGetNodeParameters(ckNode, NULL, &commandKeyStr);  
-           if(NULL == commandKeyStr) { commandKeyStr = _EMPTY; }
-        }
-        else
-        {
-           // Command Key Value could be NULL
-           DBG("NULL commandKeyStr (No Command Key Str provided)\n");
-        }
+  // -----------------------------------------------------------------
+  // NAME      = SCHEDULEINFORM
+  // MANDATORY = YES
+  // -----------------------------------------------------------------
+  // <soapenv:Envelope
+  //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
+  //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
+  //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
+  // <soapenv:Header>
+  // <cwmp:ID soapenv:mustUnderstand="1"
+  //	xsi:type="xsd:string"
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">1193144023902</cwmp:ID>
+  // </soapenv:Header>
+  // <soapenv:Body>
+  // <cwmp:ScheduleInform>
+  //   <DelaySeconds>Delay befor inform</DelaySeconds>
+  //  <CommandKey>CommandKey</CommandKey>
+  // </cwmp:ScheduleInform>
+  // </soapenv:Body>
+  // </soapenv:Envelope>
+  // -----------------------------------------------------------------
+  if (!DM_ENG_IS_SCHEDULEINFORM_SUPPORTED) {
+    DBG( " The %s RPC method is not implemented.", RPC_SCHEDULEINFORM);
+     // Send a fault SOAP message to the ACS server (NOK)
+   DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else { 
+    // The feature is supported
+    GenericXmlNodePtr scheduleInformNode = xmlGetFirstNodeWithTagName(rpcDocNode, RPC_SCHEDULEINFORM);  
+    char          * delaySecondsValueStr = NULL;
+    char          * commandKeyStr        = NULL;
+
+
+    xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(scheduleInformNode), PARAM_DELAYSECONDS), NULL, &delaySecondsValueStr); 
+    if(NULL ==  delaySecondsValueStr) {
+      xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(scheduleInformNode), CWMP_PARAM_DELAYSECONDS), NULL, &delaySecondsValueStr); 
+      if(NULL == delaySecondsValueStr) {
+        EXEC_ERROR("NULL delaySecondsValueStr\n");
+      } 
+    }
 
-       if(NULL != delaySecondsValueStr) {
-         nRet = DM_SUB_ScheduleInform( soapIdStr,
-                                       delaySecondsValueStr,
-                                       commandKeyStr );
-         DBG( "DM_SUB_ScheduleInform Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
+     GenericXmlNodePtr ckNode = xmlGetFirstNodeWithTagName(xmlNodeToDocument(scheduleInformNode), PARAM_COMMANDKEY);
+     if (NULL == ckNode)
+     {
+        ckNode = xmlGetFirstNodeWithTagName(xmlNodeToDocument(scheduleInformNode), CWMP_PARAM_COMMANDKEY);
+     }
 
-       } else {
-         EXEC_ERROR( "Invalid Parameter. The SCHEDULEINFORM request can not be performed.");
+     if(NULL != ckNode)
+     {
+        xmlGetNodeParameters(ckNode, NULL, &commandKeyStr);  
+        if(NULL == commandKeyStr) { commandKeyStr = _EMPTY; }
+     }
+     else
+     {
+        // Command Key Value could be NULL
+        DBG("NULL commandKeyStr (No Command Key Str provided)\n");
+     }
+
+    if(NULL != delaySecondsValueStr) {
+      nRet = DM_SUB_ScheduleInform( soapIdStr,
+                                    delaySecondsValueStr,
+                                    commandKeyStr );
+      DBG( "DM_SUB_ScheduleInform Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
+
+    } else {
+      EXEC_ERROR( "Invalid Parameter. The SCHEDULEINFORM request can not be performed.");
 	      // Send a fault SOAP message to the ACS server (NOK)
 	      DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-        return nRet;
-       }
-     }
-       
-     // -----------------------------------------------------------------
-     // SCHEDULEINFORM - END
-     // -----------------------------------------------------------------
+     return nRet;
+    }
+  }
 
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_UPLOAD )) {
-      // -----------------------------------------------------------------
-      // NAME      = RPC_UPLOAD
-      // MANDATORY = NO
-      // -----------------------------------------------------------------
-      if (!DM_ENG_IS_UPLOAD_SUPPORTED) {
-        DBG( " The %s RPC Method is not implemented.", rpcCmmandTypeStr);
-        // Send a fault SOAP message to the ACS server (NOK)
-        DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-      } else {
+  // -----------------------------------------------------------------
+  // SCHEDULEINFORM - END
+  // -----------------------------------------------------------------
 
-        GenericXmlNodePtr    downloadNode       = xmlGetFirstNodeWithTagName(rpcDocNode, RPC_UPLOAD);
-        char               * commandKeyValueStr = NULL;
-        char               * fileTypeValueStr   = NULL;
-        char               * urlValueStr        = NULL;
-        char               * userNameValueStr   = NULL;
-        char               * passwordValueStr   = NULL;
-        char               * delayValueStr      = NULL;
-        unsigned int         delaySeconds       = 0;
-        bool                 validValue         = true;
+  return( nRet );
+}
 
-        // -----------------------------------------------------------------
-        // Field     : Commandkey
-        // Mandatory : yes
-        // -----------------------------------------------------------------
+/*
+* Private routine which processes the Upload RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processUpload(GenericXmlNodePtr   rpcNode,
+               char              * soapIdStr,
+               unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
 
-        GenericXmlNodePtr ckNode = xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_COMMANDKEY);
-        if (NULL == ckNode)
-        {
-           ckNode = xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), CWMP_PARAM_COMMANDKEY);
-        }
+  // -----------------------------------------------------------------
+  // NAME      = RPC_UPLOAD
+  // MANDATORY = NO
+  // -----------------------------------------------------------------
+  if (!DM_ENG_IS_UPLOAD_SUPPORTED) {
+    DBG( " The %s RPC Method is not implemented.", RPC_UPLOAD);
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else {
 
-        if(NULL == ckNode) {
-          // This is a mandatory Parameter Value
-          EXEC_ERROR( "No commandKey for DOWNLOAD RPC Request.");
-          DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-          return nRet;
-        }
+    GenericXmlNodePtr    downloadNode       = xmlGetFirstNodeWithTagName(rpcDocNode, RPC_UPLOAD);
+    char               * commandKeyValueStr = NULL;
+    char               * fileTypeValueStr   = NULL;
+    char               * urlValueStr        = NULL;
+    char               * userNameValueStr   = NULL;
+    char               * passwordValueStr   = NULL;
+    char               * delayValueStr      = NULL;
+    unsigned int         delaySeconds       = 0;
+    bool                 validValue         = true;
 
-        xmlGetNodeParameters(ckNode, NULL, &commandKeyValueStr);  
-        if(NULL == commandKeyValueStr) { commandKeyValueStr = _EMPTY; }
+    // -----------------------------------------------------------------
+    // Field     : Commandkey
+    // Mandatory : yes
+    // -----------------------------------------------------------------
 
-        // -----------------------------------------------------------------
-        // Field     : FileType
-        // Mandatory : yes
-        // -----------------------------------------------------------------
-        //	1 Vendor Configuration File
-        //	2 Vendor Log File
-        //	X OUI Vendor-specific identifier
-        // -----------------------------------------------------------------
-        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_FILETYPE), NULL, &fileTypeValueStr);  
-        if(NULL == fileTypeValueStr) {
-          // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
+    GenericXmlNodePtr ckNode = xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_COMMANDKEY);
+    if (NULL == ckNode)
+    {
+       ckNode = xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), CWMP_PARAM_COMMANDKEY);
+    }
+
+    if(NULL == ckNode) {
+      // This is a mandatory Parameter Value
+      EXEC_ERROR( "No commandKey for DOWNLOAD RPC Request.");
+      DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+      return nRet;
+    }
+
+    xmlGetNodeParameters(ckNode, NULL, &commandKeyValueStr);  
+    if(NULL == commandKeyValueStr) { commandKeyValueStr = _EMPTY; }
+
+    // -----------------------------------------------------------------
+    // Field     : FileType
+    // Mandatory : yes
+    // -----------------------------------------------------------------
+    //	1 Vendor Configuration File
+    //	2 Vendor Log File
+    //	X OUI Vendor-specific identifier
+    // -----------------------------------------------------------------
+    xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_FILETYPE), NULL, &fileTypeValueStr);  
+    if(NULL == fileTypeValueStr) {
+      // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
 	        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), CWMP_PARAM_FILETYPE), NULL, &fileTypeValueStr);   
-        }       
-        if(NULL == fileTypeValueStr) {
-          // This is a mandatory Parameter Value
-          EXEC_ERROR( "No fileType for DOWNLOAD RPC Request.");
-          DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-          return nRet;
-        }
-      
-        // -----------------------------------------------------------------
-        // Field     : Url
-        // Mandatory : yes
-        // -----------------------------------------------------------------
-        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_URL), NULL, &urlValueStr); 
-        if(NULL == urlValueStr) {
-          // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
+    }       
+    if(NULL == fileTypeValueStr) {
+      // This is a mandatory Parameter Value
+      EXEC_ERROR( "No fileType for DOWNLOAD RPC Request.");
+      DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+      return nRet;
+    }
+
+    // -----------------------------------------------------------------
+    // Field     : Url
+    // Mandatory : yes
+    // -----------------------------------------------------------------
+    xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_URL), NULL, &urlValueStr); 
+    if(NULL == urlValueStr) {
+      // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
 	        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), CWMP_PARAM_URL), NULL, &urlValueStr); 
-        }
-        if(NULL == urlValueStr) {
-          // This is a mandatory Parameter Value
-          EXEC_ERROR( "No URL for DOWNLOAD RPC Request.");
-          DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-          return nRet;
-        }
+    }
+    if(NULL == urlValueStr) {
+      // This is a mandatory Parameter Value
+      EXEC_ERROR( "No URL for DOWNLOAD RPC Request.");
+      DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+      return nRet;
+    }
 
-        // -----------------------------------------------------------------
-        // Field     : Username
-        // Mandatory : No
-        // -----------------------------------------------------------------
-        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_USERNAME), NULL, &userNameValueStr);
-        if(NULL == userNameValueStr) {
-          // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
+    // -----------------------------------------------------------------
+    // Field     : Username
+    // Mandatory : No
+    // -----------------------------------------------------------------
+    xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_USERNAME), NULL, &userNameValueStr);
+    if(NULL == userNameValueStr) {
+      // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
 	        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), CWMP_PARAM_USERNAME), NULL, &userNameValueStr);
-        }
-        if(NULL == userNameValueStr) {
-          DBG( "No UserName for DOWNLOAD RPC Request.");
-        }
+    }
+    if(NULL == userNameValueStr) {
+      DBG( "No UserName for DOWNLOAD RPC Request.");
+    }
 
-        // -----------------------------------------------------------------
-        // Field     : Password
-        // Mandatory : No
-        // -----------------------------------------------------------------
-        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_PASSWORD), NULL, &passwordValueStr); 
-        if(NULL == passwordValueStr) {
-          // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
+    // -----------------------------------------------------------------
+    // Field     : Password
+    // Mandatory : No
+    // -----------------------------------------------------------------
+    xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_PASSWORD), NULL, &passwordValueStr); 
+    if(NULL == passwordValueStr) {
+      // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
 	        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), CWMP_PARAM_PASSWORD), NULL, &passwordValueStr);   
-        } 
-        if(NULL == passwordValueStr) {
-          DBG( "No Password for DOWNLOAD RPC Request.");
-        }
-      
-        // -----------------------------------------------------------------
-        // Field     : Delay
-        // Mandatory : yes
-        // -----------------------------------------------------------------
-        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_DELAYSECONDS), NULL, &delayValueStr);  
-        if(NULL == delayValueStr) {
-          // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
+    } 
+    if(NULL == passwordValueStr) {
+      DBG( "No Password for DOWNLOAD RPC Request.");
+    }
+
+    // -----------------------------------------------------------------
+    // Field     : Delay
+    // Mandatory : yes
+    // -----------------------------------------------------------------
+    xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), PARAM_DELAYSECONDS), NULL, &delayValueStr);  
+    if(NULL == delayValueStr) {
+      // TRY with cwmp:CommandKey (ACS and KARMA Compatibility)
 	        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(downloadNode), CWMP_PARAM_DELAYSECONDS), NULL, &delayValueStr);   
-        }  
-        if(NULL == delayValueStr) {
-          DBG( "No delay for DOWNLOAD RPC Request.");
-          delaySeconds = 0;
+    }  
+    if(NULL == delayValueStr) {
+      DBG( "No delay for DOWNLOAD RPC Request.");
+      delaySeconds = 0;
+    } else {
+      validValue = DM_ENG_stringToUint(delayValueStr, &delaySeconds);
+    }
+
+    // Check parameter validity    
+    if( (NULL != commandKeyValueStr) && 
+        (NULL != fileTypeValueStr)   && 
+        (NULL != urlValueStr)        &&
+        validValue ) {
+
+      nRet = DM_SUB_Upload( soapIdStr,
+                            fileTypeValueStr,
+                            urlValueStr,
+                            userNameValueStr,
+                            passwordValueStr,
+				                        delaySeconds,
+                            commandKeyValueStr  );
+
+      DBG( "DM_SUB_Upload Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
+
+    } else {
+      // The request can not be performed
+      EXEC_ERROR( "Invalid Parameter. The Upload request can not be performed.");
+      // Send a fault SOAP message to the ACS server (NOK)
+      DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+      return nRet;
+    }
+
+
+  }
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the GetQueuedTransfers RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processGetQueuedTransfers(GenericXmlNodePtr   rpcNode UNUSED,
+                           char              * soapIdStr,
+                           unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+
+  // -----------------------------------------------------------------
+  // NAME      = RPC_GETQUEUEDTRANSFERS
+  // MANDATORY = NO
+  // -----------------------------------------------------------------
+  DBG( " The %s RPC Method is not implemented.", RPC_GETQUEUEDTRANSFERS);
+  // Send a fault SOAP message to the ACS server (NOK)
+  DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the GetAllQueuedTransfers RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processGetAllQueuedTransfers(GenericXmlNodePtr   rpcNode UNUSED,
+                              char              * soapIdStr,
+                              unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+
+  // -----------------------------------------------------------------
+  // NAME      = RPC_GETALLQUEUEDTRANSFERS
+  // MANDATORY = NO
+  // -----------------------------------------------------------------
+  if (!DM_ENG_IS_GETALLQUEUEDTRANSFERS_SUPPORTED) {
+    DBG( " The %s RPC Method is not implemented.", RPC_GETALLQUEUEDTRANSFERS);
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+  } else {
+    DBG( " The %s RPC Method is implemented.", RPC_GETALLQUEUEDTRANSFERS);
+
+	      // Retrieve the queued transfers and perform the response.
+	      DM_SUB_GetAllQueuedTransferts(soapIdStr);
+
+  }
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the SetVouchers RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processSetVouchers(GenericXmlNodePtr   rpcNode UNUSED,
+                    char              * soapIdStr UNUSED,
+                    unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+
+  // -----------------------------------------------------------------
+  // NAME      = RPC_SETVOUCHERS
+  // MANDATORY = NO
+  // -----------------------------------------------------------------
+  DBG( " The %s RPC Method is not implemented.", RPC_SETVOUCHERS);
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the GetOptions RPC received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processGetOptions(GenericXmlNodePtr   rpcNode UNUSED,
+                   char              * soapIdStr UNUSED,
+                   unsigned int        holdRequests UNUSED)
+{
+  DMRET                 nRet       = DM_ERR;
+
+  // -----------------------------------------------------------------
+  // NAME      = RPC_GETOPTIONS
+  // MANDATORY = NO
+  // -----------------------------------------------------------------
+  DBG( " The %s RPC Method is not implemented.", RPC_GETOPTIONS);
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the InformResponse message received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processInformResponse(GenericXmlNodePtr   rpcNode,
+                       char              * soapIdStr,
+                       unsigned int        holdRequests)
+{
+  DMRET                 nRet       = DM_ERR;
+  GenericXmlDocumentPtr rpcDocNode = xmlNodeToDocument(rpcNode);
+
+  // -----------------------------------------------------------------
+  // NAME      = INFORMRESPONSE
+  // MANDATORY = YES
+  // -----------------------------------------------------------------
+  // -----------------------------------------------------------------
+  // RESPONSE MESSAGE FROM THE ACS SERVER
+  // -----------------------------------------------------------------
+  // NAME = INFORMRESPONSE
+  // -----------------------------------------------------------------
+  // <soapenv:Envelope
+  //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
+  //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
+  //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
+  // <soapenv:Header>
+  // <cwmp:ID
+  //	soapenv:mustUnderstand="1"
+  //	xsi:type="xsd:string"
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">8402</cwmp:ID>
+  // </soapenv:Header>
+  // <soapenv:Body>
+  // <cwmp:InformResponse
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
+  // <MaxEnvelopes
+  //	xsi:type="xsd:int">2</MaxEnvelopes>
+  // </cwmp:InformResponse>
+  // </soapenv:Body>
+  // </soapenv:Envelope>
+  // -----------------------------------------------------------------
+  char          * maxEnveloppeValueStr = NULL;
+  GenericXmlNodePtr informResponseNode = xmlGetFirstNodeWithTagName(rpcDocNode, INFORMRESPONSE);  
+
+  // If no InformResponse is received and the CWMP Session Terminated due to
+  // Timeout, the CPE must use the cwmp-1-0 flag instead of cwmp-1-1
+  atLeastOneInformResponseReceivedWithThisAcsTerminated = true;
+
+  if ( DM_OK == DM_RemoveHeaderIDFromTab( soapIdStr )){
+
+    xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(informResponseNode), INFORMRESPONSE_MAXENVELOPES), 
+	                                                      NULL,
+							                                          &maxEnveloppeValueStr);   
+
+    if(NULL == maxEnveloppeValueStr) {
+      EXEC_ERROR( "MaxEnveloppes value not specified.");
+    } else {
+      // Set the global data
+      g_DmComData.Acs.nMaxEnvelopes = (int)atoi(maxEnveloppeValueStr);
+      // Number of envelopes the HTTP client may gather in one HTTP POST
+      if ( g_DmComData.Acs.nMaxEnvelopes > 1 ) {
+        DM_SetHttpMaxEnvelopes( g_DmComData.Acs.nMaxEnvelopes );
+      }
+    }
+
+    DBG( "Ask the IsReadyToClose() function" );
+    if(holdRequests || DM_ENG_IsReadyToClose( DM_ENG_EntityType_ACS )) {
+       if (holdRequests == 0) { g_DmComData.bIRTCInProgess = true; }
+	        DBG("Send an EMPTY_HTTP_MESSAGE");
+      nRet = DM_SendHttpMessage( EMPTY_HTTP_MESSAGE );
+      DBG("DM_SendHttpMessage Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
+    }
+  } else { // DM_OK != DM_RemoveHeaderIDFromTab( soapIdStr ))
+    EXEC_ERROR( "SOAP RESPONSE - Inform received but could not  ");
+    EXEC_ERROR( "associated with a previous HEADER_ID sent by the CPE to the ACS!!" );
+  }
+
+  // -----------------------------------------------------------------
+  // INFORMRESPONSE - END
+  // -----------------------------------------------------------------
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the TransferCompleteResponse message received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processTransferCompleteResponse(GenericXmlNodePtr   rpcNode UNUSED,
+                                 char              * soapIdStr,
+                                 unsigned int        holdRequests)
+{
+  DMRET                 nRet       = DM_ERR;
+
+  // -----------------------------------------------------------------
+  // NAME      = TRANSFERTCOMPLETERESPONSE
+  // MANDATORY = NO
+  // -----------------------------------------------------------------
+  // <soapenv:Envelope
+  //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
+  //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
+  //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
+  // <soapenv:Header>
+  // <cwmp:ID
+  //	soapenv:mustUnderstand="1"
+  //	xsi:type="xsd:string"
+  //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">same as TransferComplete</cwmp:ID>
+  // </soapenv:Header>
+  // <soapenv:Body>
+  // <cwmp:TransferCompleteResponse xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
+  // </cwmp:TransferCompleteResponse>
+  // </soapenv:Body>
+  // </soapenv:Envelope>
+  // -----------------------------------------------------------------
+
+  // Look for a SOAP Header_ID in the global array
+  if ( DM_OK == DM_RemoveHeaderIDFromTab( soapIdStr )) {
+    // --------------------------------------------------------------------------------
+    // Test to check if we can close the session
+    // If so, send an empty POST HTTP/1.1 message to the ACS server
+    // -------------------------------------------------------------------------------
+
+		    // Take the mutex to use bSession
+    DM_CMN_Thread_lockMutex(mutexAcsSession);
+
+    if ( g_DmComData.bSession ) {
+      // Ask the DM_ENGINE if the session can be closed
+      if ( holdRequests || DM_ENG_IsReadyToClose( DM_ENG_EntityType_ACS ) ) {
+        DBG( "DM_ENGINE ready to close the session : OK" );
+       if (holdRequests == 0) { g_DmComData.bIRTCInProgess = true; }
+        // Send the HTTP message
+        if ( DM_OK == DM_SendHttpMessage( EMPTY_HTTP_MESSAGE ) ) {
+          DBG( "Transfer Complete Response - Sending: OK" );
+          nRet = DM_OK;
         } else {
-          validValue = DM_ENG_stringToUint(delayValueStr, &delaySeconds);
+          DBG( "Transfer Complete Response - Sending: NOK" );
         }
+      }
+    } // end if ( g_DmComData.bSession )
+  } else {
+    EXEC_ERROR( "SOAP RESPONSE - TransfertComplete received but can not "          );
+    EXEC_ERROR( "be associatedwith a previous HEADER_ID sent by the CPE to the ACS!!"  );
+  }
 
-        // Check parameter validity    
-        if( (NULL != commandKeyValueStr) && 
-            (NULL != fileTypeValueStr)   && 
-            (NULL != urlValueStr)        &&
-            validValue ) {
+  // Free the mutex
+			DM_CMN_Thread_unlockMutex(mutexAcsSession);
+
+  // -----------------------------------------------------------------
+  // TRANSFERTCOMPLETERESPONSE - END
+  // -----------------------------------------------------------------
+
+  return( nRet );
+}
+
+/*
+* Private routine which processes the RequestDownloadResponse message received from the ACS
+* return DM_OK is okay else DM_ERR
+*/
+static DMRET
+_processRequestDownloadResponse(GenericXmlNodePtr   rpcNode UNUSED,
+                                char              * soapIdStr,
+                                unsigned int        holdRequests)
+{
+  DMRET                 nRet       = DM_ERR;
+
+  // -----------------------------------------------------------------
+  // NAME      = REQUESTDOWNLOADRESPONSE
+  // MANDATORY = NO
+  // -----------------------------------------------------------------
+  // <soapenv:Envelope
+  //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
+  //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
+  //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
+  // <soapenv:Header>
+  // <cwmp:ID soapenv:mustUnderstand="1">same as RequestDownload</cwmp:ID>
+  // </soapenv:Header>
+  // <soapenv:Body>
+  // <cwmp:RequestDownloadResponse></cwmp:TransferCompleteResponse>
+  // </soapenv:Body>
+  // </soapenv:Envelope>
+  // -----------------------------------------------------------------
+
+  // Look for a SOAP Header_ID in the global array
+  if ( DM_OK == DM_RemoveHeaderIDFromTab( soapIdStr )) {
+    // --------------------------------------------------------------------------------
+    // Test to check if we can close the session
+    // If so, send an empty POST HTTP/1.1 message to the ACS server
+    // -------------------------------------------------------------------------------
+
+		    // Take the mutex to use bSession
+    DM_CMN_Thread_lockMutex(mutexAcsSession);
+
+    if ( g_DmComData.bSession ) {
+      // Ask the DM_ENGINE if the session can be closed
+      if ( holdRequests || DM_ENG_IsReadyToClose( DM_ENG_EntityType_ACS ) ) {
+        DBG( "DM_ENGINE ready to close the session : OK" );
+        if (holdRequests == 0) { g_DmComData.bIRTCInProgess = true; }
+        // Send the HTTP message
+        if ( DM_OK == DM_SendHttpMessage( EMPTY_HTTP_MESSAGE ) ) {
+          DBG( "Request Download Response - Sending: OK" );
+          nRet = DM_OK;
+        } else {
+          DBG( "Request Download Response - Sending: NOK" );
+        }
+      }
+    } // end if ( g_DmComData.bSession )
+  } else {
+    EXEC_ERROR( "SOAP RESPONSE - RequestDownloadResponse received but can not "          );
+    EXEC_ERROR( "be associatedwith a previous HEADER_ID sent by the CPE to the ACS!!"  );
+  }
+
+  // Free the mutex
+			DM_CMN_Thread_unlockMutex(mutexAcsSession);
+
+  // -----------------------------------------------------------------
+  // REQUESTDOWNLOADRESPONSE - END
+  // -----------------------------------------------------------------
+
+  return( nRet );
+}
+
+/*
+* Routine processing a RPC (or a response) received from the ACS
+*/
+typedef DMRET (*RpcHandler)(GenericXmlNodePtr rpcNode, char * soapIdStr, unsigned int holdRequests);
+
+typedef struct _RpcHandlerEntry
+{
+  const char * rpcName;
+  RpcHandler   handler;
+
+} __attribute((packed)) RpcHandlerEntry;
+
+/*
+* Routines processing the RPC received from the ACS (the Fault message excepted, its tag depending on the SOAP prefix).
+* A new RPC only needs a new entry.
+*/
+static const RpcHandlerEntry _rpcHandlers[] =
+{
+  { RPC_GETRPCMETHODS          , _processGetRPCMethods            },
+  { RPC_SETPARAMETERVALUES     , _processSetParameterValues       },
+  { RPC_GETPARAMETERVALUES     , _processGetParameterValues       },
+  { RPC_SETPARAMETERATTRIBUTES , _processSetParameterAttributes   },
+  { RPC_GETPARAMETERATTRIBUTES , _processGetParameterAttributes   },
+  { RPC_GETPARAMETERNAMES      , _processGetParameterNames        },
+  { RPC_ADDOBJECT              , _processAddObject                },
+  { RPC_DELETEOBJECT           , _processDeleteObject             },
+  { RPC_REBOOT                 , _processReboot                   },
+  { RPC_DOWNLOAD               , _processDownload                 },
+  { RPC_FACTORYRESET           , _processFactoryReset             },
+  { RPC_SCHEDULEINFORM         , _processScheduleInform           },
+  { RPC_UPLOAD                 , _processUpload                   },
+  { RPC_GETQUEUEDTRANSFERS     , _processGetQueuedTransfers       },
+  { RPC_GETALLQUEUEDTRANSFERS  , _processGetAllQueuedTransfers    },
+  { RPC_SETVOUCHERS            , _processSetVouchers              },
+  { RPC_GETOPTIONS             , _processGetOptions               },
+  { INFORMRESPONSE             , _processInformResponse           },
+  { TRANSFERTCOMPLETERESPONSE  , _processTransferCompleteResponse },
+  { REQUESTDOWNLOADRESPONSE    , _processRequestDownloadResponse  },
+  { NULL, NULL }
+};
+
+// Open addressing hash table of the entries of _rpcHandlers, by RPC name (size : power of 2, greater than the number of entries)
+#define RPC_HANDLER_INDEX_SIZE (64)
+static const RpcHandlerEntry * _rpcHandlerIndex[RPC_HANDLER_INDEX_SIZE];
+static pthread_once_t          _rpcHandlerIndexOnce = PTHREAD_ONCE_INIT;
+
+/*
+* Private routine which computes the hash (FNV-1a) of a name (RPC, parameter)
+*/
+static unsigned int
+_hashName(const char * name)
+{
+  unsigned int hash = 2166136261u;
+
+  while ( *name != '\0' ) {
+    hash ^= (unsigned char)*name++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/*
+* Private routine which builds the hash table of the RPC handlers (called once, through pthread_once)
+*/
+static void
+_buildRpcHandlerIndex()
+{
+  const RpcHandlerEntry * pEntry = NULL;
+  unsigned int            i;
+
+  for ( pEntry = _rpcHandlers ; pEntry->rpcName != NULL ; pEntry++ ) {
+    for ( i = _hashName( pEntry->rpcName ) ; _rpcHandlerIndex[i & (RPC_HANDLER_INDEX_SIZE-1)] != NULL ; i++ ) { }
+    _rpcHandlerIndex[i & (RPC_HANDLER_INDEX_SIZE-1)] = pEntry;
+  }
+}
+
+/*
+* Private routine which looks for the routine processing a RPC. The hash table is built on the first call,
+* by one thread only.
+* return the routine found, NULL if the RPC is unknown
+*/
+static RpcHandler
+_findRpcHandler(const char * rpcName)
+{
+  const RpcHandlerEntry * pEntry = NULL;
+  unsigned int            i;
+
+  pthread_once( &_rpcHandlerIndexOnce, _buildRpcHandlerIndex );
+
+  for ( i = _hashName( rpcName ) ; (pEntry = _rpcHandlerIndex[i & (RPC_HANDLER_INDEX_SIZE-1)]) != NULL ; i++ ) {
+    if ( strcmp( pEntry->rpcName, rpcName ) == 0 ) {
+      return pEntry->handler;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Function which parse a SOAP message and extract the RPC commands
+ *
+ * Example :
+ * <soapenv:Body>
+ *   <cwmp:GetParameterNames>
+ *     <ParameterPath>Object.</ParameterPath>
+ *     <NextLevel>0</NextLevel>
+ *   </cwmp:GetParameterNames>
+ * </soapenv:Body>
+ *
+ * @param pBody current reference to the body tag
+ *
+ * @return return DM_OK is okay else DM_ERR
+ *
+ */
+DMRET
+DM_ParseSoapBodyMessage(IN GenericXmlNodePtr pBody, IN char* soapIdStr, IN unsigned int holdRequests)
+{
+  DMRET                   nRet             = DM_ERR;
+  char                  * rpcCmmandTypeStr = NULL;
+  RpcHandler              rpcHandler       = NULL;
+
+  DBG("DM_ParseSoapBodyMessage - Begin");
+
+  // Retrieve the list of child nodes (child nodes of soapenv:Body node)
+  // Only one RPC command must exist per body
+  GenericXmlNodeListPtr rpcNodeList = xmlGetChildNodesList(pBody);
+  // Check only one one RPC exist 
+  if(NULL == rpcNodeList) {
+    EXEC_ERROR( "RPC Command List is Empty. No RPC Request in the Soap Message" );
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+    return nRet;
+  }
+  
+  // Check there is only one RPC Command in the soap body
+  if(MAX_NUMBER_OF_RPC_COMMAND_PER_BODY != xmlGetNumberOfChildNodes(pBody) ) {
+    // More than 1 RPC Command in the body
+    EXEC_ERROR( "The soapenv:Body contains %d RPC Cmd (max is %d)", (int )xmlGetNodesListLength(rpcNodeList),
+                                                               MAX_NUMBER_OF_RPC_COMMAND_PER_BODY);
+    // Send a fault SOAP message to the ACS server (NOK)
+    DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+    // Free the rpcNodeList
+    xmlFreeNodesList( rpcNodeList );
+    return nRet;
+  }
+
+  // Get the RPC Node (first entry in the list)
+  GenericXmlNodePtr rpcNode = xmlGetNodeFromNodesList(rpcNodeList, 0);
+
+  // Free the rpcNodeList
+  xmlFreeNodesList( rpcNodeList );
+
+  // Get the name of the RPC Command
+  xmlGetNodeParameters(rpcNode, &rpcCmmandTypeStr, NULL);
+
+  INFO("RPC Command = %s", rpcCmmandTypeStr);
+  
+  INFO("SOAP Message: RPC: %s (soapId: %s)", rpcCmmandTypeStr , soapIdStr);
+  
+  // A message is received from the ACS. Update the ACS Session Timer.
+  _updateAcsSessionTimer();
+
+
+  // Look for the routine processing the RPC
+  if(0 == strcmp( rpcCmmandTypeStr, _FaultTagName )) {
+    rpcHandler = _processFault;
+  } else {
+    rpcHandler = _findRpcHandler( rpcCmmandTypeStr );
+  }
+
+  if ( rpcHandler != NULL ) {
+    nRet = rpcHandler( rpcNode, soapIdStr, holdRequests );
+  } else {
+    // INVALID MESSAGE
+    EXEC_ERROR( "An unknown RPC method '%s' have been found.", rpcCmmandTypeStr );
+    // Force ACS Session to Close
+    _forceACSSessionToClose();
+  }
+	
+	return( nRet );
+}
+
+// -----------------------------------------------------------------------------------
+// Reading of the SOAP messages received from the ACS without DOM (see dm_com_soap_reader.h)
+// -----------------------------------------------------------------------------------
+
+/*
+* Arguments of a SetParameterValues or SetParameterAttributes read by the pull parser
+*/
+typedef struct _SoapRpcArguments
+{
+  char                              * parameterKey;
+  bool                                parameterKeyFound;
+  bool                                parameterListFound;
+  int                                 nbParameters;
+  int                                 capacity;     // number of entries allocated in pValues or pAttributes
+  DM_ENG_ParameterValueStruct      ** pValues;      // SetParameterValues
+  DM_ENG_ParameterAttributesStruct ** pAttributes;  // SetParameterAttributes
+  int                                 faultCode;    // 0 or the fault to send instead of launching the RPC
+
+} SoapRpcArguments;
+
+#define _TAB_INITIAL_CAPACITY 8
+
+/*
+* Private routine which adds an element at the end of a NULL terminated array of *pSize elements
+* The array is reallocated only when full, its capacity (*pCapacity entries) being doubled
+* return the array
+*/
+static void **
+_addToTab(void ** pTab, int * pSize, int * pCapacity, void * pElt)
+{
+  if ( *pSize + 2 > *pCapacity ) {
+    *pCapacity = (*pCapacity < _TAB_INITIAL_CAPACITY ? _TAB_INITIAL_CAPACITY : 2 * *pCapacity);
+    pTab = (void **) realloc( pTab, *pCapacity * sizeof(void *) );
+  }
+  pTab[(*pSize)++] = pElt;
+  pTab[*pSize] = NULL;
+  return pTab;
+}
+
+/*
+* Private routine which reads a ParameterValueStruct (Name and Value with its xsi:type)
+* return false if the message is malformed
+*/
+static bool
+_readParameterValueStruct(DM_SoapReader    * pReader,
+                          SoapRpcArguments * pArgs)
+{
+  char * parameterNameStr  = NULL;
+  char * parameterValueStr = NULL;
+  char * pValTypeStr       = NULL;
+  int    valueTypeFound    = 0;
+  bool   bRet              = true;
+
+  while ( bRet && (DM_SoapReader_next( pReader ) == DM_SoapReader_START_ELEMENT) ) {
+    if ( (parameterNameStr == NULL) && DM_SoapReader_isElement( pReader, PARAM_NAME ) ) {
+      bRet = DM_SoapReader_readElementText( pReader, &parameterNameStr );
+    } else if ( (pValTypeStr == NULL) && DM_SoapReader_isElement( pReader, PARAM_VALUE ) ) {
+      pValTypeStr = DM_SoapReader_getAttribute( pReader, ATTR_TYPE );
+      bRet = DM_SoapReader_readElementText( pReader, &parameterValueStr );
+    } else {
+      bRet = DM_SoapReader_skipElement( pReader );
+    }
+  }
+  bRet = bRet && !pReader->error;
+
+  if ( bRet && (pArgs->faultCode == 0) ) {
+    if ( (NULL == parameterNameStr) || (NULL == pValTypeStr) ) {
+      EXEC_ERROR( "Some element(s) haven't been found in the soap message!!" );
+      pArgs->faultCode = DM_ENG_INVALID_ARGUMENTS;
+    } else if ( DM_OK != DM_FindTypeParameter( pValTypeStr, &valueTypeFound ) ) {
+      EXEC_ERROR( "Invalid Value Type" );
+      pArgs->faultCode = DM_ENG_INVALID_ARGUMENTS;
+    } else {
+      DBG( "Param.%d : Name = '%s', Value = '%s' ", pArgs->nbParameters, parameterNameStr, (parameterValueStr == NULL ? _EMPTY : parameterValueStr) );
+      pArgs->pValues = (DM_ENG_ParameterValueStruct **) _addToTab( (void **) pArgs->pValues, &pArgs->nbParameters, &pArgs->capacity,
+                          DM_ENG_newParameterValueStruct( parameterNameStr,
+                                                          (DM_ENG_ParameterType) valueTypeFound,
+                                                          (parameterValueStr == NULL ? _EMPTY : parameterValueStr) ) );
+    }
+  }
+
+  DM_ENG_FREE( parameterNameStr );
+  DM_ENG_FREE( parameterValueStr );
+  DM_ENG_FREE( pValTypeStr );
+
+  return bRet;
+}
+
+/*
+* Private routine which reads the AccessList of a SetParameterAttributesStruct
+* return false if the message is malformed
+*/
+static bool
+_readAccessList(DM_SoapReader   * pReader,
+                char          *** pAccessList,
+                int             * pNbAccessList)
+{
+  char * accessListStr = NULL;
+  int    capacity      = 0;
+  bool   bRet          = true;
+
+  while ( bRet && (DM_SoapReader_next( pReader ) == DM_SoapReader_START_ELEMENT) ) {
+    bRet = DM_SoapReader_readElementText( pReader, &accessListStr );
+    if ( bRet ) {
+      DBG( "AccessList Value %d = %s", *pNbAccessList, (accessListStr == NULL ? _EMPTY : accessListStr) );
+      *pAccessList = (char **) _addToTab( (void **) *pAccessList, pNbAccessList, &capacity, (accessListStr == NULL ? strdup(_EMPTY) : accessListStr) );
+    }
+  }
+
+  return bRet && !pReader->error;
+}
+
+/*
+* Private routine which reads a SetParameterAttributesStruct
+* return false if the message is malformed
+*/
+static bool
+_readSetParameterAttributesStruct(DM_SoapReader    * pReader,
+                                  SoapRpcArguments * pArgs)
+{
+  char                  * paramNameStr                   = NULL;
+  char                  * paramNotificationChangeFlagStr = NULL;
+  char                  * paramNotificationChangeValStr  = NULL;
+  char                  * paramAccessListChangeFlagStr   = NULL;
+  char                 ** accessListArray                = NULL;
+  int                     nbAccessList                   = 0;
+  bool                    accessListFound                = false;
+  bool                    notificationChange             = false;
+  bool                    accessListChange               = false;
+  DM_ENG_NotificationMode notification                   = DM_ENG_NotificationMode_UNDEFINED;
+  bool                    bRet                           = true;
+
+  while ( bRet && (DM_SoapReader_next( pReader ) == DM_SoapReader_START_ELEMENT) ) {
+    if ( (paramNameStr == NULL) && DM_SoapReader_isElement( pReader, PARAM_NAME ) ) {
+      bRet = DM_SoapReader_readElementText( pReader, &paramNameStr );
+    } else if ( (paramNotificationChangeFlagStr == NULL) && DM_SoapReader_isElement( pReader, PARAM_NOTIFICATION_CHANGE ) ) {
+      bRet = DM_SoapReader_readElementText( pReader, &paramNotificationChangeFlagStr );
+    } else if ( (paramNotificationChangeValStr == NULL) && DM_SoapReader_isElement( pReader, PARAM_NOTIFICATION ) ) {
+      bRet = DM_SoapReader_readElementText( pReader, &paramNotificationChangeValStr );
+    } else if ( (paramAccessListChangeFlagStr == NULL) && DM_SoapReader_isElement( pReader, PARAM_ACCESSLIST_CHANGE ) ) {
+      bRet = DM_SoapReader_readElementText( pReader, &paramAccessListChangeFlagStr );
+    } else if ( !accessListFound && DM_SoapReader_isElement( pReader, PARAM_ACCESSLIST ) ) {
+      accessListFound = true;
+      bRet = _readAccessList( pReader, &accessListArray, &nbAccessList );
+    } else {
+      bRet = DM_SoapReader_skipElement( pReader );
+    }
+  }
+  bRet = bRet && !pReader->error;
 
-          nRet = DM_SUB_Upload( soapIdStr,
-                                fileTypeValueStr,
-                                urlValueStr,
-                                userNameValueStr,
-                                passwordValueStr,
-				                        delaySeconds,
-                                commandKeyValueStr  );
-         
-          DBG( "DM_SUB_Upload Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
-         
+  if ( bRet && (pArgs->faultCode == 0) ) {
+    if ( (NULL == paramNameStr) || (NULL == paramNotificationChangeFlagStr) || (NULL == paramAccessListChangeFlagStr) ) {
+      // Error - Invalid Parameter
+      EXEC_ERROR( "Invalid ParameterAttribute" );
+    } else {
+      DM_ENG_stringToBool( paramNotificationChangeFlagStr, &notificationChange );
+      DM_ENG_stringToBool( paramAccessListChangeFlagStr, &accessListChange );
+
+      if ( notificationChange ) {
+        if ( NULL != paramNotificationChangeValStr ) {
+          int notif;
+          DM_ENG_stringToInt( paramNotificationChangeValStr, &notif );
+          notification = (DM_ENG_NotificationMode)notif;
         } else {
-          // The request can not be performed
-          EXEC_ERROR( "Invalid Parameter. The Upload request can not be performed.");
-          // Send a fault SOAP message to the ACS server (NOK)
-          DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
-          return nRet;
+          WARN( "No Value for Parameter Notification Change - Set it to undefined" );
         }
-      
-	
       }
 
-
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_GETQUEUEDTRANSFERS )) {
-      // -----------------------------------------------------------------
-      // NAME      = RPC_GETQUEUEDTRANSFERS
-      // MANDATORY = NO
-      // -----------------------------------------------------------------
-      DBG( " The %s RPC Method is not implemented.", rpcCmmandTypeStr);
-      // Send a fault SOAP message to the ACS server (NOK)
-      DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
-      
-    } else if ((0 == strcmp( rpcCmmandTypeStr, RPC_GETALLQUEUEDTRANSFERS ))) {
-      // -----------------------------------------------------------------
-      // NAME      = RPC_GETALLQUEUEDTRANSFERS
-      // MANDATORY = NO
-      // -----------------------------------------------------------------
-      if (!DM_ENG_IS_GETALLQUEUEDTRANSFERS_SUPPORTED) {
-        DBG( " The %s RPC Method is not implemented.", rpcCmmandTypeStr);
-        // Send a fault SOAP message to the ACS server (NOK)
-        DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+      if ( accessListChange && (0 == nbAccessList) ) {
+        EXEC_ERROR( "Missing AccessList in SetParameterAttributes RPC Command" );
+        pArgs->faultCode = DM_ENG_INVALID_ARGUMENTS;
       } else {
-        DBG( " The %s RPC Method is implemented.", rpcCmmandTypeStr);
-	
-	      // Retrieve the queued transfers and perform the response.
-	      DM_SUB_GetAllQueuedTransferts(soapIdStr);
-	      
+        // Add the parameter structure into the parameter structure list
+        DBG( "Param: %s, Notification: %d, AccesssList[0]: %s", paramNameStr, notification, (accessListChange ? accessListArray[0] : "NULL") );
+        pArgs->pAttributes = (DM_ENG_ParameterAttributesStruct **) _addToTab( (void **) pArgs->pAttributes, &pArgs->nbParameters, &pArgs->capacity,
+                                DM_ENG_newParameterAttributesStruct( paramNameStr, notification, (accessListChange ? accessListArray : NULL) ) );
       }
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_SETVOUCHERS )) {
-      // -----------------------------------------------------------------
-      // NAME      = RPC_SETVOUCHERS
-      // MANDATORY = NO
-      // -----------------------------------------------------------------
-      DBG( " The %s RPC Method is not implemented.", rpcCmmandTypeStr);
-    } else if (0 == strcmp( rpcCmmandTypeStr, RPC_GETOPTIONS )) {
-      // -----------------------------------------------------------------
-      // NAME      = RPC_GETOPTIONS
-      // MANDATORY = NO
-      // -----------------------------------------------------------------
-      DBG( " The %s RPC Method is not implemented.", rpcCmmandTypeStr);
-    } else if (0 == strcmp( rpcCmmandTypeStr, INFORMRESPONSE )) {
-      // -----------------------------------------------------------------
-      // NAME      = INFORMRESPONSE
-      // MANDATORY = YES
-      // -----------------------------------------------------------------
-      // -----------------------------------------------------------------
-      // RESPONSE MESSAGE FROM THE ACS SERVER
-      // -----------------------------------------------------------------
-      // NAME = INFORMRESPONSE
-      // -----------------------------------------------------------------
-      // <soapenv:Envelope
-      //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
-      //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
-      //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
-      // <soapenv:Header>
-      // <cwmp:ID
-      //	soapenv:mustUnderstand="1"
-      //	xsi:type="xsd:string"
-      //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">8402</cwmp:ID>
-      // </soapenv:Header>
-      // <soapenv:Body>
-      // <cwmp:InformResponse
-      //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
-      // <MaxEnvelopes
-      //	xsi:type="xsd:int">2</MaxEnvelopes>
-      // </cwmp:InformResponse>
-      // </soapenv:Body>
-      // </soapenv:Envelope>
-      // -----------------------------------------------------------------
-      char          * maxEnveloppeValueStr = NULL;
-      GenericXmlNodePtr informResponseNode = xmlGetFirstNodeWithTagName(rpcDocNode, INFORMRESPONSE);  
-      
-      // If no InformResponse is received and the CWMP Session Terminated due to
-      // Timeout, the CPE must use the cwmp-1-0 flag instead of cwmp-1-1
-      atLeastOneInformResponseReceivedWithThisAcsTerminated = true;
-
-      if ( DM_OK == DM_RemoveHeaderIDFromTab( soapIdStr )){
-         
-        xmlGetNodeParameters(xmlGetFirstNodeWithTagName(xmlNodeToDocument(informResponseNode), INFORMRESPONSE_MAXENVELOPES), 
-	                                                      NULL,
-							                                          &maxEnveloppeValueStr);   
+    }
+  }
+
+  DM_ENG_FREE( paramNameStr );
+  DM_ENG_FREE( paramNotificationChangeFlagStr );
+  DM_ENG_FREE( paramNotificationChangeValStr );
+  DM_ENG_FREE( paramAccessListChangeFlagStr );
+  if ( accessListArray != NULL ) { DM_ENG_deleteTabString( accessListArray ); }
+
+  return bRet;
+}
 
-        if(NULL == maxEnveloppeValueStr) {
-          EXEC_ERROR( "MaxEnveloppes value not specified.");
+/*
+* Private routine which reads the arguments of a SetParameterValues or SetParameterAttributes
+* (the ParameterList and the ParameterKey), from the RPC start tag to its end tag.
+* return false if the message is malformed
+*/
+static bool
+_readSetParameterRpcArguments(DM_SoapReader    * pReader,
+                              bool               setValues,
+                              SoapRpcArguments * pArgs)
+{
+  char * parameterKeyStr = NULL;
+  bool   bRet            = true;
+
+  while ( bRet && (DM_SoapReader_next( pReader ) == DM_SoapReader_START_ELEMENT) ) {
+    if ( !pArgs->parameterKeyFound && DM_SoapReader_isElement( pReader, PARAM_PARAMETERKEY ) ) {
+      pArgs->parameterKeyFound = true;
+      bRet = DM_SoapReader_readElementText( pReader, &parameterKeyStr );
+      pArgs->parameterKey = parameterKeyStr;
+    } else if ( !pArgs->parameterListFound
+             && (DM_SoapReader_isElement( pReader, PARAM_PARAMETERLIST ) || DM_SoapReader_isElement( pReader, CWMP_PARAM_PARAMETERLIST )) ) {
+      // Make ACS and Karma Compatibility
+      pArgs->parameterListFound = true;
+      while ( bRet && (DM_SoapReader_next( pReader ) == DM_SoapReader_START_ELEMENT) ) {
+        if ( setValues && DM_SoapReader_isElement( pReader, PARAMETERVALUESTRUCT ) ) {
+          bRet = _readParameterValueStruct( pReader, pArgs );
+        } else if ( !setValues && (DM_SoapReader_isElement( pReader, SETPARAMETERATTRIBUTESSTRUCT )
+                                || DM_SoapReader_isElement( pReader, PARAMETERATTIBUTESSTRUCT )) ) { // Workaround for ACS Bug
+          bRet = _readSetParameterAttributesStruct( pReader, pArgs );
         } else {
-          // Set the global data
-          g_DmComData.Acs.nMaxEnvelopes = (int)atoi(maxEnveloppeValueStr);
+          bRet = DM_SoapReader_skipElement( pReader );
         }
+      }
+    } else {
+      bRet = DM_SoapReader_skipElement( pReader );
+    }
+  }
 
-        DBG( "Ask the IsReadyToClose() function" );
-        if(holdRequests || DM_ENG_IsReadyToClose( DM_ENG_EntityType_ACS )) {
-           if (holdRequests == 0) { g_DmComData.bIRTCInProgess = true; }
-	        DBG("Send an EMPTY_HTTP_MESSAGE");
-          nRet = DM_SendHttpMessage( EMPTY_HTTP_MESSAGE );
-          DBG("DM_SendHttpMessage Result: %s", (nRet==DM_OK ? "OK" : "ERROR"));
+  return bRet && !pReader->error;
+}
+
+/*
+* Private routine which reads the SOAP messages received from the ACS with the pull parser, without
+* building any DOM tree. Only SetParameterValues and SetParameterAttributes are processed this way :
+* their arguments are read straight into the DM_ENGINE structures.
+* return true if the message has been processed, false if it must be given to the DOM parser
+* (other RPC or malformed message, whose errors are then reported as before)
+*/
+static bool
+_processSoapMessageWithoutDom(const char * pMessage)
+{
+  DM_SoapReader      reader;
+  DM_SoapReaderEvent event           = DM_SoapReader_ERROR;
+  SoapRpcArguments   args;
+  char               soapIdStr[HEADER_ID_SIZE];
+  char             * idStr           = NULL;
+  bool               headerFound     = false;
+  bool               setValues       = false;
+  int                nbRpc           = 0;
+  bool               bRet            = true;
+
+  if (DM_COM_SoapEnv_NS == NULL) { _initPrefixedTag(); }
+
+  memset( (void *) &args, 0, sizeof(args) );
+  memset( (void *) soapIdStr, '\0', sizeof(soapIdStr) );
+
+  DM_SoapReader_init( &reader, pMessage );
+  if ( (DM_SoapReader_next( &reader ) != DM_SoapReader_START_ELEMENT) || !DM_SoapReader_isElement( &reader, _EnvelopeTagName ) ) {
+    return false;
+  }
+
+  while ( bRet && ((event = DM_SoapReader_next( &reader )) == DM_SoapReader_START_ELEMENT) ) {
+    if ( !headerFound && DM_SoapReader_isElement( &reader, _HeaderTagName ) ) {
+      // cwmp:ID (cwmp:HoldRequests only matters for the empty messages, read with the DOM)
+      headerFound = true;
+      while ( bRet && (DM_SoapReader_next( &reader ) == DM_SoapReader_START_ELEMENT) ) {
+        if ( (idStr == NULL) && DM_SoapReader_isElement( &reader, HEADER_ID ) ) {
+          bRet = DM_SoapReader_readElementText( &reader, &idStr );
+        } else {
+          bRet = DM_SoapReader_skipElement( &reader );
         }
-      } else { // DM_OK != DM_RemoveHeaderIDFromTab( soapIdStr ))
-        EXEC_ERROR( "SOAP RESPONSE - Inform received but could not  ");
-        EXEC_ERROR( "associated with a previous HEADER_ID sent by the CPE to the ACS!!" );
       }
-
-      // -----------------------------------------------------------------
-      // INFORMRESPONSE - END
-      // -----------------------------------------------------------------
-       
-    } else if (0 == strcmp( rpcCmmandTypeStr, TRANSFERTCOMPLETERESPONSE )) {
-      // -----------------------------------------------------------------
-      // NAME      = TRANSFERTCOMPLETERESPONSE
-      // MANDATORY = NO
-      // -----------------------------------------------------------------
-      // <soapenv:Envelope
-      //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
-      //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
-      //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
-      // <soapenv:Header>
-      // <cwmp:ID
-      //	soapenv:mustUnderstand="1"
-      //	xsi:type="xsd:string"
-      //	xmlns:cwmp="urn:dslforum-org:cwmp-1-0">same as TransferComplete</cwmp:ID>
-      // </soapenv:Header>
-      // <soapenv:Body>
-      // <cwmp:TransferCompleteResponse xmlns:cwmp="urn:dslforum-org:cwmp-1-0">
-      // </cwmp:TransferCompleteResponse>
-      // </soapenv:Body>
-      // </soapenv:Envelope>
-      // -----------------------------------------------------------------
-       
-      // Look for a SOAP Header_ID in the global array
-      if ( DM_OK == DM_RemoveHeaderIDFromTab( soapIdStr )) {
-        // --------------------------------------------------------------------------------
-        // Test to check if we can close the session
-        // If so, send an empty POST HTTP/1.1 message to the ACS server
-        // -------------------------------------------------------------------------------
-		    
-		    // Take the mutex to use bSession
-        DM_CMN_Thread_lockMutex(mutexAcsSession);
-	
-        if ( g_DmComData.bSession ) {
-          // Ask the DM_ENGINE if the session can be closed
-          if ( holdRequests || DM_ENG_IsReadyToClose( DM_ENG_EntityType_ACS ) ) {
-            DBG( "DM_ENGINE ready to close the session : OK" );
-           if (holdRequests == 0) { g_DmComData.bIRTCInProgess = true; }
-            // Send the HTTP message
-            if ( DM_OK == DM_SendHttpMessage( EMPTY_HTTP_MESSAGE ) ) {
-              DBG( "Transfer Complete Response - Sending: OK" );
-              nRet = DM_OK;
-            } else {
-              DBG( "Transfer Complete Response - Sending: NOK" );
-            }
-          }
-        } // end if ( g_DmComData.bSession )
-      } else {
-        EXEC_ERROR( "SOAP RESPONSE - TransfertComplete received but can not "          );
-        EXEC_ERROR( "be associatedwith a previous HEADER_ID sent by the CPE to the ACS!!"  );
+    } else if ( headerFound && (nbRpc == 0) && DM_SoapReader_isElement( &reader, _BodyTagName ) ) {
+      while ( bRet && (DM_SoapReader_next( &reader ) == DM_SoapReader_START_ELEMENT) ) {
+        nbRpc++;
+        if ( nbRpc > 1 ) {
+          bRet = DM_SoapReader_skipElement( &reader );
+        } else if ( DM_SoapReader_isElement( &reader, RPC_SETPARAMETERVALUES ) ) {
+          setValues = true;
+          bRet = _readSetParameterRpcArguments( &reader, setValues, &args );
+        } else if ( DM_SoapReader_isElement( &reader, RPC_SETPARAMETERATTRIBUTES ) ) {
+          bRet = _readSetParameterRpcArguments( &reader, setValues, &args );
+        } else {
+          bRet = false; // Another RPC, read with the DOM
+        }
       }
-      
-      // Free the mutex
-			DM_CMN_Thread_unlockMutex(mutexAcsSession);
-      
-      // -----------------------------------------------------------------
-      // TRANSFERTCOMPLETERESPONSE - END
-      // -----------------------------------------------------------------
+    } else {
+      bRet = DM_SoapReader_skipElement( &reader );
     }
-    
- else if (0 == strcmp( rpcCmmandTypeStr, REQUESTDOWNLOADRESPONSE )) {
-      // -----------------------------------------------------------------
-      // NAME      = REQUESTDOWNLOADRESPONSE
-      // MANDATORY = NO
-      // -----------------------------------------------------------------
-      // <soapenv:Envelope
-      //	xmlns:soapenv="http://schemas.xmlsoap.org/soap/envelope/"
-      //	xmlns:xsd="http://www.w3.org/2001/XMLSchema"
-      //	xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance">
-      // <soapenv:Header>
-      // <cwmp:ID soapenv:mustUnderstand="1">same as RequestDownload</cwmp:ID>
-      // </soapenv:Header>
-      // <soapenv:Body>
-      // <cwmp:RequestDownloadResponse></cwmp:TransferCompleteResponse>
-      // </soapenv:Body>
-      // </soapenv:Envelope>
-      // -----------------------------------------------------------------
-       
-      // Look for a SOAP Header_ID in the global array
-      if ( DM_OK == DM_RemoveHeaderIDFromTab( soapIdStr )) {
-        // --------------------------------------------------------------------------------
-        // Test to check if we can close the session
-        // If so, send an empty POST HTTP/1.1 message to the ACS server
-        // -------------------------------------------------------------------------------
-		    
-		    // Take the mutex to use bSession
-        DM_CMN_Thread_lockMutex(mutexAcsSession);
-	
-        if ( g_DmComData.bSession ) {
-          // Ask the DM_ENGINE if the session can be closed
-          if ( holdRequests || DM_ENG_IsReadyToClose( DM_ENG_EntityType_ACS ) ) {
-            DBG( "DM_ENGINE ready to close the session : OK" );
-            if (holdRequests == 0) { g_DmComData.bIRTCInProgess = true; }
-            // Send the HTTP message
-            if ( DM_OK == DM_SendHttpMessage( EMPTY_HTTP_MESSAGE ) ) {
-              DBG( "Request Download Response - Sending: OK" );
-              nRet = DM_OK;
-            } else {
-              DBG( "Request Download Response - Sending: NOK" );
-            }
-          }
-        } // end if ( g_DmComData.bSession )
-      } else {
-        EXEC_ERROR( "SOAP RESPONSE - RequestDownloadResponse received but can not "          );
-        EXEC_ERROR( "be associatedwith a previous HEADER_ID sent by the CPE to the ACS!!"  );
-      }
-      
-      // Free the mutex
-			DM_CMN_Thread_unlockMutex(mutexAcsSession);
-      
-      // -----------------------------------------------------------------
-      // REQUESTDOWNLOADRESPONSE - END
-      // -----------------------------------------------------------------
+  }
+
+  // The whole message must be well formed and hold exactly one RPC, else the DOM parser takes it
+  bRet = bRet && !reader.error && (event == DM_SoapReader_END_ELEMENT) && (nbRpc != 0)
+              && (DM_SoapReader_next( &reader ) == DM_SoapReader_EOF);
+
+  if ( bRet ) {
+    if ( idStr == NULL ) {
+      DBG( "ID SOAP message : NOT FOUND (not a blocking condition) !!" );
     } else {
-      // INVALID MESSAGE
-      EXEC_ERROR( "An unknown RPC method '%s' have been found.", rpcCmmandTypeStr );
-      // Force ACS Session to Close
-      _forceACSSessionToClose();
+      strncpy( soapIdStr, idStr, HEADER_ID_SIZE-1 );
+    }
+
+    INFO( "SOAP Message: RPC: %s (soapId: %s)", (setValues ? RPC_SETPARAMETERVALUES : RPC_SETPARAMETERATTRIBUTES), soapIdStr );
 
+    // A message is received from the ACS. Update the ACS Session Timer.
+    _updateAcsSessionTimer();
+
+    if ( nbRpc != MAX_NUMBER_OF_RPC_COMMAND_PER_BODY ) {
+      EXEC_ERROR( "The soapenv:Body contains %d RPC Cmd (max is %d)", nbRpc, MAX_NUMBER_OF_RPC_COMMAND_PER_BODY );
+      DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+    } else if ( setValues ? !DM_ENG_IS_SETPARAMETERVALUES_SUPPORTED : !DM_ENG_IS_SETPARAMETERATTRIBUTES_SUPPORTED ) {
+      DBG( " The %s RPC method is not implemented.", (setValues ? RPC_SETPARAMETERVALUES : RPC_SETPARAMETERATTRIBUTES) );
+      DM_SoapFaultResponse( soapIdStr, DM_ENG_METHOD_NOT_SUPPORTED );
+    } else if ( args.faultCode != 0 ) {
+      DM_SoapFaultResponse( soapIdStr, args.faultCode );
+    } else if ( !args.parameterListFound || (setValues && !args.parameterKeyFound) ) {
+      EXEC_ERROR( "%s - Can not get parameters node", (setValues ? RPC_SETPARAMETERVALUES : RPC_SETPARAMETERATTRIBUTES) );
+      DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+    } else if ( args.nbParameters == 0 ) {
+      EXEC_ERROR( "%s - No parameter to Set", (setValues ? RPC_SETPARAMETERVALUES : RPC_SETPARAMETERATTRIBUTES) );
+      DM_SoapFaultResponse( soapIdStr, DM_ENG_INVALID_ARGUMENTS );
+    } else if ( setValues ) {
+      DM_SUB_SetParameterValues( soapIdStr, args.pValues, (args.parameterKey == NULL ? _EMPTY : args.parameterKey) );
+    } else {
+      DM_SUB_SetParameterAttributes( soapIdStr, args.pAttributes );
+    }
   }
-	
-	return( nRet );
+
+  // Free the memory previously allocated
+  if ( args.pValues != NULL )     { DM_ENG_deleteTabParameterValueStruct( args.pValues ); }
+  if ( args.pAttributes != NULL ) { DM_ENG_deleteTabParameterAttributesStruct( args.pAttributes ); }
+  DM_ENG_FREE( args.parameterKey );
+  DM_ENG_FREE( idStr );
+
+  return bRet;
 }
 
 /**
@@ -2608,29 +3466,33 @@ DM_FindTypeParameter(IN  const char *pParameterType,
 	// Check Parameters
 	if ( (pParameterType != NULL) && (nTypeFound != NULL) )
 	{
-  // Integer
-  if ( strcmp( pParameterType, XSD_INT ) == 0 )              { *nTypeFound = DM_ENG_ParameterType_INT;       }
+  *nTypeFound = DM_ENG_ParameterType_UNDEFINED;
 
-  // Unsigned integer
-  else if ( strcmp( pParameterType, XSD_UNSIGNEDINT ) == 0 ) { *nTypeFound = DM_ENG_ParameterType_UINT;      }
-
-  // Long
-  else if ( strcmp( pParameterType, XSD_LONG ) == 0 )        { *nTypeFound = DM_ENG_ParameterType_LONG;      }
-
-  // Boolean
-  else if ( strcmp( pParameterType, XSD_BOOLEAN ) == 0 )     { *nTypeFound = DM_ENG_ParameterType_BOOLEAN;   }
-
-  // Datetime
-  else if ( strcmp( pParameterType, XSD_DATETIME ) == 0 )    { *nTypeFound = DM_ENG_ParameterType_DATE;      }
-
-  // String
-  else if ( strcmp( pParameterType, XSD_STRING ) == 0 )      { *nTypeFound = DM_ENG_ParameterType_STRING;    }
-
-  // ANY kind (other kind of)
-  else if ( strcmp( pParameterType, XSD_ANY ) == 0 )         { *nTypeFound = DM_ENG_ParameterType_ANY;       }
-
-  // Unsigned integer
-  else	         { *nTypeFound = DM_ENG_ParameterType_UNDEFINED; }
+  // The length of the name selects the only type it can be (or two for 7 characters)
+  switch ( strlen( pParameterType ) )
+  {
+    case sizeof(XSD_INT)-1: // Same length as XSD_ANY
+      if ( strcmp( pParameterType, XSD_INT ) == 0 )              { *nTypeFound = DM_ENG_ParameterType_INT;       }
+      else if ( strcmp( pParameterType, XSD_ANY ) == 0 )         { *nTypeFound = DM_ENG_ParameterType_ANY;       }
+      break;
+    case sizeof(XSD_UNSIGNEDINT)-1:
+      if ( strcmp( pParameterType, XSD_UNSIGNEDINT ) == 0 )      { *nTypeFound = DM_ENG_ParameterType_UINT;      }
+      break;
+    case sizeof(XSD_LONG)-1:
+      if ( strcmp( pParameterType, XSD_LONG ) == 0 )             { *nTypeFound = DM_ENG_ParameterType_LONG;      }
+      break;
+    case sizeof(XSD_BOOLEAN)-1:
+      if ( strcmp( pParameterType, XSD_BOOLEAN ) == 0 )          { *nTypeFound = DM_ENG_ParameterType_BOOLEAN;   }
+      break;
+    case sizeof(XSD_DATETIME)-1:
+      if ( strcmp( pParameterType, XSD_DATETIME ) == 0 )         { *nTypeFound = DM_ENG_ParameterType_DATE;      }
+      break;
+    case sizeof(XSD_STRING)-1:
+      if ( strcmp( pParameterType, XSD_STRING ) == 0 )           { *nTypeFound = DM_ENG_ParameterType_STRING;    }
+      break;
+    default:
+      break;
+  }
   nRet = DM_OK;
 	} else {
   EXEC_ERROR( ERROR_INVALID_PARAMETERS );
@@ -2641,38 +3503,177 @@ DM_FindTypeParameter(IN  const char *pParameterType,
 
 
 /**
- * @brief function which remake the string buffer from a XML data structure
+ * @brief Function which starts a SOAP message sent by the CPE : Envelope (with its namespace
+ *        attributes), Header (with the cwmp:ID) and Body
  *
- * @param pElement  Current element of the XML tree
+ * @param pWriter  Writer to initialize (see dm_com_soap_writer.h)
+ * @param pSoapId  Value of the cwmp:ID header (no cwmp:ID if NULL)
+ * @param allEnveloppeAttributs true to add the XMLSchema namespace (Inform and GetParameterValuesResponse)
  *
- * @Return DM_OK is okay else DM_ERR
+ * @Return None
  *
+ * @Remarks The content of the body is then written by the caller and the message is terminated by DM_EndSoapMessage()
+ * @Remarks The Envelope attributes only depend on the prefixes and on the cwmp version : they are written once
+ *          then copied as is
  */
-DMRET
-DM_RemakeXMLBufferCpe(GenericXmlNodePtr pElement)
+void
+DM_StartSoapMessage(DM_SoapWriter * pWriter,
+                    const char    * pSoapId,
+                    bool            allEnveloppeAttributs)
 {
-  DMRET  nRet  = DM_ERR;
+  const char * cwmpVersion = NULL;
+  char      ** pAttributes = NULL;
+  size_t       nStart      = 0;
+
+  if (DM_COM_SoapEnv_NS == NULL) { _initPrefixedTag(); }
+
+  cwmpVersion = _getCwmpVersionSupported();
+  pAttributes = &_EnvelopeAttributes[allEnveloppeAttributs ? 1 : 0][strcmp( cwmpVersion, xmlns_cwmp_1_1_attribut_value ) == 0 ? 1 : 0];
+
+  DM_SoapWriter_init( pWriter );
+
+  DM_SoapWriter_startElement( pWriter, _EnvelopeTagName );
+  if ( *pAttributes != NULL ) {
+    DM_SoapWriter_addRawAttributes( pWriter, *pAttributes );
+  } else {
+    nStart = pWriter->length;
+    DM_SoapWriter_addAttribute( pWriter, xmlns_soapenc_attribut, xmlns_soapenc_attribut_value );
+    DM_SoapWriter_addAttribute( pWriter, _SoapEnvAttrName,       xmlns_soapenv_attribut_value );
+    if ( allEnveloppeAttributs ) {
+      // Add extra attributes for Inform and GetParameterValuesResponse
+      DM_SoapWriter_addAttribute( pWriter, xmlns_xsd_attribut, xmlns_xsd_attribut_value );
+    }
+    DM_SoapWriter_addAttribute( pWriter, xmlns_xsi_attribut,  xmlns_xsi_attribut_value );  // Added for ACS compatibility
+    DM_SoapWriter_addAttribute( pWriter, xmlns_cwmp_attribut, cwmpVersion );
 
-  if(NULL == pElement) {
-    EXEC_ERROR( "Invalid Parameter" );
-    return DM_ERR;
+    // Keep the attributes for the next messages
+    if ( !pWriter->error ) {
+      *pAttributes = DM_ENG_strndup( pWriter->buffer + nStart, pWriter->length - nStart );
+    }
   }
-  
-  // If g_pBufferCpe is not NULL, free it.
-  if(NULL != g_pBufferCpe) {
-    DM_FreeTMPXMLBufferCpe();
+
+  DM_SoapWriter_startElement( pWriter, _HeaderTagName );
+  if ( pSoapId != NULL ) {
+    DM_SoapWriter_startElement( pWriter, HEADER_ID );
+    DM_SoapWriter_addAttribute( pWriter, _MustUnderstandAttrName, HEADER_ATTR_VAL );
+    DM_SoapWriter_addText( pWriter, pSoapId );
+    DM_SoapWriter_endElement( pWriter );
   }
-  
-  g_pBufferCpe = xmlDocumentToStringBuffer(xmlNodeToDocument(pElement));
-  
-  if(NULL != g_pBufferCpe) {
-    // XML Tree converted into String
+  DM_SoapWriter_endElement( pWriter );
+
+  DM_SoapWriter_startElement( pWriter, _BodyTagName );
+} /* DM_StartSoapMessage */
+
+/**
+ * @brief Function which terminates a SOAP message started by DM_StartSoapMessage()
+ *
+ * @param pWriter  Writer of the message
+ *
+ * @Return The message (to be freed by the caller) or NULL on error
+ */
+char *
+DM_EndSoapMessage(DM_SoapWriter * pWriter)
+{
+  DM_SoapWriter_endElement( pWriter ); // Body
+  DM_SoapWriter_endElement( pWriter ); // Envelope
+
+  return DM_SoapWriter_detachBuffer( pWriter );
+} /* DM_EndSoapMessage */
+
+/**
+ * @brief Function which gives the XML schema type (xsi:type attribute) of a parameter value
+ *
+ * @param type  Type of the parameter
+ *
+ * @Return The type name (xsd:int, xsd:string...) or NULL if the type is unknown
+ */
+const char *
+DM_GetXsdTypeName(DM_ENG_ParameterType type)
+{
+  const char * xsdType = NULL;
+
+  switch ( type )
+  {
+    case DM_ENG_ParameterType_INT:       xsdType = XSD_INT;         break;
+    case DM_ENG_ParameterType_UINT:      xsdType = XSD_UNSIGNEDINT; break;
+    case DM_ENG_ParameterType_LONG:      xsdType = XSD_LONG;        break;
+    case DM_ENG_ParameterType_BOOLEAN:   xsdType = XSD_BOOLEAN;     break;
+    case DM_ENG_ParameterType_DATE:      xsdType = XSD_DATETIME;    break;
+    case DM_ENG_ParameterType_STRING:    xsdType = XSD_STRING;      break;
+    case DM_ENG_ParameterType_STATISTICS:
+    case DM_ENG_ParameterType_ANY:       xsdType = XSD_ANY;         break;
+    case DM_ENG_ParameterType_UNDEFINED: WARN( "Undefined type value!!" ); break;
+    default:
+      EXEC_ERROR( "Unknown type value for a parameter (%d) ", (int)type );
+      break;
+  }
+
+  return xsdType;
+} /* DM_GetXsdTypeName */
+
+/*
+* Private routine which terminates the SOAP message written by pWriter then sends it to the ACS server
+* Parameters: The writer of the message and the message name (for the traces)
+* return DM_OK if the message has been built (the sending errors are only traced)
+*/
+static DMRET
+_sendSoapMessage(DM_SoapWriter * pWriter,
+                 const char    * pMsgName UNUSED)
+{
+  DMRET                   nRet       = DM_ERR;
+  httpMessageBufferType * pMsgBuffer = DM_CreateHttpMessageBuffer( DM_EndSoapMessage( pWriter ) );
+
+  if ( pMsgBuffer != NULL ) {
+    // Send the HTTP message (the buffer is shared with the HTTP client, not copied)
+    if ( DM_SendHttpMessageBuffer( pMsgBuffer ) == DM_OK ) {
+      DBG( "%s - Sending http message : OK", pMsgName );
+    } else {
+      EXEC_ERROR( "%s - Sending http message : NOK", pMsgName );
+    }
+    // Release our reference
+    DM_ReleaseHttpMessageBuffer( pMsgBuffer );
     nRet = DM_OK;
+  } else {
+    EXEC_ERROR( "%s - Problem with the XML/SOAP buffer!!", pMsgName );
   }
-  
+
   return nRet;
-	
-} /* DM_RemakeXMLBufferCpe */
+}
+
+/*
+* Private routine which writes the beginning of a SOAP fault : soapenv:Fault, faultcode, faultstring,
+* detail and cwmp:Fault with its FaultCode and FaultString.
+* The cwmp:Fault element is left open so that some SetParameterValuesFault may be added, it is
+* closed by _endSoapFault().
+* Parameters: The writer of the message and the fault code
+*/
+static void
+_startSoapFault(DM_SoapWriter * pWriter,
+                int             nFaultCode)
+{
+  char pTmpBuffer[TMPBUFFER_SIZE];
+
+  DM_SoapWriter_startElement( pWriter, _FaultTagName );
+  DM_SoapWriter_addElement( pWriter, FAULT_CODE,   FAULT_CODE_CONTENT );
+  DM_SoapWriter_addElement( pWriter, FAULT_STRING, FAULT_STRING_CONTENT );
+  DM_SoapWriter_startElement( pWriter, FAULT_DETAIL );
+  DM_SoapWriter_startElement( pWriter, FAULT );
+  snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", nFaultCode );
+  DM_SoapWriter_addElement( pWriter, FAULTCODE2,   pTmpBuffer );
+  DM_SoapWriter_addElement( pWriter, FAULTSTRING2, DM_ENG_getFaultString(nFaultCode) );
+}
+
+/*
+* Private routine which closes the SOAP fault started by _startSoapFault()
+* Parameters: The writer of the message
+*/
+static void
+_endSoapFault(DM_SoapWriter * pWriter)
+{
+  DM_SoapWriter_endElement( pWriter ); // cwmp:Fault
+  DM_SoapWriter_endElement( pWriter ); // detail
+  DM_SoapWriter_endElement( pWriter ); // soapenv:Fault
+}
 
 // ---------------------------------------------------------------------------------
 // Sub functions of the Engine interface : DM_ENG_XXXX
@@ -2690,68 +3691,25 @@ DM_SoapEmptyResponse(
   IN const char *pSoapId,
 	IN const char *pResponseTag)
 {
-	DMRET  nMainRet       = DM_ERR;
-	DM_SoapXml	SoapMsg;
-	
-	memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));
-	
-	// Check parameter
-	if ( (pResponseTag != NULL) && (pSoapId != NULL) )
-	{
-  // ---------------------------------------------------------------------------
-  // Initialize the SOAP data structure
-  // ---------------------------------------------------------------------------
-  DM_FreeTMPXMLBufferCpe();
-  DM_InitSoapMsgReceived( &SoapMsg );
-  DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false ); 
+  DMRET         nMainRet = DM_ERR;
+  DM_SoapWriter writer;
 
-  // ---------------------------------------------------------------------------
-  // Update the SOAP HEADER
-  // ---------------------------------------------------------------------------
-  DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-	  
-  // ---------------------------------------------------------------------------
-  // Add the RESPONSE TAG tag
-  // ---------------------------------------------------------------------------
-  xmlAddNode(SoapMsg.pParser,             // XML Document
-             SoapMsg.pBody,               // XML Parent Node
-             (char*) pResponseTag,        // New Node TAG
-             NULL,                        // Attr Name
-             NULL,                        // Attr Value
-             NULL);                       // Node Value
-  
-  // ---------------------------------------------------------------------------
-  // Remake the XML buffer then send it to the ACS server
-  // ---------------------------------------------------------------------------
-  if ( SoapMsg.pRoot != NULL )
-  {
-	  DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-	  if ( g_pBufferCpe != NULL )
-	  { 
-	    // Send the HTTP message
-    if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-	    DBG( "Empty Response - Sending http message : OK" );
-    } else {
-	    EXEC_ERROR( "Empty Response - Sending http message : NOK" );
-    }
-    
-    // Free the buffer
-    DM_FreeTMPXMLBufferCpe();
-	  }
+  // Check parameter
+  if ( (pResponseTag != NULL) && (pSoapId != NULL) ) {
+    DM_StartSoapMessage( &writer, pSoapId, false );
+
+    // Add the RESPONSE TAG tag
+    DM_SoapWriter_addElement( &writer, pResponseTag, NULL );
+
+    // Send the message to the ACS server
+    _sendSoapMessage( &writer, "Empty Response" );
+
+    nMainRet = DM_OK;
+  } else {
+    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
   }
-  
-  nMainRet = DM_OK;
-	} else {
-  EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-	}
-	
-	if(NULL != SoapMsg.pParser) {
-	  // Free xml document
-	  xmlDocumentFree(SoapMsg.pParser);
-	  SoapMsg.pParser = NULL;
-	}
 
-	return( nMainRet );
+  return( nMainRet );
 }
 
 /**
@@ -2767,115 +3725,25 @@ DM_SoapFaultResponse(
   IN const char *pSoapId,
 	IN       int   nFaultCode)
 {
-	DMRET      nMainRet            = DM_ERR;
-	char      pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml	SoapMsg;
-	
-	memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));
-	
-	// Check parameter
-	if ( pSoapId != NULL )
-	{
-  DBG( "Creating the SOAP Fault for the ACS server." );
-  
-  // ---------------------------------------------------------------------------
-  // Initialize the SOAP data structure
-  // ---------------------------------------------------------------------------
-  DM_FreeTMPXMLBufferCpe();
-  DM_InitSoapMsgReceived( &SoapMsg );
-  DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
+  DMRET         nMainRet = DM_ERR;
+  DM_SoapWriter writer;
 
-  
-  // ---------------------------------------------------------------------------
-  // Update the SOAP HEADER
-  // ---------------------------------------------------------------------------
-  DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-  
-  // ---------------------------------------------------------------------------
-  // Update the DEFAULT's SOAP FAULT MESSAGE
-  // ---------------------------------------------------------------------------
-  // Add the 'Fault' tag
-  // scew_element *pRefFaultTag     = scew_element_add( SoapMsg.pBody, FAULT_TAG_CPE );
-  GenericXmlNodePtr faultCpeNode = xmlAddNode(SoapMsg.pParser, SoapMsg.pBody, _FaultTagName, NULL, NULL, NULL);
-  
-  // Add the 'faultcode' tag
-  xmlAddNode(SoapMsg.pParser,        // doc
-             faultCpeNode,           // parentNode
-             FAULT_CODE,             // Node Name
-             NULL,                   // Attribut Name
-             NULL,                   // Attribut Value
-             FAULT_CODE_CONTENT);    // Node Value  				    
-  
-  // Add the 'faultString' tag
-	xmlAddNode(SoapMsg.pParser,        // doc
-	           faultCpeNode,           // parentNode
-	           FAULT_STRING,           // Node Name
-	           NULL,                   // Attribut Name
-	           NULL,                   // Attribut Value
-	           FAULT_STRING_CONTENT);  // Node Value  			
-					    
-  
-  // Add the 'detail' tag
-  GenericXmlNodePtr faultDetailNode = xmlAddNode(SoapMsg.pParser, faultCpeNode, FAULT_DETAIL, NULL, NULL, NULL);  
-	              
-  // Add the 'Fault' tag
-	GenericXmlNodePtr faultNode = xmlAddNode(SoapMsg.pParser,        // doc
-	                                         faultDetailNode,        // parentNode
-						                               FAULT,                  // Node Name
-										                       NULL, //FAULT_ATTR,             // Attribut Name
-													                 NULL, // _getCwmpVersionSupported(), // Attribut Value
-															             NULL);                  // Node Value  			  
-  
-  // Add the 'FaultCode' tag and update its content
-  snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", nFaultCode );
+  // Check parameter
+  if ( pSoapId != NULL ) {
+    DBG( "Creating the SOAP Fault for the ACS server." );
+    DM_StartSoapMessage( &writer, pSoapId, false );
 
-	xmlAddNode(SoapMsg.pParser,  // doc
-	           faultNode,          // parentNode
-	           FAULTCODE2,         // Node Name
-	           NULL,               // Attribut Name
-	           NULL,               // Attribut Value
-	           (char*)pTmpBuffer); // Node Value  			  
-  
-	xmlAddNode(SoapMsg.pParser,       // doc
-	           faultNode,             // parentNode
-	           FAULTSTRING2,          // Node Name
-	           NULL,                  // Attribut Name
-	           NULL,                  // Attribut Value
-              DM_ENG_getFaultString(nFaultCode)); // Node Value
+    // Write the DEFAULT's SOAP FAULT MESSAGE
+    _startSoapFault( &writer, nFaultCode );
+    _endSoapFault( &writer );
 
-  // ---------------------------------------------------------------------------
-  // Remake the XML buffer then send it to the ACS server
-  // ---------------------------------------------------------------------------
-  if ( SoapMsg.pRoot != NULL ){
-	  DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-    if ( g_pBufferCpe != NULL ) {
-      // Send the HTTP message
-      if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-	      DBG( "Soap Fault Response - Sending http message : OK" );
-      } else {
-	      EXEC_ERROR( "Soap Fault Response - Sending http message : NOK" );
-      }
-    
-      // Free the buffer
-      DM_FreeTMPXMLBufferCpe();
-    
-      nMainRet = DM_OK;
-    } else {
-      EXEC_ERROR( "Problem with the XML/SOAP buffer!!" );
-	  }
+    // Send the message to the ACS server
+    nMainRet = _sendSoapMessage( &writer, "Soap Fault Response" );
+  } else {
+    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
   }
-  
-	} else {
-  EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-	}
-	
-	// Free xml document
-	if(NULL != SoapMsg.pParser) {
-	  xmlDocumentFree(SoapMsg.pParser); 
-	  SoapMsg.pParser = NULL;
-	}
 
-	return( nMainRet );
+  return( nMainRet );
 }
 
 /**
@@ -2899,28 +3767,26 @@ DM_FreeTMPXMLBufferCpe()
  * @brief Function which update the retry buffer whith 
  *        the last emitted request.
  *
- * @param A Pointer on the message to store (string) and its size
+ * @param A Pointer on the shared buffer of the message to store (see httpMessageBufferType),
+ *        NULL or an empty message to forget the previous one
  *
  * @Return DM_OK
  *
  */
 DMRET
-DM_UpdateRetryBuffer(const char * soapMsgToStoreStr, int size) 
+DM_UpdateRetryBuffer(httpMessageBufferType * pMsgToStore) 
 {
-  DBG("DM_UpdateRetryBuffer - Update the buffer to perform RetryRequest if needed");
-  
-  if(NULL == soapMsgToStoreStr) {
-    DBG("No message to store");
-    return DM_OK;
-  }
+  httpMessageBufferType * pPreviousMsg = g_retryBuffer;
 
-  // Free g_retryBuffer
-  DM_ENG_FREE(g_retryBuffer);
+  DBG("DM_UpdateRetryBuffer - Update the buffer to perform RetryRequest if needed");
 
-  if(0 != size) {
-    // Copy g_pBufferCpe into g_retryBuffer
-    g_retryBuffer = strdup(soapMsgToStoreStr);
+  // Keep a reference on the message (no copy). It is taken before the previous one is released
+  // since they are the same buffer when the message is retried.
+  g_retryBuffer = NULL;
+  if((NULL != pMsgToStore) && (0 != pMsgToStore->length)) {
+    g_retryBuffer = DM_RetainHttpMessageBuffer(pMsgToStore);
   }
+  DM_ReleaseHttpMessageBuffer(pPreviousMsg);
 
   return (DM_OK);
 
@@ -2971,120 +3837,61 @@ DM_UpdateRetryBuffer(const char * soapMsgToStoreStr, int size)
 DMRET
 DM_SUB_GetRPCMethods(IN const char *pSoapId)
 {
-	int		      nRPCRet	        = DM_ENG_METHOD_NOT_SUPPORTED;
-	DMRET		      nMainRet         = DM_ERR;
-	const char**   methodsList      = NULL;
-	char		      pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml	  SoapMsg;
-	
-	// Check parameter
-	if ( pSoapId != NULL )	{
-	
+  int            nRPCRet     = DM_ENG_METHOD_NOT_SUPPORTED;
+  DMRET          nMainRet    = DM_ERR;
+  const char  ** methodsList = NULL;
+  char           pTmpBuffer[TMPBUFFER_SIZE];
+  DM_SoapWriter  writer;
+
+  // Check parameter
+  if ( pSoapId != NULL ) {
     // Launching the RPC method from the DM_ENGINE
     DBG( " GetRPCMethods( EntityType_ACS, &methodsList ) " );
     nRPCRet = DM_ENG_GetRPCMethods( DM_ENG_EntityType_ACS,  &methodsList );
 
     // Check the RPC's return code
-    if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (methodsList != NULL) ){
+    if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (methodsList != NULL) ) {
       int nI           = 0;
       int nNbRPCMEthod = 0;
 
       DBG( "GetRPCMethods : OK " );
       DBG( "Creating the SOAP Response for the ACS server." );
-			
-			// ---------------------------------------------------------------------------
-			// Initialize the SOAP data structure then create the XML/SOAP response
-			// --------------------------------------------------------------------------
-			DM_FreeTMPXMLBufferCpe();
-			DM_InitSoapMsgReceived( &SoapMsg );
-			DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
+      DM_StartSoapMessage( &writer, pSoapId, false );
+      DM_SoapWriter_startElement( &writer, GETRPCMETHODSRESPONSE );
 
-		
-			// ---------------------------------------------------------------------------
-			// Update the SOAP HEADER & BODY
-			// --> Add the GetRPCMethodsResponse tag
-			// ---------------------------------------------------------------------------
-			DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-      GenericXmlNodePtr pRefGetRPCMethodsResponse = xmlAddNode(SoapMsg.pParser,       // XML Document
-                                                                   SoapMsg.pBody,         // XML Parent Node
-                                                                   GETRPCMETHODSRESPONSE, // Node Name
-                                                                   NULL,                  // Attribute Name
-                                                                   NULL,                  // Attribute Value
-                                                                   NULL);                 // Node Value
-			
-			// ---------------------------------------------------------------------------
-			// Update the SOAP BODY
-			// --> Count how many RPC methods have been given by the DM_Engine
-			// ---------------------------------------------------------------------------
-			nNbRPCMEthod = DM_ENG_tablen( (void**)methodsList );
-
-			// ---------------------------------------------------------------------------
-			// Add the MethodList with its attribute
-	    GenericXmlNodePtr pRefMethodList = xmlAddNode(SoapMsg.pParser,            // XML Document
-                                                    pRefGetRPCMethodsResponse,  // XML Parent Node
-                                                    GETRPCMETHODSMETHODLIST,    // Node Name
-								                                    NULL,                       // Attribute Name
-														                        NULL,                       // Attribute Value
-																		                NULL);                      // Node Value	  
-			
-			if ( nNbRPCMEthod < 10 ) {
-				snprintf( pTmpBuffer, TMPBUFFER_SIZE, STRING_LIST_ATTR_VAL1, nNbRPCMEthod );
-			} else {
-				snprintf( pTmpBuffer, TMPBUFFER_SIZE, STRING_LIST_ATTR_VAL2, nNbRPCMEthod );
-			}
-			
-			xmlAddNodeAttribut(pRefMethodList, DM_COM_ArrayTypeAttrName, pTmpBuffer);
-			
-			// ---------------------------------------------------------------------------
-			// Add the RPC Methods
-			for ( nI=0 ; nI<nNbRPCMEthod ; nI++ )	{
-			  
-        xmlAddNode(SoapMsg.pParser,          // XML Document
-                   pRefMethodList,           // XML Parent Node
-                   PARAM_STRING,             // New Node TAG
-                   NULL,                     // Attribute Name
-                   NULL,                     // Attribute Value
-                   methodsList[nI] );        // New Node Value			  
+      // Count how many RPC methods have been given by the DM_Engine
+      nNbRPCMEthod = DM_ENG_tablen( (void**)methodsList );
 
-			}
-			
-			// ---------------------------------------------------------------------------
-			// Remake the XML buffer then send it to the ACS server
-			// ---------------------------------------------------------------------------
-			if ( SoapMsg.pRoot != NULL )
-			{
-				DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-				if ( g_pBufferCpe != NULL ) {
-					// Send the message
-					if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-						DBG( "Sending https/SOAP message (GetRPCMEthods response) : OK" );
-					} else {
-					  EXEC_ERROR( "Sending https/SOAP message (GetRPCMEthods response) : NOK" );
-					}
-					
-					// Free the buffer
-					DM_FreeTMPXMLBufferCpe();
-				}
-			}
+      // Add the MethodList with its attribute
+      DM_SoapWriter_startElement( &writer, GETRPCMETHODSMETHODLIST );
+      if ( nNbRPCMEthod < 10 ) {
+        snprintf( pTmpBuffer, TMPBUFFER_SIZE, STRING_LIST_ATTR_VAL1, nNbRPCMEthod );
+      } else {
+        snprintf( pTmpBuffer, TMPBUFFER_SIZE, STRING_LIST_ATTR_VAL2, nNbRPCMEthod );
+      }
+      DM_SoapWriter_addAttribute( &writer, DM_COM_ArrayTypeAttrName, pTmpBuffer );
 
-			nMainRet = DM_OK;
-		} else {
-		  EXEC_ERROR( "GetRPCMethods : NOK (%d) ", nRPCRet );
-			
-			// Send a fault SOAP message to the ACS server (NOK)
-			DM_SoapFaultResponse( pSoapId, nRPCRet );
-		}
-	} else {
-	  EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-	}
-	
-	// Free xml document
-	if(NULL != SoapMsg.pParser) {
-	  xmlDocumentFree(SoapMsg.pParser);
-	  SoapMsg.pParser = NULL; 
-	}
-	
-	return( nMainRet );
+      // Add the RPC Methods
+      for ( nI=0 ; nI<nNbRPCMEthod ; nI++ ) {
+        DM_SoapWriter_addElement( &writer, PARAM_STRING, methodsList[nI] );
+      }
+      DM_SoapWriter_endElement( &writer ); // MethodList
+      DM_SoapWriter_endElement( &writer ); // GetRPCMethodsResponse
+
+      // Send the message to the ACS server
+      _sendSoapMessage( &writer, "GetRPCMethods" );
+
+      nMainRet = DM_OK;
+    } else {
+      EXEC_ERROR( "GetRPCMethods : NOK (%d) ", nRPCRet );
+      // Send a fault SOAP message to the ACS server (NOK)
+      DM_SoapFaultResponse( pSoapId, nRPCRet );
+    }
+  } else {
+    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+  }
+
+  return( nMainRet );
 } /* DM_SUB_GetRPCMethods */
 
 /**
@@ -3101,164 +3908,70 @@ DM_SUB_GetParameterNames(IN const char *pSoapId,
 	   IN const char *pPath,
 	   IN       bool  nNextLevel)
 {
+  int                           nRPCRet  = DM_ENG_METHOD_NOT_SUPPORTED;
+  DMRET                         nMainRet = DM_ERR;
+  DM_ENG_ParameterInfoStruct ** pResult  = NULL;
+  char                          pTmpBuffer[TMPBUFFER_SIZE];
+  DM_SoapWriter                 writer;
 
+  // Check parameters
+  if ( (pSoapId !=NULL) && (pPath != NULL) ) {
+    // Launching the RPC method from the DM_ENGINE
+    DBG( " GetParameterNames( EntityType_ACS, pPath, nNextLevel, pResult ) " );
+    nRPCRet = DM_ENG_GetParameterNames( DM_ENG_EntityType_ACS,
+                                        (char*)pPath,
+                                        nNextLevel,
+                                        &pResult );
 
-	int		  	  nRPCRet		= DM_ENG_METHOD_NOT_SUPPORTED;
-	DMRET		  	  nMainRet		= DM_ERR;
-	DM_ENG_ParameterInfoStruct	**pResult		= NULL;
-	char		  	  pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml	  	  SoapMsg;
-		
-	// Check parameters
-	if ( (pSoapId !=NULL) && (pPath != NULL) ){
-		// ---------------------------------------------------------------------------
-		// Initialize the SOAP data structure
-		// ---------------------------------------------------------------------------
-		DM_InitSoapMsgReceived( &SoapMsg );
-		
-		// ---------------------------------------------------------------------------
-		// Launching the RPC method from the DM_ENGINE
-		// ---------------------------------------------------------------------------
-		DBG( " GetParameterNames( EntityType_ACS, pPath, nNextLevel, pResult ) " );
-		nRPCRet = DM_ENG_GetParameterNames( DM_ENG_EntityType_ACS,
-					                             (char*)pPath,
-					                              nNextLevel,
-					                              &pResult );
-			
-		// ---------------------------------------------------------------------------
-		// Check the RPC's return code
-		// ---------------------------------------------------------------------------
-		if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) )	{
-			int nI               = 0;
-			int nNbParameterList = 0;
-			
-			DBG( "GetParameterName : OK " );
-			DBG( "Creating the SOAP Response for the ACS server." );
-			// ---------------------------------------------------------------------------
-			// Create the XML/SOAP response
-			// ---------------------------------------------------------------------------
-         DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
-
-			// ---------------------------------------------------------------------------
-			// Update the SOAP HEADER
-			// ---------------------------------------------------------------------------
-			DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-			
-			// ---------------------------------------------------------------------------
-			// Add a GetParameterNameResponse tag
-			// ---------------------------------------------------------------------------
-      GenericXmlNodePtr pRefGetParameterNameResponse = xmlAddNode(SoapMsg.pParser,       // XML Document
-                                                                  SoapMsg.pBody,         // XML Parent Node
-                                                                  GETPARAMETERNAMERESPONSE, // Node Name
-                                                                  NULL,                  // Attribute Name
-                                                                  NULL,                  // Attribute Value
-                                                                  NULL);                 // Node Value			
-			
-	
-			// ---------------------------------------------------------------------------
-			// Add a ParameterList tag
-			// ---------------------------------------------------------------------------
-	    GenericXmlNodePtr pRefParameterList = xmlAddNode(SoapMsg.pParser,               // XML Document
-                                                       pRefGetParameterNameResponse,  // XML Parent Node
-                                                       PARAMETERINFOSTRUCT_LIST,      // Node Name
-								                                       NULL,                          // Attribute Name
-														                           NULL,                          // Attribute Value
-																		                   NULL);                         // Node Value	  
-																							
-			// ---------------------------------------------------------------------------
-			// Count how many parameter there is in the list, then add this information
-			// as an attribute of the ParameterList tag
-			// ---------------------------------------------------------------------------
-			nNbParameterList = DM_ENG_tablen( (void**)pResult );
-
-			DBG( "Number of parameters found = %d ", nNbParameterList );
-			if ( nNbParameterList<10 ) {
-				snprintf( pTmpBuffer, TMPBUFFER_SIZE, PARAMETERINFOSTRUCT_ATTR_VAL1, nNbParameterList );
-			} else {
-				snprintf( pTmpBuffer, TMPBUFFER_SIZE, PARAMETERINFOSTRUCT_ATTR_VAL2, nNbParameterList );
-			}
-      xmlAddNodeAttribut(pRefParameterList, DM_COM_ArrayTypeAttrName, pTmpBuffer);
-			
-			// ---------------------------------------------------------------------------
-			// Add parameters in the ParameterList
-			// ---------------------------------------------------------------------------
-			for ( nI=0 ; nI<nNbParameterList ; nI++ )	{
-				// Add a ParameterInfoStruct tag
-        GenericXmlNodePtr pRefParamStruct = xmlAddNode(SoapMsg.pParser,       // XML Document
-                                                       pRefParameterList,     // XML Parent Node
-                                                       PARAMETERINFOSTRUCT,   // Node Name
-                                                       NULL,                  // Attribute Name
-                                                       NULL,                  // Attribute Value
-                                                       NULL);                 // Node Value	
-				
-				
-				
-				// Add a Name tag with its value
-        xmlAddNode(SoapMsg.pParser,             // XML Document
-                   pRefParamStruct,             // XML Parent Node
-                   PARAMETERINFOSTRUCT_NAME,    // Node Name
-                   NULL,                        // Attribute Name
-                   NULL,                        // Attribute Value
-                   pResult[nI]->parameterName); // Node Value					
-				
-				
-				
-				
-				
-				// Add a writable tag with its value
-				snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)pResult[nI]->writable );
-        xmlAddNode(SoapMsg.pParser,             // XML Document
-                   pRefParamStruct,             // XML Parent Node
-                   PARAMETERINFOSTRUCT_WRITABLE,// Node Name
-                   NULL,                        // Attribute Name
-                   NULL,                        // Attribute Value
-                   pTmpBuffer);                 // Node Value							
-				
-				
-				
-			}
+    // Check the RPC's return code
+    if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ) {
+      int nI               = 0;
+      int nNbParameterList = 0;
 
-			// ---------------------------------------------------------------------------
-			// Remake the XML buffer then send it to the ACS server
-			// ---------------------------------------------------------------------------
-			if ( SoapMsg.pRoot != NULL ) {
-				DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-				if ( g_pBufferCpe != NULL ) {
-					if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-						DBG( "Sending http message : OK" );
-					} else {
-					  EXEC_ERROR( "Sending http message : NOK" );
-					}
-				
-					// Free the buffer
-					DM_FreeTMPXMLBufferCpe();
-				}
-			}
-			
-			// ---------------------------------------------------------------------------
-			// Free the array given by the DM_Engine
-			// ---------------------------------------------------------------------------
-			DM_ENG_deleteTabParameterInfoStruct( pResult );
-			
-			nMainRet = DM_OK;
-		} else {
-		  EXEC_ERROR( "GetParameterName : NOK (%d) ", nRPCRet );
-		
-			// Send a fault SOAP message to the ACS server
-			DM_SoapFaultResponse( pSoapId, nRPCRet );
-		}
-	} else {
-	  EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-	}
-	
-// Free xml document
-	if(NULL != SoapMsg.pParser) {
-	  xmlDocumentFree(SoapMsg.pParser);
-	  SoapMsg.pParser = NULL; 
-	}
-	
-	return( nMainRet );
+      DBG( "GetParameterName : OK " );
+      DBG( "Creating the SOAP Response for the ACS server." );
+      DM_StartSoapMessage( &writer, pSoapId, false );
+      DM_SoapWriter_startElement( &writer, GETPARAMETERNAMERESPONSE );
+
+      // Count how many parameter there is in the list, then add this information
+      // as an attribute of the ParameterList tag
+      nNbParameterList = DM_ENG_tablen( (void**)pResult );
+      DBG( "Number of parameters found = %d ", nNbParameterList );
+      DM_SoapWriter_startElement( &writer, PARAMETERINFOSTRUCT_LIST );
+      if ( nNbParameterList<10 ) {
+        snprintf( pTmpBuffer, TMPBUFFER_SIZE, PARAMETERINFOSTRUCT_ATTR_VAL1, nNbParameterList );
+      } else {
+        snprintf( pTmpBuffer, TMPBUFFER_SIZE, PARAMETERINFOSTRUCT_ATTR_VAL2, nNbParameterList );
+      }
+      DM_SoapWriter_addAttribute( &writer, DM_COM_ArrayTypeAttrName, pTmpBuffer );
+
+      // Add parameters in the ParameterList
+      for ( nI=0 ; nI<nNbParameterList ; nI++ ) {
+        DM_SoapWriter_startElement( &writer, PARAMETERINFOSTRUCT );
+        DM_SoapWriter_addElement( &writer, PARAMETERINFOSTRUCT_NAME, pResult[nI]->parameterName );
+        snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)pResult[nI]->writable );
+        DM_SoapWriter_addElement( &writer, PARAMETERINFOSTRUCT_WRITABLE, pTmpBuffer );
+        DM_SoapWriter_endElement( &writer ); // ParameterInfoStruct
+      }
+      DM_SoapWriter_endElement( &writer ); // ParameterList
+      DM_SoapWriter_endElement( &writer ); // GetParameterNamesResponse
+
+      // Send the message to the ACS server
+      _sendSoapMessage( &writer, "GetParameterNames" );
+
+      // Free the array given by the DM_Engine
+      DM_ENG_deleteTabParameterInfoStruct( pResult );
+      nMainRet = DM_OK;
+    } else {
+      EXEC_ERROR( "GetParameterName : NOK (%d) ", nRPCRet );
+      // Send a fault SOAP message to the ACS server
+      DM_SoapFaultResponse( pSoapId, nRPCRet );
+    }
+  } else {
+    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+  }
 
+  return( nMainRet );
 } /* DM_SUB_GetParameterNames */
 
 /**
@@ -3297,252 +4010,235 @@ DM_SUB_SetParameterValues(
   IN       DM_ENG_ParameterValueStruct **pParameterList,
   IN const char                  *pParameterKey)
 {
-	DM_ENG_SetParameterValuesFault ** pFaults        = NULL;
-	DMRET                      nMainRet	      = DM_ERR;
-	int                        nRPCRet	      = DM_ENG_METHOD_NOT_SUPPORTED;
-	char                       pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml                 SoapMsg;
-	DM_ENG_ParameterStatus     Status;
-	
-	
-	memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));
-	
-	// Check parameters
-   if ( (pSoapId != NULL) && (pParameterList != NULL) && (pParameterKey != NULL) )	{
+  DM_ENG_SetParameterValuesFault ** pFaults  = NULL;
+  DMRET                             nMainRet = DM_ERR;
+  int                               nRPCRet  = DM_ENG_METHOD_NOT_SUPPORTED;
+  char                              pTmpBuffer[TMPBUFFER_SIZE];
+  DM_SoapWriter                     writer;
+  DM_ENG_ParameterStatus            Status;
+
+  // Check parameters
+  if ( (pSoapId != NULL) && (pParameterList != NULL) && (pParameterKey != NULL) ) {
+    // Launching the RPC method from the DM_ENGINE
+    if ( !_isValidRpcCommandList( pParameterList ) ) {
+      // A parameter can not be set twice by the same SetParameterValues (cf TR069 protocol)
+      nRPCRet = DM_ENG_INVALID_ARGUMENTS;
+    } else {
+      DBG( " SetParameterValues( DM_ENG_EntityType_ACS, pParameterList, (char*)pParameterKey, &Status, &pFaults ) " );
+      nRPCRet = DM_ENG_SetParameterValues( DM_ENG_EntityType_ACS,
+                                           pParameterList,
+                                           (char*)pParameterKey,
+                                           &Status,
+                                           &pFaults );
+    }
 
-   // ---------------------------------------------------------------------------
-   // Initialize the SOAP data structure
-   // ---------------------------------------------------------------------------
-     DBG( "Creating the SOAP Response for the ACS server." );
-     DM_InitSoapMsgReceived( &SoapMsg );
-     DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
+    DBG( "Creating the SOAP Response for the ACS server." );
+    DM_StartSoapMessage( &writer, pSoapId, false );
 
+    // Check the RPC's return code
+    if ( nRPCRet == RPC_CPE_RETURN_CODE_OK ) {
+      DBG( "DM_ENG_SetParameterValues : OK " );
 
-  // ---------------------------------------------------------------------------
-  // Launching the RPC method from the DM_ENGINE
-  // ---------------------------------------------------------------------------
-  DBG( " SetParameterValues( DM_ENG_EntityType_ACS, pParameterList, (char*)pParameterKey, &Status, &pFaults ) " );
-  nRPCRet = DM_ENG_SetParameterValues( DM_ENG_EntityType_ACS,
-                                pParameterList,
-                                (char*)pParameterKey,
-                                &Status,
-                                &pFaults );
+      // Add a SetParameterValueResponse tag with the status
+      DM_SoapWriter_startElement( &writer, SETPARAMETERVALUESRESPONSE );
+      DBG( " Status of the SetParameterValue = %d ", (int)Status);
+      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)Status );
+      DM_SoapWriter_addElement( &writer, SETPARAMETERVALUERESPONSESTATUS, pTmpBuffer );
+      DM_SoapWriter_endElement( &writer );
 
-  
-  // ---------------------------------------------------------------------------
-  // Check the RPC's return code
-  // ---------------------------------------------------------------------------
-  if ( nRPCRet == RPC_CPE_RETURN_CODE_OK ) {
-	  DBG( "DM_ENG_SetParameterValues : OK " );
-  
-	  // ---------------------------------------------------------------------------
-	  // Update the SOAP HEADER
-	  // ---------------------------------------------------------------------------
-	  DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-	  
-	  // ---------------------------------------------------------------------------
-	  // Add a SetParameterValueResponse tag
-	  // ---------------------------------------------------------------------------
-    GenericXmlNodePtr setParamValuesRespNode = xmlAddNode(SoapMsg.pParser,             // XML Document
-	                                                        SoapMsg.pBody,               // XML Parent Node
-                                                          SETPARAMETERVALUESRESPONSE,  // New Node TAG
-                                                          NULL,                        // Attr Name
-                                                          NULL,                        // Attr Value
-							                                            NULL);                       // Node Value
-	  
-	  // ---------------------------------------------------------------------------
-	  // Add the status
-	  // ---------------------------------------------------------------------------
-	  DBG( " Status of the SetParameterValue = %d ", (int)Status);
-	  snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)Status );
-    xmlAddNode(SoapMsg.pParser,                  // XML Document
-               setParamValuesRespNode,           // XML Parent Node
-               SETPARAMETERVALUERESPONSESTATUS,  // New Node TAG
-               NULL,                             // Attr Name
-               NULL,                             // Attr Value
-               pTmpBuffer);                      // Node Value
- 
-	        
-	  // ---------------------------------------------------------------------------
-	  // Remake the XML buffer then send it to the ACS server
-	  // ---------------------------------------------------------------------------
-	  if ( SoapMsg.pRoot != NULL ){
-      DM_RemakeXMLBufferCpe( xmlDocumentToNode(SoapMsg.pRoot) );
-      if ( g_pBufferCpe != NULL ) {
-	      // Send the HTTP message
-	      if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-          DBG( "SetParameterValues Response - Sending http message : OK" );
-	      } else {
-          EXEC_ERROR( "SetParameterValues Response - Sending http message : NOK" );
-	      }
-	            
-	      // Free the buffer
-	      DM_FreeTMPXMLBufferCpe();
+      // Send the message to the ACS server
+      _sendSoapMessage( &writer, "SetParameterValues Response" );
+      nMainRet = DM_OK;
+    } else {
+      int nI                = 0;
+      int nNbParameterFault = 0;
+
+      EXEC_ERROR( "SetParameterValues : NOK (%d) ", nRPCRet );
+      DBG( "Creating the SOAP Fault for the ACS server." );
+      _startSoapFault( &writer, nRPCRet );
+
+      // Count how many parameter there is in the parameter fault list
+      nNbParameterFault = DM_ENG_tablen( (void**)pFaults );
+      DBG( "Number of parameter found in the list: %d ", nNbParameterFault );
+
+      // Add a SetParameterValuesFault for each parameter of the list
+      for ( nI=0 ; nI<nNbParameterFault ; nI++ ) {
+        DM_SoapWriter_startElement( &writer, SETPARAMETERVALUEFAULT );
+        DM_SoapWriter_addElement( &writer, PARAM_PARAMETERNAME, pFaults[nI]->parameterName );
+        snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)pFaults[nI]->faultCode );
+        DM_SoapWriter_addElement( &writer, FAULTCODE, pTmpBuffer );
+        DM_SoapWriter_addElement( &writer, FAULTSTRING, pFaults[nI]->faultString );
+        DM_SoapWriter_endElement( &writer );
+      } // end for
+      _endSoapFault( &writer );
+
+      // Send the message to the ACS server
+      nMainRet = _sendSoapMessage( &writer, "SetParameterValues" );
+
+      // Free the array given by the DM_Engine
+      if ( pFaults != NULL ) {
+        DM_ENG_deleteTabSetParameterValuesFault( pFaults );
       }
-	  }
+    }
+  } else {
+    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+  }
 
-	  nMainRet = DM_OK;
-	  
+  return( nMainRet );
+} /* DM_SUB_SetParameterValues */
+
+/*
+* Private routine which writes the SOAP message up to the ParameterList start tag of a GetParameterValuesResponse
+* Parameters: The writer of the message, the SOAP ID and the number of ParameterValueStruct
+*/
+static void
+_startGetParameterValuesResponse(DM_SoapWriter * pWriter,
+                                 const char    * pSoapId,
+                                 int             nNbParameterValueStruct)
+{
+  char pTmpBuffer[TMPBUFFER_SIZE];
+
+  DM_StartSoapMessage( pWriter, pSoapId, true );
+  DM_SoapWriter_startElement( pWriter, GETPARAMETERVALUESRESPONSE );
+
+  // Update the attribute of the ParameterList tag with the number of ParameterValueStruct
+  DM_SoapWriter_startElement( pWriter, PARAMETERINFOSTRUCT_LIST );
+  if ( nNbParameterValueStruct<10 ) {
+    snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_PARAMETERLIST_ATTR_VAL1, nNbParameterValueStruct );
   } else {
-	  EXEC_ERROR( "SetParameterValues : NOK (%d) ", nRPCRet );
-	  DBG( "Creating the SOAP Fault for the ACS server." );
-	  int nI                = 0;
-	  int nNbParameterFault = 1;
-	  
-	  // ---------------------------------------------------------------------------
-	  // Update the SOAP HEADER
-	  // ---------------------------------------------------------------------------
-	  DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-	  
-	  // ---------------------------------------------------------------------------
-	  // Update the DEFAULT's SOAP FAULT MESSAGE
-	  // ---------------------------------------------------------------------------
-	  // Add the 'Fault' tag
-    GenericXmlNodePtr pRefFaultTag = xmlAddNode(SoapMsg.pParser, // XML Document
-                                                SoapMsg.pBody,   // XML Parent Node
-						                                    _FaultTagName,   // New Node TAG
-										                            NULL,            // Attribute Name
-													                      NULL,            // Attribute Value
-															                  NULL);           // New Node Value
-						    
-	  
-	  // Add the 'faultcode' tag
-    xmlAddNode(SoapMsg.pParser,      // XML Document
-               pRefFaultTag,         // XML Parent Node
-		           FAULT_CODE,           // New Node TAG
-		           NULL,                 // Attribute Name
-		           NULL,                 // Attribute Value
-		           FAULT_CODE_CONTENT);  // New Node Value
-	  
-	  // Add the 'faultString' tag
-    xmlAddNode(SoapMsg.pParser,        // XML Document
-               pRefFaultTag,           // XML Parent Node
-		           FAULT_STRING,           // New Node TAG
-		           NULL,                   // Attribute Name
-		           NULL,                   // Attribute Value
-		           FAULT_STRING_CONTENT);  // New Node Value
-	  
-	  
-	  // Add the 'detail' tag
-    GenericXmlNodePtr pRefDetail = xmlAddNode(SoapMsg.pParser, // XML Document
-                                              pRefFaultTag,    // XML Parent Node
-						                                  FAULT_DETAIL,    // New Node TAG
-										                          NULL,            // Attribute Name
-													                    NULL,            // Attribute Value
-															                NULL);           // New Node Value
-	  
-	  // Add the 'Fault' tag
-    GenericXmlNodePtr pRefFault = xmlAddNode(SoapMsg.pParser, // XML Document
-                                             pRefDetail,      // XML Parent Node
-						                                 FAULT,           // New Node TAG
-										                         NULL,            // FAULT_ATTR,      // Attribute Name
-													                   NULL,            // _getCwmpVersionSupported(), // Attribute Value
-															               NULL);           // New Node Value
-	  
-	  // Add the 'FaultCode' tag and update its content
-
-	  snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", nRPCRet );
-
-    xmlAddNode(SoapMsg.pParser,     // XML Document
-               pRefFault,           // XML Parent Node
-						   FAULTCODE2,          // New Node TAG
-						   NULL,                // Attribute Name
-							NULL,                // Attribute Value
-							(char*)pTmpBuffer);  // New Node Value
-
-    xmlAddNode(SoapMsg.pParser,                  // XML Document
-               pRefFault,                        // XML Parent Node
-               FAULTSTRING2,                     // New Node TAG
-               NULL,                             // Attribute Name
-               NULL,                             // Attribute Value
-	            DM_ENG_getFaultString(nRPCRet) ); // New Node Value
-	  
-	  // ---------------------------------------------------------------------------
-	  // Count how many parameter there is in the parameter fault list
-	  // ---------------------------------------------------------------------------
-	  nNbParameterFault = DM_ENG_tablen( (void**)pFaults );
-	  DBG( "Number of parameter found in the list: %d ", nNbParameterFault );
-	  
-	  // ---------------------------------------------------------------------------	
-	  // Add each parameter to the list
-	  // ---------------------------------------------------------------------------
-	  // find the SetParameterValueFault tag
-	  // ---------------------------------------------------------------------------
-	  for ( nI=0 ; nI<nNbParameterFault ; nI++ ) {
-      // Add SETPARAMETERVALUEFAULT Element
-      GenericXmlNodePtr pRefParameterValueFault = xmlAddNode(SoapMsg.pParser,         // XML Document
-                                                             pRefFault,               // XML Parent Node
-						                                                 SETPARAMETERVALUEFAULT,  // New Node TAG
-										                                         NULL,                    // Attribute Name
-													                                   NULL,                    // Attribute Value
-															                               NULL);                   // New Node Value
-								 
-      // Add a Parameter Name
-      xmlAddNode(SoapMsg.pParser,                    // XML Document
-                 pRefParameterValueFault,            // XML Parent Node
-                 PARAM_PARAMETERNAME,                // New Node TAG
-                 NULL,                               // Attribute Name
-                 NULL,                               // Attribute Value
-                 (char*)pFaults[nI]->parameterName); // New Node Value
-				    
-    
-      // Add a FaultCode
-      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)pFaults[nI]->faultCode );
-      xmlAddNode(SoapMsg.pParser,          // XML Document
-                 pRefParameterValueFault,  // XML Parent Node
-                 FAULTCODE,                // New Node TAG
-                 NULL,                     // Attribute Name
-                 NULL,                     // Attribute Value
-                 pTmpBuffer);              // New Node Value
-				      
-      // Add a FaultString
-      xmlAddNode(SoapMsg.pParser,                  // XML Document
-                 pRefParameterValueFault,          // XML Parent Node
-                 FAULTSTRING,                      // New Node TAG
-                 NULL,                             // Attribute Name
-                 NULL,                             // Attribute Value
-                 (char*)pFaults[nI]->faultString); // New Node Value
-	  } // end for
-	  // ---------------------------------------------------------------------------
-	  // Remake the XML buffer
-	  // ---------------------------------------------------------------------------
-	  if ( SoapMsg.pRoot != NULL ) {
-      DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-	  }
-	  // ---------------------------------------------------------------------------
-	  // Then send it to DM_SendHttpMessage
-	  // ---------------------------------------------------------------------------
-	  if ( g_pBufferCpe != NULL )  {
-    // Send the HTTP message
-    if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-	    DBG( "SetParameterValues - Sending http message : OK" );
+    snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_PARAMETERLIST_ATTR_VAL2, nNbParameterValueStruct );
+  }
+  DM_SoapWriter_addAttribute( pWriter, DM_COM_ArrayTypeAttrName, pTmpBuffer );
+}
+
+/*
+* Private routine which writes one ParameterValueStruct of a GetParameterValuesResponse
+* Parameters: The writer of the message and the parameter
+*/
+static void
+_writeParameterValueStruct(DM_SoapWriter               * pWriter,
+                           DM_ENG_ParameterValueStruct * pParam)
+{
+  const char * xsdType = NULL;
+
+  DBG( "Param : %s = '%s' (type = %d)", (char*)pParam->parameterName, (char*)pParam->value, pParam->type );
+  DM_SoapWriter_startElement( pWriter, INFORM_PARAMETERVALUESTRUCT );
+  DM_SoapWriter_addElement( pWriter, INFORM_NAME, pParam->parameterName );
+  DM_SoapWriter_startElement( pWriter, INFORM_VALUE );
+  // Update the kind of type to the value content
+  xsdType = DM_GetXsdTypeName( pParam->type );
+  if ( xsdType != NULL ) {
+    DM_SoapWriter_addAttribute( pWriter, INFORM_VALUE_ATTR, xsdType );
+  }
+  // If the parameter is not affected to a value, the DM_ENGINE will replied NULL
+  // If so return an empty string to the ACS
+  DM_SoapWriter_addText( pWriter, ((pParam->value != NULL) ? pParam->value : _EMPTY) );
+  DM_SoapWriter_endElement( pWriter ); // Value
+  DM_SoapWriter_endElement( pWriter ); // ParameterValueStruct
+}
+
+/*
+* State of a GetParameterValuesResponse sent while it is written (see _readGpvResponse)
+*/
+typedef struct _GpvResponseStream
+{
+  char                         * soapId;
+  DM_ENG_ParameterValueStruct ** pResult;
+  int                            nbParameters;
+  int                            nextParameter; // -1 before the beginning of the message, nbParameters for its end
+  DM_SoapWriter                  writer;
+
+} __attribute((packed)) GpvResponseStream;
+
+/*
+* Private routine called by the HTTP client to get the next bytes of the GetParameterValuesResponse.
+* The ParameterValueStruct are written one at a time, only when the previous ones are consumed :
+* the writer never holds more than one HTTP chunk and one parameter.
+* return the number of bytes written in pBuffer, 0 at the end of the message, -1 on error
+*/
+static int
+_readGpvResponse(void   * pData,
+                 char   * pBuffer,
+                 size_t   size)
+{
+  GpvResponseStream * pStream = (GpvResponseStream *) pData;
+  DM_SoapWriter     * pWriter = &pStream->writer;
+
+  while ( (DM_SoapWriter_pendingLength( pWriter ) < size) && (pStream->nextParameter <= pStream->nbParameters) ) {
+    if ( pStream->nextParameter < 0 ) {
+      _startGetParameterValuesResponse( pWriter, pStream->soapId, pStream->nbParameters );
+    } else if ( pStream->nextParameter < pStream->nbParameters ) {
+      _writeParameterValueStruct( pWriter, pStream->pResult[pStream->nextParameter] );
     } else {
-	    EXEC_ERROR( "SetParameterValues - Sending http message : NOK" );
+      DM_SoapWriter_endElement( pWriter ); // ParameterList
+      DM_SoapWriter_endElement( pWriter ); // GetParameterValuesResponse
+      DM_SoapWriter_endElement( pWriter ); // Body
+      DM_SoapWriter_endElement( pWriter ); // Envelope
     }
-    
-    // Free the buffer
-    DM_FreeTMPXMLBufferCpe();
-    
-    nMainRet = DM_OK;
-	  }
-	  
-	  // ---------------------------------------------------------------------------
-	  // Free the array given by the DM_Engine
-	  // ---------------------------------------------------------------------------
-	  DM_ENG_deleteTabSetParameterValuesFault( pFaults );
+    pStream->nextParameter++;
   }
-	} else {
-  EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-	}
-	
-	// Free xml document
-	if(NULL != SoapMsg.pParser) {
-	  xmlDocumentFree(SoapMsg.pParser);
-	  SoapMsg.pParser = NULL; 
-	}
-	
-	return( nMainRet );
-} /* DM_SUB_SetParameterValues */
+
+  if ( pWriter->error ) {
+    EXEC_ERROR( "GetParameterValues - Problem with the XML/SOAP buffer!!" );
+    return -1;
+  }
+  return (int)DM_SoapWriter_read( pWriter, pBuffer, size );
+}
+
+/*
+* Private routine called by the HTTP client when the GetParameterValuesResponse must be sent again
+*/
+static int
+_rewindGpvResponse(void * pData)
+{
+  GpvResponseStream * pStream = (GpvResponseStream *) pData;
+
+  DM_SoapWriter_free( &pStream->writer );
+  pStream->nextParameter = -1;
+
+  return 0;
+}
+
+/*
+* Private routine called by the HTTP client once the GetParameterValuesResponse is sent
+*/
+static void
+_releaseGpvResponse(void * pData)
+{
+  GpvResponseStream * pStream = (GpvResponseStream *) pData;
+
+  DM_SoapWriter_free( &pStream->writer );
+  DM_ENG_deleteTabParameterValueStruct( pStream->pResult );
+  DM_ENG_FREE( pStream->soapId );
+  free( pStream );
+}
+
+/*
+* Private routine which sends a big GetParameterValuesResponse in chunks, written while they are sent.
+* The array of parameters is given to the HTTP client which frees it once the message is sent.
+* return DM_OK if the message has been handed to the HTTP client
+*/
+static DMRET
+_streamGetParameterValuesResponse(const char                   * pSoapId,
+                                  DM_ENG_ParameterValueStruct ** pResult,
+                                  int                            nNbParameterValueStruct)
+{
+  httpMessageStreamType msgStream;
+  GpvResponseStream   * pStream = (GpvResponseStream *) calloc( 1, sizeof(GpvResponseStream) );
+
+  pStream->soapId        = strdup( pSoapId );
+  pStream->pResult       = pResult;
+  pStream->nbParameters  = nNbParameterValueStruct;
+  pStream->nextParameter = -1;
+
+  msgStream.readFunction    = _readGpvResponse;
+  msgStream.rewindFunction  = _rewindGpvResponse;
+  msgStream.releaseFunction = _releaseGpvResponse;
+  msgStream.producerData    = pStream;
+
+  // pStream is released by the HTTP client, even on error
+  return ( DM_SendHttpMessageStream( &msgStream ) == DM_OK ? DM_OK : DM_ERR );
+}
 
 /**
  * @brief Call the DM_ENG_GetParameterValues function
@@ -3557,183 +4253,64 @@ DM_SUB_GetParameterValues(
   IN const char *pSoapId,
 	IN const char **pParameterName)
 {
-	int 	                 nRPCRet	  = DM_ENG_METHOD_NOT_SUPPORTED;
-	DMRET	                 nMainRet	  = DM_ERR;
-	DM_ENG_ParameterValueStruct	** pResult	  = NULL;
-	int                      nI        = 0;
-	int	                   nNbParameterValueStruct	= 1;
-	char    	             pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml             SoapMsg;
-	
-	memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));
-	
-	// Check parameters
-	if ( (pSoapId != NULL) && (pParameterName != NULL) )
-	{
-  // Initialize the SOAP data structure
-  DM_InitSoapMsgReceived( &SoapMsg );
-  
-  // Launching the RPC method from the DM_ENGINE
-  DBG( " GetParameterValues( DM_ENG_EntityType_ACS, pParameterName ) " );
-  nRPCRet = DM_ENG_GetParameterValues( DM_ENG_EntityType_ACS,
-                                       (char**)pParameterName,
-                                       &pResult );
-  
-  // Check the RPC's return code
-  if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ){
-	  DBG( "GetParameterValues : OK " );
-	  DBG( "Creating the SOAP Response for the ACS server." );
-	  // ---------------------------------------------------------------------------
-	  // Create the XML/SOAP response
-	  // ---------------------------------------------------------------------------
-    DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, true );
-	  
-	  // ---------------------------------------------------------------------------
-	  // Update the SOAP HEADER
-	  // ---------------------------------------------------------------------------
-	  DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-	  
-	  // ---------------------------------------------------------------------------
-	  // Add a SetParameterValueResponse tag
-	  // ---------------------------------------------------------------------------
-	  GenericXmlNodePtr pRefGetParameterValueResponse = xmlAddNode(SoapMsg.pParser,              // XML Document
-                                                                 SoapMsg.pBody,                // XML Parent Node
-                                                                 GETPARAMETERVALUESRESPONSE,   // Node Name
-								                                                 NULL,                         // Attribute Name
-														                                     NULL,                         // Attribute Value
-																		                             NULL);                        // Node Value
-																					     															     
-																					     
-																					     
-	  // ---------------------------------------------------------------------
-	  // Add a parameterList tag and sub-tag ParameterValueStruct
-	  // ---------------------------------------------------------------------------
-	  GenericXmlNodePtr pRefParamListTag = xmlAddNode(SoapMsg.pParser,              // XML Document
-                                                    pRefGetParameterValueResponse,// XML Parent Node
-                                                    PARAMETERINFOSTRUCT_LIST,     // Node Name
-								                                    NULL,                         // Attribute Name
-														                        NULL,                         // Attribute Value
-																		                NULL);                        // Node Value	  
-	  // ---------------------------------------------------------------------------
-	  // Count how many Eventstruct there is in the list
-	  // and update the attribute of the ParameterList tag
-	  // ---------------------------------------------------------------------------
-    nNbParameterValueStruct = DM_ENG_tablen( (void**)pResult );
- 
- 	  DBG( "Parameters found in the ParameterList : %d ", nNbParameterValueStruct );
- 	  if ( nNbParameterValueStruct<10 ) {
-     snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_PARAMETERLIST_ATTR_VAL1, nNbParameterValueStruct );
- 	  } else {
-     snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_PARAMETERLIST_ATTR_VAL2, nNbParameterValueStruct );
- 	  }
- 	  // --> is there some case where nNbParameterValueStruct may be bigger than 99 ?
- 	  //     if so may we update the mask from XX to XXX
- 	  DBG("ADD Node Attribut %s, %s", DM_COM_ArrayTypeAttrName, pTmpBuffer);
- 	  xmlAddNodeAttribut(pRefParamListTag, DM_COM_ArrayTypeAttrName, pTmpBuffer);  
-	  
-	  // ---------------------------------------------------------------------------
-	  // Add the ParameterValueStruct subtags into the ParameterList one
-	  // ---------------------------------------------------------------------------
-	  GenericXmlNodePtr pRefParamStruct       = NULL;
-	  //GenericXmlNodePtr currentChildNameNode  = NULL;
-	  GenericXmlNodePtr currentChildValueNode = NULL;
-	  
-	  for ( nI=0 ; nI<nNbParameterValueStruct ; nI++ )
-	  {
-    DBG( "Param.%d/%d : %s = '%s' (type = %d)", nI, nNbParameterValueStruct,
-	            (char*)pResult[nI]->parameterName,
-	            (char*)pResult[nI]->value,
-	            pResult[nI]->type );
-
-	    pRefParamStruct = xmlAddNode(SoapMsg.pParser, pRefParamListTag, INFORM_PARAMETERVALUESTRUCT, NULL, NULL, NULL);
-
-      /*currentChildNameNode =*/ xmlAddNode(SoapMsg.pParser, pRefParamStruct, INFORM_NAME, NULL, NULL, (char*)pResult[nI]->parameterName);    
-                    
-	    // ---------------------------------------------------------------------------
-	    // If the parameter is not affected to a value, the DM_ENGINE will replied NULL
-	    // If so return an empty string to the ACS
-	    // ---------------------------------------------------------------------------
-	    if(pResult[nI]->value != NULL) {
-		     currentChildValueNode = xmlAddNode(SoapMsg.pParser, pRefParamStruct, INFORM_VALUE, NULL, NULL, (char*)pResult[nI]->value);   
-	    } else {
-         currentChildValueNode = xmlAddNode(SoapMsg.pParser, pRefParamStruct, INFORM_VALUE, NULL, NULL, _EMPTY);   
-	    }
-	    
-	    // ---------------------------------------------------------------------------
-	    // Update the kind of type to the value content
-	    // ---------------------------------------------------------------------------
-	    switch ( pResult[nI]->type )
-	    {
-      case DM_ENG_ParameterType_INT:
-	      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_INT );         break;
-      case DM_ENG_ParameterType_UINT:
-	      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_UNSIGNEDINT ); break;
-      case DM_ENG_ParameterType_LONG:
-	      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_LONG );        break;
-      case DM_ENG_ParameterType_BOOLEAN:
-	      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_BOOLEAN );     break;
-      case DM_ENG_ParameterType_DATE:
-	      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_DATETIME );    break;
-      case DM_ENG_ParameterType_STRING:
-	      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_STRING );      break;
-      case DM_ENG_ParameterType_STATISTICS:
-      case DM_ENG_ParameterType_ANY:
-	      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_ANY );         break;
-      default:
-      {
-	      EXEC_ERROR( "Unknown type value for a parameter (%d) ",
-	             (int)pResult[nI]->type );
+  int                            nRPCRet  = DM_ENG_METHOD_NOT_SUPPORTED;
+  DMRET                          nMainRet = DM_ERR;
+  DM_ENG_ParameterValueStruct ** pResult  = NULL;
+  int                            nI       = 0;
+  int                            nNbParameterValueStruct = 0;
+  DM_SoapWriter                  writer;
+
+  // Check parameters
+  if ( (pSoapId != NULL) && (pParameterName != NULL) ) {
+    // Launching the RPC method from the DM_ENGINE
+    DBG( " GetParameterValues( DM_ENG_EntityType_ACS, pParameterName ) " );
+    nRPCRet = DM_ENG_GetParameterValues( DM_ENG_EntityType_ACS,
+                                         (char**)pParameterName,
+                                         &pResult );
+
+    // Check the RPC's return code
+    if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ) {
+      DBG( "GetParameterValues : OK " );
+      DBG( "Creating the SOAP Response for the ACS server." );
+
+      // Count how many ParameterValueStruct there is in the list
+      nNbParameterValueStruct = DM_ENG_tablen( (void**)pResult );
+      DBG( "Parameters found in the ParameterList : %d ", nNbParameterValueStruct );
+
+      if ( nNbParameterValueStruct > GPV_STREAMING_THRESHOLD ) {
+        // Big response : written while it is sent, the HTTP client frees pResult
+        if ( _streamGetParameterValuesResponse( pSoapId, pResult, nNbParameterValueStruct ) == DM_OK ) {
+          DBG( "GetParameterValues - Sending http message : OK" );
+        } else {
+          EXEC_ERROR( "GetParameterValues - Sending http message : NOK" );
+        }
+      } else {
+        _startGetParameterValuesResponse( &writer, pSoapId, nNbParameterValueStruct );
+
+        // Add the ParameterValueStruct subtags into the ParameterList one
+        for ( nI=0 ; nI<nNbParameterValueStruct ; nI++ ) {
+          _writeParameterValueStruct( &writer, pResult[nI] );
+        }
+        DM_SoapWriter_endElement( &writer ); // ParameterList
+        DM_SoapWriter_endElement( &writer ); // GetParameterValuesResponse
+
+        // Send the message to the ACS server
+        _sendSoapMessage( &writer, "GetParameterValues" );
+
+        // Free the array given by the DM_Engine
+        DM_ENG_deleteTabParameterValueStruct( pResult );
       }
-      break;
-	    }
-      xmlAddNodeAttribut(currentChildValueNode, INFORM_VALUE_ATTR, pTmpBuffer);
-	  }
-	  
-	  // ---------------------------------------------------------------------------
-	  // Remake the XML buffer then send it to the ACS server
-	  // ---------------------------------------------------------------------------
-	  if ( SoapMsg.pRoot != NULL ){
-    DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-    if ( g_pBufferCpe != NULL )
-    {
-	    
-	    // Send the HTTP message
-	    if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-        DBG( "GetParameterValues - Sending http message : OK" );
-	    } else {
-        EXEC_ERROR( "GetParameterValues - Sending http message : NOK" );
-	    }
-	    
-	    // Free the buffer
-	    DM_FreeTMPXMLBufferCpe();
-	    
-	    nMainRet = DM_OK;
+      nMainRet = DM_OK;
+    } else {
+      EXEC_ERROR( "GetParameterValues : NOK (%d) ", nRPCRet );
+      // Send a fault SOAP message to the ACS server (NOK)
+      DM_SoapFaultResponse( pSoapId, nRPCRet );
     }
-	  }
-	  
-	  // ---------------------------------------------------------------------------
-	  // Free the array given by the DM_Engine
-	  // ---------------------------------------------------------------------------
-	  DM_ENG_deleteTabParameterValueStruct( pResult );
-	  
-	  nMainRet = DM_OK;
   } else {
-	  EXEC_ERROR( "GetParameterValues : NOK (%d) ", nRPCRet );
-
-	  // Send a fault SOAP message to the ACS server (NOK)
-	  DM_SoapFaultResponse( pSoapId, nRPCRet );
+    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
   }
-	} else {
-  EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-	}
 
-	// Free xml document
-	if(NULL != SoapMsg.pParser) {
-	  xmlDocumentFree(SoapMsg.pParser);   
-	  SoapMsg.pParser = NULL;
-	}
-
-	return( nMainRet );
+  return( nMainRet );
 } /* DM_SUB_GetParameterValues */
 
 /**
@@ -3791,195 +4368,88 @@ DMRET
 DM_SUB_GetParameterAttributes(IN const char  * pSoapId,
 	                            IN const char ** pParameterName)
 {
-   DM_SoapXml                           SoapMsg;
-   DMRET                                nMainRet  = DM_ERR;
-   DM_ENG_ParameterAttributesStruct ** pResult   = NULL;
-   int                                  nRPCRet  = DM_ENG_METHOD_NOT_SUPPORTED;
-   int                                    nNbParameterValueStruct = 0;  
-   int                                  nNbAccessListString      = 0;
-   int                                  loopAccesList            = 0;
-   int                                  nI = 0;
-   char                                  pTmpBuffer[TMPBUFFER_SIZE];
-   
-         
-   // Memset to 0x00 the SoapMsg
-   memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));
-   
+  DMRET                               nMainRet = DM_ERR;
+  DM_ENG_ParameterAttributesStruct ** pResult  = NULL;
+  int                                 nRPCRet  = DM_ENG_METHOD_NOT_SUPPORTED;
+  int                                 nNbParameterValueStruct = 0;
+  int                                 nNbAccessListString     = 0;
+  int                                 loopAccesList           = 0;
+  int                                 nI = 0;
+  char                                pTmpBuffer[TMPBUFFER_SIZE];
+  DM_SoapWriter                       writer;
+
   if((NULL != pSoapId) || (NULL != pParameterName)) {
-    
-    // Initialize the SOAP data structure
-    DM_InitSoapMsgReceived( &SoapMsg );    
-    
     // Launching the RPC method from the DM_ENGINE
     DBG( " GetParameterValues( DM_ENG_EntityType_ACS, pParameterName ) " );
     nRPCRet = DM_ENG_GetParameterAttributes( DM_ENG_EntityType_ACS,
-                                              (char**)pParameterName,
-                                              &pResult );    
+                                             (char**)pParameterName,
+                                             &pResult );
 
     // Check the RPC's return code
-    if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ){  
+    if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ) {
       DBG( "GetParameterAttributes : OK " );
-      
       DBG( "Creating the SOAP Response for the ACS server." );
-      
-       // ---------------------------------------------------------------------------
-       // Create the XML/SOAP response
-       // ---------------------------------------------------------------------------
-      DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );	 
-      
-       // ---------------------------------------------------------------------------
-       // Update the SOAP HEADER
-       // ---------------------------------------------------------------------------
-       DM_AddSoapHeaderID( pSoapId, &SoapMsg );      
-      
-       // ---------------------------------------------------------------------------
-       // Add a SetParameterValueResponse tag
-       // ---------------------------------------------------------------------------
-       GenericXmlNodePtr pRefGetParameterAttributesResponse = xmlAddNode(SoapMsg.pParser,               // XML Document
-                                                                        SoapMsg.pBody,                  // XML Parent Node
-                                                                        GETPARAMETERATTRIBUTESRESPONSE, // Node Name
-                                                                        NULL,                           // Attribute Name
-                                                                        NULL,                           // Attribute Value
-                                                                        NULL);                          // Node Value
-                                                                                                                    
-                                                                    
-        // ---------------------------------------------------------------------
-       // Add a parameterList tag and sub-tag ParameterValueStruct
-       // ---------------------------------------------------------------------------
-      GenericXmlNodePtr pRefParamListTag = xmlAddNode(SoapMsg.pParser,                   // XML Document
-                                                      pRefGetParameterAttributesResponse,// XML Parent Node
-                                                      PARAMETERINFOSTRUCT_LIST,          // Node Name
-                                                      NULL,                              // Attribute Name
-                                                      NULL,                              // Attribute Value
-                                                      NULL);                             // Node Value                     
-       
-      // ---------------------------------------------------------------------------
-      // Count how many Eventstruct there is in the list
+      DM_StartSoapMessage( &writer, pSoapId, false );
+      DM_SoapWriter_startElement( &writer, GETPARAMETERATTRIBUTESRESPONSE );
+
+      // Count how many ParameterAttributeStruct there is in the list
       // and update the attribute of the ParameterList tag
-      // ---------------------------------------------------------------------------
       nNbParameterValueStruct = DM_ENG_tablen( (void**)pResult );
- 
       DBG( "Parameters found in the ParameterList : %d ", nNbParameterValueStruct );
+      DM_SoapWriter_startElement( &writer, PARAMETERINFOSTRUCT_LIST );
       if ( nNbParameterValueStruct<10 ) {
         snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_PARAMETERLIST_ATTRIBUTE_VAL1, nNbParameterValueStruct );
       } else {
         snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_PARAMETERLIST_ATTRIBUTE_VAL2, nNbParameterValueStruct );
       }
+      DM_SoapWriter_addAttribute( &writer, DM_COM_ArrayTypeAttrName, pTmpBuffer );
 
-      DBG("ADD Node Attribut %s, %s", DM_COM_ArrayTypeAttrName, pTmpBuffer);
-      xmlAddNodeAttribut(pRefParamListTag, DM_COM_ArrayTypeAttrName, pTmpBuffer);        
-      
-      // ---------------------------------------------------------------------------
-      // Add the ParameterValueStruct subtags into the ParameterList one
-      // ---------------------------------------------------------------------------
-      GenericXmlNodePtr pRefParamStruct              = NULL;
-      //GenericXmlNodePtr currentChildNameNode         = NULL;
-      //GenericXmlNodePtr currentChildNotificationNode = NULL;
-      GenericXmlNodePtr currentChildAccessListNode   = NULL;   
-      char              tmp[5];
-      
-      for ( nI=0 ; nI<nNbParameterValueStruct ; nI++ )
-      {
+      // Add the ParameterAttributeStruct subtags into the ParameterList one
+      for ( nI=0 ; nI<nNbParameterValueStruct ; nI++ ) {
         DBG( "Param.%d/%d : %s, Notification: %d, AccessList[0]: %s", nI,
-                                                                  nNbParameterValueStruct,
-                                                                         (char*)pResult[nI]->parameterName,
-                                                                               pResult[nI]->notification,
-                                                                                   ((NULL == pResult[nI]->accessList) ? "NONE" : (pResult[nI]->accessList)[0]));
-
-         pRefParamStruct = xmlAddNode(SoapMsg.pParser, pRefParamListTag, PARAMETERATTRIBUTESTRUCT, NULL, NULL, NULL);
-        
-         // Add the Name Node
-        /*currentChildNameNode =*/ xmlAddNode(SoapMsg.pParser,
-                                           pRefParamStruct,
-                                                PARAMETERNAME,
-                                                   NULL,
-                                                      NULL,
-                                                        (char*)pResult[nI]->parameterName);        
-
-         // Add the Notification Node
-        sprintf(tmp, "%d", pResult[nI]->notification);
-        /*currentChildNotificationNode =*/ xmlAddNode(SoapMsg.pParser,
-                                                   pRefParamStruct,
-                                                         PARAM_NOTIFICATION,
-                                                             NULL,
-                                                                NULL,
-                                                                  (char*)tmp); 
-
-        // Add the AccesList Node(s)   
-        currentChildAccessListNode = xmlAddNode(SoapMsg.pParser,
-                                                 pRefParamStruct,
-                                                       PARAM_ACCESSLIST,
-                                                           NULL,
-                                                              NULL,
-                                                                NULL);
-
-        // ---------------------------------------------------------------------------
+             nNbParameterValueStruct,
+             (char*)pResult[nI]->parameterName,
+             pResult[nI]->notification,
+             ((NULL == pResult[nI]->accessList) ? "NONE" : (pResult[nI]->accessList)[0]));
+        DM_SoapWriter_startElement( &writer, PARAMETERATTRIBUTESTRUCT );
+        DM_SoapWriter_addElement( &writer, PARAMETERNAME, pResult[nI]->parameterName );
+        snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", pResult[nI]->notification );
+        DM_SoapWriter_addElement( &writer, PARAM_NOTIFICATION, pTmpBuffer );
+
         // Count how many AccessList there is in the list
-        // ---------------------------------------------------------------------------
         nNbAccessListString = DM_ENG_tablen( (void**)pResult[nI]->accessList );
-
+        DM_SoapWriter_startElement( &writer, PARAM_ACCESSLIST );
         if ( nNbAccessListString < 10 ) {
           snprintf( pTmpBuffer, TMPBUFFER_SIZE, STRING_LIST_ATTR_VAL1, nNbAccessListString );
         } else {
           snprintf( pTmpBuffer, TMPBUFFER_SIZE, STRING_LIST_ATTR_VAL2, nNbAccessListString );
-        }         
-   
-        xmlAddNodeAttribut(currentChildAccessListNode, DM_COM_ArrayTypeAttrName, pTmpBuffer);
-      
-           for(loopAccesList = 0; loopAccesList < nNbAccessListString; loopAccesList++) {
-            xmlAddNode(SoapMsg.pParser,
-                     currentChildAccessListNode,
-                     PARAM_STRING,
-                     NULL,
-                     NULL,
-                     ((NULL == pResult[nI]->accessList[loopAccesList]) ? _EMPTY : pResult[nI]->accessList[loopAccesList]));
-           } // end for AccesList
-      } // end for ParameterValueStruct
-
-      // ---------------------------------------------------------------------------
-      // Remake the XML buffer then send it to the ACS server
-      // ---------------------------------------------------------------------------
-      if ( SoapMsg.pRoot != NULL ){
-        DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-        if ( g_pBufferCpe != NULL ) {
-       
-          // Send the HTTP message
-          if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-            DBG( "GetParameterAttributes - Sending http message : OK" );
-          } else {
-            EXEC_ERROR( "GetParameterAttributes - Sending http message : NOK" );
-          }
-       
-        // Free the buffer
-        DM_FreeTMPXMLBufferCpe();
-        nMainRet = DM_OK;
-      }
-     }
-     
-     // ---------------------------------------------------------------------------
-     // Free the array given by the DM_Engine
-     // ---------------------------------------------------------------------------
-     DM_ENG_deleteTabParameterAttributesStruct( pResult );
-     
-     nMainRet = DM_OK;      
-      
-     } else { //  end if Check the RPC's return code
-       // Send an error response message
-       DM_SoapFaultResponse( pSoapId, nRPCRet );
-     }
-       
-  }   else {
+        }
+        DM_SoapWriter_addAttribute( &writer, DM_COM_ArrayTypeAttrName, pTmpBuffer );
+        for(loopAccesList = 0; loopAccesList < nNbAccessListString; loopAccesList++) {
+          DM_SoapWriter_addElement( &writer, PARAM_STRING, pResult[nI]->accessList[loopAccesList] );
+        } // end for AccesList
+        DM_SoapWriter_endElement( &writer ); // AccessList
+        DM_SoapWriter_endElement( &writer ); // ParameterAttributeStruct
+      } // end for ParameterAttributeStruct
+      DM_SoapWriter_endElement( &writer ); // ParameterList
+      DM_SoapWriter_endElement( &writer ); // GetParameterAttributesResponse
+
+      // Send the message to the ACS server
+      _sendSoapMessage( &writer, "GetParameterAttributes" );
+
+      // Free the array given by the DM_Engine
+      DM_ENG_deleteTabParameterAttributesStruct( pResult );
+      nMainRet = DM_OK;
+    } else { //  end if Check the RPC's return code
+      // Send an error response message
+      DM_SoapFaultResponse( pSoapId, nRPCRet );
+    }
+  } else {
     // Invalid Parameters
     EXEC_ERROR( ERROR_INVALID_PARAMETERS );
   }
 
-   // Free xml document
-   if(NULL != SoapMsg.pParser) {
-     xmlDocumentFree(SoapMsg.pParser);   
-     SoapMsg.pParser = NULL;
-   }
-
-   return( nMainRet );
+  return( nMainRet );
 } /* DM_SUB_GetParameterAttributes */
 
 /**
@@ -3996,110 +4466,54 @@ DM_SUB_AddObject(IN const char *pSoapId,
    IN const char *pObjectName,
    IN const char *pParameterKey)
 {
-	DMRET		               nMainRet		      = DM_ERR;
-	int 		               nRPCRet		      = DM_ENG_METHOD_NOT_SUPPORTED;
-	unsigned int	         nInstanceNumber	= 0;
-	DM_ENG_ParameterStatus Status		        = DM_ENG_ParameterStatus_UNDEFINED;
-	char		               pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml	           SoapMsg;
-	
-	// Check parameters
-	if ( (pSoapId !=NULL) && (pObjectName != NULL) && (pParameterKey != NULL) )	{
-		// ---------------------------------------------------------------------------
-		// Initialize the SOAP data structure
-		// ---------------------------------------------------------------------------
-		DM_InitSoapMsgReceived( &SoapMsg );
-		
-		// ---------------------------------------------------------------------------
-		// Launching the RPC method from the DM_ENGINE
-		// ---------------------------------------------------------------------------
-		DBG( " AddObject( EntityType_ACS, pObjectName, pParameterKey, &InstanceNumber, &Status ) " );
-		nRPCRet = DM_ENG_AddObject( DM_ENG_EntityType_ACS,
-                               (char*)pObjectName,
-                               (char*)pParameterKey,
-                               &nInstanceNumber,
-                               &Status);
-		
-		// ---------------------------------------------------------------------------
-		// Check the RPC's return code
-		// ---------------------------------------------------------------------------
-		if ( nRPCRet == RPC_CPE_RETURN_CODE_OK ) {
-			DBG( "AddObject : OK " );
-			DBG( "Creating the response for the ACS server." );
-			
-			// ---------------------------------------------------------------------------
-			// Create the XML/SOAP response
-			// ---------------------------------------------------------------------------
-         DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
-
-			// ---------------------------------------------------------------------------
-			// Update the SOAP HEADER
-			// ---------------------------------------------------------------------------
-			DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-			
-			// ---------------------------------------------------------------------------
-			// Update the SOAP BODY - Add the AddObject tag
-			// ---------------------------------------------------------------------------
-      GenericXmlNodePtr pRefaddObject = xmlAddNode(SoapMsg.pParser,     // XML Document
-                                                   SoapMsg.pBody,       // XML Parent Node
-                                                   ADDOBJECTRESPONSE,   // Node Name
-							                                     NULL,                // Attribut Name
-												                           NULL,                // Attribut Value
-															                     NULL);               // Node Value	
-			
-			// ---------------------------------------------------------------------------
-			// Add the Instance number
-			// ---------------------------------------------------------------------------
-			DBG( " Instance = %d ", nInstanceNumber );
-			snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", nInstanceNumber );
-      xmlAddNode(SoapMsg.pParser,            // XML Document
-                 pRefaddObject,              // XML Parent Node
-                 ADDOBJECT_INSTANCENUMBER,   // Node Name
-			           NULL,                       // Attribut Name
-			           NULL,                       // Attribut Value
-			           pTmpBuffer);                // Node Value      
-      
-			
-			// ---------------------------------------------------------------------------
-			// Add the status
-			// ---------------------------------------------------------------------------
-			snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)Status );
-      xmlAddNode(SoapMsg.pParser,    // XML Document
-                 pRefaddObject,      // XML Parent Node
-                 ADDOBJECT_STATUS,   // Node Name
-			           NULL,               // Attribut Name
-			           NULL,               // Attribut Value
-			           pTmpBuffer);        // Node Value  		
-				   	
-			// ---------------------------------------------------------------------------
-			// Remake the XML buffer then send it to the ACS server
-			// ---------------------------------------------------------------------------
-			if ( SoapMsg.pRoot != NULL ) {
-				DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-				if ( g_pBufferCpe != NULL )	{
-					// Send the message using libCurl
-					if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-						DBG( "Sending http message : OK" );
-					} else {
-					  EXEC_ERROR( "Sending http message : NOK" );
-					}
-				}
-			}
-			
-			nMainRet = DM_OK;
-		} else {
-		  EXEC_ERROR( "AddObject : NOK (%d) ", nRPCRet );
-			
-			// Send a fault SOAP message to the ACS server (NOK)
-			DM_SoapFaultResponse( pSoapId, nRPCRet );
-		}
-	} else {
-	  EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-	}
-	
-	return( nMainRet );
+  DMRET                  nMainRet        = DM_ERR;
+  int                    nRPCRet         = DM_ENG_METHOD_NOT_SUPPORTED;
+  unsigned int           nInstanceNumber = 0;
+  DM_ENG_ParameterStatus Status          = DM_ENG_ParameterStatus_UNDEFINED;
+  char                   pTmpBuffer[TMPBUFFER_SIZE];
+  DM_SoapWriter          writer;
+
+  // Check parameters
+  if ( (pSoapId !=NULL) && (pObjectName != NULL) && (pParameterKey != NULL) ) {
+    // Launching the RPC method from the DM_ENGINE
+    DBG( " AddObject( EntityType_ACS, pObjectName, pParameterKey, &InstanceNumber, &Status ) " );
+    nRPCRet = DM_ENG_AddObject( DM_ENG_EntityType_ACS,
+                                (char*)pObjectName,
+                                (char*)pParameterKey,
+                                &nInstanceNumber,
+                                &Status);
+
+    // Check the RPC's return code
+    if ( nRPCRet == RPC_CPE_RETURN_CODE_OK ) {
+      DBG( "AddObject : OK " );
+      DBG( "Creating the response for the ACS server." );
+      DM_StartSoapMessage( &writer, pSoapId, false );
+      DM_SoapWriter_startElement( &writer, ADDOBJECTRESPONSE );
+
+      // Add the Instance number
+      DBG( " Instance = %d ", nInstanceNumber );
+      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", nInstanceNumber );
+      DM_SoapWriter_addElement( &writer, ADDOBJECT_INSTANCENUMBER, pTmpBuffer );
+
+      // Add the status
+      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)Status );
+      DM_SoapWriter_addElement( &writer, ADDOBJECT_STATUS, pTmpBuffer );
+      DM_SoapWriter_endElement( &writer );
+
+      // Send the message to the ACS server
+      _sendSoapMessage( &writer, "AddObject" );
 
+      nMainRet = DM_OK;
+    } else {
+      EXEC_ERROR( "AddObject : NOK (%d) ", nRPCRet );
+      // Send a fault SOAP message to the ACS server (NOK)
+      DM_SoapFaultResponse( pSoapId, nRPCRet );
+    }
+  } else {
+    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+  }
 
+  return( nMainRet );
 } /* DM_SUB_AddObject */
 
 /**
@@ -4116,102 +4530,47 @@ DM_SUB_DeleteObject(IN const char *pSoapId,
       IN const char *pObjectName,
       IN const char *pParameterKey)
 {
-	DMRET			                nMainRet	      = DM_ERR;
-	int 			                nRPCRet		      = DM_ENG_METHOD_NOT_SUPPORTED;
-	char			                pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml		            SoapMsg;
-	DM_ENG_ParameterStatus		Status;
-	
-	// Check parameters
-	if ( (pSoapId != NULL) && (pObjectName != NULL) && (pParameterKey != NULL) ){
-		// ---------------------------------------------------------------------------
-		// Initialize the SOAP data structure
-		// ---------------------------------------------------------------------------
-		DM_InitSoapMsgReceived( &SoapMsg );
-		
-		// ---------------------------------------------------------------------------
-		// Launching the RPC method from the DM_ENGINE
-		// ---------------------------------------------------------------------------
-		DBG( " DeleteObject( EntityType_ACS, pObjectName, pParameterKey, &Status ) " );
-		nRPCRet = DM_ENG_DeleteObject( DM_ENG_EntityType_ACS,
-					                        (char*)pObjectName,
-					                        (char*)pParameterKey,
-					                        &Status );
-		
-		// ---------------------------------------------------------------------------
-		// Check the RPC's return code
-		// ---------------------------------------------------------------------------
-		if ( nRPCRet == RPC_CPE_RETURN_CODE_OK ){
-			DBG( "DeleteObject : OK " );
-			DBG( "Creating the response for the ACS server." );
-			
-			// ---------------------------------------------------------------------------
-			// Create the XML/SOAP response
-			// ---------------------------------------------------------------------------
-         DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
-
-			// ---------------------------------------------------------------------------
-			// Update the SOAP HEADER
-			// ---------------------------------------------------------------------------
-			DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-			
-			// ---------------------------------------------------------------------------
-			// Update the SOAP BODY
-			// ---------------------------------------------------------------------------
-			// Add the DeleteObject tag
-			// ---------------------------------------------------------------------------
-			// scew_element *pRefDeleteObject = scew_element_add( SoapMsg.pBody, DELETEOBJECTRESPONSE );
-      GenericXmlNodePtr pRefDeleteObject = xmlAddNode(SoapMsg.pParser,        // XML Document
-                                                      SoapMsg.pBody,          // XML Parent Node
-                                                      DELETEOBJECTRESPONSE,   // Node Name
-							                                        NULL,                   // Attribut Name
-												                              NULL,                   // Attribut Value
-																                      NULL);                  // Node Value		
-																		      		
-			// ---------------------------------------------------------------------------
-			// Add the status
-			// ---------------------------------------------------------------------------
-			snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)Status );
-			
-      xmlAddNode(SoapMsg.pParser,       // XML Document
-                 pRefDeleteObject,      // XML Parent Node
-                 DELETEOBJECT_STATUS,   // Node Name
-			           NULL,                  // Attribut Name
-			           NULL,                  // Attribut Value
-			           pTmpBuffer);           // Node Value  			
-			
-			// ---------------------------------------------------------------------------
-			// Remake the XML buffer
-			// ---------------------------------------------------------------------------
-			if ( SoapMsg.pRoot != NULL ) {
-				DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-			}
-			
-			// ---------------------------------------------------------------------------
-			// Then send it to DM_SendHttpMessage
-			// ---------------------------------------------------------------------------
-			if ( g_pBufferCpe != NULL )	{
-				if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-					DBG( "Sending http message : OK" );
-				} else {
-				  EXEC_ERROR( "Sending http message : NOK" );
-				}
+  DMRET                  nMainRet = DM_ERR;
+  int                    nRPCRet  = DM_ENG_METHOD_NOT_SUPPORTED;
+  char                   pTmpBuffer[TMPBUFFER_SIZE];
+  DM_SoapWriter          writer;
+  DM_ENG_ParameterStatus Status;
 
-			}
+  // Check parameters
+  if ( (pSoapId != NULL) && (pObjectName != NULL) && (pParameterKey != NULL) ) {
+    // Launching the RPC method from the DM_ENGINE
+    DBG( " DeleteObject( EntityType_ACS, pObjectName, pParameterKey, &Status ) " );
+    nRPCRet = DM_ENG_DeleteObject( DM_ENG_EntityType_ACS,
+                                   (char*)pObjectName,
+                                   (char*)pParameterKey,
+                                   &Status );
 
-			nMainRet = DM_OK;
-		} else {
-		  EXEC_ERROR( "DeleteObject : NOK (%d) ", nRPCRet );
-			
-			// Send a fault SOAP message to the ACS server (NOK)
-			DM_SoapFaultResponse( pSoapId, nRPCRet );
-		}
-	} else {
-	  EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-	}
-	
-	return( nMainRet );
-	
+    // Check the RPC's return code
+    if ( nRPCRet == RPC_CPE_RETURN_CODE_OK ) {
+      DBG( "DeleteObject : OK " );
+      DBG( "Creating the response for the ACS server." );
+      DM_StartSoapMessage( &writer, pSoapId, false );
+
+      // Add the DeleteObject tag with the status
+      DM_SoapWriter_startElement( &writer, DELETEOBJECTRESPONSE );
+      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)Status );
+      DM_SoapWriter_addElement( &writer, DELETEOBJECT_STATUS, pTmpBuffer );
+      DM_SoapWriter_endElement( &writer );
+
+      // Send the message to the ACS server
+      _sendSoapMessage( &writer, "DeleteObject" );
+
+      nMainRet = DM_OK;
+    } else {
+      EXEC_ERROR( "DeleteObject : NOK (%d) ", nRPCRet );
+      // Send a fault SOAP message to the ACS server (NOK)
+      DM_SoapFaultResponse( pSoapId, nRPCRet );
+    }
+  } else {
+    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+  }
+
+  return( nMainRet );
 } /* DM_SUB_DeleteObject */
 
 /**
@@ -4272,20 +4631,13 @@ DM_SUB_Download(IN const char         *pSoapId,
 	DMRET	               nMainRet	 	      = DM_ERR;
 	DM_ENG_TransferResultStruct * pResult	= NULL;
 	char    	           pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml           SoapMsg;
-	
-	memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));
+	DM_SoapWriter        writer;
 	
 	// Check parameters
 	if ( (pSoapId     != NULL) &&
 	     (pFileType   != NULL) &&
 	     (pUrl        != NULL) && 
 	     (pCommandKey != NULL) ){
-  // ---------------------------------------------------------------------------
-  // Initialize the SOAP data structure
-  // ---------------------------------------------------------------------------
-  DM_InitSoapMsgReceived( &SoapMsg );
-  
   // ---------------------------------------------------------------------------
   // Launching the RPC method from the DM_ENGINE
   // ---------------------------------------------------------------------------
@@ -4337,115 +4689,40 @@ DM_SUB_Download(IN const char         *pSoapId,
   // ---------------------------------------------------------------------------
   // Check the RPC's return code
   // ---------------------------------------------------------------------------
-  if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ){
-	  DBG( "Download : OK " );
-	  DBG( "Creating the response for the ACS server." );
-	  
-	  // ---------------------------------------------------------------------------
-	  // Create the XML/SOAP response
-	  // ---------------------------------------------------------------------------
-    DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
-	  
-	  // ---------------------------------------------------------------------------
-	  // Update the SOAP HEADER
-	  // ---------------------------------------------------------------------------
-	  DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-	  
-	  // ---------------------------------------------------------------------------
-	  // Update the SOAP BODY and add the DownloadResponse tag
-	  // ---------------------------------------------------------------------------
-    GenericXmlNodePtr pRefDownloadResponse = xmlAddNode(SoapMsg.pParser,     // XML Document
-                                                        SoapMsg.pBody,       // XML Parent Node
-                                                        DOWNLOADRESPONSE,    // Node Name
-							                                          NULL,                // Attribut Name
-												                                NULL,                // Attribut Value
-																                        NULL);               // Node Value
-	  
-	  // ---------------------------------------------------------------------------
-	  // Add the status
-	  // ---------------------------------------------------------------------------
-	  DBG( " Status of the download = %d ", (int)pResult->status );
-	  snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)pResult->status );
-
-      xmlAddNode(SoapMsg.pParser,            // XML Document
-                 pRefDownloadResponse,       // XML Parent Node
-                 DOWNLOADRESPONSE_STATUS,    // Node Name
-			           NULL,                       // Attribut Name
-			           NULL,                       // Attribut Value
-			           pTmpBuffer);                // Node Value
-	  
-	  // ---------------------------------------------------------------------------
-	  // Add the start time if defined
-	  // ---------------------------------------------------------------------------
-	  if ( (int)pResult->status == 0 ) {
+  if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ) {
+    DBG( "Download : OK " );
+    DBG( "Creating the response for the ACS server." );
+    DM_StartSoapMessage( &writer, pSoapId, false );
+    DM_SoapWriter_startElement( &writer, DOWNLOADRESPONSE );
+
+    // Add the status
+    DBG( " Status of the download = %d ", (int)pResult->status );
+    snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)pResult->status );
+    DM_SoapWriter_addElement( &writer, DOWNLOADRESPONSE_STATUS, pTmpBuffer );
+
+    // Add the start and complete times if defined
+    if ( (int)pResult->status == 0 ) {
       char* sTime = DM_ENG_dateTimeToString(pResult->startTime);
-      DBG( "Start time = %s (WELL DEFINED) ", pTmpBuffer );
-      xmlAddNode(SoapMsg.pParser,            // XML Document
-                 pRefDownloadResponse,       // XML Parent Node
-                 DOWNLOADRESPONSE_STARTTIME, // Node Name
-			           NULL,                    // Attribut Name
-			           NULL,                    // Attribut Value
-			           sTime);                  // Node Value
+      DBG( "Start time = %s (WELL DEFINED) ", sTime );
+      DM_SoapWriter_addElement( &writer, DOWNLOADRESPONSE_STARTTIME, sTime );
       free(sTime);
-
-	  } else {
-      DBG( "Start time (UNDEFINED) " );
-      xmlAddNode(SoapMsg.pParser,            // XML Document
-                 pRefDownloadResponse,       // XML Parent Node
-                 DOWNLOADRESPONSE_STARTTIME, // Node Name
-			           NULL,                       // Attribut Name
-			           NULL,                       // Attribut Value
-			           UNDEFINED_UTC_DATETIME);    // Node Value
-	  }
-
-	  // ---------------------------------------------------------------------------
-	  // Add the Complete time if defined
-	  // ---------------------------------------------------------------------------
-	  if ( (int)pResult->status == 0 ) {
-      char* sTime = DM_ENG_dateTimeToString(pResult->completeTime);
-      DBG( "Complete time = %s (WELL DEFINED) ", pTmpBuffer );
-      xmlAddNode(SoapMsg.pParser,               // XML Document
-                 pRefDownloadResponse,          // XML Parent Node
-                 DOWNLOADRESPONSE_COMPLETETIME, // Node Name
-			           NULL,                       // Attribut Name
-			           NULL,                       // Attribut Value
-			           sTime);                     // Node Value  
+      sTime = DM_ENG_dateTimeToString(pResult->completeTime);
+      DBG( "Complete time = %s (WELL DEFINED) ", sTime );
+      DM_SoapWriter_addElement( &writer, DOWNLOADRESPONSE_COMPLETETIME, sTime );
       free(sTime);
+    } else {
+      DBG( "Start and complete times (UNDEFINED) " );
+      DM_SoapWriter_addElement( &writer, DOWNLOADRESPONSE_STARTTIME,    UNDEFINED_UTC_DATETIME );
+      DM_SoapWriter_addElement( &writer, DOWNLOADRESPONSE_COMPLETETIME, UNDEFINED_UTC_DATETIME );
+    }
+    DM_SoapWriter_endElement( &writer );
 
-	  } else {
-      DBG( "Complete time (UNDEFINED) " );
-      xmlAddNode(SoapMsg.pParser,               // XML Document
-                 pRefDownloadResponse,          // XML Parent Node
-                 DOWNLOADRESPONSE_COMPLETETIME, // Node Name
-			           NULL,                          // Attribut Name
-			           NULL,                          // Attribut Value
-			           UNDEFINED_UTC_DATETIME);       // Node Value  
-	  }
-	  
-	  // ---------------------------------------------------------------------------
-	  // Remake the XML buffer then send it to DM_SendHttpMessage
-	  // ---------------------------------------------------------------------------
-	  if ( SoapMsg.pRoot != NULL )
-	  {
-    DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-    if ( g_pBufferCpe != NULL )
-    {
-      // Send the HTTP message
-	    if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-      DBG( "Download - Sending http message : OK" );
-	    } else {
-      EXEC_ERROR( "Download - Sending http message : NOK" );
-	    }
+    // Send the message to the ACS server
+    _sendSoapMessage( &writer, "Download" );
 
-    }
-	  }
-	  
-	  // ---------------------------------------------------------------------------
-	  // Free the array given by the DM_Engine
-	  // ---------------------------------------------------------------------------
-	  DM_ENG_deleteTransferResultStruct( pResult );
-	  
-	  nMainRet = DM_OK;
+    // Free the array given by the DM_Engine
+    DM_ENG_deleteTransferResultStruct( pResult );
+    nMainRet = DM_OK;
   } else if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult == NULL) ){
       WARN("Download OK but pResult is NULL");
       DM_SoapFaultResponse( pSoapId, DM_ENG_INTERNAL_ERROR );
@@ -4459,12 +4736,6 @@ DM_SUB_Download(IN const char         *pSoapId,
   EXEC_ERROR( ERROR_INVALID_PARAMETERS );
 	}
 	
-  // Free xml document
-	if(NULL != SoapMsg.pParser) {
-	  xmlDocumentFree(SoapMsg.pParser);
-	  SoapMsg.pParser = NULL;
-	}
-	
 	return( nMainRet );
 } /* DM_SUB_Download */
 
@@ -4522,20 +4793,13 @@ DM_SUB_Upload(IN const char   *pSoapId,
 	DMRET	               nMainRet	 	      = DM_ERR;
 	DM_ENG_TransferResultStruct * pResult	= NULL;
 	char    	           pTmpBuffer[TMPBUFFER_SIZE];
-	DM_SoapXml           SoapMsg;
-	
-	memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));
+	DM_SoapWriter        writer;
 	
 	// Check parameters
 	if ( (pSoapId     != NULL) &&
 	     (pFileType   != NULL) &&
 	     (pUrl        != NULL) && 
 	     (pCommandKey != NULL) ){
-    // ---------------------------------------------------------------------------
-    // Initialize the SOAP data structure
-    // ---------------------------------------------------------------------------
-    DM_InitSoapMsgReceived( &SoapMsg );
-  
     // ---------------------------------------------------------------------------
     // Launching the RPC method from the DM_ENGINE
     // ---------------------------------------------------------------------------
@@ -4559,112 +4823,40 @@ DM_SUB_Upload(IN const char   *pSoapId,
     // ---------------------------------------------------------------------------
     // Check the RPC's return code
     // ---------------------------------------------------------------------------
-    if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ){
-	    DBG( "Upload : OK " );
-	    DBG( "Creating the response for the ACS server." );
-	  
-	    // ---------------------------------------------------------------------------
-	    // Create the XML/SOAP response
-	    // ---------------------------------------------------------------------------
-      DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
-	  
-	    // ---------------------------------------------------------------------------
-	    // Update the SOAP HEADER
-	    // ---------------------------------------------------------------------------
-	    DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-	  
-	    // ---------------------------------------------------------------------------
-	    // Update the SOAP BODY and add the UploadResponse tag
-	    // ---------------------------------------------------------------------------
-      GenericXmlNodePtr pRefUploadResponse = xmlAddNode(SoapMsg.pParser, // XML Document
-                                                        SoapMsg.pBody,   // XML Parent Node
-                                                        UPLOADRESPONSE,  // Node Name
-					  		                                        NULL,            // Attribut Name
-						     					                              NULL,            // Attribut Value
-								  								                      NULL);           // Node Value
-	  
-	    // ---------------------------------------------------------------------------
-	    // Add the status
-	    // ---------------------------------------------------------------------------
-	    DBG( " Status of the upload = %d ", (int)pResult->status );
-	    snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)pResult->status );
-
-      xmlAddNode(SoapMsg.pParser,         // XML Document
-                 pRefUploadResponse,      // XML Parent Node
-                 UPLOADRESPONSE_STATUS,   // Node Name
-			           NULL,                    // Attribut Name
-			           NULL,                    // Attribut Value
-			           pTmpBuffer);             // Node Value
-	  
-	    // ---------------------------------------------------------------------------
-	    // Add the start time if defined
-	    // ---------------------------------------------------------------------------
-	    if ( (int)pResult->status == 0 ) {
+    if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult != NULL) ) {
+      DBG( "Upload : OK " );
+      DBG( "Creating the response for the ACS server." );
+      DM_StartSoapMessage( &writer, pSoapId, false );
+      DM_SoapWriter_startElement( &writer, UPLOADRESPONSE );
+
+      // Add the status
+      DBG( " Status of the upload = %d ", (int)pResult->status );
+      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", (int)pResult->status );
+      DM_SoapWriter_addElement( &writer, UPLOADRESPONSE_STATUS, pTmpBuffer );
+
+      // Add the start and complete times if defined
+      if ( (int)pResult->status == 0 ) {
         char* sTime = DM_ENG_dateTimeToString(pResult->startTime);
-        DBG( "Start time = %s (WELL DEFINED) ", pTmpBuffer );
-        xmlAddNode(SoapMsg.pParser,            // XML Document
-                   pRefUploadResponse,         // XML Parent Node
-                   UPLOADRESPONSE_STARTTIME,   // Node Name
-			             NULL,                       // Attribut Name
-			             NULL,                       // Attribut Value
-			             sTime);                     // Node Value
+        DBG( "Start time = %s (WELL DEFINED) ", sTime );
+        DM_SoapWriter_addElement( &writer, UPLOADRESPONSE_STARTTIME, sTime );
         free(sTime);
-
-	    } else {
-        DBG( "Start time (UNDEFINED) " );
-        xmlAddNode(SoapMsg.pParser,            // XML Document
-                   pRefUploadResponse,         // XML Parent Node
-                   UPLOADRESPONSE_STARTTIME,   // Node Name
-			             NULL,                       // Attribut Name
-			             NULL,                       // Attribut Value
-			             UNDEFINED_UTC_DATETIME);    // Node Value
-	    }
-
-	    // ---------------------------------------------------------------------------
-	    // Add the Complete time if defined
-	    // ---------------------------------------------------------------------------
-	    if ( (int)pResult->status == 0 ) {
-        char* sTime = DM_ENG_dateTimeToString(pResult->completeTime);
-        DBG( "Complete time = %s (WELL DEFINED) ", pTmpBuffer );
-        xmlAddNode(SoapMsg.pParser,             // XML Document
-                   pRefUploadResponse,          // XML Parent Node
-                   UPLOADRESPONSE_COMPLETETIME, // Node Name
-			             NULL,                        // Attribut Name
-			             NULL,                        // Attribut Value
-			             sTime);                      // Node Value  
+        sTime = DM_ENG_dateTimeToString(pResult->completeTime);
+        DBG( "Complete time = %s (WELL DEFINED) ", sTime );
+        DM_SoapWriter_addElement( &writer, UPLOADRESPONSE_COMPLETETIME, sTime );
         free(sTime);
+      } else {
+        DBG( "Start and complete times (UNDEFINED) " );
+        DM_SoapWriter_addElement( &writer, UPLOADRESPONSE_STARTTIME,    UNDEFINED_UTC_DATETIME );
+        DM_SoapWriter_addElement( &writer, UPLOADRESPONSE_COMPLETETIME, UNDEFINED_UTC_DATETIME );
+      }
+      DM_SoapWriter_endElement( &writer );
 
-	    } else {
-        DBG( "Complete time (UNDEFINED) " );
-        xmlAddNode(SoapMsg.pParser,             // XML Document
-                   pRefUploadResponse,          // XML Parent Node
-                   UPLOADRESPONSE_COMPLETETIME, // Node Name
-			             NULL,                        // Attribut Name
-			             NULL,                        // Attribut Value
-			             UNDEFINED_UTC_DATETIME);     // Node Value  
-	    }
-	  
-	    // ---------------------------------------------------------------------------
-	    // Remake the XML buffer then send it to DM_SendHttpMessage
-	    // ---------------------------------------------------------------------------
-	    if ( SoapMsg.pRoot != NULL ) {
-        DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-        if ( g_pBufferCpe != NULL ) {
-          // Send the HTTP message
-	        if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-            DBG( "Upload - Sending http message : OK" );
-	        } else {
-            EXEC_ERROR( "Upload - Sending http message : NOK" );
-	        }
-        }
-	    }
-	  
-	    // ---------------------------------------------------------------------------
-	    // Free the array given by the DM_Engine
-	    // ---------------------------------------------------------------------------
-	    DM_ENG_deleteTransferResultStruct( pResult );
-	  
-	    nMainRet = DM_OK;
+      // Send the message to the ACS server
+      _sendSoapMessage( &writer, "Upload" );
+
+      // Free the array given by the DM_Engine
+      DM_ENG_deleteTransferResultStruct( pResult );
+      nMainRet = DM_OK;
     } else if ( (nRPCRet == RPC_CPE_RETURN_CODE_OK) && (pResult == NULL) ){
       WARN("Upload OK but pResult is NULL");
       DM_SoapFaultResponse( pSoapId, DM_ENG_INTERNAL_ERROR );
@@ -4677,12 +4869,6 @@ DM_SUB_Upload(IN const char   *pSoapId,
     EXEC_ERROR( ERROR_INVALID_PARAMETERS );
 	}
 	
-  // Free xml document
-	if(NULL != SoapMsg.pParser) {
-	  xmlDocumentFree(SoapMsg.pParser);
-	  SoapMsg.pParser = NULL;
-	}
-	
 	return( nMainRet );
 } /* DM_SUB_Upload */
 
@@ -4697,153 +4883,57 @@ DM_SUB_Upload(IN const char   *pSoapId,
 DMRET 
 DM_SUB_GetAllQueuedTransferts(IN const char *pSoapId)
 {
-  int rc;
+  int                                rc;
   DM_ENG_AllQueuedTransferStruct  ** pResult = NULL;
-  DM_SoapXml           SoapMsg;
-	int nNbParameterValueStruct = 0;
-	int nI;
-	char * tmpStr = NULL;
-	   
+  DM_SoapWriter                      writer;
+  int                                nNbParameterValueStruct = 0;
+  int                                nI;
+  char                             * tmpStr = NULL;
+
   DBG("DM_SUB_GetAllQueuedTransferts - Begin");
-  
+
   rc = DM_ENG_GetAllQueuedTransfers(DM_ENG_EntityType_ACS, &pResult);
-  
+
   DBG("DM_ENG_GetAllQueuedTransfers - rc = %d", rc);
-  
+
   if(0 == rc) {
     // Perform the response
-    
-	    // ---------------------------------------------------------------------------
-	    // Create the XML/SOAP response
-	    // ---------------------------------------------------------------------------
-	    DM_InitSoapMsgReceived(&SoapMsg);
-      DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
-	  
-	    // ---------------------------------------------------------------------------
-	    // Update the SOAP HEADER
-	    // ---------------------------------------------------------------------------
-	    DM_AddSoapHeaderID( pSoapId, &SoapMsg );
-	    
-	    // ---------------------------------------------------------------------------
-	    // Update the SOAP BODY and add the GETALLQUEUEDTRANSFERTSRESPONSE tag
-	    // ---------------------------------------------------------------------------
-      GenericXmlNodePtr pRefGetAllTransfertsResponse = xmlAddNode(SoapMsg.pParser,                 // XML Document
-                                                                  SoapMsg.pBody,                   // XML Parent Node
-                                                                  GETALLQUEUEDTRANSFERTSRESPONSE,  // Node Name
-					  		                                                  NULL,                            // Attribut Name
-						     					                                        NULL,                            // Attribut Value
-								  								                                NULL);                           // Node Value		    
-	    // ---------------------------------------------------------------------------
-	    // Update the SOAP BODY and add the PARAM_TRANSFER_LIST tag
-	    // ---------------------------------------------------------------------------
-      GenericXmlNodePtr pRefTransferListResponse = xmlAddNode(SoapMsg.pParser,         // XML Document
-                                                        pRefGetAllTransfertsResponse,  // XML Parent Node
-                                                        PARAM_TRANSFER_LIST,           // Node Name
-					  		                                        NULL,                          // Attribut Name
-						     					                              NULL,                          // Attribut Value
-								  								                      NULL);                         // Node Value
-      // ---------------------------------------------------------------------------
-      // Count how many Eventstruct there is in the list
-      // and update the attribute of the ParameterList tag
-      // ---------------------------------------------------------------------------																		      
-      nNbParameterValueStruct = DM_ENG_tablen( (void**)pResult );
+    DM_StartSoapMessage( &writer, pSoapId, false );
+    DM_SoapWriter_startElement( &writer, GETALLQUEUEDTRANSFERTSRESPONSE );
+    DM_SoapWriter_startElement( &writer, PARAM_TRANSFER_LIST );
 
-																		      																		      
-      for ( nI=0 ; nI<nNbParameterValueStruct ; nI++ ) {
-     
-        // Add a response structure AllQueuedTransferStruct
-        GenericXmlNodePtr pRefAllQueuedTransferStructResponse = xmlAddNode(SoapMsg.pParser,               // XML Document
-                                                                         pRefTransferListResponse,      // XML Parent Node
-                                                                         GETALLQUEUEDTRANSFERSTRUCT,    // Node Name
-					  		                                                         NULL,                          // Attribut Name
-						     					                                               NULL,                          // Attribut Value
-								  								                                       NULL);                         // Node Value       
-     
-         // Add the CommandKey
-         xmlAddNode(SoapMsg.pParser,                      // XML Document
-                    pRefAllQueuedTransferStructResponse,  // XML Parent Node
-                    GETALLQUEUEDTRANSFER_COMMANDKEY,      // Node Name
-					  		    NULL,                                 // Attribut Name
-						     		NULL,                                 // Attribut Value
-								  	pResult[nI]->commandKey);      // Node Value
-									
-         // Add the state
-	       tmpStr = DM_ENG_intToString(pResult[nI]->state);
-         xmlAddNode(SoapMsg.pParser,                      // XML Document
-                    pRefAllQueuedTransferStructResponse,  // XML Parent Node
-                    GETALLQUEUEDTRANSFER_STATE,           // Node Name
-					  		    NULL,                                 // Attribut Name
-						     		NULL,                                 // Attribut Value
-								  	tmpStr); // Node Value
-				DM_ENG_FREE(tmpStr);
-													       
-         // Add the IsDownload
-	       tmpStr = DM_ENG_intToString(pResult[nI]->isDownload);
-         xmlAddNode(SoapMsg.pParser,                            // XML Document
-                    pRefAllQueuedTransferStructResponse,        // XML Parent Node
-                    GETALLQUEUEDTRANSFER_ISDOWNLOAD,            // Node Name
-					  		    NULL,                                       // Attribut Name
-						     		NULL,                                       // Attribut Value
-								  	tmpStr);                                    // Node Value
-				 DM_ENG_FREE(tmpStr);
-					       
-         // Add the FileType
-         xmlAddNode(SoapMsg.pParser,                         // XML Document
-                    pRefAllQueuedTransferStructResponse,     // XML Parent Node
-                    GETALLQUEUEDTRANSFER_FILETYPE,           // Node Name
-					  		    NULL,                                    // Attribut Name
-						     		NULL,                                    // Attribut Value
-								  	pResult[nI]->fileType);                  // Node Value
-					          
-         // Add the FileSize
-	       tmpStr = DM_ENG_intToString(pResult[nI]->fileSize);
-         xmlAddNode(SoapMsg.pParser,                            // XML Document
-                    pRefAllQueuedTransferStructResponse,        // XML Parent Node
-                    GETALLQUEUEDTRANSFER_FILESIZE,              // Node Name
-					  		    NULL,                                       // Attribut Name
-						     		NULL,                                       // Attribut Value
-								  	DM_ENG_intToString(pResult[nI]->fileSize)); // Node Value
-				 DM_ENG_FREE(tmpStr);
-					           
-         // Add the TargetFileName (Set an empty string)
-         xmlAddNode(SoapMsg.pParser,                         // XML Document
-                    pRefAllQueuedTransferStructResponse,     // XML Parent Node
-                    GETALLQUEUEDTRANSFER_TARGETFILENAME,     // Node Name
-					  		    NULL,                                    // Attribut Name
-						     		NULL,                                    // Attribut Value
-								  	_EMPTY);                                     // Node Value
-		 }	// End for												      
-					
-																		      
-	  // ---------------------------------------------------------------------------
-	  // Remake the XML buffer then send it to DM_SendHttpMessage
-	  // ---------------------------------------------------------------------------
-	    if ( SoapMsg.pRoot != NULL ) {
-        DM_RemakeXMLBufferCpe( SoapMsg.pRoot );
-        if ( g_pBufferCpe != NULL ) {
-          // Send the HTTP message
-	        if ( DM_SendHttpMessage( g_pBufferCpe ) == DM_OK ) {
-            DBG( "GetAllQueuedTransfer - Sending http message : OK" );
-	        } else {
-            EXEC_ERROR( "GetAllQueuedTransfer - Sending http message : NOK" );
-	        }
-        }
-	    }																															      
-																																												      
-																																																									      													      
-     DM_ENG_deleteTabAllQueuedTransferStruct(pResult);					      
-																		      
-																		      
-        
+    nNbParameterValueStruct = DM_ENG_tablen( (void**)pResult );
+    for ( nI=0 ; nI<nNbParameterValueStruct ; nI++ ) {
+      // Add a response structure AllQueuedTransferStruct
+      DM_SoapWriter_startElement( &writer, GETALLQUEUEDTRANSFERSTRUCT );
+      DM_SoapWriter_addElement( &writer, GETALLQUEUEDTRANSFER_COMMANDKEY, pResult[nI]->commandKey );
+      tmpStr = DM_ENG_intToString(pResult[nI]->state);
+      DM_SoapWriter_addElement( &writer, GETALLQUEUEDTRANSFER_STATE, tmpStr );
+      DM_ENG_FREE(tmpStr);
+      tmpStr = DM_ENG_intToString(pResult[nI]->isDownload);
+      DM_SoapWriter_addElement( &writer, GETALLQUEUEDTRANSFER_ISDOWNLOAD, tmpStr );
+      DM_ENG_FREE(tmpStr);
+      DM_SoapWriter_addElement( &writer, GETALLQUEUEDTRANSFER_FILETYPE, pResult[nI]->fileType );
+      tmpStr = DM_ENG_intToString(pResult[nI]->fileSize);
+      DM_SoapWriter_addElement( &writer, GETALLQUEUEDTRANSFER_FILESIZE, tmpStr );
+      DM_ENG_FREE(tmpStr);
+      // Add the TargetFileName (Set an empty string)
+      DM_SoapWriter_addElement( &writer, GETALLQUEUEDTRANSFER_TARGETFILENAME, _EMPTY );
+      DM_SoapWriter_endElement( &writer ); // AllQueuedTransferStruct
+    } // End for
+    DM_SoapWriter_endElement( &writer ); // TransferList
+    DM_SoapWriter_endElement( &writer ); // GetAllQueuedTransfersResponse
+
+    // Send the message to the ACS server
+    _sendSoapMessage( &writer, "GetAllQueuedTransfer" );
+
+    DM_ENG_deleteTabAllQueuedTransferStruct(pResult);
   } else {
     // An error occurs
     DM_SoapFaultResponse( pSoapId, rc );
   }
-  
-  
-  
-  DBG("DM_SUB_GetAllQueuedTransferts - End");
 
+  DBG("DM_SUB_GetAllQueuedTransferts - End");
   return rc;
 }
 
@@ -5037,61 +5127,6 @@ DM_RemoveHeaderIDFromTab(IN const char *pIDToRemove UNUSED) {
   return DM_OK;
 } /* DM_RemoveHeaderIDFromTab */
 
-/**
- * @brief Function which add a Header_ID to a SOAP message
- *
- * @param pUniqueHeaderID Header ID to add to the soap XML message
- * @param pSoapMsg	  Pointer to the XML/SOAP object to update
- *
- * @Return DM_OK is okay else DM_ERR
- */
-DMRET
-DM_AddSoapHeaderID(
-  IN const char * pUniqueHeaderID,
-  IN DM_SoapXml * pSoapMsg)
-{
-  DMRET nMainRet = DM_ERR;
-  
-  DBG("DM_AddSoapHeaderID pUniqueHeaderID = %s", pUniqueHeaderID);
-	
-  // -----------------------------------------------------------
-  // Check parameters
-  // -----------------------------------------------------------
-  if ( (pUniqueHeaderID != NULL) && (pSoapMsg != NULL) && (pSoapMsg->pHeader != NULL) ){
-	         
-    GenericXmlNodePtr nodeHeaderId = xmlAddNode(pSoapMsg->pParser,  // XML Document
-                                                pSoapMsg->pHeader,  // parent node
-						HEADER_ID,          // new node tag
-						NULL,               // Attribut Name
-						NULL,               // Attribut Value
-						pUniqueHeaderID);   // Node Value
-
-    // ---------------------------------------------------------
-    // Add attributes to the ID header element
-    // ---------------------------------------------------------
-    // ---------------------------------------------------------------
-    // Add the MustUnderstarnd=1 attribute to the new inserted Element
-    // ---------------------------------------------------------------
-	  xmlAddNodeAttribut(nodeHeaderId, _MustUnderstandAttrName, HEADER_ATTR_VAL);   
-
-    // ----------------------------------------------------------------------------------------
-    // Add the type kind of the type used for this element (string) to the new inserted Element
-    // ----------------------------------------------------------------------------------------
-	  // xmlAddNodeAttribut(nodeHeaderId, ATTR_TYPE, XSD_STRING);   
-
-    // --------------------------------------------------------------
-    // Add the namespage for this element to the new inserted Element
-    // --------------------------------------------------------------
-    // xmlAddNodeAttribut(nodeHeaderId, NAMESPACE_ATTR, NAMESPACE_VAL);   
-
-    nMainRet = DM_OK;
-  } else {
-    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-  }
-	
-  return ( nMainRet );
-} /* DM_AddSoapHeaderID */
-
 /**
  * @brief Private _forceACSSessionToClose implementation
  *
@@ -5246,7 +5281,7 @@ _retryRequest(){
   DBG("_retryRequest - Send the previous CPE Request to the ACS");
  
   if(NULL != g_retryBuffer) {
-    if ( DM_SendHttpMessage( g_retryBuffer ) == DM_OK ) {
+    if ( DM_SendHttpMessageBuffer( g_retryBuffer ) == DM_OK ) {
       DBG( "Retry Request - Sending: OK" );
 	  } else {
       WARN( "Retry Request - Sending: NOK" );
@@ -5266,37 +5301,45 @@ _retryRequest(){
  */
 bool
 _isValidRpcCommandList(DM_ENG_ParameterValueStruct * pParameterList[]) {
-  const char * tmpStr;
-  int    nbParam = 0;
-  int    i = 0;
-  int    j = 0;
-  int    count = 0;
+  const char ** index     = NULL;  // Open addressing hash table of the parameter names (size : power of 2)
+  size_t        indexSize = 16;
+  int           nbParam   = 0;
+  int           i         = 0;
+  unsigned int  h         = 0;
+  bool          valid     = true;
   
   // Compute the number of parameter to set
   while(pParameterList[nbParam] != NULL) {
     nbParam++;
   }
-  
-  for(i=0; i < nbParam; i++) {
-    count = 0;
-    tmpStr = pParameterList[i]->parameterName;
-    
-    // Make sure the parameterName appears only one time in the Set RPC Command List
-    for(j = 0; j < nbParam; j++) {
-      if(0 == strcmp(tmpStr, pParameterList[j]->parameterName)) {
-        count++;
+  while(indexSize < 2 * (size_t)nbParam) {
+    indexSize *= 2;
+  }
+
+  index = (const char **)calloc(indexSize, sizeof(const char *));
+  if(NULL == index) {
+    EXEC_ERROR("Can not check the Set RPC Command List");
+    return false;
+  }
+
+  // Make sure each parameterName appears only one time in the Set RPC Command List
+  for(i=0; valid && (i < nbParam); i++) {
+    const char * tmpStr = pParameterList[i]->parameterName;
+
+    for(h = _hashName(tmpStr); index[h & (indexSize-1)] != NULL; h++) {
+      if(0 == strcmp(tmpStr, index[h & (indexSize-1)])) {
+        WARN("The %s parameter is set more than one time in a single Set RPC Command", tmpStr);
+        valid = false;
+        break;
       }
-    } // end for j
-    
-    // Check count value (must not be > 1)
-    if(count > 1) {
-      WARN("The %s parameter is set more than one time in a signle Set RPC Command", tmpStr);
-      return false;
     }
-    
+    if(valid) {
+      index[h & (indexSize-1)] = tmpStr;
+    }
   }  // end for i
-  
-  return true;
+
+  free(index);
+  return valid;
   
 }
 
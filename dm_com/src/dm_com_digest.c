@@ -33,63 +33,299 @@
 #include "DM_ENG_Global.h"
 #include "CMN_Trace.h"
 
-#define requestDigestAuthStr "HTTP/1.1 401 Unauthorized\nWWW-Authenticate: Digest\n   realm=\"liveboxrealm\",\n   qop=\"auth\",\n   nonce=\"%s\",\n   opaque=\"%s\"\n"
+#define requestDigestAuthStr "HTTP/1.1 401 Unauthorized\nWWW-Authenticate: Digest\n   realm=\"%s\",\n   qop=\"auth\",\n   nonce=\"%s\",\n   opaque=\"%s\"\n"
 
 #define NONCESIZE  (34)
 #define OPAQUESIZE (32)
-static char randomNonceStr[NONCESIZE + 1];  // Max(NONCESIZE, OPAQUESIZE) + 1
-static char randomOpaqueStr[NONCESIZE + 1]; // Max(NONCESIZE, OPAQUESIZE) + 1
+
+/**
+ * A challenge sent to the ACS. The nonce is made of the index of the challenge in
+ * _nonceTable (2 hex digits) and of MD5(secret:counter:time), so the answer of the ACS
+ * is validated without searching the table.
+ */
+typedef struct
+{
+  char          nonce[NONCESIZE + 1];
+  char          opaque[OPAQUESIZE + 1];
+  time_t        creationTime; // Monotonic time (seconds), not moved by a change of the wall clock
+  unsigned long nonceCount;   // Greatest nc accepted with this nonce (0 if none), a lower or equal nc is a replay
+
+} DigestChallenge;
+
+static DigestChallenge _nonceTable[NONCE_TABLE_SIZE];
+static unsigned int    _nextChallenge = 0;            // The oldest challenge, replaced by the next one
+static unsigned long   _challengeCounter = 0;
+static unsigned char   _nonceSecret[SIGNATURE_SIZE];  // Random key of the nonces, drawn at init
+
+// The connection request credentials pushed by DM_ENGINE, and the HA1 computed from them.
+// They are read without the DM_ENGINE data lock on each connection request.
+static DM_CMN_Mutex_t  _credentialsMutex = NULL;
+static bool            _credentialsKnown = false;
+static char          * _cpeUsername = NULL;
+static char          * _cpePassword = NULL;
+static char            _ha1StrResult[MAXTOKENSIZE];   // MD5(username:DIGEST_REALM:password), empty if not computed
 
 extern char * g_randomCpeUrl;
 
 /**
- * @brief Private routine used to send an authentication
- *        request tp the ACS.
+ * @brief Private routine used to compute the hex MD5 of the given string
  *
- * @param The socket aon wich the message is sent
+ * @param The string, the result (33 chars at least)
  *
- * @Return OK DM_OK or ERROR
+ * @Return None
  *
  */
-DMRET
-_sendAuthenticationRequest(int nSocksExp)
+static void _md5String(const char * _str, char * _strResult)
 {
-  char requestDigestMsg[SIZE_HTTP_MSG]; // No need to require a very large buffer.
-  DMRET nRet = DM_ERR;
-  
-  DBG( "Send Authentication Digest Request to the ACS" );
-  
-  memset((void *)requestDigestMsg, 0x00, SIZE_HTTP_MSG);
-   
-  memset((void *) &randomNonceStr[0],  '\0', sizeof(randomNonceStr));
-  memset((void *) &randomOpaqueStr[0], '\0', sizeof(randomOpaqueStr));
-  
-  // Generate a random nonce and opaque string
-  if((!_generateRandomString(randomNonceStr , NONCESIZE)) ||
-     (!_generateRandomString(randomOpaqueStr , OPAQUESIZE))) {
-     EXEC_ERROR("CAN NOT GENERATE RANDOM STRING");
-     return nRet;
+  MD5_CTX       ctx;
+  unsigned char signature[SIGNATURE_SIZE];
+
+  MD5_Init (&ctx);
+  MD5_Update (&ctx, (unsigned char *) _str, strlen(_str));
+  MD5_Final (signature, &ctx);
+  getStringResult(signature, _strResult);
+}
+
+/**
+ * @brief Initialize the digest authentication data (must be called
+ *        before the start of the http server).
+ *
+ * @param None
+ *
+ * @Return None
+ *
+ */
+void
+initDigestAuthentication()
+{
+  FILE * randomFile;
+  char   seedStr[NONCESIZE + 1];
+  MD5_CTX ctx;
+
+  DM_CMN_Thread_initMutex( &_credentialsMutex );
+  _credentialsKnown = false;
+  _ha1StrResult[0]  = '\0';
+
+  memset((void *) _nonceTable, 0x00, sizeof(_nonceTable));
+  _nextChallenge = 0;
+
+  randomFile = fopen("/dev/urandom", "r");
+  if ((NULL == randomFile) || (fread(_nonceSecret, 1, SIGNATURE_SIZE, randomFile) != SIGNATURE_SIZE)) {
+    // Fallback on the pseudo random strings
+    _generateRandomString(seedStr, NONCESIZE);
+    MD5_Init (&ctx);
+    MD5_Update (&ctx, (unsigned char *) seedStr, strlen(seedStr));
+    MD5_Final (_nonceSecret, &ctx);
   }
+  if (NULL != randomFile) {
+    fclose(randomFile);
+  }
+}
 
-  snprintf(requestDigestMsg, SIZE_HTTP_MSG, requestDigestAuthStr, randomNonceStr, randomOpaqueStr);
-  DBG( "Request Digest Authentication Message:\n%s", requestDigestMsg );
+/**
+ * @brief Release the digest authentication data
+ *
+ * @param None
+ *
+ * @Return None
+ *
+ */
+void
+releaseDigestAuthentication()
+{
+  DM_ENG_FREE(_cpeUsername);
+  DM_ENG_FREE(_cpePassword);
+  _credentialsKnown = false;
+  DM_CMN_Thread_destroyMutex( _credentialsMutex );
+  _credentialsMutex = NULL;
+}
 
-  // Send the message to the ACS and Wait for the response.
-#ifndef WIN32
-  if(-1 ==  send( nSocksExp, requestDigestMsg, strlen(requestDigestMsg), MSG_DONTWAIT )){
-    EXEC_ERROR("Error sending Authentication Request message on socket!!!");
-  } else {
-    nRet = DM_OK;
+/**
+ * @brief Private routine used to record the connection request credentials
+ *        and compute their HA1 for our realm. Must be called under _credentialsMutex.
+ *
+ * @param The username and password (NULL if not set)
+ *
+ * @Return None
+ *
+ */
+static void _setCredentials(const char * username, const char * password)
+{
+  char ha1Str[HA1_MAXTOKENSIZE];
+
+  DM_ENG_FREE(_cpeUsername);
+  DM_ENG_FREE(_cpePassword);
+  _cpeUsername = (NULL == username ? NULL : strdup(username));
+  _cpePassword = (NULL == password ? NULL : strdup(password));
+  _credentialsKnown = true;
+  _ha1StrResult[0] = '\0';
+
+  if ((NULL != _cpeUsername) && (NULL != _cpePassword)) {
+    // Build ha1Str (username:realm:password)
+    snprintf(ha1Str, HA1_MAXTOKENSIZE, "%s:%s:%s", _cpeUsername, DIGEST_REALM, _cpePassword);
+    _md5String(ha1Str, _ha1StrResult);
   }
-#else
-  if(-1 ==  send( nSocksExp, requestDigestMsg, strlen(requestDigestMsg), 0 )){
-    EXEC_ERROR("Error sending Authentication Request message on socket!!!");
-  } else {
-    nRet = DM_OK;
+}
+
+/**
+ * @brief Record the connection request credentials provided by DM_ENGINE,
+ *        at start and on each change.
+ *
+ * @param The username and password (NULL if not set)
+ *
+ * @Return None
+ *
+ */
+void
+updateDigestCredentials(const char * username, const char * password)
+{
+  DM_CMN_Thread_lockMutex(_credentialsMutex);
+  _setCredentials(username, password);
+  DM_CMN_Thread_unlockMutex(_credentialsMutex);
+}
+
+/**
+ * @brief Private routine used to get the HA1 of the connection request credentials
+ *        for DIGEST_REALM, computed once for all the requests.
+ *
+ * @param The result (MAXTOKENSIZE chars)
+ *
+ * @Return TRUE if the credentials are set, FALSE otherwise.
+ *
+ */
+static bool _getHa1(char * ha1StrResult)
+{
+  bool   nRet = false;
+  char * parameterNames[] = { (char*)DM_TR106_CONNECTIONREQUESTUSERNAME, (char*)DM_TR106_CONNECTIONREQUESTPASSWORD, NULL };
+  DM_ENG_ParameterValueStruct** result = NULL;
+
+  DM_CMN_Thread_lockMutex(_credentialsMutex);
+  if (!_credentialsKnown) {
+    // Not pushed by DM_ENGINE yet : read them once from the data model
+    DM_CMN_Thread_unlockMutex(_credentialsMutex);
+    if ((DM_ENG_GetParameterValues( DM_ENG_EntityType_ANY, parameterNames, &result ) == 0)
+     && (result != NULL) && (result[0] != NULL) && (result[1] != NULL)) {
+      DM_CMN_Thread_lockMutex(_credentialsMutex);
+      if (!_credentialsKnown) {
+        _setCredentials(result[0]->value, result[1]->value);
+      }
+    } else {
+      DM_CMN_Thread_lockMutex(_credentialsMutex);
+    }
+    if (NULL != result) {
+      DM_ENG_deleteTabParameterValueStruct(result);
+    }
+  }
+
+  if ('\0' != _ha1StrResult[0]) {
+    strncpy(ha1StrResult, _ha1StrResult, MAXTOKENSIZE);
+    nRet = true;
+  }
+  DM_CMN_Thread_unlockMutex(_credentialsMutex);
+
+  return nRet;
+}
+
+/**
+ * @brief Private routine used to get the monotonic time, used for the lifetime of the nonces
+ *        (the wall clock of the CPE may jump, e.g. at the NTP synchronization)
+ *
+ * @param None
+ *
+ * @Return The time in seconds
+ *
+ */
+static time_t _monotonicTime(void)
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec;
+}
+
+/**
+ * @brief Private routine used to find the challenge of the given nonce
+ *
+ * @param The nonce sent back by the ACS
+ *
+ * @Return The challenge, NULL if the nonce is unknown or expired
+ *
+ */
+static DigestChallenge * _findChallenge(const char * nonce)
+{
+  char              indexStr[3];
+  char            * endPtr = NULL;
+  unsigned long     index;
+  DigestChallenge * pChallenge;
+
+  if (strlen(nonce) != NONCESIZE) {
+    return NULL;
+  }
+
+  indexStr[0] = nonce[0];
+  indexStr[1] = nonce[1];
+  indexStr[2] = '\0';
+  index = strtoul(indexStr, &endPtr, 16);
+  if ((*endPtr != '\0') || (index >= NONCE_TABLE_SIZE)) {
+    return NULL;
   }
-#endif
 
-  return nRet; 
+  pChallenge = &_nonceTable[index];
+  if ((0 != strcmp(pChallenge->nonce, nonce))
+   || ((unsigned long)(_monotonicTime() - pChallenge->creationTime) > NONCE_LIFETIME)) {
+    return NULL;
+  }
+
+  return pChallenge;
+}
+
+/**
+ * @brief Private routine used to build an authentication
+ *        request to the ACS (a new nonce and opaque are generated).
+ *
+ * @param The buffer receiving the message and its size
+ *
+ * @Return OK DM_OK or ERROR
+ *
+ */
+DMRET
+_buildAuthenticationRequest(char * requestDigestMsg, int size)
+{
+  DigestChallenge * pChallenge;
+  MD5_CTX           ctx;
+  unsigned char     signature[SIGNATURE_SIZE];
+  char              hashStr[2 * SIGNATURE_SIZE + 1];
+  time_t            currentTime;
+
+  DBG( "Build Authentication Digest Request to the ACS" );
+
+  // Replace the oldest challenge
+  pChallenge = &_nonceTable[_nextChallenge];
+  currentTime = time(NULL);
+  _challengeCounter++;
+
+  MD5_Init (&ctx);
+  MD5_Update (&ctx, _nonceSecret, SIGNATURE_SIZE);
+  MD5_Update (&ctx, &_challengeCounter, sizeof(_challengeCounter));
+  MD5_Update (&ctx, &currentTime, sizeof(currentTime));
+  MD5_Final (signature, &ctx);
+  getStringResult(signature, hashStr);
+  snprintf(pChallenge->nonce, sizeof(pChallenge->nonce), "%02x%s", (unsigned char)_nextChallenge, hashStr);
+
+  MD5_Init (&ctx);
+  MD5_Update (&ctx, pChallenge->nonce, NONCESIZE);
+  MD5_Update (&ctx, _nonceSecret, SIGNATURE_SIZE);
+  MD5_Final (signature, &ctx);
+  getStringResult(signature, pChallenge->opaque);
+
+  pChallenge->creationTime = _monotonicTime();
+  pChallenge->nonceCount   = 0;
+  _nextChallenge = (_nextChallenge + 1) % NONCE_TABLE_SIZE;
+
+  snprintf(requestDigestMsg, size, requestDigestAuthStr, DIGEST_REALM, pChallenge->nonce, pChallenge->opaque);
+  DBG( "Request Digest Authentication Message:\n%s", requestDigestMsg );
+
+  return DM_OK; 
 }
 
 /**
@@ -357,13 +593,14 @@ performClientDigestAuthentication(const char * _str){
   char ncTokenStr[MAXTOKENSIZE];
   char cnonceTokenStr[MAXTOKENSIZE];
   char * httpMethodPtr = NULL;
+  char * endPtr = NULL;
   char pBufferTemp[SIZE_HTTP_MSG]; // No need to require a very large buffer.
+  DigestChallenge * pChallenge = NULL;
+  unsigned long nonceCount;
 
   // Below variables used to compute the response
-  MD5_CTX ha1Ctx;
   MD5_CTX ha2Ctx;
   MD5_CTX responseCtx;
-  char ha1Str[HA1_MAXTOKENSIZE];
   char ha2Str[HA2_MAXTOKENSIZE];
   char totalStr[TOTAL_MAXTOKENSIZE];
   char ha1StrResult[MAXTOKENSIZE];
@@ -381,7 +618,6 @@ performClientDigestAuthentication(const char * _str){
   memset((void*) cnonceTokenStr,         0x00, MAXTOKENSIZE);
   memset((void*) pBufferTemp,            0x00, SIZE_HTTP_MSG);  
 
-  memset((void *) ha1Str,                0x00, HA1_MAXTOKENSIZE);
   memset((void *) ha2Str,                0x00, HA2_MAXTOKENSIZE);
   memset((void *) totalStr,              0x00, TOTAL_MAXTOKENSIZE);
 
@@ -400,11 +636,11 @@ performClientDigestAuthentication(const char * _str){
     return false;
 	}
 
-	// Make sure the nonce and opaque str are identical to 
-	// the strings sent in the request authentication demand message
-	// Note: These strings are generated randomly
-	if((0 != strcmp(randomNonceStr, nonceTokenStr))   ||
-	   (0 != strcmp(randomOpaqueStr, opaqueTokenStr))) {
+	// Make sure the nonce and opaque str are identical to the strings sent
+	// in one of the last authentication demand messages, not expired
+	pChallenge = _findChallenge(nonceTokenStr);
+	if((NULL == pChallenge) ||
+	   (0 != strcmp(pChallenge->opaque, opaqueTokenStr))) {
     EXEC_ERROR("Authentication request does not match the generated Authentication demand message");
     EXEC_ERROR("Nonce and opaue strings are diferent from the generated ones.");
     return false;	   
@@ -412,6 +648,13 @@ performClientDigestAuthentication(const char * _str){
 	  DBG("HTTP Digest MD5 Auth - Nonce and Opaque are valid.");
 	}
 
+	// The nonce count must increase on each request with the same nonce (replay protection)
+	nonceCount = strtoul(ncTokenStr, &endPtr, 16);
+	if((endPtr == ncTokenStr) || (*endPtr != '\0') || (nonceCount <= pChallenge->nonceCount)) {
+    EXEC_ERROR("Nonce count %s already used with this nonce", ncTokenStr);
+    return false;
+	}
+
 	// Make sure the requested URL corrspond to the randomly choosen one.
 	if(NULL == strstr(uriTokenStr, g_randomCpeUrl)) {
 	  WARN("--------- The requested and choosen URL are not equal");
@@ -422,44 +665,20 @@ performClientDigestAuthentication(const char * _str){
     DBG("HTTP Digest MD5 Auth - CPE URL is Valid.");
   }
 
-  char* parameterNames[] = { (char*)DM_TR106_CONNECTIONREQUESTUSERNAME, (char*)DM_TR106_CONNECTIONREQUESTPASSWORD, NULL };
-  DM_ENG_ParameterValueStruct** result = NULL;
-
-  char* cpeUsername = NULL;
-  char* cpeConnectionRequestPassword = NULL;
-
-  if ((DM_ENG_GetParameterValues( DM_ENG_EntityType_ANY, parameterNames, &result ) == 0)
-   && (result != NULL) && (result[0] != NULL) && (result[1] != NULL)) // luxe de conditions normalement inutiles
-  {
-     cpeUsername = result[0]->value;
-     cpeConnectionRequestPassword = result[1]->value;
+  // Only our realm is challenged : an other one is not rehashed, the authentication fails
+  if (0 != strcmp(realmTokenStr, DIGEST_REALM)) {
+    WARN("HTTP Digest MD5 Auth - Unknown realm: %s", realmTokenStr);
+    return false;
   }
 
-  if ((cpeUsername == NULL) || (cpeConnectionRequestPassword == NULL))
+  // MD5(username:realm:password) is computed once, when the credentials are set
+  if (!_getHa1(ha1StrResult))
   {
     EXEC_ERROR("Can not retrieve the CPE Connection Request Username and Password");
     return false;  
   }
 
-  DBG("CPE username: %s, password: %s", cpeUsername, cpeConnectionRequestPassword);
-
-  // Build ha1Str (username:realm:password)
-  strncpy(ha1Str, cpeUsername,                  HA1_MAXTOKENSIZE);
-  strncat(ha1Str, ":",                          HA1_MAXTOKENSIZE - strlen(ha1Str));
-  strncat(ha1Str, realmTokenStr,                HA1_MAXTOKENSIZE - strlen(ha1Str));
-  strncat(ha1Str, ":",                          HA1_MAXTOKENSIZE - strlen(ha1Str));
-  strncat(ha1Str, cpeConnectionRequestPassword, HA1_MAXTOKENSIZE - strlen(ha1Str));
-
-  DM_ENG_deleteTabParameterValueStruct(result);
-
 	// Compute the response.
-  DBG("DIGEST AUTH - ha1Str:%s", ha1Str);
-
-  MD5_Init (&ha1Ctx);  
-  MD5_Update (&ha1Ctx, (unsigned char *) ha1Str, strlen(ha1Str));
-  memset((void *) signature, 0x00, SIGNATURE_SIZE);
-  MD5_Final (signature, &ha1Ctx);
-  getStringResult(signature, ha1StrResult);
   DBG("DIGEST AUTH - MD5(ha1Str):%s", ha1StrResult);
 
   // Build ha2Str (HTTPCommand:uri)
@@ -503,6 +722,7 @@ performClientDigestAuthentication(const char * _str){
   // Compare the computed result and the transmitted one.
   if(0 == strcmp(totalStrResult, responseTokenStr)) {
     INFO("DIGEST AUTH - AUTHENTICATION OK");
+    pChallenge->nonceCount = nonceCount;
     nRet = true;
   } else {
     WARN("DIGEST AUTH - AUTHENTICATION NOK");
@@ -66,6 +66,7 @@
 // DM_COM's header
 #include "dm_com.h"              /* DM_COM module definition            */
 #include "dm_com_rpc_acs.h"      /* Definition of the ACS RPC methods         */
+#include "dm_com_digest.h"       /* Digest authentication of the connection requests */
 
 // DM_ENGINE's header
 #include "DM_ENG_RPCInterface.h"    /* DM_Engine module definition            */
@@ -74,6 +75,66 @@ extern dm_com_struct  g_DmComData;
 
 extern DM_CMN_Mutex_t mutexAcsSession;
 
+/*
+* DeviceId element of the Inform messages, kept serialized with the device identity it was written with
+*/
+typedef struct _InformDeviceIdTemplate
+{
+  char * manufacturer;
+  char * OUI;
+  char * productClass;
+  char * serialNumber;
+  char * deviceIdXml; // NULL until the first Inform
+
+} __attribute((packed)) InformDeviceIdTemplate;
+
+static InformDeviceIdTemplate _informDeviceId = { NULL, NULL, NULL, NULL, NULL };
+
+/*
+* Private routine which compares 2 strings which may be NULL
+*/
+static bool
+_sameString(const char * s1,
+            const char * s2)
+{
+  return ( (s1 == NULL) || (s2 == NULL) ? (s1 == s2) : (strcmp( s1, s2 ) == 0) );
+}
+
+/*
+* Private routine which tells if the DeviceId element kept can be used for the given device identity
+*/
+static bool
+_isInformDeviceIdValid(DM_ENG_DeviceIdStruct * DeviceId)
+{
+  return ( (_informDeviceId.deviceIdXml != NULL)
+        && _sameString( _informDeviceId.manufacturer, DeviceId->manufacturer )
+        && _sameString( _informDeviceId.OUI,          DeviceId->OUI )
+        && _sameString( _informDeviceId.productClass, DeviceId->productClass )
+        && _sameString( _informDeviceId.serialNumber, DeviceId->serialNumber ) );
+}
+
+/*
+* Private routine which keeps the DeviceId element just written for the next Inform messages
+* Parameters: The device identity and the serialized element
+*/
+static void
+_setInformDeviceId(DM_ENG_DeviceIdStruct * DeviceId,
+                   const char            * pDeviceIdXml,
+                   size_t                  nLength)
+{
+  DM_ENG_FREE( _informDeviceId.manufacturer );
+  DM_ENG_FREE( _informDeviceId.OUI );
+  DM_ENG_FREE( _informDeviceId.productClass );
+  DM_ENG_FREE( _informDeviceId.serialNumber );
+  DM_ENG_FREE( _informDeviceId.deviceIdXml );
+
+  if ( DeviceId->manufacturer != NULL ) { _informDeviceId.manufacturer = strdup( DeviceId->manufacturer ); }
+  if ( DeviceId->OUI          != NULL ) { _informDeviceId.OUI          = strdup( DeviceId->OUI );          }
+  if ( DeviceId->productClass != NULL ) { _informDeviceId.productClass = strdup( DeviceId->productClass ); }
+  if ( DeviceId->serialNumber != NULL ) { _informDeviceId.serialNumber = strdup( DeviceId->serialNumber ); }
+  _informDeviceId.deviceIdXml = DM_ENG_strndup( pDeviceIdXml, nLength );
+}
+
 /**
  * @brief Request for the Remote Procedure Call available on the ACS server
  *
@@ -146,7 +207,7 @@ DM_ACS_InformCallback(
          // Translation with the internal DM_ACS_Inform function
          nRet = DM_ACS_Inform( id,
                              events,
-                             MAX_ENVELOPPE_TR069,  // Set to 1 (cf TR069 protocol)
+                             MAX_ENVELOPPE_TR069,  // 1 by default (cf TR069 protocol)
                              currentTime,
                              retryCount,
                              parameterList );
@@ -186,7 +247,7 @@ DM_ACS_InformCallback(
  * @brief Beside to "DM_ACS_Inform_Callback", this function will add the MaxEnveloppes parameter 
  * @brief that must be only known by the DM_COM module.
  *
- * @remarks The MaxEnveloppes parameter is set to 1 in the current TR069 version
+ * @remarks The MaxEnveloppes parameter is set to 1 in the current TR069 version (MAX_ENVELOPPE_TR069)
  *
  * Example of an SOAP Inform message :
  *
@@ -270,333 +331,186 @@ DM_ACS_Inform(DM_ENG_DeviceIdStruct       * DeviceId,
               DM_ENG_ParameterValueStruct * ParameterList[])
 {
    int nRet = DM_ENG_CANCELLED;
-   DM_SoapXml                SoapMsg;
-   
-   memset((void *)&SoapMsg, 0x00, sizeof(SoapMsg));
-   
+
    // Check parameters
    if ( (Event != NULL) && (DeviceId != NULL) && (ParameterList != NULL) ) {
-      int               nI = 0;
+      int             nI = 0;
       char            pUniqueHeaderID[HEADER_ID_SIZE];
-      GenericXmlNodePtr pRefInformTag          = NULL;
+      const char    * pSoapId                 = NULL;
       char            pTmpBuffer[TMPBUFFER_SIZE];
-      char           pTmpValueBuffer[TMPBUFFER_SIZE];
-      int               nNbEventStruct            = 0;
-      int               nNbParameterValueStruct   = 0;
-      char         * commandKeyStr             = NULL;
-      char         * httpMsgString             = NULL;
-      char* sTime = NULL;
+      int             nNbEventStruct          = 0;
+      int             nNbParameterValueStruct = 0;
+      char          * commandKeyStr           = NULL;
+      httpMessageBufferType * pMsgBuffer      = NULL;
+      char          * sTime                   = NULL;
+      const char    * xsdType                 = NULL;
+      size_t          nDeviceIdStart          = 0;
+      DM_SoapWriter   writer;
 
       INFO( "Send an 'Inform()' message to the ACS" );
 
-      
       // ---------------------------------------------------------------------------
-      // Initialize the SOAP data structure then create the XML/SOAP response
-      // ---------------------------------------------------------------------------
-      DM_InitSoapMsgReceived( &SoapMsg );
-      DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, true);
-
-      // ---------------------------------------------------------------------------
-      // Update the SOAP HEADER & BODY
-      // ---------------------------------------------------------------------------
-      // --> Add an INFORM tag inside the body XML node
+      // Write the SOAP HEADER then add an INFORM tag inside the BODY
       // ---------------------------------------------------------------------------
       if ( DM_GenerateUniqueHeaderID( pUniqueHeaderID ) == DM_OK ) {
-         //DBG( "-> HID = '%s' ", pUniqueHeaderID );
-         DM_AddSoapHeaderID( pUniqueHeaderID, &SoapMsg );
+         pSoapId = pUniqueHeaderID;
       }
-      
-      if ( SoapMsg.pBody != NULL ){
-         pRefInformTag = xmlAddNode(SoapMsg.pParser,  // XML Doc
-                                 SoapMsg.pBody,    // XML Parent Node
-                                 INFORM,           // Node Name
-                                 NULL,             // Attribute Name
-                                     NULL,             // Attribute Value
-                                        NULL);            // Node Value
-      
-         
-         if ( pRefInformTag == NULL ) {
-           EXEC_ERROR( "Problem to add the <INFORM> XML tag!!" );
-         }
-      }
-      
-      
-      // ---------------------------------------------------------------------
+      DM_StartSoapMessage( &writer, pSoapId, true );
+      DM_SoapWriter_startElement( &writer, INFORM );
+
+      // ---------------------------------------------------------------------------
       // Add a DeviceId tag and some sub-tags
-      // ---------------------------------------------------------------------
-      GenericXmlNodePtr pRefDeviceIdTag = xmlAddNode(SoapMsg.pParser,  // XML Doc
-                                                   pRefInformTag,    // XML Parent Node
-                                                   INFORM_DEVICEID,  // Node Name
-                                                   NULL,             // Attribute Name
-                                                       NULL,             // Attribute Value
-                                                          NULL);            // Node Value
-            
-      // - Manufacturer :
-      char * manufacturerStr = NO_CONTENT;
-      if ( DeviceId->manufacturer != NULL ){
-         // DM_AddElementWithValue( pRefDeviceIdTag, INFORM_MANUFACTURER, (char*)DeviceId->manufacturer );
-         manufacturerStr = DeviceId->manufacturer;       
+      // It is written only when the device identity changes, then copied as is
+      // ---------------------------------------------------------------------------
+      if ( _isInformDeviceIdValid( DeviceId ) ) {
+         DM_SoapWriter_addRawElements( &writer, _informDeviceId.deviceIdXml );
       } else {
-         // DM_AddElementWithValue( pRefDeviceIdTag, INFORM_MANUFACTURER, NO_CONTENT );
-        EXEC_ERROR( "Missing manufacturer name!!" );
-      }
+         DM_SoapWriter_startElement( &writer, INFORM_DEVICEID );
+         nDeviceIdStart = writer.length - sizeof(INFORM_DEVICEID); // Start of "<DeviceId", the tag is still open
 
-    xmlAddNode(SoapMsg.pParser,      // doc
-               pRefDeviceIdTag,      // parent node
-               INFORM_MANUFACTURER,  // Node Name 
-                NULL,                 // Attribut Name
-                 NULL,                 // Attribut Value
-                  manufacturerStr);     // Node Value
-      
-      // - Organisational Unique Identifier :
-      char * ouiStr = NO_CONTENT;
-      if ( DeviceId->OUI != NULL ){
+         // - Manufacturer :
+         char * manufacturerStr = NO_CONTENT;
+         if ( DeviceId->manufacturer != NULL ){
+            manufacturerStr = DeviceId->manufacturer;
+         } else {
+            EXEC_ERROR( "Missing manufacturer name!!" );
+         }
+         DM_SoapWriter_addElement( &writer, INFORM_MANUFACTURER, manufacturerStr );
 
-         ouiStr = DeviceId->OUI;
-      } else {
+         // - Organisational Unique Identifier :
+         char * ouiStr = NO_CONTENT;
+         if ( DeviceId->OUI != NULL ){
+            ouiStr = DeviceId->OUI;
+         } else {
+            EXEC_ERROR( "Missing OUI (Organizational Unique Identifier)!!" );
+         }
+         DM_SoapWriter_addElement( &writer, INFORM_OUI, ouiStr );
 
-      EXEC_ERROR( "Missing OUI (Organizational Unique Identifier)!!" );
-      }
+         // - Product Class :
+         char * productClassStr = NO_CONTENT;
+         if ( DeviceId->productClass  != NULL ){
+            productClassStr = DeviceId->productClass;
+         } else {
+            EXEC_ERROR( "Missing product class!!" );
+         }
+         DM_SoapWriter_addElement( &writer, INFORM_PRODUCTCLASS, productClassStr );
 
-    xmlAddNode(SoapMsg.pParser,  // doc
-               pRefDeviceIdTag,  // parent node
-               INFORM_OUI,       // Node Name 
-                NULL,             // Attribut Name
-                 NULL,             // Attribut Value
-                  ouiStr);          // Node Value
-              
-      
-      // - Product Class :
-      char * productClassStr = NO_CONTENT;
-      if ( DeviceId->productClass  != NULL ){
-      productClassStr = DeviceId->productClass;
-      } else {
-        EXEC_ERROR( "Missing product class!!" );
-      }
+         // - Serial Number :
+         char * serialNumberStr = NO_CONTENT;
+         if ( DeviceId->serialNumber != NULL ){
+            serialNumberStr = DeviceId->serialNumber;
+         } else {
+            EXEC_ERROR( "Missing serial number!!" );
+         }
+         DM_SoapWriter_addElement( &writer, INFORM_SERIALNUMBER, serialNumberStr );
 
-    xmlAddNode(SoapMsg.pParser,     // doc
-               pRefDeviceIdTag,     // parent node
-               INFORM_PRODUCTCLASS, // Node Name 
-                NULL,                // Attribut Name
-                 NULL,                // Attribut Value
-                  productClassStr);    // Node Value
-      
-      // - Serial Number :
-      char * serialNumberStr = NO_CONTENT;
-      if ( DeviceId->serialNumber != NULL ){
-      serialNumberStr = DeviceId->serialNumber;
-      } else {
-        EXEC_ERROR( "Missing serial number!!" );
+         DM_SoapWriter_endElement( &writer ); // DeviceId
+         if ( !writer.error ) {
+            _setInformDeviceId( DeviceId, writer.buffer + nDeviceIdStart, writer.length - nDeviceIdStart );
+         }
       }
 
-    xmlAddNode(SoapMsg.pParser,     // doc
-               pRefDeviceIdTag,     // parent node
-               INFORM_SERIALNUMBER, // Node Name 
-                NULL,                // Attribut Name
-                 NULL,                // Attribut Value
-                  serialNumberStr);    // Node Value
-             
-      // ---------------------------------------------------------------------
+      // ---------------------------------------------------------------------------
       // Add an event tag and some sub-tags
-      // ---------------------------------------------------------------------
-   
-      // ---------------------------------------------------------------------
+      // ---------------------------------------------------------------------------
       // Count how many Eventstruct there is in the list
-      // ---------------------------------------------------------------------
       nNbEventStruct = DM_ENG_tablen( (void**)Event );
+      DM_SoapWriter_startElement( &writer, INFORM_EVENT );
       if ( nNbEventStruct<10 ){
-         snprintf( pTmpBuffer, TMPBUFFER_SIZE,  INFORM_EVENT_ATTR_VAL1, nNbEventStruct );
+         snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_EVENT_ATTR_VAL1, nNbEventStruct );
       } else {
          snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_EVENT_ATTR_VAL2, nNbEventStruct );
       }
+      DM_SoapWriter_addAttribute( &writer, DM_COM_ArrayTypeAttrName, pTmpBuffer );
 
-      GenericXmlNodePtr pRefEventListTag = xmlAddNode(SoapMsg.pParser,    // XML Doc        
-                                                      pRefInformTag,      // XML Parent Node  
-                                                            INFORM_EVENT,       // Node Name
-                                                                DM_COM_ArrayTypeAttrName,  // Attribute Name
-                                                                   pTmpBuffer,         // Attribute Value
-                                                                     NULL);              // Node Value
-                          
-                          
-      
-      // Node * pRefEventStruct = NULL;
-      GenericXmlNodePtr pRefEventStruct = NULL;
       for ( nI=0 ; nI<nNbEventStruct ; nI++ )
       {
+         DM_SoapWriter_startElement( &writer, INFORM_EVENTSTRUCT );
+         DM_SoapWriter_addElement( &writer, INFORM_EVENT_CODE, Event[nI]->eventCode );
 
-      pRefEventStruct = xmlAddNode(SoapMsg.pParser,         // XML Doc       
-                                   pRefEventListTag,      // XML Parent Node   
-                                   INFORM_EVENTSTRUCT,    // Node Name
-                                   NULL,                  // Attribute Name
-                                   NULL,                  // Attribute Value
-                                   NULL);                 // Node Value
-
-      xmlAddNode(SoapMsg.pParser,         // XML Doc       
-                 pRefEventStruct,       // XML Parent Node   
-                 INFORM_EVENT_CODE,     // Node Name
-                 NULL,                  // Attribute Name
-                 NULL,                  // Attribute Value
-                 Event[nI]->eventCode); // Node Value
-         
          // This data may be empty for some events
          commandKeyStr = NO_CONTENT;
          if ( Event[nI]->commandKey != NULL ){
             commandKeyStr = Event[nI]->commandKey;
          }
-
-      xmlAddNode(SoapMsg.pParser,         // XML Doc       
-                 pRefEventStruct,       // XML Parent Node   
-                 INFORM_COMMANDKEY,     // Node Name
-                 NULL,                  // Attribute Name
-                 NULL,                  // Attribute Value
-                 commandKeyStr); // Node Value  
+         DM_SoapWriter_addElement( &writer, INFORM_COMMANDKEY, commandKeyStr );
+         DM_SoapWriter_endElement( &writer ); // EventStruct
       }
-      
-      // ---------------------------------------------------------------------
-      // Add a MaxEnveloppes tag with a value set to 1 according to the TR-069 document (2007)
-      // ---------------------------------------------------------------------
+      DM_SoapWriter_endElement( &writer ); // Event
+
+      // ---------------------------------------------------------------------------
+      // Add a MaxEnveloppes tag (1 according to the TR-069 document (2007), unless MAX_ENVELOPPE_TR069 is overridden)
+      // ---------------------------------------------------------------------------
       snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", MaxEnveloppes);
-    xmlAddNode(SoapMsg.pParser,       // XML Doc        
-               pRefInformTag,        // XML Parent Node   
-               INFORM_MAXENVELOPES, // Node Name
-               NULL,                 // Attribute Name
-               NULL,                 // Attribute Value
-               pTmpBuffer);          // Node Value 
-
-      // ---------------------------------------------------------------------
+      DM_SoapWriter_addElement( &writer, INFORM_MAXENVELOPES, pTmpBuffer );
+
+      // ---------------------------------------------------------------------------
       // Add a CurrentTime tag
-      // ---------------------------------------------------------------------
+      // ---------------------------------------------------------------------------
       sTime = DM_ENG_dateTimeToString(CurrentTime);
-
-      xmlAddNode(SoapMsg.pParser,       // XML Doc      
-                  pRefInformTag,        // XML Parent Node   
-                  INFORM_CURRENTTIME,   // Node Name
-                  NULL,                 // Attribute Name
-                  NULL,                 // Attribute Value
-                  sTime);               // Node Value 
+      DM_SoapWriter_addElement( &writer, INFORM_CURRENTTIME, sTime );
       free(sTime);
 
-      // ---------------------------------------------------------------------
+      // ---------------------------------------------------------------------------
       // Add a RetryCount tag
-      // ---------------------------------------------------------------------
+      // ---------------------------------------------------------------------------
       snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d", RetryCounts);
+      DM_SoapWriter_addElement( &writer, INFORM_RETRYCOUNT, pTmpBuffer );
 
-    xmlAddNode(SoapMsg.pParser,       // XML Doc        
-               pRefInformTag,        // XML Parent Node   
-               INFORM_RETRYCOUNT,   // Node Name
-               NULL,                 // Attribute Name
-               NULL,                 // Attribute Value
-               pTmpBuffer);          // Node Value 
-      // ---------------------------------------------------------------------
-      // Add a parameterList tag and sub-tag ParameterValueStruct
       // ---------------------------------------------------------------------------
+      // Add a parameterList tag and sub-tag ParameterValueStruct
       // ---------------------------------------------------------------------------
       // Count how many parametervaluestruct there is in the list
-      // ---------------------------------------------------------------------------
       nNbParameterValueStruct = DM_ENG_tablen( (void**)ParameterList );
+      DM_SoapWriter_startElement( &writer, INFORM_PARAMETERLIST );
       if ( nNbParameterValueStruct<10 ){
          snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_PARAMETERLIST_ATTR_VAL1, nNbParameterValueStruct );
       } else {
          snprintf( pTmpBuffer, TMPBUFFER_SIZE, INFORM_PARAMETERLIST_ATTR_VAL2, nNbParameterValueStruct );
       }
+      DM_SoapWriter_addAttribute( &writer, DM_COM_ArrayTypeAttrName, pTmpBuffer );
 
-                          
-      GenericXmlNodePtr pRefParamListTag = xmlAddNode(SoapMsg.pParser,    // XML Doc        
-                                                      pRefInformTag,      // XML Parent Node  
-                                                            INFORM_PARAMETERLIST,       // Node Name
-                                                                DM_COM_ArrayTypeAttrName,  // Attribute Name
-                                                                   pTmpBuffer,         // Attribute Value
-                                                                     NULL);              // Node Value
-                              
-
-      GenericXmlNodePtr pRefParamStruct = NULL;
-      GenericXmlNodePtr pRefParamValue  = NULL;
-      // char      * lanIpAddressStr = NULL;
       for ( nI=0 ; nI<nNbParameterValueStruct ; nI++ ){
+         DM_SoapWriter_startElement( &writer, INFORM_PARAMETERVALUESTRUCT );
+         DM_SoapWriter_addElement( &writer, INFORM_NAME, ParameterList[nI]->parameterName );
 
-      pRefParamStruct = xmlAddNode(SoapMsg.pParser,               // doc
-                                   pRefParamListTag,              // parent node
-                                   INFORM_PARAMETERVALUESTRUCT,   // new node tag
-                                   NULL,                          // Attribute Name
-                                        NULL,                          // Attribute Value
-                                            NULL);                         // Node value
-
-      xmlAddNode(SoapMsg.pParser,                   // doc
-                 pRefParamStruct,                   // parent node
-                 INFORM_NAME,                       // new node tag
-                 NULL,                              // Attribute Name
-                 NULL,                              // Attribute Value
-                 ParameterList[nI]->parameterName); // Node value
-
-         memset((void*) pTmpValueBuffer, 0x00, TMPBUFFER_SIZE);
          if (ParameterList[nI]->value != NULL)  {
-           strncpy(pTmpValueBuffer, ParameterList[nI]->value, TMPBUFFER_SIZE - 1);
            DBG("ParameterList[%d]->value: %s", nI, ParameterList[nI]->value);
          } else {
            DBG("ParameterList[%d]->value is NULL", nI);
          }
-
-         // pRefParamValue = DM_AddElementWithValue( pRefParamStruct, INFORM_VALUE, lanIpAddressStr );
-         
-         switch ( ParameterList[nI]->type )
-         {
-            case DM_ENG_ParameterType_INT:     snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_INT );         break;
-            case DM_ENG_ParameterType_UINT:    snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_UNSIGNEDINT ); break;
-            case DM_ENG_ParameterType_LONG:    snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_LONG );        break;
-            case DM_ENG_ParameterType_BOOLEAN: snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_BOOLEAN );     break;
-            case DM_ENG_ParameterType_DATE:    snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_DATETIME );    break;
-            case DM_ENG_ParameterType_STRING:  snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_STRING );      break;
-            case DM_ENG_ParameterType_STATISTICS:
-            case DM_ENG_ParameterType_ANY:     snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%s", XSD_ANY );         break;
-            case DM_ENG_ParameterType_UNDEFINED: WARN( "Undefined type value!!" );           break;
-            default:
-               {
-                 EXEC_ERROR( "Unknown type value for a parameter (%d) ",
-                         ParameterList[nI]->type );
-               }
-               break;
+         DM_SoapWriter_startElement( &writer, INFORM_VALUE );
+         xsdType = DM_GetXsdTypeName( ParameterList[nI]->type );
+         if ( xsdType != NULL ) {
+            DM_SoapWriter_addAttribute( &writer, INFORM_VALUE_ATTR, xsdType );
          }
-
-      pRefParamValue = xmlAddNode(SoapMsg.pParser,    // doc
-                                  pRefParamStruct,    // parent node
-                                  INFORM_VALUE,       // new node tag
-                                  INFORM_VALUE_ATTR,  // Attribute Name
-                                  pTmpBuffer,         // Attribute Value
-                                  pTmpValueBuffer);   // Node value
-
+         DM_SoapWriter_addText( &writer, ParameterList[nI]->value );
+         DM_SoapWriter_endElement( &writer ); // Value
+         DM_SoapWriter_endElement( &writer ); // ParameterValueStruct
       } // end for
+      DM_SoapWriter_endElement( &writer ); // ParameterList
+      DM_SoapWriter_endElement( &writer ); // Inform
 
       // ---------------------------------------------------------------------------
-      // Remake the XML buffer then send it to ACS server
+      // Terminate the message then send it to ACS server
       // ---------------------------------------------------------------------------
-      if ( SoapMsg.pRoot != NULL )
-      {
-         httpMsgString = DM_RemakeXMLBufferACS( SoapMsg.pRoot );
-         if ( httpMsgString != NULL ) {      
-            // Send the HTTP message
-            if ( DM_SendHttpMessage( httpMsgString ) == DM_OK ) {
-               DBG( "Inform - Sending http message : OK" );
-               nRet = DM_ENG_SESSION_OPENING;
-            } else {
-               DM_RemoveHeaderIDFromTab( pUniqueHeaderID );
-              EXEC_ERROR( "Inform - Sending http message : NOK" );
-            }
-            
-            // Free the HTTP Message
-            free(httpMsgString);
+      pMsgBuffer = DM_CreateHttpMessageBuffer( DM_EndSoapMessage( &writer ) );
+      if ( pMsgBuffer != NULL ) {
+         // Send the HTTP message
+         if ( DM_SendHttpMessageBuffer( pMsgBuffer ) == DM_OK ) {
+            DBG( "Inform - Sending http message : OK" );
+            nRet = DM_ENG_SESSION_OPENING;
+         } else {
+            DM_RemoveHeaderIDFromTab( pUniqueHeaderID );
+            EXEC_ERROR( "Inform - Sending http message : NOK" );
          }
+         // Release the HTTP Message (still referenced by the HTTP client while it is sent)
+         DM_ReleaseHttpMessageBuffer( pMsgBuffer );
       }
    } else {
-     EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+      EXEC_ERROR( ERROR_INVALID_PARAMETERS );
    }
-   
-  if(NULL != SoapMsg.pParser) {
-     // Free xml document
-     xmlDocumentFree(SoapMsg.pParser);
-     SoapMsg.pParser = NULL;
 
-   }
-   
    return( nRet );
 } /* DM_ACS_Inform */
 
@@ -703,158 +617,80 @@ DM_ACS_TransfertComplete(
   dateTime      StartTime,
    dateTime     CompleteTime)
 {
-   int   nRet = DM_ENG_CANCELLED;
-  DM_SoapXml                   SoapMsg;
-  char                      * httpMsgString = NULL;
-   
-   memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));  
-   
+   int nRet = DM_ENG_CANCELLED;
+
    // Check parameter
    if ( CommandKey != NULL )  {
-      char         pUniqueHeaderID[HEADER_ID_SIZE];
-      GenericXmlNodePtr pRefTranfertCompleteTag = NULL;
-      char         pTmpBuffer[TMPBUFFER_SIZE];
-    char* sTime = NULL;
+      char            pUniqueHeaderID[HEADER_ID_SIZE];
+      const char    * pSoapId       = NULL;
+      char            pTmpBuffer[TMPBUFFER_SIZE];
+      char          * sTime         = NULL;
+      httpMessageBufferType * pMsgBuffer = NULL;
+      DM_SoapWriter   writer;
 
-      
       INFO( "Send a 'TranfertComplete()' message to the ACS (from the callback) " );
-      
-      // ---------------------------------------------------------------------------
-      // Initialize the SOAP data structure then create the XML/SOAP response
-      // ---------------------------------------------------------------------------
-      DM_InitSoapMsgReceived( &SoapMsg );
-      DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
 
-      // ---------------------------------------------------------------------------      
-      // Update the SOAP HEADER
+      // ---------------------------------------------------------------------------
+      // Write the SOAP HEADER
       // ---------------------------------------------------------------------------
       if ( DM_GenerateUniqueHeaderID( pUniqueHeaderID ) == DM_OK ) {
-         DM_AddSoapHeaderID( pUniqueHeaderID, &SoapMsg );
+         pSoapId = pUniqueHeaderID;
       }
-      
-      // ---------------------------------------------------------------------------
-      // Save the current SOAPID
-      // ---------------------------------------------------------------------------
-      //strcpy( g_DmComData.DmSynchroCallback, pUniqueHeaderID );
-      
+      DM_StartSoapMessage( &writer, pSoapId, false );
+
       // ---------------------------------------------------------------------------
-      // Update the SOAP BODY
+      // Write the SOAP BODY : a TransferComplete tag
       // ---------------------------------------------------------------------------
-      if ( SoapMsg.pBody != NULL ) {
-         // ---------------------------------------------------------------------
-         // Add a Transfertcomplete Tag
-         // ---------------------------------------------------------------------
-
-      pRefTranfertCompleteTag = xmlAddNode(SoapMsg.pParser,    // doc
-                                           SoapMsg.pBody,      // parent node
-                                           TRANSFERTCOMPLETE,  // new node tag
-                                           NULL,               // Attribute Name
-                                           NULL,               // Attribute Value
-                                           NULL);              // Node value
-         
-         // ---------------------------------------------------------------------
-         // Add a command key
-         // ---------------------------------------------------------------------
-         if ( strlen( (char*)CommandKey ) <= SIZE_COMMANDKEY ) {
-
-        xmlAddNode(SoapMsg.pParser,             // doc
-                   pRefTranfertCompleteTag,     // parent node
-                   TRANSFERTCOMPLETECOMMANDKEY, // new node tag
-                   NULL,                        // Attribute Name
-                   NULL,                        // Attribute Value
-                   (char*)CommandKey);          // Node value
-                 
-         } else {
-           EXEC_ERROR( "Command key bigger than %d!!", SIZE_COMMANDKEY);
-         }
-         
-         // ---------------------------------------------------------------------
-         // Add a faultstruct and its two elements
-         // ---------------------------------------------------------------------
-      GenericXmlNodePtr pRefFaultStruct = xmlAddNode(SoapMsg.pParser,              // DOC
-                                                     pRefTranfertCompleteTag,      // Parent Node
-                                                     TRANSFERTCOMPLETEFAULTSTRUCT, // Node Name
-                                                     NULL,                         // Attribute Name
-                                                     NULL,                         // Attribute Value 
-                                                     NULL);                        // Node Value
-                                  
-         
-         snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d",  (int)FaultStruct.FaultCode );
-
-      xmlAddNode(SoapMsg.pParser,             // DOC
-                 pRefFaultStruct,             // Parent Node
-                 TRANSFERTCOMPLETEFAULTCODE,  // Node Name
-                 NULL,                        // Attribute Name
-                 NULL,                        // Attribute Value                        
-                 pTmpBuffer);                 // Node Value
-               
-
-      xmlAddNode(SoapMsg.pParser,              // DOC
-                 pRefFaultStruct,              // Parent Node
-                 TRANSFERTCOMPLETEFAULTSTRING, // Node Name
-                 NULL,                         // Attribute Name
-                 NULL,                         // Attribute Value                        
-                 FaultStruct.FaultString);     // Node Value
-         // ---------------------------------------------------------------------
-         // Add a start time
-         // ---------------------------------------------------------------------
-         sTime = DM_ENG_dateTimeToString(StartTime);
-         DBG( "Start time = %s ", sTime );
-
-         xmlAddNode(SoapMsg.pParser,             // DOC
-                    pRefTranfertCompleteTag,     // Parent Node
-                    TRANSFERTCOMPLETESTARTTIME,  // Node Name
-                    NULL,                        // Attribute Name
-                    NULL,                        // Attribute Value                        
-                    sTime);                      // Node Value
-         free(sTime);
-
-         // ---------------------------------------------------------------------
-         // Add a complete time (end time)
-         // ---------------------------------------------------------------------
-         sTime = DM_ENG_dateTimeToString(CompleteTime);
-         DBG( "Complete/End time = %s ", sTime );
-
-         xmlAddNode(SoapMsg.pParser,               // DOC
-                    pRefTranfertCompleteTag,       // Parent Node
-                    TRANSFERTCOMPLETECOMPLETETIME, // Node Name
-                    NULL,                          // Attribute Name
-                    NULL,                          // Attribute Value                        
-                    sTime);                        // Node Value
-         free(sTime);
+      DM_SoapWriter_startElement( &writer, TRANSFERTCOMPLETE );
 
+      // Add a command key
+      if ( strlen( (char*)CommandKey ) <= SIZE_COMMANDKEY ) {
+         DM_SoapWriter_addElement( &writer, TRANSFERTCOMPLETECOMMANDKEY, CommandKey );
+      } else {
+         EXEC_ERROR( "Command key bigger than %d!!", SIZE_COMMANDKEY);
       }
-      
+
+      // Add a faultstruct and its two elements
+      DM_SoapWriter_startElement( &writer, TRANSFERTCOMPLETEFAULTSTRUCT );
+      snprintf( pTmpBuffer, TMPBUFFER_SIZE, "%d",  (int)FaultStruct.FaultCode );
+      DM_SoapWriter_addElement( &writer, TRANSFERTCOMPLETEFAULTCODE, pTmpBuffer );
+      DM_SoapWriter_addElement( &writer, TRANSFERTCOMPLETEFAULTSTRING, FaultStruct.FaultString );
+      DM_SoapWriter_endElement( &writer );
+
+      // Add a start time
+      sTime = DM_ENG_dateTimeToString(StartTime);
+      DBG( "Start time = %s ", sTime );
+      DM_SoapWriter_addElement( &writer, TRANSFERTCOMPLETESTARTTIME, sTime );
+      free(sTime);
+
+      // Add a complete time (end time)
+      sTime = DM_ENG_dateTimeToString(CompleteTime);
+      DBG( "Complete/End time = %s ", sTime );
+      DM_SoapWriter_addElement( &writer, TRANSFERTCOMPLETECOMPLETETIME, sTime );
+      free(sTime);
+
+      DM_SoapWriter_endElement( &writer ); // TransferComplete
+
       // ---------------------------------------------------------------------------
-      // Remake the XML buffer then send it to DM_SendHttpMessage
+      // Terminate the message then send it to DM_SendHttpMessage
       // ---------------------------------------------------------------------------
-      if ( SoapMsg.pRoot != NULL )
-      {
-         httpMsgString = DM_RemakeXMLBufferACS( SoapMsg.pRoot );
-         if ( httpMsgString != NULL ) {      
-            // Send the message
-            if ( DM_SendHttpMessage( httpMsgString ) == DM_OK ) {
-               DBG( "TransfertComplete - Sending http message : OK" );
-            } else {
-               DM_RemoveHeaderIDFromTab( pUniqueHeaderID );
-              EXEC_ERROR( "TransfertComplete - Sending http message : NOK" );
-            }
+      pMsgBuffer = DM_CreateHttpMessageBuffer( DM_EndSoapMessage( &writer ) );
+      if ( pMsgBuffer != NULL ) {
+         // Send the message
+         if ( DM_SendHttpMessageBuffer( pMsgBuffer ) == DM_OK ) {
+            DBG( "TransfertComplete - Sending http message : OK" );
+         } else {
+            DM_RemoveHeaderIDFromTab( pUniqueHeaderID );
+            EXEC_ERROR( "TransfertComplete - Sending http message : NOK" );
          }
-         free(httpMsgString);
+         DM_ReleaseHttpMessageBuffer( pMsgBuffer );
       }
-      
+
       nRet = DM_ENG_SESSION_OPENING;
    } else {
-     EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+      EXEC_ERROR( ERROR_INVALID_PARAMETERS );
    }
-   
-   if(NULL != SoapMsg.pParser) {
-     // Free xml document
-     xmlDocumentFree(SoapMsg.pParser);
-     SoapMsg.pParser = NULL;
 
-   }
-   
    return( nRet );
 } /* DM_ACS_TransfertComplete */
 
@@ -882,138 +718,76 @@ int
 DM_ACS_RequestDownloadCallback(const char         * FileType,
                                DM_ENG_ArgStruct   * FileTypeArg[])
 {
+   DM_SoapWriter   writer;
+   httpMessageBufferType * pMsgBuffer = NULL;
+   unsigned int    argStructArraySize = 0;
+   unsigned int    n;
+   char            tmpStr[SIZE_FAULTSTRUCT_STRING];
+   char            pUniqueHeaderID[HEADER_ID_SIZE];
+   const char    * pSoapId            = NULL;
+   int             nRet               = DM_ENG_CANCELLED;
 
-  DM_SoapXml            SoapMsg;
-  char               * httpMsgString          = NULL;
-  GenericXmlNodePtr    pRefRequestDownloadTag   = NULL;
-  GenericXmlNodePtr    pRefFileTypeArgTag     = NULL;
-  GenericXmlNodePtr    pRefArgStructTag       = NULL;
-  unsigned int         argStructArraySize     = 0;
-  unsigned int         n;
-  char                 tmpStr[SIZE_FAULTSTRUCT_STRING];
-  char                 pUniqueHeaderID[HEADER_ID_SIZE];
-   int   nRet = DM_ENG_CANCELLED;
-
-   
-   memset((void *) &SoapMsg, 0x00, sizeof(SoapMsg));
-   
    // Check parameter
    if ( FileType != NULL ) {
-   
+
       INFO( "Send a 'RequestDownload()' message to the ACS (from the callback) " );
-      // ---------------------------------------------------------------------------
-      // Initialize the SOAP data structure then create the XML/SOAP response
-      // ---------------------------------------------------------------------------
-      DM_InitSoapMsgReceived( &SoapMsg );
-      DM_AnalyseSoapMessage( &SoapMsg, NULL, TYPE_CPE, false );
 
-      // ---------------------------------------------------------------------------      
-      // Update the SOAP HEADER
+      // ---------------------------------------------------------------------------
+      // Write the SOAP HEADER
       // ---------------------------------------------------------------------------
       if ( DM_GenerateUniqueHeaderID( pUniqueHeaderID ) == DM_OK ) {
-         DM_AddSoapHeaderID( pUniqueHeaderID, &SoapMsg );
+         pSoapId = pUniqueHeaderID;
       }
-      
+      DM_StartSoapMessage( &writer, pSoapId, false );
+
       // ---------------------------------------------------------------------------
-      // Update the SOAP BODY
+      // Write the SOAP BODY : a RequestDownload tag with the FileType
       // ---------------------------------------------------------------------------
-      if ( SoapMsg.pBody != NULL ) {
-         // ---------------------------------------------------------------------
-         // Add a REQUESTDOWNLOAD Tag
-         // ---------------------------------------------------------------------
-
-        pRefRequestDownloadTag = xmlAddNode(SoapMsg.pParser,    // doc
-                                            SoapMsg.pBody,      // parent node
-                                            REQUESTDOWNLOAD,    // new node tag
-                                            NULL,               // Attribute Name
-                                            NULL,               // Attribute Value
-                                            NULL);              // Node value
-        }
-        
-        // Add the FileType Node
-      xmlAddNode(SoapMsg.pParser,          // doc
-                 pRefRequestDownloadTag,   // parent node
-                 REQUESTDOWNLOAD_FILETYPE, // new node tag
-                 NULL,                     // Attribute Name
-                 NULL,                     // Attribute Value
-                 FileType);                // Node value
-       
-        // Compute the number of element in the array
+      DM_SoapWriter_startElement( &writer, REQUESTDOWNLOAD );
+      DM_SoapWriter_addElement( &writer, REQUESTDOWNLOAD_FILETYPE, FileType );
+
+      // Compute the number of element in the array
       argStructArraySize = DM_ENG_tablen( (void**)FileTypeArg );
 
-        DBG("Number of element in the Array = %d", argStructArraySize);
-        
-        // Build the string
-        sprintf(tmpStr, REQUESTDOWNLOAD_CWMP_ARG_STRUCT, argStructArraySize);      
-                          
-        // Add The Node 
-        pRefFileTypeArgTag = xmlAddNode(SoapMsg.pParser,                 // doc
-                                      pRefRequestDownloadTag,          // parent node
-                                      REQUESTDOWNLOAD_FILETYPEARG,     // new node tag
-                                      DM_COM_ArrayTypeAttrName, // Attribute Name
-                                      tmpStr,                          // Attribute Value
-                                      NULL);                           // Node value
-                  
-       // Add all the ArgStruct
-       for(n = 0; n < argStructArraySize; n++) {
-         // Add thhe 
-         pRefArgStructTag = xmlAddNode(SoapMsg.pParser,           // doc
-                                     pRefFileTypeArgTag,        // parent node
-                                     REQUESTDOWNLOAD_ARGSTRUCT, // new node tag
-                                     NULL,                      // Attribute Name
-                                     NULL,                      // Attribute Value
-                                     NULL);                     // Node value
-          // Add the Name
-          xmlAddNode(SoapMsg.pParser,       // doc
-                  pRefArgStructTag,      // parent node
-                  PARAM_NAME,            // new node tag
-                  NULL,                  // Attribute Name
-                  NULL,                  // Attribute Value
-                  FileTypeArg[n]->name);  // Node value
-                 
-          // Add the Value
-          xmlAddNode(SoapMsg.pParser,       // doc
-                  pRefArgStructTag,      // parent node
-                  PARAM_VALUE,           // new node tag
-                  NULL,                  // Attribute Name
-                  NULL,                  // Attribute Value
-                  FileTypeArg[n]->value); // Node value
-       }
-       
-       
-      
+      DBG("Number of element in the Array = %d", argStructArraySize);
+
+      // Build the arrayType attribute
+      sprintf(tmpStr, REQUESTDOWNLOAD_CWMP_ARG_STRUCT, argStructArraySize);
+
+      DM_SoapWriter_startElement( &writer, REQUESTDOWNLOAD_FILETYPEARG );
+      DM_SoapWriter_addAttribute( &writer, DM_COM_ArrayTypeAttrName, tmpStr );
+
+      // Add all the ArgStruct
+      for(n = 0; n < argStructArraySize; n++) {
+         DM_SoapWriter_startElement( &writer, REQUESTDOWNLOAD_ARGSTRUCT );
+         DM_SoapWriter_addElement( &writer, PARAM_NAME,  FileTypeArg[n]->name );
+         DM_SoapWriter_addElement( &writer, PARAM_VALUE, FileTypeArg[n]->value );
+         DM_SoapWriter_endElement( &writer );
+      }
+      DM_SoapWriter_endElement( &writer ); // FileTypeArg
+      DM_SoapWriter_endElement( &writer ); // RequestDownload
+
       // ---------------------------------------------------------------------------
-      // Remake the XML buffer then send it to DM_SendHttpMessage
+      // Terminate the message then send it to DM_SendHttpMessage
       // ---------------------------------------------------------------------------
-      if ( SoapMsg.pRoot != NULL )
-      {
-         httpMsgString = DM_RemakeXMLBufferACS( SoapMsg.pRoot );
-         if ( httpMsgString != NULL ) {      
-            // Send the message
-            if ( DM_SendHttpMessage( httpMsgString ) == DM_OK ) {
-               DBG( "TransfertComplete - Sending http message : OK" );
-            } else {
-               DM_RemoveHeaderIDFromTab( pUniqueHeaderID );
-               EXEC_ERROR( "TransfertComplete - Sending http message : NOK" );
-            }
+      pMsgBuffer = DM_CreateHttpMessageBuffer( DM_EndSoapMessage( &writer ) );
+      if ( pMsgBuffer != NULL ) {
+         // Send the message
+         if ( DM_SendHttpMessageBuffer( pMsgBuffer ) == DM_OK ) {
+            DBG( "RequestDownload - Sending http message : OK" );
+         } else {
+            DM_RemoveHeaderIDFromTab( pUniqueHeaderID );
+            EXEC_ERROR( "RequestDownload - Sending http message : NOK" );
          }
-         free(httpMsgString);
+         DM_ReleaseHttpMessageBuffer( pMsgBuffer );
       }
-      
+
       nRet = DM_ENG_SESSION_OPENING;
    } else {
       EXEC_ERROR( ERROR_INVALID_PARAMETERS );
    }
-   
-   if(NULL != SoapMsg.pParser) {
-     // Free xml document
-     xmlDocumentFree(SoapMsg.pParser);
-     SoapMsg.pParser = NULL;
 
-   }
-   
    return( nRet );
-
 } /* DM_ACS_RequestDownloadCallback */
 
 /**
@@ -1074,27 +848,24 @@ void DM_ACS_updateAscParameters(char * url,
 }
 
 /**
- * @brief function which remake the xml buffer
+ * @brief Notify the DM_COM module of the credentials of the connection requests.
+ *        This callback function is used when the application is started and when 
+ *        the ConnectionRequestUsername or ConnectionRequestPassword is changed.
  *
- * @param pElement  Current element of the XML tree (
+ * @param username - The username expected from the ACS (could be NULL if not set)
+ * 
+ * @param password - The password expected from the ACS (could be NULL if not set)
  *
- * @Return A pointer on the string (or NULL on ERROR)
+ * @return void
  *
- * @Remarks for a complete tree, pElement = pRoot
- */
-char *
-DM_RemakeXMLBufferACS(GenericXmlNodePtr pElement)
+ */ 
+void DM_ACS_updateConnectionRequestCredentials(char * username,
+                                               char * password)
 {
-  char * httpMessageStr = NULL;
-  
-  if(NULL == pElement) {
-    return (httpMessageStr);
-  }
-
-   httpMessageStr = xmlDocumentToStringBuffer(xmlNodeToDocument(pElement));
-      
-   return httpMessageStr;
-} /* DM_RemakeXMLBufferACS */
+  INFO("Configure the Connection Request Credentials");
+  INFO("CR username = %s", ((NULL != username) ? username : "None"));
 
+  updateDigestCredentials(username, password);
+}
 
 #endif /* _DM_COM_RPC_ACS_H_ */
@@ -0,0 +1,359 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_com_soap_reader.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_com_soap_reader.c
+ *
+ * @brief Pull parser used to read the SOAP messages received from the ACS
+ *
+ */
+
+#include "dm_com_soap_reader.h"
+#include "CMN_Trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define _BLANKS " \t\r\n"
+
+static DM_SoapReaderEvent _error(DM_SoapReader* reader, const char* msg UNUSED)
+{
+  EXEC_ERROR("Malformed SOAP message : %s", msg);
+  reader->error = true;
+  return DM_SoapReader_ERROR;
+}
+
+static bool _isBlank(const char* s, const char* end)
+{
+  while ((s < end) && (strchr(_BLANKS, *s) != NULL)) { s++; }
+  return (s == end);
+}
+
+/*
+ * Appends the UTF-8 encoding of the character c
+ */
+static char* _appendUtf8(char* dest, unsigned long c)
+{
+  if (c < 0x80) { *dest++ = (char)c; }
+  else if (c < 0x800) { *dest++ = (char)(0xC0 | (c >> 6)); *dest++ = (char)(0x80 | (c & 0x3F)); }
+  else if (c < 0x10000) { *dest++ = (char)(0xE0 | (c >> 12)); *dest++ = (char)(0x80 | ((c >> 6) & 0x3F)); *dest++ = (char)(0x80 | (c & 0x3F)); }
+  else { *dest++ = (char)(0xF0 | (c >> 18)); *dest++ = (char)(0x80 | ((c >> 12) & 0x3F)); *dest++ = (char)(0x80 | ((c >> 6) & 0x3F)); *dest++ = (char)(0x80 | (c & 0x3F)); }
+  return dest;
+}
+
+/*
+ * Copies the text with its entities (predefined ones and character references) decoded.
+ * As the decoded text is never longer than the raw one, the result is allocated once.
+ * An unknown entity is kept as is.
+ */
+static char* _decode(const char* s, size_t len)
+{
+  char* res = (char*)malloc(len + 1);
+  char* dest = res;
+  const char* end = s + len;
+  if (res == NULL) return NULL;
+  while (s < end)
+  {
+    const char* amp = memchr(s, '&', end - s);
+    if (amp == NULL) amp = end;
+    memcpy(dest, s, amp - s);
+    dest += amp - s;
+    s = amp;
+    if (s == end) break;
+
+    const char* semicolon = memchr(s, ';', end - s);
+    size_t entityLength = (semicolon == NULL ? 0 : (size_t)(semicolon - s) + 1);
+    if      ((entityLength == 4) && (strncasecmp(s, "&lt;", 4) == 0))   { *dest++ = '<'; }
+    else if ((entityLength == 4) && (strncasecmp(s, "&gt;", 4) == 0))   { *dest++ = '>'; }
+    else if ((entityLength == 5) && (strncasecmp(s, "&amp;", 5) == 0))  { *dest++ = '&'; }
+    else if ((entityLength == 6) && (strncasecmp(s, "&apos;", 6) == 0)) { *dest++ = '\''; }
+    else if ((entityLength == 6) && (strncasecmp(s, "&quot;", 6) == 0)) { *dest++ = '"'; }
+    else if ((entityLength > 3) && (s[1] == '#'))
+    {
+      char* numEnd = NULL;
+      unsigned long c = ((s[2] == 'x') || (s[2] == 'X') ? strtoul(s+3, &numEnd, 16) : strtoul(s+2, &numEnd, 10));
+      if ((numEnd != semicolon) || (c == 0) || (c > 0x10FFFF)) { entityLength = 0; }
+      // The UTF-8 encoding (at most 4 bytes) is never longer than the reference (at least 4 characters)
+      else { dest = _appendUtf8(dest, c); }
+    }
+    else { entityLength = 0; }
+
+    if (entityLength == 0) { *dest++ = '&'; s++; }
+    else { s += entityLength; }
+  }
+  *dest = '\0';
+  return res;
+}
+
+/**
+ * Initializes the reader
+ *
+ * @param reader Reader to initialize
+ * @param buffer Null-terminated message, not copied
+ */
+void DM_SoapReader_init(DM_SoapReader* reader, const char* buffer)
+{
+  memset((void*)reader, 0, sizeof(DM_SoapReader));
+  reader->pos = (buffer == NULL ? "" : buffer);
+}
+
+/**
+ * Reads the next event of the message. The comments, processing instructions and
+ * declarations (XML prolog, DOCTYPE) are skipped.
+ *
+ * @param reader Reader
+ *
+ * @return The event read
+ */
+DM_SoapReaderEvent DM_SoapReader_next(DM_SoapReader* reader)
+{
+  if (reader->error) return DM_SoapReader_ERROR;
+
+  if (reader->pendingEnd)
+  {
+    reader->pendingEnd = false;
+    reader->depth--;
+    return DM_SoapReader_END_ELEMENT;
+  }
+
+  for (;;)
+  {
+    const char* p = reader->pos;
+    const char* end;
+
+    if (*p == '\0')
+    {
+      return (reader->depth == 0 ? DM_SoapReader_EOF : _error(reader, "unexpected end"));
+    }
+
+    if (*p != '<')
+    {
+      // Character data, up to the next tag
+      end = strchr(p, '<');
+      if (end == NULL) end = p + strlen(p);
+      reader->pos = end;
+      if (_isBlank(p, end)) continue;
+      if (reader->depth == 0) return _error(reader, "text outside the root element");
+      reader->text = p;
+      reader->textLength = end - p;
+      reader->textIsCData = false;
+      return DM_SoapReader_TEXT;
+    }
+
+    if (strncmp(p, "<!--", 4) == 0)
+    {
+      end = strstr(p+4, "-->");
+      if (end == NULL) return _error(reader, "unterminated comment");
+      reader->pos = end + 3;
+      continue;
+    }
+
+    if (strncmp(p, "<![CDATA[", 9) == 0)
+    {
+      end = strstr(p+9, "]]>");
+      if (end == NULL) return _error(reader, "unterminated CDATA section");
+      if (reader->depth == 0) return _error(reader, "CDATA section outside the root element");
+      reader->pos = end + 3;
+      reader->text = p + 9;
+      reader->textLength = end - (p + 9);
+      reader->textIsCData = true;
+      return DM_SoapReader_TEXT;
+    }
+
+    if ((p[1] == '?') || (p[1] == '!'))
+    {
+      end = strchr(p, '>');
+      if (end == NULL) return _error(reader, "unterminated declaration");
+      reader->pos = end + 1;
+      continue;
+    }
+
+    if (p[1] == '/')
+    {
+      // End tag
+      const char* name = p + 2;
+      size_t len = strcspn(name, _BLANKS ">");
+      end = name + len;
+      end += strspn(end, _BLANKS);
+      if (*end != '>') return _error(reader, "invalid end tag");
+      if ((reader->depth == 0)
+       || (len != reader->openTagLengths[reader->depth-1])
+       || (strncmp(name, reader->openTags[reader->depth-1], len) != 0))
+      {
+        return _error(reader, "mismatched end tag");
+      }
+      reader->depth--;
+      reader->name = name;
+      reader->nameLength = len;
+      reader->pos = end + 1;
+      return DM_SoapReader_END_ELEMENT;
+    }
+
+    // Start tag
+    {
+      const char* name = p + 1;
+      size_t len = strcspn(name, _BLANKS "/>");
+      const char* q = name + len;
+      if (len == 0) return _error(reader, "invalid start tag");
+      if ((reader->depth == 0) && (reader->openTags[0] != NULL)) return _error(reader, "several root elements");
+      if (reader->depth >= DM_SOAP_READER_MAX_DEPTH) return _error(reader, "elements too deeply nested");
+
+      // Look for the end of the tag, the attribute values may contain '>'
+      while ((*q != '\0') && (*q != '>'))
+      {
+        if ((*q == '"') || (*q == '\''))
+        {
+          q = strchr(q+1, *q);
+          if (q == NULL) return _error(reader, "unterminated attribute value");
+        }
+        q++;
+      }
+      if (*q == '\0') return _error(reader, "unterminated start tag");
+
+      reader->pendingEnd = (q[-1] == '/');
+      reader->name = name;
+      reader->nameLength = len;
+      reader->attributes = name + len;
+      reader->attributesLength = (reader->pendingEnd ? q - 1 : q) - reader->attributes;
+      reader->openTags[reader->depth] = name;
+      reader->openTagLengths[reader->depth] = len;
+      reader->depth++;
+      reader->pos = q + 1;
+      return DM_SoapReader_START_ELEMENT;
+    }
+  }
+}
+
+/**
+ * Tells if the current element has the given name (with its prefix, if any)
+ *
+ * @param reader Reader, after a START_ELEMENT or END_ELEMENT event
+ * @param name Qualified name
+ *
+ * @return true if the name matches
+ */
+bool DM_SoapReader_isElement(const DM_SoapReader* reader, const char* name)
+{
+  return (reader->name != NULL) && (strlen(name) == reader->nameLength) && (strncmp(reader->name, name, reader->nameLength) == 0);
+}
+
+/**
+ * Gives the value of an attribute of the current start tag
+ *
+ * @param reader Reader, after a START_ELEMENT event
+ * @param name Qualified name of the attribute
+ *
+ * @return The decoded value, to be freed by the caller, or NULL if the attribute is not found
+ */
+char* DM_SoapReader_getAttribute(const DM_SoapReader* reader, const char* name)
+{
+  const char* p = reader->attributes;
+  const char* end = p + reader->attributesLength;
+  size_t nameLength = strlen(name);
+
+  while (p < end)
+  {
+    p += strspn(p, _BLANKS);
+    if (p >= end) break;
+
+    const char* attrName = p;
+    size_t attrNameLength = strcspn(p, _BLANKS "=");
+    p += attrNameLength;
+    p += strspn(p, _BLANKS);
+    if ((p >= end) || (*p != '=')) break;
+    p++;
+    p += strspn(p, _BLANKS);
+    if ((p >= end) || ((*p != '"') && (*p != '\''))) break;
+
+    const char* value = p + 1;
+    const char* valueEnd = memchr(value, *p, end - value);
+    if (valueEnd == NULL) break;
+    if ((attrNameLength == nameLength) && (strncmp(attrName, name, nameLength) == 0))
+    {
+      return _decode(value, valueEnd - value);
+    }
+    p = valueEnd + 1;
+  }
+  return NULL;
+}
+
+/**
+ * Gives the text of the current TEXT event
+ *
+ * @param reader Reader, after a TEXT event
+ *
+ * @return The decoded text, to be freed by the caller
+ */
+char* DM_SoapReader_getText(const DM_SoapReader* reader)
+{
+  return (reader->textIsCData ? DM_ENG_strndup(reader->text, reader->textLength) : _decode(reader->text, reader->textLength));
+}
+
+/**
+ * Reads the content of the current element, up to its end tag. As with the DOM, the
+ * text taken is the one of the first child : NULL if the element is empty or begins
+ * with a child element.
+ *
+ * @param reader Reader, after a START_ELEMENT event
+ * @param pText Decoded text, to be freed by the caller
+ *
+ * @return true if the element has been read, false if the message is malformed
+ */
+bool DM_SoapReader_readElementText(DM_SoapReader* reader, char** pText)
+{
+  int depth = reader->depth;
+  bool firstChild = true;
+
+  *pText = NULL;
+  for (;;)
+  {
+    DM_SoapReaderEvent event = DM_SoapReader_next(reader);
+    if ((event == DM_SoapReader_ERROR) || (event == DM_SoapReader_EOF))
+    {
+      DM_ENG_FREE(*pText);
+      return false;
+    }
+    if ((event == DM_SoapReader_END_ELEMENT) && (reader->depth < depth)) return true;
+    if (firstChild && (event == DM_SoapReader_TEXT)) { *pText = DM_SoapReader_getText(reader); }
+    firstChild = false;
+  }
+}
+
+/**
+ * Skips the current element and all its content
+ *
+ * @param reader Reader, after a START_ELEMENT event
+ *
+ * @return true if the element has been skipped, false if the message is malformed
+ */
+bool DM_SoapReader_skipElement(DM_SoapReader* reader)
+{
+  int depth = reader->depth;
+
+  for (;;)
+  {
+    DM_SoapReaderEvent event = DM_SoapReader_next(reader);
+    if ((event == DM_SoapReader_ERROR) || (event == DM_SoapReader_EOF)) return false;
+    if ((event == DM_SoapReader_END_ELEMENT) && (reader->depth < depth)) return true;
+  }
+}
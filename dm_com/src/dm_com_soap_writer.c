@@ -0,0 +1,332 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_com_soap_writer.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_com_soap_writer.c
+ *
+ * @brief Streaming XML writer used to build the SOAP messages sent by the CPE
+ *
+ */
+
+#include "dm_com_soap_writer.h"
+#include "CMN_Trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define _INITIAL_CAPACITY (4096)
+
+#define _XML_PROLOG "<?xml version=\"1.0\"?>\r\n"
+#define _CRLF "\r\n"
+
+static bool _reserve(DM_SoapWriter* writer, size_t len)
+{
+  if (writer->error) return false;
+  if ((writer->length + len + 1 > writer->capacity) && (writer->readOffset > 0))
+  {
+    // Drop the text already read before growing the buffer
+    writer->length -= writer->readOffset;
+    memmove(writer->buffer, writer->buffer + writer->readOffset, writer->length + 1); // with the '\0'
+    writer->readOffset = 0;
+  }
+  if (writer->length + len + 1 > writer->capacity)
+  {
+    size_t newCapacity = (writer->capacity == 0 ? _INITIAL_CAPACITY : writer->capacity);
+    while (writer->length + len + 1 > newCapacity) { newCapacity *= 2; }
+    char* newBuffer = (char*)realloc(writer->buffer, newCapacity);
+    if (newBuffer == NULL)
+    {
+      EXEC_ERROR("Unable to grow the SOAP buffer to %lu bytes", (unsigned long)newCapacity);
+      writer->error = true;
+      return false;
+    }
+    writer->buffer = newBuffer;
+    writer->capacity = newCapacity;
+  }
+  return true;
+}
+
+static void _append(DM_SoapWriter* writer, const char* s, size_t len)
+{
+  if (_reserve(writer, len))
+  {
+    memcpy(writer->buffer + writer->length, s, len);
+    writer->length += len;
+    writer->buffer[writer->length] = '\0';
+  }
+}
+
+static void _appendStr(DM_SoapWriter* writer, const char* s)
+{
+  _append(writer, s, strlen(s));
+}
+
+/*
+ * Appends the string with the 5 XML special characters replaced by their entities.
+ * The runs of characters which need no escaping are copied in one go.
+ */
+static void _appendEscaped(DM_SoapWriter* writer, const char* s)
+{
+  if (s == NULL) return;
+  while (*s != '\0')
+  {
+    size_t span = strcspn(s, "<>&'\"");
+    if (span > 0) { _append(writer, s, span); s += span; }
+    switch (*s)
+    {
+      case '<'  : _append(writer, "&lt;", 4); break;
+      case '>'  : _append(writer, "&gt;", 4); break;
+      case '&'  : _append(writer, "&amp;", 5); break;
+      case '\'' : _append(writer, "&apos;", 6); break;
+      case '"'  : _append(writer, "&quot;", 6); break;
+      default   : return; // end of string
+    }
+    s++;
+  }
+}
+
+/*
+ * Terminates the pending start tag. Like ixml, a line break follows it only when
+ * its first child is an element, except for the root element.
+ */
+static void _closeStartTag(DM_SoapWriter* writer, bool childElement)
+{
+  if (writer->startTagOpen)
+  {
+    _appendStr(writer, (childElement && (writer->depth > 1)) ? ">" _CRLF : ">");
+    writer->startTagOpen = false;
+  }
+}
+
+/**
+ * Initializes the writer and writes the XML prolog
+ *
+ * @param writer Writer to initialize
+ */
+void DM_SoapWriter_init(DM_SoapWriter* writer)
+{
+  memset((void*)writer, 0, sizeof(DM_SoapWriter));
+  _appendStr(writer, _XML_PROLOG);
+}
+
+/**
+ * Opens a new element, child of the current one
+ *
+ * @param writer Writer
+ * @param name Tag name (not copied, must remain valid until the element is closed)
+ */
+void DM_SoapWriter_startElement(DM_SoapWriter* writer, const char* name)
+{
+  if (writer->error) return;
+  if (writer->depth >= DM_SOAP_WRITER_MAX_DEPTH)
+  {
+    EXEC_ERROR("SOAP element %s too deeply nested", name);
+    writer->error = true;
+    return;
+  }
+  _closeStartTag(writer, true);
+  _appendStr(writer, "<");
+  _appendStr(writer, name);
+  writer->openTags[writer->depth++] = name;
+  writer->startTagOpen = true;
+}
+
+/**
+ * Adds an attribute to the element just opened
+ *
+ * @param writer Writer
+ * @param name Attribute name
+ * @param value Attribute value (escaped by the writer)
+ */
+void DM_SoapWriter_addAttribute(DM_SoapWriter* writer, const char* name, const char* value)
+{
+  if (writer->error) return;
+  if (!writer->startTagOpen)
+  {
+    EXEC_ERROR("SOAP attribute %s added outside a start tag", name);
+    writer->error = true;
+    return;
+  }
+  _appendStr(writer, " ");
+  _appendStr(writer, name);
+  _appendStr(writer, "=\"");
+  _appendEscaped(writer, value);
+  _appendStr(writer, "\"");
+}
+
+/**
+ * Adds a text content to the current element
+ *
+ * @param writer Writer
+ * @param text Text (escaped by the writer), NULL is allowed and gives an empty content
+ */
+void DM_SoapWriter_addText(DM_SoapWriter* writer, const char* text)
+{
+  if (writer->error) return;
+  _closeStartTag(writer, false);
+  _appendEscaped(writer, text);
+}
+
+/**
+ * Closes the current element
+ *
+ * @param writer Writer
+ */
+void DM_SoapWriter_endElement(DM_SoapWriter* writer)
+{
+  if (writer->error) return;
+  if (writer->depth == 0)
+  {
+    EXEC_ERROR("No SOAP element to close");
+    writer->error = true;
+    return;
+  }
+  _closeStartTag(writer, false);
+  writer->depth--;
+  _appendStr(writer, "</");
+  _appendStr(writer, writer->openTags[writer->depth]);
+  _appendStr(writer, (writer->depth > 0) ? ">" _CRLF : ">");
+}
+
+/**
+ * Writes a whole element with a text content
+ *
+ * @param writer Writer
+ * @param name Tag name
+ * @param text Text (escaped by the writer), NULL is allowed and gives an empty element
+ */
+void DM_SoapWriter_addElement(DM_SoapWriter* writer, const char* name, const char* text)
+{
+  DM_SoapWriter_startElement(writer, name);
+  DM_SoapWriter_addText(writer, text);
+  DM_SoapWriter_endElement(writer);
+}
+
+/**
+ * Appends attributes already serialized by a writer to the element just opened
+ *
+ * @param writer Writer
+ * @param attributes Attributes (with their leading space), written as is
+ */
+void DM_SoapWriter_addRawAttributes(DM_SoapWriter* writer, const char* attributes)
+{
+  if (writer->error) return;
+  if (!writer->startTagOpen)
+  {
+    EXEC_ERROR("SOAP attributes added outside a start tag");
+    writer->error = true;
+    return;
+  }
+  _appendStr(writer, attributes);
+}
+
+/**
+ * Appends whole elements already serialized by a writer (at the same depth, with their
+ * line breaks) to the content of the current element
+ *
+ * @param writer Writer
+ * @param elements Elements, written as is
+ */
+void DM_SoapWriter_addRawElements(DM_SoapWriter* writer, const char* elements)
+{
+  if (writer->error) return;
+  _closeStartTag(writer, true);
+  _appendStr(writer, elements);
+}
+
+/**
+ * Gives the written message to the caller
+ *
+ * @param writer Writer, reset by the call
+ *
+ * @return The message, to be freed by the caller, or NULL if an error occurred or if some element is still open
+ */
+char* DM_SoapWriter_detachBuffer(DM_SoapWriter* writer)
+{
+  char* res = NULL;
+  if (writer->depth != 0)
+  {
+    EXEC_ERROR("SOAP element %s not closed", writer->openTags[writer->depth-1]);
+  }
+  else if (!writer->error)
+  {
+    if (writer->readOffset > 0)
+    {
+      memmove(writer->buffer, writer->buffer + writer->readOffset, writer->length - writer->readOffset + 1);
+    }
+    res = writer->buffer;
+    writer->buffer = NULL;
+  }
+  DM_SoapWriter_free(writer);
+  return res;
+}
+
+/**
+ * Gives the number of bytes written and not yet read
+ *
+ * @param writer Writer
+ *
+ * @return The number of bytes which DM_SoapWriter_read() can still give
+ */
+size_t DM_SoapWriter_pendingLength(DM_SoapWriter* writer)
+{
+  return writer->length - writer->readOffset;
+}
+
+/**
+ * Copies the beginning of the text written and not yet read, then moves the read offset past it
+ *
+ * @param writer Writer
+ * @param dest Destination of the text (not null-terminated)
+ * @param size Maximum number of bytes to copy
+ *
+ * @return The number of bytes copied into dest
+ */
+size_t DM_SoapWriter_read(DM_SoapWriter* writer, char* dest, size_t size)
+{
+  size_t len = DM_SoapWriter_pendingLength(writer);
+  if (len > size) { len = size; }
+  if (len > 0)
+  {
+    memcpy(dest, writer->buffer + writer->readOffset, len);
+    writer->readOffset += len;
+    if (writer->readOffset == writer->length)
+    {
+      // Everything read : the buffer is reused from its beginning
+      writer->length = 0;
+      writer->readOffset = 0;
+      writer->buffer[0] = '\0';
+    }
+  }
+  return len;
+}
+
+/**
+ * Releases the writer buffer
+ *
+ * @param writer Writer
+ */
+void DM_SoapWriter_free(DM_SoapWriter* writer)
+{
+  free(writer->buffer);
+  memset((void*)writer, 0, sizeof(DM_SoapWriter));
+}
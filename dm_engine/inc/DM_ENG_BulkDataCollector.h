@@ -0,0 +1,54 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : DM_ENG_BulkDataCollector.h
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file DM_ENG_BulkDataCollector.h
+ *
+ * @brief Bulk data collection : periodic push of parameter sets (typically the statistics) to a collection server by HTTP POST
+ *
+ * The profiles are configured in the data model under DM_ENG_BULK_DATA_OBJECT_NAME :
+ *
+ *   X_ORANGE-COM_BulkData.Enable
+ *   X_ORANGE-COM_BulkData.Profile.{i}.Enable
+ *   X_ORANGE-COM_BulkData.Profile.{i}.EncodingType         "CSV" (default) or "JSON"
+ *   X_ORANGE-COM_BulkData.Profile.{i}.ReportingInterval    in seconds
+ *   X_ORANGE-COM_BulkData.Profile.{i}.TimeReference        reference date for the reporting times
+ *   X_ORANGE-COM_BulkData.Profile.{i}.URL
+ *   X_ORANGE-COM_BulkData.Profile.{i}.Username
+ *   X_ORANGE-COM_BulkData.Profile.{i}.Password
+ *   X_ORANGE-COM_BulkData.Profile.{i}.ParameterReferences  comma separated list of parameter names or partial paths (ending with '.')
+ *
+ */
+
+#ifndef _DM_ENG_BULK_DATA_COLLECTOR_H_
+#define _DM_ENG_BULK_DATA_COLLECTOR_H_
+
+#include "DM_ENG_Common.h"
+#include "DM_ENG_ComputedExp.h"
+
+void DM_ENG_BulkDataCollector_init(DM_ENG_F_GET_VALUE getValue);
+void DM_ENG_BulkDataCollector_exit();
+void DM_ENG_BulkDataCollector_join();
+void DM_ENG_BulkDataCollector_restart();
+
+#endif /*_DM_ENG_BULK_DATA_COLLECTOR_H_*/
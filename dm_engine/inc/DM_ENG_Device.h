@@ -166,6 +166,20 @@ int DM_ENG_Device_download(char* fileType, char* url, char* username, char* pass
  */
 int DM_ENG_Device_upload(char* fileType, char* url, char* username, char* password, unsigned int transferId);
 
+/**
+ * Pushes a bulk data report to a collection server. This call is synchronous and is never done under the DM lock.
+ * 
+ * @param url URL of the collection server
+ * @param username Username to be used by the CPE to authenticate with the collection server
+ * @param password Password to be used by the CPE to authenticate with the collection server
+ * @param contentType MIME type of the report (ex: "text/csv")
+ * @param data Report content
+ * @param dataSize Size of the report in bytes
+ * 
+ * @return 0 if OK, else an error code (HTTP status or negative value for transport errors)
+ */
+int DM_ENG_Device_postData(const char* url, const char* username, const char* password, const char* contentType, const char* data, size_t dataSize);
+
 /**
  * Prepares the collection of statistics identified by the objName. As appropriate, the data will be collected in polling mode (periodic calls
  * to the DM_ENG_Device_getSampleData() function by the DM Engine) or or by events notified to the DM Engine (callback DM_ENG_ParameterManager_sampleData()). 
@@ -192,6 +206,8 @@ int DM_ENG_Device_stopSampling(const char* objName);
  * 
  * @param timeStampBefore Data for this time stamp are already passed. They should not be provided again.
  * If no new data are available, no new DM_ENG_SampleDataStruct is created. A non zero code (1) is returned.
+ *
+ * N.B. This function is called without the DM lock, and may be called concurrently for different objects.
  */
 int DM_ENG_Device_getSampleData(const char* objName, time_t timeStampBefore, const char* data, OUT DM_ENG_SampleDataStruct** pSampleData);
 
@@ -51,6 +51,9 @@ extern const char* DM_ENG_DEVICE_MANUFACTURER_OUI_NAME;
 extern const char* DM_ENG_DEVICE_PRODUCT_CLASS_NAME;
 extern const char* DM_ENG_DEVICE_SERIAL_NUMBER_NAME;
 
+extern const char* DM_ENG_BULK_DATA_OBJECT_NAME;
+extern const char* DM_ENG_STATS_CHECKPOINT_INTERVAL_NAME;
+
 // Standard values for DeviceInfo.DeviceStatus (N.B. "Down" is implicit)
 #define DM_ENG_DEVICE_STATUS_DOWN          "Down"
 #define DM_ENG_DEVICE_STATUS_UP            "Up"
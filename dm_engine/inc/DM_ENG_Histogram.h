@@ -0,0 +1,68 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : DM_ENG_Histogram.h
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file DM_ENG_Histogram.h
+ *
+ * @brief Histogram kept in native form (parsed bucket boundaries and integer counts) for the statistics module
+ *
+ */
+
+#ifndef _DM_ENG_HISTOGRAM_H_
+#define _DM_ENG_HISTOGRAM_H_
+
+#include "DM_ENG_Common.h"
+
+/**
+ * Histogram Structure
+ *
+ * bounds[i] is the upper bound (inclusive) of the bucket i. The bounds are stored as a non-decreasing array
+ * so that the bucket selection is done by binary search.
+ */
+typedef struct _DM_ENG_Histogram
+{
+   char* name;
+   char* definition;
+   unsigned int* bounds;
+   unsigned int* counts;
+   int nbIntervals;
+   char* value;
+   struct _DM_ENG_Histogram* next;
+
+} __attribute((packed)) DM_ENG_Histogram;
+
+DM_ENG_Histogram* DM_ENG_newHistogram(const char* name, const char* def, unsigned int bounds[], int nbIntervals);
+void DM_ENG_deleteHistogram(DM_ENG_Histogram* histo);
+void DM_ENG_addHistogram(DM_ENG_Histogram** pHisto, DM_ENG_Histogram* newHisto);
+void DM_ENG_deleteAllHistogram(DM_ENG_Histogram** pHisto);
+DM_ENG_Histogram* DM_ENG_Histogram_find(DM_ENG_Histogram* histo, const char* name);
+
+void DM_ENG_Histogram_setBounds(DM_ENG_Histogram* histo, const char* def, unsigned int bounds[], int nbIntervals);
+void DM_ENG_Histogram_reset(DM_ENG_Histogram* histo);
+void DM_ENG_Histogram_setCounts(DM_ENG_Histogram* histo, const char* value);
+int DM_ENG_Histogram_getInterval(DM_ENG_Histogram* histo, unsigned int value);
+void DM_ENG_Histogram_addSample(DM_ENG_Histogram* histo, unsigned int value);
+void DM_ENG_Histogram_addSamples(DM_ENG_Histogram* histo, unsigned int values[], int nbValues);
+const char* DM_ENG_Histogram_getValue(DM_ENG_Histogram* histo);
+
+#endif
@@ -52,6 +52,7 @@ typedef int (*DM_ENG_F_INFORM)(DM_ENG_DeviceIdStruct* id, DM_ENG_EventStruct* ev
 typedef int (*DM_ENG_F_TRANSFER_COMPLETE)(DM_ENG_TransferCompleteStruct* tcs);
 typedef int (*DM_ENG_F_REQUEST_DOWNLOAD)(const char* fileType, DM_ENG_ArgStruct* args[]);
 typedef void (*DM_ENG_F_UPDATE_ACS_PARAMETERS)(char* url, char* username, char* password);
+typedef void (*DM_ENG_F_UPDATE_CONNECTION_REQUEST_CREDENTIALS)(char* username, char* password);
 
 typedef struct _DM_ENG_NotificationInterface
 {
@@ -67,10 +68,12 @@ void DM_ENG_NotificationInterface_activate(DM_ENG_EntityType entity,
    DM_ENG_F_INFORM inform,
    DM_ENG_F_TRANSFER_COMPLETE transferComplete,
    DM_ENG_F_REQUEST_DOWNLOAD requestDownload,
-   DM_ENG_F_UPDATE_ACS_PARAMETERS updateAcsParameters);
+   DM_ENG_F_UPDATE_ACS_PARAMETERS updateAcsParameters,
+   DM_ENG_F_UPDATE_CONNECTION_REQUEST_CREDENTIALS updateConnectionRequestCredentials);
 void DM_ENG_NotificationInterface_deactivate(DM_ENG_EntityType entity);
 void DM_ENG_NotificationInterface_deactivateAll();
 void DM_ENG_NotificationInterface_updateAcsParameters();
+void DM_ENG_NotificationInterface_updateConnectionRequestCredentials();
 bool DM_ENG_NotificationInterface_isReady();
 void DM_ENG_NotificationInterface_setKnownParameterList(DM_ENG_EntityType entity, DM_ENG_ParameterValueStruct* parameterList[]);
 void DM_ENG_NotificationInterface_clearKnownParameters(DM_ENG_EntityType entity);
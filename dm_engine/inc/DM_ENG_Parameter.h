@@ -97,6 +97,11 @@ void DM_ENG_Parameter_commit(DM_ENG_Parameter* param);
 bool DM_ENG_Parameter_cancelChange(DM_ENG_Parameter* param);
 
 void DM_ENG_Parameter_updateValue(DM_ENG_Parameter* param, char* value, bool newValue);
+void DM_ENG_Parameter_markStatsValue(DM_ENG_Parameter* param);
+void DM_ENG_Parameter_updateStatsValue(DM_ENG_Parameter* param, char* value, bool newValue);
+bool DM_ENG_Parameter_isStatsValue(DM_ENG_Parameter* param);
+int DM_ENG_Parameter_getStatsState(DM_ENG_Parameter* param);
+void DM_ENG_Parameter_restoreStatsState(DM_ENG_Parameter* param, int state);
 void DM_ENG_Parameter_resetValue(DM_ENG_Parameter* param);
 void DM_ENG_Parameter_markLoaded(DM_ENG_Parameter* param, bool withValues);
 void DM_ENG_Parameter_clearTemporaryValue(DM_ENG_Parameter* param, int level);
@@ -107,6 +112,8 @@ void DM_ENG_addParameter(DM_ENG_Parameter** pParam, DM_ENG_Parameter* newParam);
 
 bool DM_ENG_Parameter_isDataChanged();
 void DM_ENG_Parameter_setDataChanged(bool changed);
+bool DM_ENG_Parameter_isStatsDataChanged();
+void DM_ENG_Parameter_setStatsDataChanged(bool changed);
 
 void DM_ENG_Parameter_markBeingEvaluated(DM_ENG_Parameter* param);
 void DM_ENG_Parameter_unmarkBeingEvaluated(DM_ENG_Parameter* param);
@@ -102,6 +102,14 @@ void DM_ENG_ParameterData_resumeParameterLoopFrom(char* resumeName);
  */
 DM_ENG_Parameter* DM_ENG_ParameterData_getCurrent();
 
+/**
+ * Returns a number changed each time parameters are added to or removed from the data. A pointer on a parameter
+ * remains valid as long as this number is unchanged.
+ * 
+ * @return The current version of the data structure
+ */
+unsigned int DM_ENG_ParameterData_getStructureVersion();
+
 /**
  * Gets a parameter by its name
  * 
@@ -318,6 +326,12 @@ int DM_ENG_ParameterData_incRetryCount();
  */
 void DM_ENG_ParameterData_sync();
 
+/**
+ * Saves the statistics values (parameters marked by DM_ENG_Parameter_updateStatsValue) in their own store if they changed.
+ * The DM Engine invokes this function on its own checkpoint interval so that the sampling does not rewrite the whole data.
+ */
+void DM_ENG_ParameterData_syncStatistics();
+
 /**
  * Restore the data as they were previously saved by a sync call (and discard the changes since this point) 
  */
@@ -43,6 +43,7 @@
 
 int DM_ENG_ParameterManager_getNumberOfParameters();
 DM_ENG_Parameter* DM_ENG_ParameterManager_getParameter(const char* name);
+unsigned int DM_ENG_ParameterManager_getStructureVersion();
 DM_ENG_Parameter* DM_ENG_ParameterManager_getFirstParameter();
 DM_ENG_Parameter* DM_ENG_ParameterManager_getNextParameter();
 char* DM_ENG_ParameterManager_getFirstParameterName();
@@ -58,9 +59,12 @@ void DM_ENG_ParameterManager_updateParameterNames(const char* name, DM_ENG_Param
 void DM_ENG_ParameterManager_updateParameterValues(DM_ENG_ParameterValueStruct* parameterList[]);
 int DM_ENG_ParameterManager_getParameterValue(const char* name, OUT char** pValue);
 int DM_ENG_ParameterManager_setParameterValue(DM_ENG_EntityType entity, const char* name, DM_ENG_ParameterType type, char* value, OUT DM_ENG_ParameterStatus* pResult, OUT char** pSysName, OUT char** pData);
+int DM_ENG_ParameterManager_setResolvedParameterValue(DM_ENG_EntityType entity, DM_ENG_Parameter* param, const char* name, DM_ENG_ParameterType type, char* value, OUT DM_ENG_ParameterStatus* pResult, OUT char** pSysName, OUT char** pData);
 void DM_ENG_ParameterManager_setParameterKey(char* parameterKey);
 void DM_ENG_ParameterManager_commitParameter(const char* name);
+void DM_ENG_ParameterManager_commitResolvedParameter(DM_ENG_Parameter* param, const char* name);
 void DM_ENG_ParameterManager_unsetParameter(const char* name);
+void DM_ENG_ParameterManager_unsetResolvedParameter(DM_ENG_Parameter* param, const char* name);
 int DM_ENG_ParameterManager_addObject(DM_ENG_EntityType entity, char* objectName, OUT unsigned int* pInstanceNumber, OUT DM_ENG_ParameterStatus* pStatus);
 int DM_ENG_ParameterManager_deleteObject(DM_ENG_EntityType entity, char* objectName, OUT DM_ENG_ParameterStatus* pStatus);
 
@@ -0,0 +1,74 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : DM_ENG_QuantileSketch.h
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file DM_ENG_QuantileSketch.h
+ *
+ * @brief Mergeable quantile sketch with bounded memory, used by the statistics module to compute percentiles
+ *
+ */
+
+#ifndef _DM_ENG_QUANTILE_SKETCH_H_
+#define _DM_ENG_QUANTILE_SKETCH_H_
+
+#include "DM_ENG_Common.h"
+
+
+/**
+ * Quantile Sketch Structure
+ *
+ * The sample values are counted in log-linear buckets (each power of 2 is split into DM_ENG_QuantileSketch_SUB_BUCKETS
+ * buckets), so that the relative error on a quantile is bounded whatever the range of the values.
+ * counts[i] is the count of the bucket of index (firstIndex+i). At most DM_ENG_QuantileSketch_MAX_BUCKETS buckets are kept:
+ * when the range of the values is wider, the lowest buckets are collapsed, which preserves the accuracy of the high quantiles.
+ */
+typedef struct _DM_ENG_QuantileSketch
+{
+   char* name;
+   int firstIndex;
+   int nbBuckets;
+   unsigned int* counts;
+   unsigned int count;
+   char* value;
+   struct _DM_ENG_QuantileSketch* next;
+
+} __attribute((packed)) DM_ENG_QuantileSketch;
+
+#define DM_ENG_QuantileSketch_SUB_BUCKETS 16
+#define DM_ENG_QuantileSketch_MAX_BUCKETS 256
+
+DM_ENG_QuantileSketch* DM_ENG_newQuantileSketch(const char* name);
+void DM_ENG_deleteQuantileSketch(DM_ENG_QuantileSketch* sketch);
+void DM_ENG_addQuantileSketch(DM_ENG_QuantileSketch** pSketch, DM_ENG_QuantileSketch* newSketch);
+void DM_ENG_deleteAllQuantileSketch(DM_ENG_QuantileSketch** pSketch);
+DM_ENG_QuantileSketch* DM_ENG_QuantileSketch_find(DM_ENG_QuantileSketch* sketch, const char* name);
+
+void DM_ENG_QuantileSketch_reset(DM_ENG_QuantileSketch* sketch);
+void DM_ENG_QuantileSketch_setValue(DM_ENG_QuantileSketch* sketch, const char* value);
+void DM_ENG_QuantileSketch_addSample(DM_ENG_QuantileSketch* sketch, unsigned int value);
+void DM_ENG_QuantileSketch_addSamples(DM_ENG_QuantileSketch* sketch, unsigned int values[], int nbValues);
+void DM_ENG_QuantileSketch_merge(DM_ENG_QuantileSketch* sketch, DM_ENG_QuantileSketch* other);
+bool DM_ENG_QuantileSketch_getQuantile(DM_ENG_QuantileSketch* sketch, unsigned int percent, unsigned int* pRes);
+const char* DM_ENG_QuantileSketch_getValue(DM_ENG_QuantileSketch* sketch);
+
+#endif
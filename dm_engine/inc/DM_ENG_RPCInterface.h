@@ -59,7 +59,8 @@ int DM_ENG_Reboot(DM_ENG_EntityType entity, char* commandKey);
 int DM_ENG_FactoryReset(DM_ENG_EntityType entity);
 int DM_ENG_GetAllQueuedTransfers(DM_ENG_EntityType entity, OUT DM_ENG_AllQueuedTransferStruct** pResult[]);
 
-void DM_ENG_ActivateNotification(DM_ENG_EntityType entity, DM_ENG_F_INFORM inform, DM_ENG_F_TRANSFER_COMPLETE transferComplete, DM_ENG_F_REQUEST_DOWNLOAD requestDownload, DM_ENG_F_UPDATE_ACS_PARAMETERS updateAcsParameters);
+void DM_ENG_ActivateNotification(DM_ENG_EntityType entity, DM_ENG_F_INFORM inform, DM_ENG_F_TRANSFER_COMPLETE transferComplete, DM_ENG_F_REQUEST_DOWNLOAD requestDownload, DM_ENG_F_UPDATE_ACS_PARAMETERS updateAcsParameters,
+   DM_ENG_F_UPDATE_CONNECTION_REQUEST_CREDENTIALS updateConnectionRequestCredentials);
 void DM_ENG_DeactivateNotification(DM_ENG_EntityType entity);
 void DM_ENG_SessionOpened(DM_ENG_EntityType entity);
 bool DM_ENG_IsReadyToClose(DM_ENG_EntityType entity);
@@ -0,0 +1,547 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : DM_ENG_BulkDataCollector.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file DM_ENG_BulkDataCollector.c
+ *
+ * @brief Bulk data collection : periodic push of parameter sets (typically the statistics) to a collection server by HTTP POST
+ *
+ * The values are read with the same getter as the StatisticsModule, so that the statistics parameters are reported
+ * as last computed by the sampling. The report is built under the DM lock, in one pass, in a single buffer. The HTTP POST
+ * is done by the Device Adapter once the DM lock has been released.
+ */
+
+#include "DM_ENG_BulkDataCollector.h"
+#include "DM_ENG_Global.h"
+#include "DM_ENG_ParameterData.h"
+#include "DM_ENG_ParameterManager.h"
+#include "DM_ENG_ParameterValueStruct.h"
+#include "DM_ENG_Device.h"
+#include "DM_CMN_Thread.h"
+#include "CMN_Trace.h"
+#include <ctype.h>
+#include <sys/time.h>
+
+static const char* _ENABLE_NAME               = "Enable";
+static const char* _PROFILE_NODE              = "Profile.";
+static const char* _ENCODING_TYPE_NAME        = "EncodingType";
+static const char* _REPORTING_INTERVAL_NAME   = "ReportingInterval";
+static const char* _TIME_REFERENCE_NAME       = "TimeReference";
+static const char* _URL_NAME                  = "URL";
+static const char* _USERNAME_NAME             = "Username";
+static const char* _PASSWORD_NAME             = "Password";
+static const char* _PARAMETER_REFERENCES_NAME = "ParameterReferences";
+
+static const char* _ENCODING_JSON             = "JSON";
+static const char* _CSV_CONTENT_TYPE          = "text/csv; charset=UTF-8";
+static const char* _JSON_CONTENT_TYPE         = "application/json; charset=UTF-8";
+static const char* _INTERNAL_SEPARATOR        = "!";
+
+static unsigned int _REPORTING_INTERVAL_DEFAULT = 86400; // 1 day (cf. TR-232)
+static size_t _INITIAL_REPORT_SIZE              = 1024;
+
+/**
+ * Report buffer, grown geometrically so that the encoding is done in one pass
+ */
+typedef struct _BulkDataReport
+{
+   char* data;
+   size_t size;
+   size_t capacity;
+
+} __attribute((packed)) BulkDataReport;
+
+static DM_ENG_ParameterValueStruct* _profiles = NULL; // name of the enabled profiles, with the next reporting time in the timestamp field
+static DM_CMN_ThreadId_t _collectorThreadId = 0;
+static DM_CMN_Mutex_t _collectorMutex = NULL;
+static DM_CMN_Cond_t _collectorCond = NULL;
+static bool _profilesChanged = false;
+
+static DM_ENG_F_GET_VALUE _getValue = NULL;
+
+enum _CollectorStatus
+{
+   _INITIAL = 0,
+   _RUNNING,
+   _EXITING
+
+} _collectorStatus = 0;
+
+static void _signalCollector();
+
+/*
+ * Current time read from the precise clock : time() may lag behind the clock used by the timed wait
+ * and the reporting time would then be seen as not reached yet just after the wait ends.
+ */
+static time_t _currentTime()
+{
+   struct timeval now;
+   gettimeofday(&now, NULL);
+   return now.tv_sec;
+}
+
+static DM_ENG_Parameter* _getProfileParameter(const char* profileName, const char* paramName)
+{
+   char* fullName = (char*) malloc(strlen(profileName)+strlen(paramName)+1);
+   strcpy(fullName, profileName);
+   strcat(fullName, paramName);
+   DM_ENG_Parameter* prm = DM_ENG_ParameterData_getParameter(fullName);
+   free(fullName);
+   return prm;
+}
+
+static char* _getProfileValue(const char* profileName, const char* paramName)
+{
+   DM_ENG_Parameter* prm = _getProfileParameter(profileName, paramName);
+   return (prm == NULL ? NULL : prm->value);
+}
+
+static bool _isEnabled(const char* objName)
+{
+   bool enabled = false;
+   char* value = _getProfileValue(objName, _ENABLE_NAME);
+   if (value != NULL) { DM_ENG_stringToBool(value, &enabled); }
+   return enabled;
+}
+
+/*
+ * Computes the first reporting time after now, aligned on the TimeReference if any
+ */
+static time_t _computeNextReportTime(const char* profileName, time_t now)
+{
+   unsigned int interval = _REPORTING_INTERVAL_DEFAULT;
+   char* value = _getProfileValue(profileName, _REPORTING_INTERVAL_NAME);
+   if ((value != NULL) && (!DM_ENG_stringToUint(value, &interval) || (interval == 0))) { interval = _REPORTING_INTERVAL_DEFAULT; }
+
+   time_t timeRef = 0;
+   value = _getProfileValue(profileName, _TIME_REFERENCE_NAME);
+   if (value != NULL) { DM_ENG_dateStringToTime(value, &timeRef); }
+
+   time_t next = now + interval;
+   if ((timeRef > 0) && (timeRef != now))
+   {
+      if (timeRef < now) { next -= (now-timeRef)%interval; }
+      else { next = now + (timeRef-now)%interval; }
+      if (next <= now) { next += interval; }
+   }
+   return next;
+}
+
+static void _fillProfiles()
+{
+   if (!_isEnabled(DM_ENG_BULK_DATA_OBJECT_NAME)) return;
+
+   size_t rootLen = strlen(DM_ENG_BULK_DATA_OBJECT_NAME);
+   size_t profileLen = strlen(_PROFILE_NODE);
+   size_t enableLen = strlen(_ENABLE_NAME);
+   time_t now = time(NULL);
+   DM_ENG_Parameter* prm;
+   for (prm = DM_ENG_ParameterData_getFirst(); prm!=NULL; prm = DM_ENG_ParameterData_getNext())
+   {
+      // looking for the "<root>Profile.<i>.Enable" parameters
+      size_t len = strlen(prm->name);
+      if ((len > rootLen+profileLen+enableLen+1)
+       && (strncmp(prm->name, DM_ENG_BULK_DATA_OBJECT_NAME, rootLen) == 0)
+       && (strncmp(prm->name+rootLen, _PROFILE_NODE, profileLen) == 0)
+       && (strcmp(prm->name+len-enableLen, _ENABLE_NAME) == 0)
+       && (prm->name[len-enableLen-1] == '.')
+       && DM_ENG_Parameter_isValuable(prm->name))
+      {
+         bool enabled = false;
+         DM_ENG_stringToBool(prm->value, &enabled);
+         if (enabled)
+         {
+            char* profileName = strdup(prm->name);
+            profileName[len-enableLen] = '\0';
+            if (strchr(profileName+rootLen+profileLen, '.') == profileName+len-enableLen-1) // Profile.<i>. only
+            {
+               DM_ENG_ParameterValueStruct* profile = DM_ENG_newParameterValueStruct(profileName, DM_ENG_ParameterType_ANY, NULL);
+               profile->timestamp = _computeNextReportTime(profileName, now);
+               DM_ENG_addParameterValueStruct(&_profiles, profile);
+            }
+            free(profileName);
+         }
+      }
+   }
+}
+
+static void _clearProfiles()
+{
+   DM_ENG_deleteAllParameterValueStruct(&_profiles);
+}
+
+void DM_ENG_BulkDataCollector_init(DM_ENG_F_GET_VALUE getValue)
+{
+   DM_CMN_Thread_initMutex(&_collectorMutex);
+   DM_CMN_Thread_initCond(&_collectorCond);
+   DM_CMN_Thread_lockMutex(_collectorMutex);
+
+   _getValue = getValue;
+   _collectorStatus = _RUNNING;
+   _fillProfiles();
+   if (_profiles != NULL)
+   {
+      _signalCollector();
+   }
+   DM_CMN_Thread_unlockMutex(_collectorMutex);
+}
+
+void DM_ENG_BulkDataCollector_exit()
+{
+   DM_CMN_Thread_lockMutex(_collectorMutex);
+   _collectorStatus = _EXITING;
+   _clearProfiles();
+   if (_collectorThreadId != 0)
+   {
+      DM_CMN_Thread_signalCond(_collectorCond);
+      DM_CMN_Thread_unlockMutex(_collectorMutex);
+   }
+   else // no collector thread to release the resources
+   {
+      DM_CMN_Thread_unlockMutex(_collectorMutex);
+      DM_CMN_Thread_destroyCond(_collectorCond); _collectorCond = NULL;
+      DM_CMN_Thread_destroyMutex(_collectorMutex); _collectorMutex = NULL;
+      _collectorStatus = _INITIAL;
+   }
+}
+
+/**
+ * Allows to wait for the end of the collector thread
+ */
+void DM_ENG_BulkDataCollector_join()
+{
+   if (_collectorThreadId != 0)
+   {
+      DM_CMN_Thread_join(_collectorThreadId);
+   }
+}
+
+/**
+ * Re-reads the profiles after a change of the configuration
+ */
+void DM_ENG_BulkDataCollector_restart()
+{
+   DM_CMN_Thread_lockMutex(_collectorMutex);
+   if (_collectorStatus == _RUNNING)
+   {
+      _clearProfiles();
+      _fillProfiles();
+      _profilesChanged = true;
+      if (_profiles != NULL)
+      {
+         _signalCollector();
+      }
+   }
+   DM_CMN_Thread_unlockMutex(_collectorMutex);
+}
+
+/////////////////////////////////////////////////
+////////////// Report encoding ////////////////
+
+static void _appendReport(BulkDataReport* report, const char* s, size_t len)
+{
+   if (report->size + len + 1 > report->capacity)
+   {
+      size_t capacity = (report->capacity == 0 ? _INITIAL_REPORT_SIZE : report->capacity);
+      while (report->size + len + 1 > capacity) { capacity *= 2; }
+      report->data = (char*) realloc(report->data, capacity);
+      report->capacity = capacity;
+   }
+   memcpy(report->data + report->size, s, len);
+   report->size += len;
+   report->data[report->size] = '\0';
+}
+
+static void _appendReportString(BulkDataReport* report, const char* s)
+{
+   _appendReport(report, s, strlen(s));
+}
+
+/*
+ * CSV field (RFC 4180) : quoted only if needed, the quotes being doubled
+ */
+static void _appendCsvField(BulkDataReport* report, const char* s)
+{
+   if (s == NULL) return;
+   if (strpbrk(s, ",\"\r\n") == NULL)
+   {
+      _appendReportString(report, s);
+      return;
+   }
+   _appendReport(report, "\"", 1);
+   const char* start = s;
+   const char* quote;
+   while ((quote = strchr(start, '"')) != NULL)
+   {
+      _appendReport(report, start, quote-start+1);
+      _appendReport(report, "\"", 1);
+      start = quote+1;
+   }
+   _appendReportString(report, start);
+   _appendReport(report, "\"", 1);
+}
+
+static void _appendJsonString(BulkDataReport* report, const char* s)
+{
+   _appendReport(report, "\"", 1);
+   const char* start = s;
+   const char* ch;
+   for (ch = s; (ch != NULL) && (*ch != '\0'); ch++)
+   {
+      unsigned char c = (unsigned char)*ch;
+      if ((c == '"') || (c == '\\') || (c < 0x20))
+      {
+         char escape[7];
+         _appendReport(report, start, ch-start);
+         switch (c)
+         {
+            case '"'  : strcpy(escape, "\\\""); break;
+            case '\\' : strcpy(escape, "\\\\"); break;
+            case '\n' : strcpy(escape, "\\n"); break;
+            case '\r' : strcpy(escape, "\\r"); break;
+            case '\t' : strcpy(escape, "\\t"); break;
+            default   : sprintf(escape, "\\u%04x", c); break;
+         }
+         _appendReportString(report, escape);
+         start = ch+1;
+      }
+   }
+   if (ch != NULL) { _appendReport(report, start, ch-start); }
+   _appendReport(report, "\"", 1);
+}
+
+static void _appendName(DM_ENG_ParameterName** pFirst, DM_ENG_ParameterName** pLast, const char* name)
+{
+   DM_ENG_ParameterName* pn = DM_ENG_newParameterName(name);
+   if (*pLast == NULL) { *pFirst = pn; }
+   else { (*pLast)->next = pn; }
+   *pLast = pn;
+}
+
+/*
+ * Adds to the list the names of the parameters designated by the reference (parameter name or partial path)
+ */
+static void _addReferencedNames(DM_ENG_ParameterName** pFirst, DM_ENG_ParameterName** pLast, char* ref)
+{
+   char* longName = DM_ENG_Parameter_getLongName(ref, DM_ENG_PARAMETER_PREFIX);
+   size_t len = strlen(longName);
+   if ((len > 0) && (longName[len-1] == '.'))
+   {
+      char* prmName;
+      for (prmName = DM_ENG_ParameterData_getFirstName(); prmName!=NULL; prmName = DM_ENG_ParameterData_getNextName())
+      {
+         if ((strncmp(prmName, longName, len) == 0) && DM_ENG_Parameter_isValuable(prmName) && (strstr(prmName, _INTERNAL_SEPARATOR) == NULL))
+         {
+            _appendName(pFirst, pLast, prmName);
+         }
+      }
+   }
+   else if (DM_ENG_ParameterData_getParameter(longName) != NULL)
+   {
+      _appendName(pFirst, pLast, longName);
+   }
+   free(longName);
+}
+
+/*
+ * Builds the report of the profile. The names are resolved before reading the values since reading a system value
+ * may reload parameters and break the parameter loop.
+ */
+static BulkDataReport* _encodeReport(const char* profileName, bool json, time_t collectionTime)
+{
+   DM_ENG_ParameterName* names = NULL;
+   DM_ENG_ParameterName* last = NULL;
+   char* refs = _getProfileValue(profileName, _PARAMETER_REFERENCES_NAME);
+   if (refs != NULL)
+   {
+      char* refList = strdup(refs);
+      char* savePtr = NULL;
+      char* ref;
+      for (ref = strtok_r(refList, ",", &savePtr); ref != NULL; ref = strtok_r(NULL, ",", &savePtr))
+      {
+         while (isspace((unsigned char)*ref)) { ref++; }
+         char* end = ref + strlen(ref);
+         while ((end > ref) && isspace((unsigned char)end[-1])) { end--; }
+         *end = '\0';
+         if (*ref != '\0') { _addReferencedNames(&names, &last, ref); }
+      }
+      free(refList);
+   }
+
+   BulkDataReport* report = (BulkDataReport*) calloc(1, sizeof(BulkDataReport));
+   char sTime[21];
+   sprintf(sTime, "%lu", (unsigned long)collectionTime);
+   if (json)
+   {
+      _appendReportString(report, "{\"Report\":[{\"CollectionTime\":");
+      _appendReportString(report, sTime);
+   }
+   else
+   {
+      _appendReportString(report, "ReportTimestamp,ParameterName,ParameterValue\r\n");
+   }
+
+   DM_ENG_ParameterName* pn;
+   for (pn = names; pn != NULL; pn = pn->next)
+   {
+      char* value = _getValue((char*)pn->name, NULL);
+      if (json)
+      {
+         _appendReport(report, ",", 1);
+         _appendJsonString(report, pn->name);
+         _appendReport(report, ":", 1);
+         _appendJsonString(report, (value == NULL ? "" : value));
+      }
+      else
+      {
+         _appendReportString(report, sTime);
+         _appendReport(report, ",", 1);
+         _appendCsvField(report, pn->name);
+         _appendReport(report, ",", 1);
+         _appendCsvField(report, value);
+         _appendReport(report, "\r\n", 2);
+      }
+   }
+   if (json) { _appendReportString(report, "}]}"); }
+
+   DM_ENG_deleteAllParameterName(&names);
+   return report;
+}
+
+static void _deleteReport(BulkDataReport* report)
+{
+   DM_ENG_FREE(report->data);
+   free(report);
+}
+
+static char* _strdupOrNull(const char* s)
+{
+   return ((s == NULL) || (*s == '\0') ? NULL : strdup(s));
+}
+
+/*
+ * Collector thread. The locks are taken in the same order as in the StatisticsModule : DM lock then _collectorMutex.
+ */
+static void* _runCollector(void* data UNUSED)
+{
+   DM_ENG_ParameterManager_lockDM();
+   DM_CMN_Thread_lockMutex(_collectorMutex);
+
+   while ((_collectorStatus == _RUNNING) && (_profiles != NULL))
+   {
+      _profilesChanged = false;
+      time_t now = _currentTime();
+      time_t nextReportTime = 0;
+      DM_ENG_ParameterValueStruct* profile = _profiles;
+      while ((profile != NULL) && (profile->timestamp > now))
+      {
+         if ((nextReportTime == 0) || (profile->timestamp < nextReportTime)) { nextReportTime = profile->timestamp; }
+         profile = profile->next;
+      }
+
+      if ((profile != NULL) && !_isEnabled(profile->parameterName)) // profile deleted or disabled in the meantime
+      {
+         _clearProfiles();
+         _fillProfiles();
+      }
+      else if (profile != NULL) // a report is due
+      {
+         DBG("Bulk data report (%s) - Begin", profile->parameterName);
+         char* encoding = _getProfileValue(profile->parameterName, _ENCODING_TYPE_NAME);
+         bool json = ((encoding != NULL) && (strcasecmp(encoding, _ENCODING_JSON) == 0));
+         BulkDataReport* report = _encodeReport(profile->parameterName, json, now);
+         char* url = _strdupOrNull(_getProfileValue(profile->parameterName, _URL_NAME));
+         char* username = _strdupOrNull(_getProfileValue(profile->parameterName, _USERNAME_NAME));
+         char* password = _strdupOrNull(_getProfileValue(profile->parameterName, _PASSWORD_NAME));
+         char* profileName = strdup(profile->parameterName);
+         profile->timestamp = _computeNextReportTime(profile->parameterName, now);
+
+         // the POST may be long, it is done without locking the data
+         DM_CMN_Thread_unlockMutex(_collectorMutex);
+         DM_ENG_ParameterManager_unlock();
+
+         if (url == NULL)
+         {
+            WARN("Bulk data profile %s : no URL", profileName);
+         }
+         else
+         {
+            int res = DM_ENG_Device_postData(url, username, password, (json ? _JSON_CONTENT_TYPE : _CSV_CONTENT_TYPE), report->data, report->size);
+            if (res != 0) { WARN("Bulk data report %s not delivered (%d)", profileName, res); }
+         }
+         DBG("Bulk data report (%s, %d bytes) - End", profileName, (int)report->size);
+
+         _deleteReport(report);
+         DM_ENG_FREE(url);
+         DM_ENG_FREE(username);
+         DM_ENG_FREE(password);
+         free(profileName);
+
+         DM_ENG_ParameterManager_lockDM();
+         DM_CMN_Thread_lockMutex(_collectorMutex);
+      }
+      else // waiting for the next reporting time
+      {
+         DM_CMN_Thread_unlockMutex(_collectorMutex);
+         DM_ENG_ParameterManager_unlock();
+         DM_CMN_Thread_lockMutex(_collectorMutex);
+
+         if ((_collectorStatus == _RUNNING) && !_profilesChanged)
+         {
+            DM_CMN_Timespec_t timeout;
+            timeout.sec = nextReportTime;
+            timeout.msec = 0;
+            DM_CMN_Thread_timedWaitCond(_collectorCond, _collectorMutex, &timeout);
+         }
+
+         DM_CMN_Thread_unlockMutex(_collectorMutex);
+         DM_ENG_ParameterManager_lockDM();
+         DM_CMN_Thread_lockMutex(_collectorMutex);
+      }
+   }
+   _collectorThreadId = 0;
+
+   DM_CMN_Thread_unlockMutex(_collectorMutex);
+
+   if (_collectorStatus == _EXITING)
+   {
+      DM_CMN_Thread_destroyCond(_collectorCond); _collectorCond = NULL;
+      DM_CMN_Thread_destroyMutex(_collectorMutex); _collectorMutex = NULL;
+      _collectorStatus = _INITIAL;
+   }
+
+   DM_ENG_ParameterManager_unlock();
+   return 0;
+}
+
+static void _signalCollector()
+{
+   if (_collectorThreadId == 0)
+   {
+      DM_CMN_Thread_create(_runCollector, NULL, true, &_collectorThreadId);
+   }
+   else
+   {
+      DM_CMN_Thread_signalCond(_collectorCond);
+   }
+}
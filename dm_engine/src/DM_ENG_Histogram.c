@@ -0,0 +1,275 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : DM_ENG_Histogram.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file DM_ENG_Histogram.c
+ *
+ * @brief Histogram kept in native form (parsed bucket boundaries and integer counts) for the statistics module
+ *
+ */
+
+#include "DM_ENG_Histogram.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef UINT_MAX_DECIMAL_DIGITS
+#define UINT_MAX_DECIMAL_DIGITS 20
+#endif
+
+/**
+ * Constructs a new Histogram Structure with all counts set to 0.
+ *
+ * @param name Name of the histogram parameter
+ * @param def Definition the bounds have been read from
+ * @param bounds Upper bounds of the intervals, as listed in the definition
+ * @param nbIntervals Number of intervals
+ *
+ * @return A pointer to the new Histogram object
+ */
+DM_ENG_Histogram* DM_ENG_newHistogram(const char* name, const char* def, unsigned int bounds[], int nbIntervals)
+{
+   DM_ENG_Histogram* res = (DM_ENG_Histogram*) malloc(sizeof(DM_ENG_Histogram));
+   res->name = strdup(name);
+   res->definition = NULL;
+   res->bounds = NULL;
+   res->counts = NULL;
+   res->nbIntervals = 0;
+   res->value = NULL;
+   res->next = NULL;
+   DM_ENG_Histogram_setBounds(res, def, bounds, nbIntervals);
+   return res;
+}
+
+/**
+ * Deletes the Histogram Structure.
+ *
+ * @param histo A pointer to a Histogram object
+ *
+ */
+void DM_ENG_deleteHistogram(DM_ENG_Histogram* histo)
+{
+   free(histo->name);
+   DM_ENG_FREE(histo->definition);
+   free(histo->bounds);
+   free(histo->counts);
+   DM_ENG_FREE(histo->value);
+   free(histo);
+}
+
+/**
+ * Adds a Histogram object at the end of the list.
+ *
+ * @param pHisto Pointer to the first pointer of the list.
+ * @param newHisto A pointer to the Histogram object to add
+ *
+ */
+void DM_ENG_addHistogram(DM_ENG_Histogram** pHisto, DM_ENG_Histogram* newHisto)
+{
+   DM_ENG_Histogram* histo = *pHisto;
+   if (histo==NULL)
+   {
+      *pHisto=newHisto;
+   }
+   else
+   {
+      while (histo->next != NULL) { histo = histo->next; }
+      histo->next = newHisto;
+   }
+}
+
+/**
+ * Deletes all the elements of the list
+ *
+ * @param pHisto Pointer to the first pointer of the list.
+ *
+ */
+void DM_ENG_deleteAllHistogram(DM_ENG_Histogram** pHisto)
+{
+   DM_ENG_Histogram* histo = *pHisto;
+   while (histo != NULL)
+   {
+      DM_ENG_Histogram* next = histo->next;
+      DM_ENG_deleteHistogram(histo);
+      histo = next;
+   }
+   *pHisto = NULL;
+}
+
+/**
+ * Searches the histogram of the given name in the list.
+ *
+ * @param histo First element of the list
+ * @param name Name of the histogram parameter
+ *
+ * @return The Histogram object if found, else NULL
+ */
+DM_ENG_Histogram* DM_ENG_Histogram_find(DM_ENG_Histogram* histo, const char* name)
+{
+   while ((histo != NULL) && (strcmp(histo->name, name) != 0)) { histo = histo->next; }
+   return histo;
+}
+
+/**
+ * Replaces the bounds of the intervals. All counts are set to 0.
+ *
+ * @param histo A pointer to a Histogram object
+ * @param def Definition the bounds have been read from
+ * @param bounds Upper bounds of the intervals, as listed in the definition
+ * @param nbIntervals Number of intervals
+ */
+void DM_ENG_Histogram_setBounds(DM_ENG_Histogram* histo, const char* def, unsigned int bounds[], int nbIntervals)
+{
+   DM_ENG_FREE(histo->definition);
+   if (def != NULL) { histo->definition = strdup(def); }
+   if (nbIntervals != histo->nbIntervals)
+   {
+      histo->bounds = (unsigned int*) realloc(histo->bounds, nbIntervals*sizeof(unsigned int));
+      histo->counts = (unsigned int*) realloc(histo->counts, nbIntervals*sizeof(unsigned int));
+      histo->nbIntervals = nbIntervals;
+   }
+
+   // A value belongs to the first interval whose upper bound is not exceeded. Replacing each bound by the running max
+   // keeps that first interval unchanged and makes the array sorted for the binary search.
+   int i;
+   for (i=0; i<nbIntervals; i++)
+   {
+      histo->bounds[i] = ((i>0) && (bounds[i] < histo->bounds[i-1]) ? histo->bounds[i-1] : bounds[i]);
+   }
+   DM_ENG_Histogram_reset(histo);
+}
+
+/**
+ * Sets all the counts to 0.
+ *
+ * @param histo A pointer to a Histogram object
+ */
+void DM_ENG_Histogram_reset(DM_ENG_Histogram* histo)
+{
+   memset(histo->counts, 0, histo->nbIntervals*sizeof(unsigned int));
+   DM_ENG_FREE(histo->value);
+}
+
+/**
+ * Reloads the counts from the value of the histogram parameter.
+ *
+ * @param histo A pointer to a Histogram object
+ * @param value Value of the form "count1:count2:...". Missing or invalid counts are taken as 0.
+ */
+void DM_ENG_Histogram_setCounts(DM_ENG_Histogram* histo, const char* value)
+{
+   DM_ENG_Histogram_reset(histo);
+   const char* ch = value;
+   int i;
+   for (i=0; (ch != NULL) && (*ch != '\0') && (i<histo->nbIntervals); i++)
+   {
+      char* end = NULL;
+      unsigned long count = strtoul(ch, &end, 10);
+      if ((end != ch) && (count <= UINT_MAX)) { histo->counts[i] = (unsigned int)count; }
+      ch = strchr(ch, ':');
+      if (ch != NULL) { ch++; }
+   }
+}
+
+/**
+ * Gives the interval a value belongs to.
+ *
+ * @param histo A pointer to a Histogram object
+ * @param value A sample value
+ *
+ * @return The index of the interval or -1 if the value is greater than all the bounds
+ */
+int DM_ENG_Histogram_getInterval(DM_ENG_Histogram* histo, unsigned int value)
+{
+   int low = 0;
+   int high = histo->nbIntervals;
+   while (low < high)
+   {
+      int mid = (low + high) / 2;
+      if (value > histo->bounds[mid]) { low = mid + 1; }
+      else { high = mid; }
+   }
+   return (low < histo->nbIntervals ? low : -1);
+}
+
+/**
+ * Counts a new sample value.
+ *
+ * @param histo A pointer to a Histogram object
+ * @param value A sample value
+ */
+void DM_ENG_Histogram_addSample(DM_ENG_Histogram* histo, unsigned int value)
+{
+   int i = DM_ENG_Histogram_getInterval(histo, value);
+   if (i >= 0)
+   {
+      histo->counts[i]++;
+      DM_ENG_FREE(histo->value);
+   }
+}
+
+/**
+ * Counts a whole array of sample values in one call.
+ *
+ * @param histo A pointer to a Histogram object
+ * @param values Array of sample values
+ * @param nbValues Size of the array
+ */
+void DM_ENG_Histogram_addSamples(DM_ENG_Histogram* histo, unsigned int values[], int nbValues)
+{
+   bool changed = false;
+   int k;
+   for (k=0; k<nbValues; k++)
+   {
+      int i = DM_ENG_Histogram_getInterval(histo, values[k]);
+      if (i >= 0)
+      {
+         histo->counts[i]++;
+         changed = true;
+      }
+   }
+   if (changed) { DM_ENG_FREE(histo->value); }
+}
+
+/**
+ * Gives the value of the histogram parameter, of the form "count1:count2:...". The string is only rebuilt
+ * when counts have changed since the last call.
+ *
+ * @param histo A pointer to a Histogram object
+ *
+ * @return The value, owned by the Histogram object
+ */
+const char* DM_ENG_Histogram_getValue(DM_ENG_Histogram* histo)
+{
+   if (histo->value == NULL)
+   {
+      histo->value = (char*) malloc(histo->nbIntervals*(UINT_MAX_DECIMAL_DIGITS+1)+1);
+      char* ch = histo->value;
+      *ch = '\0';
+      int i;
+      for (i=0; i<histo->nbIntervals; i++)
+      {
+         ch += sprintf(ch, (i==0 ? "%u" : ":%u"), histo->counts[i]);
+      }
+   }
+   return histo->value;
+}
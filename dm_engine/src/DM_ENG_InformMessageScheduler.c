@@ -443,6 +443,7 @@ static void _start()
    {
       // initialisations...
       DM_ENG_NotificationInterface_updateAcsParameters();
+      DM_ENG_NotificationInterface_updateConnectionRequestCredentials();
 
       retryOn = false;
 
@@ -36,8 +36,10 @@ static char** mandatoryParameterList = NULL;
 static DM_ENG_NotificationInterface* listeners[2] = { NULL, NULL };
 
 static DM_ENG_F_UPDATE_ACS_PARAMETERS _updateAcsParameters = NULL;
+static DM_ENG_F_UPDATE_CONNECTION_REQUEST_CREDENTIALS _updateConnectionRequestCredentials = NULL;
 
-void DM_ENG_NotificationInterface_activate(DM_ENG_EntityType entity, DM_ENG_F_INFORM inform, DM_ENG_F_TRANSFER_COMPLETE transferComplete, DM_ENG_F_REQUEST_DOWNLOAD requestDownload, DM_ENG_F_UPDATE_ACS_PARAMETERS updateAcsParameters)
+void DM_ENG_NotificationInterface_activate(DM_ENG_EntityType entity, DM_ENG_F_INFORM inform, DM_ENG_F_TRANSFER_COMPLETE transferComplete, DM_ENG_F_REQUEST_DOWNLOAD requestDownload, DM_ENG_F_UPDATE_ACS_PARAMETERS updateAcsParameters,
+   DM_ENG_F_UPDATE_CONNECTION_REQUEST_CREDENTIALS updateConnectionRequestCredentials)
 {
    DM_ENG_NotificationInterface_deactivate(entity); // Au cas o une notif antrieure serait encore enregistre
    switch (entity)
@@ -58,6 +60,7 @@ void DM_ENG_NotificationInterface_activate(DM_ENG_EntityType entity, DM_ENG_F_IN
    }
 
    if (updateAcsParameters != NULL) { _updateAcsParameters = updateAcsParameters; }
+   if (updateConnectionRequestCredentials != NULL) { _updateConnectionRequestCredentials = updateConnectionRequestCredentials; }
 }
 
 void DM_ENG_NotificationInterface_deactivateAll()
@@ -112,6 +115,21 @@ void DM_ENG_NotificationInterface_updateAcsParameters()
    }
 }
 
+void DM_ENG_NotificationInterface_updateConnectionRequestCredentials()
+{
+   if (_updateConnectionRequestCredentials != NULL)
+   {
+      // Provide to DM_COM the updated credentials expected from the ACS on connection requests
+      char* username = NULL;
+      char* password = NULL;
+      DM_ENG_ParameterManager_getParameterValue(DM_TR106_CONNECTIONREQUESTUSERNAME, &username);
+      DM_ENG_ParameterManager_getParameterValue(DM_TR106_CONNECTIONREQUESTPASSWORD, &password);
+      (_updateConnectionRequestCredentials)(username, password);
+      DM_ENG_FREE(username);
+      DM_ENG_FREE(password);
+   }
+}
+
 bool DM_ENG_NotificationInterface_isReady()
 {
    return (listeners[0] != NULL) || (listeners[1] != NULL);
@@ -61,10 +61,15 @@ enum
    _BEING_EVALUATED = 4,
    _LOADED = 8,
    _PUSHED = 16,
+   _STATS_VALUE = 32, // valeur de statistique, sauvegarde  part (cf. DM_ENG_ParameterData_syncStatistics)
    _VALUE_CHANGED = 1
 };
 
+// Bits sauvegards avec une valeur de statistique
+#define _STATS_STATE (_STATS_VALUE | _VALUE_CHANGED | _PUSHED)
+
 static bool _dataChanged = false;
+static bool _statsDataChanged = false;
 
 bool DM_ENG_Parameter_isDataChanged()
 {
@@ -76,6 +81,23 @@ void DM_ENG_Parameter_setDataChanged(bool changed)
    _dataChanged = changed;
 }
 
+bool DM_ENG_Parameter_isStatsDataChanged()
+{
+   return _statsDataChanged;
+}
+
+void DM_ENG_Parameter_setStatsDataChanged(bool changed)
+{
+   _statsDataChanged = changed;
+}
+
+// Les changements sur les valeurs de statistique ne provoquent pas la rcriture de l'ensemble des paramtres
+static void _setChanged(DM_ENG_Parameter* param)
+{
+   if ((param->state & _STATS_VALUE) != 0) { _statsDataChanged = true; }
+   else { _dataChanged = true; }
+}
+
 DM_ENG_Parameter* DM_ENG_newParameter(char* attr[], bool ini)
 {
    DM_ENG_Parameter* res = (DM_ENG_Parameter*) malloc(sizeof(DM_ENG_Parameter));
@@ -125,9 +147,8 @@ DM_ENG_Parameter* DM_ENG_newParameter(char* attr[], bool ini)
    iAttr = DM_ENG_charToInt(*attr[10]);
    res->loadingMode = ( iAttr != -1 ? iAttr : 0 );
 
-   // cod sinon 0
-   iAttr = DM_ENG_charToInt(*attr[11]);
-   res->state = ( iAttr != -1 ? iAttr : 0 );
+   // cod sinon 0 (plusieurs chiffres depuis _PUSHED et _STATS_VALUE)
+   if (!DM_ENG_stringToInt(attr[11], &res->state)) { res->state = 0; }
 
    // copie si prsent sinon NULL
    res->backValue = (*attr[12]==0 ? NULL : strdup(attr[12]));
@@ -367,9 +388,9 @@ static void _setNewValue(DM_ENG_Parameter* param, char* newVal)
  */
 void DM_ENG_Parameter_initState(DM_ENG_Parameter* param)
 {
-   if (param->state != _INITIAL)
+   if ((param->state & ~_STATS_VALUE) != _INITIAL)
    {
-      param->state = _INITIAL;
+      param->state &= _STATS_VALUE;
       if ((!param->writable) && (param->immediateChanges == _FLAG_TRIGGER)) // signature d'un param  valeur drapeau (aussitt notifie, on l'efface)
       {
          if (param->backValue == NULL)
@@ -395,7 +416,7 @@ void DM_ENG_Parameter_initState(DM_ENG_Parameter* param)
             }
          }
       }
-      _dataChanged = true;
+      _setChanged(param);
    }
 }
 
@@ -409,7 +430,7 @@ void DM_ENG_Parameter_initState(DM_ENG_Parameter* param)
 void DM_ENG_Parameter_updateValue(DM_ENG_Parameter* param, char* value, bool newValue)
 {
    _setNewValue(param, ((value==NULL) || (value==(char*)DM_ENG_EMPTY) ? value : strdup(value)));
-   _dataChanged = true;
+   _setChanged(param);
    if (newValue)
    {
       param->state |= _VALUE_CHANGED | _PUSHED;
@@ -417,6 +438,51 @@ void DM_ENG_Parameter_updateValue(DM_ENG_Parameter* param, char* value, bool new
    }
 }
 
+/**
+ * Marks a read-only DM ONLY or COMPUTED parameter as statistics value : its later changes are saved in the statistics store
+ * (see DM_ENG_ParameterData_syncStatistics) and no longer cause the rewriting of the whole parameter data.
+ */
+void DM_ENG_Parameter_markStatsValue(DM_ENG_Parameter* param)
+{
+   if (((param->state & _STATS_VALUE) == 0) && !param->writable && !DM_ENG_Parameter_isNode(param->name)
+    && ((param->storageMode == DM_ENG_StorageMode_DM_ONLY) || (param->storageMode == DM_ENG_StorageMode_COMPUTED)))
+   {
+      param->state |= _STATS_VALUE;
+      _dataChanged = true; // le marquage lui-mme est sauvegard avec les paramtres
+   }
+}
+
+/**
+ * Same as DM_ENG_Parameter_updateValue() for a value computed by the statistics module.
+ */
+void DM_ENG_Parameter_updateStatsValue(DM_ENG_Parameter* param, char* value, bool newValue)
+{
+   DM_ENG_Parameter_markStatsValue(param);
+   DM_ENG_Parameter_updateValue(param, value, newValue);
+}
+
+bool DM_ENG_Parameter_isStatsValue(DM_ENG_Parameter* param)
+{
+   return ((param->state & _STATS_VALUE) != 0);
+}
+
+/**
+ * Returns the state bits saved with a statistics value : the statistics mark and the pending notification
+ * of the value. The other bits only make sense while the agent runs.
+ */
+int DM_ENG_Parameter_getStatsState(DM_ENG_Parameter* param)
+{
+   return (param->state & _STATS_STATE);
+}
+
+/**
+ * Restores the state bits of a statistics value read from the statistics store, the other bits are kept.
+ */
+void DM_ENG_Parameter_restoreStatsState(DM_ENG_Parameter* param, int state)
+{
+   param->state = (param->state & ~_STATS_STATE) | (state & _STATS_STATE) | _STATS_VALUE;
+}
+
 void DM_ENG_Parameter_resetValue(DM_ENG_Parameter* param)
 {
    char* newVal = NULL;
@@ -440,7 +506,7 @@ void DM_ENG_Parameter_markLoaded(DM_ENG_Parameter* param, bool withValues)
       if ((param->storageMode == DM_ENG_StorageMode_COMPUTED) && ((param->state & _LOADED) == 0))
       {
          param->state |= _LOADED;
-         _dataChanged = true;
+         _setChanged(param);
       }
    }
    else // il faut (param->value != NULL) || (param->backValue != NULL)
@@ -480,7 +546,7 @@ void DM_ENG_Parameter_clearTemporaryValue(DM_ENG_Parameter* param, int level)
       {
          if (param->value != DM_ENG_EMPTY) { free(param->value); }
          param->value = NULL;
-         param->state = _INITIAL;
+         param->state &= _STATS_VALUE;
          _dataChanged = true;
       }
    }
@@ -498,14 +564,14 @@ void DM_ENG_Parameter_clearTemporaryValue(DM_ENG_Parameter* param, int level)
          {
             if (param->value != DM_ENG_EMPTY) { free(param->value); }
             param->value = NULL;
-            _dataChanged = true;
+            _setChanged(param);
          }
       }
       int stateToClear = _LOADED | _PUSHED;
       if ((param->state & stateToClear) != 0)
       {
          param->state &= ~stateToClear;
-         _dataChanged = true;
+         _setChanged(param);
       }
    }
 }
@@ -668,7 +734,7 @@ void DM_ENG_Parameter_commit(DM_ENG_Parameter* param)
       if (param->backValue != DM_ENG_EMPTY) { free(param->backValue); }
       param->backValue = NULL;
    }
-	if (param->state != 0)
+	if ((param->state & ~_STATS_VALUE) != 0)
    {
       if ( DM_ENG_Parameter_isDiagnosticsState(param->name)
         && (param->value != NULL) && (strcmp(param->value, DM_ENG_NONE_STATE) != 0) && (strcmp(param->value, DM_ENG_REQUESTED_STATE) != 0))
@@ -682,7 +748,7 @@ void DM_ENG_Parameter_commit(DM_ENG_Parameter* param)
    		DM_ENG_InformMessageScheduler_parameterValueChanged(param);
    	}
    }
-   _dataChanged = true;
+   _setChanged(param);
 }
 
 /**
@@ -707,7 +773,7 @@ bool DM_ENG_Parameter_cancelChange(DM_ENG_Parameter* param)
 void DM_ENG_Parameter_markBeingEvaluated(DM_ENG_Parameter* param)
 {
    param->state |= _BEING_EVALUATED;
-   _dataChanged = true;
+   _setChanged(param);
 }
 
 /**
@@ -716,7 +782,7 @@ void DM_ENG_Parameter_markBeingEvaluated(DM_ENG_Parameter* param)
 void DM_ENG_Parameter_unmarkBeingEvaluated(DM_ENG_Parameter* param)
 {
    param->state &= ~_BEING_EVALUATED;
-   _dataChanged = true;
+   _setChanged(param);
 }
 
 /**
@@ -733,7 +799,7 @@ bool DM_ENG_Parameter_isBeingEvaluated(DM_ENG_Parameter* param)
 void DM_ENG_Parameter_markPushed(DM_ENG_Parameter* param)
 {
    param->state |= _PUSHED;
-   _dataChanged = true;
+   _setChanged(param);
 }
 
 /**
@@ -744,7 +810,7 @@ void DM_ENG_Parameter_unmarkPushed(DM_ENG_Parameter* param)
    if ((param->state & _PUSHED) != 0)
    {
       param->state &= ~_PUSHED;
-      _dataChanged = true;
+      _setChanged(param);
    }
 }
 
@@ -41,6 +41,7 @@
 #include "DM_ENG_InformMessageScheduler.h"
 #include "DM_ENG_NotificationInterface.h"
 #include "DM_ENG_StatisticsModule.h"
+#include "DM_ENG_BulkDataCollector.h"
 #include "DM_ENG_ComputedExp.h"
 #include "DM_CMN_Thread.h"
 #include "CMN_Trace.h"
@@ -58,6 +59,8 @@ static DM_CMN_Mutex_t _changesMutex = NULL;
 
 static bool periodicInformChanged = false;
 static bool acsParametersToUpdate = false;
+static bool connectionRequestCredentialsToUpdate = false;
+static bool bulkDataCollectorToRestart = false;
 
 static DM_ENG_ParameterValueStruct* diagnosticsRequested = NULL;
 
@@ -127,6 +130,7 @@ int DM_ENG_ParameterManager_init(const char* dataPath, DM_ENG_InitLevel level)
       _computeNextPeriodicInformTime();
    }
    DM_ENG_StatisticsModule_init(_createParameter, _getValue);
+   DM_ENG_BulkDataCollector_init(_getValue);
    DM_ENG_ParameterData_unLock();
    DBG("DM_ENG_ParameterManager_init - Done");
    return 0;
@@ -136,12 +140,14 @@ void DM_ENG_ParameterManager_release()
 {
    DM_ENG_ParameterManager_lockDM();
    DM_ENG_StatisticsModule_exit();
+   DM_ENG_BulkDataCollector_exit();
    DM_ENG_InformMessageScheduler_exit();
    DM_CMN_Thread_destroyMutex(_changesMutex); _changesMutex = NULL;
    DM_CMN_Thread_destroyMutex(_dataMutex); _dataMutex = NULL;
    DM_ENG_ParameterData_release();
    DM_ENG_ParameterData_unLock();
    DM_ENG_StatisticsModule_join();
+   DM_ENG_BulkDataCollector_join();
 }
 
 int DM_ENG_ParameterManager_getNumberOfParameters()
@@ -211,9 +217,10 @@ static int _actionAfterDownload(const char* fileType, const char* fileName)
    if ((fileType != NULL) && (strcmp(fileType, DATA_MODEL_EXTENSION_FILE_TYPE) == 0))
    {
       res = DM_ENG_DataModelConfiguration_processConfig(fileName);
-      if (res == 0) // on redmarre le module de stats
+      if (res == 0) // on redmarre le module de stats et la collecte bulk data
       {
          DM_ENG_StatisticsModule_restart();
+         DM_ENG_BulkDataCollector_restart();
       }
    }
    return res;
@@ -1250,6 +1257,15 @@ DM_ENG_Parameter* DM_ENG_ParameterManager_getParameter(const char* name)
    return DM_ENG_ParameterData_getParameter(name);
 }
 
+/**
+ * @return A number changed each time parameters are added or removed. A parameter got by DM_ENG_ParameterManager_getParameter()
+ * remains valid as long as this number is unchanged.
+ */
+unsigned int DM_ENG_ParameterManager_getStructureVersion()
+{
+   return DM_ENG_ParameterData_getStructureVersion();
+}
+
 /**
  *
  * @param name Name of a requested Parameter.
@@ -1286,9 +1302,18 @@ static int _setParameterValue(DM_ENG_Parameter* param, char* value, char** pData
  * @throws ReadOnlyParameterException if non writable parameter
  */
 int DM_ENG_ParameterManager_setParameterValue(DM_ENG_EntityType entity, const char* name, DM_ENG_ParameterType type, char* value, OUT DM_ENG_ParameterStatus* pResult, OUT char** pSysName, OUT char** pData)
+{
+   return DM_ENG_ParameterManager_setResolvedParameterValue(entity, DM_ENG_ParameterData_getParameter(name), name, type, value, pResult, pSysName, pData);
+}
+
+/**
+ * Same as DM_ENG_ParameterManager_setParameterValue() for a parameter already looked up
+ *
+ * @param param The parameter with the given name, NULL if it does not exist
+ */
+int DM_ENG_ParameterManager_setResolvedParameterValue(DM_ENG_EntityType entity, DM_ENG_Parameter* param, const char* name, DM_ENG_ParameterType type, char* value, OUT DM_ENG_ParameterStatus* pResult, OUT char** pSysName, OUT char** pData)
 {
    int res = 0;
-   DM_ENG_Parameter* param = DM_ENG_ParameterData_getParameter(name);
 
    if ((param == NULL) || DM_ENG_Parameter_isNode(param->name)
      || ((*pResult == DM_ENG_ParameterStatus_UNDEFINED) // vrification uniquement pour le 1er appel (non rcursif)
@@ -1439,7 +1464,17 @@ void DM_ENG_ParameterManager_setParameterKey(char* parameterKey)
  */
 void DM_ENG_ParameterManager_commitParameter(const char* name)
 {
-   DM_ENG_Parameter* param = DM_ENG_ParameterData_getParameter(name);
+   DM_ENG_ParameterManager_commitResolvedParameter(DM_ENG_ParameterData_getParameter(name), name);
+}
+
+/**
+ * Same as DM_ENG_ParameterManager_commitParameter() for a parameter already looked up
+ *
+ * @param param The parameter with the given name, NULL if it does not exist
+ * @param name Name of a parameter to commit
+ */
+void DM_ENG_ParameterManager_commitResolvedParameter(DM_ENG_Parameter* param, const char* name)
+{
    if ((param == NULL) || DM_ENG_Parameter_isNode(param->name)) { return; }
 
    char* nextName = NULL; // nom pour commit rcursif dans le cas des redirections
@@ -1481,6 +1516,14 @@ void DM_ENG_ParameterManager_commitParameter(const char* name)
    {
       acsParametersToUpdate = true;
    }
+   else if ((strcmp(name, DM_TR106_CONNECTIONREQUESTUSERNAME) == 0) || (strcmp(name, DM_TR106_CONNECTIONREQUESTPASSWORD) == 0))
+   {
+      connectionRequestCredentialsToUpdate = true;
+   }
+   else if (strncmp(name, DM_ENG_BULK_DATA_OBJECT_NAME, strlen(DM_ENG_BULK_DATA_OBJECT_NAME)) == 0)
+   {
+      bulkDataCollectorToRestart = true;
+   }
    else // paramtres de contrle des objets 'statistiques'
    {
       int k = strlen(name)-1;
@@ -1519,7 +1562,17 @@ void DM_ENG_ParameterManager_commitParameter(const char* name)
  */
 void DM_ENG_ParameterManager_unsetParameter(const char* name)
 {
-   DM_ENG_Parameter* param = DM_ENG_ParameterData_getParameter(name);
+   DM_ENG_ParameterManager_unsetResolvedParameter(DM_ENG_ParameterData_getParameter(name), name);
+}
+
+/**
+ * Same as DM_ENG_ParameterManager_unsetParameter() for a parameter already looked up
+ *
+ * @param param The parameter with the given name, NULL if it does not exist
+ * @param name Name of a parameter to unset
+ */
+void DM_ENG_ParameterManager_unsetResolvedParameter(DM_ENG_Parameter* param, const char* name)
+{
    if ((param == NULL) || DM_ENG_Parameter_isNode(param->name)) { return; }
 
    bool cancelled = DM_ENG_Parameter_cancelChange(param); // cancelled permet d'viter les boucles infinies
@@ -1945,6 +1998,16 @@ void DM_ENG_ParameterManager_unlock()
       DM_ENG_NotificationInterface_updateAcsParameters();
       acsParametersToUpdate = false;
    }
+   if (connectionRequestCredentialsToUpdate)
+   {
+      DM_ENG_NotificationInterface_updateConnectionRequestCredentials();
+      connectionRequestCredentialsToUpdate = false;
+   }
+   if (bulkDataCollectorToRestart)
+   {
+      DM_ENG_BulkDataCollector_restart();
+      bulkDataCollectorToRestart = false;
+   }
    if (_inSession)
    {
       DM_ENG_Device_closeSession();
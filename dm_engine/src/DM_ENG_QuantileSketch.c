@@ -0,0 +1,327 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : DM_ENG_QuantileSketch.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file DM_ENG_QuantileSketch.c
+ *
+ * @brief Mergeable quantile sketch with bounded memory, used by the statistics module to compute percentiles
+ *
+ */
+
+#include "DM_ENG_QuantileSketch.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef UINT_MAX_DECIMAL_DIGITS
+#define UINT_MAX_DECIMAL_DIGITS 20
+#endif
+
+
+/*
+ * Index of the bucket of a value. The values lower than DM_ENG_QuantileSketch_SUB_BUCKETS have their own bucket,
+ * then each interval [2^k, 2^(k+1)[ is split into DM_ENG_QuantileSketch_SUB_BUCKETS buckets of the same width.
+ */
+static int _getIndex(unsigned int value)
+{
+   if (value < DM_ENG_QuantileSketch_SUB_BUCKETS) { return (int)value; }
+   int shift = 0;
+   while ((value >> shift) >= 2*DM_ENG_QuantileSketch_SUB_BUCKETS) { shift++; }
+   return (shift+1)*DM_ENG_QuantileSketch_SUB_BUCKETS + (int)(value >> shift) - DM_ENG_QuantileSketch_SUB_BUCKETS;
+}
+
+/*
+ * Value representing a bucket : the middle of its interval
+ */
+static unsigned int _getBucketValue(int index)
+{
+   if (index < DM_ENG_QuantileSketch_SUB_BUCKETS) { return (unsigned int)index; }
+   int shift = index/DM_ENG_QuantileSketch_SUB_BUCKETS - 1;
+   unsigned int lower = (unsigned int)(DM_ENG_QuantileSketch_SUB_BUCKETS + index%DM_ENG_QuantileSketch_SUB_BUCKETS) << shift;
+   return lower + (((1u << shift) - 1) / 2);
+}
+
+/*
+ * Extends the buckets so that [first, last] is covered, collapsing the lowest ones if the maximum number is exceeded
+ */
+static void _resize(DM_ENG_QuantileSketch* sketch, int first, int last)
+{
+   if (last - first + 1 > DM_ENG_QuantileSketch_MAX_BUCKETS) { first = last - DM_ENG_QuantileSketch_MAX_BUCKETS + 1; }
+   int nbBuckets = last - first + 1;
+   unsigned int* counts = (unsigned int*) calloc(nbBuckets, sizeof(unsigned int));
+   int i;
+   for (i=0; i<sketch->nbBuckets; i++)
+   {
+      int k = sketch->firstIndex + i - first;
+      if (k < 0) { k = 0; }
+      counts[k] += sketch->counts[i];
+   }
+   DM_ENG_FREE(sketch->counts);
+   sketch->counts = counts;
+   sketch->firstIndex = first;
+   sketch->nbBuckets = nbBuckets;
+}
+
+static void _addCount(DM_ENG_QuantileSketch* sketch, int index, unsigned int count)
+{
+   if (sketch->nbBuckets == 0)
+   {
+      _resize(sketch, index, index);
+   }
+   else if (index < sketch->firstIndex)
+   {
+      _resize(sketch, index, sketch->firstIndex + sketch->nbBuckets - 1);
+   }
+   else if (index >= sketch->firstIndex + sketch->nbBuckets)
+   {
+      _resize(sketch, sketch->firstIndex, index);
+   }
+   if (index < sketch->firstIndex) { index = sketch->firstIndex; } // collapsed with the lowest buckets
+   sketch->counts[index - sketch->firstIndex] += count;
+   sketch->count += count;
+   DM_ENG_FREE(sketch->value);
+}
+
+/**
+ * Constructs a new empty Quantile Sketch Structure.
+ *
+ * @param name Name of the parameter the sketch is saved into
+ *
+ * @return A pointer to the new QuantileSketch object
+ */
+DM_ENG_QuantileSketch* DM_ENG_newQuantileSketch(const char* name)
+{
+   DM_ENG_QuantileSketch* res = (DM_ENG_QuantileSketch*) malloc(sizeof(DM_ENG_QuantileSketch));
+   res->name = strdup(name);
+   res->firstIndex = 0;
+   res->nbBuckets = 0;
+   res->counts = NULL;
+   res->count = 0;
+   res->value = NULL;
+   res->next = NULL;
+   return res;
+}
+
+/**
+ * Deletes the Quantile Sketch Structure.
+ *
+ * @param sketch A pointer to a QuantileSketch object
+ *
+ */
+void DM_ENG_deleteQuantileSketch(DM_ENG_QuantileSketch* sketch)
+{
+   free(sketch->name);
+   DM_ENG_FREE(sketch->counts);
+   DM_ENG_FREE(sketch->value);
+   free(sketch);
+}
+
+/**
+ * Adds a QuantileSketch object at the end of the list.
+ *
+ * @param pSketch Pointer to the first pointer of the list.
+ * @param newSketch A pointer to the QuantileSketch object to add
+ *
+ */
+void DM_ENG_addQuantileSketch(DM_ENG_QuantileSketch** pSketch, DM_ENG_QuantileSketch* newSketch)
+{
+   DM_ENG_QuantileSketch* sketch = *pSketch;
+   if (sketch==NULL)
+   {
+      *pSketch=newSketch;
+   }
+   else
+   {
+      while (sketch->next != NULL) { sketch = sketch->next; }
+      sketch->next = newSketch;
+   }
+}
+
+/**
+ * Deletes all the elements of the list
+ *
+ * @param pSketch Pointer to the first pointer of the list.
+ *
+ */
+void DM_ENG_deleteAllQuantileSketch(DM_ENG_QuantileSketch** pSketch)
+{
+   DM_ENG_QuantileSketch* sketch = *pSketch;
+   while (sketch != NULL)
+   {
+      DM_ENG_QuantileSketch* next = sketch->next;
+      DM_ENG_deleteQuantileSketch(sketch);
+      sketch = next;
+   }
+   *pSketch = NULL;
+}
+
+/**
+ * Searches the sketch of the given name in the list.
+ *
+ * @param sketch First element of the list
+ * @param name Name of the sketch parameter
+ *
+ * @return The QuantileSketch object if found, else NULL
+ */
+DM_ENG_QuantileSketch* DM_ENG_QuantileSketch_find(DM_ENG_QuantileSketch* sketch, const char* name)
+{
+   while ((sketch != NULL) && (strcmp(sketch->name, name) != 0)) { sketch = sketch->next; }
+   return sketch;
+}
+
+/**
+ * Empties the sketch.
+ *
+ * @param sketch A pointer to a QuantileSketch object
+ */
+void DM_ENG_QuantileSketch_reset(DM_ENG_QuantileSketch* sketch)
+{
+   DM_ENG_FREE(sketch->counts);
+   sketch->firstIndex = 0;
+   sketch->nbBuckets = 0;
+   sketch->count = 0;
+   DM_ENG_FREE(sketch->value);
+}
+
+/**
+ * Reloads the sketch from the value of its parameter.
+ *
+ * @param sketch A pointer to a QuantileSketch object
+ * @param value Value of the form "firstIndex:count1:count2:...", as given by DM_ENG_QuantileSketch_getValue().
+ * An empty or invalid value gives an empty sketch.
+ */
+void DM_ENG_QuantileSketch_setValue(DM_ENG_QuantileSketch* sketch, const char* value)
+{
+   DM_ENG_QuantileSketch_reset(sketch);
+   if ((value == NULL) || (*value == '\0')) { return; }
+
+   char* end = NULL;
+   long index = strtol(value, &end, 10);
+   if ((end == value) || (*end != ':') || (index < 0)) { return; }
+   const char* ch = end+1;
+   while (*ch != '\0')
+   {
+      unsigned long count = strtoul(ch, &end, 10);
+      if ((end != ch) && (count > 0) && (count <= UINT_MAX)) { _addCount(sketch, (int)index, (unsigned int)count); }
+      index++;
+      ch = strchr(ch, ':');
+      if (ch == NULL) { break; }
+      ch++;
+   }
+}
+
+/**
+ * Counts a new sample value.
+ *
+ * @param sketch A pointer to a QuantileSketch object
+ * @param value A sample value
+ */
+void DM_ENG_QuantileSketch_addSample(DM_ENG_QuantileSketch* sketch, unsigned int value)
+{
+   _addCount(sketch, _getIndex(value), 1);
+}
+
+/**
+ * Counts a whole array of sample values in one call.
+ *
+ * @param sketch A pointer to a QuantileSketch object
+ * @param values Array of sample values
+ * @param nbValues Size of the array
+ */
+void DM_ENG_QuantileSketch_addSamples(DM_ENG_QuantileSketch* sketch, unsigned int values[], int nbValues)
+{
+   int k;
+   for (k=0; k<nbValues; k++)
+   {
+      _addCount(sketch, _getIndex(values[k]), 1);
+   }
+}
+
+/**
+ * Adds the counts of another sketch. The result is the same as if all the samples had been counted in this sketch.
+ *
+ * @param sketch A pointer to a QuantileSketch object
+ * @param other A pointer to the QuantileSketch object to merge
+ */
+void DM_ENG_QuantileSketch_merge(DM_ENG_QuantileSketch* sketch, DM_ENG_QuantileSketch* other)
+{
+   int i;
+   for (i=0; i<other->nbBuckets; i++)
+   {
+      if (other->counts[i] > 0) { _addCount(sketch, other->firstIndex + i, other->counts[i]); }
+   }
+}
+
+/**
+ * Estimates a quantile of the counted values.
+ *
+ * @param sketch A pointer to a QuantileSketch object
+ * @param percent Rank of the quantile, from 0 to 100 (50 for the median)
+ * @param pRes Pointer to an unsigned int receiving the estimated value
+ *
+ * @return false if the sketch is empty
+ */
+bool DM_ENG_QuantileSketch_getQuantile(DM_ENG_QuantileSketch* sketch, unsigned int percent, unsigned int* pRes)
+{
+   if (sketch->count == 0) { return false; }
+   if (percent > 100) { percent = 100; }
+
+   unsigned long long rank = ((unsigned long long)(sketch->count-1) * percent) / 100;
+   unsigned long long cumul = 0;
+   int i;
+   for (i=0; i<sketch->nbBuckets; i++)
+   {
+      cumul += sketch->counts[i];
+      if (cumul > rank) { break; }
+   }
+   if (i == sketch->nbBuckets) { i--; }
+   *pRes = _getBucketValue(sketch->firstIndex + i);
+   return true;
+}
+
+/**
+ * Gives the value of the sketch parameter, of the form "firstIndex:count1:count2:...". The string is only rebuilt
+ * when counts have changed since the last call.
+ *
+ * @param sketch A pointer to a QuantileSketch object
+ *
+ * @return The value, owned by the QuantileSketch object
+ */
+const char* DM_ENG_QuantileSketch_getValue(DM_ENG_QuantileSketch* sketch)
+{
+   if (sketch->value == NULL)
+   {
+      sketch->value = (char*) malloc((sketch->nbBuckets+1)*(UINT_MAX_DECIMAL_DIGITS+1)+1);
+      char* ch = sketch->value;
+      *ch = '\0';
+      if (sketch->nbBuckets > 0)
+      {
+         ch += sprintf(ch, "%d", sketch->firstIndex);
+         int i;
+         for (i=0; i<sketch->nbBuckets; i++)
+         {
+            ch += sprintf(ch, ":%u", sketch->counts[i]);
+         }
+      }
+   }
+   return sketch->value;
+}
@@ -53,10 +53,13 @@ static bool _toLockForOneCall(DM_ENG_EntityType entity)
  * @param entity Entity number
  * @param inform Inform callback
  * @param transferComplete callback
+ * @param updateConnectionRequestCredentials Callback receiving the connection request username and password
+ * at start and when they change
  */
-void DM_ENG_ActivateNotification(DM_ENG_EntityType entity, DM_ENG_F_INFORM inform, DM_ENG_F_TRANSFER_COMPLETE transferComplete, DM_ENG_F_REQUEST_DOWNLOAD requestDownload, DM_ENG_F_UPDATE_ACS_PARAMETERS updateAcsParameters)
+void DM_ENG_ActivateNotification(DM_ENG_EntityType entity, DM_ENG_F_INFORM inform, DM_ENG_F_TRANSFER_COMPLETE transferComplete, DM_ENG_F_REQUEST_DOWNLOAD requestDownload, DM_ENG_F_UPDATE_ACS_PARAMETERS updateAcsParameters,
+   DM_ENG_F_UPDATE_CONNECTION_REQUEST_CREDENTIALS updateConnectionRequestCredentials)
 {
-   DM_ENG_NotificationInterface_activate(entity, inform, transferComplete, requestDownload, updateAcsParameters);
+   DM_ENG_NotificationInterface_activate(entity, inform, transferComplete, requestDownload, updateAcsParameters, updateConnectionRequestCredentials);
 }
 
 /**
@@ -192,6 +195,27 @@ int DM_ENG_GetRPCMethods(DM_ENG_EntityType entity UNUSED, OUT const char** pMeth
    return 0;
 }
 
+/*
+ * Paramtre d'un SetParameterValues, recherch une seule fois pour son chargement, sa modification et sa validation
+ */
+typedef struct _ParameterToSet
+{
+   DM_ENG_Parameter* param;
+   unsigned int structureVersion; // param reste valide tant qu'aucun paramtre n'est ajout ou supprim (0 : pas encore recherch)
+
+} ParameterToSet;
+
+static DM_ENG_Parameter* _getParameterToSet(ParameterToSet* pToSet, const char* name)
+{
+   unsigned int version = DM_ENG_ParameterManager_getStructureVersion();
+   if (pToSet->structureVersion != version)
+   {
+      pToSet->param = DM_ENG_ParameterManager_getParameter(name);
+      pToSet->structureVersion = version;
+   }
+   return pToSet->param;
+}
+
 /**
  * This function may be used by the ACS to modify the value of one or more CPE Parameters.
  *
@@ -238,6 +262,7 @@ int DM_ENG_SetParameterValues(DM_ENG_EntityType entity, DM_ENG_ParameterValueStr
       int size = 0;
       while (parameterList[size] != NULL) { size++; }
       DM_ENG_SystemParameterValueStruct** systemParameterList = DM_ENG_newTabSystemParameterValueStruct(size);
+      ParameterToSet* toSet = (ParameterToSet*)calloc(size+1, sizeof(ParameterToSet));
       int iSysPrm = 0;
       int i;
    	for (i=0; i<size; i++)
@@ -246,12 +271,16 @@ int DM_ENG_SetParameterValues(DM_ENG_EntityType entity, DM_ENG_ParameterValueStr
          DM_ENG_ParameterStatus stat = DM_ENG_ParameterStatus_UNDEFINED;
          char* systemName = NULL;
          char* systemData = NULL;
+         DM_ENG_Parameter* param = _getParameterToSet(&toSet[i], name);
          DBG("parameterName = %s", name);
-         res = DM_ENG_ParameterManager_loadSystemParameters(name, false);
+         // Les objets systme  chargement group sont chargs une seule fois, pour leur 1er paramtre
+         // Un nom inconnu peut tre celui d'une instance systme encore non charge
+         res = ( param != NULL ? DM_ENG_ParameterManager_loadSystemParameter(param, false)
+                               : DM_ENG_ParameterManager_loadSystemParameters(name, false) );
          if (res == 0)
          {
    	      DBG("parameterName = %s, type = %d, Value = %s", name, parameterList[i]->type, parameterList[i]->value);
-            res = DM_ENG_ParameterManager_setParameterValue( entity, name, parameterList[i]->type, parameterList[i]->value, &stat, &systemName, &systemData);
+            res = DM_ENG_ParameterManager_setResolvedParameterValue( entity, _getParameterToSet(&toSet[i], name), name, parameterList[i]->type, parameterList[i]->value, &stat, &systemName, &systemData);
          }
          if ((res == 0) || (res == 1))
          {
@@ -294,14 +323,16 @@ int DM_ENG_SetParameterValues(DM_ENG_EntityType entity, DM_ENG_ParameterValueStr
 
       for (i=0; i<size; i++)
       {
+         DM_ENG_Parameter* param = _getParameterToSet(&toSet[i], parameterList[i]->parameterName);
          if (nbFaults == 0)
          {
             DBG("nbFaults == 0");
-            DM_ENG_ParameterManager_commitParameter( parameterList[i]->parameterName );
+            DM_ENG_ParameterManager_commitResolvedParameter( param, parameterList[i]->parameterName );
          } else {
-            DM_ENG_ParameterManager_unsetParameter( parameterList[i]->parameterName );
+            DM_ENG_ParameterManager_unsetResolvedParameter( param, parameterList[i]->parameterName );
          }
       }
+      free(toSet);
    }
 
    if (lockedForThisCall) {
@@ -31,10 +31,15 @@
 #include "DM_ENG_StatisticsModule.h"
 #include "DM_ENG_ParameterData.h"
 #include "DM_ENG_ParameterManager.h"
+#include "DM_ENG_Global.h"
 #include "DM_ENG_ComputedExp.h"
+#include "DM_ENG_Histogram.h"
+#include "DM_ENG_QuantileSketch.h"
 #include "DM_ENG_Device.h"
 #include "DM_CMN_Thread.h"
 #include "CMN_Trace.h"
+#include <ctype.h>
+#include <unistd.h>
 
 static const char* _INTERNAL_SEPARATOR   = "!";
 
@@ -79,6 +84,11 @@ static const char* _OR_SUFFIX            = "!Or";
 static const char* _HISTOGRAM_SUFFIX     = "!Histogram";
 static const char* _TIMESTAMP_SUFFIX     = "!Timestamp";
 static const char* _DELAY_HISTOGRAM_SUFFIX = "!DelayHistogram";
+static const char* _SKETCH_SUFFIX        = "!Sketch";
+
+// quantiles calculs  partir du !Sketch
+static const char* _QUANTILE_SUFFIXES[]  = { "!P50", "!P90", "!P99", NULL };
+static const unsigned int _QUANTILE_PERCENTS[] = { 50, 90, 99 };
 
 static const char* _SAMPLE_ENABLE_NAME   = "SampleEnable";
 static const char* _TIME_REFERENCE_NAME  = "TimeReference";
@@ -97,14 +107,47 @@ static unsigned int _SUB_SAMPLE_INTERVAL_DEFAULT = 3600; // 1 heure
 static unsigned int _SAMPLE_INTERVAL_DEFAULT     = 3600; // 1 heure (cf. TR-157)
 static unsigned int _REPORT_SAMPLES_DEFAULT      = 24; // (cf. TR-157)
 static unsigned int _INITIAL_RETRY_DELAY         = 2; // 2 secondes
+static unsigned int _CHECKPOINT_INTERVAL_DEFAULT = 300; // 5 minutes
 
 static const int _MAX_INTERVALS = 20; // Nb d'intervalles max des histogrammes
+static const int _MAX_SAMPLE_WORKERS = 4; // Nb max de threads pour la collecte parallle des donnes (thread de polling compris)
 
 static DM_ENG_ParameterValueStruct* statsToPoll = NULL;
 static DM_CMN_ThreadId_t _pollingThreadId = 0;
 static DM_CMN_Mutex_t _pollingMutex = NULL;
 static DM_CMN_Cond_t _pollingCond = NULL;
 
+static DM_ENG_Histogram* _histograms = NULL; // histogrammes dj analyss (accs sous le verrou du DM)
+static DM_ENG_QuantileSketch* _sketches = NULL; // id. pour les sketchs de quantiles
+
+static time_t _lastCheckpointTime = 0; // dernire sauvegarde des valeurs de statistique
+
+/*
+ * Collecte (appel DM_ENG_Device_getSampleData) des donnes d'un objet stats arriv  chance
+ */
+typedef struct _SampleFetch
+{
+   char* parameterName; // copies prises sous le verrou du DM, l'objet stats pouvant tre supprim pendant la collecte
+   char* value;
+   time_t lastTimestamp;
+   time_t pollingTime;
+   int res;
+   DM_ENG_SampleDataStruct* sampleData;
+
+} __attribute((packed)) SampleFetch;
+
+// Pool de threads de collecte, dmarr par le thread de polling quand plusieurs objets stats arrivent  chance ensemble
+static DM_CMN_ThreadId_t* _sampleWorkerIds = NULL;
+static int _nbSampleWorkers = 0;
+static DM_CMN_Mutex_t _fetchMutex = NULL;
+static DM_CMN_Cond_t _fetchCond = NULL;     // nouvelles collectes  faire ou arrt du pool
+static DM_CMN_Cond_t _fetchDoneCond = NULL; // fin des collectes en cours
+static SampleFetch* _fetches = NULL; // collectes en cours (accs sous _fetchMutex)
+static int _nbFetches = 0;
+static int _nextFetch = 0;
+static int _pendingFetches = 0;
+static bool _sampleWorkersExiting = false;
+
 static DM_ENG_F_GET_VALUE _getValue = NULL;
 static DM_ENG_F_CREATE_PARAMETER _createParam = NULL;
 
@@ -119,6 +162,16 @@ enum _Status
 
 static void _signalPolling();
 
+static bool _isQuantileSuffix(const char* suffix)
+{
+   int i;
+   for (i=0; _QUANTILE_SUFFIXES[i] != NULL; i++)
+   {
+      if (strcmp(suffix, _QUANTILE_SUFFIXES[i]+1) == 0) { return true; }
+   }
+   return false;
+}
+
 static DM_ENG_Parameter* _getStatParameter(const char* statObject, const char* paramName)
 {
    char* longName = (char*) malloc(strlen(statObject)+strlen(paramName)+1);
@@ -143,14 +196,14 @@ static char* _simpleGetValue(DM_ENG_Parameter* prm) // simple redirection permis
 
 static void _updateNewValue(DM_ENG_Parameter* prm, char* val)
 {
-   DM_ENG_Parameter_updateValue(prm, (val == NULL ? (char*)DM_ENG_EMPTY : val), true);
+   DM_ENG_Parameter_updateStatsValue(prm, (val == NULL ? (char*)DM_ENG_EMPTY : val), true);
 }
 
 static void _updateValueIfChanged(DM_ENG_Parameter* prm, char* val)
 {
    if ((prm != NULL) && ((prm->value == NULL) || (strcmp(prm->value, val) != 0)))
    {
-      DM_ENG_Parameter_updateValue(prm, val, true);
+      DM_ENG_Parameter_updateStatsValue(prm, val, true);
    }
 }
 
@@ -339,6 +392,14 @@ static char* _createInternalParams(DM_ENG_ComputedExp* exp, char* destName, DM_E
                         _createParam(internalName, destName, DM_ENG_ParameterType_UINT, NULL, configKey);
                         free(internalName);
                      }
+                     else if (_isQuantileSuffix(suffix)) // vrifier que le sketch est cr
+                     {
+                        internalName = (char*) malloc(strlen(root)+strlen(_SKETCH_SUFFIX)+1);
+                        strcpy(internalName, root);
+                        strcat(internalName, _SKETCH_SUFFIX);
+                        _createParam(internalName, destName, DM_ENG_ParameterType_STRING, NULL, configKey);
+                        free(internalName);
+                     }
                      else if (strcmp(suffix, _DELAY_HISTOGRAM_SUFFIX+1) == 0) // vrifier que le Timestamp dans la branche Reading est cr
                      {
                         const char* ch1 = _TOTAL_NODE;                  // point  amliorer !!
@@ -462,6 +523,8 @@ static void _clearStatsToPoll()
       DM_ENG_deleteParameterValueStruct(stp);
       stp = statsToPoll;
    }
+   DM_ENG_deleteAllHistogram(&_histograms);
+   DM_ENG_deleteAllQuantileSketch(&_sketches);
 }
 
 void DM_ENG_StatisticsModule_init(DM_ENG_F_CREATE_PARAMETER createParam, DM_ENG_F_GET_VALUE getValue)
@@ -753,7 +816,7 @@ static void _pushSample(const char* statObject, T_PUSH_CASE pushCase, time_t arg
             param = DM_ENG_ParameterData_getParameter(resumeName); // on recharge le param courant
          }
          char* sCurrentValue = (param->value == NULL ? NULL : strdup(param->value));
-         if ((pushCase != _FORCE_SAMPLE) && !slidingMode) { DM_ENG_Parameter_updateValue(param, (char*)DM_ENG_EMPTY, false); } // sinon on ne raz pas les valeurs
+         if ((pushCase != _FORCE_SAMPLE) && !slidingMode) { DM_ENG_Parameter_updateStatsValue(param, (char*)DM_ENG_EMPTY, false); } // sinon on ne raz pas les valeurs
 
          char* shortName = resumeName+strlen(currentNodeName);
          param = _getStatParameter(samplesNodeName, shortName);
@@ -1057,82 +1120,177 @@ static bool _getUIntArgValue(char* args, unsigned int* pVal, char** pNextArg, co
    return res;
 }
 
-static void _computeHisto(const char* nameHisto, unsigned int value)
+/*
+ * Vrai si les bornes sont toutes donnes littralement (pas de nom de paramtre), auquel cas elles peuvent tre gardes
+ */
+static bool _isLiteralIntervals(const char* sIntervals)
+{
+   for (; *sIntervals != '\0'; sIntervals++)
+   {
+      if (!isdigit(*sIntervals) && (*sIntervals != ':') && !isspace(*sIntervals)) { return false; }
+   }
+   return true;
+}
+
+/*
+ * Fournit l'histogramme natif associ au paramtre nameHisto, avec ses compteurs  jour de la valeur du paramtre.
+ * Les bornes ne sont relues que si leur dfinition a chang (ou si elles font rfrence  d'autres paramtres)
+ * et les compteurs ne sont relus que si la valeur du paramtre a t modifie par ailleurs (reset, report...).
+ *
+ * Attention, effet de bord : cette fonction change le current parameter !
+ */
+static DM_ENG_Histogram* _getHisto(const char* nameHisto)
 {
    DM_ENG_Parameter* param = DM_ENG_ParameterData_getParameter(nameHisto);
-   if (param != NULL)
+   if ((param == NULL) || (param->definition == NULL) || (strlen(param->definition) == 0)) { return NULL; }
+
+   char* sIntervals = NULL;
+
+   // redirection vers le paramtre dfinissant les intervalles
+   char* longName = DM_ENG_Parameter_getLongName(param->definition, nameHisto);
+   if (DM_ENG_ParameterManager_getParameterValue(longName, &sIntervals) != 0) // autoriser une expression !! -> DM_ENG_ComputedExp_eval(param->definition, _getValue, nameHisto, &sIntervals);
    {
-      if ((param->definition != NULL) && (strlen(param->definition) > 0))
-      {
-         char* sIntervals = NULL;
+      sIntervals = strdup(param->definition);
+   }
+   free(longName);
+   if (sIntervals == NULL) { return NULL; }
 
-         // redirection vers le paramtre dfinissant les intervalles
-         char* longName = DM_ENG_Parameter_getLongName(param->definition, nameHisto);
-         if (DM_ENG_ParameterManager_getParameterValue(longName, &sIntervals) != 0) // autoriser une expression !! -> DM_ENG_ComputedExp_eval(param->definition, _getValue, nameHisto, &sIntervals);
-         {
-            sIntervals = strdup(param->definition);
-         }
-         free(longName);
+   DM_ENG_Histogram* histo = DM_ENG_Histogram_find(_histograms, nameHisto);
+   if ((histo == NULL) || (histo->definition == NULL) || (strcmp(histo->definition, sIntervals) != 0) || !_isLiteralIntervals(sIntervals))
+   {
+      // on lit les valeurs des bornes
+      char* def = strdup(sIntervals);
+      unsigned int intervals[_MAX_INTERVALS];
+      int nbIntervals = 0;
+      while ((sIntervals != NULL) && (nbIntervals<_MAX_INTERVALS))
+      {
+         char* next = NULL;
+         intervals[nbIntervals] = (nbIntervals == 0 ? 0 : UINT_MAX);
+         _getUIntArgValue(sIntervals, &intervals[nbIntervals], &next, nameHisto);
+         free(sIntervals);
+         sIntervals = next;
+         nbIntervals++;
+      }
+      if (histo == NULL)
+      {
+         histo = DM_ENG_newHistogram(nameHisto, def, intervals, nbIntervals);
+         DM_ENG_addHistogram(&_histograms, histo);
+      }
+      else
+      {
+         DM_ENG_Histogram_setBounds(histo, def, intervals, nbIntervals);
+      }
+      free(def);
+   }
+   if (sIntervals != NULL) { free(sIntervals); }
 
-         if (sIntervals != NULL)
-         {
-            // on lit les valeurs des bornes
-            unsigned int intervals[_MAX_INTERVALS];
-            intervals[0] = 0;
-            int i;
-            for (i=1; i<_MAX_INTERVALS; i++) { intervals[i] = UINT_MAX; }
-            int nbIntervals = 0;
-            while ((sIntervals != NULL) && (nbIntervals<_MAX_INTERVALS))
-            {
-               char* next = NULL;
-               _getUIntArgValue(sIntervals, &intervals[nbIntervals], &next, nameHisto);
-               free(sIntervals);
-               sIntervals = next;
-               nbIntervals++;
-            }
-            if (sIntervals != NULL) { free(sIntervals); }
-
-            // on lit les valeurs de l'histogramme
-            param = DM_ENG_ParameterData_getParameter(nameHisto); // on recharge le param courant
-            unsigned int histogram[_MAX_INTERVALS];
-            for (i=0; i<nbIntervals; i++) { histogram[i] = 0; }
-            i=0;
-            char* sHisto = param->value;
-            while ((sHisto != NULL) && (i<nbIntervals))
-            {
-               char* next = NULL;
-               _getUIntArgValue(sHisto, &histogram[i], &next, nameHisto);
-               if (i != 0) { free(sHisto); }
-               sHisto = next;
-               i++;
-            }
-            if (sHisto != NULL) { free(sHisto); } // rq: nbIntervals>=1 donc sHisto != param->value
+   // on relit les valeurs de l'histogramme si elles ne sont plus celles calcules la dernire fois
+   param = DM_ENG_ParameterData_getParameter(nameHisto); // on recharge le param courant
+   if ((histo->value == NULL) || (param->value == NULL) || (strcmp(param->value, histo->value) != 0))
+   {
+      DM_ENG_Histogram_setCounts(histo, param->value);
+   }
+   return histo;
+}
 
-            // on incrmente la bonne colonne de l'histogramme
-            i = 0;
-            while ((i<nbIntervals) && (value > intervals[i])) { i++; }
-            if (i<nbIntervals) { histogram[i]++; }
+static void _computeHisto(const char* nameHisto, unsigned int value)
+{
+   DM_ENG_Histogram* histo = _getHisto(nameHisto);
+   if (histo != NULL)
+   {
+      // on incrmente la bonne colonne de l'histogramme
+      DM_ENG_Histogram_addSample(histo, value);
+      _updateNewValue(DM_ENG_ParameterData_getParameter(nameHisto), (char*)DM_ENG_Histogram_getValue(histo));
+   }
+}
 
-            size_t sizeMaxHisto = nbIntervals*2;
-            if (param->value != NULL) { sizeMaxHisto += strlen(param->value); } // majoration sre de la taille
-            sHisto = (char*) malloc(sizeMaxHisto+1);
-            for (i=0; i<nbIntervals; i++)
-            {
-               char* sVal = DM_ENG_uintToString(histogram[i]);
-               if (i==0) { strcpy(sHisto, sVal); }
-               else { strcat(sHisto, ":"); strcat(sHisto, sVal); }
-               free(sVal);
-            }
-            _updateNewValue(param, sHisto);
-            free(sHisto);
-         }
+/*
+ * Fournit le tableau des valeurs entires de la liste csv (les valeurs vides ou invalides sont ignores)
+ * et retourne le nombre de valeurs. *pValues est  librer par l'appelant.
+ */
+static int _csvToUintArray(const char* csv, unsigned int** pValues)
+{
+   int nbValues = 0;
+   *pValues = NULL;
+   if ((csv != NULL) && (*csv != '\0'))
+   {
+      *pValues = (unsigned int*) malloc((strlen(csv)/2+1)*sizeof(unsigned int)); // majoration sre du nb de valeurs
+      char* ch0 = strdup(csv);
+      char* ch1 = ch0;
+      while (*ch1 != '\0')
+      {
+         char* ch2 = ch1;
+         while ((*ch2 != '\0') && (*ch2 != ',')) { ch2++; }
+         if (*ch2 == ',') { *ch2 = '\0'; ch2++; }
+         if (DM_ENG_stringToUint(ch1, &(*pValues)[nbValues])) { nbValues++; }
+         ch1 = ch2;
       }
+      free(ch0);
+   }
+   return nbValues;
+}
+
+static void _computeSlidingHisto(const char* nameHisto, const char* csv)
+{
+   DM_ENG_Histogram* histo = _getHisto(nameHisto);
+   if (histo != NULL)
+   {
+      // l'histogramme est recalcul en une fois sur les valeurs de la fentre glissante
+      unsigned int* values = NULL;
+      int nbValues = _csvToUintArray(csv, &values);
+      DM_ENG_Histogram_reset(histo);
+      DM_ENG_Histogram_addSamples(histo, values, nbValues);
+      DM_ENG_FREE(values);
+      _updateNewValue(DM_ENG_ParameterData_getParameter(nameHisto), (char*)DM_ENG_Histogram_getValue(histo));
    }
 }
 
-static void _computeSlidingHisto(const char* nameHisto UNUSED, const char* csv UNUSED)
+/*
+ * Fournit le sketch natif du paramtre name!Sketch, s'il existe,  jour de la valeur du paramtre
+ */
+static DM_ENG_QuantileSketch* _getSketch(const char* name)
 {
-   // TO DO !!
+   DM_ENG_Parameter* param = _getStatParameter(name, _SKETCH_SUFFIX);
+   if (param == NULL) { return NULL; }
+
+   DM_ENG_QuantileSketch* sketch = DM_ENG_QuantileSketch_find(_sketches, param->name);
+   if (sketch == NULL)
+   {
+      sketch = DM_ENG_newQuantileSketch(param->name);
+      DM_ENG_addQuantileSketch(&_sketches, sketch);
+   }
+   else if ((sketch->value != NULL) && (param->value != NULL) && (strcmp(param->value, sketch->value) == 0))
+   {
+      return sketch;
+   }
+   DM_ENG_QuantileSketch_setValue(sketch, param->value);
+   return sketch;
+}
+
+/*
+ * Sauvegarde du sketch et affectation des quantiles name!P50, name!P90...
+ */
+static void _updateQuantiles(const char* name, DM_ENG_QuantileSketch* sketch)
+{
+   DM_ENG_Parameter* param = _getStatParameter(name, _SKETCH_SUFFIX);
+   if (param != NULL)
+   {
+      _updateNewValue(param, (char*)DM_ENG_QuantileSketch_getValue(sketch));
+   }
+
+   int i;
+   for (i=0; _QUANTILE_SUFFIXES[i] != NULL; i++)
+   {
+      param = _getStatParameter(name, _QUANTILE_SUFFIXES[i]);
+      if (param != NULL)
+      {
+         unsigned int quantile = 0;
+         char* sValue = NULL;
+         if (DM_ENG_QuantileSketch_getQuantile(sketch, _QUANTILE_PERCENTS[i], &quantile)) { sValue = DM_ENG_uintToString(quantile); }
+         _updateNewValue(param, sValue);
+         DM_ENG_FREE(sValue);
+      }
+   }
 }
 
 static void _computeStats(const char* name, unsigned int newValue, char* sNewValue, time_t timestamp)
@@ -1282,6 +1440,14 @@ static void _computeStats(const char* name, unsigned int newValue, char* sNewVal
    _computeHisto(nameHisto, newValue);
    free(nameHisto);
 
+   // affection du !Sketch et des quantiles
+   DM_ENG_QuantileSketch* sketch = _getSketch(name);
+   if (sketch != NULL)
+   {
+      DM_ENG_QuantileSketch_addSample(sketch, newValue);
+      _updateQuantiles(name, sketch);
+   }
+
    // autre stats...
 }
 
@@ -1568,6 +1734,18 @@ static void _computeSlidingStats(const char* name, char* sNewValue, const char*
    _computeSlidingHisto(nameHisto, sCsvValue);
    free(nameHisto);
 
+   // affection du !Sketch et des quantiles, recalculs sur la fentre glissante
+   DM_ENG_QuantileSketch* sketch = _getSketch(name);
+   if (sketch != NULL)
+   {
+      unsigned int* values = NULL;
+      int nbValues = _csvToUintArray(sCsvValue, &values);
+      DM_ENG_QuantileSketch_reset(sketch);
+      DM_ENG_QuantileSketch_addSamples(sketch, values, nbValues);
+      DM_ENG_FREE(values);
+      _updateQuantiles(name, sketch);
+   }
+
    // autre stats...
    if (sCsvValue != NULL) { free(sCsvValue); }
 }
@@ -1708,6 +1886,25 @@ static void _processOneData(char* name, char* sNewValue, DM_ENG_SampleDataStruct
    }
 }
 
+/*
+ * Sauvegarde les valeurs de statistique si l'intervalle de checkpoint est coul ( chaque chantillon si l'intervalle est nul)
+ */
+static void _checkpointStatistics()
+{
+   if (!DM_ENG_Parameter_isStatsDataChanged()) return;
+
+   unsigned int checkpointInterval = _CHECKPOINT_INTERVAL_DEFAULT;
+   DM_ENG_Parameter* param = DM_ENG_ParameterData_getParameter(DM_ENG_STATS_CHECKPOINT_INTERVAL_NAME);
+   if (param != NULL) { DM_ENG_stringToUint(param->value, &checkpointInterval); }
+
+   time_t now = time(NULL);
+   if ((now < _lastCheckpointTime) || (now >= (time_t)(_lastCheckpointTime + checkpointInterval)))
+   {
+      DM_ENG_ParameterData_syncStatistics();
+      _lastCheckpointTime = now;
+   }
+}
+
 void DM_ENG_StatisticsModule_processSampleData(DM_ENG_SampleDataStruct* sd)
 {
    if ((sd->statObject != NULL) && (sd->parameterList != NULL))
@@ -1949,6 +2146,7 @@ void DM_ENG_StatisticsModule_processSampleData(DM_ENG_SampleDataStruct* sd)
             if ((strlen(prmName) > strlen(readingNodeName)) && (strncmp(prmName, readingNodeName, strlen(readingNodeName)) == 0))
             {
                param = DM_ENG_ParameterData_getCurrent();
+               DM_ENG_Parameter_markStatsValue(param);
                DM_ENG_Parameter_unmarkPushed(param);
             }
          }
@@ -1964,11 +2162,140 @@ void DM_ENG_StatisticsModule_processSampleData(DM_ENG_SampleDataStruct* sd)
          if (currentNodeName != NULL) { free(currentNodeName); }
 
          DM_ENG_ParameterData_sync();
+         _checkpointStatistics();
       }
    }
    DM_ENG_deleteSampleDataStruct(sd);
 }
 
+static void _fetchOne(SampleFetch* fetch)
+{
+   DM_ENG_SampleDataStruct* sampleData = NULL;
+   fetch->res = DM_ENG_Device_getSampleData(fetch->parameterName, fetch->lastTimestamp, fetch->value, &sampleData);
+   fetch->sampleData = sampleData;
+}
+
+/*
+ * Effectue les collectes restantes. Appel sous _fetchMutex, par les threads du pool comme par le thread de polling
+ */
+static void _doFetches()
+{
+   while (_nextFetch < _nbFetches)
+   {
+      SampleFetch* fetch = &_fetches[_nextFetch++];
+      DM_CMN_Thread_unlockMutex(_fetchMutex);
+      _fetchOne(fetch);
+      DM_CMN_Thread_lockMutex(_fetchMutex);
+      if (--_pendingFetches == 0) { DM_CMN_Thread_signalCond(_fetchDoneCond); }
+   }
+}
+
+static void* _runSampleWorker(void* data UNUSED)
+{
+   DM_CMN_Thread_lockMutex(_fetchMutex);
+   while (!_sampleWorkersExiting)
+   {
+      _doFetches();
+      if (!_sampleWorkersExiting) { DM_CMN_Thread_waitCond(_fetchCond, _fetchMutex); }
+   }
+   DM_CMN_Thread_unlockMutex(_fetchMutex);
+   return 0;
+}
+
+/*
+ * Dmarre un thread de collecte par coeur disponible, le thread de polling faisant lui-mme partie des collecteurs
+ */
+static void _startSampleWorkers()
+{
+   long nbCpus = sysconf(_SC_NPROCESSORS_ONLN);
+   int nbWorkers = (nbCpus > _MAX_SAMPLE_WORKERS ? _MAX_SAMPLE_WORKERS : (int)nbCpus) - 1;
+
+   DM_CMN_Thread_initMutex(&_fetchMutex);
+   DM_CMN_Thread_initCond(&_fetchCond);
+   DM_CMN_Thread_initCond(&_fetchDoneCond);
+   _sampleWorkersExiting = false;
+   _nbSampleWorkers = 0;
+   if (nbWorkers > 0)
+   {
+      _sampleWorkerIds = (DM_CMN_ThreadId_t*)calloc(nbWorkers, sizeof(DM_CMN_ThreadId_t));
+      while ((_nbSampleWorkers < nbWorkers) && (DM_CMN_Thread_create(_runSampleWorker, NULL, true, &_sampleWorkerIds[_nbSampleWorkers]) == 0))
+      {
+         _nbSampleWorkers++;
+      }
+   }
+   DBG("Sample data workers started : %d", _nbSampleWorkers);
+}
+
+static void _stopSampleWorkers()
+{
+   if (_fetchMutex == NULL) return;
+
+   DM_CMN_Thread_lockMutex(_fetchMutex);
+   _sampleWorkersExiting = true;
+   DM_CMN_Thread_broadcastCond(_fetchCond);
+   DM_CMN_Thread_unlockMutex(_fetchMutex);
+
+   int i;
+   for (i=0; i<_nbSampleWorkers; i++) { DM_CMN_Thread_join(_sampleWorkerIds[i]); }
+   _nbSampleWorkers = 0;
+   if (_sampleWorkerIds != NULL) { free(_sampleWorkerIds); _sampleWorkerIds = NULL; }
+
+   DM_CMN_Thread_destroyCond(_fetchDoneCond); _fetchDoneCond = NULL;
+   DM_CMN_Thread_destroyCond(_fetchCond); _fetchCond = NULL;
+   DM_CMN_Thread_destroyMutex(_fetchMutex); _fetchMutex = NULL;
+}
+
+/*
+ * Collecte les donnes des objets stats arrivs  chance, en parallle s'il y en a plusieurs.
+ * Appel par le thread de polling sous _pollingMutex, sans le verrou du DM.
+ */
+static void _fetchSampleData(SampleFetch fetches[], int nbFetches)
+{
+   if ((nbFetches > 1) && (_fetchMutex == NULL)) { _startSampleWorkers(); }
+
+   if ((nbFetches == 1) || (_nbSampleWorkers == 0))
+   {
+      int i;
+      for (i=0; i<nbFetches; i++) { _fetchOne(&fetches[i]); }
+   }
+   else
+   {
+      DM_CMN_Thread_lockMutex(_fetchMutex);
+      _fetches = fetches;
+      _nbFetches = nbFetches;
+      _nextFetch = 0;
+      _pendingFetches = nbFetches;
+      DM_CMN_Thread_broadcastCond(_fetchCond);
+      _doFetches();
+      while (_pendingFetches > 0) { DM_CMN_Thread_waitCond(_fetchDoneCond, _fetchMutex); }
+      _fetches = NULL;
+      _nbFetches = 0;
+      _nextFetch = 0;
+      DM_CMN_Thread_unlockMutex(_fetchMutex);
+   }
+}
+
+/*
+ * Retrouve par son nom l'objet stats toujours  collecter (il a pu tre dsactiv, voire supprim et recr, pendant la collecte)
+ */
+static DM_ENG_ParameterValueStruct* _getStillPolled(const char* parameterName)
+{
+   DM_ENG_ParameterValueStruct* p = statsToPoll;
+   while ((p != NULL) && (strcmp(p->parameterName, parameterName) != 0)) { p = p->next; }
+   return p;
+}
+
+static void _freeFetches(SampleFetch fetches[], int nbFetches)
+{
+   int i;
+   for (i=0; i<nbFetches; i++)
+   {
+      free(fetches[i].parameterName);
+      if (fetches[i].value != NULL) { free(fetches[i].value); }
+   }
+   free(fetches);
+}
+
 /*
  *
  */
@@ -2001,18 +2328,21 @@ static void* _runPolling(void* data UNUSED)
       }
 
       time_t nextPollingTime = 0;
+      int nbStats = 0;
       DM_ENG_ParameterValueStruct* stp = statsToPoll; // accs sous mutex
-      time_t lastTimestamp = 0; // pour le stp courant
-      time_t pollingTime = 0;   // id.
+      while (stp != NULL) { nbStats++; stp = stp->next; }
+      SampleFetch* fetches = (SampleFetch*)calloc(nbStats, sizeof(SampleFetch)); // objets stats arrivs  chance
+      int nbFetches = 0;
+      stp = statsToPoll;
       while (stp != NULL)
       {
          // Calcul du prochain pollingTime
          DM_ENG_Parameter* prm = _getStatParameter(stp->parameterName, _LAST_TIMESTAMP_NAME);
-         lastTimestamp = 0;
+         time_t lastTimestamp = 0;
          if (prm != NULL) { DM_ENG_dateStringToTime(prm->value, &lastTimestamp); }
 
          time_t now = time(NULL);
-         pollingTime = stp->timestamp; // la date de la prcdente tentative
+         time_t pollingTime = stp->timestamp; // la date de la prcdente tentative
          if (pollingTime == 0) { pollingTime = lastTimestamp; } //  dfaut, on prend le lastTimestamp
 
          unsigned int subSampleInterval = _SUB_SAMPLE_INTERVAL_DEFAULT;
@@ -2056,51 +2386,66 @@ static void* _runPolling(void* data UNUSED)
          }
          if ((nextPollingTime == 0) || (pollingTime < nextPollingTime)) { nextPollingTime = pollingTime; }
 
-         if (pollingTime <= now) break;
+         if (pollingTime <= now) // donnes  collecter
+         {
+            fetches[nbFetches].parameterName = strdup(stp->parameterName);
+            fetches[nbFetches].value = (stp->value == NULL ? NULL : strdup(stp->value));
+            fetches[nbFetches].lastTimestamp = lastTimestamp;
+            fetches[nbFetches].pollingTime = pollingTime;
+            nbFetches++;
+         }
 
          stp = stp->next;
       }
 
-      if (stp != NULL) // on va chercher les donnes
+      if (nbFetches > 0) // on va chercher les donnes
       {
-         DBG("SampleData polling (%s) - Begin", stp->parameterName);
-         // on fait le polling
-         DM_ENG_SampleDataStruct* sampleData = NULL;
+         DBG("SampleData polling (%d objects) - Begin", nbFetches);
 
          // on dverrouille pour ne pas bloquer l'accs aux donnes car l'appel DM_ENG_Device_getSampleData peut tre assez long
          DM_CMN_Thread_unlockMutex(_pollingMutex);
          DM_ENG_ParameterManager_unlock();
          DM_CMN_Thread_lockMutex(_pollingMutex);
-         if (_samplingStatus != _RUNNING) continue;
+         if (_samplingStatus != _RUNNING) { _freeFetches(fetches, nbFetches); continue; }
 
-         int res = DM_ENG_Device_getSampleData(stp->parameterName, lastTimestamp, stp->value, &sampleData);
+         _fetchSampleData(fetches, nbFetches);
 
          DM_CMN_Thread_unlockMutex(_pollingMutex);
          DM_ENG_ParameterManager_lockDM();
          DM_CMN_Thread_lockMutex(_pollingMutex);
-         if (_samplingStatus != _RUNNING)
-         {
-            if (sampleData != NULL) { DM_ENG_deleteSampleDataStruct(sampleData); }
-            continue;
-         }
 
-         stp->timestamp = pollingTime;
-         if ((res != 0) || (sampleData == NULL)) // pas de donne obtenue, on configure le mcanisme de retry 
-         {
-            unsigned int retryDelay = (unsigned int)stp->type;
-            if (retryDelay == 0) { retryDelay = _INITIAL_RETRY_DELAY; }
-            else { retryDelay *= 2; } // il sera crt plus tard s'il dpasse le SubSampleInterval
-            stp->type = (DM_ENG_ParameterType)retryDelay;
-         }
-         else // traitement des donnes lues
+         // traitement en srie des donnes lues, sous le verrou du DM
+         int i;
+         for (i=0; i<nbFetches; i++)
          {
-            stp->type = 0; // raz du retryDelay
-            DM_ENG_StatisticsModule_processSampleData(sampleData);
+            SampleFetch* fetch = &fetches[i];
+            stp = (_samplingStatus == _RUNNING ? _getStillPolled(fetch->parameterName) : NULL);
+            if (stp == NULL)
+            {
+               if (fetch->sampleData != NULL) { DM_ENG_deleteSampleDataStruct(fetch->sampleData); }
+               continue;
+            }
+
+            stp->timestamp = fetch->pollingTime;
+            if ((fetch->res != 0) || (fetch->sampleData == NULL)) // pas de donne obtenue, on configure le mcanisme de retry 
+            {
+               unsigned int retryDelay = (unsigned int)stp->type;
+               if (retryDelay == 0) { retryDelay = _INITIAL_RETRY_DELAY; }
+               else { retryDelay *= 2; } // il sera crt plus tard s'il dpasse le SubSampleInterval
+               stp->type = (DM_ENG_ParameterType)retryDelay;
+            }
+            else // traitement des donnes lues
+            {
+               stp->type = 0; // raz du retryDelay
+               DM_ENG_StatisticsModule_processSampleData(fetch->sampleData);
+            }
          }
+         _freeFetches(fetches, nbFetches);
          DBG("SampleData polling - End");
       }
       else // on attend le nextPollingTime
       {
+         free(fetches);
          DM_CMN_Thread_unlockMutex(_pollingMutex);
          DM_ENG_ParameterManager_unlock();
          DM_CMN_Thread_lockMutex(_pollingMutex);
@@ -2116,6 +2461,7 @@ static void* _runPolling(void* data UNUSED)
          DM_CMN_Thread_lockMutex(_pollingMutex);
       }
    }
+   _stopSampleWorkers();
    _pollingThreadId = 0;
 
    DM_CMN_Thread_unlockMutex(_pollingMutex);
@@ -190,6 +190,15 @@ int DM_CMN_Thread_timedWaitCond(IN DM_CMN_Cond_t cond, IN DM_CMN_Mutex_t mutex,
  */
 int DM_CMN_Thread_signalCond(IN DM_CMN_Cond_t cond);
 
+/**
+ * Wakes up all the threads that are currently waiting on the condition.
+ * 
+ * @param cond A condition object
+ * 
+ * @return 0 if OK, otherwise an error code
+ */
+int DM_CMN_Thread_broadcastCond(IN DM_CMN_Cond_t cond);
+
 /**
  * Destroys the condition.
  * 
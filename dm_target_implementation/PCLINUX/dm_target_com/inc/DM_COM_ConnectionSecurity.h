@@ -24,10 +24,27 @@
 #ifndef _DM_COM_CONNECTION_SECURITY_H_
 #define _DM_COM_CONNECTION_SECURITY_H_
 
-#define MAXCONNECTIONREQUESTARRAYSIZE (100)
+// Delay (in seconds) after which the MaxConnectionRequest and FreqConnectionRequest
+// parameters are read again from the data model
+#define CONNECTION_REQUEST_POLICY_REFRESH (10)
 
-void initConnectionFreqArray(time_t*);
-void newConnectionRequestAllowed(time_t*);
-bool maxConnectionPerPeriodReached(time_t*);
+// Object of the connection request counters (HTTPAllowed, HTTPRejected, UDPAllowed, UDPRejected)
+// in the data model, without the prefix
+#define CONNECTION_REQUEST_STATS_OBJECT "ManagementServer.X_ORANGE-COM_ConnectionRequestStats."
+
+// The connection request paths, each one limited by its own token bucket
+typedef enum _ConnectionRequestPath
+{
+  CONNECTION_REQUEST_HTTP = 0,  // HTTP connection requests (http server)
+  CONNECTION_REQUEST_UDP,       // UDP connection requests (STUN)
+  CONNECTION_REQUEST_NB_PATHS
+
+} ConnectionRequestPath;
+
+void initConnectionRateLimiter(ConnectionRequestPath);
+void newConnectionRequestAllowed(ConnectionRequestPath);
+bool maxConnectionPerPeriodReached(ConnectionRequestPath);
+unsigned int getConnectionRequestAllowedCount(ConnectionRequestPath);
+unsigned int getConnectionRequestRejectedCount(ConnectionRequestPath);
 
 #endif
@@ -173,6 +173,7 @@ typedef struct _IXML_Node
     DOMString       prefix;
     DOMString       localName;
     BOOL            readOnly;
+    BOOL            inArena;        // Allocated in the arena of its ownerDocument (see ixmlDocument_createArenaDocumentEx)
 
     Nodeptr         parentNode;
     Nodeptr         firstChild;
@@ -185,7 +186,10 @@ typedef struct _IXML_Node
 
 typedef struct _IXML_Document
 {
-    IXML_Node    n;
+    IXML_Node           n;
+    struct _ixml_arena *arena;          // NULL if the nodes of the document are allocated one by one
+    BOOL                hasHeapNodes;   // Heap nodes attached to an arena document : its release walks the tree
+
 } IXML_Document;
 
 typedef struct _IXML_CDATASection
@@ -214,8 +218,9 @@ typedef struct _IXML_Text
 
 typedef struct _IXML_NodeList
 {
-    IXML_Node    *nodeItem;
-    struct  _IXML_NodeList *next;
+    IXML_Node     **nodeItems;  // Contiguous array of the nodes : indexed access in constant time
+    unsigned long   length;
+    unsigned long   capacity;
 } IXML_NodeList;
 
 
@@ -756,6 +761,35 @@ EXPORT_SPEC int ixmlDocument_createDocumentEx(IXML_Document** doc
 
 EXPORT_SPEC IXML_Document* ixmlDocument_createDocument();
 
+  /** Creates a new empty {\bf Document} node in arena mode : the 
+   *  document and all the nodes created by its {\bf ixmlDocument_create*} 
+   *  functions, with their strings, are bump-allocated in blocks owned by 
+   *  the document. {\bf ixmlDocument_free} releases them in one call ; 
+   *  freeing a single node of the document does nothing. Suited to the documents parsed, processed and 
+   *  discarded at once.
+   *
+   *  @return [int] An integer representing one of the following:
+   *    \begin{itemize}
+   *      \item {\tt IXML_SUCCESS}: The operation completed successfully.
+   *      \item {\tt IXML_INSUFFICIENT_MEMORY}: Not enough free memory exists 
+   *            to complete this operation.
+   *    \end{itemize}
+   */
+
+EXPORT_SPEC int ixmlDocument_createArenaDocumentEx(IXML_Document** doc 
+                          /** Pointer to a {\bf Document} where the 
+                    new object will be stored. */
+                        );
+
+  /** Creates a new empty {\bf Document} node in arena mode (see 
+   *  {\bf ixmlDocument_createArenaDocumentEx}).
+   *
+   *  @return [Document*] A pointer to the new {\bf Document} or {\tt NULL} on 
+   *                      failure.
+   */
+
+EXPORT_SPEC IXML_Document* ixmlDocument_createArenaDocument();
+
   /** Creates a new {\bf Element} node with the given tag name.  The new
    *  {\bf Element} node has a {\tt nodeName} of {\bf tagName} and
    *  the {\tt localName}, {\tt prefix}, and {\tt namespaceURI} set 
@@ -1662,7 +1696,7 @@ ixmlNamedNodeMap_free(IXML_NamedNodeMap *nnMap
 /*! @{ */
 
   /** Retrieves a {\bf Node} from a {\bf NodeList} specified by a 
-   *  numerical index.
+   *  numerical index, in constant time.
    *
    *  @return [Node*] A pointer to a {\bf Node} or {\tt NULL} if there was an 
    *                  error.
@@ -1885,6 +1919,47 @@ ixmlLoadDocumentEx(const char* xmlFile,
                parses or {\bf NULL} on an error. */
                  );
 
+  /** Parses an XML text buffer converting it into an IXML DOM representation
+   *  allocated in arena mode (see {\bf ixmlDocument_createArenaDocumentEx}).
+   *
+   *  @return [int] The same codes as {\bf ixmlParseBufferEx}.
+   */
+
+EXPORT_SPEC int
+ixmlParseBufferArenaEx(const char *buffer, 
+          /** The buffer that contains the XML text to convert to a 
+              {\bf Document}. */
+                  IXML_Document** doc 
+          /** A point to store the {\bf Document} if file correctly 
+              parses or {\bf NULL} on an error. */
+                );
+
+  /** Parses an XML text buffer converting it into an IXML DOM representation
+   *  allocated in arena mode (see {\bf ixmlDocument_createArenaDocumentEx}).
+   *
+   *  @return [Document*] A {\bf Document} if the buffer correctly parses or 
+   *                      {\tt NULL} on an error. 
+   */
+
+EXPORT_SPEC IXML_Document*
+ixmlParseBufferArena(const char *buffer 
+        /** The buffer that contains the XML text to convert to a 
+            {\bf Document}. */
+               );
+
+  /** Parses an XML text file converting it into an IXML DOM representation
+   *  allocated in arena mode (see {\bf ixmlDocument_createArenaDocumentEx}).
+   *
+   *  @return [Document*] A {\bf Document} if the file correctly parses or 
+   *                      {\tt NULL} on an error.
+   */
+
+EXPORT_SPEC IXML_Document*
+ixmlLoadDocumentArena(const char* xmlFile      
+         /** The filename of the XML text to convert to a {\bf 
+             Document}. */
+                );
+
   /** Clones an existing {\bf DOMString}.
    *
    *  @return [DOMString] A new {\bf DOMString} that is a duplicate of the 
@@ -56,7 +56,12 @@ void
 ixmlDocument_free( IN IXML_Document * doc )
 {
     if( doc != NULL ) {
-        ixmlNode_free( ( IXML_Node * ) doc );
+        if( ( doc->arena != NULL ) && !doc->hasHeapNodes ) {
+            // all the nodes are in the arena, no need to walk the tree
+            ixml_arena_destroy( doc->arena );
+        } else {
+            ixmlNode_free( ( IXML_Node * ) doc );
+        }
     }
 
 }
@@ -128,6 +133,10 @@ ixmlDocument_importNode( IN IXML_Document * doc,
     }
 
     ixmlDocument_setOwnerDocument( doc, newNode );
+    if( doc->arena != NULL ) {
+        // the clone is allocated in the heap
+        doc->hasHeapNodes = TRUE;
+    }
     *rtNode = newNode;
 
     return IXML_SUCCESS;
@@ -160,14 +169,17 @@ ixmlDocument_createElementEx( IN IXML_Document * doc,
         goto ErrorHandler;
     }
 
-    newElement = ( IXML_Element * ) malloc( sizeof( IXML_Element ) );
+    newElement = ( IXML_Element * ) ixml_doc_malloc( doc, sizeof( IXML_Element ) );
     if( newElement == NULL ) {
         errCode = IXML_INSUFFICIENT_MEMORY;
         goto ErrorHandler;
     }
 
     ixmlElement_init( newElement );
-    newElement->tagName = strdup( tagName );
+    newElement->n.inArena = ( doc->arena != NULL );
+    newElement->n.ownerDocument = doc;
+
+    newElement->tagName = ixml_node_symdup( &newElement->n, tagName );
     if( newElement->tagName == NULL ) {
         ixmlElement_free( newElement );
         newElement = NULL;
@@ -176,7 +188,7 @@ ixmlDocument_createElementEx( IN IXML_Document * doc,
     }
     // set the node fields 
     newElement->n.nodeType = eELEMENT_NODE;
-    newElement->n.nodeName = strdup( tagName );
+    newElement->n.nodeName = ixml_node_symdup( &newElement->n, tagName );
     if( newElement->n.nodeName == NULL ) {
         ixmlElement_free( newElement );
         newElement = NULL;
@@ -184,8 +196,6 @@ ixmlDocument_createElementEx( IN IXML_Document * doc,
         goto ErrorHandler;
     }
 
-    newElement->n.ownerDocument = doc;
-
   ErrorHandler:
     *rtElement = newElement;
     return errCode;
@@ -216,32 +226,49 @@ ixmlDocument_createElement( IN IXML_Document * doc,
 }
 
 /*================================================================
-*   ixmlDocument_createDocumentEx
-*       Creates an document object
+*   ixmlDocument_newDocument
+*       Creates an document object, in arena mode or not
 *       Internal function.
 *   Parameters:
 *       rtDoc:  the document created or NULL on failure
+*       inArena: whether the nodes of the document are allocated in its arena
 *   Return Value:
 *       IXML_SUCCESS
 *       IXML_INSUFFICIENT_MEMORY:   if not enough memory to finish this operations.
 *
 *=================================================================*/
-int
-ixmlDocument_createDocumentEx( OUT IXML_Document ** rtDoc )
+static int
+ixmlDocument_newDocument( OUT IXML_Document ** rtDoc,
+                          IN BOOL inArena )
 {
     IXML_Document *doc;
+    ixml_arena *arena = NULL;
     int errCode = IXML_SUCCESS;
 
     doc = NULL;
-    doc = ( IXML_Document * ) malloc( sizeof( IXML_Document ) );
+    if( inArena ) {
+        arena = ixml_arena_create(  );
+        if( arena == NULL ) {
+            errCode = IXML_INSUFFICIENT_MEMORY;
+            goto ErrorHandler;
+        }
+        doc = ( IXML_Document * ) ixml_arena_alloc( arena, sizeof( IXML_Document ) );
+    } else {
+        doc = ( IXML_Document * ) malloc( sizeof( IXML_Document ) );
+    }
     if( doc == NULL ) {
+        ixml_arena_destroy( arena );
         errCode = IXML_INSUFFICIENT_MEMORY;
         goto ErrorHandler;
     }
 
     ixmlDocument_init( doc );
+    doc->arena = arena;
+    doc->n.inArena = inArena;
+    doc->n.nodeType = eDOCUMENT_NODE;
+    doc->n.ownerDocument = doc;
 
-    doc->n.nodeName = strdup( DOCUMENTNODENAME );
+    doc->n.nodeName = ixml_node_symdup( &doc->n, DOCUMENTNODENAME );
     if( doc->n.nodeName == NULL ) {
         ixmlDocument_free( doc );
         doc = NULL;
@@ -249,14 +276,28 @@ ixmlDocument_createDocumentEx( OUT IXML_Document ** rtDoc )
         goto ErrorHandler;
     }
 
-    doc->n.nodeType = eDOCUMENT_NODE;
-    doc->n.ownerDocument = doc;
-
   ErrorHandler:
     *rtDoc = doc;
     return errCode;
 }
 
+/*================================================================
+*   ixmlDocument_createDocumentEx
+*       Creates an document object
+*       Internal function.
+*   Parameters:
+*       rtDoc:  the document created or NULL on failure
+*   Return Value:
+*       IXML_SUCCESS
+*       IXML_INSUFFICIENT_MEMORY:   if not enough memory to finish this operations.
+*
+*=================================================================*/
+int
+ixmlDocument_createDocumentEx( OUT IXML_Document ** rtDoc )
+{
+    return ixmlDocument_newDocument( rtDoc, FALSE );
+}
+
 /*================================================================
 *   ixmlDocument_createDocument
 *       Creates an document object
@@ -278,6 +319,44 @@ ixmlDocument_createDocument(  )
 
 }
 
+/*================================================================
+*   ixmlDocument_createArenaDocumentEx
+*       Creates an document object whose nodes are allocated in
+*       its arena, released with the document.
+*       External function.
+*   Parameters:
+*       rtDoc:  the document created or NULL on failure
+*   Return Value:
+*       IXML_SUCCESS
+*       IXML_INSUFFICIENT_MEMORY:   if not enough memory to finish this operations.
+*
+*=================================================================*/
+int
+ixmlDocument_createArenaDocumentEx( OUT IXML_Document ** rtDoc )
+{
+    return ixmlDocument_newDocument( rtDoc, TRUE );
+}
+
+/*================================================================
+*   ixmlDocument_createArenaDocument
+*       Creates an document object whose nodes are allocated in
+*       its arena, released with the document.
+*       External function.
+*   Return Value:
+*       A new document object with the nodeName set to "#document".
+*
+*=================================================================*/
+IXML_Document *
+ixmlDocument_createArenaDocument(  )
+{
+    IXML_Document *doc = NULL;
+
+    ixmlDocument_createArenaDocumentEx( &doc );
+
+    return doc;
+
+}
+
 /*================================================================
 *   ixmlDocument_createTextNodeEx
 *       Creates an text node. 
@@ -304,15 +383,17 @@ ixmlDocument_createTextNodeEx( IN IXML_Document * doc,
         goto ErrorHandler;
     }
 
-    returnNode = ( IXML_Node * ) malloc( sizeof( IXML_Node ) );
+    returnNode = ( IXML_Node * ) ixml_doc_malloc( doc, sizeof( IXML_Node ) );
     if( returnNode == NULL ) {
         rc = IXML_INSUFFICIENT_MEMORY;
         goto ErrorHandler;
     }
     // initialize the node
     ixmlNode_init( returnNode );
+    returnNode->inArena = ( doc->arena != NULL );
+    returnNode->ownerDocument = doc;
 
-    returnNode->nodeName = strdup( TEXTNODENAME );
+    returnNode->nodeName = ixml_node_symdup( returnNode, TEXTNODENAME );
     if( returnNode->nodeName == NULL ) {
         ixmlNode_free( returnNode );
         returnNode = NULL;
@@ -321,7 +402,7 @@ ixmlDocument_createTextNodeEx( IN IXML_Document * doc,
     }
     // add in node value
     if( data != NULL ) {
-        returnNode->nodeValue = strdup( data );
+        returnNode->nodeValue = ixml_node_strdup( returnNode, data );
         if( returnNode->nodeValue == NULL ) {
             ixmlNode_free( returnNode );
             returnNode = NULL;
@@ -331,7 +412,6 @@ ixmlDocument_createTextNodeEx( IN IXML_Document * doc,
     }
 
     returnNode->nodeType = eTEXT_NODE;
-    returnNode->ownerDocument = doc;
 
   ErrorHandler:
     *textNode = returnNode;
@@ -379,25 +459,25 @@ ixmlDocument_createAttributeEx( IN IXML_Document * doc,
     IXML_Attr *attrNode = NULL;
     int errCode = IXML_SUCCESS;
 
-    attrNode = ( IXML_Attr * ) malloc( sizeof( IXML_Attr ) );
-    if( attrNode == NULL ) {
-        errCode = IXML_INSUFFICIENT_MEMORY;
+    if( ( doc == NULL ) || ( name == NULL ) ) {
+        errCode = IXML_INVALID_PARAMETER;
         goto ErrorHandler;
     }
 
-    if( ( doc == NULL ) || ( name == NULL ) ) {
-        ixmlAttr_free( attrNode );
-        attrNode = NULL;
-        errCode = IXML_INVALID_PARAMETER;
+    attrNode = ( IXML_Attr * ) ixml_doc_malloc( doc, sizeof( IXML_Attr ) );
+    if( attrNode == NULL ) {
+        errCode = IXML_INSUFFICIENT_MEMORY;
         goto ErrorHandler;
     }
 
     ixmlAttr_init( attrNode );
+    attrNode->n.inArena = ( doc->arena != NULL );
+    attrNode->n.ownerDocument = doc;
 
     attrNode->n.nodeType = eATTRIBUTE_NODE;
 
     // set the node fields
-    attrNode->n.nodeName = strdup( name );
+    attrNode->n.nodeName = ixml_node_symdup( &attrNode->n, name );
     if( attrNode->n.nodeName == NULL ) {
         ixmlAttr_free( attrNode );
         attrNode = NULL;
@@ -405,8 +485,6 @@ ixmlDocument_createAttributeEx( IN IXML_Document * doc,
         goto ErrorHandler;
     }
 
-    attrNode->n.ownerDocument = doc;
-
   ErrorHandler:
     *rtAttr = attrNode;
     return errCode;
@@ -470,7 +548,7 @@ ixmlDocument_createAttributeNSEx( IN IXML_Document * doc,
         goto ErrorHandler;
     }
     // set the namespaceURI field 
-    attrNode->n.namespaceURI = strdup( namespaceURI );
+    attrNode->n.namespaceURI = ixml_node_symdup( &attrNode->n, namespaceURI );
     if( attrNode->n.namespaceURI == NULL ) {
         ixmlAttr_free( attrNode );
         attrNode = NULL;
@@ -543,16 +621,18 @@ ixmlDocument_createCDATASectionEx( IN IXML_Document * doc,
     }
 
     cDSectionNode =
-        ( IXML_CDATASection * ) malloc( sizeof( IXML_CDATASection ) );
+        ( IXML_CDATASection * ) ixml_doc_malloc( doc, sizeof( IXML_CDATASection ) );
     if( cDSectionNode == NULL ) {
         errCode = IXML_INSUFFICIENT_MEMORY;
         goto ErrorHandler;
     }
 
     ixmlCDATASection_init( cDSectionNode );
+    cDSectionNode->n.inArena = ( doc->arena != NULL );
+    cDSectionNode->n.ownerDocument = doc;
 
     cDSectionNode->n.nodeType = eCDATA_SECTION_NODE;
-    cDSectionNode->n.nodeName = strdup( CDATANODENAME );
+    cDSectionNode->n.nodeName = ixml_node_symdup( &cDSectionNode->n, CDATANODENAME );
     if( cDSectionNode->n.nodeName == NULL ) {
         ixmlCDATASection_free( cDSectionNode );
         cDSectionNode = NULL;
@@ -560,7 +640,7 @@ ixmlDocument_createCDATASectionEx( IN IXML_Document * doc,
         goto ErrorHandler;
     }
 
-    cDSectionNode->n.nodeValue = strdup( data );
+    cDSectionNode->n.nodeValue = ixml_node_strdup( &cDSectionNode->n, data );
     if( cDSectionNode->n.nodeValue == NULL ) {
         ixmlCDATASection_free( cDSectionNode );
         cDSectionNode = NULL;
@@ -568,8 +648,6 @@ ixmlDocument_createCDATASectionEx( IN IXML_Document * doc,
         goto ErrorHandler;
     }
 
-    cDSectionNode->n.ownerDocument = doc;
-
   ErrorHandler:
     *rtCD = cDSectionNode;
     return errCode;
@@ -633,7 +711,7 @@ ixmlDocument_createElementNSEx( IN IXML_Document * doc,
         goto ErrorHandler;
     }
     // set the namespaceURI field 
-    newElement->n.namespaceURI = strdup( namespaceURI );
+    newElement->n.namespaceURI = ixml_node_symdup( &newElement->n, namespaceURI );
     if( newElement->n.namespaceURI == NULL ) {
         ixmlElement_free( newElement );
         newElement = NULL;
@@ -81,10 +81,10 @@ ixmlElement_setTagName( IN IXML_Element * element,
     }
 
     if( element->tagName != NULL ) {
-        free( element->tagName );
+        ixml_node_strfree( &element->n, element->tagName );
     }
 
-    element->tagName = strdup( tagName );
+    element->tagName = ixml_node_symdup( &element->n, tagName );
     if( element->tagName == NULL ) {
         rc = IXML_INSUFFICIENT_MEMORY;
     }
@@ -179,7 +179,7 @@ ixmlElement_setAttribute( IN IXML_Element * element,
 
         attrNode = ( IXML_Node * ) newAttrNode;
 
-        attrNode->nodeValue = strdup( value );
+        attrNode->nodeValue = ixml_node_strdup( attrNode, value );
         if( attrNode->nodeValue == NULL ) {
             ixmlAttr_free( newAttrNode );
             errCode = IXML_INSUFFICIENT_MEMORY;
@@ -195,10 +195,10 @@ ixmlElement_setAttribute( IN IXML_Element * element,
 
     } else {
         if( attrNode->nodeValue != NULL ) { // attribute name has a value already
-            free( attrNode->nodeValue );
+            ixml_node_strfree( attrNode, attrNode->nodeValue );
         }
 
-        attrNode->nodeValue = strdup( value );
+        attrNode->nodeValue = ixml_node_strdup( attrNode, value );
         if( attrNode->nodeValue == NULL ) {
             errCode = IXML_INSUFFICIENT_MEMORY;
         }
@@ -241,7 +241,7 @@ ixmlElement_removeAttribute( IN IXML_Element * element,
 
     if( attrNode != NULL ) {    // has the attribute
         if( attrNode->nodeValue != NULL ) {
-            free( attrNode->nodeValue );
+            ixml_node_strfree( attrNode, attrNode->nodeValue );
             attrNode->nodeValue = NULL;
         }
     }
@@ -607,22 +607,22 @@ ixmlElement_setAttributeNS( IN IXML_Element * element,
 
     if( attrNode != NULL ) {
         if( attrNode->prefix != NULL ) {
-            free( attrNode->prefix );   // remove the old prefix
+            ixml_node_strfree( attrNode, attrNode->prefix );   // remove the old prefix
         }
         // replace it with the new prefix
-        attrNode->prefix = strdup( newAttrNode.prefix );
+        attrNode->prefix = ixml_node_symdup( attrNode, newAttrNode.prefix );
         if( attrNode->prefix == NULL ) {
             Parser_freeNodeContent( &newAttrNode );
             return IXML_INSUFFICIENT_MEMORY;
         }
 
         if( attrNode->nodeValue != NULL ) {
-            free( attrNode->nodeValue );
+            ixml_node_strfree( attrNode, attrNode->nodeValue );
         }
 
-        attrNode->nodeValue = strdup( value );
+        attrNode->nodeValue = ixml_node_strdup( attrNode, value );
         if( attrNode->nodeValue == NULL ) {
-            free( attrNode->prefix );
+            ixml_node_strfree( attrNode, attrNode->prefix );
             Parser_freeNodeContent( &newAttrNode );
             return IXML_INSUFFICIENT_MEMORY;
         }
@@ -637,7 +637,7 @@ ixmlElement_setAttributeNS( IN IXML_Element * element,
             return rc;
         }
 
-        newAttr->n.nodeValue = strdup( value );
+        newAttr->n.nodeValue = ixml_node_strdup( &newAttr->n, value );
         if( newAttr->n.nodeValue == NULL ) {
             ixmlAttr_free( newAttr );
             return IXML_INSUFFICIENT_MEMORY;
@@ -694,7 +694,7 @@ ixmlElement_removeAttributeNS( IN IXML_Element * element,
 
     if( attrNode != NULL ) {    // has the attribute
         if( attrNode->nodeValue != NULL ) {
-            free( attrNode->nodeValue );
+            ixml_node_strfree( attrNode, attrNode->nodeValue );
             attrNode->nodeValue = NULL;
         }
     }
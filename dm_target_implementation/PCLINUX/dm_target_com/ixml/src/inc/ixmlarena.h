@@ -0,0 +1,101 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : ixmlarena.h
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file ixmlarena.h
+ *
+ * @brief Document-scoped arena of the ixml library
+ *
+ * The nodes and strings of a document created in arena mode are bump-allocated in
+ * blocks owned by the document, and released all at once with the document.
+ * Freeing a single arena node or string does nothing.
+ *
+ * Each node records whether it comes from the arena (inArena) : its strings follow
+ * the same allocation mode, so the heap nodes attached to an arena document (clones,
+ * imported nodes) are still allocated and freed one by one.
+ *
+ * The arena also holds the symbol table of the document : the names of its arena
+ * nodes (nodeName, tagName, prefix, localName, namespaceURI) are interned, so each
+ * distinct name is stored once and two arena nodes of the document have the same
+ * name if and only if their name pointers are equal. The interned strings are
+ * read-only.
+ */
+
+#ifndef _IXML_ARENA_H
+#define _IXML_ARENA_H
+
+#include <stdlib.h>
+#include "ixml.h"
+
+// Size of the first block of an arena, the next ones are twice bigger up to IXML_ARENA_MAX_BLOCK_SIZE
+#define IXML_ARENA_BLOCK_SIZE     (4096)
+#define IXML_ARENA_MAX_BLOCK_SIZE (65536)
+
+// Initial number of buckets of the symbol table, doubled when there are more symbols than buckets
+#define IXML_SYMTAB_INIT_SIZE     (64)
+
+typedef struct _ixml_arena_block
+{
+    struct _ixml_arena_block *next;
+    size_t                    size;   // Usable bytes after the header
+    size_t                    used;
+
+} ixml_arena_block;
+
+typedef struct _ixml_symbol
+{
+    struct _ixml_symbol *next;        // Next symbol of the bucket
+    unsigned int         hash;
+    char                 name[1];     // Null terminated, allocated with the symbol
+
+} ixml_symbol;
+
+typedef struct _ixml_arena
+{
+    ixml_arena_block *blocks;         // Current block first
+    size_t            nextBlockSize;
+
+    ixml_symbol     **symbols;        // Buckets of the symbol table (heap), NULL until the first symbol
+    unsigned int      nbBuckets;
+    unsigned int      nbSymbols;
+
+} ixml_arena;
+
+//--------------------------------------------------
+//////////////// functions /////////////////////////
+//--------------------------------------------------
+
+ixml_arena *ixml_arena_create( void );
+void ixml_arena_destroy( INOUT ixml_arena *arena );
+void *ixml_arena_alloc( INOUT ixml_arena *arena, IN size_t size );
+const char *ixml_arena_intern( INOUT ixml_arena *arena, IN const char *s, IN size_t n );
+const char *ixml_arena_lookup( IN ixml_arena *arena, IN const char *s );
+
+void *ixml_doc_malloc( IN IXML_Document *doc, IN size_t size );
+char *ixml_node_strdup( IN IXML_Node *node, IN const char *s );
+char *ixml_node_strndup( IN IXML_Node *node, IN const char *s, IN size_t n );
+void ixml_node_strfree( IN IXML_Node *node, IN char *s );
+char *ixml_node_symdup( IN IXML_Node *node, IN const char *s );
+char *ixml_node_symndup( IN IXML_Node *node, IN const char *s, IN size_t n );
+
+#endif // _IXML_ARENA_H
@@ -34,6 +34,8 @@
 
 #include "ixml.h"
 #include "ixmlmembuf.h"
+#include "ixmlarena.h"
+#include "ixmlscan.h"
 
 // Parser definitions
 #define QUOT        "&quot;"
@@ -44,6 +46,9 @@
 #define ESC_HEX     "&#x"
 #define ESC_DEC     "&#"
 
+// Initial capacity of the array of a node list
+#define NODELIST_DEF_CAPACITY 8
+
 typedef struct _IXML_NamespaceURI 
 {
     char                        *nsURI;
@@ -72,13 +77,16 @@ typedef enum
 typedef struct _Parser
 {
     char            *dataBuffer;	//data buffer
+    char            *endPtr;		//end of the data buffer (its null terminator)
     char            *curPtr;		//ptr to the token parsed 
     char            *savePtr;		//Saves for backup
     ixml_membuf     lastElem;
     ixml_membuf     tokenBuf;    
 
     IXML_Node           *pNeedPrefixNode;
-    IXML_ElementStack   *pCurElement;
+    IXML_ElementStack   *pCurElement;   // its strings are symbols of the arena below
+    ixml_arena          *symbols;       // the arena of the document, or a private one
+    BOOL                ownSymbols;     // private arena, destroyed with the parser
     IXML_Node           *currentNodePtr;
     PARSER_STATE        state;
 
@@ -88,7 +96,7 @@ typedef struct _Parser
 
 
 
-int     Parser_LoadDocument( IXML_Document **retDoc, const char * xmlFile, BOOL file);
+int     Parser_LoadDocument( IXML_Document **retDoc, const char * xmlFile, BOOL file, BOOL arena);
 BOOL    Parser_isValidXmlName( const DOMString name);
 int     Parser_setNodePrefixAndLocalName(IXML_Node *newIXML_NodeIXML_Attr);
 void    Parser_freeNodeContent( IXML_Node *IXML_Nodeptr);
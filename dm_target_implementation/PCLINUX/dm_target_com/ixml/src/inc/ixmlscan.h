@@ -0,0 +1,46 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : ixmlscan.h
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file ixmlscan.h
+ *
+ * @brief Bulk scanning of the input buffer of the ixml parser
+ *
+ * The scans look at 16 bytes at a time with SSE2 (x86) or NEON (AArch64) when the
+ * compiler targets them, and fall back to a byte loop otherwise. They never read
+ * at or beyond the end pointer, so they can be used on any part of the buffer.
+ */
+
+#ifndef _IXML_SCAN_H
+#define _IXML_SCAN_H
+
+#include "ixml.h"
+
+//--------------------------------------------------
+//////////////// functions /////////////////////////
+//--------------------------------------------------
+
+const char *ixml_scan_plainChars( IN const char *p, IN const char *pend );
+const char *ixml_scan_delimiters( IN const char *p, IN const char *pend, IN char d1, IN char d2 );
+
+#endif // _IXML_SCAN_H
@@ -29,51 +29,99 @@
 //
 ///////////////////////////////////////////////////////////////////////////
 
-#include "ixmlmembuf.h"
 #include "ixmlparser.h"
 
+// Output of the serializer : a first pass over the tree only counts the
+// bytes (buf is NULL), the second one writes them in a buffer of that size
+typedef struct
+{
+    char   *buf;
+    size_t  length;
+
+} ixml_printer;
+
+// Chars replaced by an entity in the text and attribute values
+#define IXML_ESCAPED_CHARS "<>&'\""
+
+/*================================================================
+*   ixml_print_bytes
+*       Counts or writes len bytes of s.
+*       Internal function.
+*
+*=================================================================*/
+static void
+ixml_print_bytes( INOUT ixml_printer * buf,
+                  IN const char *s,
+                  IN size_t len )
+{
+    if( buf->buf != NULL ) {
+        memcpy( buf->buf + buf->length, s, len );
+    }
+    buf->length += len;
+}
+
 /*================================================================
-*   copy_with_escape
+*   ixml_print_str
+*       Counts or writes the string s (nothing if NULL).
+*       Internal function.
 *
+*=================================================================*/
+static void
+ixml_print_str( INOUT ixml_printer * buf,
+                IN const char *s )
+{
+    if( s != NULL ) {
+        ixml_print_bytes( buf, s, strlen( s ) );
+    }
+}
+
+/*================================================================
+*   ixml_print_escaped
+*       Counts or writes the string p, with its special chars
+*       replaced by entities. The segments between them are
+*       copied in one go.
+*       Internal function.
 *
 *=================================================================*/
 static void
-copy_with_escape( INOUT ixml_membuf * buf,
-                  IN const char *p )
+ixml_print_escaped( INOUT ixml_printer * buf,
+                    IN const char *p )
 {
-    int i;
-    int plen;
+    size_t len;
 
     if( p == NULL )
         return;
 
-    plen = strlen( p );
+    for( ;; ) {
+        len = strcspn( p, IXML_ESCAPED_CHARS );
+        ixml_print_bytes( buf, p, len );
+        p += len;
 
-    for( i = 0; i < plen; i++ ) {
-        switch ( p[i] ) {
+        switch ( *p ) {
             case '<':
-                ixml_membuf_append_str( buf, "&lt;" );
+                ixml_print_str( buf, "&lt;" );
                 break;
 
             case '>':
-                ixml_membuf_append_str( buf, "&gt;" );
+                ixml_print_str( buf, "&gt;" );
                 break;
 
             case '&':
-                ixml_membuf_append_str( buf, "&amp;" );
+                ixml_print_str( buf, "&amp;" );
                 break;
 
             case '\'':
-                ixml_membuf_append_str( buf, "&apos;" );
+                ixml_print_str( buf, "&apos;" );
                 break;
 
             case '\"':
-                ixml_membuf_append_str( buf, "&quot;" );
+                ixml_print_str( buf, "&quot;" );
                 break;
 
-            default:
-                ixml_membuf_append( buf, &p[i] );
+            default:            // end of the string
+                return;
         }
+        p++;
     }
 }
 
@@ -83,9 +131,9 @@ copy_with_escape( INOUT ixml_membuf * buf,
 *       Internal to parser only.
 *
 *=================================================================*/
-void
+static void
 ixmlPrintDomTreeRecursive( IN IXML_Node * nodeptr,
-                           IN ixml_membuf * buf )
+                           IN ixml_printer * buf )
 {
     const char *nodeName = NULL;
     const char *nodeValue = NULL;
@@ -99,21 +147,21 @@ ixmlPrintDomTreeRecursive( IN IXML_Node * nodeptr,
         switch ( ixmlNode_getNodeType( nodeptr ) ) {
 
             case eTEXT_NODE:
-                copy_with_escape( buf, nodeValue );
+                ixml_print_escaped( buf, nodeValue );
                 break;
 
             case eCDATA_SECTION_NODE:
-                ixml_membuf_append_str( buf, "<![CDATA[" );
-                ixml_membuf_append_str( buf, nodeValue );
-                ixml_membuf_append_str( buf, "]]>" );
+                ixml_print_str( buf, "<![CDATA[" );
+                ixml_print_str( buf, nodeValue );
+                ixml_print_str( buf, "]]>" );
                 break;
 
             case ePROCESSING_INSTRUCTION_NODE:
-                ixml_membuf_append_str( buf, "<?" );
-                ixml_membuf_append_str( buf, nodeName );
-                ixml_membuf_append_str( buf, " " );
-                copy_with_escape( buf, nodeValue );
-                ixml_membuf_append_str( buf, "?>\n" );
+                ixml_print_str( buf, "<?" );
+                ixml_print_str( buf, nodeName );
+                ixml_print_str( buf, " " );
+                ixml_print_escaped( buf, nodeValue );
+                ixml_print_str( buf, "?>\n" );
                 break;
 
             case eDOCUMENT_NODE:
@@ -122,23 +170,23 @@ ixmlPrintDomTreeRecursive( IN IXML_Node * nodeptr,
                 break;
 
             case eATTRIBUTE_NODE:
-                ixml_membuf_append_str( buf, nodeName );
-                ixml_membuf_append_str( buf, "=\"" );
-                copy_with_escape( buf, nodeValue );
-                ixml_membuf_append_str( buf, "\"" );
+                ixml_print_str( buf, nodeName );
+                ixml_print_str( buf, "=\"" );
+                ixml_print_escaped( buf, nodeValue );
+                ixml_print_str( buf, "\"" );
 
                 if( nodeptr->nextSibling != NULL ) {
-                    ixml_membuf_append_str( buf, " " );
+                    ixml_print_str( buf, " " );
                     ixmlPrintDomTreeRecursive( nodeptr->nextSibling, buf );
                 }
                 break;
 
             case eELEMENT_NODE:
-                ixml_membuf_append_str( buf, "<" );
-                ixml_membuf_append_str( buf, nodeName );
+                ixml_print_str( buf, "<" );
+                ixml_print_str( buf, nodeName );
 
                 if( nodeptr->firstAttr != NULL ) {
-                    ixml_membuf_append_str( buf, " " );
+                    ixml_print_str( buf, " " );
                     ixmlPrintDomTreeRecursive( nodeptr->firstAttr, buf );
                 }
 
@@ -146,9 +194,9 @@ ixmlPrintDomTreeRecursive( IN IXML_Node * nodeptr,
                 if( ( child != NULL )
                     && ( ixmlNode_getNodeType( child ) ==
                          eELEMENT_NODE ) ) {
-                    ixml_membuf_append_str( buf, ">\r\n" );
+                    ixml_print_str( buf, ">\r\n" );
                 } else {
-                    ixml_membuf_append_str( buf, ">" );
+                    ixml_print_str( buf, ">" );
                 }
 
                 //  output the children
@@ -156,15 +204,15 @@ ixmlPrintDomTreeRecursive( IN IXML_Node * nodeptr,
                                            ( nodeptr ), buf );
 
                 // Done with children.  Output the end tag.
-                ixml_membuf_append_str( buf, "</" );
-                ixml_membuf_append_str( buf, nodeName );
+                ixml_print_str( buf, "</" );
+                ixml_print_str( buf, nodeName );
 
                 sibling = ixmlNode_getNextSibling( nodeptr );
                 if( sibling != NULL
                     && ixmlNode_getNodeType( sibling ) == eTEXT_NODE ) {
-                    ixml_membuf_append_str( buf, ">" );
+                    ixml_print_str( buf, ">" );
                 } else {
-                    ixml_membuf_append_str( buf, ">\r\n" );
+                    ixml_print_str( buf, ">\r\n" );
                 }
                 ixmlPrintDomTreeRecursive( ixmlNode_getNextSibling
                                            ( nodeptr ), buf );
@@ -181,12 +229,12 @@ ixmlPrintDomTreeRecursive( IN IXML_Node * nodeptr,
 *       Print a DOM tree.
 *       Element, and Attribute nodes are handled differently.
 *       We don't want to print the Element and Attribute nodes' sibling.
-*       External function.
+*       Internal function.
 *
 *=================================================================*/
-void
+static void
 ixmlPrintDomTree( IN IXML_Node * nodeptr,
-                  IN ixml_membuf * buf )
+                  IN ixml_printer * buf )
 {
     const char *nodeName = NULL;
     const char *nodeValue = NULL;
@@ -209,27 +257,27 @@ ixmlPrintDomTree( IN IXML_Node * nodeptr,
             break;
 
         case eATTRIBUTE_NODE:
-            ixml_membuf_append_str( buf, nodeName );
-            ixml_membuf_append_str( buf, "=\"" );
-            copy_with_escape( buf, nodeValue );
-            ixml_membuf_append_str( buf, "\"" );
+            ixml_print_str( buf, nodeName );
+            ixml_print_str( buf, "=\"" );
+            ixml_print_escaped( buf, nodeValue );
+            ixml_print_str( buf, "\"" );
             break;
 
         case eELEMENT_NODE:
-            ixml_membuf_append_str( buf, "<" );
-            ixml_membuf_append_str( buf, nodeName );
+            ixml_print_str( buf, "<" );
+            ixml_print_str( buf, nodeName );
 
             if( nodeptr->firstAttr != NULL ) {
-                ixml_membuf_append_str( buf, " " );
+                ixml_print_str( buf, " " );
                 ixmlPrintDomTreeRecursive( nodeptr->firstAttr, buf );
             }
 
             child = ixmlNode_getFirstChild( nodeptr );
             if( ( child != NULL )
                 && ( ixmlNode_getNodeType( child ) == eELEMENT_NODE ) ) {
-                ixml_membuf_append_str( buf, ">\r\n" );
+                ixml_print_str( buf, ">\r\n" );
             } else {
-                ixml_membuf_append_str( buf, ">" );
+                ixml_print_str( buf, ">" );
             }
 
             //  output the children
@@ -237,9 +285,9 @@ ixmlPrintDomTree( IN IXML_Node * nodeptr,
                                        buf );
 
             // Done with children.  Output the end tag.
-            ixml_membuf_append_str( buf, "</" );
-            ixml_membuf_append_str( buf, nodeName );
-            ixml_membuf_append_str( buf, ">\r\n" );
+            ixml_print_str( buf, "</" );
+            ixml_print_str( buf, nodeName );
+            ixml_print_str( buf, ">\r\n" );
             break;
 
         default:
@@ -252,12 +300,12 @@ ixmlPrintDomTree( IN IXML_Node * nodeptr,
 *       Converts a DOM tree into a text string
 *       Element, and Attribute nodes are handled differently.
 *       We don't want to print the Element and Attribute nodes' sibling.
-*       External function.
+*       Internal function.
 *
 *=================================================================*/
-void
+static void
 ixmlDomTreetoString( IN IXML_Node * nodeptr,
-                     IN ixml_membuf * buf )
+                     IN ixml_printer * buf )
 {
     const char *nodeName = NULL;
     const char *nodeValue = NULL;
@@ -280,27 +328,27 @@ ixmlDomTreetoString( IN IXML_Node * nodeptr,
             break;
 
         case eATTRIBUTE_NODE:
-            ixml_membuf_append_str( buf, nodeName );
-            ixml_membuf_append_str( buf, "=\"" );
-            copy_with_escape( buf, nodeValue );
-            ixml_membuf_append_str( buf, "\"" );
+            ixml_print_str( buf, nodeName );
+            ixml_print_str( buf, "=\"" );
+            ixml_print_escaped( buf, nodeValue );
+            ixml_print_str( buf, "\"" );
             break;
 
         case eELEMENT_NODE:
-            ixml_membuf_append_str( buf, "<" );
-            ixml_membuf_append_str( buf, nodeName );
+            ixml_print_str( buf, "<" );
+            ixml_print_str( buf, nodeName );
 
             if( nodeptr->firstAttr != NULL ) {
-                ixml_membuf_append_str( buf, " " );
+                ixml_print_str( buf, " " );
                 ixmlPrintDomTreeRecursive( nodeptr->firstAttr, buf );
             }
 
             child = ixmlNode_getFirstChild( nodeptr );
             if( ( child != NULL )
                 && ( ixmlNode_getNodeType( child ) == eELEMENT_NODE ) ) {
-                ixml_membuf_append_str( buf, ">" );
+                ixml_print_str( buf, ">" );
             } else {
-                ixml_membuf_append_str( buf, ">" );
+                ixml_print_str( buf, ">" );
             }
 
             //  output the children
@@ -308,9 +356,9 @@ ixmlDomTreetoString( IN IXML_Node * nodeptr,
                                        buf );
 
             // Done with children.  Output the end tag.
-            ixml_membuf_append_str( buf, "</" );
-            ixml_membuf_append_str( buf, nodeName );
-            ixml_membuf_append_str( buf, ">" );
+            ixml_print_str( buf, "</" );
+            ixml_print_str( buf, nodeName );
+            ixml_print_str( buf, ">" );
             break;
 
         default:
@@ -333,7 +381,7 @@ ixmlLoadDocumentEx( IN const char *xmlFile,
         return IXML_INVALID_PARAMETER;
     }
 
-    return Parser_LoadDocument( doc, xmlFile, TRUE );
+    return Parser_LoadDocument( doc, xmlFile, TRUE, FALSE );
 }
 
 /*================================================================
@@ -352,6 +400,65 @@ ixmlLoadDocument( IN const char *xmlFile )
     return doc;
 }
 
+/*================================================================
+*   ixmlLoadDocumentArena
+*       Parses the given file, and returns the DOM tree from it
+*       allocated in an arena.
+*       External function.
+*
+*=================================================================*/
+IXML_Document *
+ixmlLoadDocumentArena( IN const char *xmlFile )
+{
+
+    IXML_Document *doc = NULL;
+
+    if( xmlFile != NULL ) {
+        Parser_LoadDocument( &doc, xmlFile, TRUE, TRUE );
+    }
+    return doc;
+}
+
+/*================================================================
+*   ixml_printToString
+*       Serializes the tree of node with printTree, after the prolog
+*       if not NULL : the size of the text is computed first, so the
+*       string is allocated once. Returns NULL if the text is empty
+*       or not enough memory.
+*       Internal function.
+*
+*=================================================================*/
+static DOMString
+ixml_printToString( IN IXML_Node * node,
+                    IN const char *prolog,
+                    IN void ( *printTree ) ( IXML_Node *, ixml_printer * ) )
+{
+    ixml_printer printer;
+
+    // sizing pass
+    printer.buf = NULL;
+    printer.length = 0;
+    ixml_print_str( &printer, prolog );
+    printTree( node, &printer );
+
+    if( printer.length == 0 ) {
+        return NULL;
+    }
+
+    printer.buf = ( char * )malloc( printer.length + 1 );
+    if( printer.buf == NULL ) {
+        return NULL;
+    }
+
+    // writing pass
+    printer.length = 0;
+    ixml_print_str( &printer, prolog );
+    printTree( node, &printer );
+    printer.buf[printer.length] = '\0';
+
+    return printer.buf;
+}
+
 /*================================================================
 *   ixmlPrintDocument
 *       Prints entire document, prepending XML prolog first.
@@ -364,17 +471,13 @@ DOMString
 ixmlPrintDocument(IXML_Document *doc)
 {
     IXML_Node* rootNode = ( IXML_Node * )doc;
-    ixml_membuf memBuf;
-    ixml_membuf *buf = &memBuf;
 
     if( rootNode == NULL ) {
         return NULL;
     }
 
-    ixml_membuf_init( buf );
-    ixml_membuf_append_str( buf, "<?xml version=\"1.0\"?>\r\n" );
-    ixmlPrintDomTree( rootNode, buf );
-    return buf->buf;
+    return ixml_printToString( rootNode, "<?xml version=\"1.0\"?>\r\n",
+                               ixmlPrintDomTree );
 
 }
 
@@ -388,16 +491,11 @@ DOMString
 ixmlPrintNode( IN IXML_Node * node )
 {
 
-    ixml_membuf memBuf;
-    ixml_membuf *buf = &memBuf;
-
     if( node == NULL ) {
         return NULL;
     }
 
-    ixml_membuf_init( buf );
-    ixmlPrintDomTree( node, buf );
-    return buf->buf;
+    return ixml_printToString( node, NULL, ixmlPrintDomTree );
 
 }
 
@@ -413,17 +511,13 @@ DOMString
 ixmlDocumenttoString(IXML_Document *doc)
 {
     IXML_Node* rootNode = ( IXML_Node * )doc;
-    ixml_membuf memBuf;
-    ixml_membuf *buf = &memBuf;
 
     if( rootNode == NULL ) {
         return NULL;
     }
 
-    ixml_membuf_init( buf );
-    ixml_membuf_append_str( buf, "<?xml version=\"1.0\"?>\r\n" );
-    ixmlDomTreetoString( rootNode, buf );
-    return buf->buf;
+    return ixml_printToString( rootNode, "<?xml version=\"1.0\"?>\r\n",
+                               ixmlDomTreetoString );
 
 }
 
@@ -437,16 +531,11 @@ DOMString
 ixmlNodetoString( IN IXML_Node * node )
 {
 
-    ixml_membuf memBuf;
-    ixml_membuf *buf = &memBuf;
-
     if( node == NULL ) {
         return NULL;
     }
 
-    ixml_membuf_init( buf );
-    ixmlDomTreetoString( node, buf );
-    return buf->buf;
+    return ixml_printToString( node, NULL, ixmlDomTreetoString );
 
 }
 
@@ -482,7 +571,7 @@ ixmlParseBufferEx( IN const char *buffer,
         return IXML_INVALID_PARAMETER;
     }
 
-    return Parser_LoadDocument( retDoc, buffer, FALSE );
+    return Parser_LoadDocument( retDoc, buffer, FALSE, FALSE );
 }
 
 /*================================================================
@@ -500,6 +589,45 @@ ixmlParseBuffer( IN const char *buffer )
     return doc;
 }
 
+/*================================================================
+*   ixmlParseBufferArenaEx
+*       Parse xml file stored in buffer, the DOM tree is allocated
+*       in an arena.
+*       External function.
+*
+*=================================================================*/
+int
+ixmlParseBufferArenaEx( IN const char *buffer,
+                        IXML_Document ** retDoc )
+{
+
+    if( ( buffer == NULL ) || ( retDoc == NULL ) ) {
+        return IXML_INVALID_PARAMETER;
+    }
+
+    if( buffer[0] == '\0' ) {
+        return IXML_INVALID_PARAMETER;
+    }
+
+    return Parser_LoadDocument( retDoc, buffer, FALSE, TRUE );
+}
+
+/*================================================================
+*   ixmlParseBufferArena
+*       Parse xml file stored in buffer, the DOM tree is allocated
+*       in an arena.
+*       External function.
+*
+*=================================================================*/
+IXML_Document *
+ixmlParseBufferArena( IN const char *buffer )
+{
+    IXML_Document *doc = NULL;
+
+    ixmlParseBufferArenaEx( buffer, &doc );
+    return doc;
+}
+
 /*================================================================
 *   ixmlCloneDOMString
 *       Clones a DOM String.
@@ -0,0 +1,423 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : ixmlarena.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file ixmlarena.c
+ *
+ * @brief Document-scoped arena of the ixml library
+ *
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ixmlarena.h"
+
+// Alignment of the blocks returned by ixml_arena_alloc (pointers, integers and doubles)
+#define IXML_ARENA_ALIGN          (8)
+#define IXML_ARENA_ROUND( size )  ( ( (size) + IXML_ARENA_ALIGN - 1 ) & ~( (size_t)IXML_ARENA_ALIGN - 1 ) )
+#define IXML_ARENA_HEADER_SIZE    IXML_ARENA_ROUND( sizeof( ixml_arena_block ) )
+
+/*================================================================
+*   ixml_arena_newBlock
+*       Allocates a block able to hold size bytes.
+*       Internal function.
+*
+*=================================================================*/
+static ixml_arena_block *
+ixml_arena_newBlock( IN size_t size )
+{
+    ixml_arena_block *block;
+
+    block = ( ixml_arena_block * ) malloc( IXML_ARENA_HEADER_SIZE + size );
+    if( block != NULL ) {
+        block->next = NULL;
+        block->size = size;
+        block->used = 0;
+    }
+
+    return block;
+}
+
+/*================================================================
+*   ixml_arena_create
+*       Creates an empty arena, its first block is allocated on
+*       the first allocation.
+*       Returns NULL if not enough memory.
+*
+*=================================================================*/
+ixml_arena *
+ixml_arena_create( void )
+{
+    ixml_arena *arena;
+
+    arena = ( ixml_arena * ) malloc( sizeof( ixml_arena ) );
+    if( arena != NULL ) {
+        arena->blocks = NULL;
+        arena->nextBlockSize = IXML_ARENA_BLOCK_SIZE;
+        arena->symbols = NULL;
+        arena->nbBuckets = 0;
+        arena->nbSymbols = 0;
+    }
+
+    return arena;
+}
+
+/*================================================================
+*   ixml_arena_destroy
+*       Releases all the blocks of the arena, its symbol table and
+*       the arena itself.
+*
+*=================================================================*/
+void
+ixml_arena_destroy( INOUT ixml_arena * arena )
+{
+    ixml_arena_block *block;
+    ixml_arena_block *next;
+
+    if( arena == NULL ) {
+        return;
+    }
+
+    for( block = arena->blocks; block != NULL; block = next ) {
+        next = block->next;
+        free( block );
+    }
+    free( arena->symbols );
+    free( arena );
+}
+
+/*================================================================
+*   ixml_arena_alloc
+*       Bump-allocates size bytes (aligned) in the arena.
+*       A request bigger than a quarter of a block gets its own
+*       block, kept behind the current one.
+*       Returns NULL if not enough memory.
+*
+*=================================================================*/
+void *
+ixml_arena_alloc( INOUT ixml_arena * arena,
+                  IN size_t size )
+{
+    ixml_arena_block *block;
+    void *p;
+
+    assert( arena != NULL );
+
+    size = IXML_ARENA_ROUND( size );
+    block = arena->blocks;
+
+    if( ( block == NULL ) || ( block->size - block->used < size ) ) {
+        if( size > arena->nextBlockSize / 4 ) {
+            block = ixml_arena_newBlock( size );
+            if( block == NULL ) {
+                return NULL;
+            }
+            if( arena->blocks == NULL ) {
+                arena->blocks = block;
+            } else {
+                block->next = arena->blocks->next;
+                arena->blocks->next = block;
+            }
+        } else {
+            block = ixml_arena_newBlock( arena->nextBlockSize );
+            if( block == NULL ) {
+                return NULL;
+            }
+            block->next = arena->blocks;
+            arena->blocks = block;
+            if( arena->nextBlockSize < IXML_ARENA_MAX_BLOCK_SIZE ) {
+                arena->nextBlockSize *= 2;
+            }
+        }
+    }
+
+    p = ( char * )block + IXML_ARENA_HEADER_SIZE + block->used;
+    block->used += size;
+
+    return p;
+}
+
+/*================================================================
+*   ixml_arena_hash
+*       FNV-1a hash of the n first characters of s.
+*       Internal function.
+*
+*=================================================================*/
+static unsigned int
+ixml_arena_hash( IN const char *s,
+                 IN size_t n )
+{
+    unsigned int hash = 2166136261U;
+
+    while( n-- > 0 ) {
+        hash = ( hash ^ ( unsigned char )*s++ ) * 16777619U;
+    }
+
+    return hash;
+}
+
+/*================================================================
+*   ixml_arena_findSymbol
+*       Returns the symbol of the n first characters of s with the
+*       given hash, NULL if not interned yet.
+*       Internal function.
+*
+*=================================================================*/
+static ixml_symbol *
+ixml_arena_findSymbol( IN ixml_arena * arena,
+                       IN const char *s,
+                       IN size_t n,
+                       IN unsigned int hash )
+{
+    ixml_symbol *symbol;
+
+    if( arena->symbols == NULL ) {
+        return NULL;
+    }
+
+    for( symbol = arena->symbols[hash & ( arena->nbBuckets - 1 )];
+         symbol != NULL; symbol = symbol->next ) {
+        if( ( symbol->hash == hash ) && ( strncmp( symbol->name, s, n ) == 0 )
+            && ( symbol->name[n] == '\0' ) ) {
+            return symbol;
+        }
+    }
+
+    return NULL;
+}
+
+/*================================================================
+*   ixml_arena_growSymbols
+*       Doubles the number of buckets of the symbol table (creates
+*       it the first time). The table is left unchanged if not
+*       enough memory.
+*       Internal function.
+*
+*=================================================================*/
+static void
+ixml_arena_growSymbols( INOUT ixml_arena * arena )
+{
+    unsigned int nbBuckets;
+    ixml_symbol **buckets;
+    ixml_symbol *symbol;
+    ixml_symbol *next;
+    unsigned int i;
+
+    nbBuckets = ( arena->nbBuckets == 0 ? IXML_SYMTAB_INIT_SIZE : 2 * arena->nbBuckets );
+    buckets = ( ixml_symbol ** ) calloc( nbBuckets, sizeof( ixml_symbol * ) );
+    if( buckets == NULL ) {
+        return;
+    }
+
+    for( i = 0; i < arena->nbBuckets; i++ ) {
+        for( symbol = arena->symbols[i]; symbol != NULL; symbol = next ) {
+            next = symbol->next;
+            symbol->next = buckets[symbol->hash & ( nbBuckets - 1 )];
+            buckets[symbol->hash & ( nbBuckets - 1 )] = symbol;
+        }
+    }
+
+    free( arena->symbols );
+    arena->symbols = buckets;
+    arena->nbBuckets = nbBuckets;
+}
+
+/*================================================================
+*   ixml_arena_intern
+*       Returns the symbol of the n first characters of s, added to
+*       the symbol table of the arena if not there yet.
+*       Returns NULL if not enough memory.
+*
+*=================================================================*/
+const char *
+ixml_arena_intern( INOUT ixml_arena * arena,
+                   IN const char *s,
+                   IN size_t n )
+{
+    unsigned int hash;
+    ixml_symbol *symbol;
+
+    assert( arena != NULL );
+
+    hash = ixml_arena_hash( s, n );
+    symbol = ixml_arena_findSymbol( arena, s, n, hash );
+    if( symbol != NULL ) {
+        return symbol->name;
+    }
+
+    if( arena->nbSymbols >= arena->nbBuckets ) {
+        ixml_arena_growSymbols( arena );
+        if( arena->symbols == NULL ) {
+            return NULL;
+        }
+    }
+
+    symbol = ( ixml_symbol * ) ixml_arena_alloc( arena, sizeof( ixml_symbol ) + n );
+    if( symbol == NULL ) {
+        return NULL;
+    }
+    memcpy( symbol->name, s, n );
+    symbol->name[n] = '\0';
+    symbol->hash = hash;
+    symbol->next = arena->symbols[hash & ( arena->nbBuckets - 1 )];
+    arena->symbols[hash & ( arena->nbBuckets - 1 )] = symbol;
+    arena->nbSymbols++;
+
+    return symbol->name;
+}
+
+/*================================================================
+*   ixml_arena_lookup
+*       Returns the symbol of s, NULL if s is not interned in the
+*       arena : then no arena node of the document is named s.
+*
+*=================================================================*/
+const char *
+ixml_arena_lookup( IN ixml_arena * arena,
+                   IN const char *s )
+{
+    size_t n;
+    ixml_symbol *symbol;
+
+    assert( arena != NULL );
+
+    n = strlen( s );
+    symbol = ixml_arena_findSymbol( arena, s, n, ixml_arena_hash( s, n ) );
+
+    return ( symbol != NULL ? symbol->name : NULL );
+}
+
+/*================================================================
+*   ixml_doc_malloc
+*       Allocates a node of the document : from its arena if it
+*       has one, from the heap otherwise.
+*       The caller sets the inArena field of the node after its
+*       initialization.
+*
+*=================================================================*/
+void *
+ixml_doc_malloc( IN IXML_Document * doc,
+                 IN size_t size )
+{
+    if( ( doc != NULL ) && ( doc->arena != NULL ) ) {
+        return ixml_arena_alloc( doc->arena, size );
+    }
+
+    return malloc( size );
+}
+
+/*================================================================
+*   ixml_node_strndup
+*       Copies the n first characters of s for a field of the node,
+*       in the same allocation mode as the node.
+*
+*=================================================================*/
+char *
+ixml_node_strndup( IN IXML_Node * node,
+                   IN const char *s,
+                   IN size_t n )
+{
+    char *copy;
+
+    if( node->inArena ) {
+        copy = ( char * )ixml_arena_alloc( node->ownerDocument->arena, n + 1 );
+    } else {
+        copy = ( char * )malloc( n + 1 );
+    }
+
+    if( copy != NULL ) {
+        memcpy( copy, s, n );
+        copy[n] = '\0';
+    }
+
+    return copy;
+}
+
+/*================================================================
+*   ixml_node_strdup
+*       Copies s for a field of the node, in the same allocation
+*       mode as the node. Like safe_strdup, NULL gives "".
+*
+*=================================================================*/
+char *
+ixml_node_strdup( IN IXML_Node * node,
+                  IN const char *s )
+{
+    if( s == NULL ) {
+        s = "";
+    }
+
+    return ixml_node_strndup( node, s, strlen( s ) );
+}
+
+/*================================================================
+*   ixml_node_strfree
+*       Frees a field of the node. Nothing to do for an arena node,
+*       the string is released with its document.
+*
+*=================================================================*/
+void
+ixml_node_strfree( IN IXML_Node * node,
+                   IN char *s )
+{
+    if( ( s != NULL ) && !node->inArena ) {
+        free( s );
+    }
+}
+
+/*================================================================
+*   ixml_node_symndup
+*       Like ixml_node_strndup for a name of the node : an arena
+*       node gets the symbol of the document, shared with the other
+*       nodes of the same name.
+*
+*=================================================================*/
+char *
+ixml_node_symndup( IN IXML_Node * node,
+                   IN const char *s,
+                   IN size_t n )
+{
+    if( node->inArena ) {
+        return ( char * )ixml_arena_intern( node->ownerDocument->arena, s, n );
+    }
+
+    return ixml_node_strndup( node, s, n );
+}
+
+/*================================================================
+*   ixml_node_symdup
+*       Like ixml_node_strdup for a name of the node (see
+*       ixml_node_symndup). NULL gives "".
+*
+*=================================================================*/
+char *
+ixml_node_symdup( IN IXML_Node * node,
+                  IN const char *s )
+{
+    if( s == NULL ) {
+        s = "";
+    }
+
+    return ixml_node_symndup( node, s, strlen( s ) );
+}
@@ -219,8 +219,6 @@ static void Parser_free( Parser * myParser );
 static int Parser_skipDocType( char **pstr );
 static int Parser_skipProlog( Parser * xmlParser );
 static int Parser_skipMisc( Parser * xmlParser );
-static void Parser_freeElementStackItem( IXML_ElementStack * pItem );
-static void Parser_freeNsURI( IXML_NamespaceURI * pNsURI );
 
 static int Parser_getNextNode( Parser * myParser,
                                IXML_Node * newNode,
@@ -234,7 +232,8 @@ static BOOL Parser_ElementPrefixDefined( Parser * myParser,
 static int Parser_setElementNamespace( IXML_Element * newElement,
                                        const char *nsURI );
 static int Parser_parseDocument( IXML_Document ** retDoc,
-                                 Parser * domParser );
+                                 Parser * domParser,
+                                 BOOL arena );
 static BOOL Parser_hasDefaultNamespace( Parser * xmlParser,
                                         IXML_Node * newNode,
                                         char **nsURI );
@@ -309,6 +308,15 @@ static BOOL
 Parser_isNameChar( IN int c,
                    IN BOOL bNameChar )
 {
+    // ASCII chars (most of the names) without the table lookups
+    if( ( c >= 0 ) && ( c < 0x80 ) ) {
+        if( ( ( c >= 'a' ) && ( c <= 'z' ) ) || ( ( c >= 'A' ) && ( c <= 'Z' ) ) ||
+            ( c == ':' ) || ( c == '_' ) ) {
+            return TRUE;
+        }
+        return ( bNameChar && ( ( ( c >= '0' ) && ( c <= '9' ) ) || ( c == '-' ) || ( c == '.' ) ) );
+    }
+
     if( Parser_isCharInTable( c, Letter, LETTERTABLESIZE ) ) {
         return TRUE;
     }
@@ -519,6 +527,20 @@ Parser_isValidEndElement(
     return strcmp( xmlParser->pCurElement->element, newNode->nodeName ) == 0;
 }
 
+/*===============================================================
+*   Parser_intern
+*       returns the symbol of s in the symbol table of the parser,
+*       NULL if not enough memory.
+*       Internal to parser only.
+*
+*=================================================================*/
+static char *
+Parser_intern( IN Parser * xmlParser,
+               IN const char *s )
+{
+    return ( char * )ixml_arena_intern( xmlParser->symbols, s, strlen( s ) );
+}
+
 /*===============================================================
 *   Parser_pushElement
 *       push a new element onto element stack
@@ -545,16 +567,15 @@ Parser_pushElement( IN Parser * xmlParser,
         memset( pNewStackElement, 0, sizeof( IXML_ElementStack ) );
         // the element member includes both prefix and name 
 
-        pNewStackElement->element = safe_strdup( newElement->nodeName );
+        pNewStackElement->element = Parser_intern( xmlParser, newElement->nodeName );
         if( pNewStackElement->element == NULL ) {
             free( pNewStackElement );
             return IXML_INSUFFICIENT_MEMORY;
         }
 
         if( newElement->prefix != 0 ) {
-            pNewStackElement->prefix = safe_strdup( newElement->prefix );
+            pNewStackElement->prefix = Parser_intern( xmlParser, newElement->prefix );
             if( pNewStackElement->prefix == NULL ) {
-                Parser_freeElementStackItem( pNewStackElement );
                 free( pNewStackElement );
                 return IXML_INSUFFICIENT_MEMORY;
             }
@@ -562,9 +583,8 @@ Parser_pushElement( IN Parser * xmlParser,
 
         if( newElement->namespaceURI != 0 ) {
             pNewStackElement->namespaceUri =
-                safe_strdup( newElement->namespaceURI );
+                Parser_intern( xmlParser, newElement->namespaceURI );
             if( pNewStackElement->namespaceUri == NULL ) {
-                Parser_freeElementStackItem( pNewStackElement );
                 free( pNewStackElement );
                 return IXML_INSUFFICIENT_MEMORY;
             }
@@ -598,13 +618,10 @@ Parser_popElement( IN Parser * xmlParser )
     if( pCur != NULL ) {
         xmlParser->pCurElement = pCur->nextElement;
 
-        Parser_freeElementStackItem( pCur );
-
         pnsUri = pCur->pNsURI;
         while( pnsUri != NULL ) {
             pNextNS = pnsUri->nextNsURI;
 
-            Parser_freeNsURI( pnsUri );
             free( pnsUri );
             pnsUri = pNextNS;
         }
@@ -660,19 +677,24 @@ Parser_readFileOrBuffer( IN Parser * xmlParser,
         }
     }
 
+    // bound of the bulk scans
+    xmlParser->endPtr = xmlParser->dataBuffer + strlen( xmlParser->dataBuffer );
+
     return IXML_SUCCESS;
 }
 
 /*================================================================
 *   Parser_LoadDocument
-*       parses a xml file and return the DOM tree.
+*       parses a xml file and return the DOM tree, allocated in an
+*       arena if arena is TRUE.
 *       Internal to parser only
 *
 *=================================================================*/
 int
 Parser_LoadDocument( OUT IXML_Document ** retDoc,
                      IN const char *xmlFileName,
-                     IN BOOL file )
+                     IN BOOL file,
+                     IN BOOL arena )
 {
     int rc = IXML_SUCCESS;
     Parser *xmlParser = NULL;
@@ -689,7 +711,7 @@ Parser_LoadDocument( OUT IXML_Document ** retDoc,
     }
 
     xmlParser->curPtr = xmlParser->dataBuffer;
-    rc = Parser_parseDocument( retDoc, xmlParser );
+    rc = Parser_parseDocument( retDoc, xmlParser, arena );
     return rc;
 
 }
@@ -916,7 +938,8 @@ Parser_freeNodeContent( IN IXML_Node * nodeptr )
 *=================================================================*/
 static int
 Parser_parseDocument( OUT IXML_Document ** retDoc,
-                      IN Parser * xmlParser )
+                      IN Parser * xmlParser,
+                      IN BOOL arena )
 {
 
     IXML_Document *gRootDoc = NULL;
@@ -930,11 +953,27 @@ Parser_parseDocument( OUT IXML_Document ** retDoc,
     // can go wrong on the error handler.
     ixmlNode_init( &newNode );
 
-    rc = ixmlDocument_createDocumentEx( &gRootDoc );
+    if( arena ) {
+        rc = ixmlDocument_createArenaDocumentEx( &gRootDoc );
+    } else {
+        rc = ixmlDocument_createDocumentEx( &gRootDoc );
+    }
     if( rc != IXML_SUCCESS ) {
         goto ErrorHandler;
     }
 
+    // the names of the element stack share the symbols of the document
+    if( arena ) {
+        xmlParser->symbols = gRootDoc->arena;
+    } else {
+        xmlParser->symbols = ixml_arena_create(  );
+        if( xmlParser->symbols == NULL ) {
+            rc = IXML_INSUFFICIENT_MEMORY;
+            goto ErrorHandler;
+        }
+        xmlParser->ownSymbols = TRUE;
+    }
+
     xmlParser->currentNodePtr = ( IXML_Node * ) gRootDoc;
 
     rc = Parser_skipProlog( xmlParser );
@@ -1244,7 +1283,8 @@ Parser_copyToken( IN Parser * xmlParser,
       c,
       cl;
     const char *psrc,
-     *pend;
+     *pend,
+     *prun;
     utf8char uch;
 
     if( !src || len <= 0 ) {
@@ -1255,6 +1295,17 @@ Parser_copyToken( IN Parser * xmlParser,
     pend = src + len;
 
     while( psrc < pend ) {
+        // a run of plain chars is copied as is, in one go
+        prun = ixml_scan_plainChars( psrc, pend );
+        if( prun > psrc ) {
+            if( ixml_membuf_insert( &( xmlParser->tokenBuf ), psrc, prun - psrc,
+                                    ( xmlParser->tokenBuf ).length ) != 0 ) {
+                return IXML_FAILED;
+            }
+            psrc = prun;
+            continue;
+        }
+
         if( ( c = Parser_getChar( psrc, &cl ) ) <= 0 ) {
             return IXML_FAILED;
         }
@@ -1592,11 +1643,12 @@ Parser_getNameSpace( IN Parser * xmlParser,
     IXML_ElementStack *pCur;
     IXML_NamespaceURI *pNsUri;
 
+    // prefix is a symbol : compared by address
     pCur = xmlParser->pCurElement;
-    if( strcmp( pCur->prefix, prefix ) != 0 ) {
+    if( pCur->prefix != prefix ) {
         pNsUri = pCur->pNsURI;
         while( pNsUri != NULL ) {
-            if( strcmp( pNsUri->prefix, prefix ) == 0 ) {
+            if( pNsUri->prefix == prefix ) {
                 return pNsUri->nsURI;
             }
             pNsUri = pNsUri->nextNsURI;
@@ -1634,7 +1686,7 @@ Parser_addNamespace( IN Parser * xmlParser )
             // it would be wrong that pNode->namespace != NULL.
             assert( pNode->namespaceURI == NULL );
 
-            pNode->namespaceURI = safe_strdup( pCur->namespaceUri );
+            pNode->namespaceURI = ixml_node_symdup( pNode, pCur->namespaceUri );
             if( pNode->namespaceURI == NULL ) {
                 return IXML_INSUFFICIENT_MEMORY;
             }
@@ -1650,7 +1702,7 @@ Parser_addNamespace( IN Parser * xmlParser )
 
         namespaceUri = Parser_getNameSpace( xmlParser, pCur->prefix );
         if( namespaceUri != NULL ) {
-            pNode->namespaceURI = safe_strdup( namespaceUri );
+            pNode->namespaceURI = ixml_node_symdup( pNode, namespaceUri );
             if( pNode->namespaceURI == NULL ) {
                 return IXML_INSUFFICIENT_MEMORY;
             }
@@ -1685,7 +1737,7 @@ Parser_setNodePrefixAndLocalName( IN IXML_Node * node )
     pStrPrefix = strchr( node->nodeName, ':' );
     if( pStrPrefix == NULL ) {
         node->prefix = NULL;
-        node->localName = safe_strdup( node->nodeName );
+        node->localName = ixml_node_symdup( node, node->nodeName );
         if( node->localName == NULL ) {
             return IXML_INSUFFICIENT_MEMORY;
         }
@@ -1694,17 +1746,14 @@ Parser_setNodePrefixAndLocalName( IN IXML_Node * node )
 
         pLocalName = ( char * )pStrPrefix + 1;
         nPrefix = pStrPrefix - node->nodeName;
-        node->prefix = (char*)malloc( nPrefix + 1 );
+        node->prefix = ixml_node_symndup( node, node->nodeName, nPrefix );
         if( node->prefix == NULL ) {
             return IXML_INSUFFICIENT_MEMORY;
         }
 
-        memset( node->prefix, 0, nPrefix + 1 );
-        strncpy( node->prefix, node->nodeName, nPrefix );
-
-        node->localName = safe_strdup( pLocalName );
+        node->localName = ixml_node_symdup( node, pLocalName );
         if( node->localName == NULL ) {
-            free( node->prefix );
+            ixml_node_strfree( node, node->prefix );
             node->prefix = NULL;    //no need to free really, main loop will frees it
             //when return code is not success
             return IXML_INSUFFICIENT_MEMORY;
@@ -1737,12 +1786,9 @@ Parser_xmlNamespace( IN Parser * xmlParser,
 
     if( strcmp( newNode->nodeName, "xmlns" ) == 0 ) // default namespace def.
     {
-        if( pCur->namespaceUri != NULL ) {
-            free( pCur->namespaceUri );
-        }
 ///here it goes to segfault on "" when not copying
    if(newNode->nodeValue){
-         pCur->namespaceUri = safe_strdup( newNode->nodeValue );
+         pCur->namespaceUri = Parser_intern( xmlParser, newNode->nodeValue );
          if( pCur->namespaceUri == NULL ) {
              return IXML_INSUFFICIENT_MEMORY;
          }
@@ -1762,9 +1808,7 @@ Parser_xmlNamespace( IN Parser * xmlParser,
 
         if( ( pCur->prefix != NULL )
             && ( strcmp( pCur->prefix, newNode->localName ) == 0 ) ) {
-            if( pCur->namespaceUri != NULL ) { free( pCur->namespaceUri ); } // Bug fix of a memory leak in the initial library.
-                                                                             // Frees namespaceUri, if != NULL, then replaces the old value. Is it OK ? 
-            pCur->namespaceUri = safe_strdup( newNode->nodeValue );
+            pCur->namespaceUri = Parser_intern( xmlParser, newNode->nodeValue );
             if( pCur->namespaceUri == NULL ) {
                 return IXML_INSUFFICIENT_MEMORY;
             }
@@ -1791,15 +1835,14 @@ Parser_xmlNamespace( IN Parser * xmlParser,
                 }
                 memset( pNewNs, 0, sizeof( IXML_NamespaceURI ) );
 
-                pNewNs->prefix = safe_strdup( newNode->localName );
+                pNewNs->prefix = Parser_intern( xmlParser, newNode->localName );
                 if( pNewNs->prefix == NULL ) {
                     free( pNewNs );
                     return IXML_INSUFFICIENT_MEMORY;
                 }
 
-                pNewNs->nsURI = safe_strdup( newNode->nodeValue );
+                pNewNs->nsURI = Parser_intern( xmlParser, newNode->nodeValue );
                 if( pNewNs->nsURI == NULL ) {
-                    Parser_freeNsURI( pNewNs );
                     free( pNewNs );
                     return IXML_INSUFFICIENT_MEMORY;
                 }
@@ -1811,11 +1854,7 @@ Parser_xmlNamespace( IN Parser * xmlParser,
                 }
             } else              // udpate the namespace
             {
-                if( pNs->nsURI != NULL ) {
-                    free( pNs->nsURI );
-                }
-
-                pNs->nsURI = safe_strdup( newNode->nodeValue );
+                pNs->nsURI = Parser_intern( xmlParser, newNode->nodeValue );
                 if( pNs->nsURI == NULL ) {
                     return IXML_INSUFFICIENT_MEMORY;
                 }
@@ -1939,17 +1978,24 @@ Parser_ElementPrefixDefined( IN Parser * xmlParser,
 
     IXML_ElementStack *pCur = xmlParser->pCurElement;
     IXML_NamespaceURI *pNsUri;
+    const char *prefix;
+
+    // the prefixes of the stack are symbols : a prefix which is not one
+    // is not defined, the others are compared by address
+    prefix = ixml_arena_lookup( xmlParser->symbols, newNode->prefix );
+    if( prefix == NULL ) {
+        return FALSE;
+    }
 
     while( pCur != NULL ) {
-        if( ( pCur->prefix != NULL )
-            && ( strcmp( pCur->prefix, newNode->prefix ) == 0 ) ) {
+        if( pCur->prefix == prefix ) {
             *nsURI = pCur->namespaceUri;
             return TRUE;
         } else {
             pNsUri = pCur->pNsURI;
 
             while( pNsUri != NULL ) {
-                if( strcmp( pNsUri->prefix, newNode->prefix ) == 0 ) {
+                if( pNsUri->prefix == prefix ) {
                     *nsURI = pNsUri->nsURI;
                     return TRUE;
                 } else {
@@ -2036,7 +2082,7 @@ Parser_setElementNamespace( IN IXML_Element * newElement,
         if( newElement->n.namespaceURI != NULL ) {
             return IXML_SYNTAX_ERR;
         } else {
-            ( newElement->n ).namespaceURI = safe_strdup( nsURI );
+            ( newElement->n ).namespaceURI = ixml_node_symdup( &newElement->n, nsURI );
             if( ( newElement->n ).namespaceURI == NULL ) {
                 return IXML_INSUFFICIENT_MEMORY;
             }
@@ -2108,11 +2154,17 @@ Parser_processContent( IN Parser * xmlParser,
         xmlParser->curPtr = xmlParser->savePtr;
         pEndContent = xmlParser->curPtr;
 
-        while( ( *pEndContent != LESSTHAN ) &&
+        pEndContent =
+            ( char * )ixml_scan_delimiters( pEndContent, xmlParser->endPtr,
+                                            LESSTHAN, notAllowed[0] );
+        while( ( *pEndContent == notAllowed[0] ) &&
                ( strncmp
                  ( pEndContent, ( const char * )notAllowed,
-                   strlen( notAllowed ) ) != 0 ) && *pEndContent ) {
-            pEndContent++;
+                   strlen( notAllowed ) ) != 0 ) ) {
+            pEndContent =
+                ( char * )ixml_scan_delimiters( pEndContent + 1,
+                                                xmlParser->endPtr, LESSTHAN,
+                                                notAllowed[0] );
         }
 
         if( *pEndContent == '\0' ) {
@@ -2208,51 +2260,6 @@ Parser_processETag( IN Parser * xmlParser,
     return IXML_SUCCESS;
 }
 
-/*==============================================================================*
-*
-*   Parser_freeElementStackItem
-*       frees one ElementStack item.
-*       Internal to parser only.       
-*
-*===============================================================================*/
-static void
-Parser_freeElementStackItem( IN IXML_ElementStack * pItem )
-{
-    assert( pItem != NULL );
-    if( pItem->element != NULL ) {
-        free( pItem->element );
-        pItem->element = NULL;
-    }
-    if( pItem->namespaceUri != NULL ) {
-        free( pItem->namespaceUri );
-        pItem->namespaceUri = NULL;
-    }
-    if( pItem->prefix != NULL ) {
-        free( pItem->prefix );
-        pItem->prefix = NULL;
-    }
-
-}
-
-/*==============================================================================*
-*
-*   Parser_freeNsURI
-*       frees namespaceURI item.
-*       Internal to parser only.       
-*
-*===============================================================================*/
-static void
-Parser_freeNsURI( IN IXML_NamespaceURI * pNsURI )
-{
-    assert( pNsURI != NULL );
-    if( pNsURI->nsURI != NULL ) {
-        free( pNsURI->nsURI );
-    }
-    if( pNsURI->prefix != NULL ) {
-        free( pNsURI->prefix );
-    }
-}
-
 /*==============================================================================*
 *
 *   Parser_free
@@ -2282,12 +2289,9 @@ Parser_free( IN Parser * xmlParser )
 
     pElement = xmlParser->pCurElement;
     while( pElement != NULL ) {
-        Parser_freeElementStackItem( pElement );
-
         pNsURI = pElement->pNsURI;
         while( pNsURI != NULL ) {
             pNextNsURI = pNsURI->nextNsURI;
-            Parser_freeNsURI( pNsURI );
             free( pNsURI );
             pNsURI = pNextNsURI;
         }
@@ -2297,24 +2301,14 @@ Parser_free( IN Parser * xmlParser )
         pElement = pNextElement;
     }
 
+    if( xmlParser->ownSymbols ) {
+        ixml_arena_destroy( xmlParser->symbols );
+    }
+
     free( xmlParser );
 
 }
 
-/*==============================================================================*
-*
-*   Parser_parseReference  
-*       return IXML_SUCCESS or not
-*        
-*
-*===============================================================================*/
-static int
-Parser_parseReference( IN char *pStr )
-{                               // place holder for future implementation
-    if(NULL != pStr) pStr = pStr; // Juste to fix compil warning - Unused variable
-    return IXML_SUCCESS;
-}
-
 /*==============================================================================*
 *
 *   Parser_processAttribute   
@@ -2331,7 +2325,6 @@ Parser_processAttribute( IN Parser * xmlParser,
 
     char *strEndQuote = NULL;
     int tlen = 0;
-    char *pCur = NULL;
     char *pCurToken = NULL;
 
     assert( xmlParser );
@@ -2372,22 +2365,13 @@ Parser_processAttribute( IN Parser * xmlParser,
         return IXML_SYNTAX_ERR;
     }
 
-    strEndQuote = strstr( xmlParser->curPtr, pCurToken );
-    if( strEndQuote == NULL ) {
+    // the value ends at the quote, with no illegal '<' before it
+    strEndQuote =
+        ( char * )ixml_scan_delimiters( xmlParser->curPtr, xmlParser->endPtr,
+                                        *pCurToken, LESSTHAN );
+    if( *strEndQuote != *pCurToken ) {
         return IXML_SYNTAX_ERR;
     }
-    // check between curPtr and strEndQuote, whether there are illegal chars.
-    pCur = xmlParser->curPtr;
-    while( pCur < strEndQuote ) {
-        if( *pCur == '<' ) {
-            return IXML_SYNTAX_ERR;
-        }
-
-        if( *pCur == '&' ) {
-            Parser_parseReference( ++pCur );
-        }
-        pCur++;
-    }
     //clear token buffer
     Parser_clearTokenBuf( xmlParser );
     if( strEndQuote != xmlParser->curPtr ) {
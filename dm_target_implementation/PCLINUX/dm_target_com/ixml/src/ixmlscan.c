@@ -0,0 +1,174 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : ixmlscan.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file ixmlscan.c
+ *
+ * @brief Bulk scanning of the input buffer of the ixml parser
+ *
+ * The vector loops are selected from the target (SSE2 or NEON). Compiled with
+ * IXML_SCAN_SCALAR, only the byte loops are used (reference of the parser benchmark).
+ *
+ */
+
+#if defined( IXML_SCAN_SCALAR )
+// byte loops only
+#elif defined( __SSE2__ )
+#include <emmintrin.h>
+#define IXML_SCAN_SSE2
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#define IXML_SCAN_NEON
+#endif
+
+#include "ixmlscan.h"
+
+// Bytes examined at each step of the vector loops
+#define IXML_SCAN_STEP (16)
+
+/*================================================================
+*   ixml_scan_isPlainChar
+*       A plain char is an ASCII XML char (see Parser_isXmlChar)
+*       other than '&' : it is copied as is from the source to a
+*       token, without UTF-8 decoding nor entity substitution.
+*       Internal function.
+*
+*=================================================================*/
+static BOOL
+ixml_scan_isPlainChar( IN char c )
+{
+    unsigned char u = ( unsigned char )c;
+
+    return ( ( ( u >= 0x20 ) && ( u < 0x80 ) && ( u != '&' ) ) ||
+             ( u == 0x9 ) || ( u == 0xA ) || ( u == 0xD ) );
+}
+
+/*================================================================
+*   ixml_scan_plainChars
+*       Returns the first char of [p, pend[ which is not a plain
+*       char, pend if there is none.
+*       External function.
+*
+*=================================================================*/
+const char *
+ixml_scan_plainChars( IN const char *p,
+                      IN const char *pend )
+{
+#if defined( IXML_SCAN_SSE2 )
+    const __m128i ctrl = _mm_set1_epi8( 0x1F );
+    const __m128i tab = _mm_set1_epi8( 0x9 );
+    const __m128i lf = _mm_set1_epi8( 0xA );
+    const __m128i cr = _mm_set1_epi8( 0xD );
+    const __m128i amp = _mm_set1_epi8( '&' );
+    __m128i v;
+    __m128i plain;
+    int mask;
+
+    while( pend - p >= IXML_SCAN_STEP ) {
+        v = _mm_loadu_si128( ( const __m128i * )p );
+        // signed compare : the bytes >= 0x80 are negative, so not plain
+        plain = _mm_or_si128( _mm_cmpgt_epi8( v, ctrl ),
+                              _mm_or_si128( _mm_cmpeq_epi8( v, tab ),
+                                            _mm_or_si128( _mm_cmpeq_epi8( v, lf ),
+                                                          _mm_cmpeq_epi8( v, cr ) ) ) );
+        plain = _mm_andnot_si128( _mm_cmpeq_epi8( v, amp ), plain );
+        mask = _mm_movemask_epi8( plain ) ^ 0xFFFF;
+        if( mask != 0 ) {
+            return p + __builtin_ctz( mask );
+        }
+        p += IXML_SCAN_STEP;
+    }
+#elif defined( IXML_SCAN_NEON )
+    const int8x16_t ctrl = vdupq_n_s8( 0x1F );
+    uint8x16_t v;
+    uint8x16_t plain;
+
+    while( pend - p >= IXML_SCAN_STEP ) {
+        v = vld1q_u8( ( const uint8_t * )p );
+        plain = vorrq_u8( vcgtq_s8( vreinterpretq_s8_u8( v ), ctrl ),
+                          vorrq_u8( vceqq_u8( v, vdupq_n_u8( 0x9 ) ),
+                                    vorrq_u8( vceqq_u8( v, vdupq_n_u8( 0xA ) ),
+                                              vceqq_u8( v, vdupq_n_u8( 0xD ) ) ) ) );
+        plain = vbicq_u8( plain, vceqq_u8( v, vdupq_n_u8( '&' ) ) );
+        if( vminvq_u8( plain ) == 0 ) {
+            break;              // the byte loop below locates it in this step
+        }
+        p += IXML_SCAN_STEP;
+    }
+#endif
+
+    while( ( p < pend ) && ixml_scan_isPlainChar( *p ) ) {
+        p++;
+    }
+
+    return p;
+}
+
+/*================================================================
+*   ixml_scan_delimiters
+*       Returns the first occurence of d1 or d2 in [p, pend[, pend
+*       if there is none.
+*       External function.
+*
+*=================================================================*/
+const char *
+ixml_scan_delimiters( IN const char *p,
+                      IN const char *pend,
+                      IN char d1,
+                      IN char d2 )
+{
+#if defined( IXML_SCAN_SSE2 )
+    const __m128i v1 = _mm_set1_epi8( d1 );
+    const __m128i v2 = _mm_set1_epi8( d2 );
+    __m128i v;
+    int mask;
+
+    while( pend - p >= IXML_SCAN_STEP ) {
+        v = _mm_loadu_si128( ( const __m128i * )p );
+        mask = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, v1 ),
+                                                _mm_cmpeq_epi8( v, v2 ) ) );
+        if( mask != 0 ) {
+            return p + __builtin_ctz( mask );
+        }
+        p += IXML_SCAN_STEP;
+    }
+#elif defined( IXML_SCAN_NEON )
+    const uint8x16_t v1 = vdupq_n_u8( ( uint8_t )d1 );
+    const uint8x16_t v2 = vdupq_n_u8( ( uint8_t )d2 );
+    uint8x16_t v;
+
+    while( pend - p >= IXML_SCAN_STEP ) {
+        v = vld1q_u8( ( const uint8_t * )p );
+        if( vmaxvq_u8( vorrq_u8( vceqq_u8( v, v1 ), vceqq_u8( v, v2 ) ) ) != 0 ) {
+            break;              // the byte loop below locates it in this step
+        }
+        p += IXML_SCAN_STEP;
+    }
+#endif
+
+    while( ( p < pend ) && ( *p != d1 ) && ( *p != d2 ) ) {
+        p++;
+    }
+
+    return p;
+}
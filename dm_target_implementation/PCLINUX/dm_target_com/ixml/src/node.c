@@ -83,6 +83,14 @@ ixmlNode_freeSingleNode( IN IXML_Node * nodeptr )
     IXML_Element *element = NULL;
 
     if( nodeptr != NULL ) {
+        if( nodeptr->inArena ) {
+            // the node and its strings are released with the arena of the document
+            if( nodeptr->nodeType == eDOCUMENT_NODE ) {
+                ixml_arena_destroy( ( ( IXML_Document * ) nodeptr )->arena );
+            }
+            return;
+        }
+
         if( nodeptr->nodeName != NULL ) {
             free( nodeptr->nodeName );
         }
@@ -183,12 +191,12 @@ ixmlNode_setNamespaceURI( IN IXML_Node * nodeptr,
     }
 
     if( nodeptr->namespaceURI != NULL ) {
-        free( nodeptr->namespaceURI );
+        ixml_node_strfree( nodeptr, nodeptr->namespaceURI );
         nodeptr->namespaceURI = NULL;
     }
 
     if( namespaceURI != NULL ) {
-        nodeptr->namespaceURI = strdup( namespaceURI );
+        nodeptr->namespaceURI = ixml_node_symdup( nodeptr, namespaceURI );
         if( nodeptr->namespaceURI == NULL ) {
             return IXML_INSUFFICIENT_MEMORY;
         }
@@ -215,12 +223,12 @@ ixmlNode_setPrefix( IN IXML_Node * nodeptr,
     }
 
     if( nodeptr->prefix != NULL ) {
-        free( nodeptr->prefix );
+        ixml_node_strfree( nodeptr, nodeptr->prefix );
         nodeptr->prefix = NULL;
     }
 
     if( prefix != NULL ) {
-        nodeptr->prefix = strdup( prefix );
+        nodeptr->prefix = ixml_node_symdup( nodeptr, prefix );
         if( nodeptr->prefix == NULL ) {
             return IXML_INSUFFICIENT_MEMORY;
         }
@@ -246,12 +254,12 @@ ixmlNode_setLocalName( IN IXML_Node * nodeptr,
     assert( nodeptr != NULL );
 
     if( nodeptr->localName != NULL ) {
-        free( nodeptr->localName );
+        ixml_node_strfree( nodeptr, nodeptr->localName );
         nodeptr->localName = NULL;
     }
 
     if( localName != NULL ) {
-        nodeptr->localName = strdup( localName );
+        nodeptr->localName = ixml_node_symdup( nodeptr, localName );
         if( nodeptr->localName == NULL ) {
             return IXML_INSUFFICIENT_MEMORY;
         }
@@ -339,12 +347,12 @@ ixmlNode_setNodeValue( IN IXML_Node * nodeptr,
     }
 
     if( nodeptr->nodeValue != NULL ) {
-        free( nodeptr->nodeValue );
+        ixml_node_strfree( nodeptr, nodeptr->nodeValue );
         nodeptr->nodeValue = NULL;
     }
 
     if( newNodeValue != NULL ) {
-        nodeptr->nodeValue = strdup( newNodeValue );
+        nodeptr->nodeValue = ixml_node_strdup( nodeptr, newNodeValue );
         if( nodeptr->nodeValue == NULL ) {
             return IXML_INSUFFICIENT_MEMORY;
         }
@@ -829,6 +837,11 @@ ixmlNode_appendChild( IN IXML_Node * nodeptr,
     }
     // set the parent node pointer
     newChild->parentNode = nodeptr;
+    if( !newChild->inArena && ( nodeptr->ownerDocument != NULL ) &&
+        ( nodeptr->ownerDocument->arena != NULL ) ) {
+        // a heap node now belongs to an arena document
+        nodeptr->ownerDocument->hasHeapNodes = TRUE;
+    }
     newChild->ownerDocument = nodeptr->ownerDocument;
 
     //if the first child
@@ -1416,33 +1429,56 @@ ixmlNode_hasAttributes( IXML_Node * nodeptr )
 
 }
 
+/*================================================================
+*   ixmlNode_hasTagName
+*       Decides whether the element n is named tagname. symbol is
+*       tagname in the symbol table of doc (NULL if not there) :
+*       the arena nodes of doc are checked by address.
+*       Internal to parser.
+*
+*=================================================================*/
+static BOOL
+ixmlNode_hasTagName( IN IXML_Node * n,
+                     IN const char *tagname,
+                     IN const char *symbol,
+                     IN IXML_Document * doc )
+{
+    if( n->inArena && ( n->ownerDocument == doc ) ) {
+        return ( n->nodeName == symbol );
+    }
+
+    return ( strcmp( tagname, n->nodeName ) == 0 );
+}
+
 /*================================================================
 *   ixmlNode_getElementsByTagNameRecursive
 *       Recursively traverse the whole tree, search for element
-*       with the given tagname.
+*       with the given tagname (NULL for all the elements), see
+*       ixmlNode_hasTagName.
 *       Internal to parser.
 *
 *=================================================================*/
 void
 ixmlNode_getElementsByTagNameRecursive( IN IXML_Node * n,
                                         IN const char *tagname,
+                                        IN const char *symbol,
+                                        IN IXML_Document * doc,
                                         OUT IXML_NodeList ** list )
 {
-    const char *name;
-
     if( n != NULL ) {
         if( ixmlNode_getNodeType( n ) == eELEMENT_NODE ) {
-            name = ixmlNode_getNodeName( n );
-            if( strcmp( tagname, name ) == 0
-                || strcmp( tagname, "*" ) == 0 ) {
+            if( ( tagname == NULL )
+                || ixmlNode_hasTagName( n, tagname, symbol, doc ) ) {
                 ixmlNodeList_addToNodeList( list, n );
             }
         }
 
         ixmlNode_getElementsByTagNameRecursive( ixmlNode_getFirstChild
-                                                ( n ), tagname, list );
+                                                ( n ), tagname, symbol,
+                                                doc, list );
         ixmlNode_getElementsByTagNameRecursive( ixmlNode_getNextSibling
-                                                ( n ), tagname, list );
+                                                ( n ), tagname, symbol,
+                                                doc, list );
     }
 
 }
@@ -1460,19 +1496,30 @@ ixmlNode_getElementsByTagName( IN IXML_Node * n,
                                IN const char *tagname,
                                OUT IXML_NodeList ** list )
 {
-    const char *name;
+    IXML_Document *doc;
+    const char *symbol = NULL;
 
     assert( n != NULL && tagname != NULL );
 
+    doc = n->ownerDocument;
+    if( strcmp( tagname, "*" ) == 0 ) {
+        tagname = NULL;
+    } else if( ( doc != NULL ) && ( doc->arena != NULL ) ) {
+        symbol = ixml_arena_lookup( doc->arena, tagname );
+        if( ( symbol == NULL ) && !doc->hasHeapNodes ) {
+            return;             // no node of the document has this name
+        }
+    }
+
     if( ixmlNode_getNodeType( n ) == eELEMENT_NODE ) {
-        name = ixmlNode_getNodeName( n );
-        if( strcmp( tagname, name ) == 0 || strcmp( tagname, "*" ) == 0 ) {
+        if( ( tagname == NULL )
+            || ixmlNode_hasTagName( n, tagname, symbol, doc ) ) {
             ixmlNodeList_addToNodeList( list, n );
         }
     }
 
     ixmlNode_getElementsByTagNameRecursive( ixmlNode_getFirstChild( n ),
-                                            tagname, list );
+                                            tagname, symbol, doc, list );
 
 }
 
@@ -1567,20 +1614,20 @@ ixmlNode_setNodeName( IN IXML_Node * node,
     assert( node != NULL );
 
     if( node->nodeName != NULL ) {
-        free( node->nodeName );
+        ixml_node_strfree( node, node->nodeName );
         node->nodeName = NULL;
     }
 
     if( qualifiedName != NULL ) {
         // set the name part
-        node->nodeName = strdup( qualifiedName );
+        node->nodeName = ixml_node_symdup( node, qualifiedName );
         if( node->nodeName == NULL ) {
             return IXML_INSUFFICIENT_MEMORY;
         }
 
         rc = Parser_setNodePrefixAndLocalName( node );
         if( rc != IXML_SUCCESS ) {
-            free( node->nodeName );
+            ixml_node_strfree( node, node->nodeName );
         }
     }
 
@@ -1622,15 +1669,15 @@ ixmlNode_setNodeProperties( IN IXML_Node * destNode,
 
   ErrorHandler:
     if( destNode->nodeName != NULL ) {
-        free( destNode->nodeName );
+        ixml_node_strfree( destNode, destNode->nodeName );
         destNode->nodeName = NULL;
     }
     if( destNode->nodeValue != NULL ) {
-        free( destNode->nodeValue );
+        ixml_node_strfree( destNode, destNode->nodeValue );
         destNode->nodeValue = NULL;
     }
     if( destNode->localName != NULL ) {
-        free( destNode->localName );
+        ixml_node_strfree( destNode, destNode->localName );
         destNode->localName = NULL;
     }
 
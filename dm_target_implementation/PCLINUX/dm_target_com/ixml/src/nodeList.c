@@ -58,32 +58,19 @@ IXML_Node *
 ixmlNodeList_item( IXML_NodeList * nList,
                    unsigned long index )
 {
-    IXML_NodeList *next;
-    unsigned int i;
-
-    // if the list ptr is NULL
-    if( nList == NULL ) {
-        return NULL;
-    }
-    // if index is more than list length
-    if( index > ixmlNodeList_length( nList ) - 1 ) {
+    // if the list ptr is NULL or index is more than list length
+    if( ( nList == NULL ) || ( index >= nList->length ) ) {
         return NULL;
     }
 
-    next = nList;
-    for( i = 0; i < index && next != NULL; ++i ) {
-        next = next->next;
-    }
-
-    if( next == NULL ) return NULL;
-
-    return next->nodeItem;
+    return nList->nodeItems[index];
 
 }
 
 /*================================================================
 *   ixmlNodeList_addToNodeList
-*       Add a node to nodelist
+*       Add a node to nodelist. The array of the nodes grows by
+*       doubling its capacity.
 *       Internal to parser only.
 *
 *=================================================================*/
@@ -91,9 +78,8 @@ int
 ixmlNodeList_addToNodeList( IN IXML_NodeList ** nList,
                             IN IXML_Node * add )
 {
-    IXML_NodeList *traverse,
-     *p = NULL;
-    IXML_NodeList *newListItem;
+    IXML_Node **newItems;
+    unsigned long newCapacity;
 
     assert( add != NULL );
 
@@ -111,25 +97,19 @@ ixmlNodeList_addToNodeList( IN IXML_NodeList ** nList,
         ixmlNodeList_init( *nList );
     }
 
-    if( ( *nList )->nodeItem == NULL ) {
-        ( *nList )->nodeItem = add;
-    } else {
-        traverse = *nList;
-        while( traverse != NULL ) {
-            p = traverse;
-            traverse = traverse->next;
-        }
-
-        newListItem =
-            ( IXML_NodeList * ) malloc( sizeof( IXML_NodeList ) );
-        if( newListItem == NULL ) {
+    if( ( *nList )->length == ( *nList )->capacity ) {
+        newCapacity = ( ( *nList )->capacity == 0 ? NODELIST_DEF_CAPACITY : 2 * ( *nList )->capacity );
+        newItems = ( IXML_Node ** ) realloc( ( *nList )->nodeItems,
+                                             newCapacity * sizeof( IXML_Node * ) );
+        if( newItems == NULL ) {
             return IXML_INSUFFICIENT_MEMORY;
         }
-        p->next = newListItem;
-        newListItem->nodeItem = add;
-        newListItem->next = NULL;
+        ( *nList )->nodeItems = newItems;
+        ( *nList )->capacity = newCapacity;
     }
 
+    ( *nList )->nodeItems[( *nList )->length++] = add;
+
     return IXML_SUCCESS;
 }
 
@@ -143,16 +123,11 @@ ixmlNodeList_addToNodeList( IN IXML_NodeList ** nList,
 unsigned long
 ixmlNodeList_length( IN IXML_NodeList * nList )
 {
-    IXML_NodeList *list;
-    unsigned long length = 0;
-
-    list = nList;
-    while( list != NULL ) {
-        ++length;
-        list = list->next;
+    if( nList == NULL ) {
+        return 0;
     }
 
-    return length;
+    return nList->length;
 }
 
 /*================================================================
@@ -164,13 +139,9 @@ ixmlNodeList_length( IN IXML_NodeList * nList )
 void
 ixmlNodeList_free( IN IXML_NodeList * nList )
 {
-    IXML_NodeList *next;
-
-    while( nList != NULL ) {
-        next = nList->next;
-
+    if( nList != NULL ) {
+        free( nList->nodeItems );
         free( nList );
-        nList = next;
     }
 
 }
@@ -22,14 +22,8 @@
  */
 
 
-// The total number of connection requested by ACS
-//unsigned int numberOfConnectionRequest = 0;
-
-// Array used to track the connection request frequency
-
-//time_t connectionFreqArray[MAXCONNECTIONREQUESTARRAYSIZE];
-//#include <stdio.h>
-#include <sys/time.h> /* gettimeofday */
+#include <pthread.h>
+#include <time.h>     /* clock_gettime */
 
 #include "DM_GlobalDefs.h"
 #include "CMN_Trace.h"
@@ -38,81 +32,73 @@
 #include "DM_COM_ConnectionSecurity.h"
 
 /**
- * @brief This routine is used to initialize the 
- *        connection request frequency array.
- *        This array is used to limit the number
- *        of connection request per minute.
- *
- * @param 
- *
- * @return Void
- *
+ * Token bucket limiting the connection requests of one path. The bucket holds up to
+ * MaxConnectionRequest tokens and is refilled at the rate of MaxConnectionRequest tokens
+ * per FreqConnectionRequest seconds. Each allowed connection request takes one token.
  */
-void
-    initConnectionFreqArray(time_t *connectionFreqArray){
-  int i;
-  for(i=0; i < MAXCONNECTIONREQUESTARRAYSIZE; i++) {
-    connectionFreqArray[i]=0;
-  }
-}
+typedef struct _ConnectionRateLimiter
+{
+  double        tokens;         // Available tokens (< 0 before the first use : the bucket is full)
+  double        lastRefillTime; // Time of the last refill (in seconds)
+  unsigned int  allowed;        // Number of connection requests allowed
+  unsigned int  rejected;       // Number of connection requests refused by the policy
+
+} ConnectionRateLimiter;
 
+static ConnectionRateLimiter connectionRateLimiters[CONNECTION_REQUEST_NB_PATHS];
+static pthread_mutex_t       mutexConnectionRateLimiter = PTHREAD_MUTEX_INITIALIZER;
 
+// Connection request policy shared by the paths, cached from the data model
+static unsigned int maxConnectionRequest    = DEFAULT_MAX_CONNECTIONREQUEST;
+static unsigned int periodConnectionRequest = DEFAULT_FREQ_CONNECTION_REQUEST;
+static double       policyReadTime          = 0;
+static bool         policyRead              = FALSE;
 
 /**
- * @brief This routine is used to update the
- *        connection request frequency array.
- *        A new entry is added with the current time
- *        (and the last entry is lost).
+ * @brief Private routine used to get the monotonic time
  *
- * @param 
+ * @param none
  *
- * @return Void
+ * @return The time in seconds
  *
  */
-void
-    newConnectionRequestAllowed(time_t *connectionFreqArray){
-  struct timeval t;
-  time_t curtime;
-  int    i;
-  
-  gettimeofday( &t, NULL );
-  curtime = t.tv_sec;
-  
-  // Move the array entry to array entry + 1
-  for(i = (MAXCONNECTIONREQUESTARRAYSIZE-1); i > 0 ; i--) {
-    connectionFreqArray[i]=connectionFreqArray[i-1];
-  } 
-  
-  // Set the new entry
-  connectionFreqArray[0] = curtime;
+static double
+_currentTime()
+{
+  struct timespec ts;
 
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
 }
 
-
-
 /**
- * @brief This routine is used to check
- *        the connection acceptance policy
+ * @brief Private routine used to read the number of connection
+ *        allowed in the period and the period duration in seconds.
+ *        They are read again after CONNECTION_REQUEST_POLICY_REFRESH seconds
+ *        so the DM_ENGINE is not called on each connection request.
  *
- * @param 
+ * @param curtime - The current time
  *
  * @return Void
  *
  */
-bool
-    maxConnectionPerPeriodReached(time_t *connectionFreqArray){
-  unsigned int             numberOfRequestDuringThePreviousPeriod = 0;
-  int                      i;
-  struct                   timeval t;
-  time_t                   curtime;
-  bool                     maxConnectionPerPeriodReachedFlag = TRUE;
-  unsigned int             maxConnectionRequest    = 0;
-  unsigned int             periodConnectionRequest   = 0;  
-  char                   * pParameterName[3];
+static void
+_readConnectionRequestPolicy(double curtime)
+{
+  unsigned int                  maxRequest = DEFAULT_MAX_CONNECTIONREQUEST;
+  unsigned int                  period     = DEFAULT_FREQ_CONNECTION_REQUEST;
+  char                        * pParameterName[3];
   DM_ENG_ParameterValueStruct ** pResultGet = NULL;
-  
-      
-  // Retrieve the number of connection allowed in the period and the period duration in seconds.
+  bool                           upToDate;
+
+  // Called by the HTTP server and STUN threads
+  pthread_mutex_lock( &mutexConnectionRateLimiter );
+  upToDate = policyRead && ( curtime - policyReadTime < CONNECTION_REQUEST_POLICY_REFRESH );
+  pthread_mutex_unlock( &mutexConnectionRateLimiter );
+  if ( upToDate ) {
+    return;
+  }
+
   pParameterName[0] = DM_TR106_MAXCONNECTIONREQUEST;
   pParameterName[1] = DM_TR106_MAXCONNECTIONFREQ;
   pParameterName[2] = NULL;
@@ -121,53 +107,173 @@ bool
     if((NULL == pResultGet[0]->value) || 
        (NULL == pResultGet[1]->value)) {
       EXEC_ERROR("Can not retrieve Max Connection Request / Freq. Set default value.");
-      maxConnectionRequest    = DEFAULT_MAX_CONNECTIONREQUEST;
-      periodConnectionRequest = DEFAULT_FREQ_CONNECTION_REQUEST;       
     } else {
-      DM_ENG_stringToUint(pResultGet[0]->value, &maxConnectionRequest);
-      DM_ENG_stringToUint(pResultGet[1]->value, &periodConnectionRequest);
-      DBG("maxConnectionRequest = %d, periodConnectionRequest = %d", maxConnectionRequest, periodConnectionRequest);
-      
-      // Check the maximum array size is not reached
-      if(maxConnectionRequest >= MAXCONNECTIONREQUESTARRAYSIZE) {
-        DBG("Exceeds the array size (%d). Set default value", MAXCONNECTIONREQUESTARRAYSIZE);
-        maxConnectionRequest = DEFAULT_MAX_CONNECTIONREQUEST;
-      }
+      DM_ENG_stringToUint(pResultGet[0]->value, &maxRequest);
+      DM_ENG_stringToUint(pResultGet[1]->value, &period);
+      DBG("maxConnectionRequest = %d, periodConnectionRequest = %d", maxRequest, period);
     }
     DM_ENG_deleteTabParameterValueStruct(pResultGet);
   } else {
     EXEC_ERROR("Can not retrieve max and freq connection request - Set default value");
-    maxConnectionRequest    = DEFAULT_MAX_CONNECTIONREQUEST;
-    periodConnectionRequest = DEFAULT_FREQ_CONNECTION_REQUEST;
   }
-  gettimeofday( &t, NULL );
-  curtime = t.tv_sec;  
-
-  // count the number of connection request allowed during the previous period
-  for(i=0; i < MAXCONNECTIONREQUESTARRAYSIZE ; i++) {
-    // Check if the connectionFreqArray is within the last periodConnectionRequest seconds.
-    if((long int)(curtime - connectionFreqArray[i]) < (long int) periodConnectionRequest) {
-      numberOfRequestDuringThePreviousPeriod++;
+
+  pthread_mutex_lock( &mutexConnectionRateLimiter );
+  maxConnectionRequest    = maxRequest;
+  periodConnectionRequest = period;
+  policyReadTime          = curtime;
+  policyRead              = TRUE;
+  pthread_mutex_unlock( &mutexConnectionRateLimiter );
+}
+
+/**
+ * @brief Private routine used to add the tokens earned since
+ *        the last refill. Must be called under mutexConnectionRateLimiter.
+ *
+ * @param limiter - The token bucket
+ * @param curtime - The current time
+ *
+ * @return Void
+ *
+ */
+static void
+_refillConnectionRateLimiter(ConnectionRateLimiter * limiter, double curtime)
+{
+  if ( ( limiter->tokens < 0 ) || ( 0 == periodConnectionRequest ) ) {
+    limiter->tokens = maxConnectionRequest;
+  } else if ( curtime > limiter->lastRefillTime ) {
+    limiter->tokens += ( curtime - limiter->lastRefillTime ) * maxConnectionRequest / periodConnectionRequest;
+    if ( limiter->tokens > maxConnectionRequest ) {
+      limiter->tokens = maxConnectionRequest;
     }
   }
-  
-  DBG( "numberOfRequestDuringThePreviousPeriod = %d", numberOfRequestDuringThePreviousPeriod );
-  DBG( "periodConnectionRequest = %d", periodConnectionRequest );
-  DBG( "maxConnectionRequestArraySize = %d", MAXCONNECTIONREQUESTARRAYSIZE );
-  if(numberOfRequestDuringThePreviousPeriod <  maxConnectionRequest) {
+  limiter->lastRefillTime = curtime;
+}
+
+/**
+ * @brief This routine is used to initialize the 
+ *        connection request token bucket of a path.
+ *        This bucket is used to limit the number
+ *        of connection request per period.
+ *        The bucket is full until the first connection request.
+ *
+ * @param path - The connection request path
+ *
+ * @return Void
+ *
+ */
+void
+    initConnectionRateLimiter(ConnectionRequestPath path){
+  pthread_mutex_lock( &mutexConnectionRateLimiter );
+  connectionRateLimiters[path].tokens         = -1;
+  connectionRateLimiters[path].lastRefillTime = 0;
+  pthread_mutex_unlock( &mutexConnectionRateLimiter );
+}
+
+
+
+/**
+ * @brief This routine is used to take a token
+ *        from the bucket of the path when a new
+ *        connection request is allowed.
+ *
+ * @param path - The connection request path
+ *
+ * @return Void
+ *
+ */
+void
+    newConnectionRequestAllowed(ConnectionRequestPath path){
+  ConnectionRateLimiter * limiter = &connectionRateLimiters[path];
+
+  pthread_mutex_lock( &mutexConnectionRateLimiter );
+  _refillConnectionRateLimiter( limiter, _currentTime() );
+  limiter->tokens -= 1;
+  if ( limiter->tokens < 0 ) {
+    // Another thread of this path took the last token since the check
+    limiter->tokens = 0;
+  }
+  limiter->allowed++;
+  pthread_mutex_unlock( &mutexConnectionRateLimiter );
+}
+
+
+
+/**
+ * @brief This routine is used to check
+ *        the connection acceptance policy :
+ *        a token must be available in the bucket of the path.
+ *        A refused connection request is counted.
+ *
+ * @param path - The connection request path
+ *
+ * @return TRUE if the connection request must be refused
+ *
+ */
+bool
+    maxConnectionPerPeriodReached(ConnectionRequestPath path){
+  ConnectionRateLimiter * limiter = &connectionRateLimiters[path];
+  bool                    maxConnectionPerPeriodReachedFlag = TRUE;
+  double                  curtime = _currentTime();
+
+  _readConnectionRequestPolicy( curtime );
+
+  pthread_mutex_lock( &mutexConnectionRateLimiter );
+  _refillConnectionRateLimiter( limiter, curtime );
+  DBG( "Available connection request tokens = %.2f (max %d per %d s)", limiter->tokens, maxConnectionRequest, periodConnectionRequest );
+  if ( limiter->tokens >= 1 ) {
     // The maximum number of connection per period is not reached
-    // Make sure the number freq does not exceeds the array size
-    if(numberOfRequestDuringThePreviousPeriod == MAXCONNECTIONREQUESTARRAYSIZE) {
-      // Exceeds the array size. Should never arrive...
-      WARN( "The maximum number of connections per period is reached (Max array size reached)" );
-    } else {
-      maxConnectionPerPeriodReachedFlag = FALSE;
-    }
+    maxConnectionPerPeriodReachedFlag = FALSE;
     DBG( "The maximum number of connections per period is NOT reached" );
   } else {
+    limiter->rejected++;
     WARN( "The maximum number of connections per period is reached" );
   }
+  pthread_mutex_unlock( &mutexConnectionRateLimiter );
   
   return maxConnectionPerPeriodReachedFlag;
 }
 
+
+
+/**
+ * @brief This routine is used to get the number
+ *        of connection requests allowed on a path
+ *
+ * @param path - The connection request path
+ *
+ * @return The counter
+ *
+ */
+unsigned int
+    getConnectionRequestAllowedCount(ConnectionRequestPath path){
+  unsigned int  count;
+
+  pthread_mutex_lock( &mutexConnectionRateLimiter );
+  count = connectionRateLimiters[path].allowed;
+  pthread_mutex_unlock( &mutexConnectionRateLimiter );
+
+  return count;
+}
+
+
+
+/**
+ * @brief This routine is used to get the number
+ *        of connection requests refused by the policy on a path
+ *
+ * @param path - The connection request path
+ *
+ * @return The counter
+ *
+ */
+unsigned int
+    getConnectionRequestRejectedCount(ConnectionRequestPath path){
+  unsigned int  count;
+
+  pthread_mutex_lock( &mutexConnectionRateLimiter );
+  count = connectionRateLimiters[path].rejected;
+  pthread_mutex_unlock( &mutexConnectionRateLimiter );
+
+  return count;
+}
+
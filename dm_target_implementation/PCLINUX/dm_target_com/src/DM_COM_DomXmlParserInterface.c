@@ -41,6 +41,9 @@
 *
 * @return The function returns a pointer on the XML doucment or null on error.
 *
+* The document is parsed, processed and freed at once : its nodes are allocated
+* in an arena released by xmlDocumentFree.
+*
 */
 GenericXmlDocumentPtr
 xmlStringBufferToXmlDocument(IN char * xmlStringBuffer)
@@ -48,7 +51,7 @@ xmlStringBufferToXmlDocument(IN char * xmlStringBuffer)
   IXML_Document* xmlDocumentPtr = NULL;
   
   if(xmlStringBuffer != NULL) {
-    xmlDocumentPtr = ixmlParseBuffer(xmlStringBuffer);
+    xmlDocumentPtr = ixmlParseBufferArena(xmlStringBuffer);
   }
 
   return ((GenericXmlDocumentPtr) xmlDocumentPtr);
@@ -68,7 +71,7 @@ xmlFileToXmlDocument(IN const char* fileName)
   IXML_Document* xmlDocumentPtr = NULL;
   
   if(fileName != NULL) {
-    xmlDocumentPtr = ixmlLoadDocument(fileName);
+    xmlDocumentPtr = ixmlLoadDocumentArena(fileName);
   }
 
   return ((GenericXmlDocumentPtr) xmlDocumentPtr);
@@ -414,17 +417,20 @@ xmlGetNodesListLength(GenericXmlNodeListPtr xmlNodeList)
 unsigned int
 xmlGetNumberOfChildNodes(IN GenericXmlNodePtr     xmlParentNodePt)
 { 
-  unsigned int          nbNodes = 0;
-  GenericXmlNodeListPtr listPtr = NULL;
+  unsigned int nbNodes = 0;
+  IXML_Node *  childPtr = NULL;
   
   // check parameters
   if(NULL == xmlParentNodePt) {
     return nbNodes;
   }
   
-  listPtr = xmlGetChildNodesList(xmlParentNodePt);
-  nbNodes = xmlGetNodesListLength(listPtr);
-  xmlFreeNodesList(listPtr);
+  // Count the children in place (no node list built)
+  for(childPtr = ixmlNode_getFirstChild((IXML_Node *) xmlParentNodePt);
+      NULL != childPtr;
+      childPtr = ixmlNode_getNextSibling(childPtr)) {
+    nbNodes++;
+  }
   
   return nbNodes;
 
@@ -41,14 +41,26 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+#include <zlib.h>
+#endif
 
 extern char * PROXY_ADDRESS_STR;
 
 #define DM_HTTP_THREAD_STACK_SIZE (64*1024*2) // Require larger stack size due to ixml recursive call involving stack overflow
+#define DM_HTTP_MAX_PENDING_MESSAGES (32)   // Beyond, the callers (except the sender thread) wait for the pending messages to be sent
 
 // Pointer on the curl session
 static CURL* _sessionHandle = NULL; // Non NULL value if and only if a session is in progress
 
+// Data kept from one session to the next (the session handle is renewed for each session, with its cookies and
+// authentication) : connections to the ACS, TLS sessions (resumed instead of a full handshake) and DNS cache
+static CURLSH* _sessionShare = NULL;
+static pthread_mutex_t mutexHttpSessionShare[CURL_LOCK_DATA_LAST]; // One per kind of shared data (libcurl may nest them)
+static bool            _httpSessionShareMutexInit = false;
+
 // Used to store Private Data
 static char * _acsURLPtr                    = NULL;
 static char * _acsUsernameStr               = NULL;
@@ -61,15 +73,33 @@ static char * _sslAcsCertificationAuthority = NULL;
 static int    _curlGetHttpFile(httpGetFileDataType * httpGetDataPtr);
 static int    _curlPutHttpFile(httpPutFileDataType * httpPutDataPtr);
 static int    _curlPutFtpFile(httpPutFileDataType * httpPutDataPtr);
+static int    _curlPostHttpData(httpPostDataType * httpPostDataPtr);
 static int    _initHttpSession(); // HTTP Session inititalization is done using httpClientConfiguration
 static size_t _curlCallbackClientData(void   *ptr, size_t  size, size_t  nmemb, void   *stream); // libcurl call back function
 static size_t _curlCallbackClientHeader(void *ptr, size_t  size, size_t  nmemb, void   *stream); // libcurl call back function
 static int    _getLastHttpResponseCode(OUT int * respCodePtr);
 static void   _curlHandleCleanUp();
+static CURLSH* _getHttpSessionShare();
+static void   _curlLockHttpSessionShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr);   // libcurl call back function
+static void   _curlUnlockHttpSessionShare(CURL *handle, curl_lock_data data, void *userptr);                        // libcurl call back function
 static void*  _sendHttpMessage();
-static void   _addPendingHttpMessage(const char* httpMsg);
-static char*  _getFirstPendingHttpMessage();
+static int    _wakeHttpSendThread();
+static bool   _waitHttpPendingRoom();
+static int    _curlProgressHttpSession(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow); // libcurl call back function
+static void   _addPendingHttpMessage(httpMessageBufferType* httpMsg, httpMessageStreamType* httpStream);
+static void   _popPendingHttpMessage();
+static httpMessageBufferType* _gatherPendingHttpMessages(httpMessageBufferType* httpMsg);
 static void   _freePendingHttpMessages();
+static void   _releaseHttpStream(httpMessageStreamType* httpStream);
+static size_t _curlReadHttpStream(void *ptr, size_t size, size_t nmemb, void *stream); // libcurl call back function
+static int    _curlSeekHttpStream(void *stream, curl_off_t offset, int origin);       // libcurl call back function
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+static bool   _startGzipHttpMessage(httpMessageBufferType* httpMsg, httpMessageStreamType* httpStream);
+static bool   _endGzipHttpMessage();
+static bool   _checkGzipResponseHeader(const char * header, int httpResponseCode);
+static size_t _curlReadGzipHttpMessage(void *ptr, size_t size, size_t nmemb, void *stream); // libcurl call back function
+static int    _curlSeekGzipHttpMessage(void *stream, curl_off_t offset, int origin);       // libcurl call back function
+#endif
 static int    _getFirmwareUpgradeErrorCodeFromHttpCode(int rc);
 static int    _getUploadErrorCodeFromHttpCode(int httpRc);
 static char * _stringToLower(const char * str);
@@ -83,37 +113,91 @@ static void   _CloseHttpSession(bool closeMode);
 #define  CURL_GET_FILE_TIMEOUT (300) // Maximum amount of time to download the File.
                                      // Attention, Ne doit pas tre trop car peut tre bloquant, ni trop court pour avoir assez de temps de tlchargement !!
 #define  CURL_PUT_FILE_TIMEOUT (300) // Maximum amount of time to upload the File
+#define  CURL_POST_DATA_TIMEOUT (60) // Maximum amount of time to post a bulk data report
 #define  CURL_CONNECT_TIMEOUT  (30)
 #define  CURL_NOSIGNAL         (1)
 
 // HTTP ERROR CODE DEFINTION (2xx Success, 4xx and 5xx error)
 #define HTTP_OK                (200)
 #define HTTP_TRANSFER_COMPLETE (226)
+#define HTTP_BAD_REQUEST       (400)
 #define HTTP_UNAUTHORIZED      (401)
 #define HTTP_FORBIDDEN         (403)
+#define HTTP_UNSUPPORTED_MEDIA_TYPE (415)
 
 // List used to define the HTTP Content-Type
 static struct  curl_slist * _slist = NULL;
 #define HttpXmlContentType    "Content-Type: text/xml; charset=\"utf-8\""
 #define HttpEmptyContentType  "Content-type: "
+#define HttpChunkedEncoding   "Transfer-Encoding: chunked"
+#define HttpGzipEncoding      "Content-Encoding: gzip"
 
 /* -------------------------------------------------- */
 typedef struct _PendingHttpMessage
 {
-  char* message;
+  httpMessageBufferType* message;
+  httpMessageStreamType* stream; // Set instead of message for a streamed message
   struct _PendingHttpMessage* next;
 
 } __attribute((packed)) PendingHttpMessage;
 
 static bool  _closeHttpSessionExpected          = false; // Flag to indicate if the HTTP Session must be closed
-static char* _httpMessageBeingSent              = NULL;  // Message being sent
+static httpMessageBufferType* _httpMessageBeingSent = NULL; // Message being sent
+static httpMessageStreamType* _httpStreamBeingSent = NULL; // Streamed message being sent
 static PendingHttpMessage* _pendingHttpMessages = NULL;  // Message pending
+static int   _nbPendingHttpMessages             = 0;     // Length of the _pendingHttpMessages list
+static int   _acsMaxEnvelopes                   = 1;     // Number of SOAP envelopes the ACS accepts in one HTTP POST
+
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+// -------------------------------------------------------------
+// gzip Content-Encoding of the messages sent to the ACS
+// -------------------------------------------------------------
+#define GZIP_MIN_MESSAGE_SIZE (1024)    // Smaller messages are sent as they are
+#define GZIP_INPUT_SIZE       (4096)    // Bytes read at a time from a streamed message
+#define GZIP_WINDOW_BITS      (15 + 16) // Default deflate window, +16 for the gzip header and trailer
+#define GZIP_MEM_LEVEL        (8)
+
+typedef enum _GzipAcsSupport
+{
+  GZIP_ACS_UNKNOWN = 0, // Nothing known yet : the messages are sent uncompressed
+  GZIP_ACS_SUPPORTED,   // The ACS has advertised (Accept-Encoding) or used (Content-Encoding) gzip
+  GZIP_ACS_REFUSED      // The ACS has rejected a compressed message : no more compression with this URL
+
+} GzipAcsSupport;
+
+// Message compressed while it is sent (the compressed data are never stored as a whole)
+typedef struct _GzipHttpMessage
+{
+  z_stream                zStream;
+  httpMessageBufferType * message;  // Source of the data : either a message...
+  httpMessageStreamType * stream;   // ...or a streamed message, read by pieces of GZIP_INPUT_SIZE
+  bool                    inputEnd;
+  bool                    outputEnd;
+  char                    input[GZIP_INPUT_SIZE];
+
+} GzipHttpMessage; // Not packed : the z_stream is given to zlib
+
+static GzipAcsSupport  _gzipAcsSupport  = GZIP_ACS_UNKNOWN; // Support of the ACS URL in use
+static bool            _gzipMessageSent = false;            // The message being sent is compressed
+static bool            _gzipRefused     = false;            // The ACS has rejected the message being sent
+static GzipHttpMessage _gzipHttpMessage;
+#endif
 
 #define DefaultFtpUploadFileName "UploadedFile"
 
 
 pthread_mutex_t mutexHttpSendThreadControl = PTHREAD_MUTEX_INITIALIZER;
 
+// Sender thread : started with the first message to send, it then waits for the next ones until DM_StopHttpClient
+static pthread_t      _httpSendThreadId;
+static bool           _httpSendThreadStarted = false;
+static volatile bool  _httpSendThreadStop    = false; // Also read by _curlProgressHttpSession, without the mutex
+static pthread_cond_t condHttpMessageToSend  = PTHREAD_COND_INITIALIZER; // A message is being sent, or the thread must stop
+static pthread_cond_t condHttpPendingRoom    = PTHREAD_COND_INITIALIZER; // Pending messages have been taken or dropped
+
+// Mutex protecting the reference counters of the shared message buffers
+static pthread_mutex_t mutexHttpMessageBuffer = PTHREAD_MUTEX_INITIALIZER;
+
 
 /* --------------------------------------------------- */
 
@@ -153,6 +237,10 @@ int DM_ConfigureHttpClient(const char * acsUrl,
        // New value
          DM_ENG_FREE(_acsURLPtr);
          _acsURLPtr = strdup(acsUrl);
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+         // The support of the compression is learnt again from the new ACS
+         _gzipAcsSupport = GZIP_ACS_UNKNOWN;
+#endif
      }
      
      // Configure the Username
@@ -239,10 +327,43 @@ int DM_CloseHttpSession(bool closeMode)
 */
 int DM_StopHttpClient(void)
 {
+  pthread_t sendThreadId;
+  bool      sendThreadStarted;
+
+  // Stop the sender thread first, so that the curl session is not cleaned up under a message in progress
+  // (the message is aborted by _curlProgressHttpSession)
   pthread_mutex_lock(&mutexHttpSendThreadControl);
+  sendThreadStarted = _httpSendThreadStarted;
+  sendThreadId = _httpSendThreadId;
+  _httpSendThreadStop = true;
+  pthread_cond_signal(&condHttpMessageToSend);
+  pthread_mutex_unlock(&mutexHttpSendThreadControl);
+
+  if (sendThreadStarted)
+  {
+    if (pthread_equal(pthread_self(), sendThreadId))
+    {
+      pthread_detach(sendThreadId); // Stopped from a curl callback : the thread ends when back in _sendHttpMessage (no longer started)
+    }
+    else
+    {
+      pthread_join(sendThreadId, NULL);
+    }
+  }
+
+  pthread_mutex_lock(&mutexHttpSendThreadControl);
+
+  _httpSendThreadStarted = false;
+  _httpSendThreadStop = false;
 
   _CloseHttpSession(IMMEDIATE_CLOSE);
 
+  // Close the connections kept between the sessions
+  if(NULL != _sessionShare) {
+    curl_share_cleanup(_sessionShare);
+    _sessionShare = NULL;
+  }
+
   // Free allocated memory
   DM_ENG_FREE(_acsURLPtr);
   DM_ENG_FREE(_sslDeviceCertificatStr);
@@ -266,14 +387,8 @@ int DM_StopHttpClient(void)
 */
 int DM_SendHttpMessage(IN const char * msgToSendStr)
 {
-  pthread_attr_t   httpSendthread_Attribute;  
-#ifndef WIN32
-  pthread_t        httpSendthread_ID        = 0;
-#else
-  pthread_t        httpSendthread_ID;
-#endif
-   DMRET            nRet                     = DM_ERR;
-   int              msgSize                  = 0;
+   DMRET                   nRet      = DM_ERR;
+   httpMessageBufferType * msgBuffer = NULL;
 
    DBG("DM_SendHttpMessage - Begin");
 
@@ -283,16 +398,54 @@ int DM_SendHttpMessage(IN const char * msgToSendStr)
       EXEC_ERROR( ERROR_INVALID_PARAMETERS );
    }
    else
+   {
+      // The message is copied once, into the buffer shared with the retry buffer
+      msgBuffer = DM_CreateHttpMessageBuffer(strdup(msgToSendStr));
+      nRet = DM_SendHttpMessageBuffer(msgBuffer);
+      DM_ReleaseHttpMessageBuffer(msgBuffer);
+   }
+
+   DBG("DM_SendHttpMessage - End");
+
+   return( nRet );
+
+} // DM_SendHttpMessage
+
+
+/*
+* @brief Function used to send an HTTP Message held by a shared buffer
+*
+* @param IN: ptr on the message buffer
+*
+* @return 0 on success (-1 otherwise)
+*
+*/
+int DM_SendHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr)
+{
+   DMRET            nRet                     = DM_ERR;
+
+   DBG("DM_SendHttpMessageBuffer - Begin");
+
+   // Check parameter
+   if ( msgBufferPtr == NULL ) // Null pointer parameter
+   {
+      EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+   }
+   else
    {
       pthread_mutex_lock(&mutexHttpSendThreadControl);
 
-      if (_closeHttpSessionExpected)
+      if (!_waitHttpPendingRoom())
+      {
+         EXEC_ERROR("Too many HTTP Messages pending, message dropped");
+      }
+      else if (_closeHttpSessionExpected)
       {
          WARN("Already a session in progress, retry later"); // We must not have 2 sessions for a single TCP connection
       }
-      else if (_httpMessageBeingSent != NULL)
+      else if ((_httpMessageBeingSent != NULL) || (_httpStreamBeingSent != NULL))
       {
-         _addPendingHttpMessage(msgToSendStr);
+         _addPendingHttpMessage(msgBufferPtr, NULL);
 
           // Set the return code to OK
           nRet = DM_OK;
@@ -303,50 +456,208 @@ int DM_SendHttpMessage(IN const char * msgToSendStr)
       }
       else
       {
-         _httpMessageBeingSent = strdup(msgToSendStr);
-
-         // -----------------------------------------------------------------------
-         // Set the thread's parameters
-         // -----------------------------------------------------------------------
-         pthread_attr_init( &httpSendthread_Attribute );
-         pthread_attr_setdetachstate(&httpSendthread_Attribute,PTHREAD_CREATE_DETACHED);
-         pthread_attr_setstacksize(&httpSendthread_Attribute, DM_HTTP_THREAD_STACK_SIZE );
-
-         // -----------------------------------------------------------------------
-         // Launch the thread
-         // -----------------------------------------------------------------------
-         if ( pthread_create( &httpSendthread_ID,
-                              &httpSendthread_Attribute,
-                              (void*(*)(void*))_sendHttpMessage,
-                              NULL ) != 0 )
+         _httpMessageBeingSent = DM_RetainHttpMessageBuffer(msgBufferPtr);
+
+         if ( _wakeHttpSendThread() != DM_OK )
          {
-            DM_ENG_FREE(_httpMessageBeingSent);
-            EXEC_ERROR( "Launching the '_sendHttpMessage' as a thread : NOK " );
+            DM_ReleaseHttpMessageBuffer(_httpMessageBeingSent);
+            _httpMessageBeingSent = NULL;
          }
          else
          {
-             // Update the retry buffer
-             if(NULL != msgToSendStr) msgSize = strlen(msgToSendStr);
-             DM_UpdateRetryBuffer(msgToSendStr, msgSize);
+             // Update the retry buffer (the same buffer is shared)
+             DM_UpdateRetryBuffer(msgBufferPtr);
 
-            pthread_detach(httpSendthread_ID);
             nRet = DM_OK;
          }
-
-         // -----------------------------------------------------------------------
-         // Free the pthread's attributes
-         // -----------------------------------------------------------------------
-         pthread_attr_destroy( &httpSendthread_Attribute );
       }
 
       pthread_mutex_unlock(&mutexHttpSendThreadControl);
    }
 
-   DBG("DM_SendHttpMessage - End");
+   DBG("DM_SendHttpMessageBuffer - End");
 
    return( nRet );
 
-} // DM_SendHttpMessage
+} // DM_SendHttpMessageBuffer
+
+
+/*
+* @brief Function used to create a shared message buffer, with one reference held by the caller
+*
+* @param IN: message allocated by malloc, owned by the buffer from now on
+*
+* @return The buffer (NULL if message is NULL or on allocation error)
+*
+*/
+httpMessageBufferType * DM_CreateHttpMessageBuffer(IN char * message)
+{
+   httpMessageBufferType * msgBuffer = NULL;
+
+   if ( message != NULL )
+   {
+      msgBuffer = (httpMessageBufferType*) malloc(sizeof(httpMessageBufferType));
+      if ( msgBuffer == NULL )
+      {
+         EXEC_ERROR("Can not allocate the HTTP message buffer");
+         free(message);
+      }
+      else
+      {
+         msgBuffer->data     = message;
+         msgBuffer->length   = strlen(message);
+         msgBuffer->refCount = 1;
+      }
+   }
+
+   return( msgBuffer );
+
+} // DM_CreateHttpMessageBuffer
+
+
+/*
+* @brief Function used to take a new reference on a shared message buffer
+*
+* @param IN: ptr on the message buffer
+*
+* @return The buffer
+*
+*/
+httpMessageBufferType * DM_RetainHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr)
+{
+   pthread_mutex_lock(&mutexHttpMessageBuffer);
+   msgBufferPtr->refCount++;
+   pthread_mutex_unlock(&mutexHttpMessageBuffer);
+
+   return( msgBufferPtr );
+
+} // DM_RetainHttpMessageBuffer
+
+
+/*
+* @brief Function used to release a reference on a shared message buffer, freed with the last one
+*
+* @param IN: ptr on the message buffer (NULL allowed)
+*
+*/
+void DM_ReleaseHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr)
+{
+   bool lastReference = false;
+
+   if ( msgBufferPtr == NULL ) return;
+
+   pthread_mutex_lock(&mutexHttpMessageBuffer);
+   lastReference = (--msgBufferPtr->refCount == 0);
+   pthread_mutex_unlock(&mutexHttpMessageBuffer);
+
+   if ( lastReference )
+   {
+      free(msgBufferPtr->data);
+      free(msgBufferPtr);
+   }
+
+} // DM_ReleaseHttpMessageBuffer
+
+
+/*
+* @brief Function used to send an HTTP Message produced while it is sent (chunked transfer encoding)
+*
+* @param IN: ptr on the message producer
+*
+* @return 0 on success (-1 otherwise)
+*
+*/
+int DM_SendHttpMessageStream(IN const httpMessageStreamType * msgStreamPtr)
+{
+   DMRET                   nRet       = DM_ERR;
+   httpMessageStreamType * httpStream = NULL;
+
+   DBG("DM_SendHttpMessageStream - Begin");
+
+   // Check parameter
+   if ( (msgStreamPtr == NULL) || (msgStreamPtr->readFunction == NULL) )
+   {
+      EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+      return( nRet );
+   }
+
+   httpStream = (httpMessageStreamType*) malloc(sizeof(httpMessageStreamType));
+   memcpy((void*)httpStream, (void*)msgStreamPtr, sizeof(httpMessageStreamType));
+
+   pthread_mutex_lock(&mutexHttpSendThreadControl);
+
+   if (!_waitHttpPendingRoom())
+   {
+      EXEC_ERROR("Too many HTTP Messages pending, message dropped");
+   }
+   else if (_closeHttpSessionExpected)
+   {
+      WARN("Already a session in progress, retry later"); // We must not have 2 sessions for a single TCP connection
+   }
+   else if ((_httpMessageBeingSent != NULL) || (_httpStreamBeingSent != NULL))
+   {
+      _addPendingHttpMessage(NULL, httpStream);
+      httpStream = NULL;
+      nRet = DM_OK;
+   }
+   else if ((_sessionHandle == NULL) && (DM_OK != _initHttpSession()))
+   {
+      EXEC_ERROR("Can not set up the HTTP Session");
+   }
+   else
+   {
+      _httpStreamBeingSent = httpStream;
+
+      if ( _wakeHttpSendThread() != DM_OK )
+      {
+         _httpStreamBeingSent = NULL;
+      }
+      else
+      {
+         httpStream = NULL;
+
+         // A streamed message can not be kept for a RetryRequest : the previous one is forgotten
+         DM_UpdateRetryBuffer(NULL);
+
+         nRet = DM_OK;
+      }
+   }
+
+   pthread_mutex_unlock(&mutexHttpSendThreadControl);
+
+   // Message not taken into account
+   if (httpStream != NULL) _releaseHttpStream(httpStream);
+
+   DBG("DM_SendHttpMessageStream - End");
+
+   return( nRet );
+
+} // DM_SendHttpMessageStream
+
+
+/*
+* @brief Function used to set the number of SOAP envelopes the ACS accepts in one HTTP POST
+*
+* @param IN: the maximum number of envelopes (MaxEnvelopes of the InformResponse)
+*
+* @return 0 on success (-1 otherwise)
+*
+*/
+int DM_SetHttpMaxEnvelopes(IN int maxEnvelopes)
+{
+   if ( maxEnvelopes < 1 )
+   {
+      EXEC_ERROR( ERROR_INVALID_PARAMETERS );
+      return DM_ERR;
+   }
+
+   pthread_mutex_lock(&mutexHttpSendThreadControl);
+   _acsMaxEnvelopes = maxEnvelopes;
+   pthread_mutex_unlock(&mutexHttpSendThreadControl);
+
+   return DM_OK;
+
+} // DM_SetHttpMaxEnvelopes
 
 
 /*
@@ -465,6 +776,34 @@ int DM_FtpPutFile(httpPutFileDataType * httpPutFileDataPtr)
 
 }
 
+/*
+* @brief Function used to push data using HTTP POST (bulk data collection).
+*
+* @param IN: char * destURLStr
+*        IN: char * usernameStr
+*        IN: char * passwordStr
+*        IN: char * contentTypeStr
+*        IN: char * dataPtr
+*        IN: size_t dataSize
+*
+* @return 0 on success, the HTTP response code if not 2xx, -1 on transport error
+*
+*/
+int DM_HttpPostData(httpPostDataType * httpPostDataPtr)
+{
+
+  // Check mandatory parameters
+  if((NULL == httpPostDataPtr) ||
+     (NULL == httpPostDataPtr->destURLStr) ||
+     (NULL == httpPostDataPtr->dataPtr)) {
+     EXEC_ERROR("Invalid Parameter");
+     return DM_ENG_INVALID_ARGUMENTS;
+  }
+
+  return (_curlPostHttpData(httpPostDataPtr));
+
+}
+
 
 
 // -----------------------------------------------------------------
@@ -475,12 +814,13 @@ int DM_FtpPutFile(httpPutFileDataType * httpPutFileDataPtr)
 // -------------------------------------------------------------
 // Management of the list of the HTPP messages pending
 // -------------------------------------------------------------
-static void _addPendingHttpMessage(const char* httpMsg)
+static void _addPendingHttpMessage(httpMessageBufferType* httpMsg, httpMessageStreamType* httpStream)
 {
-   if (httpMsg == NULL) return;
+   if ((httpMsg == NULL) && (httpStream == NULL)) return;
 
    PendingHttpMessage* newMsg = (PendingHttpMessage*) malloc(sizeof(PendingHttpMessage));
-   newMsg->message = strdup(httpMsg);
+   newMsg->message = (httpMsg == NULL ? NULL : DM_RetainHttpMessageBuffer(httpMsg));
+   newMsg->stream = httpStream;
    newMsg->next = NULL;
    if (_pendingHttpMessages == NULL)
    {
@@ -492,19 +832,115 @@ static void _addPendingHttpMessage(const char* httpMsg)
       while (curMsg->next != NULL) { curMsg = curMsg->next; }
       curMsg->next = newMsg;
    }
+   _nbPendingHttpMessages++;
 }
 
-static char* _getFirstPendingHttpMessage()
+// Makes the first pending message the message being sent (none if the list is empty)
+static void _popPendingHttpMessage()
 {
-   char* msgRet = NULL;
+   _httpMessageBeingSent = NULL;
+   _httpStreamBeingSent = NULL;
    if (_pendingHttpMessages != NULL)
    {
       PendingHttpMessage* first = _pendingHttpMessages;
-      msgRet = first->message;
+      _httpMessageBeingSent = first->message;
+      _httpStreamBeingSent = first->stream;
       _pendingHttpMessages = first->next;
       free(first);
+      _nbPendingHttpMessages--;
+      pthread_cond_broadcast(&condHttpPendingRoom);
+   }
+   if ((_httpMessageBeingSent != NULL) && (_acsMaxEnvelopes > 1))
+   {
+      _httpMessageBeingSent = _gatherPendingHttpMessages(_httpMessageBeingSent);
    }
-   return msgRet;
+}
+
+/*
+* @brief Function used to skip the XML declaration at the beginning of a message
+*
+* @param IN: the message
+*
+* @return The beginning of the SOAP envelope
+*
+*/
+static const char* _skipXmlDeclaration(const char* httpMsg)
+{
+   const char* declEnd = NULL;
+
+   if (0 == strncmp(httpMsg, "<?xml", sizeof("<?xml") - 1))
+   {
+      declEnd = strstr(httpMsg, "?>");
+      if (declEnd != NULL)
+      {
+         httpMsg = declEnd + sizeof("?>") - 1;
+         while ((*httpMsg != '\0') && isspace((unsigned char)*httpMsg)) { httpMsg++; }
+      }
+   }
+
+   return httpMsg;
+}
+
+/*
+* @brief Function used to gather the next pending messages with the message to send, so that the
+*        SOAP envelopes produced while one ACS response is read (several RPCs received in the same
+*        HTTP response) go back in one HTTP POST. Neither the empty message nor the streamed
+*        messages are gathered. The XML declaration is kept for the first envelope only.
+*
+* @param IN: the message to send
+*
+* @return The message to send, gathering up to _acsMaxEnvelopes envelopes
+*
+*/
+static httpMessageBufferType* _gatherPendingHttpMessages(httpMessageBufferType* httpMsg)
+{
+   PendingHttpMessage*    next        = _pendingHttpMessages;
+   httpMessageBufferType* gatheredMsg = NULL;
+   char*                  data        = NULL;
+   const char*            envelope    = NULL;
+   size_t                 length      = httpMsg->length;
+   size_t                 envelopeLength;
+   int                    nbEnvelopes = 1;
+
+   if (httpMsg->length == 0) return httpMsg;
+
+   while ((nbEnvelopes < _acsMaxEnvelopes) && (next != NULL) && (next->message != NULL) && (next->message->length != 0))
+   {
+      length += next->message->length;
+      nbEnvelopes++;
+      next = next->next;
+   }
+   if (nbEnvelopes == 1) return httpMsg;
+
+   data = (char*) malloc(length + 1);
+   if (data == NULL)
+   {
+      EXEC_ERROR("Can not gather the HTTP messages, sent one by one");
+      return httpMsg;
+   }
+   memcpy(data, httpMsg->data, httpMsg->length);
+   length = httpMsg->length;
+   DM_ReleaseHttpMessageBuffer(httpMsg);
+
+   DBG("%d SOAP envelopes gathered in the HTTP Message", nbEnvelopes);
+   while (--nbEnvelopes > 0)
+   {
+      next = _pendingHttpMessages;
+      envelope = _skipXmlDeclaration(next->message->data);
+      envelopeLength = next->message->length - (envelope - next->message->data);
+      memcpy(data + length, envelope, envelopeLength);
+      length += envelopeLength;
+      _pendingHttpMessages = next->next;
+      DM_ReleaseHttpMessageBuffer(next->message);
+      free(next);
+      _nbPendingHttpMessages--;
+   }
+   data[length] = '\0';
+   pthread_cond_broadcast(&condHttpPendingRoom);
+
+   gatheredMsg = DM_CreateHttpMessageBuffer(data);
+
+   return gatheredMsg;
 }
 
 static void _freePendingHttpMessages()
@@ -513,9 +949,89 @@ static void _freePendingHttpMessages()
    {
       PendingHttpMessage* first = _pendingHttpMessages;
       _pendingHttpMessages = first->next;
-      free(first->message);
+      DM_ReleaseHttpMessageBuffer(first->message);
+      if (first->stream != NULL) _releaseHttpStream(first->stream);
       free(first);
    }
+   _nbPendingHttpMessages = 0;
+   pthread_cond_broadcast(&condHttpPendingRoom);
+}
+
+static void _releaseHttpStream(httpMessageStreamType* httpStream)
+{
+   if (httpStream->releaseFunction != NULL) httpStream->releaseFunction(httpStream->producerData);
+   free(httpStream);
+}
+
+// Wakes the thread which sends the message being sent, then the pending ones (started the first time)
+static int _wakeHttpSendThread()
+{
+  pthread_attr_t   httpSendthread_Attribute;
+   int              nRet                     = DM_ERR;
+
+   if ( _httpSendThreadStarted )
+   {
+      pthread_cond_signal(&condHttpMessageToSend);
+      return DM_OK;
+   }
+
+   // -----------------------------------------------------------------------
+   // Set the thread's parameters
+   // -----------------------------------------------------------------------
+   pthread_attr_init( &httpSendthread_Attribute );
+   pthread_attr_setstacksize(&httpSendthread_Attribute, DM_HTTP_THREAD_STACK_SIZE );
+
+   // -----------------------------------------------------------------------
+   // Launch the thread (joined by DM_StopHttpClient)
+   // -----------------------------------------------------------------------
+   if ( pthread_create( &_httpSendThreadId,
+                        &httpSendthread_Attribute,
+                        (void*(*)(void*))_sendHttpMessage,
+                        NULL ) != 0 )
+   {
+      EXEC_ERROR( "Launching the '_sendHttpMessage' as a thread : NOK " );
+   }
+   else
+   {
+      _httpSendThreadStarted = true;
+      nRet = DM_OK;
+   }
+
+   // -----------------------------------------------------------------------
+   // Free the pthread's attributes
+   // -----------------------------------------------------------------------
+   pthread_attr_destroy( &httpSendthread_Attribute );
+
+   return nRet;
+}
+
+/*
+* @brief Function used to wait, mutexHttpSendThreadControl locked, until a message can be added to the
+*        pending ones. The sender thread itself (responses to the RPCs read by the curl callbacks) never
+*        waits : it is the one which empties the list.
+*
+* @return false if the list is still full after CURL_TIMEOUT seconds
+*
+*/
+static bool _waitHttpPendingRoom()
+{
+   struct timespec deadline;
+
+   if ( _nbPendingHttpMessages < DM_HTTP_MAX_PENDING_MESSAGES ) return true;
+   if ( _httpSendThreadStarted && pthread_equal(pthread_self(), _httpSendThreadId) ) return true;
+
+   WARN("%d HTTP Messages pending, waiting for them to be sent", _nbPendingHttpMessages);
+   clock_gettime(CLOCK_REALTIME, &deadline);
+   deadline.tv_sec += CURL_TIMEOUT;
+   while ( _nbPendingHttpMessages >= DM_HTTP_MAX_PENDING_MESSAGES )
+   {
+      if ( pthread_cond_timedwait(&condHttpPendingRoom, &mutexHttpSendThreadControl, &deadline) == ETIMEDOUT )
+      {
+         return (_nbPendingHttpMessages < DM_HTTP_MAX_PENDING_MESSAGES);
+      }
+   }
+
+   return true;
 }
 
 
@@ -569,6 +1085,11 @@ static int _initHttpSession()
      EXEC_ERROR("Can not set CURLOPT_NOSIGNAL curl option");
    }
    
+   // Reuse the connection, the TLS session and the ACS address of the previous sessions
+   if((NULL == _getHttpSessionShare()) || (CURLE_OK != curl_easy_setopt( _sessionHandle, CURLOPT_SHARE, _sessionShare))) {
+     EXEC_ERROR("Can not set CURLOPT_SHARE curl option");
+   }
+   
    if(CURLE_OK != curl_easy_setopt( _sessionHandle, CURLOPT_TIMEOUT, CURL_TIMEOUT)) {
      EXEC_ERROR("Can not set CURLOPT_TIMEOUT curl option");
    }
@@ -577,6 +1098,12 @@ static int _initHttpSession()
      EXEC_ERROR("Can not set CURLOPT_CONNECTTIMEOUT curl option");
    }
    
+   // Lets DM_StopHttpClient abort the message in progress
+   if((CURLE_OK != curl_easy_setopt( _sessionHandle, CURLOPT_XFERINFOFUNCTION, _curlProgressHttpSession))
+      || (CURLE_OK != curl_easy_setopt( _sessionHandle, CURLOPT_NOPROGRESS, 0L))) {
+     EXEC_ERROR("Can not set CURLOPT_XFERINFOFUNCTION curl option");
+   }
+   
    if(CURLE_OK != curl_easy_setopt( _sessionHandle, CURLOPT_URL, _acsURLPtr)) {
      EXEC_ERROR("Can not set CURLOPT_URL curl option"); 
    }
@@ -607,6 +1134,13 @@ static int _initHttpSession()
   curl_easy_setopt( _sessionHandle, CURLOPT_WRITEDATA,     /* g_DmComData */ NULL );
   curl_easy_setopt( _sessionHandle, CURLOPT_WRITEFUNCTION, _curlCallbackClientData );
 
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+  // Accept the compressed responses (Accept-Encoding with all the encodings supported by libcurl, which decodes them)
+  if(CURLE_OK != curl_easy_setopt( _sessionHandle, CURLOPT_ACCEPT_ENCODING, "")) {
+    EXEC_ERROR("Can not set CURLOPT_ACCEPT_ENCODING curl option");
+  }
+#endif
+
    /* SECURITY MANAGEMENT */
    // Check if the Cetificat Authority is provided to identify the ACS platform
   if(NULL != _sslAcsCertificationAuthority) {
@@ -818,7 +1352,9 @@ static int _curlGetHttpFile(httpGetFileDataType * httpGetDataPtr)
        WARN("Download ERROR - Can not download the file. Curl error code = %d", rc);
        if (rc == CURLE_LOGIN_DENIED) { rc = HTTP_UNAUTHORIZED; }
      } else {
-       curl_easy_getinfo(session, CURLINFO_RESPONSE_CODE, &rc);
+       long curlRespCode = 0; // libcurl writes a long
+       curl_easy_getinfo(session, CURLINFO_RESPONSE_CODE, &curlRespCode);
+       rc = (int)curlRespCode;
        DBG("Download completed  - curlResponseCode = %d", rc);
        if(HTTP_OK != rc) {
          WARN("Download Error");
@@ -1213,6 +1749,131 @@ static int _curlPutFtpFile(httpPutFileDataType * httpPutDataPtr)
   
 }
 
+// Private routine used by _curlPostHttpData : the collector response body is ignored
+static size_t _discardResponseCallback(void *ptr UNUSED, size_t size, size_t nmemb, void *stream UNUSED)
+{
+  return size * nmemb;
+}
+
+/**
+ * @brief Function to post a data buffer using libcurl
+ *
+ * @param httpPostDataPtr  Data to post and collector identification
+ *
+ * @Return 0 on success, the HTTP response code if not 2xx, -1 on transport error
+ *
+ */
+static int _curlPostHttpData(httpPostDataType * httpPostDataPtr)
+{
+  int                  rc = -1;
+  CURL               * curl;
+  struct curl_slist  * headers = NULL;
+  char               * contentTypeHeaderStr = NULL;
+  int                  userNamePasswordStrSize = 0;
+  char               * userNamePasswordStr = NULL;
+
+  DBG("****** _curlPostHttpData ******");
+  DBG("Destination URL: %s", httpPostDataPtr->destURLStr);
+  DBG("Content-Type:    %s", ((NULL != httpPostDataPtr->contentTypeStr) ? httpPostDataPtr->contentTypeStr : "None"));
+  DBG("Data Size:       %d", (int) httpPostDataPtr->dataSize);
+
+  // Make sure it is a valid URL (HTTP type)
+  if((0 != _isValidUrl(httpPostDataPtr->destURLStr)) ||
+     (0 != strncasecmp(httpPostDataPtr->destURLStr, "http", sizeof("http") - 1))) {
+    WARN("Invalid HTTP URL (%s)", httpPostDataPtr->destURLStr);
+    return rc;
+  }
+
+  curl = curl_easy_init();
+  if(NULL == curl) {
+    EXEC_ERROR("Can not init curl handler");
+    return rc;
+  }
+
+  // PROXY
+  if(NULL != PROXY_ADDRESS_STR) {
+    DBG("Set Proxy Option");
+    if(CURLE_OK != curl_easy_setopt(curl, CURLOPT_PROXY, PROXY_ADDRESS_STR)) {
+      EXEC_ERROR("Can not set PROXY curl option");
+    }
+  }
+
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, CURL_NOSIGNAL);
+
+  if(CURLE_OK != curl_easy_setopt( curl, CURLOPT_TIMEOUT, CURL_POST_DATA_TIMEOUT)) {
+    EXEC_ERROR("Can not set CURLOPT_TIMEOUT curl option");
+  }
+
+  if(CURLE_OK != curl_easy_setopt( curl, CURLOPT_CONNECTTIMEOUT, CURL_CONNECT_TIMEOUT)) {
+    EXEC_ERROR("Can not set CURLOPT_CONNECTTIMEOUT curl option");
+  }
+
+  curl_easy_setopt(curl, CURLOPT_URL, httpPostDataPtr->destURLStr);
+
+  // The report buffer is posted as is, without any copy by libcurl
+  curl_easy_setopt(curl, CURLOPT_POST, 1L);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, httpPostDataPtr->dataPtr);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) httpPostDataPtr->dataSize);
+
+  if(NULL != httpPostDataPtr->contentTypeStr) {
+    contentTypeHeaderStr = (char *) malloc(strlen("Content-Type: ") + strlen(httpPostDataPtr->contentTypeStr) + 1);
+    strcpy(contentTypeHeaderStr, "Content-Type: ");
+    strcat(contentTypeHeaderStr, httpPostDataPtr->contentTypeStr);
+    headers = curl_slist_append(headers, contentTypeHeaderStr);
+  }
+  // No "Expect: 100-continue" round trip for the report
+  headers = curl_slist_append(headers, "Expect:");
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _discardResponseCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, NULL);
+
+  // Usage of username and password (Check only the username. The password could be NULL)
+  if(NULL != httpPostDataPtr->usernameStr) {
+    userNamePasswordStrSize = strlen(httpPostDataPtr->usernameStr) + 2;
+    // Add the password string size if exist.
+    if(NULL != httpPostDataPtr->passwordStr) {
+      userNamePasswordStrSize += strlen(httpPostDataPtr->passwordStr);
+    }
+    userNamePasswordStr = (char *) malloc(userNamePasswordStrSize);
+    memset((void *) userNamePasswordStr, '\0', userNamePasswordStrSize);
+    // Build the username:password string required by curl
+    strcpy(userNamePasswordStr, httpPostDataPtr->usernameStr);
+    strcat(userNamePasswordStr, ":");
+    if(NULL != httpPostDataPtr->passwordStr) {
+      strcat(userNamePasswordStr, httpPostDataPtr->passwordStr);
+    }
+    if(CURLE_OK != curl_easy_setopt(curl, CURLOPT_USERPWD, userNamePasswordStr)) {
+      EXEC_ERROR("Can not set USERPWD curl option");
+    }
+    if(CURLE_OK != curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_ANY)) {
+      EXEC_ERROR("Can not set CURLAUTH_ANY curl option");
+    }
+  } else {
+    DBG("POST - No username or password");
+  }
+
+  rc = curl_easy_perform(curl);
+  if(CURLE_OK != rc) {
+    WARN("POST ERROR - Can not post the data. Curl error code = %d", rc);
+    rc = -1;
+  } else {
+    long curlRespCode = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &curlRespCode);
+    DBG("CURLINFO_RESPONSE_CODE = %d", (int) curlRespCode);
+    rc = (((curlRespCode >= 200) && (curlRespCode < 300)) ? 0 : (int) curlRespCode);
+  }
+
+  /* always cleanup */
+  curl_easy_cleanup(curl);
+  curl_slist_free_all(headers);
+
+  DM_ENG_FREE(contentTypeHeaderStr);
+  DM_ENG_FREE(userNamePasswordStr);
+
+  return rc;
+}
+
 
 /**
  * @brief Call back Function called by the libcurl get the http content
@@ -1251,6 +1912,14 @@ _curlCallbackClientHeader(void   *ptr,
   // Read the response code of the HTTP message received
   // -------------------------------------------------------------------------
   _getLastHttpResponseCode(&lastHttpResponseCode);
+
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+  if(_checkGzipResponseHeader(httpMsgHeaderPtr, lastHttpResponseCode)) {
+    // Response to a rejected compressed message : not given to dm_com, the message is sent again uncompressed
+    DM_ENG_FREE(httpMsgHeaderPtr);
+    return (size * nmemb);
+  }
+#endif
   
   rc = DM_HttpCallbackClientHeader(httpMsgHeaderPtr, (size * nmemb), lastHttpResponseCode);
 
@@ -1287,6 +1956,13 @@ _curlCallbackClientData(void   *ptr,
   if(NULL == stream) {
      // Not an error. Unused parameter. Test added to remove compil warning
    }
+
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+   if(_gzipRefused) {
+     // Response to a rejected compressed message : ignored
+     return (size * nmemb);
+   }
+#endif
    
    httpMsgDataPtr = (char *) malloc((size * nmemb) + 1);
    memcpy((void *) httpMsgDataPtr, (void *) ptr, size * nmemb);
@@ -1310,14 +1986,15 @@ _curlCallbackClientData(void   *ptr,
 *
 */
 static int _getLastHttpResponseCode(OUT int * respCodePtr) {
+  long respCode = 0; // libcurl writes a long
   
-  *respCodePtr = 0;
-  curl_easy_getinfo( _sessionHandle, CURLINFO_RESPONSE_CODE, respCodePtr );
+  curl_easy_getinfo( _sessionHandle, CURLINFO_RESPONSE_CODE, &respCode );
          
-  if ( *respCodePtr == 0 ) {
+  if ( respCode == 0 ) {
     // Try with CURLINFO_HTTP_CONNECTCODE
-     curl_easy_getinfo( _sessionHandle, CURLINFO_HTTP_CONNECTCODE, respCodePtr );
+     curl_easy_getinfo( _sessionHandle, CURLINFO_HTTP_CONNECTCODE, &respCode );
   }
+  *respCodePtr = (int)respCode;
   
   return DM_OK;
 
@@ -1350,43 +2027,134 @@ static void _curlHandleCleanUp()
 
 }
 
+/*
+* @brief Function used to get the data shared by the successive session handles (created the first time)
+*
+* @return The share object, NULL if it can not be created (then each session starts from scratch)
+*
+*/
+static CURLSH* _getHttpSessionShare()
+{
+  if(NULL != _sessionShare) return _sessionShare;
+
+  if(!_httpSessionShareMutexInit) {
+    int i;
+    for(i = 0; i < CURL_LOCK_DATA_LAST; i++) pthread_mutex_init(&mutexHttpSessionShare[i], NULL);
+    _httpSessionShareMutexInit = true;
+  }
+
+  _sessionShare = curl_share_init();
+  if(NULL == _sessionShare) {
+    EXEC_ERROR("Can not create the CURL share object");
+    return NULL;
+  }
+
+  curl_share_setopt(_sessionShare, CURLSHOPT_LOCKFUNC,   _curlLockHttpSessionShare);
+  curl_share_setopt(_sessionShare, CURLSHOPT_UNLOCKFUNC, _curlUnlockHttpSessionShare);
+  curl_share_setopt(_sessionShare, CURLSHOPT_SHARE,      CURL_LOCK_DATA_SSL_SESSION);
+  curl_share_setopt(_sessionShare, CURLSHOPT_SHARE,      CURL_LOCK_DATA_DNS);
+#if LIBCURL_VERSION_NUM >= 0x073900
+  // Connection cache shared since libcurl 7.57.0 : before, only the TLS session is resumed
+  curl_share_setopt(_sessionShare, CURLSHOPT_SHARE,      CURL_LOCK_DATA_CONNECT);
+#endif
+
+  return _sessionShare;
+}
+
+/**
+ * @brief Call back Functions called by the libcurl around the accesses to the shared data
+ *        (the session handle is used by the sender thread, cleaned up by the others)
+ *
+ */
+static void
+_curlLockHttpSessionShare(CURL *handle UNUSED, curl_lock_data data, curl_lock_access access UNUSED, void *userptr UNUSED)
+{
+  pthread_mutex_lock(&mutexHttpSessionShare[data]);
+}
+
+static void
+_curlUnlockHttpSessionShare(CURL *handle UNUSED, curl_lock_data data, void *userptr UNUSED)
+{
+  pthread_mutex_unlock(&mutexHttpSessionShare[data]);
+}
+
 static void * _sendHttpMessage()
 {
    pthread_mutex_lock(&mutexHttpSendThreadControl);
 
-  while (NULL != _httpMessageBeingSent)
+  // A thread stopped from one of its curl callbacks ends here, even if a new sender thread has been started since
+  while (!_httpSendThreadStop && _httpSendThreadStarted && pthread_equal(pthread_self(), _httpSendThreadId))
   {
-    // ---------------------------------------------------------------------------
-    // Set the limit of the message to send
-    // ---------------------------------------------------------------------------
-    #ifdef X86
-    curl_easy_setopt(_sessionHandle, CURLOPT_POSTFIELDSIZE_LARGE, strlen(_httpMessageBeingSent) );
-    #else
-    curl_easy_setopt(_sessionHandle, CURLOPT_POSTFIELDSIZE, strlen(_httpMessageBeingSent) );
-    #endif
-    
+    if ((NULL == _httpMessageBeingSent) && (NULL == _httpStreamBeingSent))
+    {
+      // Nothing to send : wait for the next message
+      pthread_cond_wait(&condHttpMessageToSend, &mutexHttpSendThreadControl);
+      continue;
+    }
+
     // Set the relevant Content-type (No Content-type for 0 size data message)
     if(NULL != _slist) {
       // Free the list
       curl_slist_free_all(_slist); /* free the list - List used to define the HTTP Content Type */
       _slist=NULL;
-    } 
-    if(0 == strlen(_httpMessageBeingSent)) {
-      DBG("Set empty HTTP Content-type");
-      _slist = curl_slist_append(_slist, HttpEmptyContentType);
-    } else {
-      DBG("Set XML HTTP Content-type");
-      _slist = curl_slist_append(_slist, HttpXmlContentType); 
     }
-    curl_easy_setopt(_sessionHandle, CURLOPT_HTTPHEADER, _slist); 
-    
 
-    // ---------------------------------------------------------------------------
-    // Fill the data to send
-    // ---------------------------------------------------------------------------
-    curl_easy_setopt( _sessionHandle, CURLOPT_POSTFIELDS, _httpMessageBeingSent );
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+    if(_startGzipHttpMessage(_httpMessageBeingSent, _httpStreamBeingSent)) {
+      // ---------------------------------------------------------------------------
+      // Compressed message : unknown size, the data are compressed by _curlReadGzipHttpMessage
+      // ---------------------------------------------------------------------------
+      INFO("HTTP Message to send: gzip encoded");
+    } else
+#endif
+    if(NULL != _httpStreamBeingSent) {
+      // ---------------------------------------------------------------------------
+      // Streamed message : unknown size, the data are read by _curlReadHttpStream
+      // ---------------------------------------------------------------------------
+      curl_easy_setopt( _sessionHandle, CURLOPT_POSTFIELDS, NULL );
+      #ifdef X86
+      curl_easy_setopt(_sessionHandle, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)-1 );
+      #else
+      curl_easy_setopt(_sessionHandle, CURLOPT_POSTFIELDSIZE, -1L );
+      #endif
+      curl_easy_setopt( _sessionHandle, CURLOPT_READFUNCTION, _curlReadHttpStream );
+      curl_easy_setopt( _sessionHandle, CURLOPT_READDATA,     _httpStreamBeingSent );
+      curl_easy_setopt( _sessionHandle, CURLOPT_SEEKFUNCTION, _curlSeekHttpStream );
+      curl_easy_setopt( _sessionHandle, CURLOPT_SEEKDATA,     _httpStreamBeingSent );
+
+      DBG("Set XML HTTP Content-type, chunked");
+      _slist = curl_slist_append(_slist, HttpXmlContentType);
+      _slist = curl_slist_append(_slist, HttpChunkedEncoding);
+      curl_easy_setopt(_sessionHandle, CURLOPT_HTTPHEADER, _slist);
+
+      INFO("HTTP Message to send: streamed");
+    } else {
+      // ---------------------------------------------------------------------------
+      // Set the limit of the message to send
+      // ---------------------------------------------------------------------------
+      #ifdef X86
+      curl_easy_setopt(_sessionHandle, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)_httpMessageBeingSent->length );
+      #else
+      curl_easy_setopt(_sessionHandle, CURLOPT_POSTFIELDSIZE, (long)_httpMessageBeingSent->length );
+      #endif
+
+      if(0 == _httpMessageBeingSent->length) {
+        DBG("Set empty HTTP Content-type");
+        _slist = curl_slist_append(_slist, HttpEmptyContentType);
+      } else {
+        DBG("Set XML HTTP Content-type");
+        _slist = curl_slist_append(_slist, HttpXmlContentType);
+      }
+      curl_easy_setopt(_sessionHandle, CURLOPT_HTTPHEADER, _slist);
+
+
+      // ---------------------------------------------------------------------------
+      // Fill the data to send
+      // ---------------------------------------------------------------------------
+      curl_easy_setopt( _sessionHandle, CURLOPT_POSTFIELDS, _httpMessageBeingSent->data );
 
-    INFO("HTTP Message to send:\n%s", _httpMessageBeingSent);
+      INFO("HTTP Message to send:\n%s", _httpMessageBeingSent->data);
+    }
 
     pthread_mutex_unlock(&mutexHttpSendThreadControl);
 
@@ -1398,23 +2166,365 @@ static void * _sendHttpMessage()
 
     pthread_mutex_lock(&mutexHttpSendThreadControl);
 
-    // Free and set to NULL the _httpMessageBeingSent
-    DM_ENG_FREE(_httpMessageBeingSent);
-    _httpMessageBeingSent = _getFirstPendingHttpMessage();
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+    if(_endGzipHttpMessage()) {
+      // Compressed message rejected by the ACS : the same message is sent again uncompressed
+      continue;
+    }
+#endif
 
-  }  // end if(NULL != _httpMessageBeingSent)
+    // Free the message sent and take the next one
+    DM_ReleaseHttpMessageBuffer(_httpMessageBeingSent);
+    if(NULL != _httpStreamBeingSent) _releaseHttpStream(_httpStreamBeingSent);
+    _popPendingHttpMessage();
 
-  if(_closeHttpSessionExpected)
-  {
-     _CloseHttpSession(NORMAL_CLOSE);
-  }
+    if((NULL == _httpMessageBeingSent) && (NULL == _httpStreamBeingSent) && _closeHttpSessionExpected)
+    {
+       _CloseHttpSession(NORMAL_CLOSE);
+    }
+
+  }  // end while
 
   pthread_mutex_unlock(&mutexHttpSendThreadControl);
 
-   // Quit the current thread
+   // Quit the current thread (DM_StopHttpClient)
    pthread_exit(DM_OK);
 }
 
+/**
+ * @brief Call back Function called by the libcurl about once per second during a message exchange
+ *
+ * @return Non zero to abort the exchange : the sender thread is stopped
+ *
+ */
+static int
+_curlProgressHttpSession(void *clientp UNUSED, curl_off_t dltotal UNUSED, curl_off_t dlnow UNUSED, curl_off_t ultotal UNUSED, curl_off_t ulnow UNUSED)
+{
+  return (_httpSendThreadStop ? 1 : 0);
+}
+
+/**
+ * @brief Call back Function called by the libcurl to get the next bytes of a streamed message
+ *
+ * @param ptr     Buffer to fill
+ * @param size
+ * @param nmemb
+ * @param stream  The httpMessageStreamType being sent
+ *
+ * @return Number of bytes written in ptr (0 at the end of the message)
+ *
+ */
+static size_t
+_curlReadHttpStream(void   *ptr,
+                    size_t  size,
+                    size_t  nmemb,
+                    void   *stream)
+{
+  httpMessageStreamType * httpStream = (httpMessageStreamType *) stream;
+  int                     nbBytes    = httpStream->readFunction(httpStream->producerData, (char *) ptr, size * nmemb);
+
+  if(nbBytes < 0) {
+    EXEC_ERROR("Can not produce the HTTP message");
+    return CURL_READFUNC_ABORT;
+  }
+
+  return (size_t) nbBytes;
+}
+
+/**
+ * @brief Call back Function called by the libcurl when a streamed message must be sent again
+ *        (HTTP authentication). Only the rewind to the beginning is possible.
+ *
+ * @param stream  The httpMessageStreamType being sent
+ * @param offset
+ * @param origin
+ *
+ * @return CURL_SEEKFUNC_OK on success
+ *
+ */
+static int
+_curlSeekHttpStream(void       *stream,
+                    curl_off_t  offset,
+                    int         origin)
+{
+  httpMessageStreamType * httpStream = (httpMessageStreamType *) stream;
+
+  if((offset != 0) || (origin != SEEK_SET) || (httpStream->rewindFunction == NULL)) {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+
+  return (0 == httpStream->rewindFunction(httpStream->producerData) ? CURL_SEEKFUNC_OK : CURL_SEEKFUNC_FAIL);
+}
+
+#ifdef GZIP_ENABLED_ON_TR069_AGENT
+/*
+* @brief Function used to set the input of the compression at the beginning of the message
+*
+* @param IN: the compressed message
+*
+*/
+static void _resetGzipInput(GzipHttpMessage * gzipMsg)
+{
+   if(NULL != gzipMsg->message)
+   {
+      // The whole message is given at once to zlib, without copy
+      gzipMsg->zStream.next_in  = (Bytef *) gzipMsg->message->data;
+      gzipMsg->zStream.avail_in = (uInt) gzipMsg->message->length;
+      gzipMsg->inputEnd         = true;
+   }
+   else
+   {
+      gzipMsg->zStream.next_in  = NULL;
+      gzipMsg->zStream.avail_in = 0;
+      gzipMsg->inputEnd         = false;
+   }
+   gzipMsg->outputEnd = false;
+
+} // _resetGzipInput
+
+/*
+* @brief Function used to set the curl options for a message compressed while it is sent (chunked, gzip encoded).
+*        The message is compressed only if the ACS supports it and if it is big enough.
+*
+* @param IN: the message or the streamed message to send
+*
+* @return true if the message is sent compressed
+*
+*/
+static bool _startGzipHttpMessage(httpMessageBufferType * httpMsg,
+                                  httpMessageStreamType * httpStream)
+{
+   GzipHttpMessage * gzipMsg = &_gzipHttpMessage;
+
+   _gzipMessageSent = false;
+   _gzipRefused     = false;
+
+   if((GZIP_ACS_SUPPORTED != _gzipAcsSupport) || ((NULL != httpMsg) && (httpMsg->length < GZIP_MIN_MESSAGE_SIZE)))
+   {
+      return false;
+   }
+
+   memset(&gzipMsg->zStream, 0, sizeof(z_stream));
+   if(Z_OK != deflateInit2(&gzipMsg->zStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GZIP_WINDOW_BITS, GZIP_MEM_LEVEL, Z_DEFAULT_STRATEGY))
+   {
+      EXEC_ERROR("Can not initialize the gzip compression, message sent uncompressed");
+      return false;
+   }
+   gzipMsg->message = httpMsg;
+   gzipMsg->stream  = httpStream;
+   _resetGzipInput(gzipMsg);
+
+   curl_easy_setopt( _sessionHandle, CURLOPT_POSTFIELDS, NULL );
+   #ifdef X86
+   curl_easy_setopt(_sessionHandle, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)-1 );
+   #else
+   curl_easy_setopt(_sessionHandle, CURLOPT_POSTFIELDSIZE, -1L );
+   #endif
+   curl_easy_setopt( _sessionHandle, CURLOPT_READFUNCTION, _curlReadGzipHttpMessage );
+   curl_easy_setopt( _sessionHandle, CURLOPT_READDATA,     gzipMsg );
+   curl_easy_setopt( _sessionHandle, CURLOPT_SEEKFUNCTION, _curlSeekGzipHttpMessage );
+   curl_easy_setopt( _sessionHandle, CURLOPT_SEEKDATA,     gzipMsg );
+
+   DBG("Set XML HTTP Content-type, chunked, gzip encoded");
+   _slist = curl_slist_append(_slist, HttpXmlContentType);
+   _slist = curl_slist_append(_slist, HttpChunkedEncoding);
+   _slist = curl_slist_append(_slist, HttpGzipEncoding);
+   curl_easy_setopt(_sessionHandle, CURLOPT_HTTPHEADER, _slist);
+
+   _gzipMessageSent = true;
+
+   return true;
+
+} // _startGzipHttpMessage
+
+/*
+* @brief Function called once a message is sent, to free the compression data.
+*        When the ACS has rejected the compressed message, the compression is no more used
+*        with its URL and the message is made ready to be sent again uncompressed.
+*
+* @return true if the message must be sent again
+*
+*/
+static bool _endGzipHttpMessage()
+{
+   GzipHttpMessage * gzipMsg = &_gzipHttpMessage;
+   bool              resend  = false;
+
+   if(!_gzipMessageSent) return false;
+
+   deflateEnd(&gzipMsg->zStream);
+   _gzipMessageSent = false;
+
+   if(_gzipRefused)
+   {
+      _gzipRefused    = false;
+      _gzipAcsSupport = GZIP_ACS_REFUSED;
+
+      if(NULL == gzipMsg->stream)
+      {
+         resend = true;
+      }
+      else if((NULL != gzipMsg->stream->rewindFunction) && (0 == gzipMsg->stream->rewindFunction(gzipMsg->stream->producerData)))
+      {
+         resend = true;
+      }
+      else
+      {
+         EXEC_ERROR("Can not send again the streamed message uncompressed");
+      }
+   }
+
+   return resend;
+
+} // _endGzipHttpMessage
+
+/*
+* @brief Function used to check whether a header line names gzip
+*
+* @param IN: the header line, the header name (with the ':')
+*
+* @return true if the header line is this header and gzip is in its value
+*
+*/
+static bool _isGzipInHeader(const char * header,
+                            const char * headerName)
+{
+   size_t       nameLength = strlen(headerName);
+   const char * value      = NULL;
+
+   if(0 != strncasecmp(header, headerName, nameLength)) return false;
+
+   for(value = header + nameLength; *value != '\0'; value++)
+   {
+      if(0 == strncasecmp(value, "gzip", sizeof("gzip") - 1)) return true;
+   }
+
+   return false;
+
+} // _isGzipInHeader
+
+/*
+* @brief Function used to learn the support of gzip by the ACS from the headers of its responses :
+*        Accept-Encoding (RFC 7694) or Content-Encoding. A 415 or 400 response to a compressed
+*        message means that the ACS does not support it.
+*
+* @param IN: the header line, the HTTP response code
+*
+* @return true if the response rejects the compressed message being sent
+*
+*/
+static bool _checkGzipResponseHeader(const char * header,
+                                     int          httpResponseCode)
+{
+   if(_gzipMessageSent && ((HTTP_UNSUPPORTED_MEDIA_TYPE == httpResponseCode) || (HTTP_BAD_REQUEST == httpResponseCode)))
+   {
+      if(!_gzipRefused)
+      {
+         WARN("Compressed HTTP Message rejected by the ACS (%d)", httpResponseCode);
+      }
+      _gzipRefused = true;
+   }
+   else if((GZIP_ACS_UNKNOWN == _gzipAcsSupport) && (_isGzipInHeader(header, "Accept-Encoding:") || _isGzipInHeader(header, "Content-Encoding:")))
+   {
+      INFO("The ACS supports the gzip Content-Encoding");
+      _gzipAcsSupport = GZIP_ACS_SUPPORTED;
+   }
+
+   return _gzipRefused;
+
+} // _checkGzipResponseHeader
+
+/**
+ * @brief Call back Function called by the libcurl to get the next compressed bytes of the message.
+ *        The streamed messages are read and compressed piece by piece.
+ *
+ * @param ptr     Buffer to fill
+ * @param size
+ * @param nmemb
+ * @param stream  The GzipHttpMessage being sent
+ *
+ * @return Number of bytes written in ptr (0 at the end of the message)
+ *
+ */
+static size_t
+_curlReadGzipHttpMessage(void   *ptr,
+                         size_t  size,
+                         size_t  nmemb,
+                         void   *stream)
+{
+  GzipHttpMessage * gzipMsg = (GzipHttpMessage *) stream;
+  z_stream        * zStream = &gzipMsg->zStream;
+  int               nbBytes;
+  int               rc;
+
+  zStream->next_out  = (Bytef *) ptr;
+  zStream->avail_out = (uInt) (size * nmemb);
+
+  // Returning less than requested is allowed, but 0 only at the end of the message
+  while((zStream->avail_out > 0) && !gzipMsg->outputEnd) {
+    if((zStream->avail_in == 0) && !gzipMsg->inputEnd) {
+      nbBytes = gzipMsg->stream->readFunction(gzipMsg->stream->producerData, gzipMsg->input, GZIP_INPUT_SIZE);
+      if(nbBytes < 0) {
+        EXEC_ERROR("Can not produce the HTTP message");
+        return CURL_READFUNC_ABORT;
+      }
+      zStream->next_in  = (Bytef *) gzipMsg->input;
+      zStream->avail_in = (uInt) nbBytes;
+      gzipMsg->inputEnd = (nbBytes == 0);
+    }
+
+    rc = deflate(zStream, (gzipMsg->inputEnd ? Z_FINISH : Z_NO_FLUSH));
+    if(Z_STREAM_END == rc) {
+      gzipMsg->outputEnd = true;
+    } else if((Z_OK != rc) && (Z_BUF_ERROR != rc)) {
+      EXEC_ERROR("Can not compress the HTTP message (%d)", rc);
+      return CURL_READFUNC_ABORT;
+    }
+  }
+
+  return (size * nmemb) - zStream->avail_out;
+}
+
+/**
+ * @brief Call back Function called by the libcurl when a compressed message must be sent again
+ *        (HTTP authentication). Only the rewind to the beginning is possible.
+ *
+ * @param stream  The GzipHttpMessage being sent
+ * @param offset
+ * @param origin
+ *
+ * @return CURL_SEEKFUNC_OK on success
+ *
+ */
+static int
+_curlSeekGzipHttpMessage(void       *stream,
+                         curl_off_t  offset,
+                         int         origin)
+{
+  GzipHttpMessage * gzipMsg = (GzipHttpMessage *) stream;
+
+  if((offset != 0) || (origin != SEEK_SET)) {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+
+  if(NULL != gzipMsg->stream) {
+    if(gzipMsg->stream->rewindFunction == NULL) {
+      return CURL_SEEKFUNC_CANTSEEK;
+    }
+    if(0 != gzipMsg->stream->rewindFunction(gzipMsg->stream->producerData)) {
+      return CURL_SEEKFUNC_FAIL;
+    }
+  }
+
+  if(Z_OK != deflateReset(&gzipMsg->zStream)) {
+    return CURL_SEEKFUNC_FAIL;
+  }
+  _resetGzipInput(gzipMsg);
+
+  return CURL_SEEKFUNC_OK;
+}
+#endif
+
 /**
  * @brief Fuction used to retrieve the FW Upgrade ERROR Code 
  *        from the Curl Error Code
@@ -1578,22 +2688,31 @@ Used to close the HTTP Session
 static void _CloseHttpSession(bool closeMode)
 {
   _closeHttpSessionExpected = false;
-  _freePendingHttpMessages();
-  if (_httpMessageBeingSent != NULL)
+  if ((_httpMessageBeingSent != NULL) || (_httpStreamBeingSent != NULL))
   {
     if(IMMEDIATE_CLOSE == closeMode)
     {
        // Immediate close. Free the HTTP Message
-       DM_ENG_FREE(_httpMessageBeingSent);
+       DM_ReleaseHttpMessageBuffer(_httpMessageBeingSent);
+       _httpMessageBeingSent = NULL;
+       if (_httpStreamBeingSent != NULL)
+       {
+          _releaseHttpStream(_httpStreamBeingSent);
+          _httpStreamBeingSent = NULL;
+       }
     }
     else
     {
+       // The pending messages (e.g. responses to the envelopes received with the last one) are sent before
        _closeHttpSessionExpected = true;
     }
   }
 
   if (!_closeHttpSessionExpected)
   {
+     _freePendingHttpMessages();
+     _acsMaxEnvelopes = 1; // Given again by the next InformResponse
+
      // Close the HTTP Session
      _curlHandleCleanUp();
   }
@@ -32,6 +32,9 @@
 // System headers
 #ifndef WIN32
 #include <netdb.h>	  /* Needs for resolution network    */
+#include <fcntl.h>
+#include <arpa/inet.h>	  /* inet_ntop                       */
+#include <sys/epoll.h>
 #endif
 
 // Enable the tracing support
@@ -51,15 +54,54 @@ extern dm_com_struct g_DmComData;
 
 
 // // Private routine declaration
-bool _sendAllMessage(int socketFd, const char * buf, int len);
-bool _sendHttpResponse(char * httpCodeStr, char * httpString, int socketFd);
+bool _buildHttpResponse(char * httpCodeStr, char * httpString, char * pHTTP_Response);
 bool _checkHttpMessageContent(IN char *pSzBuf);
 
+/**
+ * Life cycle of a connection of the http server
+ */
+typedef enum
+{
+   _HTTP_CONNECTION_FREE = 0, // The slot is not used
+   _HTTP_CONNECTION_READING,  // Waiting for the end of the request header
+   _HTTP_CONNECTION_WRITING   // Sending the response, the connection is closed once it is sent
+
+} _HttpConnectionState;
+
+/**
+ * A connection of the http server, served without blocking the other ones
+ */
+typedef struct
+{
+   _HttpConnectionState state;
+   int                  socketFd;
+   long long            deadline;                // Monotonic time (ms) after which the connection is dropped
+   int                  length;                  // Bytes received (reading) or to send (writing)
+   int                  sent;                    // Bytes already sent (writing)
+   char                 buf[SIZE_HTTP_MSG];      // The request, then the response (null terminated)
+   char                 peer[INET_ADDRSTRLEN];   // Address of the client, for the traces
+
+} _HttpConnection;
+
+static _HttpConnection _connections[MAX_HTTP_SERVER_CONNECTIONS];
+
+static int  _processConnectionRequest(char * SzBuf);
+static void _acceptConnections(int epollFd);
+static void _readRequest(int epollFd, _HttpConnection * pConn);
+static void _writeResponse(int epollFd, _HttpConnection * pConn);
+static void _closeConnection(int epollFd, _HttpConnection * pConn);
+static long long _currentTimeMs(void);
+
 
 
 /**
  * @brief Launch the http server an infinite loop
  *
+ * The connections are served by an epoll loop on non-blocking sockets : each one
+ * progresses on its own (reading the request, then writing the response) and is
+ * dropped if not completed within HTTP_SERVER_REQUEST_TIMEOUT, so a slow or silent
+ * client does not delay the connection requests of the other ones.
+ *
  * @param none
  *
  * @return return DM_OK is okay else DM_ERR
@@ -68,14 +110,14 @@ bool _checkHttpMessageContent(IN char *pSzBuf);
 void*
 DM_HttpServer_Start(void* data UNUSED)
 {
-	struct hostent         * pExp  = NULL;
 	struct sockaddr_in       AddrLocal;
-	struct sockaddr_in       AdrExp;
-	int                      nSocksExp  = 0;
-	unsigned int             nLengthAddrExp;
-	char                     SzBuf[SIZE_HTTP_MSG]; // No need to require a very large buffer.
+	struct epoll_event       event;
+	struct epoll_event       events[MAX_HTTP_SERVER_CONNECTIONS + 1];
+	int                      epollFd;
+	int                      nbEvents;
+	int                      i;
+	int                      reuseAddr = 1;
 	char                     szHostname[MAXHOSTNAMELEN];
-   time_t                   connectionFreqArray[MAXCONNECTIONREQUESTARRAYSIZE];
 
 #ifdef WIN32
   WSADATA WSAData;
@@ -87,8 +129,8 @@ DM_HttpServer_Start(void* data UNUSED)
 	if ( g_DmComData.ServerHttp.sockfd_serveur != -1 ){
 	  DBG("dm_com - DM_HttpServer_Start");
 	  
-  // Init Connection Request Array
-  initConnectionFreqArray(connectionFreqArray);
+  // Init Connection Request Token Bucket
+  initConnectionRateLimiter(CONNECTION_REQUEST_HTTP);
 	  
   // -------------------------------------------------------------------
   // Set parameters of the http server's connexion
@@ -111,6 +153,8 @@ DM_HttpServer_Start(void* data UNUSED)
   //	  so it can become a problem in case another process use the
   //	  port defined for the tr-069's connexion request
   // -------------------------------------------------------------------
+  // The connections closed by the server leave the port in TIME_WAIT : allow to bind it anyway on restart
+  setsockopt( g_DmComData.ServerHttp.sockfd_serveur, SOL_SOCKET, SO_REUSEADDR, (char*)&reuseAddr, sizeof(reuseAddr) );
   INFO( "Http server is binding - Begin" );
   while ( bind( g_DmComData.ServerHttp.sockfd_serveur, (struct sockaddr*)&AddrLocal, sizeof(AddrLocal) ) != 0 );
   INFO( "Http server binded - End" );
@@ -122,6 +166,21 @@ DM_HttpServer_Start(void* data UNUSED)
 	  EXEC_ERROR( "Listening the http server's socket : NOK (Errno.%d) ", errno );
 	  return 0;
   }
+
+  // -------------------------------------------------------------------
+  // The listening socket and the connections are watched by epoll
+  // -------------------------------------------------------------------
+  epollFd = epoll_create1( EPOLL_CLOEXEC );
+  event.events   = EPOLLIN;
+  event.data.ptr = NULL; // The listening socket
+  if ( ( epollFd == -1 )
+    || ( fcntl( g_DmComData.ServerHttp.sockfd_serveur, F_SETFL, O_NONBLOCK ) == -1 )
+    || ( epoll_ctl( epollFd, EPOLL_CTL_ADD, g_DmComData.ServerHttp.sockfd_serveur, &event ) == -1 ) ) {
+	  EXEC_ERROR( "Polling the http server's socket : NOK (Errno.%d) ", errno );
+	  if ( epollFd != -1 ) close( epollFd );
+	  return 0;
+  }
+  memset((void *) _connections, 0x00, sizeof(_connections) );
   
   DBG("DM_COM Init End");
   // Notify DM_COM that the HTTP Server initialisation is done.
@@ -134,211 +193,426 @@ DM_HttpServer_Start(void* data UNUSED)
   g_DmComData.ServerHttp.nExitHttpSvr = 0;
   while ( g_DmComData.ServerHttp.nExitHttpSvr != 1 )
   {
-     int httpCode = 0;
+     long long now = _currentTimeMs();
+     long long timeout = HTTP_SERVER_POLL_PERIOD;
+
+     // Wait until the nearest deadline at most
+     for ( i = 0; i < MAX_HTTP_SERVER_CONNECTIONS; i++ )
+     {
+        if ( ( _connections[i].state != _HTTP_CONNECTION_FREE ) && ( _connections[i].deadline - now < timeout ) )
+        {
+           timeout = ( _connections[i].deadline > now ? _connections[i].deadline - now : 0 );
+        }
+     }
 
-	  // Wait for a client ...
-	  nLengthAddrExp = sizeof( AdrExp );
-     nSocksExp = accept( g_DmComData.ServerHttp.sockfd_serveur, (struct sockaddr*)&AdrExp, &nLengthAddrExp );
-	  if ( nSocksExp == -1 )
+     nbEvents = epoll_wait( epollFd, events, MAX_HTTP_SERVER_CONNECTIONS + 1, (int)timeout );
+     if ( ( nbEvents == -1 ) && ( errno != EINTR ) )
      {
-        EXEC_ERROR( "Bad connection established with the client (Err.%d) - Accept failed.", errno );
-        continue;
+        EXEC_ERROR( "Polling the http server's sockets failed (Err.%d)", errno );
+        break;
      }
 
-     INFO( "HTTP Server - Accept a new connection..." );
+     for ( i = 0; i < nbEvents; i++ )
+     {
+        _HttpConnection * pConn = (_HttpConnection *) events[i].data.ptr;
+
+        if ( pConn == NULL )
+        {
+           _acceptConnections( epollFd );
+        }
+        else if ( pConn->state == _HTTP_CONNECTION_READING )
+        {
+           _readRequest( epollFd, pConn );
+        }
+        else if ( pConn->state == _HTTP_CONNECTION_WRITING )
+        {
+           _writeResponse( epollFd, pConn );
+        }
+     }
+
+     // Drop the connections which did not complete in time
+     now = _currentTimeMs();
+     for ( i = 0; i < MAX_HTTP_SERVER_CONNECTIONS; i++ )
+     {
+        if ( ( _connections[i].state != _HTTP_CONNECTION_FREE ) && ( _connections[i].deadline <= now ) )
+        {
+           WARN( "HTTP Server - Connection with %s timed out", _connections[i].peer );
+           _closeConnection( epollFd, &_connections[i] );
+        }
+     }
+  } // End while
+
+  for ( i = 0; i < MAX_HTTP_SERVER_CONNECTIONS; i++ )
+  {
+     if ( _connections[i].state != _HTTP_CONNECTION_FREE )
+     {
+        _closeConnection( epollFd, &_connections[i] );
+     }
+  }
+  close( epollFd );
+
+  // --> The socket will be close in a DM_COM_Stop function
+	} else {
+  EXEC_ERROR( "[%d] Problem for creating the socket needs for the http server!!",
+                       g_DmComData.ServerHttp.sockfd_serveur );
+	}
+
+#ifdef WIN32
+  WSACleanup();
+#endif
+			
+	return 0;
+}
+
+
+// ------------------------------------------------------------------
+// ------------------------------------------------------------------
+// ------------------------------------------------------------------
+// ------------------- PRIVATE ROUTINES ARE BELOW -------------------
+// ------------------------------------------------------------------
+// ------------------------------------------------------------------
+// ------------------------------------------------------------------
+
+/**
+ * @brief Handle a complete connection request
+ *
+ * @param The request received
+ *
+ * @return The http code of the response
+ *
+ */
+static int
+_processConnectionRequest(char * SzBuf)
+{
+    int httpCode = 0;
 
     // Check connection policy (max number of connection per minute 
     // and from device start up.
-    if (true == maxConnectionPerPeriodReached(connectionFreqArray))
+    if (true == maxConnectionPerPeriodReached(CONNECTION_REQUEST_HTTP))
     {
        WARN( "Can not accept this connection (Policy Connection Refused)" );
        // Respond to that connection request with the HTTP 503 Status
-          httpCode = HTTP_SERVICE_UNAVAILABLE;
+       httpCode = HTTP_SERVICE_UNAVAILABLE;
     }
-    else
+    // -------------------------------------------------------------------
+    // Does a session is already in progress ?
+    // -------------------------------------------------------------------
+    else if ( g_DmComData.bSession ) // A session is already created
     {
        // -------------------------------------------------------------------
-       // Display several information about the client connected
-       // -------------------------------------------------------------------
-       pExp = gethostbyaddr( (char*)&AdrExp.sin_addr, sizeof(AdrExp.sin_addr), AF_INET );
-       if ( pExp != NULL ) {
-         INFO( "Connexion well established with the following client: %s", (char*)pExp->h_name );
-       } else {
-         WARN( "Connexion well established with an unknown client!!" );
-       }
-
-       // -------------------------------------------------------------------
-       // Initialise the buffer then Get it
+       // Send a 503 HTTP message (busy)
        // -------------------------------------------------------------------
-       memset((void *) SzBuf, 0x00, SIZE_HTTP_MSG );
-       // Wait a while after accept..
-       DM_CMN_Thread_msleep(10);
-
-       int res;
-       int maxLoopCounter = 0;
-       int maxLoopAllowed = 50;
-       do {
-#ifndef WIN32
-         res = recv( nSocksExp, SzBuf, SIZE_HTTP_MSG, MSG_DONTWAIT );
-#else
-         res = recv( nSocksExp, SzBuf, SIZE_HTTP_MSG, 0 );
-#endif
-
-         if (res != 0 || errno != EAGAIN) {
-            break;
-	      }
-
-	      DBG("Receive No Data or EAGAIN - Wait a while and try again later");
-         DM_CMN_Thread_msleep(10);
-
-	      // Increment maxLoopCounter (make sure to avoid infinite loop)
-	      maxLoopCounter++;
-       } while(maxLoopCounter<maxLoopAllowed);
+       EXEC_ERROR( "A session is already in process. Only one can be used at one time!!" );
+       httpCode = HTTP_SERVICE_UNAVAILABLE;
+    }
+    else
+    {
 
-       if ((-1 == res) || (maxLoopCounter == maxLoopAllowed))
-       {
-          EXEC_ERROR("ERROR while receiving message from socket");
+#ifndef WIN32 // NO AUTH ON WINDOWS
+       // If this HTTP Message do not contain DIGEST Authentication data, send
+       // an authentication request.
+       if (false == _checkDigestAuthMessageContent(SzBuf)) {
+          INFO( "HTTP Message do not contain Authentication Data." );
+          httpCode = HTTP_UNAUTHORIZED;
        }
        else
        {
-          // -------------------------------------------------------------------
-          // Does a session is already in progress ?
-          // -------------------------------------------------------------------
-          if ( g_DmComData.bSession ) // A session is already created
-          {
-             // -------------------------------------------------------------------
-             // Send a 503 HTTP message (busy)
-             // -------------------------------------------------------------------
-             EXEC_ERROR( "A session is already in process. Only one can be used at one time!!" );
-             httpCode = HTTP_SERVICE_UNAVAILABLE;
+          INFO( "HTTP Message contain DIGEST Authentication data." );
+
+          // The HTTP Message contains Digest Authentication data.
+          // Perform the authentication (check certificat)
+          if (false == performClientDigestAuthentication(SzBuf)){
+             WARN( "DIGEST AUTHENTICATION: FAILED." );
+             httpCode = HTTP_UNAUTHORIZED;
           }
           else
           {
+             INFO( "DIGEST AUTHENTICATION: SUCCESS." );
+          }
+       }
+#endif
 
-#ifndef WIN32 // NO AUTH ON WINDOWS
-             // If this HTTP Message do not contain DIGEST Authentication data, send
-             // an authentication request.
-             if (false == _checkDigestAuthMessageContent(SzBuf)) {
-                INFO( "HTTP Message do not contain Authentication Data." );
-                httpCode = HTTP_UNAUTHORIZED;
-             }
-             else
+       if (httpCode == 0)
+       {
+          // As to analyse and valid the content received
+          if ( true == _checkHttpMessageContent( SzBuf ) )
+          {
+             // If okay, ask to DM_Engine to open the session
+             if ( DM_ENG_RequestConnection( DM_ENG_EntityType_ACS ) == 0 )
              {
-                INFO( "HTTP Message contain DIGEST Authentication data." );
-
-                // The HTTP Message contains Digest Authentication data.
-                // Perform the authentication (check certificat)
-                char * tmpStr = DM_ENG_strndup(SzBuf, SIZE_HTTP_MSG-1);
-                if (false == performClientDigestAuthentication(tmpStr)){
-                   WARN( "DIGEST AUTHENTICATION: FAILED." );
-                   httpCode = HTTP_UNAUTHORIZED;
-                }
-                else
-                {
-                   INFO( "DIGEST AUTHENTICATION: SUCCESS." );
-                }
-                DM_ENG_FREE(tmpStr);
-             }
-#endif
+                // Take a token from the Connection Request Token Bucket
+                newConnectionRequestAllowed(CONNECTION_REQUEST_HTTP);
 
-             if (httpCode == 0)
+                httpCode = HTTP_OK;
+             }
+             else
              {
-                // As to analyse and valid the content received
-   	          if ( true == _checkHttpMessageContent( SzBuf ) )
-                {
-   	             // If okay, ask to DM_Engine to open the session
-                   if ( DM_ENG_RequestConnection( DM_ENG_EntityType_ACS ) == 0 )
-                   {
-   		             // Update the Request Connection Array
-                      newConnectionRequestAllowed(connectionFreqArray);
-
-                      httpCode = HTTP_OK;
-                   }
-   	             else
-                   {
-   	                // Can not perform request connection
-                      httpCode = HTTP_SERVICE_UNAVAILABLE;
-   	             }
-   	          }
-                else
-                {
-                   EXEC_ERROR( "Validation of the connexion request : NOK " );
-                   DBG( "Sending an http message to the ACS because a authentification denied!!" );
-                   httpCode = HTTP_UNAUTHORIZED;
-                }
+                // Can not perform request connection
+                httpCode = HTTP_SERVICE_UNAVAILABLE;
              }
           }
+          else
+          {
+             EXEC_ERROR( "Validation of the connexion request : NOK " );
+             DBG( "Sending an http message to the ACS because a authentification denied!!" );
+             httpCode = HTTP_UNAUTHORIZED;
+          }
        }
     }
 
-    if (httpCode == HTTP_UNAUTHORIZED)
-    {
-       INFO( "Request the ACS to provide Authentication Data." );
-       _sendAuthenticationRequest(nSocksExp);
-    }
-    else if (httpCode == HTTP_SERVICE_UNAVAILABLE)
-    {
-       DBG( "Sending an http message to the ACS with the 503 code" );
-       _sendHttpResponse(HTTP_CODE_SVR_BUSY, HTTP_STRING_SVR_BUSY, nSocksExp);
-    }
-    else if (httpCode == HTTP_OK)
-    {
-       // Send a HTTP response with either the code 200 or 204
-       _sendHttpResponse(HTTP_CODE_OK, HTTP_STRING_OK, nSocksExp);
-    }
+    return httpCode;
+}
 
-    // Close the current socket used for the transaction
-    close( nSocksExp );
-  } // End while
+/**
+ * @brief Accept all the pending connections of the listening socket.
+ *        When all the connection slots are used, the client gets a 503 response.
+ *
+ * @param The epoll instance of the server
+ *
+ * @return none
+ *
+ */
+static void
+_acceptConnections(int epollFd)
+{
+   struct sockaddr_in   AdrExp;
+   socklen_t            nLengthAddrExp;
+   struct epoll_event   event;
+   _HttpConnection    * pConn;
+   int                  nSocksExp;
+   int                  i;
+
+   for ( ;; )
+   {
+      // Wait for a client ...
+      nLengthAddrExp = sizeof( AdrExp );
+      nSocksExp = accept( g_DmComData.ServerHttp.sockfd_serveur, (struct sockaddr*)&AdrExp, &nLengthAddrExp );
+      if ( nSocksExp == -1 )
+      {
+         if ( ( errno != EAGAIN ) && ( errno != EWOULDBLOCK ) && ( errno != EINTR ) )
+         {
+            EXEC_ERROR( "Bad connection established with the client (Err.%d) - Accept failed.", errno );
+         }
+         return;
+      }
+      if ( fcntl( nSocksExp, F_SETFL, O_NONBLOCK ) == -1 )
+      {
+         EXEC_ERROR( "Bad connection established with the client (Err.%d) - Non blocking mode failed.", errno );
+         close( nSocksExp );
+         continue;
+      }
+
+      pConn = NULL;
+      for ( i = 0; ( i < MAX_HTTP_SERVER_CONNECTIONS ) && ( pConn == NULL ); i++ )
+      {
+         if ( _connections[i].state == _HTTP_CONNECTION_FREE ) pConn = &_connections[i];
+      }
+
+      if ( pConn == NULL )
+      {
+         char pHTTP_Response[SIZE_HTTP_MSG];
+
+         WARN( "HTTP Server - Too many connections in progress, the new one is refused" );
+         if ( _buildHttpResponse(HTTP_CODE_SVR_BUSY, HTTP_STRING_SVR_BUSY, pHTTP_Response) )
+         {
+            // Best effort, the socket buffer of a new connection is empty
+            send( nSocksExp, pHTTP_Response, strlen(pHTTP_Response), MSG_NOSIGNAL );
+         }
+         close( nSocksExp );
+         continue;
+      }
+
+      pConn->socketFd = nSocksExp;
+      pConn->state    = _HTTP_CONNECTION_READING;
+      pConn->deadline = _currentTimeMs() + HTTP_SERVER_REQUEST_TIMEOUT;
+      pConn->length   = 0;
+      pConn->sent     = 0;
+      pConn->buf[0]   = '\0';
+      if ( NULL == inet_ntop( AF_INET, &AdrExp.sin_addr, pConn->peer, sizeof(pConn->peer) ) )
+      {
+         strcpy( pConn->peer, "unknown" );
+      }
+
+      event.events   = EPOLLIN;
+      event.data.ptr = pConn;
+      if ( epoll_ctl( epollFd, EPOLL_CTL_ADD, nSocksExp, &event ) == -1 )
+      {
+         EXEC_ERROR( "Polling the connection with %s failed (Err.%d)", pConn->peer, errno );
+         close( nSocksExp );
+         pConn->state = _HTTP_CONNECTION_FREE;
+         continue;
+      }
+
+      INFO( "HTTP Server - Accept a new connection from %s", pConn->peer );
+   }
+}
 
-  // --> The socket will be close in a DM_COM_Stop function
-	} else {
-  EXEC_ERROR( "[%d] Problem for creating the socket needs for the http server!!",
-                       g_DmComData.ServerHttp.sockfd_serveur );
-	}
+/**
+ * @brief Read the available data of a connection. Once the request header is
+ *        complete (or the buffer is full), the request is handled and the
+ *        connection switches to the writing of the response.
+ *
+ * @param The epoll instance and the connection
+ *
+ * @return none
+ *
+ */
+static void
+_readRequest(int epollFd, _HttpConnection * pConn)
+{
+   struct epoll_event   event;
+   int                  res;
+   int                  httpCode;
+
+   do {
+      res = recv( pConn->socketFd, pConn->buf + pConn->length, SIZE_HTTP_MSG - 1 - pConn->length, 0 );
+      if ( res > 0 ) pConn->length += res;
+   } while ( ( res > 0 ) && ( pConn->length < SIZE_HTTP_MSG - 1 ) );
+   pConn->buf[pConn->length] = '\0';
+
+   if ( ( pConn->length < SIZE_HTTP_MSG - 1 )
+     && ( NULL == strstr( pConn->buf, "\r\n\r\n" ) ) && ( NULL == strstr( pConn->buf, "\n\n" ) ) )
+   {
+      // The request is not complete yet
+      if ( ( res == 0 ) || ( ( errno != EAGAIN ) && ( errno != EWOULDBLOCK ) && ( errno != EINTR ) ) )
+      {
+         EXEC_ERROR( "ERROR while receiving message from %s", pConn->peer );
+         _closeConnection( epollFd, pConn );
+      }
+      return;
+   }
+
+   httpCode = _processConnectionRequest( pConn->buf );
+   if (httpCode == HTTP_UNAUTHORIZED)
+   {
+      INFO( "Request the ACS to provide Authentication Data." );
+      if ( DM_OK != _buildAuthenticationRequest(pConn->buf, sizeof(pConn->buf)) ) httpCode = 0;
+   }
+   else if (httpCode == HTTP_SERVICE_UNAVAILABLE)
+   {
+      DBG( "Sending an http message to the ACS with the 503 code" );
+      if ( !_buildHttpResponse(HTTP_CODE_SVR_BUSY, HTTP_STRING_SVR_BUSY, pConn->buf) ) httpCode = 0;
+   }
+   else if (httpCode == HTTP_OK)
+   {
+      // Send a HTTP response with either the code 200 or 204
+      if ( !_buildHttpResponse(HTTP_CODE_OK, HTTP_STRING_OK, pConn->buf) ) httpCode = 0;
+   }
+   else
+   {
+      httpCode = 0;
+   }
+
+   if ( httpCode == 0 )
+   {
+      _closeConnection( epollFd, pConn );
+      return;
+   }
+
+   pConn->state  = _HTTP_CONNECTION_WRITING;
+   pConn->length = strlen( pConn->buf );
+   pConn->sent   = 0;
+   event.events   = EPOLLOUT;
+   event.data.ptr = pConn;
+   epoll_ctl( epollFd, EPOLL_CTL_MOD, pConn->socketFd, &event );
+
+   _writeResponse( epollFd, pConn );
+}
 
-#ifdef WIN32
-  WSACleanup();
-#endif
-			
-	return 0;
+/**
+ * @brief Send what the socket accepts of the response. The connection is
+ *        closed once the response is sent, or on error.
+ *
+ * @param The epoll instance and the connection
+ *
+ * @return none
+ *
+ */
+static void
+_writeResponse(int epollFd, _HttpConnection * pConn)
+{
+   int n;
+
+   while ( pConn->sent < pConn->length )
+   {
+      n = send( pConn->socketFd, pConn->buf + pConn->sent, pConn->length - pConn->sent, MSG_NOSIGNAL );
+      if ( n == -1 )
+      {
+         if ( ( errno == EAGAIN ) || ( errno == EWOULDBLOCK ) || ( errno == EINTR ) ) return; // Wait for EPOLLOUT
+         EXEC_ERROR( "Impossible to send the Http Message to %s.", pConn->peer );
+         break;
+      }
+      pConn->sent += n;
+   }
+
+   if ( pConn->sent == pConn->length )
+   {
+      DBG( "HTTP Message Sent" );
+   }
+
+   // Close the current socket used for the transaction
+   _closeConnection( epollFd, pConn );
 }
 
+/**
+ * @brief Close a connection and release its slot
+ *
+ * @param The epoll instance and the connection
+ *
+ * @return none
+ *
+ */
+static void
+_closeConnection(int epollFd, _HttpConnection * pConn)
+{
+   epoll_ctl( epollFd, EPOLL_CTL_DEL, pConn->socketFd, NULL );
+   close( pConn->socketFd );
+   pConn->socketFd = -1;
+   pConn->state    = _HTTP_CONNECTION_FREE;
+}
 
-// ------------------------------------------------------------------
-// ------------------------------------------------------------------
-// ------------------------------------------------------------------
-// ------------------- PRIVATE ROUTINES ARE BELOW -------------------
-// ------------------------------------------------------------------
-// ------------------------------------------------------------------
-// ------------------------------------------------------------------
+/**
+ * @brief Monotonic time in milliseconds, used for the connection deadlines
+ *
+ * @param none
+ *
+ * @return The time in ms
+ *
+ */
+static long long
+_currentTimeMs(void)
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
 
 /**
- * @brief Send and HTTP Response on the given socket with the http Code and String
+ * @brief Build an HTTP Response with the http Code and String
  *
- * @param httpCodeStr, httpString and socket to use.
+ * @param httpCodeStr, httpString and the buffer receiving the response (SIZE_HTTP_MSG bytes).
  *
  * @return return true on success, false otherwise.
  *
  */
 bool
-_sendHttpResponse(
+_buildHttpResponse(
   char * httpCodeStr,
   char * httpString,
-  int    socketFd)
+  char * pHTTP_Response)
 {
   
-  char                 pHTTP_Response[SIZE_HTTP_MSG];
   char                 pHTTP_Datetime[SIZE_HTTP_DATE];
   time_t               currentTime;
   
   
-  if((NULL == httpCodeStr) || (NULL == httpString)) {
+  if((NULL == httpCodeStr) || (NULL == httpString) || (NULL == pHTTP_Response)) {
     EXEC_ERROR("Invalid Argument");
     return false;  
   }
 	      
-  DBG( "Sending an http response (Code: %s, String: %s)", httpCodeStr, httpString);
+  DBG( "Building an http response (Code: %s, String: %s)", httpCodeStr, httpString);
   
   currentTime = time( NULL );
   strftime( pHTTP_Datetime, sizeof(pHTTP_Datetime), HTTP_DATETIME, gmtime(&currentTime) );
@@ -347,50 +621,10 @@ _sendHttpResponse(
   strcat( pHTTP_Response, pHTTP_Datetime );
   strcat( pHTTP_Response, HTTP_LENGTH    );
   DBG( "HTTP response to send to the ACS server:\n%s ", pHTTP_Response );
-	      
-  if(false == _sendAllMessage(socketFd, pHTTP_Response, strlen(pHTTP_Response))) {
-    EXEC_ERROR("Error sending message on socket!!!");
-    return false;
-  } else {
-    DBG("HTTP Message Sent");
-  }      
   
   return true;
 }
 
-/*
-* This routine is used to send a message in a socket. This routine ensure that 
-* the complete message is sent.
-*/
-bool
-_sendAllMessage(int          socketFd,
-                const char * buf,
-                int          len){
-
-  int total = 0;        // How many byte we have sent
-  int bytesleft = len;  // How many we have left to send
-  int n;
-  	      
-  // Check Parameters
-  if(NULL == buf){
-    EXEC_ERROR( ERROR_INVALID_PARAMETERS );
-    return false;
-  }
-	
-  while(total < len) {
-    n = send(socketFd, buf+total, bytesleft, 0);
-    if(n == -1) {
-      EXEC_ERROR( "Impossible to send the Http Message." );
-      return false;
-    }
-    total     += n;
-    bytesleft -= n;
-  }
-	
-  return true;
-	      
-}
-
 /**
  * @brief function which manage the a http connexion
  *
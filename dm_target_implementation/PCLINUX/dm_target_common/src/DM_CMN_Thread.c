@@ -211,6 +211,11 @@ int DM_CMN_Thread_signalCond(IN DM_CMN_Cond_t cond)
    return (cond == NULL ? 1 : pthread_cond_signal((pthread_cond_t*)cond));
 }
 
+int DM_CMN_Thread_broadcastCond(IN DM_CMN_Cond_t cond)
+{
+   return (cond == NULL ? 1 : pthread_cond_broadcast((pthread_cond_t*)cond));
+}
+
 int DM_CMN_Thread_destroyCond(IN DM_CMN_Cond_t cond)
 {
    int res = 1;
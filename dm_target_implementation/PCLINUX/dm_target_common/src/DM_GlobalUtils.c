@@ -81,6 +81,9 @@ const char* DM_ENG_DEVICE_MANUFACTURER_OUI_NAME = DM_PREFIX "DeviceInfo.Manufact
 const char* DM_ENG_DEVICE_PRODUCT_CLASS_NAME    = DM_PREFIX "DeviceInfo.ProductClass";
 const char* DM_ENG_DEVICE_SERIAL_NUMBER_NAME    = DM_PREFIX "DeviceInfo.SerialNumber";
 
+const char* DM_ENG_BULK_DATA_OBJECT_NAME        = DM_PREFIX "X_ORANGE-COM_BulkData.";
+const char* DM_ENG_STATS_CHECKPOINT_INTERVAL_NAME = DM_PREFIX "DeviceInfo.X_ORANGE-COM_StatisticsCheckpointInterval";
+
 /////////////////////////////////////////////////////////////////
 //   CONNECTION REQUEST URL
 /////////////////////////////////////////////////////////////////
@@ -27,12 +27,15 @@
 #include "CMN_Trace.h"
 #include <sys/stat.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 static const char* PARAMETERS_INI_FILE = "parameters.csv";
 static const char* PARAMETERS_OBJ_FILE = "parameters.data";
 static const char* PARAMETERS_BACKUP_OBJ_FILE = "parameters.data~";
 static const char* PARAMETERS_CTRL_FILE = "dm_control.data";
 static const char* PARAMETERS_LOCK_FILE = "parameters.lock";
+static const char* STATISTICS_OBJ_FILE = "statistics.data";
+static const char* STATISTICS_BACKUP_OBJ_FILE = "statistics.data~";
 
 static const char* NULL_CODE = "_";
 static const int MAX_NB_ATTR = 15;
@@ -45,9 +48,18 @@ static char* _parametersObjFile = NULL;
 static char* _parametersBackupObjFile = NULL;
 static char* _parametersCtrlFile = NULL;
 static char* _parametersLockFile = NULL;
+static char* _statisticsObjFile = NULL;
+static char* _statisticsBackupObjFile = NULL;
 
 static DM_ENG_Parameter* parameters = NULL;
 static int nbParameters = 0;
+static unsigned int _structureVersion = 1; // incrment  chaque ajout ou suppression de paramtres
+
+// Index des paramtres par nom : table de hachage  adressage ouvert (taille : puissance de 2, au moins 2 fois le nb de paramtres)
+// reconstruite  la 1re recherche qui suit une modification de la structure
+static DM_ENG_Parameter** _index = NULL;
+static size_t _indexSize = 0;
+static unsigned int _indexVersion = 0;
 static time_t _lastModifData = 0;
 static time_t _lastModifCtrl = 0;
 
@@ -69,6 +81,8 @@ static int _readFileParameters(const char* fichierLu);
 static void _writeParameters();
 static int _readDmControl();
 static void _writeDmControl();
+static int _readStatistics();
+static void _writeStatistics();
 
 static char* _resetCrc();
 static bool _isCrcOK();
@@ -76,6 +90,7 @@ static char* _readln(FILE* fp);
 static bool _checkCrc(FILE* fp);
 static void _writeln(FILE* fp, char* line);
 static void _writeCrc(FILE* fp);
+static unsigned long _computeCrc32(const unsigned char* buf, size_t len);
 
 static bool _controlDataChanged = false;
 
@@ -91,6 +106,8 @@ int DM_ENG_ParameterData_init(const char* dataPath, bool factoryReset)
       if (_parametersBackupObjFile!=NULL) { free(_parametersBackupObjFile); }
       if (_parametersCtrlFile!=NULL) { free(_parametersCtrlFile); }
       if (_parametersLockFile!=NULL) { free(_parametersLockFile); }
+      if (_statisticsObjFile!=NULL) { free(_statisticsObjFile); }
+      if (_statisticsBackupObjFile!=NULL) { free(_statisticsBackupObjFile); }
 
       _parametersIniFile = (char*)malloc(strlen(dataPath) + strlen(PARAMETERS_INI_FILE) + 2);
       strcpy(_parametersIniFile, dataPath);
@@ -117,6 +134,16 @@ int DM_ENG_ParameterData_init(const char* dataPath, bool factoryReset)
       strcat(_parametersLockFile, "/");
       strcat(_parametersLockFile, PARAMETERS_LOCK_FILE);
       DBG("_parametersLockFile = %s", _parametersLockFile);
+      _statisticsObjFile = (char*)malloc(strlen(dataPath) + strlen(STATISTICS_OBJ_FILE) + 2);
+      strcpy(_statisticsObjFile, dataPath);
+      strcat(_statisticsObjFile, "/");
+      strcat(_statisticsObjFile, STATISTICS_OBJ_FILE);
+      DBG("_statisticsObjFile = %s", _statisticsObjFile);
+      _statisticsBackupObjFile = (char*)malloc(strlen(dataPath) + strlen(STATISTICS_BACKUP_OBJ_FILE) + 2);
+      strcpy(_statisticsBackupObjFile, dataPath);
+      strcat(_statisticsBackupObjFile, "/");
+      strcat(_statisticsBackupObjFile, STATISTICS_BACKUP_OBJ_FILE);
+      DBG("_statisticsBackupObjFile = %s", _statisticsBackupObjFile);
    }
    else
    {
@@ -125,6 +152,8 @@ int DM_ENG_ParameterData_init(const char* dataPath, bool factoryReset)
       if (_parametersBackupObjFile==NULL) { _parametersBackupObjFile = strdup(PARAMETERS_BACKUP_OBJ_FILE); }
       if (_parametersCtrlFile==NULL) { _parametersCtrlFile = strdup(PARAMETERS_CTRL_FILE); }
       if (_parametersLockFile==NULL) { _parametersLockFile = strdup(PARAMETERS_LOCK_FILE); }
+      if (_statisticsObjFile==NULL) { _statisticsObjFile = strdup(STATISTICS_OBJ_FILE); }
+      if (_statisticsBackupObjFile==NULL) { _statisticsBackupObjFile = strdup(STATISTICS_BACKUP_OBJ_FILE); }
    }
 
    remove(_parametersLockFile); // suppression du verrou s'il tait rest (suite  un arrt brutal)
@@ -150,6 +179,7 @@ int DM_ENG_ParameterData_init(const char* dataPath, bool factoryReset)
       }
       if (res == 0)
       {
+         _readStatistics();
          _readDmControl();
 #ifdef NO_PERSISTENT_SCHEDULED_INFORM
          // effacer sScheduledInformTime et sScheduledInformCommandKey, si persistance dsactive
@@ -163,6 +193,8 @@ int DM_ENG_ParameterData_init(const char* dataPath, bool factoryReset)
       DBG("Factory Reset");
       remove(_parametersObjFile);
       remove(_parametersCtrlFile);
+      remove(_statisticsObjFile);
+      remove(_statisticsBackupObjFile);
       _lastModifData = 0;
       _lastModifCtrl = 0;
       res = _readFileParameters(_parametersIniFile);
@@ -183,7 +215,10 @@ static void _releaseData()
    {
       DM_ENG_deleteAllParameter(&parameters);
       nbParameters = 0;
+      _structureVersion++;
    }
+   DM_ENG_FREE(_index);
+   _indexSize = 0;
 }
 
 static void _releaseCtrl()
@@ -201,6 +236,11 @@ static void _releaseCtrl()
 void DM_ENG_ParameterData_release()
 {
 //   printf("NB criture / Paramtres : %d, Contrles : %d\n", _nbParameterWrite, _nbControlWrite);
+   if (DM_ENG_Parameter_isStatsDataChanged())
+   {
+      _writeStatistics();
+      DM_ENG_Parameter_setStatsDataChanged(false);
+   }
    _releaseData();
    _releaseCtrl();
 }
@@ -253,6 +293,50 @@ DM_ENG_Parameter* DM_ENG_ParameterData_getCurrent()
    return _current;
 }
 
+unsigned int DM_ENG_ParameterData_getStructureVersion()
+{
+   return _structureVersion;
+}
+
+static unsigned int _hashName(const char* name)
+{
+   unsigned int hash = 2166136261u; // FNV-1a
+   while (*name != '\0')
+   {
+      hash ^= (unsigned char)*name++;
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+static void _buildIndex()
+{
+   size_t nb = 0;
+   size_t size = 64;
+   DM_ENG_Parameter* param;
+   for (param = parameters; param!=NULL; param = param->next) { nb++; }
+   while (size < 2*nb) { size *= 2; }
+   if (size != _indexSize)
+   {
+      DM_ENG_FREE(_index);
+      _index = (DM_ENG_Parameter**)malloc(size * sizeof(DM_ENG_Parameter*));
+      _indexSize = (_index == NULL ? 0 : size);
+   }
+   if (_index == NULL) return;
+
+   memset(_index, 0, _indexSize * sizeof(DM_ENG_Parameter*));
+   for (param = parameters; param!=NULL; param = param->next)
+   {
+      unsigned int h;
+      for (h = _hashName(param->name); _index[h & (_indexSize-1)] != NULL; h++)
+      {
+         if (strcmp(param->name, _index[h & (_indexSize-1)]->name)==0) break; // doublon : le 1er de la liste est conserv
+      }
+      if (_index[h & (_indexSize-1)] == NULL) { _index[h & (_indexSize-1)] = param; }
+   }
+   _indexVersion = _structureVersion;
+}
+
 /**
  *
  * @param name Name of a requested Parameter.
@@ -265,7 +349,17 @@ DM_ENG_Parameter* DM_ENG_ParameterData_getParameter(const char* name)
    if (name != NULL)
    {
       DM_ENG_Parameter* param;
-      for (param = parameters; param!=NULL; param = param->next)
+      if ((_index == NULL) || (_indexVersion != _structureVersion)) { _buildIndex(); }
+      if (_index == NULL) // pas de mmoire pour l'index : recherche squentielle
+      {
+         for (param = parameters; param!=NULL; param = param->next)
+         {
+             if (strcmp(name, param->name)==0) return param;
+         }
+         return NULL;
+      }
+      unsigned int h;
+      for (h = _hashName(name); (param = _index[h & (_indexSize-1)]) != NULL; h++)
       {
           if (strcmp(name, param->name)==0) return param;
       }
@@ -300,12 +394,14 @@ static void _putParameter(DM_ENG_Parameter* param)
       DM_ENG_addParameter(&parameters, param);
       nbParameters++;
    }
+   _structureVersion++;
 }
 
 void DM_ENG_ParameterData_addParameter(DM_ENG_Parameter* param)
 {
    DM_ENG_addParameter(&parameters, param);
    nbParameters++;
+   _structureVersion++;
    DM_ENG_Parameter_setDataChanged(true);
 }
 
@@ -367,6 +463,7 @@ bool DM_ENG_ParameterData_deleteParameters(const char* name, char* configKey)
                   prev->next = prm;
                }
                DM_ENG_deleteParameter(supp);
+               _structureVersion++;
             }
             DM_ENG_Parameter_setDataChanged(true);
             res = true;
@@ -415,6 +512,7 @@ void DM_ENG_ParameterData_deleteObject(char* objectName)
    if (nbSupp != 0)
    {
       nbParameters -= nbSupp;
+      _structureVersion++;
       DM_ENG_Parameter_setDataChanged(true);
    }
 }
@@ -577,6 +675,7 @@ static int _readFileParameters(const char* fichierLu)
          lastParam = newParam;
          nbParameters++;
       }
+      _structureVersion++;
       if (!isIniFile && !_isCrcOK())
       {
          WARN( "*** CRC Error ***" );
@@ -592,6 +691,7 @@ static int _readFileParameters(const char* fichierLu)
  */
 static int _readParameters()
 {
+   time_t lastModif = _lastModifData;
    if (_readFileParameters(_parametersObjFile) != 0) // N.B. Le fichier est lu seulement si modifi depuis la dernire lecture
    {
       WARN("Error while reading the data file => Reading the backup file");
@@ -605,6 +705,10 @@ static int _readParameters()
       }
       _writeParameters();
    }
+   if (_lastModifData != lastModif) // paramtres relus : les valeurs de statistique sont  recharger
+   {
+      _readStatistics();
+   }
    return 0;
 }
 
@@ -667,7 +771,7 @@ static void _writeParameters()
          if (strncmp(param->name, DM_ENG_PARAMETER_PREFIX, prefixLen)==0) // robustesse : test normalement tjrs vrai
          {
             char* al = DM_ENG_buildCommaSeparatedList(param->accessList);
-            char* val = param->value;
+            char* val = (DM_ENG_Parameter_isStatsValue(param) ? NULL : param->value); // valeur sauvegarde dans le fichier des statistiques
             char* encVal = DM_ENG_encodeValue(val);
             if (encVal != NULL) { val = encVal; }
             char* bVal = param->backValue;
@@ -781,6 +885,275 @@ static void _writeDmControl()
    }
 }
 
+//////////////////////////////////////////////////////////////
+//////// Stockage des valeurs de statistique (binaire) ////////
+
+/*
+ * Les valeurs de statistique (cf. DM_ENG_Parameter_updateStatsValue) sont sauvegardes  part, dans un fichier binaire
+ * compact, pour que l'chantillonnage ne provoque pas la rcriture de tout le fichier des paramtres.
+ *
+ * Format : "DMST" <version>, puis un segment par objet (noeud parent) :
+ *    <nom du noeud> <nb de valeurs> { <nom relatif> <state> <valeur> }*
+ * puis un nom de noeud vide et le CRC32 de l'ensemble.
+ * Les noms et valeurs sont prcds de leur longueur (uint16 / uint32, 0xFFFFFFFF pour une valeur NULL).
+ * <state> ne garde que les bits de l'tat lis aux statistiques (cf. DM_ENG_Parameter_getStatsState).
+ */
+
+static const char _STATS_MAGIC[4] = { 'D', 'M', 'S', 'T' };
+static const uint32_t _STATS_VERSION = 1;
+static const uint32_t _STATS_NULL_VALUE = 0xFFFFFFFF;
+
+typedef struct _StatsBuffer
+{
+   unsigned char* data;
+   size_t size;
+   size_t capacity;
+   size_t pos; // position de lecture
+
+} StatsBuffer;
+
+static void _putBytes(StatsBuffer* buf, const void* bytes, size_t len)
+{
+   if (buf->size + len > buf->capacity)
+   {
+      size_t newCapacity = (buf->capacity == 0 ? 4096 : 2 * buf->capacity);
+      while (buf->size + len > newCapacity) { newCapacity *= 2; }
+      buf->data = (unsigned char*)realloc(buf->data, newCapacity);
+      buf->capacity = newCapacity;
+   }
+   memcpy(buf->data + buf->size, bytes, len);
+   buf->size += len;
+}
+
+static void _putUint32(StatsBuffer* buf, uint32_t val)
+{
+   _putBytes(buf, &val, sizeof(val));
+}
+
+static void _putName(StatsBuffer* buf, const char* name, size_t len)
+{
+   uint16_t len16 = (uint16_t)len;
+   _putBytes(buf, &len16, sizeof(len16));
+   _putBytes(buf, name, len);
+}
+
+static bool _getBytes(StatsBuffer* buf, void* bytes, size_t len)
+{
+   if (buf->pos + len > buf->size) return false;
+   memcpy(bytes, buf->data + buf->pos, len);
+   buf->pos += len;
+   return true;
+}
+
+// Fournit le nom (allou) ou NULL si erreur de format
+static char* _getName(StatsBuffer* buf)
+{
+   uint16_t len16 = 0;
+   if (!_getBytes(buf, &len16, sizeof(len16)) || (buf->pos + len16 > buf->size)) return NULL;
+   char* name = (char*)malloc(len16 + 1);
+   _getBytes(buf, name, len16);
+   name[len16] = '\0';
+   return name;
+}
+
+// Longueur du nom du noeud parent (y compris le '.' final)
+static size_t _parentNameLen(const char* name)
+{
+   const char* dot = strrchr(name, '.');
+   return (dot == NULL ? 0 : (size_t)(dot - name) + 1);
+}
+
+/*
+ * Recherche d'un paramtre  partir du curseur (les paramtres d'un segment sont normalement conscutifs)
+ */
+static DM_ENG_Parameter* _findParameterFrom(DM_ENG_Parameter** pCursor, const char* name)
+{
+   DM_ENG_Parameter* param;
+   for (param = *pCursor; param != NULL; param = param->next)
+   {
+      if (strcmp(param->name, name) == 0) break;
+   }
+   if (param == NULL)
+   {
+      for (param = parameters; (param != NULL) && (param != *pCursor); param = param->next)
+      {
+         if (strcmp(param->name, name) == 0) break;
+      }
+      if (param == *pCursor) { param = NULL; }
+   }
+   if (param != NULL) { *pCursor = param->next; }
+   return param;
+}
+
+static void _writeStatistics()
+{
+   size_t prefixLen = strlen(DM_ENG_PARAMETER_PREFIX);
+   StatsBuffer buf = { NULL, 0, 0, 0 };
+   _putBytes(&buf, _STATS_MAGIC, sizeof(_STATS_MAGIC));
+   _putUint32(&buf, _STATS_VERSION);
+
+   DM_ENG_Parameter* param = parameters;
+   while (param != NULL)
+   {
+      if (!DM_ENG_Parameter_isStatsValue(param) || (strncmp(param->name, DM_ENG_PARAMETER_PREFIX, prefixLen) != 0))
+      {
+         param = param->next;
+         continue;
+      }
+
+      // nouveau segment : valeurs de stat conscutives de mme noeud parent
+      const char* segName = param->name;
+      size_t segLen = _parentNameLen(segName);
+      _putName(&buf, segName+prefixLen, segLen-prefixLen);
+      size_t countPos = buf.size;
+      _putUint32(&buf, 0);
+      uint32_t count = 0;
+      while ((param != NULL) && (!DM_ENG_Parameter_isStatsValue(param)
+          || ((_parentNameLen(param->name) == segLen) && (strncmp(param->name, segName, segLen) == 0))))
+      {
+         if (DM_ENG_Parameter_isStatsValue(param))
+         {
+            _putName(&buf, param->name+segLen, strlen(param->name+segLen));
+            _putUint32(&buf, (uint32_t)DM_ENG_Parameter_getStatsState(param));
+            if (param->value == NULL)
+            {
+               _putUint32(&buf, _STATS_NULL_VALUE);
+            }
+            else
+            {
+               uint32_t len = strlen(param->value);
+               _putUint32(&buf, len);
+               _putBytes(&buf, param->value, len);
+            }
+            count++;
+         }
+         param = param->next;
+      }
+      memcpy(buf.data + countPos, &count, sizeof(count));
+   }
+   _putName(&buf, "", 0); // fin des segments
+   _putUint32(&buf, (uint32_t)_computeCrc32(buf.data, buf.size));
+
+   rename(_statisticsObjFile, _statisticsBackupObjFile);
+   FILE* fp = fopen(_statisticsObjFile, "w");
+   if (fp != NULL)
+   {
+      if (fwrite(buf.data, 1, buf.size, fp) != buf.size)
+      {
+         EXEC_ERROR("Error while writing the statistics file");
+      }
+      fclose(fp);
+   }
+   free(buf.data);
+}
+
+static int _readFileStatistics(const char* fichierLu)
+{
+   FILE* fp = fopen(fichierLu, "r");
+   if (fp == NULL) return 1; // fichier inexistant
+
+   struct stat prop;
+   fstat(fileno(fp), &prop);
+   StatsBuffer buf = { NULL, (size_t)prop.st_size, (size_t)prop.st_size, 0 };
+   buf.data = (unsigned char*)malloc(buf.size + 1);
+   size_t nbRead = fread(buf.data, 1, buf.size, fp);
+   fclose(fp);
+
+   char magic[sizeof(_STATS_MAGIC)];
+   uint32_t version = 0;
+   uint32_t crc = 0;
+   if ((nbRead != buf.size) || (buf.size < sizeof(magic) + sizeof(version) + sizeof(crc))
+    || !_getBytes(&buf, magic, sizeof(magic)) || (memcmp(magic, _STATS_MAGIC, sizeof(magic)) != 0)
+    || !_getBytes(&buf, &version, sizeof(version)) || (version != _STATS_VERSION))
+   {
+      WARN("*** Statistics file : bad format ***");
+      free(buf.data);
+      return 2;
+   }
+   memcpy(&crc, buf.data + buf.size - sizeof(crc), sizeof(crc));
+   buf.size -= sizeof(crc);
+   if (crc != (uint32_t)_computeCrc32(buf.data, buf.size))
+   {
+      WARN("*** Statistics file : CRC Error ***");
+      free(buf.data);
+      return 2;
+   }
+
+   int res = 0;
+   DM_ENG_Parameter* cursor = parameters;
+   char* segName;
+   while ((segName = _getName(&buf)) != NULL)
+   {
+      if (*segName == '\0') { free(segName); break; } // fin des segments
+
+      uint32_t count = 0;
+      if (!_getBytes(&buf, &count, sizeof(count))) { res = 2; }
+      size_t segLen = strlen(DM_ENG_PARAMETER_PREFIX) + strlen(segName);
+      uint32_t i;
+      for (i=0; (res == 0) && (i<count); i++)
+      {
+         char* shortName = _getName(&buf);
+         uint32_t state = 0;
+         uint32_t len = 0;
+         if ((shortName == NULL) || !_getBytes(&buf, &state, sizeof(state)) || !_getBytes(&buf, &len, sizeof(len))
+          || ((len != _STATS_NULL_VALUE) && (buf.pos + len > buf.size)))
+         {
+            DM_ENG_FREE(shortName);
+            res = 2;
+            break;
+         }
+         char* name = (char*)malloc(segLen + strlen(shortName) + 1);
+         strcpy(name, DM_ENG_PARAMETER_PREFIX);
+         strcat(name, segName);
+         strcat(name, shortName);
+         DM_ENG_Parameter* param = _findParameterFrom(&cursor, name);
+         if (param != NULL) // sinon paramtre supprim depuis
+         {
+            DM_ENG_Parameter_restoreStatsState(param, (int)state);
+            if (len == _STATS_NULL_VALUE)
+            {
+               DM_ENG_Parameter_updateValue(param, NULL, false);
+            }
+            else if (len == 0)
+            {
+               DM_ENG_Parameter_updateValue(param, (char*)DM_ENG_EMPTY, false);
+            }
+            else
+            {
+               char* value = (char*)malloc(len + 1);
+               _getBytes(&buf, value, len);
+               value[len] = '\0';
+               DM_ENG_Parameter_updateValue(param, value, false);
+               free(value);
+            }
+         }
+         if ((param == NULL) && (len != _STATS_NULL_VALUE)) { buf.pos += len; }
+         free(name);
+         free(shortName);
+      }
+      free(segName);
+      if (res != 0) break;
+   }
+   free(buf.data);
+   if (res != 0) { WARN("*** Statistics file : bad format ***"); }
+   DM_ENG_Parameter_setStatsDataChanged(false);
+   return res;
+}
+
+/*
+ * Recharge les valeurs de statistique aprs la lecture des paramtres
+ */
+static int _readStatistics()
+{
+   int res = _readFileStatistics(_statisticsObjFile);
+   if (res != 0) // Pb ou fichier absent (arrt entre le renommage et l'criture), on tente la lecture du fichier de backup
+   {
+      WARN("Error while reading the statistics file => Reading the backup file");
+      res = _readFileStatistics(_statisticsBackupObjFile);
+   }
+   return res;
+}
+
 /////////////////////////////////////////////////
 //////////////// Periodic Inform ////////////////
 
@@ -1191,11 +1564,23 @@ void DM_ENG_ParameterData_sync()
       _nbParameterWrite++;
       _writeParameters();
       DM_ENG_Parameter_setDataChanged(false);
+      // les valeurs des stats nouvellement marques ne sont plus dans le fichier des paramtres
+      DM_ENG_ParameterData_syncStatistics();
+   }
+}
+
+void DM_ENG_ParameterData_syncStatistics()
+{
+   if (DM_ENG_Parameter_isStatsDataChanged())
+   {
+      _writeStatistics();
+      DM_ENG_Parameter_setStatsDataChanged(false);
    }
 }
 
 void DM_ENG_ParameterData_restore()
 {
+   DM_ENG_ParameterData_syncStatistics(); // les stats ne sont pas concernes par la restauration
    _lastModifData = 0;
    _readParameters();
 }
@@ -1259,6 +1644,19 @@ static void _createCrc32Table()
   _crc32TableComputed = true;
 }
 
+static unsigned long _computeCrc32(const unsigned char* buf, size_t len)
+{
+  unsigned long c = 0xffffffffL;
+  size_t n;
+
+  if (!_crc32TableComputed) { _createCrc32Table(); }
+  for (n = 0; n < len; n++)
+  {
+    c = _crc32Table[(c ^ buf[n]) & 0xff] ^ (c >> 8);
+  }
+  return c ^ 0xffffffffL;
+}
+
 static void _updateCrc32(unsigned char *buf)
 {
   unsigned long c = _crc32 ^ 0xffffffffL;
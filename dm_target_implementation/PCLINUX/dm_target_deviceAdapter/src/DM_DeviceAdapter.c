@@ -41,6 +41,7 @@
 #include "DM_ComponentCalls.h"
 #include "DM_ENG_ParameterBackInterface.h"
 #include "DM_COM_GenericHttpClientInterface.h" // Required for HTTP GET FILE Example
+#include "DM_COM_ConnectionSecurity.h"        // Connection request rate limiting statistics
 #include "DM_CMN_Thread.h"
 
 #ifndef WIN32
@@ -386,6 +387,15 @@ int DM_ENG_Device_getValue(const char* name, const char* systemData, OUT char**
 
       *pVal = strdup(DM_ENG_NONE_STATE);
 
+  } else if (0 == strncmp(paramNameStr, CONNECTION_REQUEST_STATS_OBJECT, strlen(CONNECTION_REQUEST_STATS_OBJECT))) {
+
+      // Counters of the connection request rate limiting (token buckets of DM_COM)
+      const char* statName = paramNameStr + strlen(CONNECTION_REQUEST_STATS_OBJECT);
+      if      (0 == strcmp(statName, "HTTPAllowed"))  { *pVal = DM_ENG_uintToString(getConnectionRequestAllowedCount(CONNECTION_REQUEST_HTTP)); }
+      else if (0 == strcmp(statName, "HTTPRejected")) { *pVal = DM_ENG_uintToString(getConnectionRequestRejectedCount(CONNECTION_REQUEST_HTTP)); }
+      else if (0 == strcmp(statName, "UDPAllowed"))   { *pVal = DM_ENG_uintToString(getConnectionRequestAllowedCount(CONNECTION_REQUEST_UDP)); }
+      else if (0 == strcmp(statName, "UDPRejected"))  { *pVal = DM_ENG_uintToString(getConnectionRequestRejectedCount(CONNECTION_REQUEST_UDP)); }
+
   } else {
 
     // On recherche d'abord le paramtre dans DeviceInterfaceStubFile, fichier qui se place en coupure vis--vis de l'accs systme
@@ -916,6 +926,20 @@ int DM_ENG_Device_upload(char* fileType, char* url, char* username, char* passwo
    return 1;
 }
 
+int DM_ENG_Device_postData(const char* url, const char* username, const char* password, const char* contentType, const char* data, size_t dataSize)
+{
+   httpPostDataType httpPostData;
+
+   httpPostData.destURLStr     = (char*)url;
+   httpPostData.usernameStr    = (char*)username;
+   httpPostData.passwordStr    = (char*)password;
+   httpPostData.contentTypeStr = (char*)contentType;
+   httpPostData.dataPtr        = data;
+   httpPostData.dataSize       = dataSize;
+
+   return DM_HttpPostData(&httpPostData);
+}
+
 /* -------------------------------------------------------------- */
 /* -------------------------------------------------------------- */
 /* --------------------- PRIVATE ROUTINES ----------------------- */
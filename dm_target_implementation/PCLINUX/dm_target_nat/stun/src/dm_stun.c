@@ -110,7 +110,6 @@ typedef struct
 	int            nTimeout;
 	UInt8          TimeoutState;
 	timeoutThreadStruct	timeoutThreadData;
-	time_t         connectionFreqArray[MAXCONNECTIONREQUESTARRAYSIZE];
 	bool           bExitWindow;
 	bool           bCanNotificateWanIP;
 	bool           bThrirdThreadLaunched;
@@ -293,7 +292,7 @@ DM_STUN_stunThread()
 	memset( &udpConnectionRequestAddress, 0x00, UDP_CONNECTION_REQUEST_ADDRESS_SIZE );
 	memset( &(mainStunThreadData.timeoutThreadData), 0x00, sizeof(timeoutThreadStruct) );
 	
-	initConnectionFreqArray( mainStunThreadData.connectionFreqArray );
+	initConnectionRateLimiter( CONNECTION_REQUEST_UDP );
 	pthread_mutex_init( &(mainStunThreadData.timeoutThreadData.mutex_lock), NULL );
 
 	
@@ -663,7 +662,6 @@ DM_STUN_timeoutDiscoveryManagementThread(stunThreadStruct* initial_stunThreadDat
 	// --------------------------------------------------------------------
 	// Make some other settings
 	// --------------------------------------------------------------------
-	initConnectionFreqArray( discoveryTimeoutStunThreadData.connectionFreqArray );
 	DM_STUN_initValues( &discoveryTimeoutStunThreadData );
 	DM_STUN_openSocket( &(discoveryTimeoutStunThreadData.fdClient), discoveryTimeoutStunThreadData.lanIp, discoveryTimeoutStunThreadData.stunClientPort.binding );
 	INFO( "TimeoutDiscovery Thread - STUN Initialization completed successfully." );
@@ -1205,9 +1203,9 @@ DM_STUN_readManagement(stunThreadStruct* stunThreadData)
 					{
 						stunThreadData->messageId = messageId;
 						DBG( "New timeStamp (%lld) and messageId (%lld) ", timeStamp, messageId );
-						if ( FALSE == maxConnectionPerPeriodReached( stunThreadData->connectionFreqArray ) )
+						if ( FALSE == maxConnectionPerPeriodReached( CONNECTION_REQUEST_UDP ) )
 						{
-							newConnectionRequestAllowed( stunThreadData->connectionFreqArray );
+							newConnectionRequestAllowed( CONNECTION_REQUEST_UDP );
 							
 							// --------------------------------------------------------------
 							// Ask to DM_Engine to open the session
@@ -0,0 +1,329 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : acs_bench.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file acs_bench.c
+ *
+ * @brief Benchmark of a whole CWMP session over a link of high round trip time
+ *
+ * Usage: acs_bench [-p port] [-t rttMs] [-e maxEnvelopes]
+ *
+ * Scripted ACS serving one CWMP session to cwmpd : the Inform is answered, then the RPC of
+ * the script are sent, then the session is closed (204 No Content). Each HTTP response is
+ * delayed by the round trip time (200 ms by default), as on a distant link. With -e n, the
+ * ACS advertises MaxEnvelopes n in its InformResponse and sends up to n RPC in one HTTP
+ * response, within the MaxEnvelopes of the Inform (cwmpd built with MAX_ENVELOPES=n). The
+ * number of POSTs and of envelopes received, and the duration of the session are printed.
+ *
+ * Example, from the root of the agent :
+ *   mkdir /tmp/acs_bench && cp rsc/DeviceInterfaceStubFile /tmp/acs_bench
+ *   sed 's|^ManagementServer.URL;\(.*\);;[^;]*;|ManagementServer.URL;\1;;http://127.0.0.1:18100/acs;|' rsc/parameters.csv > /tmp/acs_bench/parameters.csv
+ *   obj/test/acs_bench -t 200 -e 4 &
+ *   ./cwmpd -p /tmp/acs_bench
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "CMN_Type_Def.h"
+
+#define _BUFFER_SIZE (64*1024)
+
+static const char * _ENVELOPE =
+  "<soapenv:Envelope xmlns:soapenv=\"http://schemas.xmlsoap.org/soap/envelope/\""
+  " xmlns:soapenc=\"http://schemas.xmlsoap.org/soap/encoding/\" xmlns:xsd=\"http://www.w3.org/2001/XMLSchema\""
+  " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xmlns:cwmp=\"urn:dslforum-org:cwmp-1-0\">"
+  "<soapenv:Header><cwmp:ID soapenv:mustUnderstand=\"1\">%s</cwmp:ID></soapenv:Header>"
+  "<soapenv:Body>%s</soapenv:Body></soapenv:Envelope>";
+
+static const char * _CONTINUE   = "HTTP/1.1 100 Continue\r\n\r\n";
+static const char * _NO_CONTENT = "HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n";
+
+static const char * _INFORM_RESPONSE =
+  "<cwmp:InformResponse><MaxEnvelopes>%d</MaxEnvelopes></cwmp:InformResponse>";
+
+// RPC of the session, after the InformResponse
+static const char * _SCRIPT[] = {
+  "<cwmp:GetRPCMethods></cwmp:GetRPCMethods>",
+  "<cwmp:GetParameterNames><ParameterPath>Device.</ParameterPath><NextLevel>1</NextLevel></cwmp:GetParameterNames>",
+  "<cwmp:GetParameterNames><ParameterPath>Device.DeviceInfo.</ParameterPath><NextLevel>0</NextLevel></cwmp:GetParameterNames>",
+  "<cwmp:GetParameterValues><ParameterNames soapenc:arrayType=\"xsd:string[2]\"><string>Device.DeviceInfo.</string>"
+    "<string>Device.ManagementServer.URL</string></ParameterNames></cwmp:GetParameterValues>",
+  "<cwmp:GetParameterValues><ParameterNames soapenc:arrayType=\"xsd:string[1]\"><string>Device.Nonexistent.Param</string>"
+    "</ParameterNames></cwmp:GetParameterValues>",
+  "<cwmp:SetParameterValues><ParameterList soapenc:arrayType=\"cwmp:ParameterValueStruct[2]\">"
+    "<ParameterValueStruct><Name>Device.DeviceInfo.ProvisioningCode</Name><Value xsi:type=\"xsd:string\">bench</Value></ParameterValueStruct>"
+    "<ParameterValueStruct><Name>Device.ManagementServer.PeriodicInformInterval</Name><Value xsi:type=\"xsd:unsignedInt\">7200</Value></ParameterValueStruct>"
+    "</ParameterList><ParameterKey>k1</ParameterKey></cwmp:SetParameterValues>",
+  "<cwmp:GetParameterValues><ParameterNames soapenc:arrayType=\"xsd:string[1]\"><string>Device.DeviceInfo.ProvisioningCode</string>"
+    "</ParameterNames></cwmp:GetParameterValues>",
+  "<cwmp:SetParameterValues><ParameterList soapenc:arrayType=\"cwmp:ParameterValueStruct[1]\">"
+    "<ParameterValueStruct><Name>Device.DeviceInfo.Manufacturer</Name><Value xsi:type=\"xsd:string\">x</Value></ParameterValueStruct>"
+    "</ParameterList><ParameterKey>k2</ParameterKey></cwmp:SetParameterValues>",
+  "<cwmp:GetParameterAttributes><ParameterNames soapenc:arrayType=\"xsd:string[2]\"><string>Device.DeviceInfo.</string>"
+    "<string>Device.ManagementServer.URL</string></ParameterNames></cwmp:GetParameterAttributes>",
+  "<cwmp:SetParameterAttributes><ParameterList soapenc:arrayType=\"cwmp:SetParameterAttributesStruct[1]\"><SetParameterAttributesStruct>"
+    "<Name>Device.ManagementServer.URL</Name><NotificationChange>1</NotificationChange><Notification>1</Notification>"
+    "<AccessListChange>0</AccessListChange><AccessList></AccessList></SetParameterAttributesStruct></ParameterList></cwmp:SetParameterAttributes>",
+  "<cwmp:AddObject><ObjectName>Device.Test.Obj.</ObjectName><ParameterKey>k3</ParameterKey></cwmp:AddObject>",
+  "<cwmp:DeleteObject><ObjectName>Device.Test.Obj.1.</ObjectName><ParameterKey>k4</ParameterKey></cwmp:DeleteObject>",
+  "<cwmp:GetAllQueuedTransfers></cwmp:GetAllQueuedTransfers>",
+  "<cwmp:ScheduleInform><DelaySeconds>3600</DelaySeconds><CommandKey>si</CommandKey></cwmp:ScheduleInform>",
+  NULL
+};
+
+static int    _rtt           = 200; // ms
+static int    _maxEnvelopes  = 1;
+static int    _cpeEnvelopes  = 1;   // MaxEnvelopes of the Inform
+static int    _nextRpc       = -1;  // -1 : Inform not received yet
+static int    _nbPosts       = 0;
+static int    _nbEnvelopes   = 0;
+static double _sessionStart  = 0;
+
+static double _now()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+static bool _sendAll(int sock, const char * data, size_t size)
+{
+  ssize_t n;
+
+  while ( size > 0 ) {
+    if ( (n = send( sock, data, size, MSG_NOSIGNAL )) <= 0 ) { return false; }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+/*
+* Value of the header (NULL if absent), the headers ending with an empty line
+*/
+static const char * _getHeader(const char * headers, const char * name)
+{
+  const char * line = strstr( headers, "\r\n" );
+  size_t       len  = strlen( name );
+
+  while ( (line != NULL) && (strncmp( line, "\r\n\r\n", 4 ) != 0) ) {
+    line += 2;
+    if ( (strncasecmp( line, name, len ) == 0) && (line[len] == ':') ) {
+      line += len + 1;
+      while ( *line == ' ' ) { line++; }
+      return line;
+    }
+    line = strstr( line, "\r\n" );
+  }
+  return NULL;
+}
+
+/*
+* Reads one HTTP request : its headers, then its body (Content-Length or chunked) in body.
+* Returns false when the connection is closed.
+*/
+static bool _readRequest(int sock, char * buffer, size_t * pFilled, char * body, size_t * pBodySize)
+{
+  char       * end      = NULL;
+  const char * value    = NULL;
+  size_t       filled   = *pFilled;
+  size_t       consumed = 0;
+  ssize_t      n;
+
+  buffer[filled] = '\0';
+  while ( (end = strstr( buffer, "\r\n\r\n" )) == NULL ) {
+    if ( (filled >= _BUFFER_SIZE - 1) || ((n = recv( sock, buffer + filled, _BUFFER_SIZE - 1 - filled, 0 )) <= 0) ) { return false; }
+    filled += n;
+    buffer[filled] = '\0';
+  }
+  end += 4;
+  consumed = end - buffer;
+
+  if ( ((value = _getHeader( buffer, "Expect" )) != NULL) && (strncasecmp( value, "100-continue", 12 ) == 0) ) {
+    _sendAll( sock, _CONTINUE, strlen( _CONTINUE ) );
+  }
+
+  *pBodySize = 0;
+  if ( ((value = _getHeader( buffer, "Transfer-Encoding" )) != NULL) && (strncasecmp( value, "chunked", 7 ) == 0) ) {
+    // Chunks : size in hex, CRLF, data, CRLF ... up to the chunk of size 0 and its CRLF
+    for (;;) {
+      char        * lineEnd;
+      unsigned long chunkSize;
+
+      while ( (lineEnd = strstr( buffer + consumed, "\r\n" )) == NULL ) {
+        if ( (filled >= _BUFFER_SIZE - 1) || ((n = recv( sock, buffer + filled, _BUFFER_SIZE - 1 - filled, 0 )) <= 0) ) { return false; }
+        filled += n;
+        buffer[filled] = '\0';
+      }
+      chunkSize = strtoul( buffer + consumed, NULL, 16 );
+      consumed  = (lineEnd - buffer) + 2;
+      while ( filled < consumed + chunkSize + 2 ) {
+        if ( (filled >= _BUFFER_SIZE - 1) || ((n = recv( sock, buffer + filled, _BUFFER_SIZE - 1 - filled, 0 )) <= 0) ) { return false; }
+        filled += n;
+        buffer[filled] = '\0';
+      }
+      if ( *pBodySize + chunkSize >= _BUFFER_SIZE ) { return false; }
+      memcpy( body + *pBodySize, buffer + consumed, chunkSize );
+      *pBodySize += chunkSize;
+      consumed   += chunkSize + 2;
+      if ( chunkSize == 0 ) { break; }
+    }
+  } else {
+    size_t contentLength = ( (value = _getHeader( buffer, "Content-Length" )) != NULL ? strtoul( value, NULL, 10 ) : 0 );
+
+    if ( contentLength >= _BUFFER_SIZE - consumed ) { return false; }
+    while ( filled < consumed + contentLength ) {
+      if ( (n = recv( sock, buffer + filled, _BUFFER_SIZE - 1 - filled, 0 )) <= 0 ) { return false; }
+      filled += n;
+    }
+    memcpy( body, buffer + consumed, contentLength );
+    *pBodySize = contentLength;
+    consumed  += contentLength;
+  }
+  body[*pBodySize] = '\0';
+
+  // The bytes of the next request are kept
+  memmove( buffer, buffer + consumed, filled - consumed );
+  *pFilled = filled - consumed;
+
+  return true;
+}
+
+/*
+* Answers a POST of the CPE. Returns false at the end of the session.
+*/
+static bool _answer(int sock, const char * body)
+{
+  char         response[_BUFFER_SIZE];
+  char         payload[_BUFFER_SIZE];
+  char         id[16];
+  char         rpc[256];
+  const char * p           = body;
+  size_t       length      = 0;
+  int          nbEnvelopes = 0;
+  int          k;
+
+  _nbPosts++;
+  while ( (p = strstr( p, "</soapenv:Envelope>" )) != NULL ) { nbEnvelopes++; p++; }
+  _nbEnvelopes += nbEnvelopes;
+
+  if ( strstr( body, "<cwmp:Inform>" ) != NULL ) {
+    const char * max = strstr( body, "<MaxEnvelopes>" );
+    _cpeEnvelopes = ( max != NULL ? atoi( max + strlen( "<MaxEnvelopes>" ) ) : 1 );
+    _sessionStart = _now();
+    snprintf( rpc, sizeof(rpc), _INFORM_RESPONSE, _maxEnvelopes );
+    length  = snprintf( payload, sizeof(payload), _ENVELOPE, "inform", rpc );
+    _nextRpc = 0;
+  } else if ( (_nextRpc >= 0) && (_SCRIPT[_nextRpc] != NULL) ) {
+    // Up to the MaxEnvelopes of both sides in one response
+    for ( k=0 ; (k < _maxEnvelopes) && (k < _cpeEnvelopes) && (_SCRIPT[_nextRpc] != NULL) ; k++ ) {
+      snprintf( id, sizeof(id), "r%d", _nextRpc );
+      length += snprintf( payload + length, sizeof(payload) - length, _ENVELOPE, id, _SCRIPT[_nextRpc] );
+      _nextRpc++;
+    }
+  }
+
+  usleep( _rtt * 1000 );
+
+  if ( length == 0 ) {
+    _sendAll( sock, _NO_CONTENT, strlen( _NO_CONTENT ) );
+    return (_nextRpc < 0); // no session yet : a POST before the Inform
+  }
+  k = snprintf( response, sizeof(response), "HTTP/1.1 200 OK\r\nContent-Type: text/xml\r\nContent-Length: %d\r\n\r\n", (int)length );
+  _sendAll( sock, response, k );
+  _sendAll( sock, payload, length );
+
+  return true;
+}
+
+static void _showUsage(const char * name)
+{
+  fprintf( stderr, "Usage: %s [-p port] [-t rttMs] [-e maxEnvelopes]\n", name );
+}
+
+int main(int argc, char * argv[])
+{
+  static char        buffer[_BUFFER_SIZE];
+  static char        body[_BUFFER_SIZE];
+  struct sockaddr_in address;
+  int                port       = 18100;
+  int                listenSock = -1;
+  int                sock       = -1;
+  int                one        = 1;
+  bool               inSession  = true;
+  int                nbRpc      = 0;
+  int                opt;
+
+  while ( (opt = getopt( argc, argv, "p:t:e:" )) != -1 ) {
+    switch ( opt ) {
+      case 'p' : port          = atoi( optarg ); break;
+      case 't' : _rtt          = atoi( optarg ); break;
+      case 'e' : _maxEnvelopes = atoi( optarg ); break;
+      default  : _showUsage( argv[0] ); return 1;
+    }
+  }
+  if ( (optind != argc) || (_rtt < 0) || (_maxEnvelopes <= 0) ) {
+    _showUsage( argv[0] );
+    return 1;
+  }
+  while ( _SCRIPT[nbRpc] != NULL ) { nbRpc++; }
+
+  memset( &address, 0, sizeof(address) );
+  address.sin_family      = AF_INET;
+  address.sin_port        = htons( port );
+  address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  listenSock = socket( AF_INET, SOCK_STREAM, 0 );
+  setsockopt( listenSock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one) );
+  if ( (bind( listenSock, (struct sockaddr *)&address, sizeof(address) ) != 0) || (listen( listenSock, 4 ) != 0) ) {
+    perror( "acs_bench" );
+    return 1;
+  }
+  printf( "ACS on http://127.0.0.1:%d/acs, RTT %d ms, MaxEnvelopes %d, %d RPC\n", port, _rtt, _maxEnvelopes, nbRpc );
+  fflush( stdout );
+
+  // One connection after the other, until the end of the session
+  while ( inSession && ((sock = accept( listenSock, NULL, NULL )) >= 0) ) {
+    size_t filled = 0;
+    size_t bodySize;
+
+    while ( inSession && _readRequest( sock, buffer, &filled, body, &bodySize ) ) {
+      inSession = _answer( sock, body );
+    }
+    close( sock );
+  }
+  close( listenSock );
+
+  printf( "session : %d POSTs, %d envelopes received, %.2f s (MaxEnvelopes of the CPE %d)\n",
+          _nbPosts, _nbEnvelopes, _now() - _sessionStart, _cpeEnvelopes );
+
+  return 0;
+}
@@ -0,0 +1,356 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : cr_auth_bench.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file cr_auth_bench.c
+ *
+ * @brief Benchmark of the authenticated connection requests per second
+ *
+ * Usage: cr_auth_bench [-c clients] [-n requests] [-p cwmpdPid] url username password
+ *
+ * Each client sends its requests one after the other to the connection request URL of a
+ * running cwmpd. Each request is a complete digest handshake, each step on a new connection
+ * as an ACS does it : the request without credentials, the 401 challenge, then the request
+ * with the Authorization header computed from the challenge. The rate, the latency of the
+ * handshakes and the HTTP codes of the second requests are printed. With -p, the CPU time
+ * used by cwmpd for each handshake is printed too.
+ *
+ * The connection requests refused by the rate limitation get 503 : to measure the
+ * authentication alone, raise MaxConnectionRequest in the parameters.csv of cwmpd.
+ *
+ * Example: cr_auth_bench -c 4 -n 500 -p `pidof cwmpd` http://127.0.0.1:50805/abcdef acsuser acspass
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include "CMN_Type_Def.h"
+#include "md5.h"
+
+#define BENCH_BUFFER_SIZE (4096)
+#define BENCH_TOKEN_SIZE  (128)
+
+typedef struct _BenchClient
+{
+  pthread_t   threadId;
+  int         clientIndex;
+  double    * latencies; // ms
+  int         nbOk;      // 200
+  int         nbUnauthorized;
+  int         nbUnavailable;
+  int         nbOthers;  // other codes and transport errors
+
+} BenchClient;
+
+static struct addrinfo * _address    = NULL;
+static char              _host[BENCH_TOKEN_SIZE];
+static char              _path[BENCH_TOKEN_SIZE];
+static const char      * _username   = NULL;
+static const char      * _password   = NULL;
+static int               _nbRequests = 100;
+
+static double _now()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/*
+* CPU time (user + system) used by the process, in seconds. -1 if it can not be read.
+*/
+static double _processCpuTime(int pid)
+{
+  char            path[64];
+  char            stat[1024];
+  char          * p     = NULL;
+  FILE          * f     = NULL;
+  unsigned long   utime = 0;
+  unsigned long   stime = 0;
+  size_t          n     = 0;
+
+  snprintf( path, sizeof(path), "/proc/%d/stat", pid );
+  if ( (f = fopen( path, "r" )) == NULL ) { return -1; }
+  n = fread( stat, 1, sizeof(stat)-1, f );
+  fclose( f );
+  stat[n] = '\0';
+
+  // The fields after the command name (which may hold blanks) : utime and stime are the 12th and 13th
+  if ( ((p = strrchr( stat, ')' )) == NULL)
+    || (sscanf( p+1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime ) != 2) ) { return -1; }
+
+  return (double)(utime + stime) / (double)sysconf( _SC_CLK_TCK );
+}
+
+/*
+* Splits the url http://host:port/path. Returns false if it is not a valid http url.
+*/
+static bool _parseUrl(const char * url, char ** port)
+{
+  static char   portStr[16];
+  const char  * hostStart = NULL;
+  const char  * pathStart = NULL;
+  const char  * portStart = NULL;
+
+  if ( strncmp( url, "http://", 7 ) != 0 ) { return false; }
+  hostStart = url + 7;
+  if ( (pathStart = strchr( hostStart, '/' )) == NULL ) { pathStart = hostStart + strlen( hostStart ); }
+  if ( ((portStart = memchr( hostStart, ':', pathStart - hostStart )) == NULL) ) { portStart = pathStart; }
+  if ( (portStart == hostStart) || (portStart - hostStart >= BENCH_TOKEN_SIZE)
+    || (pathStart - portStart >= (int)sizeof(portStr)) || (strlen( pathStart ) >= BENCH_TOKEN_SIZE - 1) ) { return false; }
+
+  snprintf( _host, sizeof(_host), "%.*s", (int)(portStart - hostStart), hostStart );
+  if ( portStart < pathStart ) {
+    snprintf( portStr, sizeof(portStr), "%.*s", (int)(pathStart - portStart - 1), portStart + 1 );
+  } else {
+    strcpy( portStr, "80" );
+  }
+  snprintf( _path, sizeof(_path), "%s", (*pathStart == '\0' ? "/" : pathStart) );
+  *port = portStr;
+
+  return true;
+}
+
+/*
+* Sends the request on a new connection and reads the response until the server closes it.
+* Returns the HTTP code of the response (0 on a transport error).
+*/
+static int _exchange(const char * request, char * response, size_t responseSize)
+{
+  size_t  received = 0;
+  ssize_t n;
+  int     code     = 0;
+  int     sock     = socket( _address->ai_family, SOCK_STREAM, 0 );
+
+  if ( sock < 0 ) { return 0; }
+  if ( (connect( sock, _address->ai_addr, _address->ai_addrlen ) == 0)
+    && (send( sock, request, strlen( request ), MSG_NOSIGNAL ) == (ssize_t)strlen( request )) ) {
+    while ( (received < responseSize - 1)
+         && ((n = recv( sock, response + received, responseSize - 1 - received, 0 )) > 0) ) {
+      received += n;
+    }
+  }
+  close( sock );
+  response[received] = '\0';
+
+  if ( sscanf( response, "HTTP/1.%*d %d", &code ) != 1 ) { code = 0; }
+  return code;
+}
+
+/*
+* Copies the value of the quoted field name="value" of the challenge. Returns false if not found.
+*/
+static bool _getChallengeField(const char * challenge, const char * name, char * value)
+{
+  char         pattern[32];
+  const char * start = NULL;
+  const char * end   = NULL;
+
+  snprintf( pattern, sizeof(pattern), "%s=\"", name );
+  if ( ((start = strstr( challenge, pattern )) == NULL)
+    || ((end = strchr( start += strlen( pattern ), '"' )) == NULL)
+    || (end - start >= BENCH_TOKEN_SIZE) ) { return false; }
+  snprintf( value, BENCH_TOKEN_SIZE, "%.*s", (int)(end - start), start );
+
+  return true;
+}
+
+static void _md5Hex(const char * str, char * hex)
+{
+  MD5_CTX       ctx;
+  unsigned char signature[16];
+
+  MD5_Init( &ctx );
+  MD5_Update( &ctx, str, strlen( str ) );
+  MD5_Final( signature, &ctx );
+  getStringResult( signature, hex );
+}
+
+/*
+* One digest handshake. Returns the HTTP code of the authenticated request (0 on error).
+*/
+static int _handshake(int clientIndex, int requestIndex)
+{
+  char response[BENCH_BUFFER_SIZE];
+  char request[BENCH_BUFFER_SIZE];
+  char realm[BENCH_TOKEN_SIZE];
+  char nonce[BENCH_TOKEN_SIZE];
+  char opaque[BENCH_TOKEN_SIZE];
+  char cnonce[BENCH_TOKEN_SIZE];
+  char a[BENCH_BUFFER_SIZE];
+  char ha1[33];
+  char ha2[33];
+  char digest[33];
+  int  code;
+
+  snprintf( request, sizeof(request), "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n", _path, _host );
+  code = _exchange( request, response, sizeof(response) );
+  if ( code != 401 ) { return code; }
+  if ( !_getChallengeField( response, "realm", realm ) || !_getChallengeField( response, "nonce", nonce )
+    || !_getChallengeField( response, "opaque", opaque ) ) { return 0; }
+
+  snprintf( cnonce, sizeof(cnonce), "%08x", (unsigned int)(clientIndex * _nbRequests + requestIndex) );
+  snprintf( a, sizeof(a), "%s:%s:%s", _username, realm, _password );
+  _md5Hex( a, ha1 );
+  snprintf( a, sizeof(a), "GET:%s", _path );
+  _md5Hex( a, ha2 );
+  snprintf( a, sizeof(a), "%s:%s:00000001:%s:auth:%s", ha1, nonce, cnonce, ha2 );
+  _md5Hex( a, digest );
+
+  snprintf( request, sizeof(request),
+            "GET %s HTTP/1.1\r\nHost: %s\r\n"
+            "Authorization: Digest username=\"%s\", realm=\"%s\", nonce=\"%s\", uri=\"%s\", response=\"%s\", "
+            "opaque=\"%s\", qop=auth, nc=00000001, cnonce=\"%s\"\r\n\r\n",
+            _path, _host, _username, realm, nonce, _path, digest, opaque, cnonce );
+
+  return _exchange( request, response, sizeof(response) );
+}
+
+static void * _runClient(void * data)
+{
+  BenchClient * client = (BenchClient *)data;
+  int           i;
+
+  for ( i=0 ; i<_nbRequests ; i++ ) {
+    double t0   = _now();
+    int    code = _handshake( client->clientIndex, i );
+
+    client->latencies[i] = (_now() - t0) * 1000.0;
+
+    switch ( code ) {
+      case 200 : client->nbOk++;           break;
+      case 401 : client->nbUnauthorized++; break;
+      case 503 : client->nbUnavailable++;  break;
+      default  : client->nbOthers++;       break;
+    }
+  }
+
+  return NULL;
+}
+
+static int _compareDoubles(const void * a, const void * b)
+{
+  double d = *(const double *)a - *(const double *)b;
+  return (d < 0 ? -1 : (d > 0 ? 1 : 0));
+}
+
+static void _showUsage(const char * name)
+{
+  fprintf( stderr, "Usage: %s [-c clients] [-n requests] [-p cwmpdPid] url username password\n", name );
+}
+
+int main(int argc, char * argv[])
+{
+  BenchClient     * clients        = NULL;
+  double          * latencies      = NULL;
+  int               nbClients      = 1;
+  int               pid            = 0;
+  int               nbTotal        = 0;
+  int               nbOk           = 0;
+  int               nbUnauthorized = 0;
+  int               nbUnavailable  = 0;
+  int               nbOthers       = 0;
+  double            cpu0           = 0;
+  double            cpu1           = 0;
+  double            t0             = 0;
+  double            elapsed        = 0;
+  char            * port           = NULL;
+  struct addrinfo   hints;
+  int               opt;
+  int               i;
+
+  memset( &hints, 0, sizeof(hints) );
+  hints.ai_socktype = SOCK_STREAM;
+
+  while ( (opt = getopt( argc, argv, "c:n:p:" )) != -1 ) {
+    switch ( opt ) {
+      case 'c' : nbClients   = atoi( optarg ); break;
+      case 'n' : _nbRequests = atoi( optarg ); break;
+      case 'p' : pid         = atoi( optarg ); break;
+      default  : _showUsage( argv[0] ); return 1;
+    }
+  }
+  if ( (argc - optind != 3) || (nbClients <= 0) || (_nbRequests <= 0) ) {
+    _showUsage( argv[0] );
+    return 1;
+  }
+  _username = argv[optind+1];
+  _password = argv[optind+2];
+  if ( !_parseUrl( argv[optind], &port ) ) {
+    fprintf( stderr, "Invalid url: %s\n", argv[optind] );
+    return 1;
+  }
+  if ( getaddrinfo( _host, port, &hints, &_address ) != 0 ) {
+    fprintf( stderr, "Unknown host: %s\n", _host );
+    return 1;
+  }
+
+  clients = (BenchClient *)calloc( nbClients, sizeof(BenchClient) );
+  for ( i=0 ; i<nbClients ; i++ ) {
+    clients[i].clientIndex = i;
+    clients[i].latencies = (double *)calloc( _nbRequests, sizeof(double) );
+  }
+
+  if ( pid != 0 ) { cpu0 = _processCpuTime( pid ); }
+  t0 = _now();
+  for ( i=0 ; i<nbClients ; i++ ) {
+    pthread_create( &clients[i].threadId, NULL, _runClient, &clients[i] );
+  }
+  for ( i=0 ; i<nbClients ; i++ ) {
+    pthread_join( clients[i].threadId, NULL );
+  }
+  elapsed = _now() - t0;
+  if ( pid != 0 ) { cpu1 = _processCpuTime( pid ); }
+
+  nbTotal   = nbClients * _nbRequests;
+  latencies = (double *)malloc( nbTotal * sizeof(double) );
+  for ( i=0 ; i<nbClients ; i++ ) {
+    memcpy( latencies + i*_nbRequests, clients[i].latencies, _nbRequests * sizeof(double) );
+    nbOk           += clients[i].nbOk;
+    nbUnauthorized += clients[i].nbUnauthorized;
+    nbUnavailable  += clients[i].nbUnavailable;
+    nbOthers       += clients[i].nbOthers;
+    free( clients[i].latencies );
+  }
+  qsort( latencies, nbTotal, sizeof(double), _compareDoubles );
+
+  printf( "clients %d, handshakes %d : %.0f per second, p50 %.2f ms, p99 %.2f ms\n",
+          nbClients, nbTotal, nbTotal / elapsed, latencies[nbTotal/2], latencies[(nbTotal*99)/100] );
+  printf( "200 : %d, 401 : %d, 503 : %d, others : %d\n", nbOk, nbUnauthorized, nbUnavailable, nbOthers );
+  if ( (pid != 0) && (cpu0 >= 0) && (cpu1 >= 0) ) {
+    printf( "cwmpd CPU : %.1f us per handshake\n", (cpu1 - cpu0) * 1000000.0 / nbTotal );
+  }
+
+  free( latencies );
+  free( clients );
+  freeaddrinfo( _address );
+
+  return (nbOthers == 0 ? 0 : 1);
+}
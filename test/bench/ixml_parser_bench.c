@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : ixml_parser_bench.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file ixml_parser_bench.c
+ *
+ * @brief Throughput of the ixml parser on recorded CWMP messages
+ *
+ * Usage: ixml_parser_bench [-i iterations] [-d] file...
+ *
+ * The files (test/data/cwmp : the RPC of a scripted ACS and the messages of the agent) are
+ * parsed again and again in arena mode, as DM_COM does it, and the throughput is printed.
+ * With -d, each file is parsed once and its result is dumped instead (return code and
+ * serialized document).
+ *
+ * The program is built twice : with the vector scanning of ixmlscan.c, and with its byte
+ * loops only (IXML_SCAN_SCALAR). 'make bench' runs both on the same files and compares
+ * their dumps.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include "ixml.h"
+
+#ifdef IXML_SCAN_SCALAR
+#define _SCAN_MODE "scalar"
+#else
+#define _SCAN_MODE "vector"
+#endif
+
+static double _now()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/*
+* Reads the whole file in a null terminated buffer. NULL on error.
+*/
+static char * _readFile(const char * fileName,
+                        size_t     * pSize)
+{
+  FILE * f      = fopen( fileName, "rb" );
+  char * buffer = NULL;
+  long   size;
+
+  if ( f == NULL ) { return NULL; }
+  if ( (fseek( f, 0, SEEK_END ) == 0) && ((size = ftell( f )) >= 0) && (fseek( f, 0, SEEK_SET ) == 0) ) {
+    buffer = (char*)malloc( size + 1 );
+    if ( fread( buffer, 1, size, f ) != (size_t)size ) {
+      free( buffer );
+      buffer = NULL;
+    } else {
+      buffer[size] = '\0';
+      *pSize = (size_t)size;
+    }
+  }
+  fclose( f );
+
+  return buffer;
+}
+
+static void _dump(const char * fileName,
+                  const char * buffer)
+{
+  IXML_Document * doc = NULL;
+  DOMString       str = NULL;
+  int             rc  = ixmlParseBufferArenaEx( buffer, &doc );
+
+  printf( "%s rc=%d\n", fileName, rc );
+  if ( doc != NULL ) {
+    if ( (str = ixmlDocumenttoString( doc )) != NULL ) {
+      printf( "%s\n", str );
+      ixmlFreeDOMString( str );
+    }
+    ixmlDocument_free( doc );
+  }
+}
+
+static void _showUsage(const char * name)
+{
+  fprintf( stderr, "Usage: %s [-i iterations] [-d] file...\n", name );
+}
+
+int main(int argc, char * argv[])
+{
+  char  ** buffers      = NULL;
+  size_t   nbBytes      = 0;
+  int      nbFiles      = 0;
+  int      nbIterations = 2000;
+  int      nbErrors     = 0;
+  BOOL     dump         = FALSE;
+  double   elapsed      = 0;
+  int      opt;
+  int      i;
+  int      k;
+
+  while ( (opt = getopt( argc, argv, "i:d" )) != -1 ) {
+    switch ( opt ) {
+      case 'i' : nbIterations = atoi( optarg ); break;
+      case 'd' : dump         = TRUE;           break;
+      default  : _showUsage( argv[0] ); return 1;
+    }
+  }
+  nbFiles = argc - optind;
+  if ( (nbFiles <= 0) || (nbIterations <= 0) ) {
+    _showUsage( argv[0] );
+    return 1;
+  }
+
+  buffers = (char**)calloc( nbFiles, sizeof(char*) );
+  for ( i=0 ; i<nbFiles ; i++ ) {
+    size_t size = 0;
+    if ( (buffers[i] = _readFile( argv[optind+i], &size )) == NULL ) {
+      fprintf( stderr, "Can not read %s\n", argv[optind+i] );
+      return 1;
+    }
+    nbBytes += size;
+  }
+
+  if ( dump ) {
+    for ( i=0 ; i<nbFiles ; i++ ) { _dump( argv[optind+i], buffers[i] ); }
+  } else {
+    // The first pass is not timed (cache and allocator warm-up)
+    for ( k=-1 ; k<nbIterations ; k++ ) {
+      if ( k == 0 ) { elapsed = _now(); }
+      for ( i=0 ; i<nbFiles ; i++ ) {
+        IXML_Document * doc = NULL;
+        if ( ixmlParseBufferArenaEx( buffers[i], &doc ) != IXML_SUCCESS ) {
+          if ( k < 0 ) { fprintf( stderr, "Can not parse %s\n", argv[optind+i] ); }
+          nbErrors++;
+        }
+        if ( doc != NULL ) { ixmlDocument_free( doc ); }
+      }
+    }
+    elapsed = _now() - elapsed;
+
+    printf( "%s : %d files, %d bytes, %d iterations : %.1f MB/s, %.2f us per file\n",
+            _SCAN_MODE, nbFiles, (int)nbBytes, nbIterations,
+            (double)nbBytes * nbIterations / elapsed / 1000000.0, elapsed * 1000000.0 / nbIterations / nbFiles );
+  }
+
+  for ( i=0 ; i<nbFiles ; i++ ) { free( buffers[i] ); }
+  free( buffers );
+
+  return (nbErrors == 0 ? 0 : 1);
+}
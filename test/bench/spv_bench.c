@@ -0,0 +1,233 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : spv_bench.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file spv_bench.c
+ *
+ * @brief Benchmark of a SetParameterValues RPC setting many parameters
+ *
+ * Usage: spv_bench [-n parameters] [-r runs] rscDirectory
+ *
+ * A data directory is made from the parameters.csv of rscDirectory (rsc of the agent), with
+ * 2 x parameters writable parameters X_ORANGE-COM_Bench.<i>.Value added, and the parameter
+ * manager of DM_ENGINE is initialized from it. Then each run gives one SetParameterValues
+ * envelope of the given number of parameters (5000 by default) to DM_HttpCallbackClientData(),
+ * as received from the ACS : the RPC is read by DM_COM, the values are checked, set, committed
+ * and saved by DM_ENGINE, and the response is built. The time of each run is printed, with the
+ * time spent in DM_ENG_SetParameterValues(), wrapped at link time (-Wl,--wrap) as is
+ * DM_SendHttpMessageBuffer() to count the responses without any ACS.
+ *
+ * Example (from the root of the agent): obj/test/spv_bench -n 5000 -r 5 rsc
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+#include "dm_com.h"
+#include "DM_ENG_RPCInterface.h"
+#include "DM_ENG_ParameterBackInterface.h"
+#include "DM_ENG_ParameterData.h"
+#include "DM_GlobalDefs.h"
+#include "DM_COM_GenericHttpClientInterface.h"
+
+#define _BENCH_OBJECT "X_ORANGE-COM_Bench."
+
+static const char * _ENVELOPE_BEGIN =
+  "<soapenv:Envelope xmlns:soapenv=\"http://schemas.xmlsoap.org/soap/envelope/\""
+  " xmlns:soapenc=\"http://schemas.xmlsoap.org/soap/encoding/\" xmlns:xsd=\"http://www.w3.org/2001/XMLSchema\""
+  " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xmlns:cwmp=\"urn:dslforum-org:cwmp-1-0\">"
+  "<soapenv:Header><cwmp:ID soapenv:mustUnderstand=\"1\">spv%d</cwmp:ID></soapenv:Header>"
+  "<soapenv:Body><cwmp:SetParameterValues><ParameterList soapenc:arrayType=\"cwmp:ParameterValueStruct[%d]\">";
+
+static const char * _ENVELOPE_END =
+  "</ParameterList><ParameterKey>spv%d</ParameterKey></cwmp:SetParameterValues></soapenv:Body></soapenv:Envelope>";
+
+// The parameters set are spread over the bench object, their values change at each run
+static const char * _PARAMETER =
+  "<ParameterValueStruct><Name>" DM_PREFIX _BENCH_OBJECT "%d.Value</Name>"
+  "<Value xsi:type=\"xsd:string\">value-%d-%d</Value></ParameterValueStruct>";
+
+static double _engineTime  = 0; // s
+static int    _nbResponses = 0;
+static int    _lastResult  = 0;
+
+int __real_DM_ENG_SetParameterValues(DM_ENG_EntityType entity, DM_ENG_ParameterValueStruct* parameterList[], char* parameterKey, OUT DM_ENG_ParameterStatus* pStatus, OUT DM_ENG_SetParameterValuesFault** pFaults[]);
+
+static double _now()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+int __wrap_DM_ENG_SetParameterValues(DM_ENG_EntityType                  entity,
+                                     DM_ENG_ParameterValueStruct      * parameterList[],
+                                     char                             * parameterKey,
+                                     OUT DM_ENG_ParameterStatus       * pStatus,
+                                     OUT DM_ENG_SetParameterValuesFault ** pFaults[])
+{
+  double t0 = _now();
+
+  _lastResult  = __real_DM_ENG_SetParameterValues( entity, parameterList, parameterKey, pStatus, pFaults );
+  _engineTime += _now() - t0;
+
+  return _lastResult;
+}
+
+int __wrap_DM_SendHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr UNUSED)
+{
+  _nbResponses++;
+  return DM_OK;
+}
+
+/*
+* Makes the data directory : parameters.csv of the agent, followed by the bench parameters
+*/
+static bool _makeDataDirectory(const char * rscDirectory,
+                               char       * dataDirectory,
+                               int          nbParameters)
+{
+  char   path[256];
+  char   line[512];
+  FILE * in  = NULL;
+  FILE * out = NULL;
+  int    i;
+
+  strcpy( dataDirectory, "/tmp/spv_bench.XXXXXX" );
+  if ( mkdtemp( dataDirectory ) == NULL ) { return false; }
+
+  snprintf( path, sizeof(path), "%s/parameters.csv", rscDirectory );
+  if ( (in = fopen( path, "r" )) == NULL ) { return false; }
+  snprintf( path, sizeof(path), "%s/parameters.csv", dataDirectory );
+  if ( (out = fopen( path, "w" )) == NULL ) { fclose( in ); return false; }
+
+  while ( fgets( line, sizeof(line), in ) != NULL ) { fputs( line, out ); }
+  fprintf( out, "%s;ANY;0;0;0;0;0;0;;;0;0\n", _BENCH_OBJECT );
+  for ( i=1 ; i<=2*nbParameters ; i++ ) {
+    fprintf( out, "%s%d.;ANY;0;0;0;0;0;0;;;0;0\n", _BENCH_OBJECT, i );
+    fprintf( out, "%s%d.Value;STRING;0;1;1;0;0;0;;;0;0\n", _BENCH_OBJECT, i );
+  }
+
+  fclose( in );
+  fclose( out );
+  return true;
+}
+
+static void _removeDataDirectory(const char * dataDirectory)
+{
+  static const char * files[] = { "parameters.csv", "parameters.data", "parameters.data~", "dm_control.data", "statistics.data", "statistics.data~", NULL };
+  char path[256];
+  int  i;
+
+  for ( i=0 ; files[i]!=NULL ; i++ ) {
+    snprintf( path, sizeof(path), "%s/%s", dataDirectory, files[i] );
+    unlink( path );
+  }
+  rmdir( dataDirectory );
+}
+
+/*
+* Builds the SetParameterValues envelope of the run : every other bench parameter, from the run-th one
+*/
+static char * _buildMessage(int run,
+                            int nbParameters)
+{
+  size_t capacity = strlen( _ENVELOPE_BEGIN ) + strlen( _ENVELOPE_END ) + 64 + nbParameters * (strlen( _PARAMETER ) + 40);
+  char * message  = (char*)malloc( capacity );
+  size_t length   = snprintf( message, capacity, _ENVELOPE_BEGIN, run, nbParameters );
+  int    i;
+
+  for ( i=0 ; i<nbParameters ; i++ ) {
+    length += snprintf( message + length, capacity - length, _PARAMETER, 2*i + 1 + run%2, run, i );
+  }
+  snprintf( message + length, capacity - length, _ENVELOPE_END, run );
+
+  return message;
+}
+
+static void _showUsage(const char * name)
+{
+  fprintf( stderr, "Usage: %s [-n parameters] [-r runs] rscDirectory\n", name );
+}
+
+int main(int argc, char * argv[])
+{
+  char   dataDirectory[64];
+  char * message      = NULL;
+  int    nbParameters = 5000;
+  int    nbRuns       = 5;
+  int    nbFailures   = 0;
+  double t0           = 0;
+  int    opt;
+  int    run;
+
+  while ( (opt = getopt( argc, argv, "n:r:" )) != -1 ) {
+    switch ( opt ) {
+      case 'n' : nbParameters = atoi( optarg ); break;
+      case 'r' : nbRuns       = atoi( optarg ); break;
+      default  : _showUsage( argv[0] ); return 1;
+    }
+  }
+  if ( (argc - optind != 1) || (nbParameters <= 0) || (nbRuns <= 0) ) {
+    _showUsage( argv[0] );
+    return 1;
+  }
+
+  if ( !_makeDataDirectory( argv[optind], dataDirectory, nbParameters ) ) {
+    fprintf( stderr, "Can not make the data directory from %s\n", argv[optind] );
+    return 1;
+  }
+  t0 = _now();
+  if ( DM_ENG_ParameterManager_init( dataDirectory, DM_ENG_InitLevel_FACTORY_RESET ) != 0 ) {
+    fprintf( stderr, "Can not initialize the parameter manager\n" );
+    _removeDataDirectory( dataDirectory );
+    return 1;
+  }
+  printf( "%d parameters loaded in %.1f ms\n", DM_ENG_ParameterData_getNumberOfParameters(), (_now() - t0) * 1000.0 );
+
+  for ( run=0 ; run<nbRuns ; run++ ) {
+    size_t length;
+
+    message      = _buildMessage( run, nbParameters );
+    length       = strlen( message );
+    _engineTime  = 0;
+    _nbResponses = 0;
+    _lastResult  = -1;
+
+    t0 = _now();
+    if ( DM_HttpCallbackClientData( message, length ) != length ) { _lastResult = -1; }
+    printf( "run %d, %d parameters (%d KB) : %.1f ms, DM_ENG_SetParameterValues %.1f ms, result %d, responses %d\n",
+            run, nbParameters, (int)(length / 1024), (_now() - t0) * 1000.0, _engineTime * 1000.0, _lastResult, _nbResponses );
+    if ( (_lastResult != 0) || (_nbResponses != 1) ) { nbFailures++; }
+
+    free( message );
+  }
+
+  _removeDataDirectory( dataDirectory );
+
+  return (nbFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,360 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : cr_load_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file cr_load_test.c
+ *
+ * @brief Load test of the connection request HTTP server
+ *
+ * Usage: cr_load_test [-s silent] [-w slow] [-c clients] [-n requests]
+ *
+ * DM_HttpServer_Start() runs in a thread of the test, on CPE_PORT of the loopback. The digest
+ * authentication and DM_ENG_RequestConnection() are wrapped at link time (-Wl,--wrap), as is
+ * DM_ENG_GetParameterValues() to give a connection request policy which never refuses.
+ *
+ * First, MAX_HTTP_SERVER_CONNECTIONS silent connections are opened : one more client must get
+ * a 503, and the silent ones must be dropped after HTTP_SERVER_REQUEST_TIMEOUT. Then the given
+ * number of silent connections, and of slow ones sending their request one byte at a time, are
+ * kept open (opened again when dropped) while the clients send their connection requests, one
+ * every _CLIENT_PERIOD ms (the default run lasts longer than the request timeout). The p50 and
+ * p99 latencies of the connection requests are printed, all of them must succeed within half
+ * the request timeout.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "DM_GlobalDefs.h"
+#include "DM_COM_GenericHttpServerInterface.h"
+#include "dm_com_digest.h"
+#include "DM_ENG_RPCInterface.h"
+#include "DM_ENG_ParameterValueStruct.h"
+
+#define _START_TIMEOUT  (5000) // ms
+#define _SLOW_PERIOD    (200)  // ms between two bytes of a slow connection
+#define _CLIENT_PERIOD  (10)   // ms between two connection requests of a client
+
+static const char * _REQUEST =
+  "GET /cr HTTP/1.1\r\nHost: 127.0.0.1\r\n"
+  "Authorization: Digest username=\"cpe\", realm=\"load\", nonce=\"0\", uri=\"/cr\", response=\"0\"\r\n\r\n";
+
+extern dm_com_struct g_DmComData;
+
+static volatile bool _serverStarted = false;
+static volatile bool _stopHolders   = false;
+static int           _nbFailures    = 0;
+
+// Latencies (ms) of the connection requests of the clients
+static double      * _latencies     = NULL;
+static int           _nbRequests    = 0;
+static int           _nbBadCodes    = 0;
+static int           _nbDropped     = 0;   // Drops of the silent and slow connections by the server
+static pthread_mutex_t _mutex       = PTHREAD_MUTEX_INITIALIZER;
+
+void __wrap_DM_HttpServerStarted()
+{
+  _serverStarted = true;
+}
+
+int __wrap_DM_ENG_RequestConnection(DM_ENG_EntityType entity UNUSED)
+{
+  return 0;
+}
+
+bool __wrap__checkDigestAuthMessageContent(const char * str UNUSED)
+{
+  return true;
+}
+
+bool __wrap_performClientDigestAuthentication(const char * str UNUSED)
+{
+  return true;
+}
+
+/*
+* Policy of the connection requests : the load is far from its limit
+*/
+int __wrap_DM_ENG_GetParameterValues(DM_ENG_EntityType             entity UNUSED,
+                                     char                        * parameterNames[],
+                                     OUT DM_ENG_ParameterValueStruct ** pResult[])
+{
+  *pResult = DM_ENG_newTabParameterValueStruct( 2 );
+  (*pResult)[0] = DM_ENG_newParameterValueStruct( parameterNames[0], DM_ENG_ParameterType_UINT, "1000000" );
+  (*pResult)[1] = DM_ENG_newParameterValueStruct( parameterNames[1], DM_ENG_ParameterType_UINT, "1" );
+  return 0;
+}
+
+static double _nowMs()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static int _connectToServer()
+{
+  struct sockaddr_in address;
+  int                sock = socket( AF_INET, SOCK_STREAM, 0 );
+
+  memset( &address, 0, sizeof(address) );
+  address.sin_family      = AF_INET;
+  address.sin_port        = htons( CPE_PORT );
+  address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  if ( (sock != -1) && (connect( sock, (struct sockaddr *)&address, sizeof(address) ) != 0) ) {
+    close( sock );
+    sock = -1;
+  }
+  return sock;
+}
+
+/*
+* Waits until the server closes the connection. Returns false after timeout ms.
+*/
+static bool _waitClosed(int sock, int timeout)
+{
+  struct pollfd pfd;
+  char          buffer[256];
+
+  pfd.fd     = sock;
+  pfd.events = POLLIN;
+  while ( poll( &pfd, 1, timeout ) > 0 ) {
+    if ( recv( sock, buffer, sizeof(buffer), 0 ) <= 0 ) { return true; }
+  }
+  return false;
+}
+
+/*
+* Sends a connection request and reads the response up to the close of the connection.
+* Returns the HTTP code of the response (0 on error).
+*/
+static int _connectionRequest()
+{
+  char buffer[SIZE_HTTP_MSG];
+  int  length = 0;
+  int  code   = 0;
+  int  sock   = _connectToServer();
+  int  n;
+
+  if ( sock == -1 ) { return 0; }
+  if ( send( sock, _REQUEST, strlen( _REQUEST ), MSG_NOSIGNAL ) == (ssize_t)strlen( _REQUEST ) ) {
+    while ( (length < (int)sizeof(buffer) - 1) && ((n = recv( sock, buffer + length, sizeof(buffer) - 1 - length, 0 )) > 0) ) {
+      length += n;
+    }
+    buffer[length] = '\0';
+    if ( sscanf( buffer, "HTTP/1.%*d %d", &code ) != 1 ) { code = 0; }
+  }
+  close( sock );
+
+  return code;
+}
+
+/*
+* Keeps a silent (arg NULL) or slow connection open until the end of the test
+*/
+static void * _holder(void * slow)
+{
+  while ( !_stopHolders ) {
+    int    sock = _connectToServer();
+    size_t sent = 0;
+
+    if ( sock == -1 ) { usleep( _SLOW_PERIOD * 1000 ); continue; }
+    for (;;) {
+      if ( _waitClosed( sock, _SLOW_PERIOD ) ) {
+        pthread_mutex_lock( &_mutex );
+        _nbDropped++;
+        pthread_mutex_unlock( &_mutex );
+        break;
+      }
+      if ( _stopHolders ) { break; }
+      // A slow client never sends the end of its header
+      if ( (slow != NULL) && (sent < strlen( _REQUEST ) - 2) ) {
+        send( sock, _REQUEST + sent, 1, MSG_NOSIGNAL );
+        sent++;
+      }
+    }
+    close( sock );
+  }
+  return NULL;
+}
+
+static void * _client(void * arg)
+{
+  int nb = *(int*)arg;
+  int i;
+
+  for ( i=0 ; i<nb ; i++ ) {
+    double t0   = _nowMs();
+    int    code = _connectionRequest();
+
+    pthread_mutex_lock( &_mutex );
+    _latencies[_nbRequests++] = _nowMs() - t0;
+    if ( code != atoi( HTTP_CODE_OK ) ) { _nbBadCodes++; }
+    pthread_mutex_unlock( &_mutex );
+    usleep( _CLIENT_PERIOD * 1000 );
+  }
+  return NULL;
+}
+
+static int _compareLatencies(const void * a, const void * b)
+{
+  double d = *(const double*)a - *(const double*)b;
+  return (d < 0 ? -1 : (d > 0 ? 1 : 0));
+}
+
+static void _report(const char * testName,
+                    bool         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+/*
+* All the connection slots used by silent clients : one more client gets a 503, then the silent
+* ones are dropped at their deadline
+*/
+static void _testAllSlotsUsed()
+{
+  int    socks[MAX_HTTP_SERVER_CONNECTIONS];
+  int    nbClosed = 0;
+  double t0       = _nowMs();
+  double elapsed;
+  char   testName[128];
+  int    code;
+  int    i;
+
+  for ( i=0 ; i<MAX_HTTP_SERVER_CONNECTIONS ; i++ ) { socks[i] = _connectToServer(); }
+  usleep( 200 * 1000 ); // accepted by the server
+  code = _connectionRequest();
+  snprintf( testName, sizeof(testName), "connection request with %d silent connections : %d", MAX_HTTP_SERVER_CONNECTIONS, code );
+  _report( testName, code == atoi( HTTP_CODE_SVR_BUSY ) );
+
+  for ( i=0 ; i<MAX_HTTP_SERVER_CONNECTIONS ; i++ ) {
+    if ( (socks[i] != -1) && _waitClosed( socks[i], HTTP_SERVER_REQUEST_TIMEOUT + HTTP_SERVER_POLL_PERIOD ) ) { nbClosed++; }
+  }
+  elapsed = _nowMs() - t0;
+  snprintf( testName, sizeof(testName), "%d silent connections dropped after %.0f ms", nbClosed, elapsed );
+  _report( testName, (nbClosed == MAX_HTTP_SERVER_CONNECTIONS) && (elapsed >= HTTP_SERVER_REQUEST_TIMEOUT)
+                     && (elapsed < HTTP_SERVER_REQUEST_TIMEOUT + HTTP_SERVER_POLL_PERIOD) );
+  for ( i=0 ; i<MAX_HTTP_SERVER_CONNECTIONS ; i++ ) { if ( socks[i] != -1 ) { close( socks[i] ); } }
+}
+
+/*
+* Connection requests of the clients while silent and slow connections are kept open
+*/
+static void _testLatency(int nbSilent,
+                         int nbSlow,
+                         int nbClients,
+                         int nbRequestsPerClient)
+{
+  pthread_t * holders = (pthread_t*)calloc( nbSilent + nbSlow, sizeof(pthread_t) );
+  pthread_t * clients = (pthread_t*)calloc( nbClients, sizeof(pthread_t) );
+  double      p50;
+  double      p99;
+  double      t0;
+  char        testName[192];
+  int         i;
+
+  _latencies = (double*)calloc( nbClients * nbRequestsPerClient, sizeof(double) );
+  for ( i=0 ; i<nbSilent+nbSlow ; i++ ) { pthread_create( &holders[i], NULL, _holder, (i < nbSilent ? NULL : (void*)1) ); }
+  usleep( 200 * 1000 );
+
+  t0 = _nowMs();
+  for ( i=0 ; i<nbClients ; i++ ) { pthread_create( &clients[i], NULL, _client, &nbRequestsPerClient ); }
+  for ( i=0 ; i<nbClients ; i++ ) { pthread_join( clients[i], NULL ); }
+  t0 = _nowMs() - t0;
+
+  _stopHolders = true;
+  for ( i=0 ; i<nbSilent+nbSlow ; i++ ) { pthread_join( holders[i], NULL ); }
+
+  qsort( _latencies, _nbRequests, sizeof(double), _compareLatencies );
+  p50 = _latencies[_nbRequests * 50 / 100];
+  p99 = _latencies[_nbRequests * 99 / 100];
+  printf( "%d silent and %d slow connections (%d drops), %d clients : %d connection requests in %.0f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+          nbSilent, nbSlow, _nbDropped, nbClients, _nbRequests, t0, p50, p99, _latencies[_nbRequests-1] );
+
+  snprintf( testName, sizeof(testName), "connection requests beside silent and slow connections : %d not accepted", _nbBadCodes );
+  _report( testName, (_nbBadCodes == 0) && (p99 < HTTP_SERVER_REQUEST_TIMEOUT / 2) );
+
+  free( _latencies );
+  free( holders );
+  free( clients );
+}
+
+static void _showUsage(const char * name)
+{
+  fprintf( stderr, "Usage: %s [-s silent] [-w slow] [-c clients] [-n requests]\n", name );
+}
+
+int main(int argc, char * argv[])
+{
+  pthread_t server;
+  int       nbSilent   = 6;
+  int       nbSlow     = 6;
+  int       nbClients  = 4;
+  int       nbRequests = 250;
+  double    t0;
+  int       opt;
+
+  while ( (opt = getopt( argc, argv, "s:w:c:n:" )) != -1 ) {
+    switch ( opt ) {
+      case 's' : nbSilent   = atoi( optarg ); break;
+      case 'w' : nbSlow     = atoi( optarg ); break;
+      case 'c' : nbClients  = atoi( optarg ); break;
+      case 'n' : nbRequests = atoi( optarg ); break;
+      default  : _showUsage( argv[0] ); return 1;
+    }
+  }
+  // The clients must always find a free slot
+  if ( (optind != argc) || (nbSilent < 0) || (nbSlow < 0) || (nbClients <= 0) || (nbRequests <= 0)
+    || (nbSilent + nbSlow + nbClients > MAX_HTTP_SERVER_CONNECTIONS) ) {
+    _showUsage( argv[0] );
+    return 1;
+  }
+
+  pthread_create( &server, NULL, DM_HttpServer_Start, NULL );
+  for ( t0=_nowMs() ; !_serverStarted && (_nowMs() - t0 < _START_TIMEOUT) ; ) { usleep( 10 * 1000 ); }
+  if ( !_serverStarted ) {
+    // The server thread keeps on trying to bind the port
+    fprintf( stderr, "Can not start the HTTP server on port %d\n", CPE_PORT );
+    _exit( 1 );
+  }
+
+  _testAllSlotsUsed();
+  _testLatency( nbSilent, nbSlow, nbClients, nbRequests );
+
+  g_DmComData.ServerHttp.nExitHttpSvr = 1;
+  pthread_join( server, NULL );
+  close( g_DmComData.ServerHttp.sockfd_serveur );
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
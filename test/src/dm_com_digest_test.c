@@ -0,0 +1,233 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_com_digest_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_com_digest_test.c
+ *
+ * @brief Test of the digest authentication of the connection requests (dm_com_digest.c)
+ *
+ * The challenges are built by _buildAuthenticationRequest() and answered as an ACS does, the
+ * credentials being pushed by updateDigestCredentials(). A nonce count must increase on each
+ * request with the same nonce : a replayed or lower nc is rejected, a failed authentication
+ * does not consume its nc. Interleaved challenges are valid together, an evicted or expired
+ * one is not. The monotonic clock is wrapped at link time (-Wl,--wrap) to age the nonces.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "dm_com.h"
+#include "dm_com_digest.h"
+
+#define _USERNAME "cruser"
+#define _PASSWORD "crpassword"
+#define _URI      "/cr"
+
+extern char * g_randomCpeUrl;
+
+int __real_clock_gettime(clockid_t clockId, struct timespec * ts);
+
+/**
+ * Challenge of the CPE as read by the ACS
+ */
+typedef struct _Challenge
+{
+  char nonce[MAXTOKENSIZE];
+  char opaque[MAXTOKENSIZE];
+
+} Challenge;
+
+// Seconds added to the monotonic clock
+static time_t _clockOffset = 0;
+static int    _nbFailures  = 0;
+
+int __wrap_clock_gettime(clockid_t         clockId,
+                         struct timespec * ts)
+{
+  int res = __real_clock_gettime( clockId, ts );
+  ts->tv_sec += _clockOffset;
+  return res;
+}
+
+static void _report(const char * testName,
+                    bool         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+static void _md5String(const char * str,
+                       char       * result)
+{
+  MD5_CTX       ctx;
+  unsigned char signature[SIGNATURE_SIZE];
+
+  MD5_Init( &ctx );
+  MD5_Update( &ctx, (unsigned char *) str, strlen( str ) );
+  MD5_Final( signature, &ctx );
+  getStringResult( signature, result );
+}
+
+/*
+* Value of the quoted field of the 401 message
+*/
+static void _getField(const char * message,
+                      const char * token,
+                      char       * value)
+{
+  const char * start = strstr( message, token );
+  size_t       len   = 0;
+
+  value[0] = '\0';
+  if ( start == NULL ) { return; }
+  start += strlen( token ) + 1;
+  while ( (start[len] != '"') && (start[len] != '\0') && (len < MAXTOKENSIZE - 1) ) { len++; }
+  memcpy( value, start, len );
+  value[len] = '\0';
+}
+
+static bool _newChallenge(Challenge * challenge)
+{
+  char message[SIZE_HTTP_MSG];
+
+  if ( _buildAuthenticationRequest( message, sizeof(message) ) != DM_OK ) { return false; }
+  _getField( message, nonceToken, challenge->nonce );
+  _getField( message, opaqueToken, challenge->opaque );
+  return (challenge->nonce[0] != '\0') && (challenge->opaque[0] != '\0');
+}
+
+/*
+* Authenticates a connection request answering the challenge with the given nonce count,
+* as the ACS does (RFC 2617, qop auth)
+*/
+static bool _authenticate(const Challenge * challenge,
+                          unsigned long     nonceCount,
+                          const char      * password)
+{
+  char str[TOTAL_MAXTOKENSIZE];
+  char ha1[MAXTOKENSIZE];
+  char ha2[MAXTOKENSIZE];
+  char response[MAXTOKENSIZE];
+  char nc[16];
+  char request[SIZE_HTTP_MSG];
+
+  snprintf( nc, sizeof(nc), "%08lx", nonceCount );
+  snprintf( str, sizeof(str), "%s:%s:%s", _USERNAME, DIGEST_REALM, password );
+  _md5String( str, ha1 );
+  snprintf( str, sizeof(str), "GET:%s", _URI );
+  _md5String( str, ha2 );
+  snprintf( str, sizeof(str), "%s:%s:%s:%s:auth:%s", ha1, challenge->nonce, nc, "0a4f113b", ha2 );
+  _md5String( str, response );
+
+  snprintf( request, sizeof(request),
+            "GET " _URI " HTTP/1.1\r\n"
+            "Authorization: Digest username=\"" _USERNAME "\", realm=\"" DIGEST_REALM "\", nonce=\"%s\", uri=\"" _URI "\","
+            " response=\"%s\", opaque=\"%s\", qop=auth, nc=%s, cnonce=\"0a4f113b\"\r\n\r\n",
+            challenge->nonce, response, challenge->opaque, nc );
+  return _checkDigestAuthMessageContent( request ) && performClientDigestAuthentication( request );
+}
+
+/*
+* The nonce count must increase with the same nonce
+*/
+static void _testNonceCount()
+{
+  Challenge challenge;
+
+  if ( !_newChallenge( &challenge ) ) {
+    _report( "challenge built", false );
+    return;
+  }
+  _report( "nc 1 accepted", _authenticate( &challenge, 1, _PASSWORD ) );
+  _report( "nc 1 replayed : rejected", !_authenticate( &challenge, 1, _PASSWORD ) );
+  _report( "nc 2 accepted", _authenticate( &challenge, 2, _PASSWORD ) );
+  _report( "nc 1 after nc 2 : rejected", !_authenticate( &challenge, 1, _PASSWORD ) );
+  _report( "nc 3 with a wrong password : rejected", !_authenticate( &challenge, 3, "wrong" ) );
+  _report( "nc 3 not consumed by the failure : accepted", _authenticate( &challenge, 3, _PASSWORD ) );
+  _report( "nc 3 replayed : rejected", !_authenticate( &challenge, 3, _PASSWORD ) );
+  _report( "nc 0x10 after nc 3 : accepted", _authenticate( &challenge, 0x10, _PASSWORD ) );
+}
+
+/*
+* Interleaved challenges have their own nonce count, a forged nonce is rejected
+*/
+static void _testChallenges()
+{
+  Challenge first;
+  Challenge second;
+  Challenge forged;
+
+  _newChallenge( &first );
+  _newChallenge( &second );
+  _report( "interleaved challenges : second one answered", _authenticate( &second, 1, _PASSWORD ) );
+  _report( "interleaved challenges : first one answered", _authenticate( &first, 1, _PASSWORD ) );
+  _report( "interleaved challenges : own nonce counts", _authenticate( &second, 2, _PASSWORD ) && !_authenticate( &first, 1, _PASSWORD ) );
+
+  forged = first;
+  forged.nonce[strlen( forged.nonce ) - 1] = (forged.nonce[strlen( forged.nonce ) - 1] == '0' ? '1' : '0');
+  _report( "forged nonce rejected", !_authenticate( &forged, 1, _PASSWORD ) );
+
+  forged = first;
+  strcpy( forged.opaque, second.opaque );
+  _report( "opaque of another challenge rejected", !_authenticate( &forged, 2, _PASSWORD ) );
+}
+
+/*
+* A challenge is valid for NONCE_LIFETIME seconds, among the last NONCE_TABLE_SIZE ones
+*/
+static void _testExpiration()
+{
+  Challenge challenge;
+  Challenge other;
+  int       i;
+
+  _newChallenge( &challenge );
+  _clockOffset += NONCE_LIFETIME - 1;
+  _report( "challenge valid for its lifetime", _authenticate( &challenge, 1, _PASSWORD ) );
+  _clockOffset += 2;
+  _report( "expired challenge rejected", !_authenticate( &challenge, 2, _PASSWORD ) );
+
+  _newChallenge( &challenge );
+  for ( i=0 ; i<NONCE_TABLE_SIZE-1 ; i++ ) { _newChallenge( &other ); }
+  _report( "oldest of the table still valid", _authenticate( &challenge, 1, _PASSWORD ) );
+  _newChallenge( &other );
+  _report( "evicted challenge rejected", !_authenticate( &challenge, 2, _PASSWORD ) );
+}
+
+int main()
+{
+  g_randomCpeUrl = _URI;
+  initDigestAuthentication();
+  updateDigestCredentials( _USERNAME, _PASSWORD );
+
+  _testNonceCount();
+  _testChallenges();
+  _testExpiration();
+
+  releaseDigestAuthentication();
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,191 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_com_dom_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_com_dom_test.c
+ *
+ * @brief Test of the SOAP messages read with the DOM parser whose lists of child nodes are empty
+ *
+ * The child list of a node without children has a length of 0 (it used to have one NULL item).
+ * The messages are given to DM_HttpCallbackClientData() as the HTTP client does. The calls to
+ * DM_ENG_GetParameterValues() and DM_SendHttpMessageBuffer() are wrapped at link time
+ * (-Wl,--wrap) to check the RPC read and the response sent without any DM_ENGINE nor ACS.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "dm_com.h"
+#include "DM_ENG_RPCInterface.h"
+#include "DM_COM_GenericHttpClientInterface.h"
+#include "DM_COM_GenericDomXmlParserInterface.h"
+
+static const char * _ENVELOPE =
+  "<soapenv:Envelope xmlns:soapenv=\"http://schemas.xmlsoap.org/soap/envelope/\""
+  " xmlns:soapenc=\"http://schemas.xmlsoap.org/soap/encoding/\" xmlns:xsd=\"http://www.w3.org/2001/XMLSchema\""
+  " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xmlns:cwmp=\"urn:dslforum-org:cwmp-1-0\">"
+  "<soapenv:Header><cwmp:ID soapenv:mustUnderstand=\"1\">%s</cwmp:ID></soapenv:Header>"
+  "%s</soapenv:Envelope>";
+
+// Last response sent and number of GetParameterValues
+static char * _response            = NULL;
+static int    _nbResponses         = 0;
+static int    _nbGpv               = 0;
+static int    _nbGpvParameterNames = -1;
+static int    _nbFailures          = 0;
+
+int __wrap_DM_ENG_GetParameterValues(DM_ENG_EntityType                  entity UNUSED,
+                                     char                             * parameterNames[],
+                                     OUT DM_ENG_ParameterValueStruct ** pResult[])
+{
+  _nbGpv++;
+  _nbGpvParameterNames = DM_ENG_tablen( (void**)parameterNames );
+  *pResult = (DM_ENG_ParameterValueStruct **) calloc( _nbGpvParameterNames + 1, sizeof(DM_ENG_ParameterValueStruct *) );
+  return RPC_CPE_RETURN_CODE_OK;
+}
+
+int __wrap_DM_SendHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr)
+{
+  free( _response );
+  _response = strdup( msgBufferPtr->data );
+  _nbResponses++;
+  return DM_OK;
+}
+
+static void _report(const char * testName,
+                    bool         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+/*
+* Gives an envelope with the given ID and Body to DM_HttpCallbackClientData(), in one part
+*/
+static void _receive(const char * id,
+                     const char * body)
+{
+  size_t size    = strlen( _ENVELOPE ) + strlen( id ) + strlen( body );
+  char * message = (char*)malloc( size );
+
+  snprintf( message, size, _ENVELOPE, id, body );
+  free( _response );
+  _response            = NULL;
+  _nbResponses         = 0;
+  _nbGpv               = 0;
+  _nbGpvParameterNames = -1;
+  DM_HttpCallbackClientData( message, strlen( message ) );
+  free( message );
+}
+
+/*
+* Whether the last response contains all the given strings (NULL terminated)
+*/
+static bool _responseContains(const char * expected[])
+{
+  int i;
+
+  if ( (_nbResponses != 1) || (_response == NULL) ) { return false; }
+  for ( i=0 ; expected[i]!=NULL ; i++ ) {
+    if ( strstr( _response, expected[i] ) == NULL ) {
+      printf( "  '%s' not found in the response :\n%s\n", expected[i], _response );
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+* Lists of child nodes read through the generic XML interface
+*/
+static void _testChildNodesList()
+{
+  GenericXmlDocumentPtr doc   = xmlStringBufferToXmlDocument( "<a><empty></empty><b>1</b><b>2</b><b/></a>" );
+  GenericXmlNodePtr     a     = xmlGetFirstNodeWithTagName( doc, "a" );
+  GenericXmlNodePtr     empty = xmlGetFirstNodeWithTagName( doc, "empty" );
+  GenericXmlNodeListPtr list  = NULL;
+
+  list = xmlGetChildNodesList( empty );
+  _report( "child list of a node without children : length 0", (list != NULL) && (xmlGetNodesListLength( list ) == 0)
+                                                               && (xmlGetNodeFromNodesList( list, 0 ) == NULL) );
+  xmlFreeNodesList( list );
+  _report( "number of child nodes of a node without children : 0", xmlGetNumberOfChildNodes( empty ) == 0 );
+
+  list = xmlGetChildNodesList( a );
+  _report( "child list of a node with 4 children : length 4", (xmlGetNodesListLength( list ) == 4) && (xmlGetNodeFromNodesList( list, 3 ) != NULL)
+                                                              && (xmlGetNodeFromNodesList( list, 4 ) == NULL) );
+  xmlFreeNodesList( list );
+  _report( "number of child nodes of a node with 4 children : 4", xmlGetNumberOfChildNodes( a ) == 4 );
+
+  xmlDocumentFree( doc );
+}
+
+/*
+* A Body without RPC gets the fault of an invalid RPC count instead of an RPC
+*/
+static void _testEmptyBody()
+{
+  const char * fault1[] = { "<cwmp:ID soapenv:mustUnderstand=\"1\">empty1</cwmp:ID>", "<soapenv:Fault>", "<FaultCode>9003</FaultCode>", NULL };
+  const char * fault2[] = { "<cwmp:ID soapenv:mustUnderstand=\"1\">empty2</cwmp:ID>", "<soapenv:Fault>", "<FaultCode>9003</FaultCode>", NULL };
+
+  _receive( "empty1", "<soapenv:Body></soapenv:Body>" );
+  _report( "empty soapenv:Body : fault 9003", _responseContains( fault1 ) );
+
+  _receive( "empty2", "<soapenv:Body/>" );
+  _report( "soapenv:Body empty-element tag : fault 9003", _responseContains( fault2 ) );
+}
+
+/*
+* A GetParameterValues without any name gets an empty ParameterList (the counts lower than 10 are
+* written with 2 digits)
+*/
+static void _testEmptyParameterNames()
+{
+  const char * emptyList[] = { "<cwmp:ID soapenv:mustUnderstand=\"1\">gpv0</cwmp:ID>", "<cwmp:GetParameterValuesResponse>",
+                               "<ParameterList soapenc:arrayType=\"cwmp:ParameterValueStruct[00]\">", NULL };
+  const char * oneName[]   = { "<cwmp:ID soapenv:mustUnderstand=\"1\">gpv1</cwmp:ID>", "<cwmp:GetParameterValuesResponse>", NULL };
+
+  _receive( "gpv0", "<soapenv:Body><cwmp:GetParameterValues>"
+                    "<ParameterNames soapenc:arrayType=\"xsd:string[0]\"></ParameterNames>"
+                    "</cwmp:GetParameterValues></soapenv:Body>" );
+  _report( "empty ParameterNames : GetParameterValues of 0 names", (_nbGpv == 1) && (_nbGpvParameterNames == 0) );
+  _report( "empty ParameterNames : empty ParameterList", _responseContains( emptyList ) && (strstr( _response, "<soapenv:Fault>" ) == NULL) );
+
+  _receive( "gpv1", "<soapenv:Body><cwmp:GetParameterValues>"
+                    "<ParameterNames soapenc:arrayType=\"xsd:string[1]\"><string>Device.</string></ParameterNames>"
+                    "</cwmp:GetParameterValues></soapenv:Body>" );
+  _report( "one name in ParameterNames : GetParameterValues of 1 name", (_nbGpv == 1) && (_nbGpvParameterNames == 1)
+                                                                        && _responseContains( oneName ) );
+}
+
+int main()
+{
+  _testChildNodesList();
+  _testEmptyBody();
+  _testEmptyParameterNames();
+
+  free( _response );
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,348 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_com_receive_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_com_receive_test.c
+ *
+ * @brief Test of the gathering of the SOAP messages received from the ACS in several parts
+ *
+ * The parts are given to DM_HttpCallbackClientData() as the HTTP client does. The calls to
+ * DM_ENG_SetParameterValues() and DM_SendHttpMessageBuffer() are wrapped at link time
+ * (-Wl,--wrap) to check the RPC read from each envelope without any DM_ENGINE nor ACS.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "dm_com.h"
+#include "DM_ENG_RPCInterface.h"
+#include "DM_COM_GenericHttpClientInterface.h"
+
+#define _PART_SIZE        (1024)
+#define _BIG_MESSAGE_SIZE (5*1024*1024)
+#define _BIG_VALUE_LENGTH (200)
+#define _MAX_RECEIVED     (8)
+
+static const char * _ENVELOPE_BEGIN =
+  "<soapenv:Envelope xmlns:soapenv=\"http://schemas.xmlsoap.org/soap/envelope/\""
+  " xmlns:soapenc=\"http://schemas.xmlsoap.org/soap/encoding/\" xmlns:xsd=\"http://www.w3.org/2001/XMLSchema\""
+  " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xmlns:cwmp=\"urn:dslforum-org:cwmp-1-0\">"
+  "<soapenv:Header><cwmp:ID soapenv:mustUnderstand=\"1\">%s</cwmp:ID></soapenv:Header>"
+  "<soapenv:Body><cwmp:SetParameterValues><ParameterList soapenc:arrayType=\"cwmp:ParameterValueStruct[%d]\">";
+
+static const char * _ENVELOPE_END =
+  "</ParameterList><ParameterKey>%s</ParameterKey></cwmp:SetParameterValues></soapenv:Body></soapenv:Envelope>";
+
+static const char * _PARAMETER =
+  "<ParameterValueStruct><Name>Device.Test.%d.Value</Name><Value xsi:type=\"xsd:string\">%s</Value></ParameterValueStruct>";
+
+// RPC read from the envelopes, in their order of arrival
+static char * _receivedKeys[_MAX_RECEIVED];
+static int    _receivedParameters[_MAX_RECEIVED];
+static int    _nbReceived   = 0;
+static int    _nbResponses  = 0;
+static int    _nbBadValues  = 0;
+static int    _nbFailures   = 0;
+
+/*
+* Value of the i-th parameter of the messages built by _buildMessage()
+*/
+static void _parameterValue(int i, int length, char * value)
+{
+  int j;
+  for ( j=0 ; j<length ; j++ ) { value[j] = (char)('a' + (i+j)%26); }
+  value[length] = '\0';
+}
+
+int __wrap_DM_ENG_SetParameterValues(DM_ENG_EntityType                  entity UNUSED,
+                                     DM_ENG_ParameterValueStruct      * parameterList[],
+                                     char                             * parameterKey,
+                                     OUT DM_ENG_ParameterStatus       * pStatus,
+                                     OUT DM_ENG_SetParameterValuesFault ** pFaults[])
+{
+  char name[64];
+  char value[_BIG_VALUE_LENGTH+1];
+  int  nb = DM_ENG_tablen( (void**)parameterList );
+  int  i;
+
+  for ( i=0 ; i<nb ; i++ ) {
+    snprintf( name, sizeof(name), "Device.Test.%d.Value", i );
+    _parameterValue( i, (int)strlen( parameterList[i]->value ), value );
+    if ( (strcmp( parameterList[i]->parameterName, name ) != 0) || (strcmp( parameterList[i]->value, value ) != 0) ) { _nbBadValues++; }
+  }
+
+  if ( _nbReceived < _MAX_RECEIVED ) {
+    _receivedKeys[_nbReceived]       = strdup( parameterKey );
+    _receivedParameters[_nbReceived] = nb;
+  }
+  _nbReceived++;
+
+  *pStatus = DM_ENG_ParameterStatus_APPLIED;
+  *pFaults = NULL;
+  return RPC_CPE_RETURN_CODE_OK;
+}
+
+int __wrap_DM_SendHttpMessageBuffer(IN httpMessageBufferType * msgBufferPtr UNUSED)
+{
+  _nbResponses++;
+  return DM_OK;
+}
+
+static void _resetReceived()
+{
+  int i;
+  for ( i=0 ; (i<_nbReceived) && (i<_MAX_RECEIVED) ; i++ ) { free( _receivedKeys[i] ); }
+  _nbReceived  = 0;
+  _nbResponses = 0;
+  _nbBadValues = 0;
+}
+
+/*
+* Builds a SetParameterValues envelope of *pNbParameters values of the given length, with at least
+* minSize bytes (more parameters are added when needed, *pNbParameters is then updated)
+*/
+static char * _buildMessage(const char * key,
+                            int        * pNbParameters,
+                            int          valueLength,
+                            size_t       minSize)
+{
+  int    nbParameters  = *pNbParameters;
+  size_t parameterSize = strlen( _PARAMETER ) - 4 + valueLength; // without the index
+  size_t capacity      = 0;
+  size_t length        = 0;
+  char * message       = NULL;
+  char   value[_BIG_VALUE_LENGTH+1];
+  int    i;
+
+  if ( (size_t)nbParameters * parameterSize < minSize ) { nbParameters = (int)(minSize / parameterSize) + 1; }
+  capacity = strlen( _ENVELOPE_BEGIN ) + strlen( _ENVELOPE_END ) + 2*strlen( key ) + 32 + nbParameters * (parameterSize + 12);
+  message  = (char*)malloc( capacity );
+
+  length = snprintf( message, capacity, _ENVELOPE_BEGIN, key, nbParameters );
+  for ( i=0 ; i<nbParameters ; i++ ) {
+    _parameterValue( i, valueLength, value );
+    length += snprintf( message + length, capacity - length, _PARAMETER, i, value );
+  }
+  snprintf( message + length, capacity - length, _ENVELOPE_END, key );
+
+  *pNbParameters = nbParameters;
+  return message;
+}
+
+/*
+* Gives the part [begin, begin+size[ of the data to DM_HttpCallbackClientData(), null terminated
+* as done by the HTTP client
+*/
+static void _receivePart(const char * data,
+                         size_t       size)
+{
+  char * part = (char*)malloc( size + 1 );
+
+  memcpy( part, data, size );
+  part[size] = '\0';
+  if ( DM_HttpCallbackClientData( part, size ) != size ) {
+    printf( "  DM_HttpCallbackClientData() refused a part of %d bytes\n", (int)size );
+    _nbFailures++;
+  }
+  free( part );
+}
+
+/*
+* Gives the length first bytes of the data in parts of partSize bytes
+*/
+static void _receiveInParts(const char * data,
+                            size_t       length,
+                            size_t       partSize)
+{
+  size_t offset = 0;
+
+  for ( offset=0 ; offset<length ; offset+=partSize ) {
+    _receivePart( data + offset, (length - offset < partSize ? length - offset : partSize) );
+  }
+}
+
+static void _report(const char * testName,
+                    bool         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+/*
+* Checks the RPC read since the last check : their number, their parameter keys and their number of parameters
+*/
+static void _check(const char * testName,
+                   int          nbExpected,
+                   const char * expectedKeys[],
+                   const int    expectedParameters[])
+{
+  bool ok = (_nbReceived == nbExpected) && (_nbResponses == nbExpected) && (_nbBadValues == 0);
+  int  i;
+
+  for ( i=0 ; ok && (i<nbExpected) ; i++ ) {
+    ok = (strcmp( _receivedKeys[i], expectedKeys[i] ) == 0) && (_receivedParameters[i] == expectedParameters[i]);
+  }
+
+  _report( testName, ok );
+  if ( !ok ) {
+    printf( "  %d RPC (%d expected), %d responses, %d bad values\n", _nbReceived, nbExpected, _nbResponses, _nbBadValues );
+    for ( i=0 ; (i<_nbReceived) && (i<_MAX_RECEIVED) ; i++ ) {
+      printf( "  RPC %d : key %s, %d parameters\n", i, _receivedKeys[i], _receivedParameters[i] );
+    }
+  }
+  _resetReceived();
+}
+
+/*
+* A 5 MB SetParameterValues received in parts of 1 KB
+*/
+static void _testBigMessage()
+{
+  const char      * keys[]  = { "big" };
+  int               nbs[]   = { 0 };
+  char            * message = _buildMessage( keys[0], &nbs[0], _BIG_VALUE_LENGTH, _BIG_MESSAGE_SIZE );
+  struct timespec   t0, t1;
+  char              testName[128];
+
+  clock_gettime( CLOCK_MONOTONIC, &t0 );
+  _receiveInParts( message, strlen( message ), _PART_SIZE );
+  clock_gettime( CLOCK_MONOTONIC, &t1 );
+
+  snprintf( testName, sizeof(testName), "SetParameterValues of %d bytes (%d parameters) in parts of %d bytes, %ld ms",
+            (int)strlen( message ), nbs[0], _PART_SIZE, (long)((t1.tv_sec-t0.tv_sec)*1000 + (t1.tv_nsec-t0.tv_nsec)/1000000) );
+  _check( testName, 1, keys, nbs );
+  free( message );
+}
+
+/*
+* Checks that exactly one RPC, with the given parameter key, has been read since the last check
+*/
+static bool _receivedOne(const char * key)
+{
+  bool ok = (_nbReceived == 1) && (_nbBadValues == 0) && (strcmp( _receivedKeys[0], key ) == 0);
+  _resetReceived();
+  return ok;
+}
+
+/*
+* The end envelope tag split between two parts, at each of its positions (the parts before are
+* of 1 KB), then the message split at each position, then received byte per byte.
+* The first part of a message always holds the begin envelope tag, else it is not taken as SOAP.
+*/
+static void _testSplitEndTag()
+{
+  const char * keys[]    = { "split" };
+  int          nbs[]     = { 20 };
+  char       * message   = _buildMessage( keys[0], &nbs[0], 40, 0 );
+  size_t       length    = strlen( message );
+  size_t       tagLength = strlen( "</soapenv:Envelope>" );
+  size_t       first     = strlen( "<soapenv:Envelope" );
+  size_t       cut;
+  bool         ok        = true;
+
+  for ( cut=1 ; cut<tagLength ; cut++ ) {
+    size_t at = length - tagLength + cut;
+    _receiveInParts( message, at, _PART_SIZE ); // the last part ends inside the tag
+    ok = ok && (_nbReceived == 0);
+    _receivePart( message + at, length - at );
+    ok = _receivedOne( keys[0] ) && ok;
+  }
+  _report( "end envelope tag split between two parts", ok );
+
+  for ( cut=first ; cut<length ; cut++ ) {
+    _receivePart( message, cut );
+    _receivePart( message + cut, length - cut );
+    ok = _receivedOne( keys[0] ) && ok;
+  }
+  _report( "message split in two parts at each position", ok );
+
+  _receivePart( message, first );
+  _receiveInParts( message + first, length - first, 1 );
+  _check( "message received byte per byte", 1, keys, nbs );
+  free( message );
+}
+
+/*
+* Several envelopes in the same part (MaxEnvelopes > 1), with or without blanks between them
+*/
+static void _testSeveralEnvelopes()
+{
+  const char * keys[]    = { "first", "second", "third" };
+  int          nbs[]     = { 2, 3, 1 };
+  char       * message1  = _buildMessage( keys[0], &nbs[0], 10, 0 );
+  char       * message2  = _buildMessage( keys[1], &nbs[1], 10, 0 );
+  char       * message3  = _buildMessage( keys[2], &nbs[2], 10, 0 );
+  size_t       length1   = strlen( message1 );
+  size_t       length2   = strlen( message2 );
+  size_t       length3   = strlen( message3 );
+  const char * blanks    = " \r\n\t\r\n";
+  char       * data      = (char*)malloc( length1 + length2 + length3 + 3*strlen( blanks ) + 1 );
+
+  // Two envelopes in one part
+  sprintf( data, "%s%s", message1, message2 );
+  _receivePart( data, strlen( data ) );
+  _check( "two envelopes in one part", 2, keys, nbs );
+
+  // Blanks between and after the envelopes
+  sprintf( data, "%s%s%s%s%s", message1, blanks, message2, blanks, message3 );
+  _receivePart( data, strlen( data ) );
+  _check( "three envelopes in one part, with blanks between them", 3, keys, nbs );
+
+  // The second envelope begins in the part which ends the first one and ends in the next part,
+  // its end tag split between them : it is searched again from the start after the first one is removed
+  sprintf( data, "%s%s%s", message1, blanks, message2 );
+  _receivePart( data, length1 + strlen( blanks ) + length2 - 5 );
+  _receivePart( data + length1 + strlen( blanks ) + length2 - 5, 5 );
+  _check( "second envelope completed by the next part", 2, keys, nbs );
+
+  // Blanks alone after the last envelope : they are dropped and a new message can begin.
+  // A part which is not SOAP is dropped when no message is pending, it would else corrupt the next one.
+  sprintf( data, "%s%s", message1, blanks );
+  _receivePart( data, strlen( data ) );
+  _receivePart( "garbage", strlen( "garbage" ) );
+  _receiveInParts( message2, length2, 64 );
+  _check( "blanks after the last envelope", 2, keys, nbs );
+
+  // Blanks received in their own part between two envelopes
+  _receivePart( message1, length1 );
+  _receivePart( blanks, strlen( blanks ) );
+  _receivePart( message2, length2 );
+  _check( "blanks received alone between two envelopes", 2, keys, nbs );
+
+  free( data );
+  free( message1 );
+  free( message2 );
+  free( message3 );
+}
+
+int main()
+{
+  _testBigMessage();
+  _testSplitEndTag();
+  _testSeveralEnvelopes();
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,204 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_connection_security_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_connection_security_test.c
+ *
+ * @brief Test of the token buckets limiting the connection requests (DM_COM_ConnectionSecurity.c)
+ *
+ * The policy (MaxConnectionRequest per FreqConnectionRequest seconds) and the monotonic clock
+ * are wrapped at link time (-Wl,--wrap) : DM_ENG_GetParameterValues() gives the policy of the
+ * test, clock_gettime() the time of the test. The requests allowed and rejected, the refill of
+ * the bucket, its limit, the cache of the policy and the counters of each path are checked.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "DM_ENG_RPCInterface.h"
+#include "DM_COM_GenericHttpServerInterface.h"
+#include "DM_COM_ConnectionSecurity.h"
+
+// Policy given by the data model, none when the GetParameterValues fails
+static const char * _maxConnectionRequest  = NULL;
+static const char * _freqConnectionRequest = NULL;
+static int          _nbPolicyReads         = 0;
+
+// Time of the test, in seconds
+static double _now        = 1000.0;
+static int    _nbFailures = 0;
+
+int __wrap_DM_ENG_GetParameterValues(DM_ENG_EntityType             entity UNUSED,
+                                     char                        * parameterNames[],
+                                     OUT DM_ENG_ParameterValueStruct ** pResult[])
+{
+  _nbPolicyReads++;
+  if ( _maxConnectionRequest == NULL ) { return DM_ENG_INVALID_PARAMETER_NAME; }
+  *pResult = DM_ENG_newTabParameterValueStruct( 2 );
+  (*pResult)[0] = DM_ENG_newParameterValueStruct( parameterNames[0], DM_ENG_ParameterType_UINT, (char*)_maxConnectionRequest );
+  (*pResult)[1] = DM_ENG_newParameterValueStruct( parameterNames[1], DM_ENG_ParameterType_UINT, (char*)_freqConnectionRequest );
+  return 0;
+}
+
+int __wrap_clock_gettime(clockid_t         clockId UNUSED,
+                         struct timespec * ts)
+{
+  ts->tv_sec  = (time_t)_now;
+  ts->tv_nsec = (long)((_now - (double)ts->tv_sec) * 1000000000.0);
+  return 0;
+}
+
+static void _report(const char * testName,
+                    bool         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+/*
+* Connection requests on the path, as the HTTP server does : checked then taken when allowed.
+* Returns the number of requests allowed.
+*/
+static int _requestConnections(ConnectionRequestPath path,
+                               int                   nbRequests)
+{
+  int nbAllowed = 0;
+  int i;
+
+  for ( i=0 ; i<nbRequests ; i++ ) {
+    if ( !maxConnectionPerPeriodReached( path ) ) {
+      newConnectionRequestAllowed( path );
+      nbAllowed++;
+    }
+  }
+  return nbAllowed;
+}
+
+/*
+* Counters of the path increased by the given numbers since the previous check
+*/
+static bool _countersIncreased(ConnectionRequestPath path,
+                               unsigned int        * pAllowed,
+                               unsigned int        * pRejected,
+                               unsigned int          nbAllowed,
+                               unsigned int          nbRejected)
+{
+  unsigned int allowed  = getConnectionRequestAllowedCount( path );
+  unsigned int rejected = getConnectionRequestRejectedCount( path );
+  bool         ok       = (allowed == *pAllowed + nbAllowed) && (rejected == *pRejected + nbRejected);
+
+  *pAllowed  = allowed;
+  *pRejected = rejected;
+  return ok;
+}
+
+/*
+* Default policy when the data model does not give one : DEFAULT_MAX_CONNECTIONREQUEST per hour
+*/
+static void _testDefaultPolicy()
+{
+  unsigned int allowed  = 0;
+  unsigned int rejected = 0;
+
+  initConnectionRateLimiter( CONNECTION_REQUEST_HTTP );
+  _report( "default policy : bucket full at first", _requestConnections( CONNECTION_REQUEST_HTTP, DEFAULT_MAX_CONNECTIONREQUEST ) == DEFAULT_MAX_CONNECTIONREQUEST );
+  _report( "default policy : empty bucket, request rejected", _requestConnections( CONNECTION_REQUEST_HTTP, 1 ) == 0 );
+  _report( "default policy : counters", _countersIncreased( CONNECTION_REQUEST_HTTP, &allowed, &rejected, DEFAULT_MAX_CONNECTIONREQUEST, 1 ) );
+  _report( "default policy : read once", _nbPolicyReads == 1 );
+}
+
+/*
+* Refill at the rate of the policy (3 per minute : one token every 20 s), up to its maximum
+*/
+static void _testRefill()
+{
+  unsigned int allowed  = getConnectionRequestAllowedCount( CONNECTION_REQUEST_HTTP );
+  unsigned int rejected = getConnectionRequestRejectedCount( CONNECTION_REQUEST_HTTP );
+
+  _maxConnectionRequest  = "3";
+  _freqConnectionRequest = "60";
+  _now += CONNECTION_REQUEST_POLICY_REFRESH;
+  initConnectionRateLimiter( CONNECTION_REQUEST_HTTP );
+
+  _report( "3 per 60 s : 3 requests of 5 allowed", _requestConnections( CONNECTION_REQUEST_HTTP, 5 ) == 3 );
+  _report( "3 per 60 s : counters", _countersIncreased( CONNECTION_REQUEST_HTTP, &allowed, &rejected, 3, 2 ) );
+
+  _now += 10;
+  _report( "half a token after 10 s : request rejected", _requestConnections( CONNECTION_REQUEST_HTTP, 1 ) == 0 );
+  _now += 10;
+  _report( "one token after 20 s : 1 request of 2 allowed", _requestConnections( CONNECTION_REQUEST_HTTP, 2 ) == 1 );
+  _report( "refill : counters", _countersIncreased( CONNECTION_REQUEST_HTTP, &allowed, &rejected, 1, 2 ) );
+
+  _now += 1000;
+  _report( "bucket limited to the maximum of the policy", _requestConnections( CONNECTION_REQUEST_HTTP, 5 ) == 3 );
+  _report( "limit : counters", _countersIncreased( CONNECTION_REQUEST_HTTP, &allowed, &rejected, 3, 2 ) );
+}
+
+/*
+* The policy is read again after CONNECTION_REQUEST_POLICY_REFRESH seconds only
+*/
+static void _testPolicyCache()
+{
+  int nbReads;
+
+  _now += 1000;
+  _requestConnections( CONNECTION_REQUEST_HTTP, 1 );
+  nbReads = _nbPolicyReads;
+
+  _maxConnectionRequest = "1";
+  _now += CONNECTION_REQUEST_POLICY_REFRESH / 2;
+  _report( "policy cached : previous maximum", (_requestConnections( CONNECTION_REQUEST_HTTP, 3 ) == 2) && (_nbPolicyReads == nbReads) );
+
+  _now += 1000;
+  _report( "policy read again : new maximum", (_requestConnections( CONNECTION_REQUEST_HTTP, 3 ) == 1) && (_nbPolicyReads == nbReads + 1) );
+}
+
+/*
+* Each path has its own bucket and counters
+*/
+static void _testPaths()
+{
+  unsigned int httpAllowed  = getConnectionRequestAllowedCount( CONNECTION_REQUEST_HTTP );
+  unsigned int httpRejected = getConnectionRequestRejectedCount( CONNECTION_REQUEST_HTTP );
+  unsigned int udpAllowed   = 0;
+  unsigned int udpRejected  = 0;
+
+  _report( "HTTP bucket empty", _requestConnections( CONNECTION_REQUEST_HTTP, 1 ) == 0 );
+  initConnectionRateLimiter( CONNECTION_REQUEST_UDP );
+  _report( "UDP bucket full", _requestConnections( CONNECTION_REQUEST_UDP, 2 ) == 1 );
+  _report( "UDP counters", _countersIncreased( CONNECTION_REQUEST_UDP, &udpAllowed, &udpRejected, 1, 1 ) );
+  _report( "HTTP counters unchanged by the UDP requests", _countersIncreased( CONNECTION_REQUEST_HTTP, &httpAllowed, &httpRejected, 0, 1 ) );
+}
+
+int main()
+{
+  _testDefaultPolicy();
+  _testRefill();
+  _testPolicyCache();
+  _testPaths();
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,465 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_http_gzip_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_http_gzip_test.c
+ *
+ * @brief Test of the gzip Content-Encoding of the messages sent to the ACS (DM_COM_HttpClientInterface.c)
+ *
+ * Only built with GZIP_ENABLE=Y. An envelope is written with the SOAP writer (DM_StartSoapMessage()),
+ * then sent to a local ACS run by the test, as a buffer and as a streamed message. Once the ACS has
+ * advertised gzip (Accept-Encoding), the envelopes must arrive deflated, and give back the envelope
+ * byte for byte once inflated. The small messages stay uncompressed. A compressed message rejected
+ * (415) must be sent again uncompressed, as the next ones. The callbacks of dm_com reading the
+ * responses are wrapped at link time (-Wl,--wrap).
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "dm_com.h"
+#include "DM_COM_GenericHttpClientInterface.h"
+
+#define _BUFFER_SIZE   (64*1024)
+#define _TIMEOUT       10  // s
+#define _NB_PARAMETERS 100 // Envelope of about 10 KB
+#define _STREAM_PIECE  100 // Bytes given at a time by the streamed message
+#define _NB_REQUESTS   7
+
+static const char * _CONTINUE = "HTTP/1.1 100 Continue\r\n\r\n";
+
+// Answer of the ACS to each request : the first one advertises gzip, the fifth one rejects it
+static const char * _ANSWERS[_NB_REQUESTS] = {
+  "HTTP/1.1 200 OK\r\nAccept-Encoding: gzip\r\nContent-Length: 0\r\n\r\n",
+  "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+  "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+  "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+  "HTTP/1.1 415 Unsupported Media Type\r\nContent-Length: 0\r\n\r\n",
+  "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+  "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n"
+};
+
+/**
+ * Request received by the ACS, its body being inflated when it is gzip encoded
+ */
+typedef struct _Request
+{
+  bool   gzipEncoded;
+  bool   chunked;
+  bool   inflated;
+  char * body;
+
+} Request;
+
+/**
+ * Streamed message, given by pieces of _STREAM_PIECE bytes
+ */
+typedef struct _StreamedMessage
+{
+  const char * message;
+  size_t       offset;
+
+} StreamedMessage;
+
+static Request         _requests[_NB_REQUESTS];
+static int             _nbReceived = 0;
+static pthread_mutex_t _acsMutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  _acsCond    = PTHREAD_COND_INITIALIZER;
+
+static int _listenSock = -1;
+static int _nbFailures = 0;
+
+size_t __wrap_DM_HttpCallbackClientHeader(char   * httpHeaderMsgString UNUSED,
+                                          size_t   msgSize,
+                                          int      lastHttpResponseCode UNUSED)
+{
+  return msgSize;
+}
+
+size_t __wrap_DM_HttpCallbackClientData(char   * httpDataMsgString UNUSED,
+                                        size_t   msgSize)
+{
+  return msgSize;
+}
+
+static void _report(const char * testName,
+                    bool         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+/*
+* Value of the header (NULL if absent), the headers ending with an empty line
+*/
+static const char * _getHeader(const char * headers,
+                               const char * name)
+{
+  const char * line = strstr( headers, "\r\n" );
+  size_t       len  = strlen( name );
+
+  while ( (line != NULL) && (strncmp( line, "\r\n\r\n", 4 ) != 0) ) {
+    line += 2;
+    if ( (strncasecmp( line, name, len ) == 0) && (line[len] == ':') ) {
+      line += len + 1;
+      while ( *line == ' ' ) { line++; }
+      return line;
+    }
+    line = strstr( line, "\r\n" );
+  }
+  return NULL;
+}
+
+static bool _receiveMore(int      sock,
+                         char   * buffer,
+                         size_t * pFilled)
+{
+  ssize_t n;
+
+  if ( (*pFilled >= _BUFFER_SIZE - 1) || ((n = recv( sock, buffer + *pFilled, _BUFFER_SIZE - 1 - *pFilled, 0 )) <= 0) ) { return false; }
+  *pFilled += n;
+  buffer[*pFilled] = '\0';
+  return true;
+}
+
+/*
+* Inflates the gzip encoded body. Returns NULL if it is not a valid gzip stream.
+*/
+static char * _inflate(const char * data,
+                       size_t       size)
+{
+  char     * text = (char*)malloc( _BUFFER_SIZE );
+  z_stream   zStream;
+  int        rc;
+
+  memset( &zStream, 0, sizeof(zStream) );
+  if ( inflateInit2( &zStream, 15 + 16 ) != Z_OK ) {
+    free( text );
+    return NULL;
+  }
+  zStream.next_in   = (Bytef *) data;
+  zStream.avail_in  = (uInt) size;
+  zStream.next_out  = (Bytef *) text;
+  zStream.avail_out = _BUFFER_SIZE - 1;
+  rc = inflate( &zStream, Z_FINISH );
+  if ( (rc != Z_STREAM_END) || (zStream.avail_in != 0) ) {
+    free( text );
+    text = NULL;
+  } else {
+    text[zStream.total_out] = '\0';
+  }
+  inflateEnd( &zStream );
+  return text;
+}
+
+/*
+* Reads one request (Content-Length or chunked), the bytes of the next requests being kept in
+* the buffer. Returns false when the connection is closed.
+*/
+static bool _readRequest(int       sock,
+                         char    * buffer,
+                         size_t  * pFilled,
+                         Request * request)
+{
+  static char  body[_BUFFER_SIZE];
+  char       * end      = NULL;
+  const char * value    = NULL;
+  size_t       filled   = *pFilled;
+  size_t       bodySize = 0;
+  size_t       consumed;
+
+  buffer[filled] = '\0';
+  while ( (end = strstr( buffer, "\r\n\r\n" )) == NULL ) {
+    if ( !_receiveMore( sock, buffer, &filled ) ) { return false; }
+  }
+  end     += 4;
+  consumed = (size_t)(end - buffer);
+
+  if ( ((value = _getHeader( buffer, "Expect" )) != NULL) && (strncasecmp( value, "100-continue", 12 ) == 0) ) {
+    send( sock, _CONTINUE, strlen( _CONTINUE ), MSG_NOSIGNAL );
+  }
+  request->gzipEncoded = ((value = _getHeader( buffer, "Content-Encoding" )) != NULL) && (strncasecmp( value, "gzip", 4 ) == 0);
+  request->chunked     = ((value = _getHeader( buffer, "Transfer-Encoding" )) != NULL) && (strncasecmp( value, "chunked", 7 ) == 0);
+
+  if ( request->chunked ) {
+    // Chunks : size in hex, CRLF, data, CRLF ... up to the chunk of size 0 and its CRLF
+    for (;;) {
+      char        * lineEnd;
+      unsigned long chunkSize;
+
+      while ( (lineEnd = strstr( buffer + consumed, "\r\n" )) == NULL ) {
+        if ( !_receiveMore( sock, buffer, &filled ) ) { return false; }
+      }
+      chunkSize = strtoul( buffer + consumed, NULL, 16 );
+      consumed  = (size_t)(lineEnd - buffer) + 2;
+      while ( filled < consumed + chunkSize + 2 ) {
+        if ( !_receiveMore( sock, buffer, &filled ) ) { return false; }
+      }
+      if ( bodySize + chunkSize >= _BUFFER_SIZE ) { return false; }
+      memcpy( body + bodySize, buffer + consumed, chunkSize );
+      bodySize += chunkSize;
+      consumed += chunkSize + 2;
+      if ( chunkSize == 0 ) { break; }
+    }
+  } else {
+    bodySize = ( (value = _getHeader( buffer, "Content-Length" )) != NULL ? strtoul( value, NULL, 10 ) : 0 );
+    if ( bodySize >= _BUFFER_SIZE - consumed ) { return false; }
+    while ( filled < consumed + bodySize ) {
+      if ( !_receiveMore( sock, buffer, &filled ) ) { return false; }
+    }
+    memcpy( body, buffer + consumed, bodySize );
+    consumed += bodySize;
+  }
+  body[bodySize] = '\0';
+
+  if ( request->gzipEncoded ) {
+    request->body     = _inflate( body, bodySize );
+    request->inflated = (request->body != NULL);
+  } else {
+    request->body     = strdup( body );
+    request->inflated = false;
+  }
+
+  memmove( buffer, buffer + consumed, filled - consumed );
+  *pFilled = filled - consumed;
+  return true;
+}
+
+/*
+* ACS : each request gets the answer of its rank
+*/
+static void * _runAcs(void * data UNUSED)
+{
+  static char buffer[_BUFFER_SIZE];
+  Request     request;
+  int         sock;
+
+  while ( (sock = accept( _listenSock, NULL, NULL )) >= 0 ) {
+    size_t filled = 0;
+
+    while ( _readRequest( sock, buffer, &filled, &request ) ) {
+      const char * answer = _ANSWERS[_NB_REQUESTS - 1];
+
+      pthread_mutex_lock( &_acsMutex );
+      if ( _nbReceived < _NB_REQUESTS ) {
+        answer = _ANSWERS[_nbReceived];
+        _requests[_nbReceived] = request;
+      } else {
+        free( request.body );
+      }
+      _nbReceived++;
+      pthread_cond_broadcast( &_acsCond );
+      pthread_mutex_unlock( &_acsMutex );
+
+      send( sock, answer, strlen( answer ), MSG_NOSIGNAL );
+    }
+    close( sock );
+  }
+  return NULL;
+}
+
+static int _startAcs(pthread_t * pThread)
+{
+  struct sockaddr_in address;
+  socklen_t          addressLen = sizeof(address);
+
+  memset( &address, 0, sizeof(address) );
+  address.sin_family      = AF_INET;
+  address.sin_port        = 0;
+  address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  _listenSock = socket( AF_INET, SOCK_STREAM, 0 );
+  if ( (bind( _listenSock, (struct sockaddr *)&address, sizeof(address) ) != 0) || (listen( _listenSock, 4 ) != 0)
+    || (getsockname( _listenSock, (struct sockaddr *)&address, &addressLen ) != 0)
+    || (pthread_create( pThread, NULL, _runAcs, NULL ) != 0) ) {
+    return 0;
+  }
+  return ntohs( address.sin_port );
+}
+
+/*
+* Waits until the ACS has received the given number of requests
+*/
+static bool _waitReceived(int nbRequests)
+{
+  struct timespec deadline;
+  bool            received;
+
+  clock_gettime( CLOCK_REALTIME, &deadline );
+  deadline.tv_sec += _TIMEOUT;
+  pthread_mutex_lock( &_acsMutex );
+  while ( (_nbReceived < nbRequests) && (pthread_cond_timedwait( &_acsCond, &_acsMutex, &deadline ) == 0) ) {}
+  received = (_nbReceived >= nbRequests);
+  pthread_mutex_unlock( &_acsMutex );
+  return received;
+}
+
+/*
+* GetParameterValuesResponse written with the SOAP writer, escaped texts included
+*/
+static char * _writeEnvelope()
+{
+  DM_SoapWriter writer;
+  char          text[64];
+  int           i;
+
+  DM_StartSoapMessage( &writer, "gzip", true );
+  DM_SoapWriter_startElement( &writer, "cwmp:GetParameterValuesResponse" );
+  DM_SoapWriter_startElement( &writer, "ParameterList" );
+  snprintf( text, sizeof(text), "cwmp:ParameterValueStruct[%d]", _NB_PARAMETERS );
+  DM_SoapWriter_addAttribute( &writer, "soapenc:arrayType", text );
+  for ( i=0 ; i<_NB_PARAMETERS ; i++ ) {
+    DM_SoapWriter_startElement( &writer, "ParameterValueStruct" );
+    snprintf( text, sizeof(text), "Device.X_ORANGE-COM_Gzip.Value%d", i );
+    DM_SoapWriter_addElement( &writer, "Name", text );
+    DM_SoapWriter_startElement( &writer, "Value" );
+    DM_SoapWriter_addAttribute( &writer, "xsi:type", "xsd:string" );
+    snprintf( text, sizeof(text), "<%d> & \"%d\"", i, i * i );
+    DM_SoapWriter_addText( &writer, text );
+    DM_SoapWriter_endElement( &writer );
+    DM_SoapWriter_endElement( &writer );
+  }
+  DM_SoapWriter_endElement( &writer );
+  DM_SoapWriter_endElement( &writer );
+  return DM_EndSoapMessage( &writer );
+}
+
+static int _readStreamedMessage(void   * producerData,
+                                char   * buffer,
+                                size_t   size)
+{
+  StreamedMessage * stream = (StreamedMessage *) producerData;
+  size_t            len    = strlen( stream->message + stream->offset );
+
+  if ( len > _STREAM_PIECE ) { len = _STREAM_PIECE; }
+  if ( len > size ) { len = size; }
+  memcpy( buffer, stream->message + stream->offset, len );
+  stream->offset += len;
+  return (int)len;
+}
+
+static int _rewindStreamedMessage(void * producerData)
+{
+  ((StreamedMessage *) producerData)->offset = 0;
+  return 0;
+}
+
+static void _releaseStreamedMessage(void * producerData)
+{
+  free( producerData );
+}
+
+static int _sendStreamedMessage(const char * message)
+{
+  httpMessageStreamType msgStream;
+  StreamedMessage     * stream = (StreamedMessage *) calloc( 1, sizeof(StreamedMessage) );
+
+  stream->message           = message;
+  msgStream.readFunction    = _readStreamedMessage;
+  msgStream.rewindFunction  = _rewindStreamedMessage;
+  msgStream.releaseFunction = _releaseStreamedMessage;
+  msgStream.producerData    = stream;
+  return DM_SendHttpMessageStream( &msgStream );
+}
+
+/*
+* Whether the request of the given rank is received, with the expected encoding and body
+*/
+static bool _checkRequest(int          rank,
+                          bool         gzipEncoded,
+                          const char * body)
+{
+  Request * request = &_requests[rank];
+
+  if ( !_waitReceived( rank + 1 ) ) { return false; }
+  if ( request->gzipEncoded != gzipEncoded ) {
+    printf( "  request %d : %s\n", rank, (gzipEncoded ? "not gzip encoded" : "gzip encoded") );
+    return false;
+  }
+  if ( gzipEncoded && !request->inflated ) {
+    printf( "  request %d : not a valid gzip stream\n", rank );
+    return false;
+  }
+  return (request->body != NULL) && (strcmp( request->body, body ) == 0);
+}
+
+static void _testGzip()
+{
+  char * envelope = _writeEnvelope();
+
+  if ( (envelope == NULL) || (strlen( envelope ) < 1024) ) {
+    _report( "envelope written", false );
+    free( envelope );
+    return;
+  }
+
+  _report( "gzip unknown : small message sent uncompressed", (DM_SendHttpMessage( "<m>0</m>" ) == DM_OK) && _checkRequest( 0, false, "<m>0</m>" ) );
+
+  _report( "gzip advertised : envelope deflated, then inflated unchanged", (DM_SendHttpMessage( envelope ) == DM_OK) && _checkRequest( 1, true, envelope )
+                                                                          && _requests[1].chunked );
+  _report( "gzip advertised : small message sent uncompressed", (DM_SendHttpMessage( "<m>2</m>" ) == DM_OK) && _checkRequest( 2, false, "<m>2</m>" ) );
+  _report( "gzip advertised : streamed envelope deflated, then inflated unchanged", (_sendStreamedMessage( envelope ) == DM_OK) && _checkRequest( 3, true, envelope ) );
+
+  _report( "gzip rejected (415) : envelope deflated", (DM_SendHttpMessage( envelope ) == DM_OK) && _checkRequest( 4, true, envelope ) );
+  _report( "gzip rejected (415) : same envelope sent again uncompressed", _checkRequest( 5, false, envelope ) );
+  _report( "gzip rejected : next envelope sent uncompressed", (_sendStreamedMessage( envelope ) == DM_OK) && _checkRequest( 6, false, envelope ) );
+
+  // The streamed message refers to the envelope until it is sent
+  DM_StopHttpClient();
+  free( envelope );
+}
+
+int main()
+{
+  pthread_t acsThread;
+  char      acsUrl[64];
+  int       port;
+  int       i;
+
+  // The local ACS is reached directly
+  setenv( "no_proxy", "127.0.0.1", 1 );
+
+  if ( (port = _startAcs( &acsThread )) == 0 ) {
+    printf( "FAIL start of the ACS\n" );
+    return 1;
+  }
+  snprintf( acsUrl, sizeof(acsUrl), "http://127.0.0.1:%d/acs", port );
+  DM_ConfigureHttpClient( acsUrl, NULL, NULL, NULL, NULL, NULL );
+
+  _testGzip();
+
+  shutdown( _listenSock, SHUT_RDWR );
+  close( _listenSock );
+  pthread_join( acsThread, NULL );
+  for ( i=0 ; (i<_nbReceived) && (i<_NB_REQUESTS) ; i++ ) { free( _requests[i].body ); }
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
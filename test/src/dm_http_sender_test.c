@@ -0,0 +1,301 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_http_sender_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_http_sender_test.c
+ *
+ * @brief Test of the backpressure of the HTTP sender thread (DM_COM_HttpClientInterface.c)
+ *
+ * The messages are sent to a local ACS run by the test, which holds its answer to the first
+ * one. The 32 next messages are queued at once, behind the one in flight. The following send
+ * must wait for room in the queue, and resume when the ACS answers. All the messages must
+ * then reach the ACS, in order. The callbacks of dm_com reading the responses are wrapped at
+ * link time (-Wl,--wrap).
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "dm_com.h"
+#include "DM_COM_GenericHttpClientInterface.h"
+
+#define _BUFFER_SIZE  (16*1024)
+#define _TIMEOUT      10   // s
+#define _BLOCKED_WAIT 300  // ms
+
+#define _NB_PENDING_MAX 32 // DM_HTTP_MAX_PENDING_MESSAGES
+#define _NB_MESSAGES    (1 + _NB_PENDING_MAX + 1)
+
+static const char * _OK = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+
+// Messages received by the ACS, in order
+static char            _received[_NB_MESSAGES][32];
+static int             _nbReceived  = 0;
+static bool            _acsReleased = false;
+static pthread_mutex_t _acsMutex    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  _acsCond     = PTHREAD_COND_INITIALIZER;
+
+// Send waiting for room in the queue
+static bool            _lastSendDone   = false;
+static int             _lastSendResult = DM_ERR;
+
+static int _listenSock = -1;
+static int _nbFailures = 0;
+
+size_t __wrap_DM_HttpCallbackClientHeader(char   * httpHeaderMsgString UNUSED,
+                                          size_t   msgSize,
+                                          int      lastHttpResponseCode UNUSED)
+{
+  return msgSize;
+}
+
+size_t __wrap_DM_HttpCallbackClientData(char   * httpDataMsgString UNUSED,
+                                        size_t   msgSize)
+{
+  return msgSize;
+}
+
+static void _report(const char * testName,
+                    bool         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+/*
+* Value of the header (NULL if absent), the headers ending with an empty line
+*/
+static const char * _getHeader(const char * headers,
+                               const char * name)
+{
+  const char * line = strstr( headers, "\r\n" );
+  size_t       len  = strlen( name );
+
+  while ( (line != NULL) && (strncmp( line, "\r\n\r\n", 4 ) != 0) ) {
+    line += 2;
+    if ( (strncasecmp( line, name, len ) == 0) && (line[len] == ':') ) {
+      line += len + 1;
+      while ( *line == ' ' ) { line++; }
+      return line;
+    }
+    line = strstr( line, "\r\n" );
+  }
+  return NULL;
+}
+
+/*
+* Reads one request with a Content-Length into the body, the bytes of the next requests being
+* kept in the buffer. Returns false when the connection is closed.
+*/
+static bool _readRequest(int      sock,
+                         char   * buffer,
+                         size_t * pFilled,
+                         char   * body,
+                         size_t   bodySize)
+{
+  char       * end    = NULL;
+  const char * value  = NULL;
+  size_t       filled = *pFilled;
+  size_t       length = 0;
+  size_t       consumed;
+  ssize_t      n;
+
+  buffer[filled] = '\0';
+  while ( (end = strstr( buffer, "\r\n\r\n" )) == NULL ) {
+    if ( (filled >= _BUFFER_SIZE - 1) || ((n = recv( sock, buffer + filled, _BUFFER_SIZE - 1 - filled, 0 )) <= 0) ) { return false; }
+    filled += n;
+    buffer[filled] = '\0';
+  }
+  end     += 4;
+  length   = ( (value = _getHeader( buffer, "Content-Length" )) != NULL ? strtoul( value, NULL, 10 ) : 0 );
+  consumed = (end - buffer) + length;
+  if ( consumed >= _BUFFER_SIZE ) { return false; }
+  while ( filled < consumed ) {
+    if ( (n = recv( sock, buffer + filled, _BUFFER_SIZE - 1 - filled, 0 )) <= 0 ) { return false; }
+    filled += n;
+  }
+  snprintf( body, bodySize, "%.*s", (int)length, end );
+
+  memmove( buffer, buffer + consumed, filled - consumed );
+  *pFilled = filled - consumed;
+  return true;
+}
+
+/*
+* ACS : the answer to the first message is held until the test releases it
+*/
+static void * _runAcs(void * data UNUSED)
+{
+  static char buffer[_BUFFER_SIZE];
+  char        body[32];
+  int         sock;
+
+  while ( (sock = accept( _listenSock, NULL, NULL )) >= 0 ) {
+    size_t filled = 0;
+
+    while ( _readRequest( sock, buffer, &filled, body, sizeof(body) ) ) {
+      pthread_mutex_lock( &_acsMutex );
+      if ( _nbReceived < _NB_MESSAGES ) { strcpy( _received[_nbReceived], body ); }
+      _nbReceived++;
+      pthread_cond_broadcast( &_acsCond );
+      while ( !_acsReleased ) { pthread_cond_wait( &_acsCond, &_acsMutex ); }
+      pthread_mutex_unlock( &_acsMutex );
+
+      send( sock, _OK, strlen( _OK ), MSG_NOSIGNAL );
+    }
+    close( sock );
+  }
+  return NULL;
+}
+
+static int _startAcs(pthread_t * pThread)
+{
+  struct sockaddr_in address;
+  socklen_t          addressLen = sizeof(address);
+
+  memset( &address, 0, sizeof(address) );
+  address.sin_family      = AF_INET;
+  address.sin_port        = 0;
+  address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  _listenSock = socket( AF_INET, SOCK_STREAM, 0 );
+  if ( (bind( _listenSock, (struct sockaddr *)&address, sizeof(address) ) != 0) || (listen( _listenSock, 4 ) != 0)
+    || (getsockname( _listenSock, (struct sockaddr *)&address, &addressLen ) != 0)
+    || (pthread_create( pThread, NULL, _runAcs, NULL ) != 0) ) {
+    return 0;
+  }
+  return ntohs( address.sin_port );
+}
+
+/*
+* Waits until the ACS has received the given number of messages
+*/
+static bool _waitReceived(int nbMessages)
+{
+  struct timespec deadline;
+  bool            received;
+
+  clock_gettime( CLOCK_REALTIME, &deadline );
+  deadline.tv_sec += _TIMEOUT;
+  pthread_mutex_lock( &_acsMutex );
+  while ( (_nbReceived < nbMessages) && (pthread_cond_timedwait( &_acsCond, &_acsMutex, &deadline ) == 0) ) {}
+  received = (_nbReceived >= nbMessages);
+  pthread_mutex_unlock( &_acsMutex );
+  return received;
+}
+
+static int _sendMessage(int index)
+{
+  char message[32];
+
+  snprintf( message, sizeof(message), "<m>%d</m>", index );
+  return DM_SendHttpMessage( message );
+}
+
+/*
+* Send of the message beyond the queue, from another thread than the sender one
+*/
+static void * _sendLastMessage(void * data UNUSED)
+{
+  int res = _sendMessage( _NB_MESSAGES - 1 );
+
+  pthread_mutex_lock( &_acsMutex );
+  _lastSendResult = res;
+  _lastSendDone   = true;
+  pthread_mutex_unlock( &_acsMutex );
+  return NULL;
+}
+
+static bool _isLastSendDone()
+{
+  bool done;
+
+  pthread_mutex_lock( &_acsMutex );
+  done = _lastSendDone;
+  pthread_mutex_unlock( &_acsMutex );
+  return done;
+}
+
+static void _testBackpressure()
+{
+  pthread_t lastSendThread;
+  bool      queued = true;
+  bool      inOrder = true;
+  char      expected[32];
+  int       i;
+
+  _report( "first message in flight", (_sendMessage( 0 ) == DM_OK) && _waitReceived( 1 ) );
+  for ( i=1 ; i<=_NB_PENDING_MAX ; i++ ) { queued = queued && (_sendMessage( i ) == DM_OK); }
+  _report( "32 messages queued without waiting", queued );
+
+  pthread_create( &lastSendThread, NULL, _sendLastMessage, NULL );
+  usleep( _BLOCKED_WAIT * 1000 );
+  _report( "queue full : the send waits", !_isLastSendDone() );
+
+  pthread_mutex_lock( &_acsMutex );
+  _acsReleased = true;
+  pthread_cond_broadcast( &_acsCond );
+  pthread_mutex_unlock( &_acsMutex );
+  pthread_join( lastSendThread, NULL );
+  _report( "ACS answering : the send resumes", _isLastSendDone() && (_lastSendResult == DM_OK) );
+
+  _report( "all the messages received", _waitReceived( _NB_MESSAGES ) && (_nbReceived == _NB_MESSAGES) );
+  for ( i=0 ; i<_NB_MESSAGES ; i++ ) {
+    snprintf( expected, sizeof(expected), "<m>%d</m>", i );
+    inOrder = inOrder && (strcmp( _received[i], expected ) == 0);
+  }
+  _report( "messages received in order", inOrder );
+}
+
+int main()
+{
+  pthread_t acsThread;
+  char      acsUrl[64];
+  int       port;
+
+  // The local ACS is reached directly
+  setenv( "no_proxy", "127.0.0.1", 1 );
+
+  if ( (port = _startAcs( &acsThread )) == 0 ) {
+    printf( "FAIL start of the ACS\n" );
+    return 1;
+  }
+  snprintf( acsUrl, sizeof(acsUrl), "http://127.0.0.1:%d/acs", port );
+  DM_ConfigureHttpClient( acsUrl, NULL, NULL, NULL, NULL, NULL );
+
+  _testBackpressure();
+
+  DM_StopHttpClient();
+  shutdown( _listenSock, SHUT_RDWR );
+  close( _listenSock );
+  pthread_join( acsThread, NULL );
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
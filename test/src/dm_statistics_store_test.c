@@ -0,0 +1,198 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_statistics_store_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_statistics_store_test.c
+ *
+ * @brief Test of the statistics values saved apart from the parameters (statistics.data)
+ *
+ * The parameter data is initialized from a small parameters.csv in a temporary directory. The
+ * statistics values are saved, then reloaded by DM_ENG_ParameterData_restore() as after a change
+ * of the parameters file : the value and its statistics state bits come from statistics.data,
+ * the other state bits are not taken from it. Then statistics.data is corrupted or removed, the
+ * values must come from statistics.data~, and from none of them when both are corrupted.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "DM_ENG_Parameter.h"
+#include "DM_ENG_ParameterData.h"
+#include "DM_GlobalDefs.h"
+
+#define _OBJECT  "X_ORANGE-COM_StoreTest."
+#define _COUNTER DM_PREFIX _OBJECT "Counter"
+#define _OTHER   DM_PREFIX _OBJECT "Other"
+
+// Read-only parameters stored by the agent : the counter is made a statistics value by the test
+static const char * _PARAMETERS =
+  "# ParameterName;TYPE;STORAGE_MODE;ACCESS_MODE;IMMEDIATE_CHANGE;NOTIFICATION;MANDATORY_NOTIF;NOTIFICATION_DENIED;ACCESS_LIST;DEFAULT_VALUE\n"
+  _OBJECT ";ANY;0;0;0;0;0;0;;;0;0\n"
+  _OBJECT "Counter;UINT;0;0;1;0;0;0;;0;0;0\n"
+  _OBJECT "Other;UINT;0;0;1;0;0;0;;0;0;0\n";
+
+static char _dataDirectory[64];
+static int  _nbFailures = 0;
+
+static void _report(const char * testName,
+                    bool         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+static char * _path(const char * fileName)
+{
+  static char path[128];
+  snprintf( path, sizeof(path), "%s/%s", _dataDirectory, fileName );
+  return path;
+}
+
+static bool _makeDataDirectory()
+{
+  FILE * out = NULL;
+
+  strcpy( _dataDirectory, "/tmp/dm_statistics_store_test.XXXXXX" );
+  if ( (mkdtemp( _dataDirectory ) == NULL) || ((out = fopen( _path( "parameters.csv" ), "w" )) == NULL) ) { return false; }
+  fputs( _PARAMETERS, out );
+  fclose( out );
+  return true;
+}
+
+static void _removeDataDirectory()
+{
+  static const char * files[] = { "parameters.csv", "parameters.data", "parameters.data~", "dm_control.data", "statistics.data", "statistics.data~", NULL };
+  int i;
+
+  for ( i=0 ; files[i]!=NULL ; i++ ) { unlink( _path( files[i] ) ); }
+  rmdir( _dataDirectory );
+}
+
+/*
+* Flips a byte in the middle of the file : its CRC no longer matches
+*/
+static void _corrupt(const char * fileName)
+{
+  FILE * f = fopen( _path( fileName ), "r+b" );
+  long   size;
+  int    c;
+
+  if ( f == NULL ) { return; }
+  fseek( f, 0, SEEK_END );
+  size = ftell( f );
+  fseek( f, size / 2, SEEK_SET );
+  c = fgetc( f );
+  fseek( f, size / 2, SEEK_SET );
+  fputc( c ^ 0x5A, f );
+  fclose( f );
+}
+
+static bool _hasValue(DM_ENG_Parameter * param,
+                      const char       * value)
+{
+  if ( param == NULL ) { return false; }
+  if ( value == NULL ) { return (param->value == NULL); }
+  return (param->value != NULL) && (strcmp( param->value, value ) == 0);
+}
+
+/*
+* Sets the value of the counter and saves it in statistics.data (the previous file becomes statistics.data~)
+*/
+static void _saveCounter(const char * value)
+{
+  DM_ENG_Parameter_updateStatsValue( DM_ENG_ParameterData_getParameter( _COUNTER ), (char*)value, false );
+  DM_ENG_ParameterData_syncStatistics();
+}
+
+/*
+* Statistics value and state reloaded, the other state bits are not taken from statistics.data
+*/
+static void _testReload()
+{
+  DM_ENG_Parameter * counter = DM_ENG_ParameterData_getParameter( _COUNTER );
+  DM_ENG_Parameter * other   = DM_ENG_ParameterData_getParameter( _OTHER );
+
+  // The statistics mark is saved with the parameters, the value apart
+  DM_ENG_Parameter_updateStatsValue( counter, "1", false );
+  DM_ENG_Parameter_markPushed( other );
+  DM_ENG_ParameterData_sync();
+
+  DM_ENG_Parameter_updateStatsValue( counter, "2", false );
+  DM_ENG_Parameter_markPushed( counter );
+  DM_ENG_Parameter_markBeingEvaluated( counter ); // only meaningful while the agent runs
+  DM_ENG_ParameterData_syncStatistics();
+
+  DM_ENG_ParameterData_restore();
+  counter = DM_ENG_ParameterData_getParameter( _COUNTER );
+  other   = DM_ENG_ParameterData_getParameter( _OTHER );
+  _report( "statistics value reloaded", _hasValue( counter, "2" ) && DM_ENG_Parameter_isStatsValue( counter ) );
+  _report( "statistics state bits reloaded, not the other ones", (counter != NULL) && DM_ENG_Parameter_isPushed( counter )
+                                                                 && !DM_ENG_Parameter_isBeingEvaluated( counter ) );
+  _report( "state of the parameters file reloaded", (other != NULL) && DM_ENG_Parameter_isPushed( other )
+                                                    && !DM_ENG_Parameter_isStatsValue( other ) && _hasValue( other, "0" ) );
+  if ( counter != NULL ) { DM_ENG_Parameter_unmarkPushed( counter ); }
+}
+
+/*
+* Values read from statistics.data~ when statistics.data is corrupted or missing
+*/
+static void _testFallback()
+{
+  _saveCounter( "3" );
+  _corrupt( "statistics.data" );
+  DM_ENG_ParameterData_restore();
+  _report( "corrupted statistics.data : value of statistics.data~", _hasValue( DM_ENG_ParameterData_getParameter( _COUNTER ), "2" ) );
+
+  _saveCounter( "4" );
+  _saveCounter( "5" );
+  unlink( _path( "statistics.data" ) );
+  DM_ENG_ParameterData_restore();
+  _report( "missing statistics.data : value of statistics.data~", _hasValue( DM_ENG_ParameterData_getParameter( _COUNTER ), "4" ) );
+
+  _saveCounter( "6" );
+  _corrupt( "statistics.data" );
+  _corrupt( "statistics.data~" );
+  DM_ENG_ParameterData_restore();
+  _report( "corrupted statistics.data and statistics.data~ : no value", _hasValue( DM_ENG_ParameterData_getParameter( _COUNTER ), NULL ) );
+}
+
+int main()
+{
+  if ( !_makeDataDirectory() || (DM_ENG_ParameterData_init( _dataDirectory, true ) != 0)
+    || (DM_ENG_ParameterData_getParameter( _COUNTER ) == NULL) ) {
+    printf( "FAIL initialization of the parameter data in %s\n", _dataDirectory );
+    _removeDataDirectory();
+    return 1;
+  }
+
+  _testReload();
+  _testFallback();
+
+  DM_ENG_ParameterData_release();
+  _removeDataDirectory();
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,36 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : dm_test_stubs.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file dm_test_stubs.c
+ *
+ * @brief Globals of dm_main.c, which is not linked with the test programs
+ *
+ */
+
+#include <stddef.h>
+
+char * DATA_PATH         = NULL;
+char * PROXY_ADDRESS_STR = NULL;
+char * ETH_INTERFACE     = "eth0";
+char * g_randomCpeUrl    = NULL;
@@ -0,0 +1,317 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : ixml_arena_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file ixml_arena_test.c
+ *
+ * @brief Test of the ixml documents allocated in arena mode
+ *
+ * A SOAP message is parsed in arena mode and in heap mode : both documents must print the
+ * same. Then heap nodes are attached to an arena document (a node imported from a heap
+ * document, a clone of one of its own nodes) before the document is released by
+ * ixmlDocument_free(). The allocation functions are wrapped at link time (-Wl,--wrap) to
+ * count the heap blocks in use : their number must come back to its value before the parse,
+ * so that neither the arena nor the heap nodes are leaked.
+ *
+ * The names of the arena nodes are interned, and compared by address in the lookups by tag
+ * name. getElementsByTagName and getElementsByTagNameNS must give the same counts for an
+ * arena document and a heap document, with or without heap nodes attached to them.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ixml.h"
+
+static const char * _MESSAGE =
+  "<soapenv:Envelope xmlns:soapenv=\"http://schemas.xmlsoap.org/soap/envelope/\""
+  " xmlns:soapenc=\"http://schemas.xmlsoap.org/soap/encoding/\""
+  " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xmlns:cwmp=\"urn:dslforum-org:cwmp-1-0\">"
+  "<soapenv:Header><cwmp:ID soapenv:mustUnderstand=\"1\">42</cwmp:ID></soapenv:Header>"
+  "<soapenv:Body><cwmp:SetParameterValues><ParameterList soapenc:arrayType=\"cwmp:ParameterValueStruct[2]\">"
+  "<ParameterValueStruct><Name>Device.Test.1.Value</Name><Value xsi:type=\"xsd:string\">a &amp; b</Value></ParameterValueStruct>"
+  "<ParameterValueStruct><Name>Device.Test.2.Value</Name><Value xsi:type=\"xsd:unsignedInt\">2</Value></ParameterValueStruct>"
+  "</ParameterList><ParameterKey>key</ParameterKey></cwmp:SetParameterValues></soapenv:Body></soapenv:Envelope>";
+
+static const char * _OTHER_MESSAGE =
+  "<Imported xmlns:cwmp=\"urn:dslforum-org:cwmp-1-0\"><cwmp:Child attr=\"1\">text</cwmp:Child><Name>Device.Imported</Name></Imported>";
+
+#define _CWMP_NS    "urn:dslforum-org:cwmp-1-0"
+#define _SOAPENV_NS "http://schemas.xmlsoap.org/soap/envelope/"
+
+/*
+* Lookups by tag name and their number of elements, in _MESSAGE alone and once the clone of a
+* ParameterValueStruct and the Imported element of _OTHER_MESSAGE are appended to its Body
+*/
+typedef struct _TagNameLookup
+{
+  const char * namespaceURI; // NULL for getElementsByTagName
+  const char * name;
+  int          nbElements;
+  int          nbElementsWithAddedNodes;
+
+} TagNameLookup;
+
+static const TagNameLookup _LOOKUPS[] =
+{
+  { NULL,        "ParameterValueStruct",    2,  3 },
+  { NULL,        "Name",                    2,  4 },
+  { NULL,        "cwmp:SetParameterValues", 1,  1 },
+  { NULL,        "cwmp:Child",              0,  1 },
+  { NULL,        "Imported",                0,  1 },
+  { NULL,        "Unknown",                 0,  0 },
+  { NULL,        "*",                       13, 19 },
+  { _CWMP_NS,    "SetParameterValues",      1,  1 },
+  { _CWMP_NS,    "Child",                   0,  1 },
+  { _CWMP_NS,    "Unknown",                 0,  0 },
+  { _SOAPENV_NS, "*",                       3,  3 },
+  { "*",         "ID",                      1,  1 },
+  { "*",         "*",                       5,  6 },
+  { NULL, NULL, 0, 0 }
+};
+
+static long _nbHeapBlocks = 0;
+static int  _nbFailures   = 0;
+
+// End of the Body once the imported node and the clone of ParameterKey are appended to it
+static const char * _BODY_END =
+  "</cwmp:SetParameterValues>\r\n"
+  "<Imported xmlns:cwmp=\"urn:dslforum-org:cwmp-1-0\">\r\n<cwmp:Child attr=\"1\">text</cwmp:Child>\r\n<Name>Device.Imported</Name>\r\n</Imported>\r\n"
+  "<ParameterKey>key</ParameterKey>\r\n"
+  "</soapenv:Body>\r\n";
+
+void * __real_malloc(size_t size);
+void * __real_calloc(size_t nmemb, size_t size);
+void * __real_realloc(void * ptr, size_t size);
+void   __real_free(void * ptr);
+
+void * __wrap_malloc(size_t size)
+{
+  void * ptr = __real_malloc( size );
+  if ( ptr != NULL ) { _nbHeapBlocks++; }
+  return ptr;
+}
+
+void * __wrap_calloc(size_t nmemb, size_t size)
+{
+  void * ptr = __real_calloc( nmemb, size );
+  if ( ptr != NULL ) { _nbHeapBlocks++; }
+  return ptr;
+}
+
+void * __wrap_realloc(void * ptr, size_t size)
+{
+  void * res = __real_realloc( ptr, size );
+  if ( (ptr == NULL) && (res != NULL) ) { _nbHeapBlocks++; }
+  return res;
+}
+
+void __wrap_free(void * ptr)
+{
+  if ( ptr != NULL ) { _nbHeapBlocks--; }
+  __real_free( ptr );
+}
+
+// The strdup of the C library does not go through the wrapped malloc
+char * __wrap_strdup(const char * s)
+{
+  size_t size = strlen( s ) + 1;
+  char * res  = (char *) __wrap_malloc( size );
+  if ( res != NULL ) { memcpy( res, s, size ); }
+  return res;
+}
+
+static void _report(const char * testName,
+                    BOOL         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+/*
+* First element named tagName in the document
+*/
+static IXML_Node * _getElement(IXML_Document * doc,
+                               const char    * tagName)
+{
+  IXML_NodeList * list = ixmlDocument_getElementsByTagName( doc, (char*)tagName );
+  IXML_Node     * node = ixmlNodeList_item( list, 0 );
+
+  ixmlNodeList_free( list );
+  return node;
+}
+
+/*
+* Whether the two documents print the same
+*/
+static BOOL _samePrint(IXML_Document * doc1,
+                       IXML_Document * doc2)
+{
+  DOMString s1 = ixmlDocumenttoString( doc1 );
+  DOMString s2 = ixmlDocumenttoString( doc2 );
+  BOOL      ok = (s1 != NULL) && (s2 != NULL) && (strcmp( s1, s2 ) == 0);
+
+  ixmlFreeDOMString( s1 );
+  ixmlFreeDOMString( s2 );
+  return ok;
+}
+
+/*
+* Parse in arena mode, compared to the heap mode, and release
+*/
+static void _testParseAndFree()
+{
+  long            nbBlocks   = _nbHeapBlocks;
+  IXML_Document * arenaDoc   = ixmlParseBufferArena( _MESSAGE );
+  IXML_Document * heapDoc    = ixmlParseBuffer( _MESSAGE );
+
+  _report( "parse in arena mode", (arenaDoc != NULL) && arenaDoc->n.inArena && (arenaDoc->arena != NULL) );
+  _report( "parse in heap mode", (heapDoc != NULL) && !heapDoc->n.inArena && (heapDoc->arena == NULL) );
+  _report( "same print in arena and heap modes", _samePrint( arenaDoc, heapDoc ) );
+
+  ixmlDocument_free( arenaDoc );
+  ixmlDocument_free( heapDoc );
+  _report( "arena and heap documents released", _nbHeapBlocks == nbBlocks );
+}
+
+/*
+* Heap nodes attached to an arena document, released with it
+*/
+static void _testHeapNodesInArenaDocument()
+{
+  long            nbBlocks   = _nbHeapBlocks;
+  IXML_Document * arenaDoc   = ixmlParseBufferArena( _MESSAGE );
+  IXML_Document * heapDoc    = ixmlParseBuffer( _OTHER_MESSAGE );
+  IXML_Node     * body       = NULL;
+  IXML_Node     * imported   = NULL;
+  IXML_Node     * clone      = NULL;
+  DOMString       print      = NULL;
+  BOOL            ok         = FALSE;
+
+  if ( (arenaDoc == NULL) || (heapDoc == NULL) ) {
+    _report( "parse of the documents", FALSE );
+    ixmlDocument_free( arenaDoc );
+    ixmlDocument_free( heapDoc );
+    return;
+  }
+
+  body = _getElement( arenaDoc, "soapenv:Body" );
+  ok = (ixmlDocument_importNode( arenaDoc, _getElement( heapDoc, "Imported" ), TRUE, &imported ) == IXML_SUCCESS)
+    && (ixmlNode_appendChild( body, imported ) == IXML_SUCCESS);
+  _report( "node of a heap document imported into an arena document", ok && !imported->inArena && arenaDoc->hasHeapNodes );
+
+  clone = ixmlNode_cloneNode( _getElement( arenaDoc, "ParameterKey" ), TRUE );
+  ok = (clone != NULL) && (ixmlNode_appendChild( body, clone ) == IXML_SUCCESS);
+  _report( "clone of an arena node attached to its document", ok && !clone->inArena && (clone->ownerDocument == arenaDoc) );
+
+  print = ixmlDocumenttoString( arenaDoc );
+  _report( "heap nodes printed with the arena document", (print != NULL) && (strstr( print, _BODY_END ) != NULL) );
+  ixmlFreeDOMString( print );
+
+  // The source of the import is released first : the imported nodes are copies
+  ixmlDocument_free( heapDoc );
+  ixmlDocument_free( arenaDoc );
+  _report( "arena document released with its heap nodes", _nbHeapBlocks == nbBlocks );
+}
+
+/*
+* Number of elements found by a lookup
+*/
+static int _countElements(IXML_Document       * doc,
+                          const TagNameLookup * lookup)
+{
+  IXML_NodeList * list = NULL;
+  int             nb   = 0;
+
+  if ( lookup->namespaceURI == NULL ) {
+    list = ixmlDocument_getElementsByTagName( doc, (char*)lookup->name );
+  } else {
+    list = ixmlDocument_getElementsByTagNameNS( doc, (char*)lookup->namespaceURI, (char*)lookup->name );
+  }
+  nb = (int)ixmlNodeList_length( list );
+  ixmlNodeList_free( list );
+  return nb;
+}
+
+/*
+* Appends to the Body a clone of the first ParameterValueStruct and the Imported element of _OTHER_MESSAGE
+*/
+static BOOL _addNodes(IXML_Document * doc,
+                      IXML_Document * otherDoc)
+{
+  IXML_Node * body     = _getElement( doc, "soapenv:Body" );
+  IXML_Node * imported = NULL;
+
+  return (ixmlNode_appendChild( body, ixmlNode_cloneNode( _getElement( doc, "ParameterValueStruct" ), TRUE ) ) == IXML_SUCCESS)
+      && (ixmlDocument_importNode( doc, _getElement( otherDoc, "Imported" ), TRUE, &imported ) == IXML_SUCCESS)
+      && (ixmlNode_appendChild( body, imported ) == IXML_SUCCESS);
+}
+
+/*
+* Same lookups by tag name in the arena, heap and mixed documents
+*/
+static void _testElementsByTagName()
+{
+  IXML_Document       * arenaDoc = ixmlParseBufferArena( _MESSAGE );
+  IXML_Document       * heapDoc  = ixmlParseBuffer( _MESSAGE );
+  IXML_Document       * otherDoc = ixmlParseBuffer( _OTHER_MESSAGE );
+  const TagNameLookup * lookup   = NULL;
+  BOOL                  same     = TRUE;
+  BOOL                  added    = FALSE;
+  char                  testName[128];
+
+  if ( (arenaDoc == NULL) || (heapDoc == NULL) || (otherDoc == NULL) ) {
+    _report( "parse of the documents", FALSE );
+  } else {
+    for ( lookup = _LOOKUPS ; lookup->name != NULL ; lookup++ ) {
+      same = same && (_countElements( arenaDoc, lookup ) == lookup->nbElements)
+                  && (_countElements( heapDoc, lookup ) == lookup->nbElements);
+    }
+    _report( "same lookups by tag name in the arena and heap documents", same );
+
+    added = _addNodes( arenaDoc, otherDoc ) && _addNodes( heapDoc, otherDoc );
+    _report( "heap nodes added to the arena and heap documents", added && arenaDoc->hasHeapNodes );
+
+    for ( lookup = _LOOKUPS ; added && (lookup->name != NULL) ; lookup++ ) {
+      snprintf( testName, sizeof(testName), "%s %s%s%s in the mixed document", (lookup->namespaceURI == NULL ? "getElementsByTagName" : "getElementsByTagNameNS"),
+                (lookup->namespaceURI == NULL ? "" : lookup->namespaceURI), (lookup->namespaceURI == NULL ? "" : " "), lookup->name );
+      _report( testName, (_countElements( arenaDoc, lookup ) == lookup->nbElementsWithAddedNodes)
+                         && (_countElements( heapDoc, lookup ) == lookup->nbElementsWithAddedNodes) );
+    }
+  }
+
+  ixmlDocument_free( arenaDoc );
+  ixmlDocument_free( heapDoc );
+  ixmlDocument_free( otherDoc );
+}
+
+int main()
+{
+  _testParseAndFree();
+  _testHeapNodesInArenaDocument();
+  _testElementsByTagName();
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}
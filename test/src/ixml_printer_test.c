@@ -0,0 +1,194 @@
+/*---------------------------------------------------------------------------
+ * Project     : TR069 Generic Agent
+ *
+ * Copyright (C) 2014 Orange
+ *
+ * This software is distributed under the terms and conditions of the 'Apache-2.0'
+ * license which can be found in the file 'LICENSE.txt' in this package distribution
+ * or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+ *
+ *---------------------------------------------------------------------------
+ * File        : ixml_printer_test.c
+ *
+ * Created     : 19/10/2026
+ * Author      :
+ *
+ *---------------------------------------------------------------------------
+ * $Id$
+ *
+ *---------------------------------------------------------------------------
+ * $Log$
+ *
+ */
+
+/**
+ * @file ixml_printer_test.c
+ *
+ * @brief Test of the ixml print functions (ixmlPrintDocument, ixmlPrintNode, ixmlDocumenttoString
+ * and ixmlNodetoString)
+ *
+ * They compute the size of the output in a first pass, allocate it, then write it in a second
+ * pass. A document with the 5 escaped characters in its texts and attribute values, empty
+ * elements and empty attributes is printed whole and in parts : each output must be the
+ * expected one, and malloc, wrapped at link time (-Wl,--wrap), must have been called once
+ * with a size equal to the strlen of the output plus its '\0'.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ixml.h"
+
+#define _PROLOG "<?xml version=\"1.0\"?>\r\n"
+
+// Every escaped character in the attribute a, the text of t and the text node added by the test
+static const char * _MESSAGE =
+  "<r a=\"&amp;&lt;&gt;&quot;&apos;\" e=\"\">"
+  "<t>&amp;x&lt;y&gt;z&quot;&apos;</t>"
+  "<empty></empty><empty2/><n e=\"\"/>"
+  "</r>";
+
+// Text of the element created by the test, written without its entities
+static const char * _RAW_TEXT = "if (a<b && c>d) s = \"'\";";
+
+#define _DOCUMENT \
+  "<r a=\"&amp;&lt;&gt;&quot;&apos;\" e=\"\">\r\n" \
+  "<t>&amp;x&lt;y&gt;z&quot;&apos;</t>\r\n" \
+  "<empty></empty>\r\n" \
+  "<empty2></empty2>\r\n" \
+  "<n e=\"\"></n>\r\n" \
+  "<raw>if (a&lt;b &amp;&amp; c&gt;d) s = &quot;&apos;&quot;;</raw>\r\n" \
+  "</r>\r\n"
+
+// ixmlNodetoString gives no line break after the start tag of the node printed
+#define _ROOT_NODE \
+  "<r a=\"&amp;&lt;&gt;&quot;&apos;\" e=\"\"><t>&amp;x&lt;y&gt;z&quot;&apos;</t>\r\n" \
+  "<empty></empty>\r\n" \
+  "<empty2></empty2>\r\n" \
+  "<n e=\"\"></n>\r\n" \
+  "<raw>if (a&lt;b &amp;&amp; c&gt;d) s = &quot;&apos;&quot;;</raw>\r\n" \
+  "</r>"
+
+static size_t _lastMallocSize = 0;
+static int    _nbMallocs      = 0;
+static int    _nbFailures     = 0;
+
+void * __real_malloc(size_t size);
+
+void * __wrap_malloc(size_t size)
+{
+  _lastMallocSize = size;
+  _nbMallocs++;
+  return __real_malloc( size );
+}
+
+static void _report(const char * testName,
+                    BOOL         ok)
+{
+  printf( "%s %s\n", (ok ? "PASS" : "FAIL"), testName );
+  if ( !ok ) { _nbFailures++; }
+}
+
+/*
+* Checks the output of a print function and the size computed for it
+*/
+static void _checkPrint(const char * testName,
+                        DOMString    output,
+                        int          nbMallocsBefore,
+                        const char * expected)
+{
+  char name[128];
+
+  snprintf( name, sizeof(name), "%s : output", testName );
+  _report( name, (output != NULL) && (strcmp( output, expected ) == 0) );
+  if ( (output != NULL) && (strcmp( output, expected ) != 0) ) { printf( "%s\n", output ); }
+
+  snprintf( name, sizeof(name), "%s : computed size", testName );
+  _report( name, (output != NULL) && (_nbMallocs == nbMallocsBefore + 1) && (_lastMallocSize == strlen( output ) + 1) );
+
+  ixmlFreeDOMString( output );
+}
+
+/*
+* Adds to the root element a child whose text has the escaped characters unescaped
+*/
+static BOOL _addRawText(IXML_Document * doc,
+                        IXML_Node     * root)
+{
+  IXML_Element * raw  = ixmlDocument_createElement( doc, "raw" );
+  IXML_Node    * text = ixmlDocument_createTextNode( doc, (char*)_RAW_TEXT );
+
+  return (raw != NULL) && (text != NULL)
+      && (ixmlNode_appendChild( (IXML_Node *) raw, text ) == IXML_SUCCESS)
+      && (ixmlNode_appendChild( root, (IXML_Node *) raw ) == IXML_SUCCESS);
+}
+
+/*
+* Prints the document whole and in parts, with each print function
+*/
+static void _testPrint(IXML_Document * doc,
+                       const char    * mode)
+{
+  IXML_Node * root  = ixmlNode_getFirstChild( (IXML_Node *) doc );
+  IXML_Node * t     = NULL;
+  IXML_Node * empty = NULL;
+  char        testName[64];
+  int         nb;
+
+  if ( (root == NULL) || !_addRawText( doc, root ) ) {
+    printf( "FAIL %s document\n", mode );
+    _nbFailures++;
+    return;
+  }
+  t     = ixmlNode_getFirstChild( root );
+  empty = ixmlNode_getNextSibling( t );
+
+  snprintf( testName, sizeof(testName), "%s ixmlDocumenttoString", mode );
+  nb = _nbMallocs;
+  _checkPrint( testName, ixmlDocumenttoString( doc ), nb, _PROLOG _DOCUMENT );
+
+  snprintf( testName, sizeof(testName), "%s ixmlPrintDocument", mode );
+  nb = _nbMallocs;
+  _checkPrint( testName, ixmlPrintDocument( doc ), nb, _PROLOG _DOCUMENT );
+
+  snprintf( testName, sizeof(testName), "%s ixmlNodetoString of an element", mode );
+  nb = _nbMallocs;
+  _checkPrint( testName, ixmlNodetoString( root ), nb, _ROOT_NODE );
+
+  snprintf( testName, sizeof(testName), "%s ixmlPrintNode of an element", mode );
+  nb = _nbMallocs;
+  _checkPrint( testName, ixmlPrintNode( root ), nb, _DOCUMENT );
+
+  snprintf( testName, sizeof(testName), "%s ixmlNodetoString of an empty element", mode );
+  nb = _nbMallocs;
+  _checkPrint( testName, ixmlNodetoString( empty ), nb, "<empty></empty>" );
+
+  snprintf( testName, sizeof(testName), "%s ixmlNodetoString of a text", mode );
+  nb = _nbMallocs;
+  _checkPrint( testName, ixmlNodetoString( ixmlNode_getFirstChild( t ) ), nb, "&amp;x&lt;y&gt;z&quot;&apos;" );
+
+  snprintf( testName, sizeof(testName), "%s ixmlNodetoString of an attribute", mode );
+  nb = _nbMallocs;
+  _checkPrint( testName, ixmlNodetoString( (IXML_Node *) ixmlElement_getAttributeNode( (IXML_Element *) root, "a" ) ), nb,
+               "a=\"&amp;&lt;&gt;&quot;&apos;\"" );
+
+  snprintf( testName, sizeof(testName), "%s ixmlPrintNode of an empty attribute", mode );
+  nb = _nbMallocs;
+  _checkPrint( testName, ixmlPrintNode( (IXML_Node *) ixmlElement_getAttributeNode( (IXML_Element *) root, "e" ) ), nb, "e=\"\"" );
+}
+
+int main()
+{
+  IXML_Document * heapDoc  = ixmlParseBuffer( (char*)_MESSAGE );
+  IXML_Document * arenaDoc = ixmlParseBufferArena( _MESSAGE );
+
+  _testPrint( heapDoc, "heap" );
+  _testPrint( arenaDoc, "arena" );
+
+  ixmlDocument_free( heapDoc );
+  ixmlDocument_free( arenaDoc );
+
+  printf( "%s\n", (_nbFailures == 0 ? "All the tests passed" : "Some tests failed") );
+  return (_nbFailures == 0 ? 0 : 1);
+}